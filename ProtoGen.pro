@@ -13,9 +13,22 @@ macx{
 
 CONFIG += c++1z
 
+# The xml files are loaded on multiple threads
+CONFIG += thread
+
 SOURCES += main.cpp \
     prebuiltSources/floatspecial.c \
     protocolfloatspecial.cpp \
+    protocoltablecodec.cpp \
+    protocolspanarena.cpp \
+    protocoliovencode.cpp \
+    protocolringencode.cpp \
+    protocolpacketqueue.cpp \
+    protocolcolumntable.cpp \
+    protocolpacketlog.cpp \
+    protocoludpbatch.cpp \
+    protocolshmchannel.cpp \
+    protocolreplay.cpp \
     protocolparser.cpp \
     protocolpacket.cpp \
     protocolfield.cpp \
@@ -32,11 +45,32 @@ SOURCES += main.cpp \
     protocolcode.cpp \
     protocolbitfield.cpp \
     protocoldocumentation.cpp \
+    symboltable.cpp \
+    attributeindex.cpp \
+    protocolprofiler.cpp \
+    allocationhooks.cpp \
+    filewatcher.cpp \
+    markdownrenderer.cpp \
+    latexrenderer.cpp \
+    xmlloader.cpp \
+    modulecache.cpp \
+    internedstring.cpp \
+    precompiledlibrary.cpp \
     tinyxml/tinyxml2.cpp
 
 HEADERS += \
     prebuiltSources/floatspecial.h \
     protocolfloatspecial.h \
+    protocoltablecodec.h \
+    protocolspanarena.h \
+    protocoliovencode.h \
+    protocolringencode.h \
+    protocolpacketqueue.h \
+    protocolcolumntable.h \
+    protocolpacketlog.h \
+    protocoludpbatch.h \
+    protocolshmchannel.h \
+    protocolreplay.h \
     protocolparser.h \
     protocolpacket.h \
     protocolfield.h \
@@ -53,6 +87,16 @@ HEADERS += \
     protocolcode.h \
     protocolbitfield.h \
     protocoldocumentation.h \
+    symboltable.h \
+    attributeindex.h \
+    protocolprofiler.h \
+    filewatcher.h \
+    markdownrenderer.h \
+    latexrenderer.h \
+    xmlloader.h \
+    modulecache.h \
+    internedstring.h \
+    precompiledlibrary.h \
     tinyxml/tinyxml2.h
 
 RESOURCES +=
@@ -65,6 +109,9 @@ CONFIG(debug, debug|release){
 }
 
 win32{
+    # Used by ProtocolProfiler::peakMemory()
+    LIBS += -lpsapi
+
     CONFIG(release, debug|release){
         QMAKE_POST_LINK += $$QMAKE_COPY $$quote($$shell_path($$PWD\exampleprotocol.xml)) $$quote($$shell_path($$PWD\ProtoGenInstall\exampleprotocol.xml)) $$escape_expand(\n\t)
         QMAKE_POST_LINK += $$QMAKE_COPY $$quote($$shell_path($$PWD\LICENSE.txt)) $$quote($$shell_path($$PWD\ProtoGenInstall\LICENSE.txt)) $$escape_expand(\n\t)
@@ -0,0 +1,68 @@
+# Benchmark for the ProtoGen generator itself. This builds the generator
+# sources (except the command line main) together with a synthetic protocol
+# generator, and times each phase of generation at increasing scale.
+
+TARGET = ProtoGenBenchmark
+TEMPLATE = app
+
+CONFIG   += console
+CONFIG   -= app_bundle
+CONFIG   -= qt
+
+CONFIG += c++1z
+
+# The xml files are loaded on multiple threads
+CONFIG += thread
+
+SOURCES += main.cpp \
+    protocolsynthesizer.cpp \
+    ../prebuiltSources/floatspecial.c \
+    ../protocolfloatspecial.cpp \
+    ../protocoltablecodec.cpp \
+    ../protocolspanarena.cpp \
+    ../protocoliovencode.cpp \
+    ../protocolringencode.cpp \
+    ../protocolpacketqueue.cpp \
+    ../protocolcolumntable.cpp \
+    ../protocolpacketlog.cpp \
+    ../protocoludpbatch.cpp \
+    ../protocolshmchannel.cpp \
+    ../protocolreplay.cpp \
+    ../protocolparser.cpp \
+    ../protocolpacket.cpp \
+    ../protocolfield.cpp \
+    ../enumcreator.cpp \
+    ../protocolfile.cpp \
+    ../protocolscaling.cpp \
+    ../fieldcoding.cpp \
+    ../encodable.cpp \
+    ../protocolstructure.cpp \
+    ../protocolstructuremodule.cpp \
+    ../protocolsupport.cpp \
+    ../encodedlength.cpp \
+    ../shuntingyard.cpp \
+    ../protocolcode.cpp \
+    ../protocolbitfield.cpp \
+    ../protocoldocumentation.cpp \
+    ../symboltable.cpp \
+    ../attributeindex.cpp \
+    ../protocolprofiler.cpp \
+    ../allocationhooks.cpp \
+    ../markdownrenderer.cpp \
+    ../latexrenderer.cpp \
+    ../xmlloader.cpp \
+    ../modulecache.cpp \
+    ../internedstring.cpp \
+    ../precompiledlibrary.cpp \
+    ../tinyxml/tinyxml2.cpp
+
+HEADERS += \
+    protocolsynthesizer.h
+
+INCLUDEPATH += .. \
+               ../tinyxml \
+               ../prebuiltSources
+
+win32{
+    LIBS += -lpsapi
+}
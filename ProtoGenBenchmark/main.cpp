@@ -0,0 +1,375 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <chrono>
+#include <map>
+#include <algorithm>
+#include "protocolparser.h"
+#include "protocolprofiler.h"
+#include "protocolsynthesizer.h"
+
+static void printHelp(void);
+
+//! Result of one phase of one benchmark run
+class PhaseResult
+{
+public:
+    double milliseconds;    //!< Wall time of the phase
+    uint64_t peak;          //!< Peak heap bytes of the phase, or the peak resident memory of the process for the total
+};
+
+//! Results by number of packets, then phase name
+typedef std::map<int, std::map<std::string, PhaseResult>> BenchmarkResults;
+
+static bool readBaseline(const std::string& fileName, BenchmarkResults& results);
+static bool writeBaseline(const std::string& fileName, const BenchmarkResults& results);
+
+/*!
+ * Benchmark for ProtoGen itself. Synthetic protocols of increasing size are
+ * generated and run through the ProtocolParser in-process, and the time and
+ * peak memory of each phase is recorded. Timings only mean something on the
+ * machine that made them, so nothing is compared unless a baseline file is
+ * given. If that file does not exist yet the results are recorded in it, so
+ * the first run on a machine makes the baseline for the runs after it.
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> scales = {10, 100, 1000};
+    std::string outputdir = (std::filesystem::temp_directory_path() / "ProtoGenBenchmark").string();
+    std::string baselinefile;
+    std::string savefile;
+    double tolerance = 25.0;
+    double memorytolerance = 10.0;
+    int perFile = 50;
+    int repeat = 3;
+    bool markdown = false;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string argument = trimm(std::string(argv[i]));
+        std::string follower = (i < argc - 1) ? trimm(std::string(argv[i+1])) : std::string();
+
+        // All leading "--" are converted to "-" here
+        while(startsWith(argument, "--"))
+            argument.erase(0, 1);
+
+        if(startsWith(argument, "-help") || startsWith(argument, "-?"))
+        {
+            printHelp();
+            return 0;
+        }
+        else if(isEqual(argument, "-markdown"))
+            markdown = true;
+        else if(isEqual(argument, "-large"))
+            scales.push_back(10000);
+        else if(follower.empty())
+        {
+            std::cerr << "error: " << argument << " requires a value" << std::endl;
+            return 2;
+        }
+        else if(isEqual(argument, "-scales"))
+        {
+            scales.clear();
+            for(const std::string& scale : splitanyof(follower, ", "))
+                scales.push_back(std::stoi(scale));
+            i++;
+        }
+        else if(isEqual(argument, "-output"))
+        {
+            outputdir = follower;
+            i++;
+        }
+        else if(isEqual(argument, "-baseline"))
+        {
+            baselinefile = follower;
+            i++;
+        }
+        else if(isEqual(argument, "-save"))
+        {
+            savefile = follower;
+            i++;
+        }
+        else if(isEqual(argument, "-tolerance"))
+        {
+            tolerance = std::stod(follower);
+            i++;
+        }
+        else if(isEqual(argument, "-memory-tolerance"))
+        {
+            memorytolerance = std::stod(follower);
+            i++;
+        }
+        else if(isEqual(argument, "-per-file"))
+        {
+            perFile = std::stoi(follower);
+            i++;
+        }
+        else if(isEqual(argument, "-repeat"))
+        {
+            repeat = std::max(std::stoi(follower), 1);
+            i++;
+        }
+        else
+        {
+            std::cerr << "error: unknown argument " << argument << std::endl;
+            return 2;
+        }
+
+    }// for all arguments
+
+    // The first run with a new baseline file records it
+    BenchmarkResults baseline;
+    if(!baselinefile.empty())
+    {
+        if(!std::filesystem::exists(baselinefile))
+        {
+            std::cout << "Recording the baseline in " << baselinefile << std::endl;
+            if(savefile.empty())
+                savefile = baselinefile;
+        }
+        else if(!readBaseline(baselinefile, baseline))
+        {
+            std::cerr << "error: could not read baseline file " << baselinefile << std::endl;
+            return 2;
+        }
+    }
+
+    // Run the small protocols first, the peak resident memory of the process only goes up
+    std::sort(scales.begin(), scales.end());
+    scales.erase(std::unique(scales.begin(), scales.end()), scales.end());
+
+    BenchmarkResults results;
+    int regressions = 0;
+
+    for(int scale : scales)
+    {
+        std::filesystem::path dir = std::filesystem::path(outputdir) / ("packets" + std::to_string(scale));
+        ProtocolSynthesizer synthesizer(scale, perFile);
+
+        if(!synthesizer.write(dir.string()))
+        {
+            std::cerr << "error: could not write synthetic protocol to " << dir.string() << std::endl;
+            return 1;
+        }
+
+        // The generator is chatty on std::cout, keep the benchmark output readable
+        std::ostringstream chatter;
+        std::streambuf* coutbuf = std::cout.rdbuf(chatter.rdbuf());
+
+        bool ok = true;
+        std::vector<std::string> names;
+        std::vector<double> milliseconds;
+        std::vector<uint64_t> peaks;
+
+        // Keep the fastest time of each phase, which is the least disturbed by the rest of the machine
+        for(int run = 0; ok && (run < repeat); run++)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::vector<std::string> runnames;
+            std::vector<int> counts;
+            std::vector<double> runmilliseconds;
+            std::vector<uint64_t> allocations;
+            std::vector<uint64_t> runpeaks;
+
+            {
+                ProtocolParser parser;
+
+                parser.enableProfiling(true);
+                parser.disableDoxygen(true);
+                parser.disableMarkdown(!markdown);
+
+                ok = parser.parse((dir / synthesizer.mainFileName()).string(), (dir / "output").string(), std::vector<std::string>());
+
+                parser.getProfiler().getPhaseTotals(runnames, counts, runmilliseconds, allocations, runpeaks);
+            }
+
+            // Total includes tearing down the parser
+            runnames.push_back("Total");
+            runmilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            runpeaks.push_back(ProtocolProfiler::peakMemory());
+
+            if(run == 0)
+            {
+                names = runnames;
+                milliseconds = runmilliseconds;
+                peaks = runpeaks;
+            }
+            else
+            {
+                for(std::size_t i = 0; (i < milliseconds.size()) && (i < runmilliseconds.size()); i++)
+                    milliseconds[i] = std::min(milliseconds[i], runmilliseconds[i]);
+            }
+
+        }// for all runs
+
+        std::cout.rdbuf(coutbuf);
+
+        if(!ok)
+        {
+            std::cerr << "error: generation failed for " << scale << " packets" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::endl << scale << " packets" << std::endl;
+        // The phase peaks are heap use, the total is the resident memory of the process
+        std::cout << std::left << std::setw(28) << "  Phase" << std::right << std::setw(12) << "Time (ms)" << std::setw(12) << "Peak (MB)";
+        if(!baseline.empty())
+            std::cout << std::setw(12) << "Time ratio" << std::setw(12) << "Peak ratio";
+        std::cout << std::endl << std::fixed;
+
+        for(std::size_t i = 0; i < names.size(); i++)
+        {
+            PhaseResult& result = results[scale][names.at(i)];
+            result.milliseconds = milliseconds.at(i);
+            result.peak = peaks.at(i);
+
+            std::cout << std::left << std::setw(28) << ("  " + names.at(i)) << std::right
+                      << std::setw(12) << std::setprecision(2) << result.milliseconds
+                      << std::setw(12) << std::setprecision(1) << result.peak/1048576.0;
+
+            std::map<std::string, PhaseResult>::const_iterator it;
+            if((baseline.count(scale) > 0) && ((it = baseline[scale].find(names.at(i))) != baseline[scale].end()))
+            {
+                double ratio = (it->second.milliseconds > 0) ? result.milliseconds/it->second.milliseconds : 1.0;
+                double peakratio = (it->second.peak > 0) ? (double)result.peak/it->second.peak : 1.0;
+
+                std::cout << std::setw(12) << std::setprecision(2) << ratio << std::setw(12) << std::setprecision(2) << peakratio;
+
+                // Short phases are too noisy to compare
+                if((ratio > 1.0 + tolerance/100.0) && (it->second.milliseconds >= 50.0))
+                {
+                    std::cout << "  slower";
+                    regressions++;
+                }
+
+                // Nor are phases that use very little memory
+                if((peakratio > 1.0 + memorytolerance/100.0) && (it->second.peak >= 8*1048576))
+                {
+                    std::cout << "  larger";
+                    regressions++;
+                }
+            }
+
+            std::cout << std::endl;
+
+        }// for all phases
+
+        std::cout << "  " << std::setprecision(1) << 1000.0*results[scale]["Total"].milliseconds/scale << " us per packet" << std::endl;
+        std::cout << std::defaultfloat << std::setprecision(6);
+
+    }// for all scales
+
+    if(!savefile.empty() && !writeBaseline(savefile, results))
+    {
+        std::cerr << "error: could not write baseline file " << savefile << std::endl;
+        return 1;
+    }
+
+    if(regressions > 0)
+    {
+        std::cout << std::endl << regressions << " phases are more than " << tolerance << "% slower, or use more than " << memorytolerance << "% more memory, than the baseline" << std::endl;
+        return 1;
+    }
+
+    return 0;
+
+}// main
+
+
+/*!
+ * Read a baseline file. Each line has the number of packets, the phase name,
+ * the time in milliseconds, and the peak memory in bytes, separated by tabs.
+ * \param fileName is the name of the file to read
+ * \param results receives the baseline results
+ * \return true if the file was read
+ */
+bool readBaseline(const std::string& fileName, BenchmarkResults& results)
+{
+    std::ifstream file(fileName);
+
+    if(!file.is_open())
+        return false;
+
+    std::string line;
+    while(std::getline(file, line))
+    {
+        std::vector<std::string> fields = split(line, "\t");
+
+        if((fields.size() < 4) || startsWith(fields.at(0), "#"))
+            continue;
+
+        PhaseResult& result = results[std::stoi(fields.at(0))][fields.at(1)];
+        result.milliseconds = std::stod(fields.at(2));
+        result.peak = std::stoull(fields.at(3));
+    }
+
+    return true;
+
+}// readBaseline
+
+
+/*!
+ * Write a baseline file, which can be read by readBaseline()
+ * \param fileName is the name of the file to write
+ * \param results are the results to write
+ * \return true if the file was written
+ */
+bool writeBaseline(const std::string& fileName, const BenchmarkResults& results)
+{
+    std::ofstream file(fileName, std::ios_base::out | std::ios_base::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << "# ProtoGen " << ProtocolParser::genVersion << " benchmark baseline: packets, phase, milliseconds, peak bytes" << std::endl;
+
+    for(const auto& scale : results)
+    {
+        for(const auto& phase : scale.second)
+            file << scale.first << "\t" << phase.first << "\t" << phase.second.milliseconds << "\t" << phase.second.peak << std::endl;
+    }
+
+    return file.good();
+
+}// writeBaseline
+
+
+void printHelp(void)
+{
+    std::string help = "ProtoGen benchmark, version: " + ProtocolParser::genVersion;
+    help += R"===(
+
+Usage: ProtoGenBenchmark -options
+
+  -scales <list>     : Comma separated list of the number of packets in each
+                       synthetic protocol (default = 10,100,1000).
+  -large             : Also run a protocol with 10000 packets, which needs
+                       about 6 GB of memory.
+  -output <path>     : Directory for the synthetic protocols and generated
+                       code (default = a directory in the system temp path).
+  -per-file <n>      : Number of packets in each required xml file
+                       (default = 50).
+  -markdown          : Include markdown documentation generation.
+  -repeat <n>        : Run each protocol <n> times, and keep the fastest time
+                       of each phase (default = 3).
+
+  -baseline <file>   : Compare the results against a baseline file. If the
+                       file does not exist the results are recorded in it.
+                       Baselines are only meaningful on the machine that
+                       recorded them. Without this option nothing is
+                       compared.
+
+  -save <file>       : Save the results as a baseline file.
+
+  -tolerance <pct>   : Percentage a phase can be slower than the baseline
+                       before it is reported as a regression (default = 25).
+
+  -memory-tolerance <pct> : Percentage the peak memory of a phase can be
+                       larger than the baseline before it is reported as a
+                       regression (default = 10).
+
+)===";
+    std::cout << help;
+}
@@ -0,0 +1,216 @@
+#include "protocolsynthesizer.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+/*!
+ * Construct a synthesizer for a given number of packets
+ * \param numPackets is the number of packets in the protocol
+ * \param packetsPerFile is the number of packets in each required file
+ */
+ProtocolSynthesizer::ProtocolSynthesizer(int numPackets, int packetsPerFile) :
+    packets(numPackets > 0 ? numPackets : 1),
+    perFile(packetsPerFile > 0 ? packetsPerFile : 1),
+    numStructures(packets/10 + 1)
+{
+}
+
+
+/*!
+ * Write the protocol xml files to a directory, creating it if needed
+ * \param directory is the directory to write to
+ * \return true if all files were written
+ */
+bool ProtocolSynthesizer::write(const std::string& directory) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    std::filesystem::path dir(directory);
+
+    if(!writeFile((dir / mainFileName()).string(), createMainFile()))
+        return false;
+
+    if(!writeFile((dir / "SyntheticShared.xml").string(), createSharedFile()))
+        return false;
+
+    for(int first = 0; first < packets; first += perFile)
+    {
+        int last = std::min(first + perFile, packets);
+
+        if(!writeFile((dir / (packetFileName(first/perFile) + ".xml")).string(), createPacketFile(first, last)))
+            return false;
+    }
+
+    return true;
+
+}// ProtocolSynthesizer::write
+
+
+/*!
+ * Create the top level protocol file, which has the packet identifiers and
+ * requires all the other files.
+ * \return the xml text
+ */
+std::string ProtocolSynthesizer::createMainFile(void) const
+{
+    std::string xml;
+
+    xml += "<?xml version=\"1.0\"?>\n\n";
+    xml += "<Protocol name=\"Synthetic\" prefix=\"Syn\" api=\"1\" version=\"1.0\" endian=\"big\" supportBool=\"true\" supportLongBitfield=\"true\" compare=\"true\" print=\"true\" map=\"true\" comment=\"Procedurally generated protocol with " + std::to_string(packets) + " packets\">\n\n";
+
+    xml += "    <Enum name=\"SyntheticIds\" lookup=\"true\" comment=\"Packet identifiers\">\n";
+    for(int i = 0; i < packets; i++)
+        xml += "        <Value name=\"PKT_" + std::to_string(i) + "\" comment=\"Identifier of packet " + std::to_string(i) + "\"/>\n";
+    xml += "    </Enum>\n\n";
+
+    xml += "    <Require file=\"SyntheticShared\"/>\n";
+
+    for(int first = 0; first < packets; first += perFile)
+        xml += "    <Require file=\"" + packetFileName(first/perFile) + "\"/>\n";
+
+    xml += "\n</Protocol>\n";
+
+    return xml;
+
+}// ProtocolSynthesizer::createMainFile
+
+
+/*!
+ * Create the file with global enumerations and structures which are
+ * referenced by the packets.
+ * \return the xml text
+ */
+std::string ProtocolSynthesizer::createSharedFile(void) const
+{
+    std::string xml;
+
+    xml += "<?xml version=\"1.0\"?>\n\n";
+    xml += "<Protocol name=\"Synthetic\">\n\n";
+
+    xml += "    <Enum name=\"SyntheticMode\" file=\"SyntheticEnums\" lookup=\"true\" comment=\"Operating modes\">\n";
+    for(int i = 0; i < 16; i++)
+        xml += "        <Value name=\"MODE_" + std::to_string(i) + "\" comment=\"Operating mode " + std::to_string(i) + "\"/>\n";
+    xml += "        <Value name=\"NUM_MODES\" comment=\"Number of modes\"/>\n";
+    xml += "    </Enum>\n\n";
+
+    xml += "    <Enum name=\"SyntheticSizes\" file=\"SyntheticEnums\" comment=\"Array sizes\">\n";
+    xml += "        <Value name=\"NUM_SAMPLES\" value=\"8\"/>\n";
+    xml += "        <Value name=\"NUM_DETAILS\" value=\"NUM_SAMPLES/2\"/>\n";
+    xml += "    </Enum>\n\n";
+
+    for(int i = 0; i < numStructures; i++)
+    {
+        std::string index = std::to_string(i);
+
+        xml += "    <Structure name=\"Shared" + index + "\" file=\"SyntheticStructures" + std::to_string(i/perFile) + "\" comment=\"Global structure " + index + "\">\n";
+        xml += "        <Data name=\"mode\" inMemoryType=\"unsigned8\" enum=\"SyntheticMode\" comment=\"Operating mode\"/>\n";
+        xml += "        <Data name=\"enabled\" inMemoryType=\"bool\" encodedType=\"bitfield1\" comment=\"Enable flag\"/>\n";
+        xml += "        <Data name=\"level\" inMemoryType=\"bitfield7\" comment=\"Level\"/>\n";
+        xml += "        <Data name=\"value\" inMemoryType=\"float32\" encodedType=\"float24\" comment=\"Special float\"/>\n";
+        xml += "        <Data name=\"time\" inMemoryType=\"unsigned32\" comment=\"Time in milliseconds\"/>\n";
+        xml += "    </Structure>\n\n";
+    }
+
+    xml += "</Protocol>\n";
+
+    return xml;
+
+}// ProtocolSynthesizer::createSharedFile
+
+
+/*!
+ * Create a file with a group of packets
+ * \param first is the index of the first packet in the file
+ * \param last is one more than the index of the last packet in the file
+ * \return the xml text
+ */
+std::string ProtocolSynthesizer::createPacketFile(int first, int last) const
+{
+    std::string xml;
+
+    xml += "<?xml version=\"1.0\"?>\n\n";
+    xml += "<Protocol name=\"Synthetic\">\n\n";
+    xml += "    <Documentation name=\"Packets " + std::to_string(first) + " to " + std::to_string(last - 1) + "\" paragraph=\"1\" comment=\"Synthetic packets\"/>\n\n";
+
+    for(int i = first; i < last; i++)
+        xml += createPacket(i);
+
+    xml += "</Protocol>\n";
+
+    return xml;
+
+}// ProtocolSynthesizer::createPacketFile
+
+
+/*!
+ * Create one packet. Packets alternate between the structure and parameter
+ * interfaces, and each references one of the global structures.
+ * \param i is the index of the packet
+ * \return the xml text
+ */
+std::string ProtocolSynthesizer::createPacket(int i) const
+{
+    std::string index = std::to_string(i);
+    std::string xml;
+
+    xml += "    <Packet name=\"Packet" + index + "\" ID=\"PKT_" + index + "\" file=\"SyntheticPackets" + std::to_string(i/perFile) + "\"";
+    xml += std::string(" structureInterface=\"true\" parameterInterface=\"") + (((i % 2) == 0) ? "true" : "false") + "\"";
+    xml += " comment=\"Synthetic packet " + index + "\">\n";
+
+    xml += "        <Data name=\"numSamples\" inMemoryType=\"unsigned8\" verifyMaxValue=\"NUM_SAMPLES\" comment=\"Number of samples\"/>\n";
+    xml += "        <Data name=\"numDetails\" inMemoryType=\"unsigned8\" comment=\"Number of details\"/>\n";
+    xml += "        <Data name=\"mode\" inMemoryType=\"unsigned8\" enum=\"SyntheticMode\" comment=\"Operating mode\"/>\n";
+    xml += "        <Data name=\"flagA\" inMemoryType=\"bitfield3\" comment=\"First bitfield\"/>\n";
+    xml += "        <Data name=\"flagB\" inMemoryType=\"bitfield5\" comment=\"Second bitfield\"/>\n";
+    xml += "        <Data name=\"flagC\" inMemoryType=\"bitfield12\" comment=\"Third bitfield\"/>\n";
+    xml += "        <Data name=\"reserved\" inMemoryType=\"null\" encodedType=\"bitfield4\"/>\n";
+    xml += "        <Data name=\"scaled\" inMemoryType=\"float32\" encodedType=\"signed16\" max=\"100\" comment=\"Scaled value\"/>\n";
+    xml += "        <Data name=\"wide\" inMemoryType=\"unsigned64\" encodedType=\"unsigned40\" comment=\"Wide integer\"/>\n";
+    xml += "        <Data name=\"samples\" inMemoryType=\"signed16\" array=\"NUM_SAMPLES\" variableArray=\"numSamples\" comment=\"Samples\"/>\n";
+    xml += "        <Data name=\"shared\" struct=\"Shared" + std::to_string(i % numStructures) + "\" comment=\"Reference to a global structure\"/>\n";
+    xml += "        <Structure name=\"detail\" array=\"NUM_DETAILS\" variableArray=\"numDetails\" comment=\"Nested structure\">\n";
+    xml += "            <Data name=\"id\" inMemoryType=\"unsigned16\" comment=\"Identifier\"/>\n";
+    xml += "            <Data name=\"valid\" inMemoryType=\"bool\" encodedType=\"bitfield1\" comment=\"Valid flag\"/>\n";
+    xml += "            <Data name=\"level\" inMemoryType=\"bitfield7\" comment=\"Level\"/>\n";
+    xml += "            <Structure name=\"position\" comment=\"Deeper nested structure\">\n";
+    xml += "                <Data name=\"x\" inMemoryType=\"float32\" encodedType=\"signed24\" scaler=\"1000\" comment=\"X position\"/>\n";
+    xml += "                <Data name=\"y\" inMemoryType=\"float32\" encodedType=\"signed24\" scaler=\"1000\" comment=\"Y position\"/>\n";
+    xml += "            </Structure>\n";
+    xml += "        </Structure>\n";
+    xml += "        <Data name=\"label\" inMemoryType=\"string\" array=\"16\" comment=\"Text label\"/>\n";
+    xml += "    </Packet>\n\n";
+
+    return xml;
+
+}// ProtocolSynthesizer::createPacket
+
+
+/*!
+ * Return the name of the file for a group of packets
+ * \param group is the index of the group
+ * \return the file name without extension
+ */
+std::string ProtocolSynthesizer::packetFileName(int group) const
+{
+    return "SyntheticGroup" + std::to_string(group);
+}
+
+
+/*!
+ * Write text to a file, replacing any existing file
+ * \param fileName is the name of the file
+ * \param text is the contents of the file
+ * \return true if the file was written
+ */
+bool ProtocolSynthesizer::writeFile(const std::string& fileName, const std::string& text)
+{
+    std::ofstream file(fileName, std::ios_base::out | std::ios_base::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << text;
+
+    return file.good();
+}
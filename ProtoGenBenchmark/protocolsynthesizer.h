@@ -0,0 +1,52 @@
+#ifndef PROTOCOLSYNTHESIZER_H
+#define PROTOCOLSYNTHESIZER_H
+
+#include <string>
+
+/*!
+ * The ProtocolSynthesizer procedurally creates protocol xml for benchmarking
+ * ProtoGen. The protocol scales with the number of packets, and uses the
+ * features that tend to be expensive to generate: nested structures,
+ * bitfields, enumerations, scaled encodings, variable length arrays, global
+ * structure references, and Require tags that split the protocol across many
+ * files. The output is deterministic for a given number of packets.
+ */
+class ProtocolSynthesizer
+{
+public:
+
+    //! Construct a synthesizer for a given number of packets
+    ProtocolSynthesizer(int numPackets, int packetsPerFile = 50);
+
+    //! Write the protocol xml files to a directory
+    bool write(const std::string& directory) const;
+
+    //! Return the name of the top level xml file, within the directory
+    std::string mainFileName(void) const {return "Synthetic.xml";}
+
+protected:
+
+    //! Create the top level protocol file
+    std::string createMainFile(void) const;
+
+    //! Create the file with global enumerations and structures
+    std::string createSharedFile(void) const;
+
+    //! Create a file with a group of packets
+    std::string createPacketFile(int first, int last) const;
+
+    //! Create one packet
+    std::string createPacket(int index) const;
+
+    //! Return the name of the file for a group of packets
+    std::string packetFileName(int group) const;
+
+    //! Write text to a file
+    static bool writeFile(const std::string& fileName, const std::string& text);
+
+    int packets;        //!< Number of packets in the protocol
+    int perFile;        //!< Number of packets in each required file
+    int numStructures;  //!< Number of global structures
+};
+
+#endif // PROTOCOLSYNTHESIZER_H
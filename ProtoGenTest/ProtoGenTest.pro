@@ -14,6 +14,9 @@ CONFIG   -= app_bundle
 
 TEMPLATE = app
 
+# The shared memory channel uses shm_open, which older glibc keeps in librt
+unix:!macx: LIBS += -lrt
+
 #QMAKE_CXXFLAGS += -Wno-unused-parameter
 #QMAKE_CFLAGS += -std=c99
 #QMAKE_CFLAGS += -pedantic
@@ -21,6 +24,12 @@ TEMPLATE = app
 
 
 SOURCES += main.cpp \
+    columntable.cpp \
+    DemolinkColumns.cpp \
+    DemolinkLog.cpp \
+    DemolinkShm.cpp \
+    DemolinkUdp.cpp \
+    packetlog.cpp \
     Engine.c \
     base_types.c \
     compare/base_compare.cpp \
@@ -28,14 +37,22 @@ SOURCES += main.cpp \
     fielddecode.c \
     fieldencode.c \
     floatspecial.c \
+    iovencode.c \
     GPS.c \
     globaldependson.c \
     map/base_map.cpp \
     scaleddecode.c \
     scaledencode.c \
+    shmchannel.cpp \
+    spanarena.c \
+    tablecodec.c \
+    udpbatch.cpp \
     TelemetryPacket.c \
     linkcode.c \
     packetinterface.c \
+    packetqueue.c \
+    replay.cpp \
+    ringencode.c \
     bitfieldtest.c \
     definitions/verify.c \
     verify/dateverify.c \
@@ -45,6 +62,12 @@ SOURCES += main.cpp \
     map/mapDemolink.cpp
 
 HEADERS += \
+    columntable.hpp \
+    DemolinkColumns.hpp \
+    DemolinkLog.hpp \
+    DemolinkShm.hpp \
+    DemolinkUdp.hpp \
+    packetlog.hpp \
     base_types.h \
     compare/base_compare.hpp \
     compare/base_print.hpp \
@@ -55,13 +78,20 @@ HEADERS += \
     fielddecode.h \
     fieldencode.h \
     floatspecial.h \
+    iovencode.h \
     GPS.h \
     map/base_map.hpp \
     scaleddecode.h \
     scaledencode.h \
+    shmchannel.hpp \
+    spanarena.h \
+    tablecodec.h \
+    udpbatch.hpp \
     TelemetryPacket.h \
     linkcode.h \
     packetinterface.h \
+    packetqueue.h \
+    ringencode.h \
     definitions/EngineDefinitions.hpp \
     bitfieldtest.h \
     definitions/verify.h \
@@ -73,7 +103,8 @@ HEADERS += \
     map/mapDemolink.hpp
 
 OTHER_FILES += \
-    Doxyfile
+    Doxyfile \
+    numpytest.py
 
 INCLUDEPATH += ./ \
                ./definitions \
@@ -82,7 +113,7 @@ INCLUDEPATH += ./ \
                ./map
 
 #protogen.target = $$PWD/Demolink.markdown
-#protogen.commands = $$PWD/../ProtoGenInstall/ProtoGen.exe $$PWD/../exampleprotocol.xml $$PWD -no-doxygen
+#protogen.commands = $$PWD/../ProtoGenInstall/ProtoGen.exe $$PWD/../exampleprotocol.xml $$PWD -no-doxygen -replay -columns -log -udp -shm -numpy
 #protogen.depends = FORCE
 
 #PRE_TARGETDEPS += $$PWD/Demolink.markdown
@@ -1,5 +1,8 @@
 #include <QDateTime>
 #include <iostream>
+#include <vector>
+#include <cstdio>
+#include <ctime>
 #include <math.h>
 #include "bitfieldtest.h"
 #include "floatspecial.h"
@@ -10,6 +13,10 @@
 #include "linkcode.h"
 #include "compareDemolink.hpp"
 #include "printDemolink.hpp"
+#include "DemolinkColumns.hpp"
+#include "DemolinkLog.hpp"
+#include "DemolinkUdp.hpp"
+#include "DemolinkShm.hpp"
 #include "fieldencode.h"
 
 #define PI 3.141592653589793
@@ -36,9 +43,27 @@ static int testZeroLengthPacket(void);
 static int testBitfieldGroupPacket(void);
 static int testMultiDimensionPacket(void);
 static int testDefaultStringsPacket(void);
+static int testTableDrivenPacket(void);
+static int testSpanPacket(void);
+static int testImageIovPacket(void);
+static int testImageRingPacket(void);
+static int testPacketQueue(void);
+static int testReplayTool(void);
+static int testColumns(void);
+static int testPacketLog(void);
+static void encodeEngineCommandValue(testPacket_t* pkt, float value);
+static int isEngineCommandValue(const testPacket_t* pkt, float value);
+static int testUdpBatch(void);
+static int testShmChannel(void);
+static int testNumpyRecords(void);
+static void udpBatchHandler(const testPacket_t* pkt, const PgUdpDatagram& datagram, void* context);
+static uint64_t columnValue(const PgColumnTable& table, const std::string& name, std::size_t row, bool* valid);
 
 static int fcompare(double input1, double input2, double epsilon);
 
+//! The generated replay tool, which replay.cpp builds into this program
+int replayDemolink(int argc, char* argv[]);
+
 int main(int argc, char *argv[])
 {
     (void)argc;
@@ -103,6 +128,39 @@ int main(int argc, char *argv[])
     if(testDefaultStringsPacket() == 0)
         Return = 0;
 
+    if(testTableDrivenPacket() == 0)
+        Return = 0;
+
+    if(testSpanPacket() == 0)
+        Return = 0;
+
+    if(testImageIovPacket() == 0)
+        Return = 0;
+
+    if(testImageRingPacket() == 0)
+        Return = 0;
+
+    if(testPacketQueue() == 0)
+        Return = 0;
+
+    if(testReplayTool() == 0)
+        Return = 0;
+
+    if(testColumns() == 0)
+        Return = 0;
+
+    if(testPacketLog() == 0)
+        Return = 0;
+
+    if(testUdpBatch() == 0)
+        Return = 0;
+
+    if(testShmChannel() == 0)
+        Return = 0;
+
+    if(testNumpyRecords() == 0)
+        Return = 0;
+
     if(Return == 1)
         std::cout << "All tests passed" << std::endl;
 
@@ -1169,6 +1227,858 @@ int testDefaultStringsPacket(void)
 }
 
 
+int testTableDrivenPacket(void)
+{
+    TableDriven_t table = TableDriven_t();
+    testPacket_t pkt;
+
+    table.counter = 0x12345678;
+    table.temperature = -40.5f;
+    table.numSamples = 3;
+    for(int i = 0; i < table.numSamples; i++)
+    {
+        table.sample[i].time = 1000 + i;
+        table.sample[i].value = i*12.5f;
+    }
+    table.position[0] = 45.6980142;
+    table.position[1] = -121.5618339;
+    table.position[2] = 169.4;
+    pgstrncpy(table.label, "table driven", sizeof(table.label));
+
+    encodeTableDrivenPacketStructure(&pkt, &table);
+
+    if(pkt.length != (1 + 4 + 2 + 1 + 3*4 + 8*N3D + strlen(table.label) + 1))
+    {
+        std::cout << "Table driven packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    if((pkt.pkttype != TABLEDRIVEN) || (pkt.data[0] != 0xA5))
+    {
+        std::cout << "Table driven packet has the wrong type or constant" << std::endl;
+        return 0;
+    }
+
+    table = TableDriven_t();
+    if(!decodeTableDrivenPacketStructure(&pkt, &table))
+    {
+        std::cout << "decodeTableDrivenPacketStructure() failed" << std::endl;
+        return 0;
+    }
+
+    if( (table.counter != 0x12345678) ||
+        fcompare(table.temperature, -40.5, 200.0/32767) ||
+        (table.numSamples != 3) ||
+        (table.position[0] != 45.6980142) ||
+        (table.position[1] != -121.5618339) ||
+        (table.position[2] != 169.4) ||
+        (strcmp(table.label, "table driven") != 0))
+    {
+        std::cout << "decodeTableDrivenPacketStructure() yielded incorrect data" << std::endl;
+        return 0;
+    }
+
+    for(int i = 0; i < table.numSamples; i++)
+    {
+        if((table.sample[i].time != 1000 + i) || fcompare(table.sample[i].value, i*12.5f, 100.0/32767))
+        {
+            std::cout << "decodeTableDrivenPacketStructure() yielded incorrect sample data" << std::endl;
+            return 0;
+        }
+    }
+
+    // The constant is checked, and every field is checked against the packet length
+    pkt.data[0] = 0;
+    if(decodeTableDrivenPacketStructure(&pkt, &table))
+    {
+        std::cout << "decodeTableDrivenPacketStructure() accepted a wrong constant" << std::endl;
+        return 0;
+    }
+
+    pkt.data[0] = 0xA5;
+    pkt.length = 1 + 4 + 2 + 1 + 2*4;
+    if(decodeTableDrivenPacketStructure(&pkt, &table))
+    {
+        std::cout << "decodeTableDrivenPacketStructure() accepted a short packet" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testTableDrivenPacket
+
+
+int testSpanPacket(void)
+{
+    float readings[50];
+    Date_t dates[10];
+    Span_t span = Span_t();
+    testPacket_t pkt;
+    pgarena_t arena;
+    uint64_t storage[(getSpanMaxSpanStorage() + 7)/8];
+
+    span.numReadings = 40;
+    span.readings = readings;
+    for(int i = 0; i < span.numReadings; i++)
+        readings[i] = i*2.5f - 50.0f;
+
+    span.numDates = 2;
+    span.dates = dates;
+    dates[0].year = 2017;
+    dates[0].month = 7;
+    dates[0].day = 4;
+    dates[1].year = 2069;
+    dates[1].month = 7;
+    dates[1].day = 20;
+
+    span.fixed[0] = 1;
+    span.fixed[3] = 4;
+
+    encodeSpanPacketStructure(&pkt, &span);
+
+    if(pkt.length != (2 + 40*2 + 1 + 2*getMinLengthOfDate_t() + 4))
+    {
+        std::cout << "Span packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    // Decoding takes the storage for the spans from the arena
+    initArena(&arena, storage, sizeof(storage));
+    span = Span_t();
+    if(!decodeSpanPacketStructure(&pkt, &span, &arena))
+    {
+        std::cout << "decodeSpanPacketStructure() failed" << std::endl;
+        return 0;
+    }
+
+    if( ((uint8_t*)span.readings < (uint8_t*)storage) ||
+        ((uint8_t*)(span.dates + span.numDates) > (uint8_t*)storage + sizeof(storage)))
+    {
+        std::cout << "decodeSpanPacketStructure() did not use the arena" << std::endl;
+        return 0;
+    }
+
+    if((span.numReadings != 40) || (span.numDates != 2) || (span.fixed[0] != 1) || (span.fixed[3] != 4))
+    {
+        std::cout << "decodeSpanPacketStructure() yielded incorrect data" << std::endl;
+        return 0;
+    }
+
+    for(int i = 0; i < span.numReadings; i++)
+    {
+        if(fcompare(span.readings[i], i*2.5f - 50.0f, 100.0/32767))
+        {
+            std::cout << "decodeSpanPacketStructure() yielded incorrect readings" << std::endl;
+            return 0;
+        }
+    }
+
+    if( (span.dates[0].year != 2017) || (span.dates[0].month != 7) || (span.dates[0].day != 4) ||
+        (span.dates[1].year != 2069) || (span.dates[1].month != 7) || (span.dates[1].day != 20))
+    {
+        std::cout << "decodeSpanPacketStructure() yielded incorrect dates" << std::endl;
+        return 0;
+    }
+
+    // Decode fails if the arena runs out
+    initArena(&arena, storage, 16*sizeof(float));
+    if(decodeSpanPacketStructure(&pkt, &span, &arena))
+    {
+        std::cout << "decodeSpanPacketStructure() decoded into an arena that is too small" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testSpanPacket
+
+
+int testImageIovPacket(void)
+{
+    Image_t image = Image_t();
+    testPacket_t pkt, iovpkt;
+    struct iovec iov[getImageMaxIovCount()];
+    uint8_t gathered[getImageMaxDataLength()];
+    int numiov;
+    size_t length = 0;
+
+    image.frame = 0x1234;
+    image.numPixels = 150;
+    for(int i = 0; i < image.numPixels; i++)
+        image.pixels[i] = (uint8_t)(i*7);
+    image.gain = -2.5f;
+    image.tag[0] = -1;
+    image.tag[3] = 100;
+
+    encodeImagePacketStructure(&pkt, &image);
+
+    numiov = encodeImagePacketStructureIov(&iovpkt, &image, iov, getImageMaxIovCount());
+    if(numiov <= 0)
+    {
+        std::cout << "encodeImagePacketStructureIov() failed" << std::endl;
+        return 0;
+    }
+
+    // The pixels are sent from the structure, not copied into the packet
+    int pixelentry = 0;
+    for(int i = 0; i < numiov; i++)
+    {
+        if(iov[i].iov_base == (void*)image.pixels)
+            pixelentry = 1;
+
+        memcpy(gathered + length, iov[i].iov_base, iov[i].iov_len);
+        length += iov[i].iov_len;
+    }
+
+    if(!pixelentry)
+    {
+        std::cout << "encodeImagePacketStructureIov() copied the pixels" << std::endl;
+        return 0;
+    }
+
+    if((length != (size_t)pkt.length) || (length != iovLength(iov, numiov)) || (memcmp(gathered, pkt.data, length) != 0))
+    {
+        std::cout << "encodeImagePacketStructureIov() data differ from encodeImagePacketStructure()" << std::endl;
+        return 0;
+    }
+
+    if(encodeImagePacketStructureIov(&iovpkt, &image, iov, 1) != 0)
+    {
+        std::cout << "encodeImagePacketStructureIov() did not fail with too few entries" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testImageIovPacket
+
+
+int testImageRingPacket(void)
+{
+    Image_t image = Image_t();
+    testPacket_t pkt;
+    pgring_t ring;
+    uint8_t storage[400 + getImageMaxDataLength()];
+    uint8_t data[getImageMaxDataLength()];
+    int total = 0;
+
+    // The end of the storage is slack for a packet that wraps around the end of the ring
+    initRing(&ring, storage, sizeof(storage), getImageMaxDataLength());
+
+    image.gain = 1.5f;
+    image.tag[1] = 12;
+
+    // Packets of different sizes, so they wrap at different places
+    for(int count = 0; count < 20; count++)
+    {
+        image.frame = (uint16_t)count;
+        image.numPixels = (uint8_t)(50 + (count*37) % 150);
+        for(int i = 0; i < image.numPixels; i++)
+            image.pixels[i] = (uint8_t)(count + i);
+
+        encodeImagePacketStructure(&pkt, &image);
+
+        int length = encodeImagePacketStructureRing(&ring, &image);
+
+        if((length != pkt.length) || (ringUsed(&ring) != (uint32_t)length))
+        {
+            std::cout << "encodeImagePacketStructureRing() added the wrong number of bytes" << std::endl;
+            return 0;
+        }
+
+        if((readRing(&ring, data, (uint32_t)length) != (uint32_t)length) || (memcmp(data, pkt.data, length) != 0))
+        {
+            std::cout << "encodeImagePacketStructureRing() data differ from encodeImagePacketStructure()" << std::endl;
+            return 0;
+        }
+    }
+
+    // Without a consumer the ring fills up, and then nothing is added
+    while(1)
+    {
+        int length = encodeImagePacketStructureRing(&ring, &image);
+        if(length == 0)
+            break;
+
+        total += length;
+    }
+
+    if((total == 0) || (ringUsed(&ring) != (uint32_t)total) || (ringSpace(&ring) >= getImageMaxDataLength()))
+    {
+        std::cout << "encodeImagePacketStructureRing() did not stop when the ring was full" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testImageRingPacket
+
+
+int testPacketQueue(void)
+{
+    pgqueue_t queue;
+    testPacket_t storage[8];
+    testPacket_t* pkt;
+    EngineCommand_t eng;
+
+    if(initDemolinkQueue(&queue, storage, 6))
+    {
+        std::cout << "Packet queue accepted a slot count that is not a power of two" << std::endl;
+        return 0;
+    }
+
+    if(!initDemolinkQueue(&queue, storage, 8) || (peekDemolinkQueue(&queue) != NULL))
+    {
+        std::cout << "Packet queue failed to initialize empty" << std::endl;
+        return 0;
+    }
+
+    // Packets are encoded in place in the slots, run through the queue twice so the slots are reused
+    for(int pass = 0; pass < 2; pass++)
+    {
+        for(int i = 0; i < 8; i++)
+        {
+            pkt = reserveDemolinkQueue(&queue);
+            if(pkt == NULL)
+            {
+                std::cout << "Packet queue is full too soon" << std::endl;
+                return 0;
+            }
+
+            eng.command = pass*100.0f + i;
+            encodeEngineCommandPacketStructure(pkt, &eng);
+            commitQueue(&queue);
+        }
+
+        if((reserveDemolinkQueue(&queue) != NULL) || (queueUsed(&queue) != 8))
+        {
+            std::cout << "Packet queue is not full" << std::endl;
+            return 0;
+        }
+
+        // Packets are decoded in place, in the order they were committed
+        for(int i = 0; i < 8; i++)
+        {
+            pkt = peekDemolinkQueue(&queue);
+            if((pkt == NULL) || !decodeEngineCommandPacketStructure(pkt, &eng) || (eng.command != pass*100.0f + i))
+            {
+                std::cout << "Packet queue yielded incorrect packets" << std::endl;
+                return 0;
+            }
+
+            releaseQueue(&queue);
+        }
+
+        if((peekDemolinkQueue(&queue) != NULL) || (queueUsed(&queue) != 0))
+        {
+            std::cout << "Packet queue is not empty" << std::endl;
+            return 0;
+        }
+    }
+
+    return 1;
+
+}// testPacketQueue
+
+
+int testReplayTool(void)
+{
+    std::vector<long> offsets;
+    EngineCommand_t eng = EngineCommand_t();
+    testPacket_t pkt;
+    char packet[64], good[8];
+    unsigned long offset, length;
+    unsigned id;
+    std::size_t line = 0;
+    int result = 1;
+
+    // Enough frames that the capture is split into several one megabyte chunks
+    FILE* file = fopen("Demolink.capture", "wb");
+    if(file == NULL)
+    {
+        std::cout << "Could not create the replay capture file" << std::endl;
+        return 0;
+    }
+
+    for(int i = 0; i < 250000; i++)
+    {
+        eng.command = (float)i;
+        encodeEngineCommandPacketStructure(&pkt, &eng);
+
+        // Every thousandth frame is too short to decode, but has a good checksum
+        if((i % 1000) == 999)
+            finishDemolinkPacket(&pkt, 2, ENGINECOMMAND);
+
+        // Bytes between frames, including a false start, are skipped
+        if((i % 7) == 0)
+            fputc(TEST_PKT_SYNC_BYTE0, file);
+
+        offsets.push_back(ftell(file));
+        fwrite(&pkt, 1, pkt.length + TEST_PKT_OVERHEAD, file);
+    }
+
+    fclose(file);
+
+    char* arguments[] = {(char*)"DemolinkReplay", (char*)"-threads", (char*)"4", (char*)"-chunk", (char*)"1", (char*)"-list", (char*)"Demolink.replay", (char*)"Demolink.capture"};
+    if(replayDemolink(8, arguments) != 0)
+    {
+        std::cout << "Replay tool failed" << std::endl;
+        remove("Demolink.capture");
+        return 0;
+    }
+
+    // The listing has a line for every frame, in file order, after the heading
+    file = fopen("Demolink.replay", "r");
+    if((file == NULL) || (fscanf(file, "%*[^\n]\n") != 0))
+        result = 0;
+
+    while(result && (fscanf(file, "%lu,%63[^,],%u,%lu,%7s\n", &offset, packet, &id, &length, good) == 5))
+    {
+        const char* expected = ((line % 1000) == 999) ? "0" : "1";
+
+        if( (line >= offsets.size()) || (offset != (unsigned long)offsets.at(line)) ||
+            (strcmp(packet, "EngineCommand") != 0) || (id != ENGINECOMMAND) || (strcmp(good, expected) != 0))
+            result = 0;
+
+        line++;
+    }
+
+    if(file != NULL)
+        fclose(file);
+
+    remove("Demolink.capture");
+    remove("Demolink.replay");
+
+    if(!result || (line != offsets.size()))
+    {
+        std::cout << "Replay tool listing is wrong" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testReplayTool
+
+
+int testColumns(void)
+{
+    PgColumnTable table;
+    ThrottleSettings_t settings = ThrottleSettings_t();
+    testPacket_t pkt;
+    bool valid;
+
+    settings.enableCurve = 1;
+    settings.lowPWM = 1000;
+    settings.highPWM = 2000;
+
+    // Two rows, with different numbers of curve points
+    for(int row = 0; row < 2; row++)
+    {
+        settings.numCurvePoints = (row == 0) ? 5 : 2;
+        for(uint32_t i = 0; i < settings.numCurvePoints; i++)
+        {
+            settings.curvePoint[i].PWM = settings.lowPWM + i*100 + row;
+            settings.curvePoint[i].throttle = i*0.2f;
+        }
+
+        encodeThrottleSettingsPacketStructure(&pkt, &settings);
+
+        if(!appendThrottleSettingsColumns(table, &pkt))
+        {
+            std::cout << "appendThrottleSettingsColumns() failed" << std::endl;
+            return 0;
+        }
+    }
+
+    // A packet that does not decode is not appended
+    pkt.length = 1;
+    if(appendThrottleSettingsColumns(table, &pkt) || (table.rows() != 2))
+    {
+        std::cout << "appendThrottleSettingsColumns() appended a bad packet" << std::endl;
+        return 0;
+    }
+
+    // A column for every field, and every element of the curve points
+    if((table.columns.size() != 2 + 10*2 + 3) || (table.columns.at(0).name != "numCurvePoints"))
+    {
+        std::cout << "Throttle settings columns are wrong" << std::endl;
+        return 0;
+    }
+
+    if( (columnValue(table, "numCurvePoints", 0, &valid) != 5) || !valid ||
+        (columnValue(table, "numCurvePoints", 1, &valid) != 2) || !valid ||
+        (columnValue(table, "highPWM", 1, &valid) != 2000) || !valid ||
+        (columnValue(table, "curvePoint[3]:PWM", 0, &valid) != 1300) || !valid ||
+        (columnValue(table, "curvePoint[1]:PWM", 1, &valid) != 1101) || !valid)
+    {
+        std::cout << "Throttle settings column values are wrong" << std::endl;
+        return 0;
+    }
+
+    // Curve points past the end of the variable array are null
+    columnValue(table, "curvePoint[3]:PWM", 1, &valid);
+    if(valid)
+    {
+        std::cout << "Throttle settings column is not null past the end of the curve" << std::endl;
+        return 0;
+    }
+
+    if(!table.write("Demolink.columns"))
+    {
+        std::cout << "Column table failed to write" << std::endl;
+        return 0;
+    }
+
+    remove("Demolink.columns");
+
+    return 1;
+
+}// testColumns
+
+
+/*!
+ * Encode an engine command packet, for the tests that pass packets through
+ * the log, UDP, and shared memory outputs and check what comes back
+ * \param pkt receives the encoded packet
+ * \param value is the command of the packet
+ */
+void encodeEngineCommandValue(testPacket_t* pkt, float value)
+{
+    EngineCommand_t eng = EngineCommand_t();
+
+    eng.command = value;
+    encodeEngineCommandPacketStructure(pkt, &eng);
+
+}// encodeEngineCommandValue
+
+
+/*!
+ * Check a packet that came back from the log, UDP, or shared memory outputs
+ * \param pkt is the packet to check
+ * \param value is the command the packet was encoded with
+ * \return 1 if the packet decodes as an engine command with the command value
+ */
+int isEngineCommandValue(const testPacket_t* pkt, float value)
+{
+    EngineCommand_t eng = EngineCommand_t();
+
+    if(!decodeEngineCommandPacketStructure(pkt, &eng))
+        return 0;
+
+    return (eng.command == value) ? 1 : 0;
+
+}// isEngineCommandValue
+
+
+int testPacketLog(void)
+{
+    PgLogWriter writer;
+    PgLogReader reader;
+    testPacket_t pkt;
+    const PgLogEntry* entries;
+    std::size_t number;
+
+    if(!openDemolinkLogWriter(writer, "Demolink.pglog"))
+    {
+        std::cout << "openDemolinkLogWriter() failed" << std::endl;
+        return 0;
+    }
+
+    // Engine commands every 10 time units, with a keep alive after every fourth
+    for(int i = 0; i < 100; i++)
+    {
+        encodeEngineCommandValue(&pkt, (float)i);
+        writeDemolinkLog(writer, i*10, &pkt);
+
+        if((i % 4) == 3)
+        {
+            encodeKeepAlivePacket(&pkt);
+            writeDemolinkLog(writer, i*10, &pkt);
+        }
+    }
+
+    if(!writer.close() || !openDemolinkLogReader(reader, "Demolink.pglog"))
+    {
+        std::cout << "Packet log failed to close or open" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    if((reader.count(ENGINECOMMAND) != 100) || (reader.count(KEEPALIVE) != 25) || (reader.ids().size() != 2))
+    {
+        std::cout << "Packet log index is wrong" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    // Seek straight to the engine commands from time 200 to 400, inclusive
+    entries = reader.entries(ENGINECOMMAND, 200, 400, number);
+    if(number != 21)
+    {
+        std::cout << "Packet log time range is wrong" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    for(std::size_t i = 0; i < number; i++)
+    {
+        PgLogRecord record = reader.record(entries[i]);
+
+        readDemolinkLog(record, &pkt);
+        if( (record.time != 200 + i*10) || !isEngineCommandValue(&pkt, 20.0f + i))
+        {
+            std::cout << "Packet log record is wrong" << std::endl;
+            remove("Demolink.pglog");
+            return 0;
+        }
+    }
+
+    // All the records in a range, in the order they were written
+    std::vector<PgLogEntry> all = reader.allEntries(30, 40);
+    if( (all.size() != 3) ||
+        (reader.record(all.at(0)).id != ENGINECOMMAND) ||
+        (reader.record(all.at(1)).id != KEEPALIVE) ||
+        (reader.record(all.at(2)).time != 40))
+    {
+        std::cout << "Packet log records of all packets are wrong" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    reader.close();
+    remove("Demolink.pglog");
+
+    return 1;
+
+}// testPacketLog
+
+
+//! Packets received by testUdpBatch()
+typedef struct
+{
+    int count;          //!< Number of engine commands received
+    int outOfOrder;     //!< Number of engine commands with the wrong value
+}udpReceived_t;
+
+
+void udpBatchHandler(const testPacket_t* pkt, const PgUdpDatagram& datagram, void* context)
+{
+    udpReceived_t* received = (udpReceived_t*)context;
+
+    (void)datagram;
+
+    if(isEngineCommandValue(pkt, (float)received->count))
+        received->count++;
+    else
+        received->outOfOrder++;
+
+}// udpBatchHandler
+
+
+int testUdpBatch(void)
+{
+    PgUdpBatch* udp = newDemolinkUdp();
+    udpReceived_t received = {0, 0};
+    int invalid = 0;
+    int result = 1;
+
+    // Send to ourselves on the loopback interface
+    if(!udp->open("127.0.0.1", 0) || !udp->setDestination("127.0.0.1", udp->port()))
+    {
+        std::cout << "Failed to open the UDP socket" << std::endl;
+        delete udp;
+        return 0;
+    }
+
+    for(int i = 0; i < 20; i++)
+    {
+        encodeEngineCommandValue(reserveDemolinkUdp(*udp), (float)i);
+        if(!commitDemolinkUdp(*udp, reserveDemolinkUdp(*udp)))
+            result = 0;
+    }
+
+    // A datagram that is not a frame
+    memset(udp->reserve(), 0x55, 8);
+    udp->commit(8);
+    udp->flush();
+
+    while((received.count + received.outOfOrder < 20) || (invalid < 1))
+    {
+        if(receiveDemolinkUdp(*udp, 1000, udpBatchHandler, &received, &invalid) <= 0)
+            break;
+    }
+
+    if((result == 0) || (received.count != 20) || (received.outOfOrder != 0) || (invalid != 1))
+    {
+        std::cout << "UDP batch received " << received.count << " packets, " << received.outOfOrder << " out of order, " << invalid << " invalid" << std::endl;
+        result = 0;
+    }
+
+    delete udp;
+
+    return result;
+
+}// testUdpBatch
+
+
+int testShmChannel(void)
+{
+    PgShmChannel publisher;
+    PgShmChannel consumer;
+    PgShmMessage message;
+    EngineCommand_t eng = EngineCommand_t();
+    testPacket_t pkt;
+    char name[64];
+    int result = 1;
+
+    // A name no other run of this test is using
+    snprintf(name, sizeof(name), "/protogentest%ld", (long)clock());
+
+    if(!createDemolinkShm(publisher, name, 8) || !openDemolinkShm(consumer, name))
+    {
+        std::cout << "Failed to create shared memory " << name << std::endl;
+        PgShmChannel::unlink(name);
+        return 0;
+    }
+
+    // The shared memory is still mapped once its name is gone
+    PgShmChannel::unlink(name);
+
+    // A decoded structure, and then a packet
+    eng.command = 0.25f;
+    publishEngineCommandShm(publisher, &eng);
+    encodeEngineCommandValue(&pkt, 0.75f);
+    publishDemolinkPacketShm(publisher, &pkt);
+
+    eng = EngineCommand_t();
+    if(!consumer.read(message) || !readEngineCommandShm(message, &eng) || (eng.command != 0.25f))
+        result = 0;
+
+    if( !consumer.read(message) || !readDemolinkPacketShm(message, &pkt) ||
+        !isEngineCommandValue(&pkt, 0.75f))
+        result = 0;
+
+    // Nothing more to read, and a packet is not read as a structure
+    if(consumer.read(message) || readEngineCommandShm(message, &eng))
+        result = 0;
+
+    // Lap the consumer, which loses the oldest messages
+    for(int i = 0; i < 20; i++)
+    {
+        eng.command = (float)i;
+        publishEngineCommandShm(publisher, &eng);
+    }
+
+    for(int i = 12; i < 20; i++)
+    {
+        if(!consumer.read(message) || !readEngineCommandShm(message, &eng) || (eng.command != (float)i))
+            result = 0;
+    }
+
+    if((consumer.lost() != 12) || consumer.read(message))
+        result = 0;
+
+    if(result == 0)
+        std::cout << "Shared memory channel failed, " << consumer.lost() << " messages lost" << std::endl;
+
+    return result;
+
+}// testShmChannel
+
+
+/*!
+ * Write encoded records for numpytest.py, which decodes them with the NumPy
+ * output of ProtoGen and checks the values against the same formulas used here.
+ * Demolink.positions holds PositionLLA structures back to back,
+ * Demolink.dates holds Date structures back to back, and Demolink.bitfields
+ * holds whole BitfieldTester packet frames.
+ * \return 1 if the files were written
+ */
+int testNumpyRecords(void)
+{
+    FILE* positions = fopen("Demolink.positions", "wb");
+    FILE* dates = fopen("Demolink.dates", "wb");
+    FILE* bitfields = fopen("Demolink.bitfields", "wb");
+    int result = 1;
+
+    if((positions == NULL) || (dates == NULL) || (bitfields == NULL))
+        result = 0;
+
+    for(int i = 0; (result == 1) && (i < 100); i++)
+    {
+        uint8_t posData[getMaxLengthOfPositionLLA_t()];
+        uint8_t dateData[getMaxLengthOfDate_t()];
+        int posIndex = 0, dateIndex = 0, frameLength;
+        PositionLLA_t pos;
+        Date_t date;
+        BitfieldTester_t bits;
+        testPacket_t pkt;
+
+        pos.latitude = -1.5 + i*0.03;
+        pos.longitude = -3.0 + i*0.06;
+        pos.altitude = -500.0 + i*10.0;
+        encodePositionLLA_t(posData, &posIndex, &pos);
+
+        // Some months are out of range, which the NumPy verify must find
+        date.year = (uint16_t)(2000 + i);
+        date.month = (uint8_t)(1 + (i % 14));
+        date.day = (uint8_t)(1 + (i % 31));
+        encodeDate_t(dateData, &dateIndex, &date);
+
+        bits.field1 = (unsigned)((i*13) % 2048);
+        bits.field2 = (unsigned)(i % 4);
+        bits.field3 = (unsigned)(i % 32);
+        bits.field4 = (unsigned)((i*1000003) % 134217728);
+        bits.field5 = (unsigned)(i & 1);
+        bits.field6 = ((uint64_t)i*123456789012ULL) % 35184372088832ULL;
+        encodeBitfieldTesterPacketStructure(&pkt, &bits);
+        frameLength = getDemolinkFrameLength((const uint8_t*)&pkt, sizeof(pkt));
+
+        if( (fwrite(posData, 1, (std::size_t)posIndex, positions) != (std::size_t)posIndex) ||
+            (fwrite(dateData, 1, (std::size_t)dateIndex, dates) != (std::size_t)dateIndex) ||
+            (frameLength <= 0) ||
+            (fwrite(&pkt, 1, (std::size_t)frameLength, bitfields) != (std::size_t)frameLength))
+            result = 0;
+    }
+
+    if(positions != NULL)
+        fclose(positions);
+    if(dates != NULL)
+        fclose(dates);
+    if(bitfields != NULL)
+        fclose(bitfields);
+
+    if(result == 0)
+        std::cout << "Failed to write the records for numpytest.py" << std::endl;
+
+    return result;
+
+}// testNumpyRecords
+
+
+uint64_t columnValue(const PgColumnTable& table, const std::string& name, std::size_t row, bool* valid)
+{
+    uint64_t value = 0;
+
+    *valid = false;
+
+    for(std::size_t i = 0; i < table.columns.size(); i++)
+    {
+        const PgColumn& column = table.columns.at(i);
+
+        if((column.name != name) || (column.type != PgColumn::UInt64) || (row >= column.length))
+            continue;
+
+        memcpy(&value, column.values.data() + row*sizeof(value), sizeof(value));
+        *valid = (column.validity.at(row/8) & (1 << (row % 8))) != 0;
+        break;
+    }
+
+    return value;
+
+}// columnValue
+
+
 int fcompare(double input1, double input2, double epsilon)
 {
     if(fabs(input1 - input2) > epsilon)
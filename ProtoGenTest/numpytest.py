@@ -0,0 +1,59 @@
+# Check the NumPy output of ProtoGen against the records written by ProtoGenTest.
+#
+# Generate the protocol with -numpy, run ProtoGenTest, and then run this script
+# in the same directory. The expected values use the same formulas as
+# testNumpyRecords() in main.cpp.
+
+import sys
+import numpy as np
+import DemolinkNumpy as demolink
+
+count = 100
+index = np.arange(count)
+failures = 0
+
+
+def check(name, decoded, expected, tolerance=0):
+    """Compare a decoded column with its expected values"""
+    global failures
+    if decoded.shape != expected.shape or not np.all(np.abs(decoded.astype(np.float64) - expected.astype(np.float64)) <= tolerance):
+        print('%s decoded wrong' % name)
+        failures += 1
+
+
+# Scaled fields, including a 24 bit field with an offset
+with open('Demolink.positions', 'rb') as f:
+    positions = demolink.readPositionLLA(f.read())
+
+check('latitude', positions['latitude'], -1.5 + index*0.03, 1e-8)
+check('longitude', positions['longitude'], -3.0 + index*0.06, 1e-8)
+check('altitude', positions['altitude'], -500.0 + index*10.0, 1e-3)
+
+# Verify limits the months, and finds the records that were out of range
+with open('Demolink.dates', 'rb') as f:
+    dates = demolink.readDate(f.read())
+
+check('year', dates['year'], 2000 + index)
+check('day', dates['day'], 1 + index % 31)
+good = demolink.verifyDate(dates)
+check('month', dates['month'], np.minimum(1 + index % 14, 12))
+check('good dates', good, (1 + index % 14) <= 12)
+
+# Bitfields, read from the data of whole packet frames
+with open('Demolink.bitfields', 'rb') as f:
+    frames = f.read()
+
+stride = len(frames)//count
+bits = demolink.readBitfieldTester(frames, offset=4, stride=stride)
+
+check('field1', bits['field1'], (index*13) % 2048)
+check('field2', bits['field2'], index % 4)
+check('field3', bits['field3'], index % 32)
+check('field4', bits['field4'], (index*1000003) % 134217728)
+check('field5', bits['field5'], index & 1)
+check('field6', bits['field6'], (index.astype(np.uint64)*np.uint64(123456789012)) % np.uint64(35184372088832))
+
+if failures == 0:
+    print('All tests passed')
+
+sys.exit(failures)
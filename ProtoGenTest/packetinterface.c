@@ -115,6 +115,34 @@ int lookForDemolinkPacket(testPacket_t* pkt, uint8_t byte)
 }// lookForDemolinkPacket
 
 
+/*!
+ * Find the length of a demolink packet frame that starts at the beginning of
+ * a series of bytes, for example in a capture file or a datagram.
+ * \param frame points to the first byte of the frame.
+ * \param size is the number of bytes available from frame.
+ * \return the number of bytes in the frame if it is complete and its checksum
+ *         is correct, else 0.
+ */
+int getDemolinkFrameLength(const uint8_t* frame, size_t size)
+{
+    int length;
+    uint16_t check;
+
+    if((size < TEST_PKT_OVERHEAD) || (frame[0] != TEST_PKT_SYNC_BYTE0) || (frame[1] != TEST_PKT_SYNC_BYTE1))
+        return 0;
+
+    length = frame[2];
+    if(size < (size_t)(length + TEST_PKT_OVERHEAD))
+        return 0;
+
+    check = (uint16_t)((frame[length+4] << 8) | frame[length+5]);
+    if(fletcher16(frame, length+4) != check)
+        return 0;
+
+    return length + TEST_PKT_OVERHEAD;
+
+}// getDemolinkFrameLength
+
 /*!
  * Check a received packet for correct checksum.
  * \param pkt is the packet to check.
@@ -6,4 +6,10 @@
 //! Look for an incoming packet in a sequence of bytes
 int lookForDemolinkPacket(testPacket_t* pkt, uint8_t byte);
 
+//! Find the length of a packet frame at the start of a series of bytes
+#ifdef __cplusplus
+extern "C"
+#endif
+int getDemolinkFrameLength(const uint8_t* frame, size_t size);
+
 #endif // PACKETINTERFACE_H
@@ -0,0 +1,5 @@
+// The replay tool is built into the test program, with its main() renamed,
+// so that the test can run it on a capture file
+#define main replayDemolink
+#include "DemolinkReplay.cpp"
+#undef main
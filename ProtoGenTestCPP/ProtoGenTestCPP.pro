@@ -3,6 +3,9 @@ QT -= gui
 CONFIG += c++11 console
 CONFIG -= app_bundle
 
+# The shared memory channel uses shm_open, which older glibc keeps in librt
+unix:!macx: LIBS += -lrt
+
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
 # depend on your compiler). Please consult the documentation of the
@@ -14,22 +17,36 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# The protocol sources are generated by: ProtoGen ../exampleprotocol_cpp.xml . -no-doxygen -replay -columns -log -udp -shm
 SOURCES += \
+        DemolinkColumns.cpp \
+        DemolinkLog.cpp \
+        DemolinkShm.cpp \
+        DemolinkUdp.cpp \
         DemolinkProtocol.cpp \
         Engine.cpp \
         GPS.cpp \
         TelemetryPacket.cpp \
         base_types.cpp \
         bitfieldtest.cpp \
+        columntable.cpp \
         fielddecode.cpp \
         fieldencode.cpp \
         floatspecial.cpp \
         globaldependson.cpp \
+        iovencode.cpp \
         linkcode.cpp \
         main.cpp \
         packetinterface.cpp \
+        packetlog.cpp \
+        packetqueue.cpp \
+        replay.cpp \
+        ringencode.cpp \
         scaleddecode.cpp \
-        scaledencode.cpp
+        scaledencode.cpp \
+        shmchannel.cpp \
+        spanarena.cpp \
+        udpbatch.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -37,6 +54,10 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 HEADERS += \
+    DemolinkColumns.hpp \
+    DemolinkLog.hpp \
+    DemolinkShm.hpp \
+    DemolinkUdp.hpp \
     DemolinkProtocol.hpp \
     Engine.hpp \
     EngineDefinitions.hpp \
@@ -44,11 +65,19 @@ HEADERS += \
     TelemetryPacket.hpp \
     base_types.hpp \
     bitfieldtest.hpp \
+    columntable.hpp \
     fielddecode.hpp \
     fieldencode.hpp \
     floatspecial.hpp \
     globaldependson.hpp \
+    iovencode.hpp \
     linkcode.hpp \
+    packetlog.hpp \
+    packetqueue.hpp \
+    ringencode.hpp \
     scaleddecode.hpp \
-    scaledencode.hpp
+    scaledencode.hpp \
+    shmchannel.hpp \
+    spanarena.hpp \
+    udpbatch.hpp
 
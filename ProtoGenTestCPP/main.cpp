@@ -1,5 +1,8 @@
 #include <QDateTime>
 #include <iostream>
+#include <vector>
+#include <cstdio>
+#include <ctime>
 #include <math.h>
 #include "bitfieldtest.hpp"
 #include "floatspecial.hpp"
@@ -8,6 +11,10 @@
 #include "TelemetryPacket.hpp"
 #include "packetinterface.h"
 #include "linkcode.hpp"
+#include "DemolinkColumns.hpp"
+#include "DemolinkLog.hpp"
+#include "DemolinkUdp.hpp"
+#include "DemolinkShm.hpp"
 #include "fieldencode.hpp"
 
 #define PI 3.141592653589793
@@ -34,9 +41,25 @@ static int testZeroLengthPacket(void);
 static int testBitfieldGroupPacket(void);
 static int testMultiDimensionPacket(void);
 static int testDefaultStringsPacket(void);
+static int testSpanPacket(void);
+static int testImageIovPacket(void);
+static int testImageRingPacket(void);
+static int testPacketQueue(void);
+static int testReplayTool(void);
+static int testColumns(void);
+static int testPacketLog(void);
+static void encodeEngineCommandValue(testPacket_c* pkt, float value);
+static int isEngineCommandValue(const testPacket_c* pkt, float value);
+static int testUdpBatch(void);
+static int testShmChannel(void);
+static void udpBatchHandler(const testPacket_c* pkt, const PgUdpDatagram& datagram, void* context);
+static uint64_t columnValue(const PgColumnTable& table, const std::string& name, std::size_t row, bool* valid);
 
 static int fcompare(double input1, double input2, double epsilon);
 
+//! The generated replay tool, which replay.cpp builds into this program
+int replayDemolink(int argc, char* argv[]);
+
 int main(int argc, char *argv[])
 {
     (void)argc;
@@ -101,6 +124,33 @@ int main(int argc, char *argv[])
     if(testDefaultStringsPacket() == 0)
         Return = 0;
 
+    if(testSpanPacket() == 0)
+        Return = 0;
+
+    if(testImageIovPacket() == 0)
+        Return = 0;
+
+    if(testImageRingPacket() == 0)
+        Return = 0;
+
+    if(testPacketQueue() == 0)
+        Return = 0;
+
+    if(testReplayTool() == 0)
+        Return = 0;
+
+    if(testColumns() == 0)
+        Return = 0;
+
+    if(testPacketLog() == 0)
+        Return = 0;
+
+    if(testUdpBatch() == 0)
+        Return = 0;
+
+    if(testShmChannel() == 0)
+        Return = 0;
+
     if(Return == 1)
         std::cout << "All tests passed" << std::endl;
 
@@ -1170,6 +1220,716 @@ int testDefaultStringsPacket(void)
 }
 
 
+int testSpanPacket(void)
+{
+    float readings[50];
+    Date_c dates[10];
+    Span_c span;
+    testPacket_c pkt;
+    pgarena_t arena;
+    uint64_t storage[(Span_c::maxSpanStorage() + 7)/8];
+
+    span.numReadings = 20;
+    span.readings = readings;
+    for(int i = 0; i < span.numReadings; i++)
+        readings[i] = i*2.5f - 50.0f;
+
+    span.numDates = 2;
+    span.dates = dates;
+    dates[0].year = 2017;
+    dates[0].month = 7;
+    dates[0].day = 4;
+    dates[1].year = 2069;
+    dates[1].month = 7;
+    dates[1].day = 20;
+
+    span.fixed[0] = 1;
+    span.fixed[3] = 4;
+
+    span.encode(&pkt);
+
+    if(pkt.length != (2 + 20*2 + 1 + 2*Date_c::minLength() + 4))
+    {
+        std::cout << "Span packet has the wrong length" << std::endl;
+        return 0;
+    }
+
+    // The arena is sized for the largest packet, which holds two of these
+    initArena(&arena, storage, sizeof(storage));
+    for(int pass = 0; pass < 2; pass++)
+    {
+        span = Span_c();
+        if(!span.decode(&pkt, arena))
+        {
+            std::cout << "Span_c::decode() failed" << std::endl;
+            return 0;
+        }
+
+        if( ((uint8_t*)span.readings < (uint8_t*)storage) ||
+            ((uint8_t*)(span.dates + span.numDates) > (uint8_t*)storage + sizeof(storage)))
+        {
+            std::cout << "Span_c::decode() did not use the arena" << std::endl;
+            return 0;
+        }
+
+        if((span.numReadings != 20) || (span.numDates != 2) || (span.fixed[0] != 1) || (span.fixed[3] != 4))
+        {
+            std::cout << "Span_c::decode() yielded incorrect data" << std::endl;
+            return 0;
+        }
+
+        for(int i = 0; i < span.numReadings; i++)
+        {
+            if(fcompare(span.readings[i], i*2.5f - 50.0f, 100.0/32767))
+            {
+                std::cout << "Span_c::decode() yielded incorrect readings" << std::endl;
+                return 0;
+            }
+        }
+
+        if( (span.dates[0].year != 2017) || (span.dates[0].month != 7) || (span.dates[0].day != 4) ||
+            (span.dates[1].year != 2069) || (span.dates[1].month != 7) || (span.dates[1].day != 20))
+        {
+            std::cout << "Span_c::decode() yielded incorrect dates" << std::endl;
+            return 0;
+        }
+    }
+
+    // The third packet does not fit until the arena is reset
+    if(span.decode(&pkt, arena))
+    {
+        std::cout << "Span_c::decode() decoded into an arena that is full" << std::endl;
+        return 0;
+    }
+
+    resetArena(&arena);
+    if(!span.decode(&pkt, arena))
+    {
+        std::cout << "Span_c::decode() failed after the arena was reset" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testSpanPacket
+
+
+int testImageIovPacket(void)
+{
+    Image_c image;
+    testPacket_c pkt, iovpkt;
+    struct iovec iov[Image_c::maxIovCount()];
+    uint8_t gathered[sizeof(pkt.data)];
+    int numiov;
+    size_t length = 0;
+
+    image.frame = 0x1234;
+    image.numPixels = 150;
+    for(int i = 0; i < image.numPixels; i++)
+        image.pixels[i] = (uint8_t)(i*7);
+    image.gain = -2.5f;
+    image.tag[0] = -1;
+    image.tag[3] = 100;
+
+    image.encode(&pkt);
+
+    numiov = image.encodeIov(&iovpkt, iov, Image_c::maxIovCount());
+    if(numiov <= 0)
+    {
+        std::cout << "Image_c::encodeIov() failed" << std::endl;
+        return 0;
+    }
+
+    // The pixels are sent from the structure, not copied into the packet
+    int pixelentry = 0;
+    for(int i = 0; i < numiov; i++)
+    {
+        if(iov[i].iov_base == (void*)image.pixels)
+            pixelentry = 1;
+
+        memcpy(gathered + length, iov[i].iov_base, iov[i].iov_len);
+        length += iov[i].iov_len;
+    }
+
+    if(!pixelentry)
+    {
+        std::cout << "Image_c::encodeIov() copied the pixels" << std::endl;
+        return 0;
+    }
+
+    if((length != (size_t)pkt.length) || (length != iovLength(iov, numiov)) || (memcmp(gathered, pkt.data, length) != 0))
+    {
+        std::cout << "Image_c::encodeIov() data differ from Image_c::encode()" << std::endl;
+        return 0;
+    }
+
+    if(image.encodeIov(&iovpkt, iov, 1) != 0)
+    {
+        std::cout << "Image_c::encodeIov() did not fail with too few entries" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testImageIovPacket
+
+
+int testImageRingPacket(void)
+{
+    Image_c image;
+    testPacket_c pkt;
+    pgring_t ring;
+    uint8_t storage[400 + sizeof(pkt.data)];
+    uint8_t data[sizeof(pkt.data)];
+    int total = 0;
+
+    // The end of the storage is slack for a packet that wraps around the end of the ring
+    initRing(&ring, storage, sizeof(storage), Image_c::maxLength());
+
+    image.gain = 1.5f;
+    image.tag[1] = 12;
+
+    // Packets of different sizes, so they wrap at different places
+    for(int count = 0; count < 20; count++)
+    {
+        image.frame = (uint16_t)count;
+        image.numPixels = (uint8_t)(50 + (count*37) % 150);
+        for(int i = 0; i < image.numPixels; i++)
+            image.pixels[i] = (uint8_t)(count + i);
+
+        image.encode(&pkt);
+
+        int length = image.encodeRing(ring);
+
+        if((length != pkt.length) || (ringUsed(&ring) != (uint32_t)length))
+        {
+            std::cout << "Image_c::encodeRing() added the wrong number of bytes" << std::endl;
+            return 0;
+        }
+
+        if((readRing(&ring, data, (uint32_t)length) != (uint32_t)length) || (memcmp(data, pkt.data, length) != 0))
+        {
+            std::cout << "Image_c::encodeRing() data differ from Image_c::encode()" << std::endl;
+            return 0;
+        }
+    }
+
+    // Without a consumer the ring fills up, and then nothing is added
+    while(1)
+    {
+        int length = image.encodeRing(ring);
+        if(length == 0)
+            break;
+
+        total += length;
+    }
+
+    if((total == 0) || (ringUsed(&ring) != (uint32_t)total) || (ringSpace(&ring) >= (uint32_t)Image_c::maxLength()))
+    {
+        std::cout << "Image_c::encodeRing() did not stop when the ring was full" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testImageRingPacket
+
+
+int testPacketQueue(void)
+{
+    pgqueue_t queue;
+    testPacket_c storage[8];
+    testPacket_c* pkt;
+    EngineCommand_c eng;
+
+    if(initDemolinkQueue(&queue, storage, 6))
+    {
+        std::cout << "Packet queue accepted a slot count that is not a power of two" << std::endl;
+        return 0;
+    }
+
+    if(!initDemolinkQueue(&queue, storage, 8) || (peekDemolinkQueue(&queue) != NULL))
+    {
+        std::cout << "Packet queue failed to initialize empty" << std::endl;
+        return 0;
+    }
+
+    // Packets are encoded in place in the slots, run through the queue twice so the slots are reused
+    for(int pass = 0; pass < 2; pass++)
+    {
+        for(int i = 0; i < 8; i++)
+        {
+            pkt = reserveDemolinkQueue(&queue);
+            if(pkt == NULL)
+            {
+                std::cout << "Packet queue is full too soon" << std::endl;
+                return 0;
+            }
+
+            eng.command = pass*100.0f + i;
+            eng.encode(pkt);
+            commitQueue(&queue);
+        }
+
+        if((reserveDemolinkQueue(&queue) != NULL) || (queueUsed(&queue) != 8))
+        {
+            std::cout << "Packet queue is not full" << std::endl;
+            return 0;
+        }
+
+        // Packets are decoded in place, in the order they were committed
+        for(int i = 0; i < 8; i++)
+        {
+            pkt = peekDemolinkQueue(&queue);
+            if((pkt == NULL) || !eng.decode(pkt) || (eng.command != pass*100.0f + i))
+            {
+                std::cout << "Packet queue yielded incorrect packets" << std::endl;
+                return 0;
+            }
+
+            releaseQueue(&queue);
+        }
+
+        if((peekDemolinkQueue(&queue) != NULL) || (queueUsed(&queue) != 0))
+        {
+            std::cout << "Packet queue is not empty" << std::endl;
+            return 0;
+        }
+    }
+
+    return 1;
+
+}// testPacketQueue
+
+
+int testReplayTool(void)
+{
+    std::vector<long> offsets;
+    EngineCommand_c eng;
+    testPacket_c pkt;
+    char packet[64], good[8];
+    unsigned long offset, length;
+    unsigned id;
+    std::size_t line = 0;
+    int result = 1;
+
+    // Enough frames that the capture is split into several one megabyte chunks
+    FILE* file = fopen("Demolink.capture", "wb");
+    if(file == NULL)
+    {
+        std::cout << "Could not create the replay capture file" << std::endl;
+        return 0;
+    }
+
+    for(int i = 0; i < 250000; i++)
+    {
+        eng.command = (float)i;
+        eng.encode(&pkt);
+
+        // Every thousandth frame is too short to decode, but has a good checksum
+        if((i % 1000) == 999)
+            finishDemolinkPacket(&pkt, 2, ENGINECOMMAND);
+
+        // Bytes between frames, including a false start, are skipped
+        if((i % 7) == 0)
+            fputc(TEST_PKT_SYNC_BYTE0, file);
+
+        offsets.push_back(ftell(file));
+        fwrite(&pkt, 1, pkt.length + TEST_PKT_OVERHEAD, file);
+    }
+
+    fclose(file);
+
+    char* arguments[] = {(char*)"DemolinkReplay", (char*)"-threads", (char*)"4", (char*)"-chunk", (char*)"1", (char*)"-list", (char*)"Demolink.replay", (char*)"Demolink.capture"};
+    if(replayDemolink(8, arguments) != 0)
+    {
+        std::cout << "Replay tool failed" << std::endl;
+        remove("Demolink.capture");
+        return 0;
+    }
+
+    // The listing has a line for every frame, in file order, after the heading
+    file = fopen("Demolink.replay", "r");
+    if((file == NULL) || (fscanf(file, "%*[^\n]\n") != 0))
+        result = 0;
+
+    while(result && (fscanf(file, "%lu,%63[^,],%u,%lu,%7s\n", &offset, packet, &id, &length, good) == 5))
+    {
+        const char* expected = ((line % 1000) == 999) ? "0" : "1";
+
+        if( (line >= offsets.size()) || (offset != (unsigned long)offsets.at(line)) ||
+            (strcmp(packet, "EngineCommand") != 0) || (id != ENGINECOMMAND) || (strcmp(good, expected) != 0))
+            result = 0;
+
+        line++;
+    }
+
+    if(file != NULL)
+        fclose(file);
+
+    remove("Demolink.capture");
+    remove("Demolink.replay");
+
+    if(!result || (line != offsets.size()))
+    {
+        std::cout << "Replay tool listing is wrong" << std::endl;
+        return 0;
+    }
+
+    return 1;
+
+}// testReplayTool
+
+
+int testColumns(void)
+{
+    PgColumnTable table;
+    ThrottleSettings_c settings;
+    testPacket_c pkt;
+    bool valid;
+
+    settings.enableCurve = 1;
+    settings.lowPWM = 1000;
+    settings.highPWM = 2000;
+
+    // Two rows, with different numbers of curve points
+    for(int row = 0; row < 2; row++)
+    {
+        settings.numCurvePoints = (row == 0) ? 5 : 2;
+        for(uint32_t i = 0; i < settings.numCurvePoints; i++)
+        {
+            settings.curvePoint[i].PWM = settings.lowPWM + i*100 + row;
+            settings.curvePoint[i].throttle = i*0.2f;
+        }
+
+        settings.encode(&pkt);
+
+        if(!appendThrottleSettingsColumns(table, &pkt))
+        {
+            std::cout << "appendThrottleSettingsColumns() failed" << std::endl;
+            return 0;
+        }
+    }
+
+    // A packet that does not decode is not appended
+    pkt.length = 1;
+    if(appendThrottleSettingsColumns(table, &pkt) || (table.rows() != 2))
+    {
+        std::cout << "appendThrottleSettingsColumns() appended a bad packet" << std::endl;
+        return 0;
+    }
+
+    // A column for every field, and every element of the curve points
+    if((table.columns.size() != 2 + 10*2 + 3) || (table.columns.at(0).name != "numCurvePoints"))
+    {
+        std::cout << "Throttle settings columns are wrong" << std::endl;
+        return 0;
+    }
+
+    if( (columnValue(table, "numCurvePoints", 0, &valid) != 5) || !valid ||
+        (columnValue(table, "numCurvePoints", 1, &valid) != 2) || !valid ||
+        (columnValue(table, "highPWM", 1, &valid) != 2000) || !valid ||
+        (columnValue(table, "curvePoint[3]:PWM", 0, &valid) != 1300) || !valid ||
+        (columnValue(table, "curvePoint[1]:PWM", 1, &valid) != 1101) || !valid)
+    {
+        std::cout << "Throttle settings column values are wrong" << std::endl;
+        return 0;
+    }
+
+    // Curve points past the end of the variable array are null
+    columnValue(table, "curvePoint[3]:PWM", 1, &valid);
+    if(valid)
+    {
+        std::cout << "Throttle settings column is not null past the end of the curve" << std::endl;
+        return 0;
+    }
+
+    if(!table.write("Demolink.columns"))
+    {
+        std::cout << "Column table failed to write" << std::endl;
+        return 0;
+    }
+
+    remove("Demolink.columns");
+
+    return 1;
+
+}// testColumns
+
+
+/*!
+ * Encode an engine command packet, for the tests that pass packets through
+ * the log, UDP, and shared memory outputs and check what comes back
+ * \param pkt receives the encoded packet
+ * \param value is the command of the packet
+ */
+void encodeEngineCommandValue(testPacket_c* pkt, float value)
+{
+    EngineCommand_c eng;
+
+    eng.command = value;
+    eng.encode(pkt);
+
+}// encodeEngineCommandValue
+
+
+/*!
+ * Check a packet that came back from the log, UDP, or shared memory outputs
+ * \param pkt is the packet to check
+ * \param value is the command the packet was encoded with
+ * \return 1 if the packet decodes as an engine command with the command value
+ */
+int isEngineCommandValue(const testPacket_c* pkt, float value)
+{
+    EngineCommand_c eng;
+
+    if(!eng.decode(pkt))
+        return 0;
+
+    return (eng.command == value) ? 1 : 0;
+
+}// isEngineCommandValue
+
+
+int testPacketLog(void)
+{
+    PgLogWriter writer;
+    PgLogReader reader;
+    testPacket_c pkt;
+    const PgLogEntry* entries;
+    std::size_t number;
+
+    if(!openDemolinkLogWriter(writer, "Demolink.pglog"))
+    {
+        std::cout << "openDemolinkLogWriter() failed" << std::endl;
+        return 0;
+    }
+
+    // Engine commands every 10 time units, with a keep alive after every fourth
+    for(int i = 0; i < 100; i++)
+    {
+        encodeEngineCommandValue(&pkt, (float)i);
+        writeDemolinkLog(writer, i*10, &pkt);
+
+        if((i % 4) == 3)
+        {
+            KeepAlive_c::encode(&pkt);
+            writeDemolinkLog(writer, i*10, &pkt);
+        }
+    }
+
+    if(!writer.close() || !openDemolinkLogReader(reader, "Demolink.pglog"))
+    {
+        std::cout << "Packet log failed to close or open" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    if((reader.count(ENGINECOMMAND) != 100) || (reader.count(KEEPALIVE) != 25) || (reader.ids().size() != 2))
+    {
+        std::cout << "Packet log index is wrong" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    // Seek straight to the engine commands from time 200 to 400, inclusive
+    entries = reader.entries(ENGINECOMMAND, 200, 400, number);
+    if(number != 21)
+    {
+        std::cout << "Packet log time range is wrong" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    for(std::size_t i = 0; i < number; i++)
+    {
+        PgLogRecord record = reader.record(entries[i]);
+
+        readDemolinkLog(record, &pkt);
+        if( (record.time != 200 + i*10) || !isEngineCommandValue(&pkt, 20.0f + i))
+        {
+            std::cout << "Packet log record is wrong" << std::endl;
+            remove("Demolink.pglog");
+            return 0;
+        }
+    }
+
+    // All the records in a range, in the order they were written
+    std::vector<PgLogEntry> all = reader.allEntries(30, 40);
+    if( (all.size() != 3) ||
+        (reader.record(all.at(0)).id != ENGINECOMMAND) ||
+        (reader.record(all.at(1)).id != KEEPALIVE) ||
+        (reader.record(all.at(2)).time != 40))
+    {
+        std::cout << "Packet log records of all packets are wrong" << std::endl;
+        remove("Demolink.pglog");
+        return 0;
+    }
+
+    reader.close();
+    remove("Demolink.pglog");
+
+    return 1;
+
+}// testPacketLog
+
+
+//! Packets received by testUdpBatch()
+typedef struct
+{
+    int count;          //!< Number of engine commands received
+    int outOfOrder;     //!< Number of engine commands with the wrong value
+}udpReceived_t;
+
+
+void udpBatchHandler(const testPacket_c* pkt, const PgUdpDatagram& datagram, void* context)
+{
+    udpReceived_t* received = (udpReceived_t*)context;
+
+    (void)datagram;
+
+    if(isEngineCommandValue(pkt, (float)received->count))
+        received->count++;
+    else
+        received->outOfOrder++;
+
+}// udpBatchHandler
+
+
+int testUdpBatch(void)
+{
+    PgUdpBatch* udp = newDemolinkUdp();
+    udpReceived_t received = {0, 0};
+    int invalid = 0;
+    int result = 1;
+
+    // Send to ourselves on the loopback interface
+    if(!udp->open("127.0.0.1", 0) || !udp->setDestination("127.0.0.1", udp->port()))
+    {
+        std::cout << "Failed to open the UDP socket" << std::endl;
+        delete udp;
+        return 0;
+    }
+
+    for(int i = 0; i < 20; i++)
+    {
+        encodeEngineCommandValue(reserveDemolinkUdp(*udp), (float)i);
+        if(!commitDemolinkUdp(*udp, reserveDemolinkUdp(*udp)))
+            result = 0;
+    }
+
+    // A datagram that is not a frame
+    memset(udp->reserve(), 0x55, 8);
+    udp->commit(8);
+    udp->flush();
+
+    while((received.count + received.outOfOrder < 20) || (invalid < 1))
+    {
+        if(receiveDemolinkUdp(*udp, 1000, udpBatchHandler, &received, &invalid) <= 0)
+            break;
+    }
+
+    if((result == 0) || (received.count != 20) || (received.outOfOrder != 0) || (invalid != 1))
+    {
+        std::cout << "UDP batch received " << received.count << " packets, " << received.outOfOrder << " out of order, " << invalid << " invalid" << std::endl;
+        result = 0;
+    }
+
+    delete udp;
+
+    return result;
+
+}// testUdpBatch
+
+
+int testShmChannel(void)
+{
+    PgShmChannel publisher;
+    PgShmChannel consumer;
+    PgShmMessage message;
+    EngineCommand_c eng;
+    testPacket_c pkt;
+    char name[64];
+    int result = 1;
+
+    // A name no other run of this test is using
+    snprintf(name, sizeof(name), "/protogentest%ld", (long)clock());
+
+    if(!createDemolinkShm(publisher, name, 8) || !openDemolinkShm(consumer, name))
+    {
+        std::cout << "Failed to create shared memory " << name << std::endl;
+        PgShmChannel::unlink(name);
+        return 0;
+    }
+
+    // The shared memory is still mapped once its name is gone
+    PgShmChannel::unlink(name);
+
+    // A decoded structure, and then a packet
+    eng.command = 0.25f;
+    publishEngineCommandShm(publisher, &eng);
+    encodeEngineCommandValue(&pkt, 0.75f);
+    publishDemolinkPacketShm(publisher, &pkt);
+
+    eng = EngineCommand_c();
+    if(!consumer.read(message) || !readEngineCommandShm(message, &eng) || (eng.command != 0.25f))
+        result = 0;
+
+    if( !consumer.read(message) || !readDemolinkPacketShm(message, &pkt) ||
+        !isEngineCommandValue(&pkt, 0.75f))
+        result = 0;
+
+    // Nothing more to read, and a packet is not read as a structure
+    if(consumer.read(message) || readEngineCommandShm(message, &eng))
+        result = 0;
+
+    // Lap the consumer, which loses the oldest messages
+    for(int i = 0; i < 20; i++)
+    {
+        eng.command = (float)i;
+        publishEngineCommandShm(publisher, &eng);
+    }
+
+    for(int i = 12; i < 20; i++)
+    {
+        if(!consumer.read(message) || !readEngineCommandShm(message, &eng) || (eng.command != (float)i))
+            result = 0;
+    }
+
+    if((consumer.lost() != 12) || consumer.read(message))
+        result = 0;
+
+    if(result == 0)
+        std::cout << "Shared memory channel failed, " << consumer.lost() << " messages lost" << std::endl;
+
+    return result;
+
+}// testShmChannel
+
+
+uint64_t columnValue(const PgColumnTable& table, const std::string& name, std::size_t row, bool* valid)
+{
+    uint64_t value = 0;
+
+    *valid = false;
+
+    for(std::size_t i = 0; i < table.columns.size(); i++)
+    {
+        const PgColumn& column = table.columns.at(i);
+
+        if((column.name != name) || (column.type != PgColumn::UInt64) || (row >= column.length))
+            continue;
+
+        memcpy(&value, column.values.data() + row*sizeof(value), sizeof(value));
+        *valid = (column.validity.at(row/8) & (1 << (row % 8))) != 0;
+        break;
+    }
+
+    return value;
+
+}// columnValue
+
+
 int fcompare(double input1, double input2, double epsilon)
 {
     if(fabs(input1 - input2) > epsilon)
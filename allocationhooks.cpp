@@ -0,0 +1,160 @@
+#include "protocolprofiler.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+// Replacements for the global allocation functions, which report every
+// allocation and free to the ProtocolProfiler while profiling is enabled.
+// Replacing operator new affects the whole program, so this file is not part
+// of the generator itself, only the ProtoGen application and the benchmark
+// link it. A program that embeds the ProtocolParser without this file gets
+// the profiler's timing, but no memory figures.
+
+// Tell the profiler that allocations can be counted
+static const bool hooksInstalled = ProtocolProfiler::installAllocationHooks();
+
+/*!
+ * Return the number of bytes the heap reserved for an allocation, which is
+ * the same when the memory is allocated and freed, so the profiler's count
+ * of bytes in use balances.
+ * \param pointer is the memory, which must not be nullptr
+ * \param alignment is the alignment it was allocated with, 0 for the default alignment
+ * \return the usable size of the memory
+ */
+static std::size_t allocatedSize(void* pointer, std::size_t alignment)
+{
+    #if defined(_WIN32)
+    if(alignment > 0)
+        return _aligned_msize(pointer, alignment, 0);
+    else
+        return _msize(pointer);
+    #elif defined(__APPLE__)
+    (void)alignment;
+    return malloc_size(pointer);
+    #else
+    (void)alignment;
+    return malloc_usable_size(pointer);
+    #endif
+}
+
+
+/*!
+ * Allocate memory for the replacement global allocation functions. Like the
+ * standard functions this calls the new handler until the allocation
+ * succeeds, or there is no handler.
+ * \param size is the number of bytes to allocate
+ * \param alignment is the alignment of the memory, 0 for the default alignment
+ * \param nothrow should be true to return nullptr instead of throwing
+ * \return the memory, or nullptr if it could not be allocated and nothrow is true
+ */
+static void* countedAllocate(std::size_t size, std::size_t alignment, bool nothrow)
+{
+    if(size == 0)
+        size = 1;
+
+    // aligned_alloc() needs the size to be a multiple of the alignment
+    if(alignment > 0)
+        size = ((size + alignment - 1)/alignment)*alignment;
+
+    while(true)
+    {
+        void* pointer;
+
+        #if defined(_WIN32)
+        if(alignment > 0)
+            pointer = _aligned_malloc(size, alignment);
+        else
+            pointer = std::malloc(size);
+        #else
+        if(alignment > 0)
+            pointer = std::aligned_alloc(alignment, size);
+        else
+            pointer = std::malloc(size);
+        #endif
+
+        if(pointer != nullptr)
+        {
+            if(ProtocolProfiler::isCounting())
+                ProtocolProfiler::countAllocation(allocatedSize(pointer, alignment));
+
+            return pointer;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if(handler == nullptr)
+        {
+            if(nothrow)
+                return nullptr;
+            else
+                throw std::bad_alloc();
+        }
+
+        try
+        {
+            handler();
+        }
+        catch(const std::bad_alloc&)
+        {
+            if(nothrow)
+                return nullptr;
+            else
+                throw;
+        }
+    }
+
+}// countedAllocate
+
+
+/*!
+ * Free memory from countedAllocate()
+ * \param pointer is the memory to free, which can be nullptr
+ * \param alignment is the alignment it was allocated with, 0 for the default alignment
+ */
+static void countedFree(void* pointer, std::size_t alignment)
+{
+    if(pointer == nullptr)
+        return;
+
+    if(ProtocolProfiler::isCounting())
+        ProtocolProfiler::countFree(allocatedSize(pointer, alignment));
+
+    #if defined(_WIN32)
+    if(alignment > 0)
+        _aligned_free(pointer);
+    else
+        std::free(pointer);
+    #else
+    std::free(pointer);
+    #endif
+}
+
+// Replacements for all the global allocation functions, so every allocation
+// is counted while profiling, including arrays, aligned and nothrow forms.
+void* operator new(std::size_t size) {return countedAllocate(size, 0, false);}
+void* operator new[](std::size_t size) {return countedAllocate(size, 0, false);}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {return countedAllocate(size, 0, true);}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {return countedAllocate(size, 0, true);}
+void* operator new(std::size_t size, std::align_val_t align) {return countedAllocate(size, static_cast<std::size_t>(align), false);}
+void* operator new[](std::size_t size, std::align_val_t align) {return countedAllocate(size, static_cast<std::size_t>(align), false);}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {return countedAllocate(size, static_cast<std::size_t>(align), true);}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {return countedAllocate(size, static_cast<std::size_t>(align), true);}
+
+void operator delete(void* pointer) noexcept {countedFree(pointer, 0);}
+void operator delete[](void* pointer) noexcept {countedFree(pointer, 0);}
+void operator delete(void* pointer, std::size_t) noexcept {countedFree(pointer, 0);}
+void operator delete[](void* pointer, std::size_t) noexcept {countedFree(pointer, 0);}
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {countedFree(pointer, 0);}
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {countedFree(pointer, 0);}
+void operator delete(void* pointer, std::align_val_t align) noexcept {countedFree(pointer, static_cast<std::size_t>(align));}
+void operator delete[](void* pointer, std::align_val_t align) noexcept {countedFree(pointer, static_cast<std::size_t>(align));}
+void operator delete(void* pointer, std::size_t, std::align_val_t align) noexcept {countedFree(pointer, static_cast<std::size_t>(align));}
+void operator delete[](void* pointer, std::size_t, std::align_val_t align) noexcept {countedFree(pointer, static_cast<std::size_t>(align));}
+void operator delete(void* pointer, std::align_val_t align, const std::nothrow_t&) noexcept {countedFree(pointer, static_cast<std::size_t>(align));}
+void operator delete[](void* pointer, std::align_val_t align, const std::nothrow_t&) noexcept {countedFree(pointer, static_cast<std::size_t>(align));}
@@ -0,0 +1,109 @@
+#include "attributeindex.h"
+
+/*!
+ * Convert a character to lower case, only for 'A' to 'Z'. This matches the
+ * comparison done by XMLUtil::StringEqual(), which leaves UTF-8 alone.
+ * \param c is the character to convert
+ * \return the lower case character
+ */
+static inline char attributeNameLower(char c)
+{
+    if((c >= 'A') && (c <= 'Z'))
+        return (char)(c + ('a' - 'A'));
+    else
+        return c;
+}
+
+
+/*!
+ * Compute a hash of an attribute name without regard to case
+ * \param name is the name to hash
+ * \return the hash of the name
+ */
+std::size_t AttributeNameHash::operator()(std::string_view name) const
+{
+    // FNV-1a, which is plenty for the short names used by attributes
+    std::size_t hash = 2166136261u;
+
+    for(char c : name)
+    {
+        hash ^= (unsigned char)attributeNameLower(c);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+
+/*!
+ * Determine if two attribute names are equal without regard to case
+ * \param one is the first name to compare
+ * \param two is the second name to compare
+ * \return true if the names are equal
+ */
+bool AttributeNameEqual::operator()(std::string_view one, std::string_view two) const
+{
+    if(one.size() != two.size())
+        return false;
+
+    for(std::size_t i = 0; i < one.size(); i++)
+    {
+        if(attributeNameLower(one[i]) != attributeNameLower(two[i]))
+            return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * Construct a set of attribute names
+ * \param list is the list of names, which must be string literals
+ */
+AttributeNames::AttributeNames(std::initializer_list<std::string_view> list) :
+    names(list)
+{
+}
+
+
+/*!
+ * Construct a set of attribute names that extends another set
+ * \param base is the set to extend
+ * \param list is the list of additional names, which must be string literals
+ */
+AttributeNames::AttributeNames(const AttributeNames& base, std::initializer_list<std::string_view> list) :
+    names(base.names)
+{
+    names.insert(list.begin(), list.end());
+}
+
+
+/*!
+ * Construct the index from the first attribute of an element
+ * \param firstattrib is the first attribute of the element, which can be null
+ */
+AttributeIndex::AttributeIndex(const XMLAttribute* firstattrib) :
+    first(firstattrib)
+{
+    for(const XMLAttribute* a = first; a != nullptr; a = a->Next())
+    {
+        // emplace does not replace, so the first attribute with a name is kept
+        attributes.emplace(a->Name(), a);
+    }
+}
+
+
+/*!
+ * Find an attribute by name
+ * \param name is the name of the attribute, case is ignored
+ * \return the attribute, or nullptr if the element does not have it
+ */
+const XMLAttribute* AttributeIndex::find(std::string_view name) const
+{
+    std::unordered_map<std::string_view, const XMLAttribute*, AttributeNameHash, AttributeNameEqual>::const_iterator it = attributes.find(name);
+
+    if(it == attributes.end())
+        return nullptr;
+    else
+        return it->second;
+}
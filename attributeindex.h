@@ -0,0 +1,83 @@
+#ifndef ATTRIBUTEINDEX_H
+#define ATTRIBUTEINDEX_H
+
+#include "tinyxml2.h"
+#include <unordered_set>
+#include <unordered_map>
+#include <initializer_list>
+#include <string_view>
+#include <string>
+
+using namespace tinyxml2;
+
+//! Hash of attribute names that ignores case, to match XMLUtil::StringEqual()
+class AttributeNameHash
+{
+public:
+    std::size_t operator()(std::string_view name) const;
+};
+
+//! Comparison of attribute names that ignores case, to match XMLUtil::StringEqual()
+class AttributeNameEqual
+{
+public:
+    bool operator()(std::string_view one, std::string_view two) const;
+};
+
+
+/*!
+ * A set of attribute names that are understood by an object. The names are
+ * compared without regard to case. The names are not copied, they must be
+ * string literals (or otherwise outlive the set). Sets are intended to be
+ * built once as static objects and shared by every object of a class.
+ */
+class AttributeNames
+{
+public:
+
+    //! Construct a set of attribute names
+    AttributeNames(std::initializer_list<std::string_view> names);
+
+    //! Construct a set of attribute names that extends another set
+    AttributeNames(const AttributeNames& base, std::initializer_list<std::string_view> names);
+
+    //! Determine if a name is in the set
+    bool contains(std::string_view name) const {return names.find(name) != names.end();}
+
+protected:
+
+    //! The names in the set
+    std::unordered_set<std::string_view, AttributeNameHash, AttributeNameEqual> names;
+};
+
+
+/*!
+ * An index of the attributes of one XML element, by name. The index is built
+ * once per element so that repeated lookups do not walk the attribute list.
+ * Names are compared without regard to case, and if an attribute appears more
+ * than once the first one is used. The index refers into the DOM, which must
+ * outlive it.
+ */
+class AttributeIndex
+{
+public:
+
+    //! Construct the index from the first attribute of an element
+    explicit AttributeIndex(const XMLAttribute* first);
+
+    //! Find an attribute by name
+    const XMLAttribute* find(std::string_view name) const;
+
+    //! Return the first attribute of the element
+    const XMLAttribute* firstAttribute(void) const {return first;}
+
+protected:
+
+    //! The first attribute of the element
+    const XMLAttribute* first;
+
+    //! The attributes of the element by name
+    std::unordered_map<std::string_view, const XMLAttribute*, AttributeNameHash, AttributeNameEqual> attributes;
+};
+
+#endif // ATTRIBUTEINDEX_H
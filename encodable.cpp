@@ -4,12 +4,18 @@
 #include "protocolcode.h"
 #include "protocoldocumentation.h"
 #include "protocolparser.h"
+#include "shuntingyard.h"
+#include "precompiledlibrary.h"
+#include <sstream>
+#include <iomanip>
+#include <limits>
 
 /*!
  * Constructor for encodable
  */
-Encodable::Encodable(ProtocolParser* parse, const std::string& Parent, ProtocolSupport supported) :
-    ProtocolDocumentation(parse, Parent, supported)
+Encodable::Encodable(ProtocolParser* parse, const std::string& Parent, const ProtocolSupport& supported) :
+    ProtocolDocumentation(parse, Parent, supported),
+    span(false)
 {
 }
 
@@ -124,6 +130,59 @@ void Encodable::clear(void)
     dependsOn.clear();
     dependsOnValue.clear();
     dependsOnCompare.clear();
+    span = false;
+}
+
+
+/*!
+ * Save the parsed encodable to a precompiled library, including the protocol
+ * options that parse() changed from the attributes
+ * \param writer receives the data
+ */
+void Encodable::save(CacheWriter& writer) const
+{
+    ProtocolDocumentation::save(writer);
+    writer.write(typeName);
+    writer.write(array);
+    writer.write(array2d);
+    writer.write(variableArray);
+    writer.write(variable2dArray);
+    writer.write(dependsOn);
+    writer.write(dependsOnValue);
+    writer.write(dependsOnCompare);
+    writer.write(encodedLength.minEncodedLength);
+    writer.write(encodedLength.maxEncodedLength);
+    writer.write(encodedLength.nonDefaultEncodedLength);
+    writer.write(span);
+    writer.write(support.limitonencode);
+    writer.write(support.span);
+}
+
+
+/*!
+ * Load the parsed encodable from a precompiled library, in place of parse()
+ * \param reader supplies the data written by save()
+ * \return true if the encodable was loaded
+ */
+bool Encodable::load(CacheReader& reader)
+{
+    ProtocolDocumentation::load(reader);
+    typeName = reader.readString();
+    array = reader.readString();
+    array2d = reader.readString();
+    variableArray = reader.readString();
+    variable2dArray = reader.readString();
+    dependsOn = reader.readString();
+    dependsOnValue = reader.readString();
+    dependsOnCompare = reader.readString();
+    encodedLength.minEncodedLength = reader.readString();
+    encodedLength.maxEncodedLength = reader.readString();
+    encodedLength.nonDefaultEncodedLength = reader.readString();
+    span = reader.readBool();
+    support.limitonencode = reader.readBool();
+    support.span = reader.readBool();
+
+    return reader.isGood();
 }
 
 
@@ -431,6 +490,223 @@ std::string Encodable::getDecodeArrayIterationCode(const std::string& spacing, b
 }// Encodable::getDecodeArrayIterationCode
 
 
+/*!
+ * Get the string which accesses this field, or another member of the same
+ * structure, in the column append functions. Those are free functions, even
+ * in C++, which reach the structure through the _pg_user pointer.
+ * \param variable is the name of the member to access
+ * \return the string that accesses the member, a structure is accessed by its address
+ */
+std::string Encodable::getColumnFieldAccess(const std::string& variable) const
+{
+    std::string access = getEncodeFieldAccess(true, variable);
+
+    if(support.language == ProtocolSupport::cpp_language)
+    {
+        access = "_pg_user->" + access;
+
+        if(!isPrimitive() && (variable == name))
+            access = "&" + access;
+    }
+
+    return access;
+
+}// Encodable::getColumnFieldAccess
+
+
+/*!
+ * Get the key that names the columns of this field in the column append
+ * functions, which is the field name and the array indices.
+ * \return the key, as the arguments of PgColumnTable::next() or name()
+ */
+std::string Encodable::getColumnKey(void) const
+{
+    std::string key = "\":" + name + "\"";
+
+    if(isArray() && !isString())
+    {
+        key += ", (int)_pg_i";
+        if(is2dArray())
+            key += ", (int)_pg_j";
+    }
+
+    return key;
+
+}// Encodable::getColumnKey
+
+
+/*!
+ * Get the code that appends every element of this field to its columns. Every
+ * element of an array gets a column, so each row has the same columns, and
+ * the elements past the length of a variable length array are null.
+ * \param present are the statements that append an element which is present
+ * \param absent are the statements that append an element past the array length
+ * \return the code, which iterates over the array
+ */
+std::string Encodable::getColumnElementCode(const std::vector<std::string>& present, const std::vector<std::string>& absent) const
+{
+    std::string output;
+    std::string spacing = TAB_IN;
+    std::string condition;
+
+    if(!isArray() || isString())
+    {
+        for(std::size_t i = 0; i < present.size(); i++)
+            output += spacing + present.at(i) + "\n";
+
+        return output;
+    }
+
+    output += spacing + "for(_pg_i = 0; _pg_i < " + array + "; _pg_i++)\n";
+    if(!variableArray.empty())
+        condition = "_pg_i < (unsigned)" + getColumnFieldAccess(variableArray);
+
+    if(is2dArray())
+    {
+        spacing += TAB_IN;
+        output += spacing + "for(_pg_j = 0; _pg_j < " + array2d + "; _pg_j++)\n";
+
+        if(!variable2dArray.empty())
+        {
+            if(condition.empty())
+                condition = "_pg_j < (unsigned)" + getColumnFieldAccess(variable2dArray);
+            else
+                condition = "(" + condition + ") && (_pg_j < (unsigned)" + getColumnFieldAccess(variable2dArray) + ")";
+        }
+    }
+
+    // The statements in a block, or alone, one level in from spacing
+    auto block = [](const std::string& spacing, const std::vector<std::string>& statements)
+    {
+        std::string code;
+
+        if(statements.size() == 1)
+            return spacing + TAB_IN + statements.front() + "\n";
+
+        code += spacing + "{\n";
+        for(std::size_t i = 0; i < statements.size(); i++)
+            code += spacing + TAB_IN + statements.at(i) + "\n";
+        code += spacing + "}\n";
+
+        return code;
+    };
+
+    if(condition.empty())
+        output += block(spacing, present);
+    else
+    {
+        output += spacing + "{\n";
+        output += spacing + TAB_IN + "if(" + condition + ")\n";
+        output += block(spacing + TAB_IN, present);
+        output += spacing + TAB_IN + "else\n";
+        output += block(spacing + TAB_IN, absent);
+        output += spacing + "}\n";
+    }
+
+    return output;
+
+}// Encodable::getColumnElementCode
+
+
+/*!
+ * Get the code that appends every element of this structure field to the
+ * columns, through the appendColumns() function of the structure. Elements
+ * past the length of a variable length array append an empty structure as
+ * nulls, which still defines their columns.
+ * \param structType is the type of the structure
+ * \return the code
+ */
+std::string Encodable::getColumnStructureCode(const std::string& structType) const
+{
+    std::string prename = "_pg_table.name(_pg_prename, " + getColumnKey() + ")";
+
+    std::vector<std::string> present, absent;
+
+    present.push_back("appendColumns(_pg_table, " + prename + ", " + getColumnFieldAccess(name) + ");");
+
+    absent.push_back("static const " + structType + " _pg_empty = " + structType + "();");
+    absent.push_back("_pg_table.beginNulls();");
+    absent.push_back("appendColumns(_pg_table, " + prename + ", &_pg_empty);");
+    absent.push_back("_pg_table.endNulls();");
+
+    return getColumnElementCode(present, absent);
+
+}// Encodable::getColumnStructureCode
+
+
+/*!
+ * Get the code that draws the storage of a span from the arena, in a decode
+ * context. The storage is sized by the variable array length, limited to the
+ * array maximum, and the decode fails if the arena is out of storage.
+ * \param spacing is the spacing that begins each line
+ * \return the code for the allocation, which may be empty
+ */
+std::string Encodable::getSpanAllocationCode(const std::string& spacing) const
+{
+    std::string output;
+
+    if(!span)
+        return output;
+
+    // C passes the arena by pointer, C++ by reference to a class member decode
+    std::string access = "_pg_user->" + name;
+    std::string arena = "_pg_arena";
+
+    if(support.language != ProtocolSupport::c_language)
+    {
+        access = name;
+        arena = "&_pg_arena";
+    }
+
+    output += spacing + "// The storage for " + name + " comes from the arena\n";
+    output += spacing + access + " = (" + typeName + "*)allocateArenaSpan(" + arena + ", (unsigned)" + getDecodeFieldAccess(true, variableArray) + ", " + array + ", sizeof(" + typeName + "));\n";
+    output += spacing + "if(" + access + " == NULL)\n";
+    output += spacing + TAB_IN + "return " + getReturnCode(false) + ";\n";
+
+    return output;
+
+}// Encodable::getSpanAllocationCode
+
+
+/*!
+ * Get the most arena storage used by decoding this encodable, which is the
+ * storage of its span (if it is one) plus the storage used by each element
+ * that is a structure with spans. Each span may also use up to
+ * PG_ARENA_ALIGNMENT bytes to align its storage.
+ * \param nested is the most storage used by decoding one element, empty if none
+ * \return the storage expression, empty if no storage is used
+ */
+std::string Encodable::combineSpanStorage(const std::string& nested) const
+{
+    std::string output;
+    std::string count;
+
+    if(isArray())
+    {
+        count = "(" + array + ")";
+        if(is2dArray())
+            count += "*(" + array2d + ")";
+    }
+
+    if(span)
+        output = count + "*sizeof(" + typeName + ") + PG_ARENA_ALIGNMENT";
+
+    if(!nested.empty())
+    {
+        if(!output.empty())
+            output += " + ";
+
+        if(count.empty())
+            output += nested;
+        else
+            output += count + "*(" + nested + ")";
+    }
+
+    return output;
+
+}// Encodable::combineSpanStorage
+
+
 /*!
  * Get documentation repeat details for array or 2d arrays
  * \return The repeat details
@@ -499,6 +775,115 @@ std::string Encodable::getRepeatsDocumentationDetails(void) const
 }// Encodable::getRepeatsDocumentationDetails
 
 
+/*!
+ * Return the dimensions of this encodable's array, for NumPy output. The
+ * dimensions must be fixed numbers, enumerations are resolved to their values.
+ * \param dimensions receives the dimensions, which is empty if this is not an array
+ * \return false if the array is variable length, or its dimensions are not numbers
+ */
+bool Encodable::getNumpyArrayDimensions(std::vector<int>& dimensions) const
+{
+    dimensions.clear();
+
+    if(!isArray())
+        return true;
+
+    if(!variableArray.empty() || !variable2dArray.empty())
+        return false;
+
+    std::vector<std::string> arrays;
+    arrays.push_back(array);
+
+    if(is2dArray())
+        arrays.push_back(array2d);
+
+    for(const std::string& length : arrays)
+    {
+        bool ok = false;
+        double value = ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(length), &ok);
+
+        if(!ok || (value < 1))
+            return false;
+
+        dimensions.push_back((int)value);
+    }
+
+    return true;
+
+}// Encodable::getNumpyArrayDimensions
+
+
+/*!
+ * Return the Python name of a structure, which is its type name without the
+ * type suffix (so "myStructure_t" becomes "myStructure")
+ * \param structTypeName is the type name of the structure
+ * \return the Python name of the structure
+ */
+std::string Encodable::getNumpyStructureName(const std::string& structTypeName) const
+{
+    if(!support.typeSuffix().empty() && endsWith(structTypeName, support.typeSuffix(), true) && (structTypeName.size() > support.typeSuffix().size()))
+        return structTypeName.substr(0, structTypeName.size() - support.typeSuffix().size());
+    else
+        return structTypeName;
+}
+
+
+/*!
+ * Return a NumPy shape string for a list of dimensions
+ * \param dimensions is the list of dimensions
+ * \return the shape, like "(3,)" or "(3, 4)", or an empty string if there are no dimensions
+ */
+std::string Encodable::getNumpyShapeString(const std::vector<int>& dimensions)
+{
+    if(dimensions.empty())
+        return std::string();
+
+    std::string shape = "(";
+
+    for(std::size_t i = 0; i < dimensions.size(); i++)
+    {
+        if(i > 0)
+            shape += ", ";
+
+        shape += std::to_string(dimensions.at(i));
+    }
+
+    if(dimensions.size() == 1)
+        shape += ",";
+
+    return shape + ")";
+}
+
+
+/*!
+ * Return a number formatted as a Python literal, with enough precision to
+ * round trip the double precision value
+ * \param number is the number to format
+ * \return the Python literal
+ */
+std::string Encodable::getNumpyNumberString(double number)
+{
+    std::string string;
+
+    // Use the shortest precision that reads back as the same number
+    for(int precision = std::numeric_limits<double>::digits10; precision <= std::numeric_limits<double>::max_digits10; precision++)
+    {
+        std::stringstream stream;
+        stream << std::setprecision(precision) << number;
+        string = stream.str();
+
+        if(std::stod(string) == number)
+            break;
+    }
+
+    // Python floating point literals need a decimal point or exponent
+    if(string.find_first_of(".en") == std::string::npos)
+        string += ".0";
+
+    return string;
+}
+
+
 /*!
  * Construct a protocol field by parsing a DOM element. The type of Encodable
  * created will be either a ProtocolStructure or a ProtocolField
@@ -509,7 +894,31 @@ std::string Encodable::getRepeatsDocumentationDetails(void) const
  * \return a pointer to a newly allocated encodable. The caller is
  *         responsible for deleting this object.
  */
-Encodable* Encodable::generateEncodable(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported, const XMLElement* field)
+Encodable* Encodable::generateEncodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported, const XMLElement* field)
+{
+    Encodable* enc = createEncodable(parse, parent, supported, field);
+
+    if(enc != NULL)
+    {
+        enc->setElement(field);
+        enc->parse();
+    }
+
+    return enc;
+}
+
+
+/*!
+ * Construct the encodable for a DOM element, without parsing it. The type of
+ * Encodable created depends on the tag of the element.
+ * \param parse points to the global protocol parser that owns everything
+ * \param Parent is the hierarchical name of the objec which owns the newly created object
+ * \param supported describes what the protocol can support
+ * \param field is the DOM element of the encodable
+ * \return a pointer to a newly allocated encodable, or NULL if the element is
+ *         not an encodable. The caller is responsible for deleting this object.
+ */
+Encodable* Encodable::createEncodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported, const XMLElement* field)
 {
     Encodable* enc = NULL;
 
@@ -525,12 +934,6 @@ Encodable* Encodable::generateEncodable(ProtocolParser* parse, const std::string
     else if(contains(tagname, "code"))
         enc = new ProtocolCode(parse, parent, supported);
 
-    if(enc != NULL)
-    {
-        enc->setElement(field);
-        enc->parse();
-    }
-
     return enc;
 }
 
@@ -4,18 +4,28 @@
 #include "protocolsupport.h"
 #include "encodedlength.h"
 #include "protocoldocumentation.h"
+#include "internedstring.h"
 
 class Encodable : public ProtocolDocumentation
 {
 public:
 
     //! Constructor for basic encodable that sets protocol options
-    Encodable(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported);
+    Encodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported);
 
     virtual ~Encodable() {;}
 
     //! Construct a protocol field by parsing a DOM element
-    static Encodable* generateEncodable(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported, const XMLElement* field);
+    static Encodable* generateEncodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported, const XMLElement* field);
+
+    //! Construct the encodable for a DOM element, without parsing it
+    static Encodable* createEncodable(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported, const XMLElement* field);
+
+    //! Save the parsed encodable to a precompiled library
+    void save(CacheWriter& writer) const override;
+
+    //! Load the parsed encodable from a precompiled library
+    bool load(CacheReader& reader) override;
 
     //! Provide the pointer to a previous encodable in the list
     virtual void setPreviousEncodable(Encodable* prev) {(void)prev;}
@@ -62,6 +72,9 @@ public:
     //! Get the string used to decode this field from a map
     virtual std::string getMapDecodeString(void) const {return std::string();}
 
+    //! Get the string used to append this field to the columns of a table
+    virtual std::string getColumnAppendString(void) const {return std::string();}
+
     //! Return the string that sets this encodable to its default value in code
     virtual std::string getSetToDefaultsString(bool isStructureMember) const {(void)isStructureMember; return std::string();}
 
@@ -116,6 +129,54 @@ public:
     //! Get the array handling code for decoding context
     virtual std::string getDecodeArrayIterationCode(const std::string& spacing, bool isStructureMember) const;
 
+    //! Get the string which accesses this field, or another member, in the column append functions
+    std::string getColumnFieldAccess(const std::string& variable) const;
+
+    //! Get the key that names the columns of this field in the column append functions
+    std::string getColumnKey(void) const;
+
+    //! Get the code that appends every element of this field to its columns
+    std::string getColumnElementCode(const std::vector<std::string>& present, const std::vector<std::string>& absent) const;
+
+    //! Get the code that appends every element of this structure field to the columns
+    std::string getColumnStructureCode(const std::string& structType) const;
+
+    //! Get the code that draws the storage of a span from the arena
+    std::string getSpanAllocationCode(const std::string& spacing) const;
+
+    //! Get the most arena storage used by this encodable's span and by the structures it contains
+    std::string combineSpanStorage(const std::string& nested) const;
+
+    //! Return the reason this encodable has no fixed layout for a NumPy dtype, empty if it has one
+    virtual std::string getNumpyIncompatibility(void) const {return std::string();}
+
+    //! Return the entries of a NumPy dtype that describe the encoding of this encodable
+    virtual std::string getNumpyDtypeString(void) const {return std::string();}
+
+    //! Return the Python code that decodes this encodable from NumPy records into columns
+    virtual std::string getNumpyDecodeString(void) const {return std::string();}
+
+    //! Return the Python code that verifies this encodable in decoded NumPy columns
+    virtual std::string getNumpyVerifyString(void) const {return std::string();}
+
+    //! Return the reason this encodable cannot be described by a table codec descriptor, empty if it can
+    virtual std::string getDescriptorIncompatibility(void) const {return std::string();}
+
+    //! Return the entry of a table codec descriptor that describes this encodable
+    virtual std::string getDescriptorEntryString(const std::string& structure, int length, int depends) const {(void)structure; (void)length; (void)depends; return std::string();}
+
+    //! Return the dimensions of this encodable's array, for NumPy output
+    bool getNumpyArrayDimensions(std::vector<int>& dimensions) const;
+
+    //! Return the Python name of a structure, which is its type name without the type suffix
+    std::string getNumpyStructureName(const std::string& structTypeName) const;
+
+    //! Return a NumPy shape string for a list of dimensions
+    static std::string getNumpyShapeString(const std::vector<int>& dimensions);
+
+    //! Return a number formatted as a Python literal
+    static std::string getNumpyNumberString(double number);
+
     //! Return true if this encodable has documentation for markdown output
     virtual bool hasDocumentation(void) {return true;}
 
@@ -140,6 +201,24 @@ public:
     //! Determine if this encodable is a 2d array
     bool is2dArray(void) const {return (isArray() && !array2d.empty());}
 
+    //! Determine if this encodable is a variable length array declared as a span of arena storage
+    bool isSpan(void) const {return span;}
+
+    //! Declare this encodable as a fixed array, return true if it was a span
+    virtual bool clearSpans(void) {bool cleared = span; span = false; return cleared;}
+
+    //! True if decoding this encodable draws storage from an arena
+    virtual bool usesArena(bool isStructureMember) const {(void)isStructureMember; return false;}
+
+    //! Return the most arena storage that decoding this encodable can use, empty if none
+    virtual std::string getSpanStorageString(void) const {return std::string();}
+
+    //! True if the encoded bytes of this encodable are its in-memory bytes, so it can be sent without copying
+    virtual bool isZeroCopy(void) const {return false;}
+
+    //! Return the code that points an iovec entry at the in-memory bytes of this encodable
+    virtual std::string getIovEncodeString(bool isStructureMember) const {(void)isStructureMember; return std::string();}
+
     //! True if this encodable has verification data
     virtual bool hasVerify(void) const {return false;}
 
@@ -223,15 +302,18 @@ public:
 
 public:
 
-    std::string typeName;        //!< The type name of this encodable, like "uint8_t" or "myStructure_t"
-    std::string array;           //!< The array length of this encodable, empty if no array
-    std::string array2d;         //!< The second dimension array length of this encodable, empty if no 2nd dimension
-    std::string variableArray;   //!< variable that gives the length of the array in a packet
-    std::string variable2dArray; //!< variable that gives the length of the 2nd array dimension in a packet
-    std::string dependsOn;       //!< variable that determines if this field is present
-    std::string dependsOnValue;  //!< String providing the details of the depends on value
-    std::string dependsOnCompare;//!< Comparison to use for dependsOnValue
+    InternedString typeName;        //!< The type name of this encodable, like "uint8_t" or "myStructure_t"
+    InternedString array;           //!< The array length of this encodable, empty if no array
+    InternedString array2d;         //!< The second dimension array length of this encodable, empty if no 2nd dimension
+    InternedString variableArray;   //!< variable that gives the length of the array in a packet
+    InternedString variable2dArray; //!< variable that gives the length of the 2nd array dimension in a packet
+    InternedString dependsOn;       //!< variable that determines if this field is present
+    InternedString dependsOnValue;  //!< String providing the details of the depends on value
+    InternedString dependsOnCompare;//!< Comparison to use for dependsOnValue
     EncodedLength encodedLength; //!< The lengths of the encodables
+
+protected:
+    bool span;                      //!< True if this variable length array is declared as a pointer to arena storage
 };
 
 #endif // ENCODABLE_H
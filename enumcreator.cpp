@@ -2,18 +2,20 @@
 #include "protocolparser.h"
 #include "shuntingyard.h"
 #include "encodedlength.h"
+#include "precompiledlibrary.h"
 #include <math.h>
 #include <iostream>
 #include <algorithm>
 
-EnumElement::EnumElement(ProtocolParser *parse, EnumCreator *creator, const std::string& parent, ProtocolSupport supported) :
+EnumElement::EnumElement(ProtocolParser *parse, EnumCreator *creator, const std::string& parent, const ProtocolSupport& supported) :
     ProtocolDocumentation(parse, parent, supported),
     hidden(false),
     ignoresPrefix(false),
     ignoresLookup(false),
     parentEnum(creator)
 {
-    attriblist = {"name", "title", "lookupName", "value", "comment", "hidden", "ignorePrefix", "ignoreLookup"};
+    static const AttributeNames names({"name", "title", "lookupName", "value", "comment", "hidden", "ignorePrefix", "ignoreLookup"});
+    attriblist = &names;
 }
 
 void EnumElement::checkAgainstKeywords()
@@ -21,7 +23,7 @@ void EnumElement::checkAgainstKeywords()
     if (contains(keywords, getName(), true))
     {
         emitWarning("enum value name matches C keyword, changed to name_");
-        name += "_";
+        name = name + "_";
     }
 
     if (contains(keywords, value, true))
@@ -36,7 +38,7 @@ void EnumElement::parse()
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
     testAndWarnAttributes(map);
 
@@ -84,8 +86,53 @@ std::string EnumElement::getDeclaration() const
     return decl;
 }
 
+std::string EnumElement::getSubstitution() const
+{
+    if (!number.empty())
+    {
+        return number;
+    }
+    else
+    {
+        return value;
+    }
+}
+
+/*!
+ * Save the parsed element to a precompiled library
+ * \param writer receives the data
+ */
+void EnumElement::save(CacheWriter& writer) const
+{
+    ProtocolDocumentation::save(writer);
+    writer.write(lookupName);
+    writer.write(value);
+    writer.write(number);
+    writer.write(hidden);
+    writer.write(ignoresPrefix);
+    writer.write(ignoresLookup);
+}
+
+/*!
+ * Load the parsed element from a precompiled library, in place of parse()
+ * \param reader supplies the data written by save()
+ * \return true if the element was loaded
+ */
+bool EnumElement::load(CacheReader& reader)
+{
+    ProtocolDocumentation::load(reader);
+    lookupName = reader.readString();
+    value = reader.readString();
+    number = reader.readString();
+    hidden = reader.readBool();
+    ignoresPrefix = reader.readBool();
+    ignoresLookup = reader.readBool();
+
+    return reader.isGood();
+}
+
 //! Create an empty enumeration list
-EnumCreator::EnumCreator(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported) :
+EnumCreator::EnumCreator(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported) :
     ProtocolDocumentation(parse, parent, supported),
     minbitwidth(0),
     maxvalue(0),
@@ -96,7 +143,8 @@ EnumCreator::EnumCreator(ProtocolParser* parse, const std::string& parent, Proto
     lookupComment(false),
     isglobal(false)
 {
-    attriblist = {"name", "title", "comment", "description", "hidden", "neverOmit", "lookup", "lookupTitle", "lookupComment", "prefix", "file"};
+    static const AttributeNames names({"name", "title", "comment", "description", "hidden", "neverOmit", "lookup", "lookupTitle", "lookupComment", "prefix", "file"});
+    attriblist = &names;
 }
 
 EnumCreator::~EnumCreator(void)
@@ -168,7 +216,7 @@ void EnumCreator::parse(void)
 {
     clear();
 
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
     // We use name as part of our debug outputs, so its good to have it first.
     name = ProtocolParser::getAttribute("name", map);
@@ -194,11 +242,11 @@ void EnumCreator::parse(void)
     // The file attribute is only supported on global enumerations
     if(isglobal)
     {
-        filepath = support.outputpath;
+        filepath = support.outputpath();
 
         // If no file information is provided we use the global header name
         if(file.empty())
-            file = support.protoName + "Protocol";
+            file = support.protoName() + "Protocol";
 
         // This will separate all the path information
         ProtocolFile::separateModuleNameAndPath(file, filepath);
@@ -219,6 +267,7 @@ void EnumCreator::parse(void)
     }
 
     elements.clear();
+    elementindex.clear();
 
     std::size_t maxLength = 0;
 
@@ -249,6 +298,10 @@ void EnumCreator::parse(void)
         return;
     }
 
+    // Index the elements by name, the first element with a name wins
+    for(std::size_t i = 0; i < elements.size(); i++)
+        elementindex.emplace(trimm(elements.at(i).getName()), i);
+
     // Check for keywords that will cause compilation problems
     checkAgainstKeywords();
 
@@ -330,7 +383,7 @@ void EnumCreator::parse(void)
                 continue;
 
             sourceOutput += TAB_IN + "case " + element.getName() + ":\n";
-            sourceOutput += TAB_IN + TAB_IN + "return translate" + support.protoName + "(\"" + element.getName() + "\");\n";
+            sourceOutput += TAB_IN + TAB_IN + "return translate" + support.protoName() + "(\"" + element.getName() + "\");\n";
         }
 
         sourceOutput += TAB_IN + "}\n";
@@ -383,7 +436,7 @@ void EnumCreator::parse(void)
             if (title.empty())
                 title = element.getLookupName();
 
-            sourceOutput += TAB_IN + TAB_IN + "return translate" + support.protoName + "(\"" + title + "\");\n";
+            sourceOutput += TAB_IN + TAB_IN + "return translate" + support.protoName() + "(\"" + title + "\");\n";
         }
 
         sourceOutput += TAB_IN + "}\n";
@@ -436,7 +489,7 @@ void EnumCreator::parse(void)
             if (_comment.empty())
                 _comment = element.getLookupName();
 
-            sourceOutput += TAB_IN + TAB_IN + "return translate" + support.protoName + "(\"" + _comment + "\");\n";
+            sourceOutput += TAB_IN + TAB_IN + "return translate" + support.protoName() + "(\"" + _comment + "\");\n";
         }
 
         sourceOutput += TAB_IN + "}\n";
@@ -447,6 +500,103 @@ void EnumCreator::parse(void)
 }// EnumCreator::parse
 
 
+/*!
+ * Save the parsed enumeration to a precompiled library. The values and
+ * documents refer to their xml elements by index.
+ * \param writer receives the data
+ */
+void EnumCreator::save(CacheWriter& writer) const
+{
+    ProtocolDocumentation::save(writer);
+    writer.write(file);
+    writer.write(filepath);
+    writer.write(sourceOutput);
+    writer.write(description);
+    writer.write(prefix);
+    writer.write(output);
+    writer.write((int64_t)minbitwidth);
+    writer.write((int64_t)maxvalue);
+    writer.write(hidden);
+    writer.write(neverOmit);
+    writer.write(lookup);
+    writer.write(lookupTitle);
+    writer.write(lookupComment);
+
+    writer.write((int64_t)elements.size());
+    for(const EnumElement& element : elements)
+    {
+        writer.write((int64_t)element.getElementIndex());
+        element.save(writer);
+    }
+
+    writer.write((int64_t)documentList.size());
+    for(const ProtocolDocumentation* doc : documentList)
+    {
+        writer.write((int64_t)doc->getElementIndex());
+        doc->save(writer);
+    }
+
+}// EnumCreator::save
+
+
+/*!
+ * Load the parsed enumeration from a precompiled library, in place of parse()
+ * or parseGlobal(). The element must be set first.
+ * \param reader supplies the data written by save()
+ * \return true if the enumeration was loaded
+ */
+bool EnumCreator::load(CacheReader& reader)
+{
+    clear();
+    elements.clear();
+    elementindex.clear();
+
+    ProtocolDocumentation::load(reader);
+    file = reader.readString();
+    filepath = reader.readString();
+    sourceOutput = reader.readString();
+    description = reader.readString();
+    prefix = reader.readString();
+    output = reader.readString();
+    minbitwidth = (int)reader.readInt();
+    maxvalue = (int)reader.readInt();
+    hidden = reader.readBool();
+    neverOmit = reader.readBool();
+    lookup = reader.readBool();
+    lookupTitle = reader.readBool();
+    lookupComment = reader.readBool();
+
+    std::vector<const XMLElement*> children = childElements(e);
+
+    for(int64_t count = reader.readInt(); (count > 0) && reader.isGood(); count--)
+    {
+        EnumElement elem(parser, this, parent, support);
+
+        elem.setElement(readElement(reader, children));
+        elem.load(reader);
+
+        elements.push_back(elem);
+    }
+
+    for(int64_t count = reader.readInt(); (count > 0) && reader.isGood(); count--)
+    {
+        ProtocolDocumentation* doc = new ProtocolDocumentation(parser, getHierarchicalName(), support);
+
+        doc->setElement(readElement(reader, children));
+        doc->load(reader);
+
+        documentList.push_back(doc);
+    }
+
+    // Index the elements by name, the first element with a name wins
+    for(std::size_t i = 0; i < elements.size(); i++)
+        elementindex.emplace(trimm(elements.at(i).getName()), i);
+
+    return reader.isGood();
+
+}// EnumCreator::load
+
+
 //! Check names against the list of C keywords, this includes the global enumeration name as well as all the value names
 void EnumCreator::checkAgainstKeywords(void)
 {
@@ -505,7 +655,7 @@ void EnumCreator::computeNumberList(void)
             // Next, check if the value was defined in *this* enumeration or other enumerations
             if (!ok)
             {
-                replaceEnumerationNameWithValue(stringValue);
+                stringValue = replaceEnumerationNameWithValue(stringValue);
                 stringValue = parser->replaceEnumerationNameWithValue(stringValue);
 
                 // If this string is a composite of numbers, add them together if we can
@@ -713,29 +863,21 @@ std::string EnumCreator::replaceEnumerationNameWithValue(const std::string& text
         std::string token = trimm(tokens.at(j));
 
         // Don't look to replace the mathematical operators
-        if(isMathOperator(token.at(0)))
+        if(token.empty() || isMathOperator(token.at(0)))
             continue;
 
         // Don't look to replace elements that are already numeric
         if (ShuntingYard::isInt(token))
             continue;
 
-        for (const auto& element : elements )
+        // The entire token must match before we will replace it
+        const EnumElement* element = lookUpElement(token);
+        if(element != nullptr)
         {
-            // The entire token must match before we will replace it
-            if(token == trimm(element.getName()))
-            {
-                if (!element.number.empty())
-                {
-                    tokens[j] = element.number;
-                }
-                else if (!element.value.empty())
-                {
-                    tokens[j] = element.value;
-                }
-                break;
-            }
-        }// for all names
+            std::string substitution = element->getSubstitution();
+            if(!substitution.empty())
+                tokens[j] = substitution;
+        }
 
     }// for all tokens
 
@@ -750,7 +892,7 @@ std::string EnumCreator::replaceEnumerationNameWithValue(const std::string& text
  * \param text is the input text to split
  * \return is the list of split strings
  */
-std::vector<std::string> EnumCreator::splitAroundMathOperators(std::string text) const
+std::vector<std::string> EnumCreator::splitAroundMathOperators(const std::string& text)
 {
     std::vector<std::string> output;
     std::string token;
@@ -794,7 +936,7 @@ std::vector<std::string> EnumCreator::splitAroundMathOperators(std::string text)
  * \param op is the character to check
  * \return true if op is a math operator
  */
-bool EnumCreator::isMathOperator(char op) const
+bool EnumCreator::isMathOperator(char op)
 {
     if(ShuntingYard::isOperator(op) || ShuntingYard::isParen(op))
         return true;
@@ -824,11 +966,10 @@ std::string EnumCreator::getFirstEnumerationName(void) const
  */
 std::string EnumCreator::getEnumerationValueComment(const std::string& name) const
 {
-    for(const auto& element : elements )
-    {
-        if(trimm(name) == trimm(element.getName()))
-            return element.comment;
-    }
+    const EnumElement* element = lookUpElement(trimm(name));
+
+    if(element != nullptr)
+        return element->comment;
 
     return std::string();
 }
@@ -842,17 +983,28 @@ std::string EnumCreator::getEnumerationValueComment(const std::string& name) con
  */
 bool EnumCreator::isEnumerationValue(const std::string& text) const
 {
-    for(const auto& element : elements )
-    {
-        if(trimm(text) == trimm(element.getName()))
-            return true;
-    }
-
-    return false;
+    return (lookUpElement(trimm(text)) != nullptr);
 
 }// EnumCreator::isEnumerationValue
 
 
+/*!
+ * Find the element with a specific name
+ * \param name is the trimmed name of the element, including any prefix
+ * \return a pointer to the first element with this name, or nullptr if none
+ */
+const EnumElement* EnumCreator::lookUpElement(const std::string& name) const
+{
+    std::unordered_map<std::string, std::size_t>::const_iterator it = elementindex.find(name);
+
+    if(it == elementindex.end())
+        return nullptr;
+    else
+        return &elements.at(it->second);
+
+}// EnumCreator::lookUpElement
+
+
 /*!
  * Output a spaced string
  * \param text is the first part of the string
@@ -3,6 +3,7 @@
 
 #include "protocolsupport.h"
 #include "protocoldocumentation.h"
+#include <unordered_map>
 
 // Forward declaration of EnumCreator so EnumElement can see it
 class EnumCreator;
@@ -15,11 +16,17 @@ class EnumElement : public ProtocolDocumentation
 public:
 
     //! Cronstruct an enumeration element
-    EnumElement(ProtocolParser* parse, EnumCreator* creator, const std::string& Parent, ProtocolSupport supported);
+    EnumElement(ProtocolParser* parse, EnumCreator* creator, const std::string& Parent, const ProtocolSupport& supported);
 
     //! Parse an enumeration element
     void parse(void) override;
 
+    //! Save the parsed element to a precompiled library
+    void save(CacheWriter& writer) const override;
+
+    //! Load the parsed element from a precompiled library
+    bool load(CacheReader& reader) override;
+
     //! Check the enumeration element against C keywords
     void checkAgainstKeywords(void) override;
 
@@ -35,6 +42,9 @@ public:
     //! The enumeration element declaration string
     std::string getDeclaration() const;
 
+    //! The text that replaces the element name when computing values
+    std::string getSubstitution() const;
+
 protected:
 
     //! The name returned
@@ -64,7 +74,7 @@ class EnumCreator : public ProtocolDocumentation
 {
 public:
     //! Construct the enumeration object
-    EnumCreator(ProtocolParser* parse, const std::string& parent, ProtocolSupport supported);
+    EnumCreator(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& supported);
 
     ~EnumCreator(void);
 
@@ -77,6 +87,12 @@ public:
     //! Parse the DOM to fill out the enumeration list for a global enum
     void parseGlobal(void);
 
+    //! Save the parsed enumeration to a precompiled library
+    void save(CacheWriter& writer) const override;
+
+    //! Load the parsed enumeration from a precompiled library
+    bool load(CacheReader& reader) override;
+
     //! Check names against the list of C keywords
     void checkAgainstKeywords(void) override;
 
@@ -89,6 +105,9 @@ public:
     //! Return the enumeration comment
     std::string getComment(void) const {return comment;}
 
+    //! Return true if this enumeration outputs the function that looks up the label of a value
+    bool hasLabelLookup(void) const {return lookup;}
+
     //! Return the header file output string
     std::string getOutput(void) const {return output;}
 
@@ -110,6 +129,15 @@ public:
     //! Determine if text is an enumeration name
     bool isEnumerationValue(const std::string& text) const;
 
+    //! Return the list of enumeration elements
+    const std::vector<EnumElement>& getElements(void) const {return elements;}
+
+    //! Split string around math operators
+    static std::vector<std::string> splitAroundMathOperators(const std::string& text);
+
+    //! Determine if a character is a math operator
+    static bool isMathOperator(char op);
+
     //! Return the minimum number of bits needed to encode the enumeration
     int getMinBitWidth(void) const {return minbitwidth;}
 
@@ -136,11 +164,8 @@ protected:
     //! Parse the enumeration values to build the number list
     void computeNumberList(void);
 
-    //! Split string around math operators
-    std::vector<std::string> splitAroundMathOperators(std::string text) const;
-
-    //! Determine if a character is a math operator
-    bool isMathOperator(char op) const;
+    //! Find the element with a specific name
+    const EnumElement* lookUpElement(const std::string& name) const;
 
     //! Output file for global enumerations
     std::string file;
@@ -154,6 +179,9 @@ protected:
     //! List of all the enumerated values
     std::vector<EnumElement> elements;
 
+    //! Index into elements by element name
+    std::unordered_map<std::string, std::size_t> elementindex;
+
     //! A longer description is possible for enums (will be displayed in the documentation)
     std::string description;
 
@@ -2,7 +2,7 @@
 #include "protocolparser.h"
 
 
-FieldCoding::FieldCoding(ProtocolSupport sup) :
+FieldCoding::FieldCoding(const ProtocolSupport& sup) :
     ProtocolScaling(sup)
 {
     // we use 64-bit integers for floating point
@@ -98,7 +98,7 @@ bool FieldCoding::generate(std::vector<std::string>& fileNameList, std::vector<s
  */
 bool FieldCoding::generateEncodeHeader(void)
 {
-    header.setModuleNameAndPath("fieldencode", support.outputpath, support.language);
+    header.setModuleNameAndPath("fieldencode", support.outputpath(), support.language);
 
 // Raw string magic
 header.setFileComment(R"(fieldencode provides routines to place numbers into a byte stream.
@@ -212,7 +212,7 @@ void bytesToLeBytes(const uint8_t* data, uint8_t* bytes, int* index, int num);)"
  */
 bool FieldCoding::generateEncodeSource(void)
 {
-    source.setModuleNameAndPath("fieldencode", support.outputpath, support.language);
+    source.setModuleNameAndPath("fieldencode", support.outputpath(), support.language);
 
     if(support.specialFloat)
         source.writeIncludeDirective("floatspecial");
@@ -619,7 +619,7 @@ std::string FieldCoding::integerEncodeFunction(int type, bool bigendian)
  */
 bool FieldCoding::generateDecodeHeader(void)
 {
-    header.setModuleNameAndPath("fielddecode", support.outputpath, support.language);
+    header.setModuleNameAndPath("fielddecode", support.outputpath(), support.language);
 
 // Top level comment
 header.setFileComment(R"(fielddecode provides routines to pull numbers from a byte stream.
@@ -721,7 +721,7 @@ void bytesFromLeBytes(uint8_t* data, const uint8_t* bytes, int* index, int num);
  */
 bool FieldCoding::generateDecodeSource(void)
 {
-    source.setModuleNameAndPath("fielddecode", support.outputpath, support.language);
+    source.setModuleNameAndPath("fielddecode", support.outputpath(), support.language);
 
     if(support.specialFloat)
         source.writeIncludeDirective("floatspecial");
@@ -7,7 +7,7 @@ class FieldCoding : public ProtocolScaling
 {
 public:
 
-    FieldCoding(ProtocolSupport sup);
+    FieldCoding(const ProtocolSupport& sup);
 
     //! Perform the generation, writing out the files
     bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
@@ -0,0 +1,240 @@
+#include "filewatcher.h"
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+/*!
+ * Construct a file watcher, which watches no files. On Linux the inotify
+ * descriptor is created now, and kept until the watcher is destroyed, so
+ * changes are queued even while nobody is waiting for them.
+ */
+FileWatcher::FileWatcher(void) :
+    settleTime(100),
+    pollTime(250),
+    notifyfd(-1)
+{
+    #if defined(__linux__)
+    notifyfd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    #endif
+}
+
+
+/*!
+ * Stop watching
+ */
+FileWatcher::~FileWatcher(void)
+{
+    #if defined(__linux__)
+    if(notifyfd >= 0)
+        close(notifyfd);
+    #endif
+}
+
+
+/*!
+ * Add files to the files that are watched. Files that are already watched
+ * are ignored. Watch files before they are read, so that a change made while
+ * they are read is seen.
+ * \param list is the list of files to watch
+ */
+void FileWatcher::watch(const std::vector<std::string>& list)
+{
+    for(const std::string& file : list)
+    {
+        std::string name = canonicalName(file);
+
+        if(files.count(name) > 0)
+            continue;
+
+        files[name] = modificationTime(name);
+
+        // If inotify cannot watch every file then poll all of them
+        if((notifyfd >= 0) && !addNotify(name))
+        {
+            #if defined(__linux__)
+            close(notifyfd);
+            #endif
+            notifyfd = -1;
+        }
+    }
+
+}// FileWatcher::watch
+
+
+/*!
+ * Wait until one of the watched files changes. This blocks until a change is
+ * seen, and then waits for the editor to finish writing. Changes made after
+ * that are reported by the next call.
+ * \return the name of the file that changed
+ */
+std::string FileWatcher::waitForChange(void)
+{
+    std::string changed;
+
+    if(notifyfd >= 0)
+        changed = waitForNotify();
+    else
+        changed = waitForPoll();
+
+    // Give the editor a chance to finish writing, saves often come in bursts
+    std::this_thread::sleep_for(std::chrono::milliseconds(settleTime));
+
+    // The burst is covered by the generation that follows, anything later is a new change
+    if(notifyfd >= 0)
+        drainNotify();
+
+    for(auto& entry : files)
+        entry.second = modificationTime(entry.first);
+
+    return changed;
+
+}// FileWatcher::waitForChange
+
+
+/*!
+ * Watch the directory of a file with inotify. A directory that is already
+ * watched gives the same watch descriptor again.
+ * \param name is the canonical name of the file
+ * \return false if the directory cannot be watched
+ */
+bool FileWatcher::addNotify(const std::string& name)
+{
+    #if defined(__linux__)
+    std::filesystem::path dir = std::filesystem::path(name).parent_path();
+    int wd = inotify_add_watch(notifyfd, dir.string().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+    if(wd < 0)
+        return false;
+
+    directories[wd] = dir;
+    return true;
+
+    #else
+    (void)name;
+    return false;
+    #endif
+
+}// FileWatcher::addNotify
+
+
+/*!
+ * Wait until one of the files changes by using inotify on the directories
+ * that contain the files. Events are matched against the watched files when
+ * they are read, so events queued before a file was added still count.
+ * \return the name of the file that changed
+ */
+std::string FileWatcher::waitForNotify(void)
+{
+    std::string changed;
+
+    #if defined(__linux__)
+    alignas(struct inotify_event) char buffer[4096];
+
+    while(changed.empty())
+    {
+        struct pollfd request = {notifyfd, POLLIN, 0};
+
+        if(poll(&request, 1, -1) <= 0)
+            continue;
+
+        ssize_t length = read(notifyfd, buffer, sizeof(buffer));
+
+        if(length <= 0)
+            continue;
+
+        for(char* ptr = buffer; ptr < buffer + length; )
+        {
+            const struct inotify_event* event = (const struct inotify_event*)ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if((event->len == 0) || (directories.count(event->wd) == 0))
+                continue;
+
+            std::string name = (directories[event->wd] / event->name).lexically_normal().string();
+
+            if(changed.empty() && (files.count(name) > 0))
+                changed = name;
+        }
+
+    }// while waiting for a change
+    #endif
+
+    return changed;
+
+}// FileWatcher::waitForNotify
+
+
+/*!
+ * Discard the inotify events that are already queued, without waiting
+ */
+void FileWatcher::drainNotify(void)
+{
+    #if defined(__linux__)
+    alignas(struct inotify_event) char buffer[4096];
+
+    while(read(notifyfd, buffer, sizeof(buffer)) > 0)
+        ;
+    #endif
+
+}// FileWatcher::drainNotify
+
+
+/*!
+ * Wait until one of the files changes by polling the modification times. The
+ * times are compared against the times last seen, which are kept between
+ * calls, so a change made between calls is not missed.
+ * \return the name of the file that changed
+ */
+std::string FileWatcher::waitForPoll(void)
+{
+    while(true)
+    {
+        for(const auto& entry : files)
+        {
+            if(modificationTime(entry.first) != entry.second)
+                return entry.first;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(pollTime));
+    }
+
+}// FileWatcher::waitForPoll
+
+
+/*!
+ * Get the modification time of a file
+ * \param file is the name of the file
+ * \return the modification time, or the minimum time if the file does not exist
+ */
+std::filesystem::file_time_type FileWatcher::modificationTime(const std::string& file)
+{
+    std::error_code ec;
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(file, ec);
+
+    if(ec)
+        return std::filesystem::file_time_type::min();
+
+    return time;
+}
+
+
+/*!
+ * Make a canonical name so that files can be compared
+ * \param file is the file name, which can be relative
+ * \return the absolute, normalized file name
+ */
+std::string FileWatcher::canonicalName(const std::string& file)
+{
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::absolute(file, ec);
+
+    if(ec)
+        path = file;
+
+    return path.lexically_normal().string();
+}
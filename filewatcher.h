@@ -0,0 +1,69 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <filesystem>
+
+/*!
+ * The FileWatcher blocks until one of a list of files changes. On Linux this
+ * uses inotify on the directories that contain the files, which also catches
+ * editors that save by writing a new file and renaming it over the old one.
+ * On other systems, or if inotify is not available, the modification times
+ * of the files are polled. One watcher is kept for the whole watch loop, so a
+ * change made while the output is being generated is seen by the next wait.
+ */
+class FileWatcher
+{
+public:
+
+    //! Construct a file watcher, which watches no files
+    FileWatcher(void);
+
+    //! Stop watching
+    ~FileWatcher(void);
+
+    //! Add files to the files that are watched
+    void watch(const std::vector<std::string>& files);
+
+    //! Wait until one of the watched files changes
+    std::string waitForChange(void);
+
+protected:
+
+    //! Watch the directory of a file with inotify
+    bool addNotify(const std::string& name);
+
+    //! Wait until one of the files changes by using inotify
+    std::string waitForNotify(void);
+
+    //! Discard the inotify events that are already queued
+    void drainNotify(void);
+
+    //! Wait until one of the files changes by polling modification times
+    std::string waitForPoll(void);
+
+    //! Get the modification time of a file, the minimum time if it does not exist
+    static std::filesystem::file_time_type modificationTime(const std::string& file);
+
+    //! Make a canonical name so that files can be compared
+    static std::string canonicalName(const std::string& file);
+
+    //! Time to wait after a change for the editor to finish writing, in milliseconds
+    int settleTime;
+
+    //! Time between checks when polling, in milliseconds
+    int pollTime;
+
+    //! The inotify descriptor, or -1 if the files are polled
+    int notifyfd;
+
+    //! The directories watched by inotify, by watch descriptor
+    std::map<int, std::filesystem::path> directories;
+
+    //! The watched files by canonical name, with the modification time last seen
+    std::map<std::string, std::filesystem::file_time_type> files;
+};
+
+#endif // FILEWATCHER_H
@@ -0,0 +1,88 @@
+#include "internedstring.h"
+#include <mutex>
+
+const std::string InternedString::emptyString;
+
+//! The newest pool of this thread, which receives new strings, or null if there is none
+static thread_local InternedString::Pool* currentPool = nullptr;
+
+//! The strings interned on threads with no pool. Entries are never removed
+static std::unordered_set<std::string>& globalPool(void)
+{
+    static std::unordered_set<std::string> strings;
+    return strings;
+}
+
+//! Protects the shared pool, which any thread without a pool can use
+static std::mutex& globalPoolMutex(void)
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+
+/*!
+ * Construct a pool, which receives the strings interned on this thread from
+ * now until it is destroyed, or a newer pool is constructed.
+ */
+InternedString::Pool::Pool(void)
+{
+    previous = currentPool;
+    currentPool = this;
+}
+
+
+/*!
+ * Free the strings of this pool. If a newer pool of this thread still exists
+ * this pool is only unlinked from the list of pools.
+ */
+InternedString::Pool::~Pool(void)
+{
+    if(currentPool == this)
+        currentPool = previous;
+    else
+    {
+        for(Pool* pool = currentPool; pool != nullptr; pool = pool->previous)
+        {
+            if(pool->previous == this)
+            {
+                pool->previous = previous;
+                break;
+            }
+        }
+    }
+
+}// InternedString::Pool::~Pool
+
+
+/*!
+ * Return the pool entry for a string, adding it if needed
+ * \param value is the string to intern
+ * \return a pointer to the pooled copy of the string
+ */
+const std::string* InternedString::intern(const std::string& value)
+{
+    if(value.empty())
+        return &emptyString;
+
+    if(currentPool != nullptr)
+        return &(*currentPool->strings.insert(value).first);
+
+    std::lock_guard<std::mutex> lock(globalPoolMutex());
+
+    return &(*globalPool().insert(value).first);
+}
+
+
+/*!
+ * Return the pool entry for a C string, adding it if needed
+ * \param value is the string to intern, which can be null
+ * \return a pointer to the pooled copy of the string
+ */
+const std::string* InternedString::intern(const char* value)
+{
+    if((value == nullptr) || (value[0] == '\0'))
+        return &emptyString;
+
+    return intern(std::string(value));
+}
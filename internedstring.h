@@ -0,0 +1,132 @@
+#ifndef INTERNEDSTRING_H
+#define INTERNEDSTRING_H
+
+#include <string>
+#include <unordered_set>
+
+/*!
+ * An InternedString is an immutable string stored once in a pool. The object
+ * itself is only a pointer into the pool, so fields that hold many strings
+ * (most of them empty, or repeated across thousands of fields like "0", "1",
+ * or a type name) take one pointer each instead of a std::string and its heap
+ * allocation. Assigning a new value interns it, and reading the value is a
+ * pointer dereference. It converts to a const std::string& so it can be used
+ * wherever a string is read. To change a value build it as a std::string and
+ * assign the result, so intermediate strings are not interned.
+ */
+class InternedString
+{
+public:
+
+    /*!
+     * A Pool owns the strings that are interned while it exists. Each parser
+     * has one, so the strings of a protocol are freed with its parser instead
+     * of living until the process exits. Pools belong to the thread that made
+     * them, so interning takes no lock. When pools overlap on a thread the
+     * newest one is used, and strings interned on a thread with no pool go to
+     * a shared pool that is never freed.
+     */
+    class Pool
+    {
+    public:
+
+        //! Construct a pool, which this thread uses until it is destroyed or a newer one is made
+        Pool(void);
+
+        //! Free the strings of this pool, which must be on the thread that made it. No InternedString may still use them
+        ~Pool(void);
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+    private:
+
+        friend class InternedString;
+
+        //! The strings, the nodes of an unordered_set do not move so pointers to them stay valid
+        std::unordered_set<std::string> strings;
+
+        //! The pool that was in use before this one
+        Pool* previous;
+    };
+
+    //! Construct an empty string
+    InternedString(void) : text(&emptyString) {}
+
+    //! Construct by interning a string
+    InternedString(const std::string& value) : text(intern(value)) {}
+
+    //! Construct by interning a C string
+    InternedString(const char* value) : text(intern(value)) {}
+
+    //! Assign a new value by interning it
+    InternedString& operator=(const std::string& value) {text = intern(value); return *this;}
+
+    //! Assign a new value by interning it
+    InternedString& operator=(const char* value) {text = intern(value); return *this;}
+
+    //! Return the string
+    const std::string& str(void) const {return *text;}
+
+    //! Return the string
+    operator const std::string&(void) const {return *text;}
+
+    //! Set the string to empty
+    void clear(void) {text = &emptyString;}
+
+    bool empty(void) const {return text->empty();}
+    std::size_t size(void) const {return text->size();}
+    std::size_t length(void) const {return text->length();}
+    const char* c_str(void) const {return text->c_str();}
+    char at(std::size_t i) const {return text->at(i);}
+    char operator[](std::size_t i) const {return (*text)[i];}
+    char front(void) const {return text->front();}
+    char back(void) const {return text->back();}
+    std::size_t find(const std::string& s, std::size_t pos = 0) const {return text->find(s, pos);}
+    std::size_t find(char c, std::size_t pos = 0) const {return text->find(c, pos);}
+    std::size_t rfind(const std::string& s, std::size_t pos = std::string::npos) const {return text->rfind(s, pos);}
+    std::size_t rfind(char c, std::size_t pos = std::string::npos) const {return text->rfind(c, pos);}
+    std::string substr(std::size_t pos = 0, std::size_t count = std::string::npos) const {return text->substr(pos, count);}
+    int compare(const std::string& s) const {return text->compare(s);}
+    std::string::const_iterator begin(void) const {return text->begin();}
+    std::string::const_iterator end(void) const {return text->end();}
+
+    //! Interned strings are equal if they are the same entry in a pool, or have the same text in different pools
+    bool operator==(const InternedString& that) const {return (text == that.text) || (*text == *that.text);}
+    bool operator!=(const InternedString& that) const {return !(*this == that);}
+
+    bool operator==(const std::string& that) const {return *text == that;}
+    bool operator!=(const std::string& that) const {return *text != that;}
+    bool operator==(const char* that) const {return *text == that;}
+    bool operator!=(const char* that) const {return *text != that;}
+
+private:
+
+    //! Return the pool entry for a string, adding it if needed
+    static const std::string* intern(const std::string& value);
+
+    //! Return the pool entry for a string, adding it if needed
+    static const std::string* intern(const char* value);
+
+    //! The empty string, which is not stored in the pool
+    static const std::string emptyString;
+
+    //! The entry in the pool
+    const std::string* text;
+};
+
+inline bool operator==(const std::string& one, const InternedString& two) {return two == one;}
+inline bool operator!=(const std::string& one, const InternedString& two) {return two != one;}
+inline bool operator==(const char* one, const InternedString& two) {return two == one;}
+inline bool operator!=(const char* one, const InternedString& two) {return two != one;}
+
+inline std::string operator+(const InternedString& one, const InternedString& two) {return one.str() + two.str();}
+inline std::string operator+(const InternedString& one, const std::string& two) {return one.str() + two;}
+inline std::string operator+(const std::string& one, const InternedString& two) {return one + two.str();}
+inline std::string operator+(const InternedString& one, const char* two) {return one.str() + two;}
+inline std::string operator+(const char* one, const InternedString& two) {return one + two.str();}
+inline std::string operator+(const InternedString& one, char two) {return one.str() + two;}
+inline std::string operator+(char one, const InternedString& two) {return one + two.str();}
+inline std::string operator+(std::string&& one, const InternedString& two) {return std::move(one.append(two.str()));}
+
+#endif // INTERNEDSTRING_H
@@ -0,0 +1,405 @@
+#include "latexrenderer.h"
+#include "protocolsupport.h"
+#include <cctype>
+#include <cstdlib>
+
+/*!
+ * Construct an empty renderer
+ */
+LatexRenderer::LatexRenderer(void) :
+    MarkdownRenderer()
+{
+}
+
+
+/*!
+ * Get the start of a complete LaTeX document, which goes before the output of
+ * render(). This is the preamble with the packages the output needs.
+ * \return the start of the LaTeX document
+ */
+std::string LatexRenderer::documentStart(void) const
+{
+    std::string output = "\\documentclass{report}\n";
+
+    output += "\\usepackage[utf8]{inputenc}\n";
+    output += "\\usepackage[T1]{fontenc}\n";
+    output += "\\usepackage{textcomp}\n";
+    output += "\\usepackage{longtable}\n";
+    output += "\\usepackage{hyperref}\n";
+
+    if(!title.empty())
+        output += "\\hypersetup{pdftitle={" + escapeText(title) + "}}\n";
+
+    output += "\n\\begin{document}\n\n";
+
+    return output;
+
+}// LatexRenderer::documentStart
+
+
+/*!
+ * Get the end of a complete LaTeX document, which goes after the output of render()
+ * \return the end of the LaTeX document
+ */
+std::string LatexRenderer::documentEnd(void) const
+{
+    return "\\end{document}\n";
+}
+
+
+/*!
+ * Format a heading as a sectioning command. The top headings use the LaTeX
+ * header level from the metadata: 1 for chapters, 2 for sections, and so on.
+ * The heading is a hyperlink target for its reference.
+ * \param heading is the heading, which has been recorded for the table of contents
+ * \param text is the markdown text of the heading, including any anchor
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatHeading(const Heading& heading, const std::string& text) const
+{
+    (void)text;
+
+    static const char* commands[] = {"chapter", "section", "subsection", "subsubsection", "paragraph", "subparagraph"};
+
+    int index = heading.level + latexHeaderLevel - 2;
+    if(index < 0)
+        index = 0;
+    else if(index > 5)
+        index = 5;
+
+    return std::string("\\") + commands[index] + "{" + renderInline(heading.text) + "}\n\\hypertarget{" + escapeReference(heading.reference) + "}{}\n\n";
+
+}// LatexRenderer::formatHeading
+
+
+/*!
+ * Format a paragraph as LaTeX
+ * \param text is the rendered text of the paragraph
+ * \param tight should be true for a paragraph in a list without blank lines
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatParagraph(const std::string& text, bool tight) const
+{
+    if(tight)
+        return text + "\n";
+    else
+        return text + "\n\n";
+}
+
+
+/*!
+ * Format a code block as verbatim text
+ * \param code is the literal text of the code block
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatCode(const std::string& code) const
+{
+    return "\\begin{verbatim}\n" + code + "\\end{verbatim}\n\n";
+}
+
+
+/*!
+ * Format a horizontal rule as LaTeX
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatRule(void) const
+{
+    return "\\begin{center}\\rule{3in}{0.4pt}\\end{center}\n\n";
+}
+
+
+/*!
+ * Format a block of raw html. The html cannot be rendered, so it is dropped,
+ * except for the page breaks that ProtoGen puts in the documentation.
+ * \param html is the lines of the block
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatHtmlBlock(const std::string& html) const
+{
+    if(contains(html, "class=\"page-break\""))
+        return "\\clearpage\n\n";
+    else
+        return std::string();
+}
+
+
+/*!
+ * Format a block quote as LaTeX
+ * \param contents are the rendered blocks of the quote
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatQuote(const std::string& contents) const
+{
+    return "\\begin{quote}\n" + contents + "\\end{quote}\n\n";
+}
+
+
+/*!
+ * Format a list as LaTeX
+ * \param items are the rendered blocks of each item
+ * \param ordered should be true for a numbered list
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatList(const std::vector<std::string>& items, bool ordered) const
+{
+    std::string environment = ordered ? "enumerate" : "itemize";
+    std::string output = "\\begin{" + environment + "}\n";
+
+    for(const std::string& item : items)
+        output += "\\item " + item + "\n";
+
+    output += "\\end{" + environment + "}\n\n";
+
+    return output;
+}
+
+
+/*!
+ * Format a table as a longtable, so tables can break across pages. The header
+ * row is repeated on each page.
+ * \param caption is the rendered caption, which can be empty
+ * \param alignments gives the alignment of each column: 'l', 'c', 'r', or ' ' for the default
+ * \param rows are the rendered cells of each row, the first row is the header
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatTable(const std::string& caption, const std::vector<char>& alignments, const std::vector<std::vector<TableCell>>& rows) const
+{
+    // The number of columns is the widest of the rows and the separator
+    std::size_t columns = alignments.size();
+    for(const std::vector<TableCell>& row : rows)
+    {
+        if(!row.empty() && (row.back().column + row.back().span > columns))
+            columns = row.back().column + row.back().span;
+    }
+
+    std::string output = "\\begin{longtable}{|";
+
+    for(std::size_t c = 0; c < columns; c++)
+    {
+        char alignment = (c < alignments.size()) ? alignments.at(c) : ' ';
+        output += ((alignment == ' ') ? 'l' : alignment);
+        output += "|";
+    }
+
+    output += "}\n";
+
+    if(!caption.empty())
+        output += "\\caption{" + caption + "} \\\\\n";
+
+    output += "\\hline\n";
+
+    for(std::size_t r = 0; r < rows.size(); r++)
+    {
+        const std::vector<TableCell>& row = rows.at(r);
+
+        for(std::size_t c = 0; c < row.size(); c++)
+        {
+            const TableCell& cell = row.at(c);
+
+            if(c > 0)
+                output += " & ";
+
+            if(cell.span > 1)
+            {
+                char alignment = (cell.column < alignments.size()) ? alignments.at(cell.column) : ' ';
+                std::string spec = (alignment == ' ') ? std::string("l") : std::string(1, alignment);
+                output += "\\multicolumn{" + std::to_string(cell.span) + "}{|" + spec + "|}{" + cell.text + "}";
+            }
+            else
+                output += cell.text;
+        }
+
+        output += " \\\\\n\\hline\n";
+
+        if(r == 0)
+            output += "\\endhead\n";
+    }
+
+    output += "\\end{longtable}\n\n";
+
+    return output;
+
+}// LatexRenderer::formatTable
+
+
+/*!
+ * Format a code span as LaTeX
+ * \param code is the literal text of the code span
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatCodeSpan(const std::string& code) const
+{
+    return "\\texttt{" + escapeText(code) + "}";
+}
+
+
+/*!
+ * Format a link as LaTeX. Links in the document go to the hyperlink target of
+ * the anchor or heading.
+ * \param url is the target of the link, which starts with '#' for a link in the document
+ * \param text is the rendered text of the link
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatLink(const std::string& url, const std::string& text) const
+{
+    if(startsWith(url, "#"))
+        return "\\hyperlink{" + escapeReference(url.substr(1)) + "}{" + text + "}";
+
+    std::string target;
+
+    for(char symbol : url)
+    {
+        if((symbol == '%') || (symbol == '#') || (symbol == '\\') || (symbol == '{') || (symbol == '}'))
+            target += '\\';
+
+        target += symbol;
+    }
+
+    return "\\href{" + target + "}{" + text + "}";
+
+}// LatexRenderer::formatLink
+
+
+/*!
+ * Format emphasis as LaTeX
+ * \param text is the rendered text to emphasize
+ * \param strong should be true for strong emphasis
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatEmphasis(const std::string& text, bool strong) const
+{
+    if(strong)
+        return "\\textbf{" + text + "}";
+    else
+        return "\\emph{" + text + "}";
+}
+
+
+/*!
+ * Format a raw html tag in text. Anchors become hyperlink targets and line
+ * breaks are kept, every other tag is dropped.
+ * \param tag is the tag, including the angle brackets
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatInlineHtml(const std::string& tag) const
+{
+    if(startsWith(tag, "<a name=\""))
+    {
+        std::size_t start = 9;
+        return "\\hypertarget{" + escapeReference(tag.substr(start, tag.find('"', start) - start)) + "}{}";
+    }
+    else if(startsWith(tag, "<br"))
+        return "\\newline ";
+    else
+        return std::string();
+}
+
+
+/*!
+ * Format an html entity as LaTeX. The entities that ProtoGen and common
+ * comments use are converted, others are dropped.
+ * \param entity is the entity, including the ampersand and semicolon
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatEntity(const std::string& entity) const
+{
+    std::string name = entity.substr(1, entity.size() - 2);
+
+    // Numeric entities in the ASCII range are the character itself
+    if(startsWith(name, "#"))
+    {
+        long value = std::strtol(name.c_str() + 1, nullptr, 10);
+        if((value > 31) && (value < 127))
+            return escapeText(std::string(1, (char)value));
+        else
+            return std::string();
+    }
+
+    if(name == "deg")
+        return "\\textdegree{}";
+    else if(name == "amp")
+        return "\\&";
+    else if(name == "lt")
+        return "\\textless{}";
+    else if(name == "gt")
+        return "\\textgreater{}";
+    else if(name == "quot")
+        return "\"";
+    else if(name == "nbsp")
+        return "~";
+    else if(name == "plusmn")
+        return "\\textpm{}";
+    else if(name == "times")
+        return "\\texttimes{}";
+    else if((name == "micro") || (name == "mu"))
+        return "\\textmu{}";
+    else
+        return std::string();
+
+}// LatexRenderer::formatEntity
+
+
+/*!
+ * Format plain text as LaTeX, escaping the special characters
+ * \param text is the plain text
+ * \return the LaTeX text
+ */
+std::string LatexRenderer::formatText(const std::string& text) const
+{
+    return escapeText(text);
+}
+
+
+/*!
+ * Escape text so it appears literally in LaTeX
+ * \param text is the text to escape
+ * \return the escaped text
+ */
+std::string LatexRenderer::escapeText(const std::string& text) const
+{
+    std::string output;
+
+    for(char symbol : text)
+    {
+        switch(symbol)
+        {
+        case '\\': output += "\\textbackslash{}"; break;
+        case '{': case '}': case '#': case '$': case '%': case '&': case '_':
+            output += '\\';
+            output += symbol;
+            break;
+        case '~': output += "\\textasciitilde{}"; break;
+        case '^': output += "\\textasciicircum{}"; break;
+        case '<': output += "\\textless{}"; break;
+        case '>': output += "\\textgreater{}"; break;
+        case '|': output += "\\textbar{}"; break;
+        default: output += symbol; break;
+        }
+    }
+
+    return output;
+
+}// LatexRenderer::escapeText
+
+
+/*!
+ * Escape a label so it can be used as a hyperlink target. Characters other
+ * than letters, digits and a few punctuation marks are replaced, the same
+ * way for the target and the links to it.
+ * \param text is the label
+ * \return the escaped label
+ */
+std::string LatexRenderer::escapeReference(const std::string& text)
+{
+    std::string output;
+
+    for(char symbol : text)
+    {
+        if(std::isalnum((unsigned char)symbol) || (symbol == '-') || (symbol == '.') || (symbol == ':'))
+            output += symbol;
+        else
+            output += '-';
+    }
+
+    return output;
+}
@@ -0,0 +1,78 @@
+#ifndef LATEXRENDERER_H
+#define LATEXRENDERER_H
+
+#include "markdownrenderer.h"
+
+/*!
+ * The LatexRenderer converts the markdown that ProtoGen writes into LaTeX,
+ * using the parsing of the MarkdownRenderer, so the LaTeX documentation does
+ * not need an external markdown processor. Headings become sectioning
+ * commands, starting at the level given by the "LaTeX Header Level" metadata
+ * (1 for chapters), tables use the longtable package, and links use the
+ * hyperref package. Raw html blocks, like the stylesheet, are dropped.
+ */
+class LatexRenderer : public MarkdownRenderer
+{
+public:
+
+    //! Construct an empty renderer
+    LatexRenderer(void);
+
+    //! Get the start of a complete LaTeX document, which goes before the output of render()
+    std::string documentStart(void) const override;
+
+    //! Get the end of a complete LaTeX document, which goes after the output of render()
+    std::string documentEnd(void) const override;
+
+protected:
+
+    //! Format a heading as a sectioning command
+    std::string formatHeading(const Heading& heading, const std::string& text) const override;
+
+    //! Format a paragraph
+    std::string formatParagraph(const std::string& text, bool tight) const override;
+
+    //! Format a code block as verbatim text
+    std::string formatCode(const std::string& code) const override;
+
+    //! Format a horizontal rule
+    std::string formatRule(void) const override;
+
+    //! Format a block of raw html, which is dropped
+    std::string formatHtmlBlock(const std::string& html) const override;
+
+    //! Format a block quote
+    std::string formatQuote(const std::string& contents) const override;
+
+    //! Format a list
+    std::string formatList(const std::vector<std::string>& items, bool ordered) const override;
+
+    //! Format a table as a longtable
+    std::string formatTable(const std::string& caption, const std::vector<char>& alignments, const std::vector<std::vector<TableCell>>& rows) const override;
+
+    //! Format a code span
+    std::string formatCodeSpan(const std::string& code) const override;
+
+    //! Format a link
+    std::string formatLink(const std::string& url, const std::string& text) const override;
+
+    //! Format emphasis
+    std::string formatEmphasis(const std::string& text, bool strong) const override;
+
+    //! Format a raw html tag in text
+    std::string formatInlineHtml(const std::string& tag) const override;
+
+    //! Format an html entity
+    std::string formatEntity(const std::string& entity) const override;
+
+    //! Format plain text
+    std::string formatText(const std::string& text) const override;
+
+    //! Escape text so it appears literally in LaTeX
+    std::string escapeText(const std::string& text) const override;
+
+    //! Escape a label or url so it can be used in a LaTeX command
+    static std::string escapeReference(const std::string& text);
+};
+
+#endif // LATEXRENDERER_H
@@ -1,9 +1,13 @@
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include "shuntingyard.h"
 #include "protocolparser.h"
+#include "filewatcher.h"
+#include "xmlloader.h"
 
 static void printHelp(void);
+static void configureParser(ProtocolParser& parser, const std::vector<std::string>& arguments);
 
 int main(int argc, char *argv[])
 {
@@ -43,6 +47,8 @@ int main(int argc, char *argv[])
             if( startsWith(argument, "-d")            ||
                 startsWith(argument, "-li")           ||
                 startsWith(argument, "-latex-header") ||
+                startsWith(argument, "-profile-trace") ||
+                startsWith(argument, "-profile-top") ||
                 isEqual(argument, "-s")               ||
                 startsWith(argument, "-style")        ||
                 startsWith(argument, "-ti") )
@@ -55,8 +61,6 @@ int main(int argc, char *argv[])
 
     }// for all arguments except the first one
 
-    ProtocolParser parser;
-
     // Process the positional arguments
     std::vector<std::string> otherfiles;
     std::string filename, path;
@@ -86,6 +90,100 @@ int main(int argc, char *argv[])
         return 2;   // no input file
     }
 
+    // Profiling trace file
+    std::string profileTrace = liststartsWith(arguments, "-profile-trace");
+    profileTrace = profileTrace.substr(profileTrace.find(" ") + 1);
+
+    // Number of slowest modules in the profile report
+    std::size_t profileTop = 10;
+    std::string profileTopText = liststartsWith(arguments, "-profile-top");
+    if(!profileTopText.empty())
+        profileTop = (std::size_t)std::stoul(profileTopText.substr(profileTopText.find(" ") + 1));
+
+    bool watch = contains(arguments, "-watch");
+    FileWatcher watcher;
+    XmlLoader loader;
+    ModuleCache cache;
+    bool ok;
+
+    // Watch the files from the command line before they are first read, in
+    // case they fail to parse, or change while the first generation runs
+    if(watch)
+    {
+        std::vector<std::string> files(1, filename);
+        files.insert(files.end(), otherfiles.begin(), otherfiles.end());
+        watcher.watch(files);
+    }
+
+    while(true)
+    {
+        // Each generation uses a new parser, but the xml documents stay
+        // resident in the loader, and only the files that changed are read again
+        loader.refresh();
+
+        ProtocolParser parser;
+        parser.setXmlLoader(&loader);
+        configureParser(parser, arguments);
+
+        // The modules from the last generation are remembered, so only the
+        // modules affected by a change are generated again
+        if(watch)
+            parser.setModuleCache(&cache);
+
+        ok = parser.parse(filename, path, otherfiles);
+
+        if(parser.getProfiler().isEnabled())
+        {
+            parser.getProfiler().report(std::cerr, profileTop);
+
+            if(!profileTrace.empty() && !parser.getProfiler().writeTrace(profileTrace))
+                std::cerr << "warning: Failed to write profile trace file " << profileTrace << std::endl;
+        }
+
+        if(!watch)
+            break;
+
+        // An unchanged module shared a file with output that changed, so generate everything
+        if(cache.isInvalid())
+            continue;
+
+        // Also watch every Require'd file that was parsed, but not the
+        // temporary files the parser deletes again, like the bitfield tester
+        std::vector<std::string> files;
+        for(const std::string& file : parser.getFilesParsed())
+        {
+            if(std::filesystem::exists(file))
+                files.push_back(file);
+        }
+
+        watcher.watch(files);
+
+        std::cout << "Watching for changes, press Ctrl+C to stop" << std::endl;
+        std::string changed = watcher.waitForChange();
+        std::cout << std::endl << changed << " changed, regenerating" << std::endl;
+
+    }// while watching for changes
+
+    if (ok)
+    {
+        // Normal exit
+        return 0;
+    }
+    else
+    {
+        // Input file in error
+        return 1;
+    }
+
+}// main
+
+/*!
+ * Configure the parser from the optional command line arguments
+ * \param parser is the parser to configure
+ * \param arguments is the list of command line arguments
+ */
+void configureParser(ProtocolParser& parser, const std::vector<std::string>& arguments)
+{
     // License template file
     std::string licenseTemplate = liststartsWith(arguments, "-li");
     licenseTemplate = licenseTemplate.substr(licenseTemplate.find(" ") + 1);
@@ -125,6 +223,16 @@ int main(int argc, char *argv[])
     parser.setLaTeXSupport(contains(arguments, "-latex"));
     parser.disableCSS(contains(arguments, "-no-css"));
     parser.enableTableOfContents(contains(arguments, "-table-of-contents"));
+    parser.enableNumpy(contains(arguments, "-numpy"));
+    parser.enableReplay(contains(arguments, "-replay"));
+    parser.enableColumns(contains(arguments, "-columns"));
+    parser.enableLog(contains(arguments, "-log"));
+    parser.enableUdp(contains(arguments, "-udp"));
+    parser.enableShm(contains(arguments, "-shm"));
+    parser.enablePrecompile(contains(arguments, "-precompile"));
+
+    // Profiling output, the trace file or module count implies profiling
+    parser.enableProfiling(contains(arguments, "-profile") || !liststartsWith(arguments, "-profile-trace").empty() || !liststartsWith(arguments, "-profile-top").empty());
 
     if(contains(arguments, "-lang-c"))
         parser.setLanguageOverride(ProtocolSupport::c_language);
@@ -186,18 +294,8 @@ int main(int argc, char *argv[])
         }
     }
 
-    if (parser.parse(filename, path, otherfiles))
-    {
-        // Normal exit
-        return 0;
-    }
-    else
-    {
-        // Input file in error
-        return 1;
-    }
+}// configureParser
 
-}// main
 
 
 void printHelp(void)
@@ -241,6 +339,31 @@ Usage: ProtoGen inputfile.xml <outputpath> <otherinputfiles.xml> -options
                        specifier in the protocol file.
   -lang-cpp          : Force the output language to C++, overriding the
                        language specifier in the protocol file.
+  -profile           : Report the time, memory allocations, and peak heap use
+                       of each phase, and the slowest modules, to stderr.
+  -profile-trace <f> : Also write the profile to a JSON file <f> which can be
+                       loaded in Chrome's trace viewer.
+  -profile-top <n>   : Profile, and list the <n> slowest modules (default = 10).
+  -numpy             : Also write <Protocol>Numpy.py, with NumPy dtypes and
+                       functions that decode many structures at once.
+  -replay            : Also write <Protocol>Replay.cpp, a multithreaded tool
+                       that decodes a capture file and counts each packet.
+  -columns           : Also write <Protocol>Columns.hpp/.cpp, with functions
+                       that append decoded packets to typed columns.
+  -log               : Also write <Protocol>Log.hpp/.cpp, with functions that
+                       write packets to a binary log indexed by packet type
+                       and time, and read them back.
+  -udp               : Also write <Protocol>Udp.hpp/.cpp, a Linux transport
+                       that receives and sends packets over UDP in batches.
+  -shm               : Also write <Protocol>Shm.hpp/.cpp, with functions that
+                       publish packets and decoded structures to other
+                       processes through shared memory.
+  -precompile        : Write the parsed enumerations and structures of each
+                       Require'd file to a .pgc library next to it, which
+                       later runs load instead of parsing the file again.
+  -watch             : Stay resident after generating, and generate again
+                       whenever one of the protocol xml files changes.
+                       Only the files that changed are read again.
   -version           : Prints just the version information.
 
 )===";
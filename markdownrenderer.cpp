@@ -0,0 +1,1209 @@
+#include "markdownrenderer.h"
+#include "protocolsupport.h"
+#include <cctype>
+
+/*!
+ * Construct an empty renderer
+ */
+MarkdownRenderer::MarkdownRenderer(void) :
+    baseHeaderLevel(1),
+    latexHeaderLevel(1)
+{
+}
+
+
+/*!
+ * Render markdown to html. The headings are recorded for the table of contents.
+ * \param markdown is the markdown text to render
+ * \param out receives the html text, which is not a complete document
+ * \param metadata should be true if the markdown can start with metadata
+ *        lines, which are used for the document and not rendered
+ */
+void MarkdownRenderer::render(const std::string& markdown, std::ostream& out, bool metadata)
+{
+    std::vector<std::string> lines = split(markdown, "\n", true);
+
+    for(std::string& line : lines)
+    {
+        if(!line.empty() && (line.back() == '\r'))
+            line.pop_back();
+    }
+
+    if(metadata)
+        lines.erase(lines.begin(), lines.begin() + parseMetadata(lines));
+
+    out << renderBlocks(lines, false);
+
+}// MarkdownRenderer::render
+
+
+/*!
+ * Get the start of a complete html document, which goes before the output of render()
+ * \return the start of the html document
+ */
+std::string MarkdownRenderer::documentStart(void) const
+{
+    std::string output = "<!DOCTYPE html>\n<html>\n<head>\n\t<meta charset=\"utf-8\"/>\n";
+
+    if(!title.empty())
+        output += "\t<title>" + escape(title) + "</title>\n";
+
+    output += "</head>\n<body>\n\n";
+
+    return output;
+
+}// MarkdownRenderer::documentStart
+
+
+/*!
+ * Get the end of a complete html document, which goes after the output of render()
+ * \return the end of the html document
+ */
+std::string MarkdownRenderer::documentEnd(void) const
+{
+    return "</body>\n</html>\n";
+}
+
+
+/*!
+ * Return the table of contents of all the headings rendered so far. Each line
+ * of the table uses a tag for the level of the heading, so it can be styled.
+ * \return the table of contents as markdown
+ */
+std::string MarkdownRenderer::getTableOfContents(void) const
+{
+    std::string output;
+
+    if(!headings.empty())
+        output = "<toctitle id=\"tableofcontents\">Table of contents</toctitle>\n";
+
+    for(const Heading& heading : headings)
+    {
+        std::string level = std::to_string(heading.level);
+        output += "<toc" + level + "><a href=\"#" + heading.reference + "\">" + heading.text + "</a></toc" + level + ">\n";
+    }
+
+    return output + "\n";
+
+}// MarkdownRenderer::getTableOfContents
+
+
+/*!
+ * Return the identifier used for a heading, which is the target of links to
+ * the heading. The identifier is the text in lower case, without spaces and
+ * other special characters.
+ * \param text is the text of the heading
+ * \return the identifier of the heading
+ */
+std::string MarkdownRenderer::headingIdentifier(const std::string& text)
+{
+    std::string identifier;
+
+    for(char symbol : toLower(text))
+    {
+        switch(symbol)
+        {
+        case ' ': case '(': case ')': case '{': case '}':
+        case '[': case ']': case '`': case '"': case '*':
+            break;
+
+        default:
+            identifier += symbol;
+            break;
+        }
+    }
+
+    return identifier;
+
+}// MarkdownRenderer::headingIdentifier
+
+
+/*!
+ * Parse metadata lines from the start of the markdown. Metadata are lines of
+ * the form "key: value" at the very start, ending with a blank line.
+ * \param lines are the lines of the markdown
+ * \return the number of lines of metadata, which can be zero
+ */
+std::size_t MarkdownRenderer::parseMetadata(const std::vector<std::string>& lines)
+{
+    std::size_t i;
+
+    for(i = 0; i < lines.size(); i++)
+    {
+        const std::string& line = lines.at(i);
+
+        if(trimm(line).empty())
+            break;
+
+        std::size_t colon = line.find(':');
+        if((colon == 0) || (colon == std::string::npos))
+            break;
+
+        std::string key;
+        for(std::size_t j = 0; j < colon; j++)
+        {
+            char symbol = line.at(j);
+
+            if(std::isalnum((unsigned char)symbol))
+                key += (char)std::tolower((unsigned char)symbol);
+            else if((symbol != ' ') && (symbol != '-') && (symbol != '_'))
+            {
+                key.clear();
+                break;
+            }
+        }
+
+        if(key.empty())
+            break;
+
+        std::string value = trimm(line.substr(colon + 1));
+
+        if(key == "title")
+            title = value;
+        else if(key == "baseheaderlevel")
+            baseHeaderLevel = std::atoi(value.c_str());
+        else if(key == "latexheaderlevel")
+            latexHeaderLevel = std::atoi(value.c_str());
+
+    }// for all lines
+
+    // Metadata must be followed by a blank line, else it was not metadata
+    if((i == 0) || (i >= lines.size()) || !trimm(lines.at(i)).empty())
+        return 0;
+
+    return i;
+
+}// MarkdownRenderer::parseMetadata
+
+
+/*!
+ * Render a list of lines as blocks.
+ * \param lines are the lines of the markdown
+ * \param tight should be true for the contents of a list item without blank
+ *        lines, in which case paragraphs are not wrapped in paragraph tags.
+ * \return the rendered text
+ */
+std::string MarkdownRenderer::renderBlocks(const std::vector<std::string>& lines, bool tight)
+{
+    std::string output;
+    std::size_t i = 0;
+
+    while(i < lines.size())
+    {
+        const std::string& line = lines.at(i);
+        std::string trimmed = trimm(line);
+        std::string tag;
+        bool ordered;
+
+        if(trimmed.empty())
+        {
+            i++;
+        }
+        else if(startsWith(trimmed, "```") || startsWith(trimmed, "~~~"))
+        {
+            // Fenced code block
+            std::string fence = trimmed.substr(0, 3);
+            std::string code;
+
+            for(i++; (i < lines.size()) && !startsWith(trimm(lines.at(i)), fence); i++)
+                code += lines.at(i) + "\n";
+
+            output += formatCode(code);
+            i++;
+        }
+        else if(indentation(line) >= 4)
+        {
+            // Indented code block, which can include blank lines
+            std::string code, blanks;
+
+            for(; i < lines.size(); i++)
+            {
+                if(trimm(lines.at(i)).empty())
+                    blanks += "\n";
+                else if(indentation(lines.at(i)) >= 4)
+                {
+                    code += blanks + dedent(lines.at(i), 4) + "\n";
+                    blanks.clear();
+                }
+                else
+                    break;
+            }
+
+            output += formatCode(code);
+        }
+        else if(startsWith(trimmed, "#"))
+        {
+            output += renderHeading(trimmed);
+            i++;
+        }
+        else if(isRule(line))
+        {
+            output += formatRule();
+            i++;
+        }
+        else if(isHtmlBlock(trimmed, tag))
+        {
+            // Raw html is passed through. Some tags can have blank lines in
+            // their contents, in which case the block ends with the closing tag
+            std::string closer;
+            if(tag == "!--")
+                closer = "-->";
+            else if((tag == "style") || (tag == "script") || (tag == "pre") || (tag == "textarea"))
+                closer = "</" + tag;
+
+            std::string html;
+
+            for(; i < lines.size(); i++)
+            {
+                if(closer.empty() && trimm(lines.at(i)).empty())
+                    break;
+
+                html += lines.at(i) + "\n";
+
+                if(!closer.empty() && contains(lines.at(i), closer))
+                {
+                    i++;
+                    break;
+                }
+            }
+
+            output += formatHtmlBlock(html);
+        }
+        else if(contains(line, "|") && (i + 1 < lines.size()) && isTableSeparator(lines.at(i + 1)))
+        {
+            // Table, which ends with the first line that is not a row
+            std::vector<std::string> rows;
+            std::string caption;
+
+            for(; (i < lines.size()) && contains(lines.at(i), "|"); i++)
+                rows.push_back(lines.at(i));
+
+            // Optional caption in brackets after the table
+            if(i < lines.size())
+            {
+                std::string next = trimm(lines.at(i));
+
+                if((next.size() >= 2) && (next.front() == '[') && (next.back() == ']'))
+                {
+                    caption = next.substr(1, next.size() - 2);
+                    i++;
+                }
+            }
+
+            output += renderTable(rows, caption);
+        }
+        else if(trimmed.front() == '>')
+        {
+            // Block quote, the contents are blocks themselves
+            std::vector<std::string> quote;
+
+            for(; (i < lines.size()) && !trimm(lines.at(i)).empty(); i++)
+            {
+                std::string quoted = trimm(lines.at(i));
+
+                if(quoted.front() == '>')
+                {
+                    quoted.erase(0, 1);
+                    if(!quoted.empty() && (quoted.front() == ' '))
+                        quoted.erase(0, 1);
+                }
+
+                quote.push_back(quoted);
+            }
+
+            output += formatQuote(renderBlocks(quote, false));
+        }
+        else if(listMarker(line, ordered) > 0)
+        {
+            // List, which continues across blank lines if the next line is
+            // indented or is another item.
+            std::vector<std::string> list;
+
+            while(i < lines.size())
+            {
+                if(trimm(lines.at(i)).empty())
+                {
+                    std::size_t next = i;
+                    while((next < lines.size()) && trimm(lines.at(next)).empty())
+                        next++;
+
+                    bool nextordered;
+                    if((next >= lines.size()) || ((indentation(lines.at(next)) < 2) && (listMarker(lines.at(next), nextordered) == 0)))
+                        break;
+
+                    list.insert(list.end(), lines.begin() + i, lines.begin() + next);
+                    i = next;
+                }
+                else if((indentation(lines.at(i)) < 2) && (startsWith(trimm(lines.at(i)), "#") || isRule(lines.at(i))))
+                    break;
+                else
+                {
+                    list.push_back(lines.at(i));
+                    i++;
+                }
+
+            }// while lines are in the list
+
+            output += renderList(list, ordered);
+        }
+        else
+        {
+            // Paragraph, which ends with a blank line or a line that must start a new block
+            std::string paragraph;
+
+            for(; i < lines.size(); i++)
+            {
+                const std::string& next = lines.at(i);
+                std::string nexttrimmed = trimm(next);
+
+                if(nexttrimmed.empty())
+                    break;
+
+                if(!paragraph.empty())
+                {
+                    if(startsWith(nexttrimmed, "#") || startsWith(nexttrimmed, "```") || startsWith(nexttrimmed, "~~~"))
+                        break;
+
+                    if(contains(next, "|") && (i + 1 < lines.size()) && isTableSeparator(lines.at(i + 1)))
+                        break;
+
+                    // Sub lists in list items do not need a blank line
+                    if(tight && (listMarker(next, ordered) > 0))
+                        break;
+
+                    // Two spaces at the end of a line are a line break, which
+                    // is written as the html tag, so it is rendered inline
+                    if(endsWith(paragraph, "  "))
+                        paragraph = trimm(paragraph) + "<br />";
+
+                    paragraph += "\n";
+                }
+
+                paragraph += nexttrimmed;
+
+            }// for all lines of the paragraph
+
+            output += formatParagraph(renderInline(paragraph), tight);
+        }
+
+    }// while all lines
+
+    return output;
+
+}// MarkdownRenderer::renderBlocks
+
+
+/*!
+ * Render a heading line, and record the heading for the table of contents
+ * \param line is the heading line, which starts with one or more '#'
+ * \return the rendered text
+ */
+std::string MarkdownRenderer::renderHeading(const std::string& line)
+{
+    std::size_t level = 0;
+    while((level < line.size()) && (line.at(level) == '#'))
+        level++;
+
+    // The closing '#'s are optional
+    std::string text = trimm(line.substr(level));
+    while(!text.empty() && (text.back() == '#'))
+        text.pop_back();
+    text = trimm(text);
+
+    if(text.empty())
+        return std::string();
+
+    Heading heading;
+    heading.level = (int)level;
+    heading.text = text;
+
+    // An embedded anchor gives the reference, otherwise the reference is the
+    // identifier that we put on the heading
+    std::size_t anchor = text.find("<a name=\"");
+    if(anchor != std::string::npos)
+    {
+        std::size_t start = anchor + 9;
+        heading.reference = text.substr(start, text.find('"', start) - start);
+
+        std::size_t end = text.find("</a>", start);
+        if(end != std::string::npos)
+            heading.text = trimm(text.substr(end + 4));
+    }
+    else
+        heading.reference = headingIdentifier(text);
+
+    headings.push_back(heading);
+
+    return formatHeading(heading, text);
+
+}// MarkdownRenderer::renderHeading
+
+
+/*!
+ * Render a table. The second row gives the alignment of each column. Empty
+ * cells (with no white space) extend the cell before them across columns.
+ * \param rows are the lines of the table, including the header and separator rows
+ * \param caption is the caption of the table, which can be empty
+ * \return the rendered text
+ */
+std::string MarkdownRenderer::renderTable(const std::vector<std::string>& rows, const std::string& caption) const
+{
+    std::vector<char> alignments;
+
+    for(const std::string& cell : splitRow(rows.at(1)))
+    {
+        std::string spec = trimm(cell);
+        bool left = startsWith(spec, ":");
+        bool right = endsWith(spec, ":");
+
+        if(left && right)
+            alignments.push_back('c');
+        else if(right)
+            alignments.push_back('r');
+        else if(left)
+            alignments.push_back('l');
+        else
+            alignments.push_back(' ');
+    }
+
+    // The separator row is not output
+    std::vector<std::vector<TableCell>> cellrows;
+
+    for(std::size_t r = 0; r < rows.size(); r++)
+    {
+        if(r == 1)
+            continue;
+
+        std::vector<std::string> cells = splitRow(rows.at(r));
+        std::vector<TableCell> cellrow;
+
+        std::size_t column = 0;
+        for(std::size_t c = 0; c < cells.size(); c++)
+        {
+            TableCell cell;
+
+            cell.column = column;
+            cell.span = 1;
+            while((c + cell.span < cells.size()) && cells.at(c + cell.span).empty())
+                cell.span++;
+
+            cell.text = renderInline(trimm(cells.at(c)));
+            cellrow.push_back(cell);
+
+            column += cell.span;
+            c += cell.span - 1;
+        }
+
+        cellrows.push_back(cellrow);
+    }
+
+    return formatTable(caption.empty() ? caption : renderInline(caption), alignments, cellrows);
+
+}// MarkdownRenderer::renderTable
+
+
+/*!
+ * Render a list. Each item is rendered as blocks, and if there are blank
+ * lines in the list the items are paragraphs.
+ * \param lines are the lines of the list
+ * \param ordered should be true for a numbered list
+ * \return the rendered text
+ */
+std::string MarkdownRenderer::renderList(const std::vector<std::string>& lines, bool ordered)
+{
+    std::vector<std::vector<std::string>> items;
+    std::size_t base = indentation(lines.at(0));
+    std::size_t width = 0;
+    bool loose = false;
+
+    for(const std::string& line : lines)
+    {
+        bool itemordered;
+        std::size_t marker = listMarker(line, itemordered);
+
+        if((marker > 0) && (indentation(line) <= base + 1))
+        {
+            // A new item, the text starts after the marker
+            width = marker;
+            items.push_back(std::vector<std::string>(1, line.substr(marker)));
+        }
+        else
+        {
+            if(trimm(line).empty())
+                loose = true;
+
+            items.back().push_back(dedent(line, width));
+        }
+    }
+
+    std::vector<std::string> contents;
+
+    for(const std::vector<std::string>& item : items)
+    {
+        contents.push_back(renderBlocks(item, !loose));
+
+        while(!contents.back().empty() && std::isspace((unsigned char)contents.back().back()))
+            contents.back().pop_back();
+    }
+
+    return formatList(contents, ordered);
+
+}// MarkdownRenderer::renderList
+
+
+/*!
+ * Render the inline elements of text: code spans, raw html, entities, links,
+ * emphasis and backslash escapes. Everything else is plain text.
+ * \param text is the markdown text
+ * \return the rendered text
+ */
+std::string MarkdownRenderer::renderInline(const std::string& text) const
+{
+    std::string output;
+
+    for(std::size_t i = 0; i < text.size(); i++)
+    {
+        char symbol = text.at(i);
+
+        if((symbol == '\\') && (i + 1 < text.size()) && std::ispunct((unsigned char)text.at(i + 1)))
+        {
+            // Backslash escape
+            output += escapeText(text.substr(i + 1, 1));
+            i++;
+        }
+        else if(symbol == '`')
+        {
+            // Code span, which can be opened with more than one backtick
+            std::size_t run = 1;
+            while((i + run < text.size()) && (text.at(i + run) == '`'))
+                run++;
+
+            std::size_t close = text.find(std::string(run, '`'), i + run);
+
+            if(close == std::string::npos)
+                output += std::string(run, '`');
+            else
+            {
+                output += formatCodeSpan(trimm(text.substr(i + run, close - i - run)));
+                i = close;
+            }
+
+            i += run - 1;
+        }
+        else if(symbol == '<')
+        {
+            // Raw html tags pass through, as do automatic links
+            std::size_t close = text.find('>', i);
+            char next = (i + 1 < text.size()) ? text.at(i + 1) : ' ';
+
+            if((close != std::string::npos) && (std::isalpha((unsigned char)next) || (next == '/') || (next == '!')))
+            {
+                std::string tag = text.substr(i, close - i + 1);
+                std::string url = tag.substr(1, tag.size() - 2);
+
+                if(contains(url, "://") && !contains(url, " "))
+                    output += formatLink(url, escapeText(url));
+                else
+                    output += formatInlineHtml(tag);
+
+                i = close;
+            }
+            else
+                output += escapeText("<");
+        }
+        else if(symbol == '&')
+        {
+            // Entities pass through, a lone ampersand is escaped
+            std::size_t end = i + 1;
+            while((end < text.size()) && (std::isalnum((unsigned char)text.at(end)) || (text.at(end) == '#')))
+                end++;
+
+            if((end < text.size()) && (end > i + 1) && (text.at(end) == ';'))
+            {
+                output += formatEntity(text.substr(i, end - i + 1));
+                i = end;
+            }
+            else
+                output += escapeText("&");
+        }
+        else if(symbol == '>')
+        {
+            output += escapeText(">");
+        }
+        else if(symbol == '[')
+        {
+            // Link, which is [text](url)
+            std::size_t close = std::string::npos;
+            int depth = 0;
+
+            for(std::size_t j = i + 1; j < text.size(); j++)
+            {
+                if(text.at(j) == '[')
+                    depth++;
+                else if((text.at(j) == ']') && (depth-- == 0))
+                {
+                    close = j;
+                    break;
+                }
+            }
+
+            std::size_t end = std::string::npos;
+            if((close != std::string::npos) && (close + 1 < text.size()) && (text.at(close + 1) == '('))
+                end = text.find(')', close + 2);
+
+            if(end == std::string::npos)
+                output += symbol;
+            else
+            {
+                std::string url = trimm(text.substr(close + 2, end - close - 2));
+                output += formatLink(url, renderInline(text.substr(i + 1, close - i - 1)));
+                i = end;
+            }
+        }
+        else if((symbol == '*') || (symbol == '_'))
+        {
+            // Emphasis, two delimiters for strong. Underscores only count at
+            // the boundaries of words, so identifiers are left alone.
+            std::size_t run = ((i + 1 < text.size()) && (text.at(i + 1) == symbol)) ? 2 : 1;
+            std::string delimiter(run, symbol);
+            std::size_t close = std::string::npos;
+
+            bool open = (i + run < text.size()) && !std::isspace((unsigned char)text.at(i + run));
+            if((symbol == '_') && (i > 0) && std::isalnum((unsigned char)text.at(i - 1)))
+                open = false;
+
+            for(std::size_t j = i + run + 1; open && (j + run <= text.size()); j++)
+            {
+                j = text.find(delimiter, j);
+                if(j == std::string::npos)
+                    break;
+
+                if(std::isspace((unsigned char)text.at(j - 1)))
+                    continue;
+
+                if((symbol == '_') && (j + run < text.size()) && std::isalnum((unsigned char)text.at(j + run)))
+                    continue;
+
+                close = j;
+                break;
+            }
+
+            if(close == std::string::npos)
+                output += formatText(delimiter);
+            else
+            {
+                output += formatEmphasis(renderInline(text.substr(i + run, close - i - run)), run == 2);
+                i = close;
+            }
+
+            i += run - 1;
+        }
+        else
+        {
+            // Plain text, up to the next character that could be markup
+            std::size_t end = text.find_first_of("\\`<&>[*_", i + 1);
+            if(end == std::string::npos)
+                end = text.size();
+
+            output += formatText(text.substr(i, end - i));
+            i = end - 1;
+        }
+
+    }// for all characters
+
+    return output;
+
+}// MarkdownRenderer::renderInline
+
+
+/*!
+ * Format a heading as html
+ * \param heading is the heading, which has been recorded for the table of contents
+ * \param text is the markdown text of the heading, including any anchor
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatHeading(const Heading& heading, const std::string& text) const
+{
+    int htmllevel = heading.level + baseHeaderLevel - 1;
+    if(htmllevel < 1)
+        htmllevel = 1;
+    else if(htmllevel > 6)
+        htmllevel = 6;
+
+    std::string tag = "h" + std::to_string(htmllevel);
+
+    return "<" + tag + " id=\"" + escape(headingIdentifier(heading.text)) + "\">" + renderInline(text) + "</" + tag + ">\n\n";
+}
+
+
+/*!
+ * Format a paragraph as html
+ * \param text is the rendered text of the paragraph
+ * \param tight should be true for a paragraph in a list without blank lines, which has no paragraph tag
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatParagraph(const std::string& text, bool tight) const
+{
+    if(tight)
+        return text + "\n";
+    else
+        return "<p>" + text + "</p>\n\n";
+}
+
+
+/*!
+ * Format a code block as html
+ * \param code is the literal text of the code block
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatCode(const std::string& code) const
+{
+    return "<pre><code>" + escape(code) + "</code></pre>\n\n";
+}
+
+
+/*!
+ * Format a horizontal rule as html
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatRule(void) const
+{
+    return "<hr />\n\n";
+}
+
+
+/*!
+ * Format a block of raw html, which is passed through
+ * \param html is the lines of the block
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatHtmlBlock(const std::string& html) const
+{
+    return html + "\n";
+}
+
+
+/*!
+ * Format a block quote as html
+ * \param contents are the rendered blocks of the quote
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatQuote(const std::string& contents) const
+{
+    return "<blockquote>\n" + contents + "</blockquote>\n\n";
+}
+
+
+/*!
+ * Format a list as html
+ * \param items are the rendered blocks of each item
+ * \param ordered should be true for a numbered list
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatList(const std::vector<std::string>& items, bool ordered) const
+{
+    std::string listtag = ordered ? "ol" : "ul";
+    std::string output = "<" + listtag + ">\n";
+
+    for(const std::string& item : items)
+        output += "<li>" + item + "</li>\n";
+
+    output += "</" + listtag + ">\n\n";
+
+    return output;
+}
+
+
+/*!
+ * Format a table as html
+ * \param caption is the rendered caption, which can be empty
+ * \param alignments gives the alignment of each column: 'l', 'c', 'r', or ' ' for the default
+ * \param rows are the rendered cells of each row, the first row is the header
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatTable(const std::string& caption, const std::vector<char>& alignments, const std::vector<std::vector<TableCell>>& rows) const
+{
+    std::string output = "<table>\n";
+
+    if(!caption.empty())
+        output += "<caption>" + caption + "</caption>\n";
+
+    for(std::size_t r = 0; r < rows.size(); r++)
+    {
+        std::string celltag = (r == 0) ? "th" : "td";
+
+        if(r == 0)
+            output += "<thead>\n";
+        else if(r == 1)
+            output += "<tbody>\n";
+
+        output += "<tr>\n";
+
+        for(const TableCell& cell : rows.at(r))
+        {
+            output += "\t<" + celltag;
+
+            char alignment = (cell.column < alignments.size()) ? alignments.at(cell.column) : ' ';
+            if(alignment == 'c')
+                output += " style=\"text-align:center;\"";
+            else if(alignment == 'r')
+                output += " style=\"text-align:right;\"";
+            else if(alignment == 'l')
+                output += " style=\"text-align:left;\"";
+
+            if(cell.span > 1)
+                output += " colspan=\"" + std::to_string(cell.span) + "\"";
+
+            output += ">" + cell.text + "</" + celltag + ">\n";
+        }
+
+        output += "</tr>\n";
+
+        if(r == 0)
+            output += "</thead>\n";
+    }
+
+    if(rows.size() > 1)
+        output += "</tbody>\n";
+
+    output += "</table>\n\n";
+
+    return output;
+
+}// MarkdownRenderer::formatTable
+
+
+/*!
+ * Format a code span as html
+ * \param code is the literal text of the code span
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatCodeSpan(const std::string& code) const
+{
+    return "<code>" + escape(code) + "</code>";
+}
+
+
+/*!
+ * Format a link as html
+ * \param url is the target of the link, which starts with '#' for a link in the document
+ * \param text is the rendered text of the link
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatLink(const std::string& url, const std::string& text) const
+{
+    return "<a href=\"" + escape(url) + "\">" + text + "</a>";
+}
+
+
+/*!
+ * Format emphasis as html
+ * \param text is the rendered text to emphasize
+ * \param strong should be true for strong emphasis
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatEmphasis(const std::string& text, bool strong) const
+{
+    std::string tag = strong ? "strong" : "em";
+    return "<" + tag + ">" + text + "</" + tag + ">";
+}
+
+
+/*!
+ * Format a raw html tag in text, which is passed through
+ * \param tag is the tag, including the angle brackets
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatInlineHtml(const std::string& tag) const
+{
+    return tag;
+}
+
+
+/*!
+ * Format an html entity, which is passed through
+ * \param entity is the entity, including the ampersand and semicolon
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatEntity(const std::string& entity) const
+{
+    return entity;
+}
+
+
+/*!
+ * Format plain text as html. The text cannot contain markup characters
+ * other than quotes, so it is passed through.
+ * \param text is the plain text
+ * \return the html text
+ */
+std::string MarkdownRenderer::formatText(const std::string& text) const
+{
+    return text;
+}
+
+
+/*!
+ * Escape text so it appears literally in the output, which for html is escape()
+ * \param text is the text to escape
+ * \return the escaped text
+ */
+std::string MarkdownRenderer::escapeText(const std::string& text) const
+{
+    return escape(text);
+}
+
+
+/*!
+ * Escape text so it appears literally in html
+ * \param text is the text to escape
+ * \return the escaped text
+ */
+std::string MarkdownRenderer::escape(const std::string& text)
+{
+    std::string output;
+
+    for(char symbol : text)
+    {
+        switch(symbol)
+        {
+        case '&': output += "&amp;"; break;
+        case '<': output += "&lt;"; break;
+        case '>': output += "&gt;"; break;
+        case '"': output += "&quot;"; break;
+        default: output += symbol; break;
+        }
+    }
+
+    return output;
+}
+
+
+/*!
+ * Split a table row into its cells. The cells are not trimmed, so that an
+ * empty cell (which spans) can be told apart from a blank cell. Pipes inside
+ * code spans or escaped with a backslash do not split cells.
+ * \param row is the table row
+ * \return the list of cells
+ */
+std::vector<std::string> MarkdownRenderer::splitRow(const std::string& row)
+{
+    std::vector<std::string> cells;
+    std::string text = trimm(row);
+    bool code = false;
+
+    if(startsWith(text, "|"))
+        text.erase(0, 1);
+
+    cells.push_back(std::string());
+
+    for(std::size_t i = 0; i < text.size(); i++)
+    {
+        char symbol = text.at(i);
+
+        if((symbol == '\\') && (i + 1 < text.size()) && (text.at(i + 1) == '|'))
+        {
+            cells.back() += "\\|";
+            i++;
+        }
+        else if((symbol == '|') && !code)
+            cells.push_back(std::string());
+        else
+        {
+            if(symbol == '`')
+                code = !code;
+
+            cells.back() += symbol;
+        }
+    }
+
+    // The closing pipe does not start a cell
+    if(endsWith(text, "|") && cells.back().empty())
+        cells.pop_back();
+
+    return cells;
+
+}// MarkdownRenderer::splitRow
+
+
+/*!
+ * Determine if a line is a table separator row, which is made of dashes and
+ * optional colons in each cell
+ * \param line is the line to test
+ * \return true if the line is a table separator row
+ */
+bool MarkdownRenderer::isTableSeparator(const std::string& line)
+{
+    if(!contains(line, "-") || !contains(line, "|"))
+        return false;
+
+    for(char symbol : line)
+    {
+        if((symbol != '|') && (symbol != '-') && (symbol != ':') && (symbol != ' ') && (symbol != '\t'))
+            return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * Determine if a line is a horizontal rule, which is three or more dashes,
+ * asterisks or underscores, optionally separated by spaces
+ * \param line is the line to test
+ * \return true if the line is a horizontal rule
+ */
+bool MarkdownRenderer::isRule(const std::string& line)
+{
+    std::string text = trimm(line);
+
+    if(text.empty() || (indentation(line) >= 4) || ((text.front() != '-') && (text.front() != '*') && (text.front() != '_')))
+        return false;
+
+    int count = 0;
+    for(char symbol : text)
+    {
+        if(symbol == text.front())
+            count++;
+        else if(symbol != ' ')
+            return false;
+    }
+
+    return (count >= 3);
+}
+
+
+/*!
+ * Determine if a line starts a list item
+ * \param line is the line to test
+ * \param ordered is set to true if the item is numbered
+ * \return the number of characters before the text of the item, or zero if this is not a list item
+ */
+std::size_t MarkdownRenderer::listMarker(const std::string& line, bool& ordered)
+{
+    std::size_t i = 0;
+    while((i < line.size()) && ((line.at(i) == ' ') || (line.at(i) == '\t')))
+        i++;
+
+    if(i >= line.size())
+        return 0;
+
+    if((line.at(i) == '-') || (line.at(i) == '*') || (line.at(i) == '+'))
+    {
+        ordered = false;
+        i++;
+    }
+    else if(std::isdigit((unsigned char)line.at(i)))
+    {
+        while((i < line.size()) && std::isdigit((unsigned char)line.at(i)))
+            i++;
+
+        if((i >= line.size()) || (line.at(i) != '.'))
+            return 0;
+
+        ordered = true;
+        i++;
+    }
+    else
+        return 0;
+
+    // The marker must be followed by white space
+    if((i >= line.size()) || ((line.at(i) != ' ') && (line.at(i) != '\t')))
+        return 0;
+
+    while((i < line.size()) && ((line.at(i) == ' ') || (line.at(i) == '\t')))
+        i++;
+
+    return i;
+
+}// MarkdownRenderer::listMarker
+
+
+/*!
+ * Determine if a line starts a block of raw html. Lines that start with an
+ * inline tag (like an anchor) are part of a paragraph instead.
+ * \param line is the trimmed line to test
+ * \param tag receives the lower case name of the tag
+ * \return true if the line starts a block of raw html
+ */
+bool MarkdownRenderer::isHtmlBlock(const std::string& line, std::string& tag)
+{
+    static const std::vector<std::string> inlinetags = {"a", "abbr", "b", "big", "br", "cite", "code", "em", "font", "i", "img", "kbd", "q", "s", "small", "span", "strike", "strong", "sub", "sup", "tt", "u", "var"};
+
+    tag.clear();
+
+    if(!startsWith(line, "<"))
+        return false;
+
+    if(startsWith(line, "<!--"))
+    {
+        tag = "!--";
+        return true;
+    }
+
+    std::size_t i = 1;
+    if((i < line.size()) && (line.at(i) == '/'))
+        i++;
+
+    while((i < line.size()) && std::isalnum((unsigned char)line.at(i)))
+        tag += (char)std::tolower((unsigned char)line.at(i++));
+
+    if(tag.empty() || !std::isalpha((unsigned char)tag.front()))
+        return false;
+
+    for(const std::string& inlinetag : inlinetags)
+    {
+        if(tag == inlinetag)
+            return false;
+    }
+
+    return true;
+
+}// MarkdownRenderer::isHtmlBlock
+
+
+/*!
+ * Return the number of leading spaces, counting tabs as four spaces
+ * \param line is the line to measure
+ * \return the indentation of the line
+ */
+std::size_t MarkdownRenderer::indentation(const std::string& line)
+{
+    std::size_t count = 0;
+
+    for(char symbol : line)
+    {
+        if(symbol == ' ')
+            count++;
+        else if(symbol == '\t')
+            count += 4;
+        else
+            break;
+    }
+
+    return count;
+}
+
+
+/*!
+ * Remove up to a number of leading spaces, counting tabs as four spaces
+ * \param line is the line to dedent
+ * \param count is the number of spaces to remove
+ * \return the dedented line
+ */
+std::string MarkdownRenderer::dedent(const std::string& line, std::size_t count)
+{
+    std::size_t removed = 0, i = 0;
+
+    for(; (i < line.size()) && (removed < count); i++)
+    {
+        if(line.at(i) == ' ')
+            removed++;
+        else if(line.at(i) == '\t')
+            removed += 4;
+        else
+            break;
+    }
+
+    return line.substr(i);
+}
@@ -0,0 +1,164 @@
+#ifndef MARKDOWNRENDERER_H
+#define MARKDOWNRENDERER_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+/*!
+ * The MarkdownRenderer converts the markdown that ProtoGen writes into html,
+ * without needing an external markdown processor. It understands the subset
+ * of MultiMarkdown that the documentation uses: metadata, headings, tables
+ * (with alignment, captions and column spans), lists, block quotes, code
+ * blocks, horizontal rules, raw html blocks, and the inline elements for
+ * emphasis, code, links and line breaks. As headings are rendered they are
+ * recorded, so the table of contents comes out of the rendering rather than
+ * from another pass over the markdown.
+ *
+ * The html is rendered from markdown, rather than from the protocol objects,
+ * because much of the documentation is markdown written by the user: the
+ * comments of every element, Documentation tags, and whole documentation
+ * files. Those have to be rendered whichever way the tables are produced, and
+ * rendering everything through one path keeps the markdown and html outputs
+ * the same document. The output of each element is formatted by a virtual
+ * function, so LatexRenderer reuses the parsing to produce LaTeX.
+ */
+class MarkdownRenderer
+{
+public:
+
+    //! Construct an empty renderer
+    MarkdownRenderer(void);
+
+    //! Destroy the renderer
+    virtual ~MarkdownRenderer(void) {}
+
+    //! Render markdown, recording the headings for the table of contents
+    void render(const std::string& markdown, std::ostream& out, bool metadata);
+
+    //! Get the start of a complete document, which goes before the output of render()
+    virtual std::string documentStart(void) const;
+
+    //! Get the end of a complete document, which goes after the output of render()
+    virtual std::string documentEnd(void) const;
+
+    //! Return the table of contents of all the headings rendered so far, as markdown
+    std::string getTableOfContents(void) const;
+
+    //! Return the identifier used for a heading, which is the target of links to the heading
+    static std::string headingIdentifier(const std::string& text);
+
+protected:
+
+    //! Information about a heading, used to create the table of contents
+    class Heading
+    {
+    public:
+        int level;              //!< Level of the heading, 1 for the top level
+        std::string reference;  //!< Name of the anchor that links to the heading
+        std::string text;       //!< Markdown text of the heading
+    };
+
+    //! A rendered cell of a table
+    class TableCell
+    {
+    public:
+        std::string text;       //!< Rendered text of the cell
+        std::size_t column;     //!< Column the cell starts in
+        int span;               //!< Number of columns the cell covers
+    };
+
+    //! Parse metadata lines from the start of the markdown
+    std::size_t parseMetadata(const std::vector<std::string>& lines);
+
+    //! Render a list of lines as blocks
+    std::string renderBlocks(const std::vector<std::string>& lines, bool tight);
+
+    //! Render a heading line
+    std::string renderHeading(const std::string& line);
+
+    //! Render a table
+    std::string renderTable(const std::vector<std::string>& rows, const std::string& caption) const;
+
+    //! Render a list
+    std::string renderList(const std::vector<std::string>& lines, bool ordered);
+
+    //! Render the inline elements of text
+    std::string renderInline(const std::string& text) const;
+
+    //! Format a heading
+    virtual std::string formatHeading(const Heading& heading, const std::string& text) const;
+
+    //! Format a paragraph
+    virtual std::string formatParagraph(const std::string& text, bool tight) const;
+
+    //! Format a code block
+    virtual std::string formatCode(const std::string& code) const;
+
+    //! Format a horizontal rule
+    virtual std::string formatRule(void) const;
+
+    //! Format a block of raw html
+    virtual std::string formatHtmlBlock(const std::string& html) const;
+
+    //! Format a block quote
+    virtual std::string formatQuote(const std::string& contents) const;
+
+    //! Format a list
+    virtual std::string formatList(const std::vector<std::string>& items, bool ordered) const;
+
+    //! Format a table
+    virtual std::string formatTable(const std::string& caption, const std::vector<char>& alignments, const std::vector<std::vector<TableCell>>& rows) const;
+
+    //! Format a code span
+    virtual std::string formatCodeSpan(const std::string& code) const;
+
+    //! Format a link
+    virtual std::string formatLink(const std::string& url, const std::string& text) const;
+
+    //! Format emphasis
+    virtual std::string formatEmphasis(const std::string& text, bool strong) const;
+
+    //! Format a raw html tag in text
+    virtual std::string formatInlineHtml(const std::string& tag) const;
+
+    //! Format an html entity
+    virtual std::string formatEntity(const std::string& entity) const;
+
+    //! Format plain text
+    virtual std::string formatText(const std::string& text) const;
+
+    //! Escape text so it appears literally in the output
+    virtual std::string escapeText(const std::string& text) const;
+
+    //! Escape text so it appears literally in html
+    static std::string escape(const std::string& text);
+
+    //! Split a table row into its cells
+    static std::vector<std::string> splitRow(const std::string& row);
+
+    //! Determine if a line is a table separator row
+    static bool isTableSeparator(const std::string& line);
+
+    //! Determine if a line is a horizontal rule
+    static bool isRule(const std::string& line);
+
+    //! Determine if a line starts a list item, and if so the length of the marker
+    static std::size_t listMarker(const std::string& line, bool& ordered);
+
+    //! Determine if a line starts a block of raw html
+    static bool isHtmlBlock(const std::string& line, std::string& tag);
+
+    //! Return the number of leading spaces, counting tabs as four spaces
+    static std::size_t indentation(const std::string& line);
+
+    //! Remove up to a number of leading spaces
+    static std::string dedent(const std::string& line, std::size_t count);
+
+    std::string title;              //!< Title from the metadata, used for the html document
+    int baseHeaderLevel;            //!< Level of the top headings from the metadata
+    int latexHeaderLevel;           //!< Level of the top LaTeX headings from the metadata
+    std::vector<Heading> headings;  //!< Headings in the order they were rendered
+};
+
+#endif // MARKDOWNRENDERER_H
@@ -0,0 +1,224 @@
+#include "modulecache.h"
+#include <algorithm>
+#include <filesystem>
+
+/*!
+ * Construct an empty cache, the first generation generates every module
+ */
+ModuleCache::ModuleCache(void) :
+    everything(true),
+    invalid(false),
+    generatedcount(0)
+{
+}
+
+
+/*!
+ * Forget the last generation, so the next generation generates every module.
+ * Modules which were found to share a file with output that is not from a
+ * module are remembered.
+ */
+void ModuleCache::clear(void)
+{
+    lasthashes.clear();
+    nexthashes.clear();
+    lastoptions.clear();
+    nextoptions.clear();
+    last.clear();
+    next.clear();
+    affectedfiles.clear();
+    affectedmodules.clear();
+    everything = true;
+}
+
+
+/*!
+ * Start a generation. The files which changed since the last generation are
+ * found by their hash, and then the files which Require them, and then the
+ * modules in those files, and the modules which share output files with them.
+ * \param hashes is the hash of each xml file parsed by this generation, by absolute file name
+ * \param requiredfiles gives the files that each xml file Requires, by absolute file name
+ * \param options are the protocol options of the main file, if these change every module is affected
+ */
+void ModuleCache::begin(const std::map<std::string, uint64_t>& hashes, const std::map<std::string, std::vector<std::string>>& requiredfiles, const std::string& options)
+{
+    nexthashes = hashes;
+    nextoptions = options;
+    next.clear();
+    affectedfiles.clear();
+    affectedmodules.clear();
+    invalid = false;
+    generatedcount = 0;
+
+    everything = last.empty() || (options != lastoptions);
+
+    if(everything)
+        return;
+
+    // The files that changed, or are new
+    std::vector<std::string> changed;
+    for(const auto& entry : hashes)
+    {
+        auto it = lasthashes.find(entry.first);
+        if((it == lasthashes.end()) || (it->second != entry.second))
+            changed.push_back(entry.first);
+    }
+
+    // Which files Require each file
+    std::map<std::string, std::vector<std::string>> requiredby;
+    for(const auto& entry : requiredfiles)
+    {
+        for(const std::string& required : entry.second)
+            requiredby[required].push_back(entry.first);
+    }
+
+    // The changed files, and every file that depends on them through Require
+    while(!changed.empty())
+    {
+        std::string file = changed.back();
+        changed.pop_back();
+
+        if(!affectedfiles.insert(file).second)
+            continue;
+
+        auto it = requiredby.find(file);
+        if(it != requiredby.end())
+            changed.insert(changed.end(), it->second.begin(), it->second.end());
+    }
+
+    // Which modules write each output file
+    std::map<std::string, std::vector<std::string>> writers;
+    for(const auto& entry : last)
+    {
+        for(const std::string& output : entry.second.outputs)
+            writers[output].push_back(entry.first);
+    }
+
+    // The modules in the affected files, and any whose output files are gone
+    std::vector<std::string> modules;
+    for(const auto& entry : last)
+    {
+        bool affected = (affectedfiles.count(entry.second.file) > 0) || (pinned.count(entry.first) > 0);
+
+        for(std::size_t i = 0; !affected && (i < entry.second.outputs.size()); i++)
+            affected = !std::filesystem::exists(entry.second.outputs.at(i));
+
+        if(affected)
+            modules.push_back(entry.first);
+    }
+
+    // And the modules which share an output file with an affected module
+    while(!modules.empty())
+    {
+        std::string module = modules.back();
+        modules.pop_back();
+
+        if(!affectedmodules.insert(module).second)
+            continue;
+
+        for(const std::string& output : last[module].outputs)
+        {
+            const std::vector<std::string>& list = writers[output];
+            modules.insert(modules.end(), list.begin(), list.end());
+        }
+    }
+
+}// ModuleCache::begin
+
+
+/*!
+ * Determine if a module must be generated, or if its output from the last
+ * generation is unchanged. Modules which were not in the last generation, or
+ * were in a different file, must be generated.
+ * \param module is the hierarchical name of the module
+ * \param file is the absolute name of the xml file the module is defined in
+ * \return true if the module must be generated
+ */
+bool ModuleCache::isAffected(const std::string& module, const std::string& file) const
+{
+    // Files which could not be hashed, like the bitfield tester, are always affected
+    if(everything || (affectedmodules.count(module) > 0) || (nexthashes.count(file) == 0))
+        return true;
+
+    auto it = last.find(module);
+
+    return (it == last.end()) || (it->second.file != file);
+}
+
+
+/*!
+ * Record the source and output files of a module in this generation
+ * \param module is the hierarchical name of the module
+ * \param file is the absolute name of the xml file the module is defined in
+ * \param outputs are the files the module writes, including the path
+ * \param generated should be true if the module was generated, false if its output was unchanged
+ */
+void ModuleCache::addModule(const std::string& module, const std::string& file, const std::vector<std::string>& outputs, bool generated)
+{
+    Module& entry = next[module];
+
+    entry.file = file;
+    entry.generated = generated;
+
+    for(const std::string& output : outputs)
+    {
+        if(output.empty())
+            continue;
+
+        std::string name = std::filesystem::path(output).lexically_normal().string();
+
+        if(std::find(entry.outputs.begin(), entry.outputs.end(), name) == entry.outputs.end())
+            entry.outputs.push_back(name);
+    }
+
+    if(generated)
+        generatedcount++;
+}
+
+
+/*!
+ * Get the output files of the modules which were not generated in this
+ * generation. If any of these files were written by this generation the
+ * contents of the unchanged module are lost, and the generation is invalid.
+ * \return the list of files, and the module that each one belongs to
+ */
+std::vector<std::pair<std::string, std::string>> ModuleCache::getUnchangedOutputs(void) const
+{
+    std::vector<std::pair<std::string, std::string>> list;
+
+    for(const auto& entry : next)
+    {
+        if(entry.second.generated)
+            continue;
+
+        for(const std::string& output : entry.second.outputs)
+            list.emplace_back(output, entry.first);
+    }
+
+    return list;
+}
+
+
+/*!
+ * Finish a generation, which becomes the last generation for the next one
+ */
+void ModuleCache::finish(void)
+{
+    lasthashes = nexthashes;
+    lastoptions = nextoptions;
+    last = next;
+}
+
+
+/*!
+ * Forget this generation and the last one, because a module which was not
+ * generated shares a file that was written by something else. That module is
+ * always generated from now on.
+ * \param module is the hierarchical name of the module which was not generated
+ */
+void ModuleCache::invalidate(const std::string& module)
+{
+    pinned.insert(module);
+    clear();
+    invalid = true;
+}
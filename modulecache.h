@@ -0,0 +1,107 @@
+#ifndef MODULECACHE_H
+#define MODULECACHE_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <utility>
+
+/*!
+ * The ModuleCache remembers what the last generation of a protocol parsed and
+ * wrote, so that watch mode only generates the modules which are affected by
+ * a change. A module is affected if its xml file changed, or if a file it
+ * Requires (directly or through other files) changed. Every module is
+ * affected if the protocol options of the main file changed. Modules which
+ * share an output file with an affected module are affected as well, because
+ * a file is always written whole. Modules which are not affected are still
+ * parsed, since other modules refer to them, but their output files are not
+ * generated again, and stay as they are on disk.
+ */
+class ModuleCache
+{
+public:
+
+    //! Construct an empty cache, the first generation generates every module
+    ModuleCache(void);
+
+    //! Forget the last generation, so the next generation generates every module
+    void clear(void);
+
+    //! Start a generation, and find the modules which are affected by the files that changed
+    void begin(const std::map<std::string, uint64_t>& hashes, const std::map<std::string, std::vector<std::string>>& requiredfiles, const std::string& options);
+
+    //! Determine if a module must be generated, or if its output from the last generation is unchanged
+    bool isAffected(const std::string& module, const std::string& file) const;
+
+    //! Record the source and output files of a module in this generation
+    void addModule(const std::string& module, const std::string& file, const std::vector<std::string>& outputs, bool generated);
+
+    //! Get the output files of the modules which were not generated in this generation, with their modules
+    std::vector<std::pair<std::string, std::string>> getUnchangedOutputs(void) const;
+
+    //! Finish a generation, which becomes the last generation for the next one
+    void finish(void);
+
+    //! Forget this generation, because an unchanged module shares a file that was written
+    void invalidate(const std::string& module);
+
+    //! True if the generation was invalidated, and must be run again in full
+    bool isInvalid(void) const {return invalid;}
+
+    //! Return the number of modules which were generated in this generation
+    std::size_t getGeneratedCount(void) const {return generatedcount;}
+
+    //! Return the number of modules in this generation
+    std::size_t getModuleCount(void) const {return next.size();}
+
+protected:
+
+    //! What the cache knows about one module
+    class Module
+    {
+    public:
+        std::string file;                   //!< The xml file the module is defined in
+        std::vector<std::string> outputs;   //!< The files the module writes
+        bool generated;                     //!< True if the module was generated, rather than left unchanged
+    };
+
+    //! The hash of each xml file, from the last generation
+    std::map<std::string, uint64_t> lasthashes;
+
+    //! The hash of each xml file, from this generation
+    std::map<std::string, uint64_t> nexthashes;
+
+    //! The protocol options of the main file, from the last generation
+    std::string lastoptions;
+
+    //! The protocol options of the main file, from this generation
+    std::string nextoptions;
+
+    //! The modules from the last generation, by hierarchical name
+    std::map<std::string, Module> last;
+
+    //! The modules from this generation, by hierarchical name
+    std::map<std::string, Module> next;
+
+    //! The xml files which changed, or which Require a file that changed
+    std::set<std::string> affectedfiles;
+
+    //! The modules from the last generation which must be generated
+    std::set<std::string> affectedmodules;
+
+    //! Modules which share a file with output that is not from a module, and are always generated
+    std::set<std::string> pinned;
+
+    //! True if every module must be generated
+    bool everything;
+
+    //! True if this generation was invalidated
+    bool invalid;
+
+    //! The number of modules generated in this generation
+    std::size_t generatedcount;
+};
+
+#endif // MODULECACHE_H
@@ -0,0 +1,462 @@
+#include "precompiledlibrary.h"
+#include "protocolsupport.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+//! Identifies a precompiled library file, change the number if the format changes
+static const std::string libraryMagic = "ProtoGen precompiled library 4";
+
+/*!
+ * Write a string, as its length and then its bytes
+ * \param text is the string to write
+ */
+void CacheWriter::write(const std::string& text)
+{
+    writeVarint(text.size());
+    buffer += text;
+}
+
+
+/*!
+ * Write a signed integer, small magnitudes take fewer bytes
+ * \param value is the integer to write
+ */
+void CacheWriter::write(int64_t value)
+{
+    // Zig-zag encoding so small negative numbers are also small
+    writeVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+
+/*!
+ * Write a boolean as a single byte
+ * \param value is the boolean to write
+ */
+void CacheWriter::write(bool value)
+{
+    buffer += value ? '\1' : '\0';
+}
+
+
+/*!
+ * Write a double precision number, as its bit pattern so it is read back exactly
+ * \param value is the number to write
+ */
+void CacheWriter::write(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeVarint(bits);
+}
+
+
+/*!
+ * Write an unsigned integer using 7 bits per byte, least significant first.
+ * The most significant bit of each byte is set if more bytes follow.
+ * \param value is the integer to write
+ */
+void CacheWriter::writeVarint(uint64_t value)
+{
+    while(value >= 0x80)
+    {
+        buffer += (char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+
+    buffer += (char)value;
+}
+
+
+/*!
+ * Construct a reader for a buffer
+ * \param data is the buffer to read, which must outlive the reader
+ */
+CacheReader::CacheReader(const std::string& data) :
+    buffer(data),
+    position(0),
+    good(true)
+{
+}
+
+
+/*!
+ * Read a string written by CacheWriter::write()
+ * \return the string, which is empty if the read failed
+ */
+std::string CacheReader::readString(void)
+{
+    uint64_t length = readVarint();
+
+    if(!good || (length > buffer.size() - position))
+    {
+        good = false;
+        return std::string();
+    }
+
+    std::string text = buffer.substr(position, length);
+    position += length;
+
+    return text;
+}
+
+
+/*!
+ * Read a signed integer written by CacheWriter::write()
+ * \return the integer, which is zero if the read failed
+ */
+int64_t CacheReader::readInt(void)
+{
+    uint64_t value = readVarint();
+
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+
+/*!
+ * Read a boolean written by CacheWriter::write()
+ * \return the boolean, which is false if the read failed
+ */
+bool CacheReader::readBool(void)
+{
+    if(position >= buffer.size())
+    {
+        good = false;
+        return false;
+    }
+
+    return (buffer.at(position++) != '\0');
+}
+
+
+/*!
+ * Read a double precision number written by CacheWriter::write()
+ * \return the number, which is zero if the read failed
+ */
+double CacheReader::readDouble(void)
+{
+    uint64_t bits = readVarint();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+
+/*!
+ * Read an unsigned integer written by CacheWriter::writeVarint()
+ * \return the integer, which is zero if the read failed
+ */
+uint64_t CacheReader::readVarint(void)
+{
+    uint64_t value = 0;
+
+    for(int shift = 0; shift < 64; shift += 7)
+    {
+        if(position >= buffer.size())
+            break;
+
+        uint8_t byte = (uint8_t)buffer.at(position++);
+
+        value |= (uint64_t)(byte & 0x7F) << shift;
+
+        if((byte & 0x80) == 0)
+            return value;
+    }
+
+    good = false;
+    return 0;
+
+}// CacheReader::readVarint
+
+
+/*!
+ * Start recording everything written to std::cout and std::cerr
+ * \param list receives the output, in the order it is written
+ */
+OutputRecorder::OutputRecorder(Output& list) :
+    out(std::cout.rdbuf(), false, list),
+    err(std::cerr.rdbuf(), true, list)
+{
+    std::cout.rdbuf(&out);
+    std::cerr.rdbuf(&err);
+}
+
+
+/*!
+ * Stop recording, and give the streams back their own buffers
+ */
+OutputRecorder::~OutputRecorder(void)
+{
+    std::cout.rdbuf(out.getTarget());
+    std::cerr.rdbuf(err.getTarget());
+}
+
+
+/*!
+ * Write recorded output to std::cout and std::cerr again, in the same order
+ * \param list is the output from an OutputRecorder
+ */
+void OutputRecorder::replay(const Output& list)
+{
+    for(const auto& text : list)
+    {
+        if(text.first)
+            std::cerr << text.second << std::flush;
+        else
+            std::cout << text.second << std::flush;
+    }
+}
+
+
+/*!
+ * Construct a buffer that passes text to another buffer, and records it
+ * \param buffer is the buffer which receives the text
+ * \param error should be true if buffer is the buffer of std::cerr
+ * \param list receives a copy of the text
+ */
+OutputRecorder::Tee::Tee(std::streambuf* buffer, bool error, Output& list) :
+    target(buffer),
+    iserror(error),
+    output(list)
+{
+}
+
+
+/*!
+ * Write one character, this buffer has no storage so every character comes here
+ * \param c is the character to write
+ * \return c, or EOF if it could not be written
+ */
+int OutputRecorder::Tee::overflow(int c)
+{
+    if(traits_type::eq_int_type(c, traits_type::eof()))
+        return traits_type::not_eof(c);
+
+    char symbol = traits_type::to_char_type(c);
+
+    return (xsputn(&symbol, 1) == 1) ? c : traits_type::eof();
+}
+
+
+/*!
+ * Write a block of characters. Text that follows text on the same stream is
+ * added to the same entry, so the output is a list of alternating streams.
+ * \param text is the characters to write
+ * \param count is the number of characters
+ * \return the number of characters written
+ */
+std::streamsize OutputRecorder::Tee::xsputn(const char* text, std::streamsize count)
+{
+    if(!output.empty() && (output.back().first == iserror))
+        output.back().second.append(text, count);
+    else
+        output.emplace_back(iserror, std::string(text, count));
+
+    return target->sputn(text, count);
+}
+
+
+/*!
+ * Flush the buffer which receives the text
+ * \return 0 on success, -1 on failure
+ */
+int OutputRecorder::Tee::sync(void)
+{
+    return target->pubsync();
+}
+
+
+/*!
+ * Construct an empty library for an xml file
+ * \param xmlFileName is the name of the xml file
+ * \param xmlHash is the hash of the contents of the xml file
+ * \param libraryOptions are the version and protocol options that affect how the file is parsed
+ */
+PrecompiledLibrary::PrecompiledLibrary(const std::string& xmlFileName, uint64_t xmlHash, const std::string& libraryOptions) :
+    xmlfile(xmlFileName),
+    hash(xmlHash),
+    options(libraryOptions)
+{
+}
+
+
+/*!
+ * Load the library file. The library is only loaded if it was written from
+ * the same xml contents, with the same version and protocol options.
+ * \return true if the library was loaded, else the library is empty
+ */
+bool PrecompiledLibrary::load(void)
+{
+    entries.clear();
+
+    std::ifstream file(libraryFileName(xmlfile), std::ios_base::in | std::ios_base::binary);
+
+    if(!file.is_open())
+        return false;
+
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // The header must match exactly, this covers all the reasons the library could be out of date
+    CacheWriter header;
+    writeHeader(header);
+
+    if(contents.compare(0, header.data().size(), header.data()) != 0)
+        return false;
+
+    // The body follows its own hash, so a damaged file is not used
+    std::string rest = contents.substr(header.data().size());
+    CacheReader framing(rest);
+    uint64_t bodyhash = (uint64_t)framing.readInt();
+    std::string body = framing.readString();
+
+    if(!framing.isGood() || (hashData(body) != bodyhash))
+        return false;
+
+    CacheReader reader(body);
+
+    for(int64_t count = reader.readInt(); (count > 0) && reader.isGood(); count--)
+    {
+        Entry& entry = entries[(int)reader.readInt()];
+
+        for(int64_t number = reader.readInt(); (number > 0) && reader.isGood(); number--)
+        {
+            int kind = (int)reader.readInt();
+            std::string argument = reader.readString();
+            entry.dependencies.emplace_back(kind, argument, reader.readString());
+        }
+
+        for(int64_t number = reader.readInt(); (number > 0) && reader.isGood(); number--)
+        {
+            bool error = reader.readBool();
+            entry.output.emplace_back(error, reader.readString());
+        }
+
+        entry.model = reader.readString();
+    }
+
+    if(!reader.isGood())
+    {
+        entries.clear();
+        return false;
+    }
+
+    return true;
+
+}// PrecompiledLibrary::load
+
+
+/*!
+ * Save the library file, next to the xml file
+ * \return true if the library was written
+ */
+bool PrecompiledLibrary::save(void) const
+{
+    CacheWriter writer;
+
+    writer.write((int64_t)entries.size());
+    for(const auto& element : entries)
+    {
+        const Entry& entry = element.second;
+
+        writer.write((int64_t)element.first);
+
+        writer.write((int64_t)entry.dependencies.size());
+        for(const Dependency& dependency : entry.dependencies)
+        {
+            writer.write((int64_t)dependency.kind);
+            writer.write(dependency.argument);
+            writer.write(dependency.result);
+        }
+
+        writer.write((int64_t)entry.output.size());
+        for(const auto& text : entry.output)
+        {
+            writer.write(text.first);
+            writer.write(text.second);
+        }
+
+        writer.write(entry.model);
+    }
+
+    // The header, and then the body with its hash
+    CacheWriter library;
+    writeHeader(library);
+    library.write((int64_t)hashData(writer.data()));
+    library.write(writer.data());
+
+    std::ofstream file(libraryFileName(xmlfile), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+
+    if(!file.is_open())
+        return false;
+
+    file << library.data();
+
+    return file.good();
+
+}// PrecompiledLibrary::save
+
+
+/*!
+ * Return the entry of the object from an element of the xml file
+ * \param element is the index of the element amongst the top level elements of the xml file
+ * \return the entry, or null if there is none
+ */
+const PrecompiledLibrary::Entry* PrecompiledLibrary::getEntry(int element) const
+{
+    std::map<int, Entry>::const_iterator it = entries.find(element);
+
+    if(it == entries.end())
+        return nullptr;
+    else
+        return &it->second;
+}
+
+
+/*!
+ * Return the name of the library file for an xml file, which is the xml file
+ * name with the extension changed to ".pgc"
+ * \param xmlFileName is the name of the xml file
+ * \return the name of the library file
+ */
+std::string PrecompiledLibrary::libraryFileName(const std::string& xmlFileName)
+{
+    std::string fileName = xmlFileName;
+
+    if(endsWith(fileName, ".xml"))
+        fileName.erase(fileName.size() - 4);
+
+    return fileName + ".pgc";
+}
+
+
+/*!
+ * Compute the 64-bit FNV-1a hash of data
+ * \param data is the data to hash
+ * \return the hash of the data
+ */
+uint64_t PrecompiledLibrary::hashData(const std::string& data)
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    for(char byte : data)
+    {
+        hash ^= (uint8_t)byte;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+
+/*!
+ * Write the header which identifies the source of the library
+ * \param writer receives the header
+ */
+void PrecompiledLibrary::writeHeader(CacheWriter& writer) const
+{
+    writer.write(libraryMagic);
+    writer.write((int64_t)hash);
+    writer.write(options);
+}
@@ -0,0 +1,210 @@
+#ifndef PRECOMPILEDLIBRARY_H
+#define PRECOMPILEDLIBRARY_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <utility>
+#include <streambuf>
+#include <cstdint>
+
+//! Writes values to a compact binary buffer
+class CacheWriter
+{
+public:
+
+    //! Write a string, as its length and then its bytes
+    void write(const std::string& text);
+
+    //! Write a signed integer
+    void write(int64_t value);
+
+    //! Write a boolean
+    void write(bool value);
+
+    //! Write a double precision number
+    void write(double value);
+
+    //! Return the data written so far
+    const std::string& data(void) const {return buffer;}
+
+protected:
+
+    //! Write an unsigned integer using 7 bits per byte
+    void writeVarint(uint64_t value);
+
+    std::string buffer; //!< The data written so far
+};
+
+
+//! Reads values from a buffer written by CacheWriter
+class CacheReader
+{
+public:
+
+    //! Construct a reader for a buffer, the buffer must outlive the reader
+    CacheReader(const std::string& data);
+
+    //! Read a string
+    std::string readString(void);
+
+    //! Read a signed integer
+    int64_t readInt(void);
+
+    //! Read a boolean
+    bool readBool(void);
+
+    //! Read a double precision number
+    double readDouble(void);
+
+    //! Mark the data as bad, because something read does not make sense
+    void fail(void) {good = false;}
+
+    //! Return true if every read so far was within the buffer and made sense
+    bool isGood(void) const {return good;}
+
+protected:
+
+    //! Read an unsigned integer using 7 bits per byte
+    uint64_t readVarint(void);
+
+    const std::string& buffer;  //!< The data being read
+    std::size_t position;       //!< Location of the next read
+    bool good;                  //!< Set false if a read went past the end
+};
+
+
+/*!
+ * An OutputRecorder keeps a copy of everything written to std::cout and
+ * std::cerr while it exists, in the order it was written. The text is still
+ * written to the streams as usual. This is how the warnings and notes of a
+ * parse are kept, so they can be printed again when the parse is skipped.
+ */
+class OutputRecorder
+{
+public:
+
+    //! Text written to one of the streams, true for std::cerr
+    typedef std::vector<std::pair<bool, std::string>> Output;
+
+    //! Start recording the output
+    OutputRecorder(Output& list);
+
+    //! Stop recording the output
+    ~OutputRecorder(void);
+
+    OutputRecorder(const OutputRecorder&) = delete;
+    OutputRecorder& operator=(const OutputRecorder&) = delete;
+
+    //! Write recorded output to std::cout and std::cerr again
+    static void replay(const Output& list);
+
+private:
+
+    //! A stream buffer that passes text to another buffer, and records it
+    class Tee : public std::streambuf
+    {
+    public:
+        Tee(std::streambuf* buffer, bool error, Output& list);
+
+        //! Return the buffer of the stream
+        std::streambuf* getTarget(void) const {return target;}
+
+    protected:
+        int overflow(int c) override;
+        std::streamsize xsputn(const char* text, std::streamsize count) override;
+        int sync(void) override;
+
+    private:
+        std::streambuf* target; //!< The buffer of the stream
+        bool iserror;           //!< True if this is the buffer of std::cerr
+        Output& output;         //!< Receives the text
+    };
+
+    Tee out;    //!< Records std::cout
+    Tee err;    //!< Records std::cerr
+};
+
+
+/*!
+ * A PrecompiledLibrary is a binary file next to a Require'd xml file, which
+ * holds the parsed global enumerations and structures of that file. Each
+ * entry is the model of one of these, the warnings its parse printed, and
+ * what it looked up from other files while it was parsed. A library is only
+ * used if the xml file, the ProtoGen version, and the protocol options are
+ * all the same as when it was written, and the file is not damaged. An entry
+ * is only used if everything it looked up still gives the same result, else
+ * the object is parsed again.
+ */
+class PrecompiledLibrary
+{
+public:
+
+    //! The kinds of things an entry can look up while it is parsed
+    enum DependencyKind
+    {
+        enumerationLookup,  //!< The enumeration with a name
+        valueReplacement,   //!< The text with enumeration values replaced
+        structureLookup     //!< The structure with a type name
+    };
+
+    //! Something an entry looked up while it was parsed
+    class Dependency
+    {
+    public:
+        Dependency(int what, const std::string& name, const std::string& answer) :
+            kind(what), argument(name), result(answer) {}
+
+        int kind;               //!< The DependencyKind of the look up
+        std::string argument;   //!< What was looked up
+        std::string result;     //!< A summary of what the look up found
+    };
+
+    //! The parsed data of one enumeration or structure
+    class Entry
+    {
+    public:
+        std::vector<Dependency> dependencies;   //!< What the parse looked up
+        OutputRecorder::Output output;          //!< What the parse printed
+        std::string model;                      //!< The parsed object
+    };
+
+    //! Construct an empty library for an xml file
+    PrecompiledLibrary(const std::string& xmlFileName, uint64_t xmlHash, const std::string& options);
+
+    //! Load the library file, if it is up to date
+    bool load(void);
+
+    //! Save the library file
+    bool save(void) const;
+
+    //! Return true if the library has no entries
+    bool isEmpty(void) const {return entries.empty();}
+
+    //! Return the entry of the object from an element of the xml file, or null if there is none
+    const Entry* getEntry(int element) const;
+
+    //! Add an empty entry for the object from an element of the xml file
+    Entry& addEntry(int element) {return entries[element] = Entry();}
+
+    //! Return the name of the library file
+    std::string getFileName(void) const {return libraryFileName(xmlfile);}
+
+    //! Return the name of the library file for an xml file
+    static std::string libraryFileName(const std::string& xmlFileName);
+
+protected:
+
+    //! Write the header which identifies the source of the library
+    void writeHeader(CacheWriter& writer) const;
+
+    //! Compute the 64-bit FNV-1a hash of data
+    static uint64_t hashData(const std::string& data);
+
+    std::string xmlfile;            //!< The name of the xml file
+    uint64_t hash;                  //!< The hash of the contents of the xml file
+    std::string options;            //!< The version and protocol options the library depends on
+    std::map<int, Entry> entries;   //!< The entries, by the index of their element in the xml file
+};
+
+#endif // PRECOMPILEDLIBRARY_H
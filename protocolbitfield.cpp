@@ -2,7 +2,7 @@
 #include <iomanip>
 #include <sstream>
 
-void ProtocolBitfield::generatetest(ProtocolSupport support)
+void ProtocolBitfield::generatetest(const ProtocolSupport& support)
 {
     if(!support.bitfieldtest)
         return;
@@ -14,7 +14,7 @@ void ProtocolBitfield::generatetest(ProtocolSupport support)
     // functions in the bitfieldtest module, we just need to exercise them.
 
     // Prototype for testing bitfields, note the files have already been flushed, so we are appending
-    header.setModuleNameAndPath("bitfieldtest", support.outputpath, support.language);
+    header.setModuleNameAndPath("bitfieldtest", support.outputpath(), support.language);
     header.makeLineSeparator();
     header.write("//! Test the bit fields\n");
     header.write("int testBitfield(void);\n");
@@ -22,7 +22,7 @@ void ProtocolBitfield::generatetest(ProtocolSupport support)
     header.flush();
 
     // Now the source code
-    source.setModuleNameAndPath("bitfieldtest", support.outputpath, support.language);
+    source.setModuleNameAndPath("bitfieldtest", support.outputpath(), support.language);
     source.makeLineSeparator();
     source.writeIncludeDirective("string.h", std::string(), true);
     source.writeIncludeDirective("limits.h", std::string(), true);
@@ -36,10 +36,10 @@ void ProtocolBitfield::generatetest(ProtocolSupport support)
         source.write(" */\n");
         source.write("int testBitfield(void)\n");
         source.write("{\n");
-        source.write("    bitfieldtest" + support.typeSuffix + " test   = {1, 2, 12, 0xABC, 0, 3, 4, 0xC87654321ULL};\n");
-        source.write("    bitfieldtest2" + support.typeSuffix + " test2 = {1, 2, 12, 0xABC, 0, 3, 4, 0xC87654321ULL};\n");
+        source.write("    bitfieldtest" + support.typeSuffix() + " test   = {1, 2, 12, 0xABC, 0, 3, 4, 0xC87654321ULL};\n");
+        source.write("    bitfieldtest2" + support.typeSuffix() + " test2 = {1, 2, 12, 0xABC, 0, 3, 4, 0xC87654321ULL};\n");
         source.write("\n");
-        source.write("    bitfieldtest3" + support.typeSuffix + " test3 = {12.5f, 12.5f, 3.14159, 0, 0, 50};\n");
+        source.write("    bitfieldtest3" + support.typeSuffix() + " test3 = {12.5f, 12.5f, 3.14159, 0, 0, 50};\n");
         source.write("\n");
         source.write("    uint8_t data[20];\n");
         source.write("    int index = 0;\n");
@@ -141,9 +141,9 @@ void ProtocolBitfield::generatetest(ProtocolSupport support)
         source.write(" */\n");
         source.write("int testBitfield(void)\n");
         source.write("{\n");
-        source.write("    bitfieldtest" + support.typeSuffix + " test;\n");
-        source.write("    bitfieldtest2" + support.typeSuffix + " test2;\n");
-        source.write("    bitfieldtest3" + support.typeSuffix + " test3;\n");
+        source.write("    bitfieldtest" + support.typeSuffix() + " test;\n");
+        source.write("    bitfieldtest2" + support.typeSuffix() + " test2;\n");
+        source.write("    bitfieldtest3" + support.typeSuffix() + " test3;\n");
         source.write("    uint8_t data[20];\n");
         source.write("    int index = 0;\n");
         source.write("\n");
@@ -18,7 +18,7 @@ class ProtocolBitfield
 public:
 
     //! Perform the test generation, writing out the files
-    static void generatetest(ProtocolSupport support);
+    static void generatetest(const ProtocolSupport& support);
 
     //! Compute the maximum value of a field
     static uint64_t maxvalueoffield(int numbits);
@@ -1,5 +1,6 @@
 #include "protocolcode.h"
 #include "protocolparser.h"
+#include "precompiledlibrary.h"
 #include <iostream>
 
 /*!
@@ -8,10 +9,11 @@
  * \param parent is the hierarchical name of the owning object
  * \param supported indicates what the protocol can support
  */
-ProtocolCode::ProtocolCode(ProtocolParser* parse, std::string parent, ProtocolSupport supported):
+ProtocolCode::ProtocolCode(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported):
     Encodable(parse, parent, supported)
 {
-    attriblist = {"name", "encode", "decode", "encode_c", "decode_c", "encode_cpp", "decode_cpp", "encode_python", "decode_python", "comment", "include"};
+    static const AttributeNames names({"name", "encode", "decode", "encode_c", "decode_c", "encode_cpp", "decode_cpp", "encode_python", "decode_python", "comment", "include"});
+    attriblist = &names;
 }
 
 
@@ -40,7 +42,7 @@ void ProtocolCode::parse(void)
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
     // We use name as part of our debug outputs, so its good to have it first.
     name = ProtocolParser::getAttribute("name", map, "_unknown");
@@ -64,6 +66,45 @@ void ProtocolCode::parse(void)
 }// ProtocolCode::parse
 
 
+/*!
+ * Save the parsed code to a precompiled library
+ * \param writer receives the data
+ */
+void ProtocolCode::save(CacheWriter& writer) const
+{
+    Encodable::save(writer);
+    writer.write(encode);
+    writer.write(decode);
+    writer.write(encodecpp);
+    writer.write(decodecpp);
+    writer.write(encodepython);
+    writer.write(decodepython);
+    writer.write(include);
+}
+
+
+/*!
+ * Load the parsed code from a precompiled library, in place of parse()
+ * \param reader supplies the data written by save()
+ * \return true if the code was loaded
+ */
+bool ProtocolCode::load(CacheReader& reader)
+{
+    clear();
+
+    Encodable::load(reader);
+    encode = reader.readString();
+    decode = reader.readString();
+    encodecpp = reader.readString();
+    decodecpp = reader.readString();
+    encodepython = reader.readString();
+    decodepython = reader.readString();
+    include = reader.readString();
+
+    return reader.isGood();
+}
+
+
 /*!
  * Get the next lines(s) of source coded needed to add this code to the encode function
  * \param isBigEndian should be true for big endian encoding, ignored.
@@ -10,7 +10,7 @@ class ProtocolCode : public Encodable
     public:
 
     //! Construct a field, setting the protocol name and name prefix
-    ProtocolCode(ProtocolParser* parse, std::string parent, ProtocolSupport supported);
+    ProtocolCode(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported);
 
     //! Reset all data to defaults
     void clear(void) override;
@@ -18,6 +18,12 @@ class ProtocolCode : public Encodable
     //! Parse the DOM element
     void parse(void) override;
 
+    //! Save the parsed code to a precompiled library
+    void save(CacheWriter& writer) const override;
+
+    //! Load the parsed code from a precompiled library
+    bool load(CacheReader& reader) override;
+
     //! The hierarchical name of this object
     std::string getHierarchicalName(void) const override {return parent + ":" + name;}
 
@@ -0,0 +1,637 @@
+#include "protocolcolumntable.h"
+#include "protocolstructuremodule.h"
+#include "protocolpacket.h"
+#include <algorithm>
+
+ProtocolColumnTable::ProtocolColumnTable(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolColumnTable::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*!
+ * Output C++ functions that decode packets and append them, one row per
+ * packet, to a table of typed columns. Every field gets a column, including
+ * each element of an array, so all rows of a packet have the same columns.
+ * The table can be written as a column file whose buffers have the Arrow
+ * layout. The columns helper module is output as well.
+ * \param protocolname is the name of the protocol
+ * \param protocolheader is the name of the main header of the protocol
+ * \param structures are the global structures of the protocol
+ * \param packets are the packets of the protocol
+ * \param fileNameList is appended with the names of the files that are output
+ * \param filePathList is appended with the paths of the files that are output
+ * \return true if the helper module was output
+ */
+bool ProtocolColumnTable::generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::vector<ProtocolStructureModule*>& structures, const std::vector<ProtocolPacket*>& packets, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    std::vector<const ProtocolStructureModule*> modules(structures.begin(), structures.end());
+
+    // Packets which can be used by other packets are already in the structures
+    for(std::size_t i = 0; i < packets.size(); i++)
+    {
+        if(std::find(modules.begin(), modules.end(), packets.at(i)) == modules.end())
+            modules.push_back(packets.at(i));
+    }
+
+    ProtocolHeaderFile columnheader(support);
+    ProtocolSourceFile columnsource(support);
+
+    columnheader.setModuleNameAndPath(protocolname + "Columns", support.outputpath(), ProtocolSupport::cpp_language);
+    columnsource.setModuleNameAndPath(protocolname + "Columns", support.outputpath(), ProtocolSupport::cpp_language);
+
+    columnheader.setFileComment("Functions that append decoded " + protocolname + " packets to the columns of a table");
+
+    columnheader.writeIncludeDirective("columntable");
+    columnheader.writeIncludeDirective(protocolheader, std::string(), false, false);
+
+    std::vector<std::string> includes;
+    std::string prototypes, bodies;
+
+    for(const ProtocolStructureModule* module : modules)
+    {
+        // Don't output if hidden and we are omitting hidden items
+        if(module->isHidden() && !module->isNeverOmit() && support.omitIfHidden)
+            continue;
+
+        includes.push_back(module->getHeaderFileName());
+
+        ProtocolFile::makeLineSeparator(prototypes);
+        prototypes += module->getColumnAppendFunctionPrototype();
+
+        ProtocolFile::makeLineSeparator(bodies);
+        bodies += module->getColumnAppendFunctionBody();
+    }
+
+    for(std::size_t i = 0; i < packets.size(); i++)
+    {
+        const ProtocolPacket* packet = packets.at(i);
+
+        if(packet->isHidden() && !packet->isNeverOmit() && support.omitIfHidden)
+            continue;
+
+        ProtocolFile::makeLineSeparator(prototypes);
+        prototypes += packet->getColumnAppendPacketPrototype();
+
+        ProtocolFile::makeLineSeparator(bodies);
+        bodies += packet->getColumnAppendPacketBody();
+    }
+
+    removeDuplicates(includes);
+    for(std::size_t i = 0; i < includes.size(); i++)
+        columnheader.writeIncludeDirective(includes.at(i), std::string(), false, false);
+
+    columnheader.makeLineSeparator();
+    columnheader.write(prototypes);
+    columnheader.makeLineSeparator();
+
+    columnsource.makeLineSeparator();
+    columnsource.write(bodies);
+    columnsource.makeLineSeparator();
+
+    bool helper = generate(fileNameList, filePathList);
+
+    columnheader.flush();
+    fileNameList.push_back(columnheader.fileName());
+    filePathList.push_back(columnheader.filePath());
+
+    columnsource.flush();
+    fileNameList.push_back(columnsource.fileName());
+    filePathList.push_back(columnsource.filePath());
+
+    return helper;
+
+}// ProtocolColumnTable::generateProtocol
+
+
+//! Generate the header file
+bool ProtocolColumnTable::generateHeader(void)
+{
+    // The columns are C++, even for a C protocol
+    header.setModuleNameAndPath("columntable", support.outputpath(), ProtocolSupport::cpp_language);
+
+// Raw string magic here
+header.setFileComment(R"(\brief Typed column buffers that decoded structures are appended to
+
+A table holds one column for every value of a structure: each field, each
+element of an array, and each field of a sub-structure. Scaled fields are
+stored as their scaled value, and enumerations with a label lookup also get
+a column of labels. The generated appendColumns() functions append one
+structure to the table as a row, the first row defines the columns.
+
+The buffers of each column are laid out like an Apache Arrow array: a
+validity bitmap (least significant bit first, 1 if the value is present),
+32-bit offsets for strings, and the values, with booleans packed as bits.
+They can be handed to Arrow, or to NumPy, without conversion. Elements of
+variable length arrays past the array length are null.
+
+write() saves the table as a simple column file, which is described with
+that function.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("cstdint", std::string(), true, false);
+    header.writeIncludeDirective("string", std::string(), true, false);
+    header.writeIncludeDirective("vector", std::string(), true, false);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! One column of a table, with its values in the buffers of an Arrow array
+class PgColumn
+{
+public:
+
+    //! The types of column, which match the Arrow types of the same name
+    enum Type
+    {
+        Bool,       //!< Booleans, packed as bits
+        Int64,      //!< Signed integers and enumerations
+        UInt64,     //!< Unsigned integers
+        Float32,    //!< Single precision floating point
+        Float64,    //!< Double precision floating point, and scaled values
+        Utf8        //!< Strings and enumeration labels
+    };
+
+    //! Construct an empty column
+    PgColumn(const std::string& columnName, Type columnType);
+
+    //! Append a boolean
+    void appendBool(bool value);
+
+    //! Append a signed integer
+    void appendInt(int64_t value);
+
+    //! Append an unsigned integer
+    void appendUInt(uint64_t value);
+
+    //! Append a single precision value
+    void appendFloat(float value);
+
+    //! Append a double precision value
+    void appendDouble(double value);
+
+    //! Append a string, a null pointer is a null value
+    void appendString(const char* value);
+
+    //! Append a string
+    void appendString(const std::string& value);
+
+    //! Append a null value
+    void appendNull(void);
+
+    //! Remove all the values, keeping the name and type
+    void clear(void);
+
+    std::string name;               //!< Name of the column
+    Type type;                      //!< Type of the values
+    std::size_t length;             //!< Number of values, including nulls
+    std::size_t nullCount;          //!< Number of null values
+    std::vector<uint8_t> validity;  //!< Bit for each value, set if it is not null
+    std::vector<int32_t> offsets;   //!< For strings, the offset of each string in values, and the end
+    std::vector<uint8_t> values;    //!< The values, or the bytes of the strings
+    bool nullNext;                  //!< Set to make the next value null, whatever it is
+
+private:
+
+    //! Append the bytes of a fixed width value
+    void appendBytes(const void* value, std::size_t size);
+
+    //! Record if the next value is present
+    void appendValidity(bool valid);
+};
+
+
+//! Columns for one type of structure, with one row for each structure appended
+class PgColumnTable
+{
+public:
+
+    //! Construct an empty table
+    PgColumnTable(void);
+
+    //! Start a new row
+    void beginRow(void);
+
+    //! Finish a row, the first row defines the columns
+    void endRow(void);
+
+    //! Return the column for the next value of the row, creating it on the first row
+    PgColumn& next(PgColumn::Type type, const std::string& prename, const char* name, int i = -1, int j = -1);
+
+    //! Return the name of a sub-structure, which is only built while the columns are defined
+    std::string name(const std::string& prename, const char* name, int i = -1, int j = -1) const;
+
+    //! Make all the values appended until endNulls() null
+    void beginNulls(void) {nulls++;}
+
+    //! Stop making the values appended null
+    void endNulls(void) {nulls--;}
+
+    //! Return the number of rows
+    std::size_t rows(void) const {return numRows;}
+
+    //! Remove all the rows, keeping the columns
+    void clear(void);
+
+    //! Write the table to a column file
+    bool write(const std::string& fileName) const;
+
+    std::vector<PgColumn> columns;  //!< The columns, in the order of the fields
+
+private:
+
+    //! Build the name of a column
+    static std::string columnName(const std::string& prename, const char* name, int i, int j);
+
+    std::size_t numRows;    //!< Number of complete rows
+    std::size_t cursor;     //!< Index of the next column in the row
+    bool defined;           //!< True once the first row has defined the columns
+    int nulls;              //!< Greater than zero while the values appended are made null
+};
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolColumnTable::generateHeader
+
+
+//! Generate the source file
+bool ProtocolColumnTable::generateSource(void)
+{
+    source.setModuleNameAndPath("columntable", support.outputpath(), ProtocolSupport::cpp_language);
+    source.writeIncludeDirective("cstring", std::string(), true, false);
+    source.writeIncludeDirective("cstdio", std::string(), true, false);
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(/*!
+ * Construct an empty column
+ * \param columnName is the name of the column
+ * \param columnType is the type of the values
+ */
+PgColumn::PgColumn(const std::string& columnName, Type columnType) :
+    name(columnName),
+    type(columnType),
+    length(0),
+    nullCount(0),
+    nullNext(false)
+{
+    if(type == Utf8)
+        offsets.push_back(0);
+}
+
+
+//! Record if the next value is present
+void PgColumn::appendValidity(bool valid)
+{
+    if((length % 8) == 0)
+        validity.push_back(0);
+
+    if(valid)
+        validity.back() |= (uint8_t)(1u << (length % 8));
+    else
+        nullCount++;
+
+    length++;
+}
+
+
+//! Append the bytes of a fixed width value
+void PgColumn::appendBytes(const void* value, std::size_t size)
+{
+    std::size_t end = values.size();
+    values.resize(end + size);
+    std::memcpy(values.data() + end, value, size);
+}
+
+
+//! Append a boolean
+void PgColumn::appendBool(bool value)
+{
+    if(nullNext)
+    {
+        appendNull();
+        return;
+    }
+
+    if((length % 8) == 0)
+        values.push_back(0);
+
+    if(value)
+        values.back() |= (uint8_t)(1u << (length % 8));
+
+    appendValidity(true);
+}
+
+
+//! Append a signed integer
+void PgColumn::appendInt(int64_t value)
+{
+    if(nullNext)
+        appendNull();
+    else
+    {
+        appendBytes(&value, sizeof(value));
+        appendValidity(true);
+    }
+}
+
+
+//! Append an unsigned integer
+void PgColumn::appendUInt(uint64_t value)
+{
+    if(nullNext)
+        appendNull();
+    else
+    {
+        appendBytes(&value, sizeof(value));
+        appendValidity(true);
+    }
+}
+
+
+//! Append a single precision value
+void PgColumn::appendFloat(float value)
+{
+    if(nullNext)
+        appendNull();
+    else
+    {
+        appendBytes(&value, sizeof(value));
+        appendValidity(true);
+    }
+}
+
+
+//! Append a double precision value
+void PgColumn::appendDouble(double value)
+{
+    if(nullNext)
+        appendNull();
+    else
+    {
+        appendBytes(&value, sizeof(value));
+        appendValidity(true);
+    }
+}
+
+
+//! Append a string, a null pointer is a null value
+void PgColumn::appendString(const char* value)
+{
+    if(nullNext || (value == nullptr))
+        appendNull();
+    else
+    {
+        values.insert(values.end(), value, value + std::strlen(value));
+        offsets.push_back((int32_t)values.size());
+        appendValidity(true);
+    }
+}
+
+
+//! Append a string
+void PgColumn::appendString(const std::string& value)
+{
+    appendString(value.c_str());
+}
+
+
+//! Append a null value, which still takes the space of a value
+void PgColumn::appendNull(void)
+{
+    nullNext = false;
+
+    switch(type)
+    {
+    case Bool:
+        if((length % 8) == 0)
+            values.push_back(0);
+        break;
+
+    case Int64:
+    case UInt64:
+    case Float64:
+        values.resize(values.size() + 8);
+        break;
+
+    case Float32:
+        values.resize(values.size() + 4);
+        break;
+
+    case Utf8:
+        offsets.push_back(offsets.back());
+        break;
+    }
+
+    appendValidity(false);
+}
+
+
+//! Remove all the values, keeping the name and type
+void PgColumn::clear(void)
+{
+    length = 0;
+    nullCount = 0;
+    nullNext = false;
+    validity.clear();
+    values.clear();
+    offsets.clear();
+    if(type == Utf8)
+        offsets.push_back(0);
+}
+
+
+//! Construct an empty table
+PgColumnTable::PgColumnTable(void) :
+    numRows(0),
+    cursor(0),
+    defined(false),
+    nulls(0)
+{
+}
+
+
+//! Start a new row
+void PgColumnTable::beginRow(void)
+{
+    cursor = 0;
+}
+
+
+//! Finish a row, the first row defines the columns
+void PgColumnTable::endRow(void)
+{
+    defined = true;
+    numRows++;
+}
+
+
+/*!
+ * Return the column for the next value of the row. On the first row the
+ * column is created, after that the columns are used in the same order.
+ * \param type is the type of the column
+ * \param prename is the name of the structure that holds the value
+ * \param name is the name of the field, starting with ':'
+ * \param i is the first array index, or -1
+ * \param j is the second array index, or -1
+ * \return the column, which the caller appends the value to
+ */
+PgColumn& PgColumnTable::next(PgColumn::Type type, const std::string& prename, const char* name, int i, int j)
+{
+    if(!defined)
+        columns.push_back(PgColumn(columnName(prename, name, i, j), type));
+
+    PgColumn& column = columns[cursor++];
+
+    if(nulls > 0)
+        column.nullNext = true;
+
+    return column;
+}
+
+
+/*!
+ * Return the name of a sub-structure, which is the prename of its fields. The
+ * name is only built while the columns are defined, after that it is empty.
+ * \param prename is the name of the structure that holds the sub-structure
+ * \param name is the name of the field, starting with ':'
+ * \param i is the first array index, or -1
+ * \param j is the second array index, or -1
+ * \return the name
+ */
+std::string PgColumnTable::name(const std::string& prename, const char* name, int i, int j) const
+{
+    if(defined)
+        return std::string();
+    else
+        return columnName(prename, name, i, j);
+}
+
+
+//! Build the name of a column, fields of the top level structure do not start with ':'
+std::string PgColumnTable::columnName(const std::string& prename, const char* name, int i, int j)
+{
+    std::string output = prename.empty() ? std::string(name + 1) : prename + name;
+
+    if(i >= 0)
+        output += "[" + std::to_string(i) + "]";
+
+    if(j >= 0)
+        output += "[" + std::to_string(j) + "]";
+
+    return output;
+}
+
+
+//! Remove all the rows, keeping the columns
+void PgColumnTable::clear(void)
+{
+    for(std::size_t i = 0; i < columns.size(); i++)
+        columns[i].clear();
+
+    numRows = 0;
+    cursor = 0;
+}
+
+
+//! Write a 64-bit length and the bytes that follow it, padded to 8 bytes
+static void writeBuffer(std::FILE* file, const void* data, std::size_t size)
+{
+    static const uint8_t padding[8] = {0};
+
+    uint64_t length = size;
+    std::fwrite(&length, sizeof(length), 1, file);
+
+    if(size > 0)
+        std::fwrite(data, 1, size, file);
+
+    std::fwrite(padding, 1, (8 - (size % 8)) % 8, file);
+}
+
+
+/*!
+ * Write the table to a column file. Everything is in the byte order of the
+ * machine that wrote it, and every item is aligned to 8 bytes:
+ *
+ *     char     magic[8]       "PGCOLS1" and a zero
+ *     uint32_t byteOrder      0x01020304
+ *     uint32_t numColumns
+ *     uint64_t numRows
+ *
+ * then for each column:
+ *
+ *     uint64_t nameLength     followed by the name, padded
+ *     uint32_t type           PgColumn::Type
+ *     uint32_t reserved       zero
+ *     uint64_t nullCount
+ *     uint64_t validityBytes  followed by the validity bitmap, padded, empty if there are no nulls
+ *     uint64_t offsetBytes    followed by the string offsets, padded, empty if not a string
+ *     uint64_t valueBytes     followed by the values, padded
+ *
+ * \param fileName is the name of the file
+ * \return true if the file was written
+ */
+bool PgColumnTable::write(const std::string& fileName) const
+{
+    std::FILE* file = std::fopen(fileName.c_str(), "wb");
+    if(file == nullptr)
+        return false;
+
+    const char magic[8] = {'P', 'G', 'C', 'O', 'L', 'S', '1', 0};
+    uint32_t byteOrder = 0x01020304;
+    uint32_t numColumns = (uint32_t)columns.size();
+    uint64_t rowCount = numRows;
+
+    std::fwrite(magic, 1, sizeof(magic), file);
+    std::fwrite(&byteOrder, sizeof(byteOrder), 1, file);
+    std::fwrite(&numColumns, sizeof(numColumns), 1, file);
+    std::fwrite(&rowCount, sizeof(rowCount), 1, file);
+
+    for(std::size_t i = 0; i < columns.size(); i++)
+    {
+        const PgColumn& column = columns[i];
+        uint32_t type[2] = {(uint32_t)column.type, 0};
+        uint64_t nullCount = column.nullCount;
+
+        writeBuffer(file, column.name.data(), column.name.size());
+        std::fwrite(type, sizeof(type), 1, file);
+        std::fwrite(&nullCount, sizeof(nullCount), 1, file);
+
+        // Like Arrow, the validity bitmap can be left out if there are no nulls
+        writeBuffer(file, column.validity.data(), (nullCount > 0) ? column.validity.size() : 0);
+        writeBuffer(file, column.offsets.data(), column.offsets.size()*sizeof(int32_t));
+        writeBuffer(file, column.values.data(), column.values.size());
+    }
+
+    return (std::fclose(file) == 0);
+}
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolColumnTable::generateSource
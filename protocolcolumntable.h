@@ -0,0 +1,42 @@
+#ifndef PROTOCOLCOLUMNTABLE_H
+#define PROTOCOLCOLUMNTABLE_H
+
+/*!
+ * \file
+ * Auto magically generate the typed column buffers that decoded packets are appended to
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+#include <vector>
+
+class ProtocolStructureModule;
+class ProtocolPacket;
+
+class ProtocolColumnTable
+{
+public:
+    ProtocolColumnTable(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+    //! Perform the generation of the functions that append the packets of a protocol, and the helper module
+    bool generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::vector<ProtocolStructureModule*>& structures, const std::vector<ProtocolPacket*>& packets, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLCOLUMNTABLE_H
@@ -1,5 +1,6 @@
 #include "protocoldocumentation.h"
 #include "protocolparser.h"
+#include "precompiledlibrary.h"
 #include <fstream>
 
 // Initialize convenience strings
@@ -12,14 +13,16 @@ std::vector<std::string> ProtocolDocumentation::keywords = {"auto", "double", "i
 std::vector<std::string> ProtocolDocumentation::variablenames = {"_pg_user", "_pg_user1", "_pg_user2", "_pg_data", "_pg_i", "_pg_j", "_pg_byteindex", "_pg_bytecount", "_pg_numBytes", "_pg_bitfieldbytes", "_pg_tempbitfield", "_pg_templongbitfield", "_pg_bitfieldindex", "_pg_good", "_pg_struct1", "_pg_struct2", "_pg_prename", "_pg_report"};
 
 //! Construct the document object, with details about the overall protocol
-ProtocolDocumentation::ProtocolDocumentation(ProtocolParser* parse, std::string Parent, ProtocolSupport supported) :
+ProtocolDocumentation::ProtocolDocumentation(ProtocolParser* parse, std::string Parent, const ProtocolSupport& supported) :
     support(supported),
     parser(parse),
     parent(Parent),
     e(nullptr),
-    attriblist({"name", "title", "comment", "file", "paragraph"}),
+    attriblist(nullptr),
     outlineLevel(0)
 {
+    static const AttributeNames names({"name", "title", "comment", "file", "paragraph"});
+    attriblist = &names;
 }
 
 
@@ -31,7 +34,7 @@ void ProtocolDocumentation::parse(void)
 
     // We have two features we care about in the documentation, "name" which
     // gives the paragraph, and "comment" which gives the documentation to add
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
     name = ProtocolParser::getAttribute("name", map);
     title = ProtocolParser::getAttribute("title", map);
@@ -51,6 +54,38 @@ void ProtocolDocumentation::parse(void)
 }
 
 
+/*!
+ * Save the parsed data to a precompiled library
+ * \param writer receives the data
+ */
+void ProtocolDocumentation::save(CacheWriter& writer) const
+{
+    writer.write(name);
+    writer.write(title);
+    writer.write(comment);
+    writer.write(docfile);
+    writer.write((int64_t)outlineLevel);
+}
+
+
+/*!
+ * Load the parsed data from a precompiled library, in place of parse(). The
+ * element must be set first.
+ * \param reader supplies the data written by save()
+ * \return true if the data were loaded
+ */
+bool ProtocolDocumentation::load(CacheReader& reader)
+{
+    name = reader.readString();
+    title = reader.readString();
+    comment = reader.readString();
+    docfile = reader.readString();
+    outlineLevel = (int)reader.readInt();
+
+    return reader.isGood();
+}
+
+
 /*!
  * Return top level markdown documentation for this documentation
  * \param global specifies if this output is the sub of another documentation (global == false) or is a top level documentation.
@@ -118,7 +153,7 @@ void ProtocolDocumentation::emitWarning(const std::string& warning, const std::s
 
     int line = e->GetLineNum();
 
-    std::cerr << support.sourcefile << "(" << line << "): warning: " << name << ": " << warning << std::endl;
+    std::cerr << support.sourcefile() << "(" << line << "): warning: " << name << ": " << warning << std::endl;
 }
 
 
@@ -131,7 +166,7 @@ void ProtocolDocumentation::emitWarning(const std::string& warning, const std::s
  */
 void ProtocolDocumentation::emitWarning(const std::string& warning, const XMLAttribute* a) const
 {
-    emitWarning(support.sourcefile, getHierarchicalName(), warning, a);
+    emitWarning(support.sourcefile(), getHierarchicalName(), warning, a);
 }
 
 
@@ -162,17 +197,17 @@ void ProtocolDocumentation::emitWarning(const std::string& sourcefile, const std
  * \param map is the list of attributes
  * \param subname is the optional name of a sub-element for which this test is done
  */
-void ProtocolDocumentation::testAndWarnAttributes(const XMLAttribute* map) const
+void ProtocolDocumentation::testAndWarnAttributes(const AttributeIndex& map) const
 {
     // The only thing we check for is unrecognized attributes
     if(support.disableunrecognized)
         return;
 
     /// TODO: test for repeated attributes
-    for(const XMLAttribute* a = map; a != nullptr; a = a->Next())
+    for(const XMLAttribute* a = map.firstAttribute(); a != nullptr; a = a->Next())
     {
-        // Check to see if the attribute is not in the list of known attributes
-        if((contains(attriblist, a->Name()) == false))
+        // Check to see if the attribute is not in the set of known attributes
+        if(attriblist->contains(a->Name()) == false)
             emitWarning("Unrecognized attribute", a);
 
     }// for all attributes
@@ -188,7 +223,7 @@ void ProtocolDocumentation::testAndWarnAttributes(const XMLAttribute* map) const
  * \param e is the DOM element which may have documentation children
  * \param list receives the list of allocated objects.
  */
-void ProtocolDocumentation::getChildDocuments(ProtocolParser* parse, const std::string& Parent, ProtocolSupport support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list)
+void ProtocolDocumentation::getChildDocuments(ProtocolParser* parse, const std::string& Parent, const ProtocolSupport& support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list)
 {
     // The list of documentation that goes inside this packet
     std::vector<const XMLElement*> documents = ProtocolParser::childElementsByTagName(e, "Document");
@@ -207,3 +242,61 @@ void ProtocolDocumentation::getChildDocuments(ProtocolParser* parse, const std::
     }
 
 }// ProtocolDocumentation::getChildDocuments
+
+
+/*!
+ * Return the index of the element amongst the child elements of its parent,
+ * which is how a precompiled library refers to the element.
+ * \return the index of the element, or -1 if there is no element
+ */
+int ProtocolDocumentation::getElementIndex(void) const
+{
+    if(e == nullptr)
+        return -1;
+
+    int index = 0;
+    for(const XMLElement* sibling = e->PreviousSiblingElement(); sibling != nullptr; sibling = sibling->PreviousSiblingElement())
+        index++;
+
+    return index;
+}
+
+
+/*!
+ * Read the index of a child element from a precompiled library, and return
+ * the element. The reader is marked bad if the element does not exist.
+ * \param reader supplies the index written from getElementIndex()
+ * \param children are the child elements of the parent, from childElements()
+ * \return the element, or null if it does not exist
+ */
+const XMLElement* ProtocolDocumentation::readElement(CacheReader& reader, const std::vector<const XMLElement*>& children)
+{
+    int64_t index = reader.readInt();
+
+    if((index < 0) || (index >= (int64_t)children.size()))
+    {
+        reader.fail();
+        return nullptr;
+    }
+
+    return children.at((std::size_t)index);
+}
+
+
+/*!
+ * Return all the child elements of an element
+ * \param element is the parent element, which can be null
+ * \return the child elements, in order
+ */
+std::vector<const XMLElement*> ProtocolDocumentation::childElements(const XMLElement* element)
+{
+    std::vector<const XMLElement*> list;
+
+    if(element != nullptr)
+    {
+        for(const XMLElement* child = element->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+            list.push_back(child);
+    }
+
+    return list;
+}
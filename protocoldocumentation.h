@@ -4,15 +4,19 @@
 #include <vector>
 #include <string>
 #include "protocolsupport.h"
+#include "attributeindex.h"
+#include "internedstring.h"
 
 class ProtocolParser;
+class CacheWriter;
+class CacheReader;
 
 class ProtocolDocumentation
 {
 public:
 
     //! Construct the document object
-    ProtocolDocumentation(ProtocolParser* parse, std::string Parent, ProtocolSupport supported);
+    ProtocolDocumentation(ProtocolParser* parse, std::string Parent, const ProtocolSupport& supported);
 
     //! Virtual destructor
     virtual ~ProtocolDocumentation(void) {;}
@@ -26,6 +30,12 @@ public:
     //! Parse the document from the DOM
     virtual void parse(void);
 
+    //! Save the parsed data to a precompiled library
+    virtual void save(CacheWriter& writer) const;
+
+    //! Load the parsed data from a precompiled library, in place of parse()
+    virtual bool load(CacheReader& reader);
+
     //! Return top level markdown documentation for this packet
     virtual std::string getTopLevelMarkdown(bool global = false, const std::vector<std::string>& ids = std::vector<std::string>()) const;
 
@@ -48,28 +58,37 @@ public:
     static void emitWarning(const std::string& sourcefile, const std::string& hierarchicalName, const std::string& warning, const XMLAttribute* a);
 
     //! Test the list of attributes and warn if any of them are unrecognized or repeated
-    void testAndWarnAttributes(const XMLAttribute* map) const;
+    void testAndWarnAttributes(const AttributeIndex& map) const;
 
     //! Helper function to create a list of ProtocolDocumentation objects
-    static void getChildDocuments(ProtocolParser* parse, const std::string& parent, ProtocolSupport support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list);
+    static void getChildDocuments(ProtocolParser* parse, const std::string& parent, const ProtocolSupport& support, const XMLElement* e, std::vector<ProtocolDocumentation*>& list);
+
+    //! Return the index of the element amongst the child elements of its parent
+    int getElementIndex(void) const;
+
+    //! Read the index of a child element from a precompiled library, and return the element
+    static const XMLElement* readElement(CacheReader& reader, const std::vector<const XMLElement*>& children);
+
+    //! Return all the child elements of an element
+    static std::vector<const XMLElement*> childElements(const XMLElement* element);
 
 public:
 
     //! String used to tab code in (perhaps one day we'll make this user changeable)
     static const std::string TAB_IN;
 
-    std::string name;           //!< The name of this encodable
-    std::string title;          //!< The title of this encodable (used for documentation)
-    std::string comment;        //!< The comment that goes with this encodable
+    InternedString name;        //!< The name of this encodable
+    InternedString title;       //!< The title of this encodable (used for documentation)
+    InternedString comment;     //!< The comment that goes with this encodable
 
 protected:
 
     ProtocolSupport support;    //!< Information about what is supported
     ProtocolParser* parser;     //!< The parser object
-    std::string parent;         //!< The parent name of this encodable
+    InternedString parent;      //!< The parent name of this encodable
     const XMLElement* e;        //!< The DOM element which is the source of this object's data
 
-    std::vector<std::string> attriblist;//!< List of all attributes that we understand
+    const AttributeNames* attriblist;//!< Shared set of all attributes that we understand
 
     static std::vector<std::string> keywords;     //!< keywords for the C language
     static std::vector<std::string> variablenames;//!< variables used by protogen
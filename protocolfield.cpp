@@ -4,6 +4,7 @@
 #include "enumcreator.h"
 #include "protocolstructuremodule.h"
 #include "protocolbitfield.h"
+#include "precompiledlibrary.h"
 #include "prebuiltSources/floatspecial.h"
 #include <cmath>
 #include <iomanip>
@@ -11,7 +12,7 @@
 #include <regex>
 #include <limits>
 
-TypeData::TypeData(ProtocolSupport sup) :
+TypeData::TypeData(const ProtocolSupport& sup) :
     isBool(false),
     isStruct(false),
     isSigned(false),
@@ -24,26 +25,7 @@ TypeData::TypeData(ProtocolSupport sup) :
     bits(8),
     sigbits(0),
     enummax(0),
-    support(sup)
-{
-}
-
-
-TypeData::TypeData(const TypeData& that) :
-    isBool(that.isBool),
-    isStruct(that.isStruct),
-    isSigned(that.isSigned),
-    isBitfield(that.isBitfield),
-    isFloat(that.isFloat),
-    isEnum(that.isEnum),
-    isString(that.isString),
-    isFixedString(that.isFixedString),
-    isNull(that.isNull),
-    bits(that.bits),
-    sigbits(that.sigbits),
-    enummax(that.enummax),
-    enumName(that.enumName),
-    support(that.support)
+    support(&sup)
 {
 }
 
@@ -69,6 +51,78 @@ void TypeData::clear(void)
 }
 
 
+/*!
+ * Save the type data to a precompiled library
+ * \param writer receives the data
+ */
+void TypeData::save(CacheWriter& writer) const
+{
+    writer.write(isBool);
+    writer.write(isStruct);
+    writer.write(isSigned);
+    writer.write(isBitfield);
+    writer.write(isFloat);
+    writer.write(isEnum);
+    writer.write(isString);
+    writer.write(isFixedString);
+    writer.write(isNull);
+    writer.write((int64_t)bits);
+    writer.write((int64_t)sigbits);
+    writer.write((int64_t)enummax);
+    writer.write(enumName);
+}
+
+
+/*!
+ * Load the type data from a precompiled library
+ * \param reader supplies the data written by save()
+ */
+void TypeData::load(CacheReader& reader)
+{
+    isBool = reader.readBool();
+    isStruct = reader.readBool();
+    isSigned = reader.readBool();
+    isBitfield = reader.readBool();
+    isFloat = reader.readBool();
+    isEnum = reader.readBool();
+    isString = reader.readBool();
+    isFixedString = reader.readBool();
+    isNull = reader.readBool();
+    bits = (int)reader.readInt();
+    sigbits = (int)reader.readInt();
+    enummax = (int)reader.readInt();
+    enumName = reader.readString();
+}
+
+
+/*!
+ * Save the bitfield data to a precompiled library
+ * \param writer receives the data
+ */
+void BitfieldData::save(CacheWriter& writer) const
+{
+    writer.write((int64_t)startingBitCount);
+    writer.write((int64_t)groupBits);
+    writer.write(groupStart);
+    writer.write(groupMember);
+    writer.write(lastBitfield);
+}
+
+
+/*!
+ * Load the bitfield data from a precompiled library
+ * \param reader supplies the data written by save()
+ */
+void BitfieldData::load(CacheReader& reader)
+{
+    startingBitCount = (int)reader.readInt();
+    groupBits = (int)reader.readInt();
+    groupStart = reader.readBool();
+    groupMember = reader.readBool();
+    lastBitfield = reader.readBool();
+}
+
+
 /*!
  * Determine the typename of this field (for example uint8_t).
  * \param structName is the structure name, if this is a structure.
@@ -82,7 +136,7 @@ std::string TypeData::toTypeString(const std::string& structName) const
         typeName = "char";
     else if(isBitfield)
     {
-        if((bits > 32) && (support.longbitfield))
+        if((bits > 32) && (support->longbitfield))
             typeName = "uint64_t";
         else
             typeName = "unsigned";
@@ -96,9 +150,9 @@ std::string TypeData::toTypeString(const std::string& structName) const
         typeName = trimm(structName);
 
         // Make sure it ends with the suffix;
-        if(!endsWith(typeName, support.typeSuffix))
+        if(!endsWith(typeName, support->typeSuffix()))
         {
-            typeName += support.typeSuffix;
+            typeName += support->typeSuffix();
         }
     }
     else
@@ -164,6 +218,84 @@ std::string TypeData::toSigString(void) const
 }// toSigString
 
 
+/*!
+ * Determine the NumPy dtype string of this type when encoded, for example
+ * ">u2". Only types with a native NumPy width can be described this way.
+ * \param bigendian should be true if the protocol is big endian
+ * \return the dtype string, or an empty string if there is no native dtype
+ *         (for example 24 bit integers, or special floats).
+ */
+std::string TypeData::toNumpyString(bool bigendian) const
+{
+    if(isString || isBitfield || isStruct || isNull)
+        return std::string();
+
+    // Only IEEE-754 float and double map to NumPy floats
+    if(isFloat && (bits != 32) && (bits != 64))
+        return std::string();
+
+    if((bits != 8) && (bits != 16) && (bits != 32) && (bits != 64))
+        return std::string();
+
+    std::string code;
+    if(isFloat)
+        code = "f";
+    else if(isSigned)
+        code = "i";
+    else
+        code = "u";
+
+    code += std::to_string(bits/8);
+
+    // Byte order only applies to multi-byte types
+    if(bits == 8)
+        return code;
+    else if(bigendian)
+        return ">" + code;
+    else
+        return "<" + code;
+
+}// TypeData::toNumpyString
+
+
+/*!
+ * Determine the NumPy type used for this type in memory, for example "np.uint16"
+ * \return the NumPy type name, using native byte order
+ */
+std::string TypeData::toNumpyMemoryString(void) const
+{
+    if(isBool)
+        return "np.bool_";
+    else if(isFloat)
+    {
+        if(bits > 32)
+            return "np.float64";
+        else
+            return "np.float32";
+    }
+
+    std::string typeName;
+
+    if(isSigned)
+        typeName = "np.int";
+    else
+        typeName = "np.uint";
+
+    // We use only valid native type widths
+    if(bits > 32)
+        typeName += "64";
+    else if(bits > 16)
+        typeName += "32";
+    else if(bits > 8)
+        typeName += "16";
+    else
+        typeName += "8";
+
+    return typeName;
+
+}// TypeData::toNumpyMemoryString
+
+
 /*!
  * Determine the maximum floating point value this TypeData can hold
  * \return the maximum floating point value of this TypeData
@@ -488,7 +620,7 @@ double TypeData::extractDouble(const std::string& string, bool* ok)
  * \param parent is the hierarchical name of the parent object
  * \param supported indicates what the protocol can support
  */
-ProtocolField::ProtocolField(ProtocolParser* parse, std::string parent, ProtocolSupport supported):
+ProtocolField::ProtocolField(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported):
     Encodable(parse, parent, supported),
     encodedMin(0),
     encodedMax(0),
@@ -499,48 +631,51 @@ ProtocolField::ProtocolField(ProtocolParser* parse, std::string parent, Protocol
     hasVerifyMaxValue(false),
     verifyMaxValue(0),
     limitMaxValue(0),
+    limitFormat(noLimits),
     checkConstant(false),
     overridesPrevious(false),
     isOverriden(false),
-    inMemoryType(supported),
-    encodedType(supported),
+    inMemoryType(support),
+    encodedType(support),
     prevField(0),
     hidden(false),
     neverOmit(false),
     mapOptions(MAP_BOTH)
 {
-    attriblist = {"name",
-                  "title",
-                  "inMemoryType",
-                  "encodedType",
-                  "struct",
-                  "max",
-                  "min",
-                  "scaler",
-                  "printscaler",
-                  "array",
-                  "variableArray",
-                  "array2d",
-                  "variable2dArray",
-                  "dependsOn",
-                  "dependsOnValue",
-                  "dependsOnCompare",
-                  "enum",
-                  "default",
-                  "constant",
-                  "checkConstant",
-                  "comment",
-                  "Units",
-                  "Range",
-                  "Notes",
-                  "bitfieldGroup",
-                  "hidden",
-                  "neverOmit",
-                  "initialValue",
-                  "verifyMinValue",
-                  "verifyMaxValue",
-                  "map",
-                  "limitOnEncode"};
+    static const AttributeNames names({"name",
+                                        "title",
+                                        "inMemoryType",
+                                        "encodedType",
+                                        "struct",
+                                        "max",
+                                        "min",
+                                        "scaler",
+                                        "printscaler",
+                                        "array",
+                                        "variableArray",
+                                        "array2d",
+                                        "variable2dArray",
+                                        "dependsOn",
+                                        "dependsOnValue",
+                                        "dependsOnCompare",
+                                        "enum",
+                                        "default",
+                                        "constant",
+                                        "checkConstant",
+                                        "comment",
+                                        "Units",
+                                        "Range",
+                                        "Notes",
+                                        "bitfieldGroup",
+                                        "hidden",
+                                        "neverOmit",
+                                        "initialValue",
+                                        "verifyMinValue",
+                                        "verifyMaxValue",
+                                        "map",
+                                        "limitOnEncode",
+                                        "span"});
+    attriblist = &names;
 }
 
 
@@ -578,20 +713,128 @@ void ProtocolField::clear(void)
     initialValueStringForDisplay.clear();
     verifyMinStringForDisplay.clear();
     verifyMaxStringForDisplay.clear();
-    limitMinString.clear();
-    limitMinStringForComment.clear();
     limitMinValue = 0;
     hasVerifyMinValue = false;
     verifyMinValue = 0;
-    limitMaxString.clear();
-    limitMaxStringForComment.clear();
     limitMaxValue = 0;
+    limitFormat = noLimits;
     hasVerifyMaxValue = false;
     verifyMaxValue = 0;
 
 }// ProtocolField::clear
 
 
+/*!
+ * Save the parsed field to a precompiled library. The previous field is not
+ * saved, the structure that owns the field saves which one it is.
+ * \param writer receives the data
+ */
+void ProtocolField::save(CacheWriter& writer) const
+{
+    Encodable::save(writer);
+    writer.write(encodedMin);
+    writer.write(encodedMax);
+    writer.write(scaler);
+    writer.write(maxString);
+    writer.write(minString);
+    writer.write(scalerString);
+    writer.write(printScalerString);
+    writer.write(readScalerString);
+    writer.write(defaultString);
+    writer.write(defaultStringForDisplay);
+    writer.write(constantString);
+    writer.write(constantStringForDisplay);
+    writer.write(initialValueString);
+    writer.write(initialValueStringForDisplay);
+    writer.write(verifyMinString);
+    writer.write(verifyMinStringForDisplay);
+    writer.write(hasVerifyMinValue);
+    writer.write(verifyMinValue);
+    writer.write(limitMinValue);
+    writer.write(verifyMaxString);
+    writer.write(verifyMaxStringForDisplay);
+    writer.write(hasVerifyMaxValue);
+    writer.write(verifyMaxValue);
+    writer.write(limitMaxValue);
+    writer.write((int64_t)limitFormat);
+    writer.write(checkConstant);
+    writer.write(overridesPrevious);
+    writer.write(isOverriden);
+    inMemoryType.save(writer);
+    encodedType.save(writer);
+    bitfieldData.save(writer);
+
+    writer.write((int64_t)extraInfoNames.size());
+    for(std::size_t i = 0; i < extraInfoNames.size(); i++)
+    {
+        writer.write(extraInfoNames.at(i));
+        writer.write(extraInfoValues.at(i));
+    }
+
+    writer.write(hidden);
+    writer.write(neverOmit);
+    writer.write((int64_t)mapOptions);
+
+}// ProtocolField::save
+
+
+/*!
+ * Load the parsed field from a precompiled library, in place of parse()
+ * \param reader supplies the data written by save()
+ * \return true if the field was loaded
+ */
+bool ProtocolField::load(CacheReader& reader)
+{
+    clear();
+
+    Encodable::load(reader);
+    encodedMin = reader.readDouble();
+    encodedMax = reader.readDouble();
+    scaler = reader.readDouble();
+    maxString = reader.readString();
+    minString = reader.readString();
+    scalerString = reader.readString();
+    printScalerString = reader.readString();
+    readScalerString = reader.readString();
+    defaultString = reader.readString();
+    defaultStringForDisplay = reader.readString();
+    constantString = reader.readString();
+    constantStringForDisplay = reader.readString();
+    initialValueString = reader.readString();
+    initialValueStringForDisplay = reader.readString();
+    verifyMinString = reader.readString();
+    verifyMinStringForDisplay = reader.readString();
+    hasVerifyMinValue = reader.readBool();
+    verifyMinValue = reader.readDouble();
+    limitMinValue = reader.readDouble();
+    verifyMaxString = reader.readString();
+    verifyMaxStringForDisplay = reader.readString();
+    hasVerifyMaxValue = reader.readBool();
+    verifyMaxValue = reader.readDouble();
+    limitMaxValue = reader.readDouble();
+    limitFormat = (LimitFormat)reader.readInt();
+    checkConstant = reader.readBool();
+    overridesPrevious = reader.readBool();
+    isOverriden = reader.readBool();
+    inMemoryType.load(reader);
+    encodedType.load(reader);
+    bitfieldData.load(reader);
+
+    for(int64_t count = reader.readInt(); (count > 0) && reader.isGood(); count--)
+    {
+        extraInfoNames.push_back(reader.readString());
+        extraInfoValues.push_back(reader.readString());
+    }
+
+    hidden = reader.readBool();
+    neverOmit = reader.readBool();
+    mapOptions = (int)reader.readInt();
+
+    return reader.isGood();
+
+}// ProtocolField::load
+
+
 //! Provide the pointer to a previous encodable in the list
 void ProtocolField::setPreviousEncodable(Encodable* prev)
 {
@@ -1044,7 +1287,7 @@ void ProtocolField::parse(void)
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
     // We use name as part of our debug outputs, so its good to have it first.
     name = ProtocolParser::getAttribute("name", map);
@@ -1058,6 +1301,11 @@ void ProtocolField::parse(void)
     else if(ProtocolParser::isFieldClear("limitOnEncode", map))
         support.limitonencode = false;
 
+    if(ProtocolParser::isFieldSet("span", map))
+        support.span = true;
+    else if(ProtocolParser::isFieldClear("span", map))
+        support.span = false;
+
     title = ProtocolParser::getAttribute("title", map);
     memoryTypeString = ProtocolParser::getAttribute("inMemoryType", map);
     encodedTypeString = ProtocolParser::getAttribute("encodedType", map);
@@ -1696,7 +1944,7 @@ void ProtocolField::parse(void)
     }
 
     // Just the type data
-    typeName = inMemoryType.toTypeString(support.prefix + structName);
+    typeName = inMemoryType.toTypeString(support.prefix() + structName);
 
     if(!constantString.empty())
     {
@@ -1716,60 +1964,33 @@ void ProtocolField::parse(void)
         limitMinValue = encodedMin;
         limitMaxValue = encodedMax;
 
+        // Integer scaling is interesting. Imagine the case where we encode
+        // in a signed16 number with a scaler of 8. Hence the largest value
+        // after decode will be 32767/8 = 4095.875. However if the in-Memory
+        // type is an integer then this will truncate to 4095, therefore use
+        // of the trunc() function
         if(isFloatScaling())
-        {
-            limitMaxString = getNumberString(limitMaxValue, encodedType.bits);
-            limitMinString = getNumberString(limitMinValue, encodedType.bits);
-            limitMaxStringForComment = getNumberString(limitMaxValue);
-            limitMinStringForComment = getNumberString(limitMinValue);
-        }
+            limitFormat = floatLimits;
         else
-        {
-            // Integer scaling is interesting. Imagine the case where we encode
-            // in a signed16 number with a scaler of 8. Hence the largest value
-            // after decode will be 32767/8 = 4095.875. However if the in-Memory
-            // type is an integer then this will truncate to 4095, therefore use
-            // of the trunc() function
-            if(limitMaxValue >= 0)
-                limitMaxStringForComment = limitMaxString = std::to_string((uint64_t)trunc(limitMaxValue));
-            else
-                limitMaxStringForComment = limitMaxString = std::to_string((int64_t)trunc(limitMaxValue));
-
-            if(limitMinValue >= 0)
-                limitMinStringForComment = limitMinString = std::to_string((uint64_t)trunc(limitMinValue));
-            else
-                limitMinStringForComment = limitMinString = std::to_string((int64_t)trunc(limitMinValue));
-        }
+            limitFormat = truncatedLimits;
     }
     else if(encodedType.isFloat)
     {
         limitMinValue = encodedType.getMinimumFloatValue()/scaler;
         limitMaxValue = encodedType.getMaximumFloatValue()/scaler;
-        limitMaxString = getNumberString(limitMaxValue, encodedType.bits);
-        limitMinString = getNumberString(limitMinValue, encodedType.bits);
-        limitMaxStringForComment = getNumberString(limitMaxValue);
-        limitMinStringForComment = getNumberString(limitMinValue);
+        limitFormat = floatLimits;
     }
     else
     {
         limitMinValue = (double)encodedType.getMinimumIntegerValue();
         limitMaxValue = (double)encodedType.getMaximumIntegerValue();
-
-        if(limitMaxValue >= 0)
-            limitMaxStringForComment = limitMaxString = std::to_string((uint64_t)round(limitMaxValue));
-        else
-            limitMaxStringForComment = limitMaxString = std::to_string((int64_t)round(limitMaxValue));
-
-        if(limitMinValue >= 0)
-            limitMinStringForComment = limitMinString = std::to_string((uint64_t)round(limitMinValue));
-        else
-            limitMinStringForComment = limitMinString = std::to_string((int64_t)round(limitMinValue));
+        limitFormat = roundedLimits;
     }
 
     // Now handle the verify maximum value
     if(toLower(verifyMaxString) == "auto")
     {
-        verifyMaxString = limitMaxString;
+        verifyMaxString = getLimitString(limitMaxValue);
         hasVerifyMaxValue = true;
     }
     else if(!verifyMaxString.empty())
@@ -1781,7 +2002,7 @@ void ProtocolField::parse(void)
     // Now handle the verify minimum value
     if(toLower(verifyMinString) == "auto")
     {
-        verifyMinString = limitMinString;
+        verifyMinString = getLimitString(limitMinValue);
         hasVerifyMinValue = true;
     }
     else if(!verifyMinString.empty())
@@ -1802,6 +2023,11 @@ void ProtocolField::parse(void)
     minString = handleNumericConstants(minString);
     scalerString = handleNumericConstants(scalerString);
 
+    // Variable length arrays in memory can be spans of arena storage
+    span = support.span && isArray() && !is2dArray() && !variableArray.empty() &&
+           !inMemoryType.isNull && !inMemoryType.isString && !inMemoryType.isBitfield &&
+           !encodedType.isNull && defaultString.empty() && constantString.empty() && !overridesPrevious;
+
     // Compute the data length
     computeEncodedLength();
 
@@ -1815,7 +2041,7 @@ void ProtocolField::parse(void)
  * \param input is the input string, which may be modified
  * \return a documentation version of input
  */
-std::string ProtocolField::handleNumericConstants(std::string& input) const
+std::string ProtocolField::handleNumericConstants(InternedString& input) const
 {
     if(input.empty())
         return input;
@@ -1832,7 +2058,9 @@ std::string ProtocolField::handleNumericConstants(std::string& input) const
         // numeric values so the code which uses this string will compile. We
         // cannot do this replacement without first knowing input is a number,
         // otherwise we'll just be screwing up the name of something
-        ShuntingYard::replacePie(input);
+        std::string replaced = input;
+        ShuntingYard::replacePie(replaced);
+        input = replaced;
 
         // For the display string we replace the symbol "pi" with the
         // appropriate value for html outputs
@@ -2029,6 +2257,8 @@ std::string ProtocolField::getDeclaration(void) const
 
     if(inMemoryType.isBitfield)
         output += " : " + std::to_string(inMemoryType.bits);
+    else if(span)
+        output = "    " + typeName + "* " + name;
     else if(is2dArray())
         output += "[" + array + "][" + array2d + "]";
     else if(isArray())
@@ -2048,6 +2278,14 @@ std::string ProtocolField::getDeclaration(void) const
             output += ". Field is encoded constant.";
     }
 
+    if(span)
+    {
+        if(comment.empty())
+            output += " //!< Span of up to " + array + " elements.";
+        else
+            output += ". Span of up to " + array + " elements.";
+    }
+
     output += "\n";
 
     return output;
@@ -3104,6 +3342,83 @@ std::string ProtocolField::getMapEncodeString(void) const
 }// ProtocolField::getMapEncodeString
 
 
+/*!
+ * Get the string used to append this field to the columns of a table. Each
+ * value goes in a column of its in-memory type, except scaled values which
+ * are double precision. Enumerations with a label lookup also get a column
+ * of labels.
+ * \return the string used to append this field, which may be empty
+ */
+std::string ProtocolField::getColumnAppendString(void) const
+{
+    std::string output;
+
+    // Nothing to append if nothing is in memory or if not encoded
+    if(inMemoryType.isNull || encodedType.isNull)
+        return output;
+
+    if(inMemoryType.isStruct)
+    {
+        // The structure must be one of ours, with something in memory
+        const ProtocolStructureModule* struc = parser->lookUpStructure(typeName);
+        if((struc == nullptr) || (struc->getNumberOfDecodeParameters() == 0))
+            return output;
+    }
+
+    if(!comment.empty())
+        output += TAB_IN + "// " + comment + "\n";
+
+    if(inMemoryType.isStruct)
+    {
+        output += getColumnStructureCode(typeName);
+        return output;
+    }
+
+    std::string access = getColumnFieldAccess(name);
+    std::string column = "_pg_table.next(PgColumn::";
+    std::string key = getColumnKey() + ")";
+
+    std::vector<std::string> present, absent;
+
+    if(inMemoryType.isString)
+        present.push_back(column + "Utf8, _pg_prename, " + key + ".appendString(" + access + ");");
+    else if(!printScalerString.empty())
+        present.push_back(column + "Float64, _pg_prename, " + key + ".appendDouble((double)" + access + printScalerString + ");");
+    else if(inMemoryType.isFloat && (inMemoryType.bits > 32))
+        present.push_back(column + "Float64, _pg_prename, " + key + ".appendDouble(" + access + ");");
+    else if(inMemoryType.isFloat)
+        present.push_back(column + "Float32, _pg_prename, " + key + ".appendFloat(" + access + ");");
+    else if(inMemoryType.isBool)
+        present.push_back(column + "Bool, _pg_prename, " + key + ".appendBool(" + access + " != 0);");
+    else if(inMemoryType.isSigned || inMemoryType.isEnum)
+        present.push_back(column + "Int64, _pg_prename, " + key + ".appendInt((int64_t)" + access + ");");
+    else
+        present.push_back(column + "UInt64, _pg_prename, " + key + ".appendUInt((uint64_t)" + access + ");");
+
+    // The type of the column is the text between "::" and the first ','
+    std::size_t start = present.front().find("::") + 2;
+    absent.push_back(column + present.front().substr(start, present.front().find(',') - start) + ", _pg_prename, " + key + ".appendNull();");
+
+    // The label of an enumeration, if it can be looked up
+    if(inMemoryType.isEnum)
+    {
+        const EnumCreator* creator = parser->lookUpEnumeration(inMemoryType.enumName);
+        if((creator != nullptr) && creator->hasLabelLookup())
+        {
+            std::string labelkey = "\":" + name + ":label\"" + key.substr(key.find('"', 1) + 1);
+
+            present.push_back(column + "Utf8, _pg_prename, " + labelkey + ".appendString(" + creator->getName() + "_EnumLabel((int)" + access + "));");
+            absent.push_back(column + "Utf8, _pg_prename, " + labelkey + ".appendNull();");
+        }
+    }
+
+    output += getColumnElementCode(present, absent);
+
+    return output;
+
+}// ProtocolField::getColumnAppendString
+
+
 /*!
  * Get the string used for extracting this field from a map.
  * \return the string used to read this field as text, which may be empty
@@ -3255,6 +3570,16 @@ std::string ProtocolField::getSetInitialValueString(bool isStructureMember) cons
     if(inMemoryType.isNull)
         return output;
 
+    // A span has no storage to initialize until it is decoded. In C++ we
+    // explicitly initialize all members, so the span starts out empty.
+    if(span)
+    {
+        if(support.language != ProtocolSupport::c_language)
+            output += TAB_IN + name + "(NULL),\n";
+
+        return output;
+    }
+
     if(inMemoryType.isStruct)
     {
         // In C++ the constructor is the initializer
@@ -3332,9 +3657,9 @@ std::string ProtocolField::getSetInitialValueString(bool isStructureMember) cons
                         // encoded value we should initialize to
                         // respect those values
                         if(limitMaxValue < 0)
-                            initial = limitMaxString;
+                            initial = getLimitString(limitMaxValue);
                         else if(limitMinValue > 0)
-                            initial = limitMinString;
+                            initial = getLimitString(limitMinValue);
                         else
                             initial = "0";
 
@@ -3601,6 +3926,44 @@ bool ProtocolField::usesDecodeTempLongBitfield(void) const
 }
 
 
+/*!
+ * Get the text of a limit value. The limits are kept as numbers, and written
+ * as text only when code or documentation needs them.
+ * \param value is limitMinValue or limitMaxValue
+ * \param forComment should be true for the text used in comments, which
+ *        does not depend on the precision of the encoding
+ * \return the text of the limit value, empty if the limits were not computed
+ */
+std::string ProtocolField::getLimitString(double value, bool forComment) const
+{
+    switch(limitFormat)
+    {
+    default:
+    case noLimits:
+        return std::string();
+
+    case floatLimits:
+        if(forComment)
+            return getNumberString(value);
+        else
+            return getNumberString(value, encodedType.bits);
+
+    case truncatedLimits:
+        if(value >= 0)
+            return std::to_string((uint64_t)trunc(value));
+        else
+            return std::to_string((int64_t)trunc(value));
+
+    case roundedLimits:
+        if(value >= 0)
+            return std::to_string((uint64_t)round(value));
+        else
+            return std::to_string((int64_t)round(value));
+    }
+
+}// ProtocolField::getLimitString
+
+
 /*!
  * Create a comment, with no leading white space, but including a line feed,
  * that documents the encoded range of this field. The encoded range will
@@ -3613,12 +3976,12 @@ std::string ProtocolField::getRangeComment(bool limitonencode) const
     std::string minstring, maxstring;
 
     if((limitonencode == false) || verifyMaxString.empty() || (hasVerifyMaxValue && (verifyMaxValue >= limitMaxValue)))
-        maxstring = limitMaxStringForComment;
+        maxstring = getLimitString(limitMaxValue, true);
     else
         maxstring = verifyMaxString;
 
     if((limitonencode == false) || verifyMinString.empty() || (hasVerifyMinValue && (verifyMinValue <= limitMinValue)))
-        minstring = limitMinStringForComment;
+        minstring = getLimitString(limitMinValue, true);
     else
         minstring = verifyMinString;
 
@@ -3635,9 +3998,37 @@ std::string ProtocolField::getRangeComment(bool limitonencode) const
  */
 std::string ProtocolField::getLimitedArgument(std::string argument) const
 {
+    std::string minstring, maxstring;
+
+    getEncodeLimits(minstring, maxstring);
+
+    if(minstring.empty() && maxstring.empty())
+        return argument;
+    else if(minstring.empty())
+        return "limitMax(" + argument + ", " + maxstring + ")";
+    else if(maxstring.empty())
+        return "limitMin(" + argument + ", " + minstring + ")";
+    else
+        return "limitBoth(" + argument + ", " + minstring + ", " + maxstring + ")";
+
+}// ProtocolField::getLimitedArgument
+
+
+/*!
+ * Determine the limits that must be applied to the in-memory value before it
+ * is encoded. Scaled encodings limit themselves, so they only have limits if
+ * the user asked for tighter limits.
+ * \param minstring receives the lower limit, or is cleared if there is none
+ * \param maxstring receives the upper limit, or is cleared if there is none
+ */
+void ProtocolField::getEncodeLimits(std::string& minstring, std::string& maxstring) const
+{
+    minstring.clear();
+    maxstring.clear();
+
     // Boolean is handled specially, because it is only ever 1 bit (true or false), but the in-memory size is more than 1 bit
     if(inMemoryType.isBool)
-        return argument;
+        return;
 
     // If scaling is active the scaling functions will apply encoding
     // limits. The same thing will happen with the conversion to smaller
@@ -3656,23 +4047,19 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
             if(!skipmin && hasVerifyMinValue && (verifyMinValue <= limitMinValue))
                 skipmin = true;
 
-            if(skipmin && skipmax)
-                return argument;
+            if(!skipmin)
+                minstring = verifyMinString;
 
-            if(skipmin)
-                argument = "limitMax(" + argument + ", " + verifyMaxString + ")";
-            else if(skipmax)
-                argument = "limitMin(" + argument + ", " + verifyMinString + ")";
-            else
-                argument = "limitBoth(" + argument + ", " + verifyMinString + ", " + verifyMaxString + ")";
+            if(!skipmax)
+                maxstring = verifyMaxString;
 
         }// if user asked for specific encode limiting
 
     }// if scaling is going on
     else
     {
-        std::string minstring = limitMinString;
-        std::string maxstring = limitMaxString;
+        std::string minlimit = getLimitString(limitMinValue);
+        std::string maxlimit = getLimitString(limitMaxValue);
         double minvalue = limitMinValue;
         double maxvalue = limitMaxValue;
         bool skipmin = true;
@@ -3682,7 +4069,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
         if(!hasVerifyMaxValue && !verifyMaxString.empty() && support.limitonencode)
         {
             // In this case we cannot vet the user's verify string, we just have to use it
-            maxstring = verifyMaxString;
+            maxlimit = verifyMaxString;
             skipmax = false;
 
         }// if we cannot evaluate the verify value
@@ -3691,7 +4078,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
             if(hasVerifyMaxValue && support.limitonencode && (verifyMaxValue < limitMaxValue))
             {
                 maxvalue = verifyMaxValue;
-                maxstring = verifyMaxString;
+                maxlimit = verifyMaxString;
             }
 
             // Now check if this max value is less than the in-Memory maximum. If it is then we must apply the max limit. We allow one lsb of fiddle.
@@ -3704,7 +4091,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
         if(!hasVerifyMinValue && !verifyMinString.empty() && support.limitonencode)
         {
             // In this case we cannot vet the user's verify string, we just have to use it
-            minstring = verifyMinString;
+            minlimit = verifyMinString;
             skipmin = false;
 
         }// if we cannot evaluate the verify value
@@ -3713,7 +4100,7 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
             if(hasVerifyMinValue && support.limitonencode && (verifyMinValue > limitMinValue))
             {
                 minvalue = verifyMinValue;
-                minstring = verifyMinString;
+                minlimit = verifyMinString;
             }
 
             // Now check if this min value is more than the in-Memory minimum. If it is then we must apply the min limit. We allow one lsb of fiddle.
@@ -3722,21 +4109,15 @@ std::string ProtocolField::getLimitedArgument(std::string argument) const
 
         }// else if we can evaluate the verify value
 
-        if(skipmin && skipmax)
-            return argument;
+        if(!skipmin)
+            minstring = minlimit;
 
-        if(skipmin)
-            argument = "limitMax(" + argument + ", " + maxstring + ")";
-        else if(skipmax)
-            argument = "limitMin(" + argument + ", " + minstring + ")";
-        else
-            argument = "limitBoth(" + argument + ", " + minstring + ", " + maxstring + ")";
+        if(!skipmax)
+            maxstring = maxlimit;
 
     }// else if not scaling
 
-    return argument;
-
-}// ProtocolField::getLimitedArgument
+}// ProtocolField::getEncodeLimits
 
 
 /*!
@@ -4368,6 +4749,9 @@ std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) c
         spacing += TAB_IN;
     }
 
+    if(isStructureMember)
+        output += getSpanAllocationCode(spacing);
+
     // The array iteration code
     output += getDecodeArrayIterationCode(spacing, isStructureMember);
 
@@ -4383,12 +4767,23 @@ std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) c
 
     if(support.language == ProtocolSupport::c_language)
     {
-        output += spacing + "if(decode" + typeName + "(_pg_data, &_pg_byteindex, " + access + ") == 0)\n";
+        const ProtocolStructure* struc = parser->lookUpStructure(typeName);
+
+        // A structure with spans draws their storage from our arena
+        if((struc != nullptr) && struc->hasSpans())
+            output += spacing + "if(decode" + typeName + "(_pg_data, &_pg_byteindex, " + access + ", _pg_arena) == 0)\n";
+        else
+            output += spacing + "if(decode" + typeName + "(_pg_data, &_pg_byteindex, " + access + ") == 0)\n";
         output += spacing + TAB_IN + "return 0;\n";
     }
     else
     {
         const ProtocolStructure* struc = parser->lookUpStructure(typeName);
+        std::string arena;
+
+        // A structure with spans draws their storage from our arena
+        if((struc != nullptr) && struc->hasSpans())
+            arena = ", _pg_arena";
 
         if((struc != nullptr) && (typeName != struc->getStructName()))
         {
@@ -4399,14 +4794,14 @@ std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) c
             // interfaces between here and the data we are going to touch.
             /// TODO: is there a better way? A very complex topic...
             if(isStructureMember || isArray())
-                output += spacing + "if((static_cast<" + typeName + "*>(&" + access + "))->decode(_pg_data, &_pg_byteindex) == false)\n";
+                output += spacing + "if((static_cast<" + typeName + "*>(&" + access + "))->decode(_pg_data, &_pg_byteindex" + arena + ") == false)\n";
             else
-                output += spacing + "if((static_cast<" + typeName + "*>(" + access + "))->decode(_pg_data, &_pg_byteindex) == false)\n";
+                output += spacing + "if((static_cast<" + typeName + "*>(" + access + "))->decode(_pg_data, &_pg_byteindex" + arena + ") == false)\n";
         }
         else if(isStructureMember || isArray())
-            output += spacing + "if(" + access + ".decode(_pg_data, &_pg_byteindex) == false)\n";
+            output += spacing + "if(" + access + ".decode(_pg_data, &_pg_byteindex" + arena + ") == false)\n";
         else
-            output += spacing + "if(" + access + "->decode(_pg_data, &_pg_byteindex) == false)\n";
+            output += spacing + "if(" + access + "->decode(_pg_data, &_pg_byteindex" + arena + ") == false)\n";
 
         output += spacing + TAB_IN + "return false;\n";
     }
@@ -4419,6 +4814,133 @@ std::string ProtocolField::getDecodeStringForStructure(bool isStructureMember) c
 }// ProtocolField::getDecodeStringForStructure
 
 
+/*!
+ * Determine if decoding this field draws storage from an arena, either
+ * because the field is a span, or because it is a structure with spans
+ * \param isStructureMember should be true if this field is decoded into a structure
+ * \return true if the decode needs an arena
+ */
+bool ProtocolField::usesArena(bool isStructureMember) const
+{
+    if(encodedType.isNull)
+        return false;
+
+    if(span && isStructureMember)
+        return true;
+
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructure* structure = parser->lookUpStructure(typeName);
+        return (structure != nullptr) && structure->hasSpans();
+    }
+
+    return false;
+
+}// ProtocolField::usesArena
+
+
+/*!
+ * Get the most arena storage that decoding this field can use, as an
+ * expression for the C compiler
+ * \return the storage expression, empty if no storage is used
+ */
+std::string ProtocolField::getSpanStorageString(void) const
+{
+    std::string nested;
+
+    if(encodedType.isNull)
+        return std::string();
+
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructure* structure = parser->lookUpStructure(typeName);
+        if((structure != nullptr) && structure->hasSpans())
+            nested = structure->getMaxSpanStorageString();
+    }
+
+    return combineSpanStorage(nested);
+
+}// ProtocolField::getSpanStorageString
+
+
+/*!
+ * Determine if the encoded bytes of this field are the same as its in-memory
+ * bytes, so a scatter gather encode can point at the field rather than copy
+ * it. This is true for one dimensional arrays of bytes that are encoded
+ * without scaling, limiting, or conversion. Larger types are not included,
+ * because their in-memory byte order depends on the machine.
+ * \return true if this field can be sent without copying
+ */
+bool ProtocolField::isZeroCopy(void) const
+{
+    if(inMemoryType.isNull || encodedType.isNull)
+        return false;
+
+    if(!isArray() || is2dArray())
+        return false;
+
+    if(inMemoryType.isStruct || inMemoryType.isString || inMemoryType.isBitfield || encodedType.isBitfield ||
+       inMemoryType.isBool || inMemoryType.isEnum || inMemoryType.isFloat || encodedType.isFloat)
+        return false;
+
+    if((inMemoryType.bits != 8) || (encodedType.bits != 8) || (inMemoryType.isSigned != encodedType.isSigned))
+        return false;
+
+    if(!constantString.empty() || !defaultString.empty() || !dependsOn.empty() || overridesPrevious)
+        return false;
+
+    if(isFloatScaling() || isIntegerScaling())
+        return false;
+
+    // Limits on encode would change the bytes
+    std::string minstring, maxstring;
+    getEncodeLimits(minstring, maxstring);
+
+    return minstring.empty() && maxstring.empty();
+
+}// ProtocolField::isZeroCopy
+
+
+/*!
+ * Get the code that points an iovec entry at the in-memory bytes of this
+ * field, after adding an entry for any bytes already encoded in the scratch
+ * buffer. A variable length array is sent up to its length.
+ * \param isStructureMember should be true if this field is a member of a user structure
+ * \return the code, which is empty if this field cannot be sent without copying
+ */
+std::string ProtocolField::getIovEncodeString(bool isStructureMember) const
+{
+    std::string output;
+
+    if(!isZeroCopy())
+        return output;
+
+    std::string access = name;
+    std::string length = array;
+
+    if(isStructureMember && (support.language == ProtocolSupport::c_language))
+        access = "_pg_user->" + name;
+
+    if(!variableArray.empty())
+    {
+        std::string count = "(unsigned)" + getEncodeFieldAccess(isStructureMember, variableArray);
+        length = "((" + count + " < " + array + ") ? " + count + " : " + array + ")";
+    }
+
+    if(!comment.empty())
+        output += TAB_IN + "// " + comment + "\n";
+
+    output += TAB_IN + "// " + name + " is sent from memory, after the bytes encoded before it\n";
+    output += TAB_IN + "if(!appendIov(_pg_iov, _pg_maxiov, &_pg_numiov, _pg_data + _pg_start, (size_t)(_pg_byteindex - _pg_start)) ||\n";
+    output += TAB_IN + "   !appendIov(_pg_iov, _pg_maxiov, &_pg_numiov, " + access + ", (size_t)" + length + "))\n";
+    output += TAB_IN + TAB_IN + "return 0;\n";
+    output += TAB_IN + "_pg_start = _pg_byteindex;\n";
+
+    return output;
+
+}// ProtocolField::getIovEncodeString
+
+
 /*!
  * Look for a constantValue, in order of preference:
  * 1. constantValue
@@ -4882,6 +5404,9 @@ std::string ProtocolField::getDecodeStringForField(bool isBigEndian, bool isStru
     }// If nothing in-memory
     else
     {
+        if(isStructureMember)
+            output += getSpanAllocationCode(spacing);
+
         output += getDecodeArrayIterationCode(spacing, isStructureMember);
 
         // Array spacing
@@ -5135,3 +5660,505 @@ std::string ProtocolField::getDisplayNumberString(double number)
         return string;
     }
 }
+
+
+/*!
+ * Return the reason this field has no fixed layout for a NumPy dtype
+ * \return the reason, or an empty string if the field can be described by a dtype
+ */
+std::string ProtocolField::getNumpyIncompatibility(void) const
+{
+    if(encodedType.isNull)
+        return std::string();
+
+    std::vector<int> dimensions;
+
+    if(!getNumpyArrayDimensions(dimensions))
+        return "field " + name + " does not have a fixed array length";
+
+    if(!dependsOn.empty())
+        return "field " + name + " depends on another field";
+
+    if(!defaultString.empty())
+        return "field " + name + " has a default value, so the encoded length can vary";
+
+    if(overridesPrevious)
+        return "field " + name + " overrides a previous field";
+
+    if(encodedType.isString && !encodedType.isFixedString)
+        return "field " + name + " is a variable length string";
+
+    if(encodedType.isString && (dimensions.size() != 1))
+        return "string " + name + " is not a single fixed length";
+
+    if(encodedType.isBitfield)
+    {
+        // Bitfields are extracted from at most 8 bytes at a time
+        int start = bitfieldData.startingBitCount;
+
+        if(((start + encodedType.bits - 1)/8 - start/8) >= 8)
+            return "bitfield " + name + " spans more than 8 bytes";
+    }
+
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructureModule* structure = parser->lookUpStructure(typeName);
+
+        if(structure == nullptr)
+            return "structure " + typeName + " used by field " + name + " is not defined";
+        else
+            return structure->getNumpyIncompatibility();
+    }
+
+    return std::string();
+
+}// ProtocolField::getNumpyIncompatibility
+
+
+/*!
+ * Return the entries of a NumPy dtype that describe the encoding of this
+ * field. A run of bitfields is described by a single entry holding all of its
+ * bytes, which is output by the last bitfield in the run. Reserved space
+ * (which is not in memory) has no name, so NumPy names it.
+ * \return the dtype entries, one per line
+ */
+std::string ProtocolField::getNumpyDtypeString(void) const
+{
+    if(encodedType.isNull)
+        return std::string();
+
+    if(encodedType.isBitfield)
+    {
+        if(!bitfieldData.lastBitfield)
+            return std::string();
+
+        int bytes = (bitfieldData.startingBitCount + encodedType.bits + 7)/8;
+
+        return TAB_IN + "('" + getNumpyBitfieldRunName() + "', 'u1', (" + std::to_string(bytes) + ",)),\n";
+    }
+
+    std::vector<int> dimensions;
+    getNumpyArrayDimensions(dimensions);
+
+    std::string format;
+
+    if(inMemoryType.isStruct)
+        format = getNumpyStructureName(typeName) + "_dtype";
+    else if(encodedType.isString)
+    {
+        // A fixed string is exactly its array length, which is not a dimension
+        format = "'S" + std::to_string(dimensions.front()) + "'";
+        dimensions.clear();
+    }
+    else
+    {
+        format = encodedType.toNumpyString(support.bigendian);
+
+        // Types without a native NumPy width are decoded from their bytes
+        if(format.empty())
+        {
+            format = "'u1'";
+            dimensions.push_back(encodedType.bits/8);
+        }
+        else
+            format = "'" + format + "'";
+    }
+
+    std::string output = TAB_IN + "('";
+
+    if(!inMemoryType.isNull)
+        output += name;
+
+    output += "', " + format;
+
+    if(!dimensions.empty())
+        output += ", " + getNumpyShapeString(dimensions);
+
+    return output + "),\n";
+
+}// ProtocolField::getNumpyDtypeString
+
+
+/*!
+ * Return the Python code that decodes this field from NumPy records into
+ * columns. The last bitfield in a run decodes all the bitfields of the run.
+ * \return the Python code, which expects "raw" to be the records and "columns"
+ *         to be the dictionary of decoded columns.
+ */
+std::string ProtocolField::getNumpyDecodeString(void) const
+{
+    std::string output;
+    std::string bigendian = support.bigendian ? "True" : "False";
+
+    if(encodedType.isNull)
+        return output;
+
+    if(encodedType.isBitfield)
+    {
+        if(!bitfieldData.lastBitfield)
+            return output;
+
+        std::string bytes = "raw['" + getNumpyBitfieldRunName() + "']";
+
+        // Bitfield groups are swapped as a whole in little endian protocols
+        if(bitfieldData.groupMember && !support.bigendian)
+            bytes += "[..., ::-1]";
+
+        std::vector<const ProtocolField*> run;
+        for(const ProtocolField* field = this; field != nullptr; field = field->prevField)
+        {
+            run.insert(run.begin(), field);
+
+            if(field == getNumpyBitfieldRunStart())
+                break;
+        }
+
+        for(const ProtocolField* field : run)
+        {
+            if(field->inMemoryType.isNull)
+                continue;
+
+            std::string value = "_bits(" + bytes + ", " + std::to_string(field->bitfieldData.startingBitCount) + ", " + std::to_string(field->encodedType.bits) + ")";
+
+            output += TAB_IN + "columns['" + field->name + "'] = " + field->getNumpyScaledString(value) + "\n";
+        }
+
+        return output;
+
+    }// if bitfield
+
+    if(inMemoryType.isNull)
+        return output;
+
+    std::string value = "raw['" + name + "']";
+
+    if(inMemoryType.isStruct)
+        return TAB_IN + "columns['" + name + "'] = decode" + getNumpyStructureName(typeName) + "(" + value + ")\n";
+
+    if(encodedType.isString)
+        return TAB_IN + "columns['" + name + "'] = " + value + "\n";
+
+    // Types without a native NumPy width are assembled from their bytes
+    if(encodedType.toNumpyString(support.bigendian).empty())
+    {
+        if(encodedType.isFloat)
+            value = "_specialFloat(_uint(" + value + ", " + bigendian + "), " + std::to_string(encodedType.bits) + ", " + std::to_string(encodedType.sigbits) + ")";
+        else if(encodedType.isSigned)
+            value = "_int(" + value + ", " + bigendian + ")";
+        else
+            value = "_uint(" + value + ", " + bigendian + ")";
+    }
+
+    return TAB_IN + "columns['" + name + "'] = " + getNumpyScaledString(value) + "\n";
+
+}// ProtocolField::getNumpyDecodeString
+
+
+/*!
+ * Return the Python code that verifies this field in decoded NumPy columns,
+ * which limits the values in the same way as the C verify function.
+ * \return the Python code, which expects "columns" to be the dictionary of
+ *         decoded columns and "good" to be the boolean array of records that
+ *         passed verification.
+ */
+std::string ProtocolField::getNumpyVerifyString(void) const
+{
+    if(encodedType.isNull || inMemoryType.isNull || inMemoryType.isBool || inMemoryType.isString)
+        return std::string();
+
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructureModule* structure = parser->lookUpStructure(typeName);
+
+        if((structure != nullptr) && structure->hasVerify())
+            return TAB_IN + "verify" + getNumpyStructureName(typeName) + "(columns['" + name + "'], good)\n";
+        else
+            return std::string();
+    }
+
+    if(!hasVerifyMinValue && !hasVerifyMaxValue)
+        return std::string();
+
+    std::string low = hasVerifyMinValue ? getNumpyNumberString(verifyMinValue) : "None";
+    std::string high = hasVerifyMaxValue ? getNumpyNumberString(verifyMaxValue) : "None";
+
+    return TAB_IN + "columns['" + name + "'] = _limit(columns['" + name + "'], " + low + ", " + high + ", good)\n";
+
+}// ProtocolField::getNumpyVerifyString
+
+
+/*!
+ * Return the reason this field cannot be described by a table codec
+ * descriptor. Only the encodings the table codec interpreter knows are
+ * supported. Array and dependsOn references are checked by the structure
+ * that holds the field, since they refer to its other fields.
+ * \return the reason, or an empty string if the field can be described
+ */
+std::string ProtocolField::getDescriptorIncompatibility(void) const
+{
+    // Fields which are not encoded are not in the descriptor
+    if(encodedType.isNull)
+        return std::string();
+
+    if(encodedType.isBitfield)
+        return "field " + name + " is a bitfield";
+
+    if(!defaultString.empty())
+        return "field " + name + " has a default value";
+
+    if(overridesPrevious)
+        return "field " + name + " overrides a previous field";
+
+    if(inMemoryType.isString)
+    {
+        if(!constantString.empty() || checkConstant || inMemoryType.isNull)
+            return "string " + name + " is constant";
+
+        if(is2dArray() || !variableArray.empty() || !dependsOn.empty())
+            return "string " + name + " has a variable length or is conditional";
+
+        return std::string();
+    }
+
+    if(inMemoryType.isStruct)
+    {
+        const ProtocolStructureModule* structure = parser->lookUpStructure(typeName);
+
+        if((structure == nullptr) || !structure->isTableDriven())
+            return "structure " + typeName + " used by field " + name + " is not table driven";
+
+        return std::string();
+    }
+
+    if(encodedType.isFloat && ((encodedType.bits < 32) || (scaler != 1.0)))
+        return "field " + name + " uses a special or scaled floating point encoding";
+
+    if(isIntegerScaling())
+        return "field " + name + " uses integer scaling";
+
+    // The descriptor holds constants and limits as pgfloat_t, which must represent them exactly
+    if(!support.float64 && ((encodedType.bits > 24) || (!inMemoryType.isFloat && (inMemoryType.bits > 24))))
+    {
+        std::string minstring, maxstring;
+
+        if(constantString.empty())
+            getEncodeLimits(minstring, maxstring);
+
+        if(!constantString.empty() || !minstring.empty() || !maxstring.empty())
+            return "field " + name + " has constants or limits that need double precision";
+    }
+
+    return std::string();
+
+}// ProtocolField::getDescriptorIncompatibility
+
+
+/*!
+ * Return the entry of a table codec descriptor that describes this field
+ * \param structure is the name of the in-memory structure that holds the field
+ * \param length is the index of the descriptor entry that gives the array length, or -1
+ * \param depends is the index of the descriptor entry this field depends on, or -1
+ * \return the pgfield_t initializer for this field, without line feed
+ */
+std::string ProtocolField::getDescriptorEntryString(const std::string& structure, int length, int depends) const
+{
+    std::string offset = "0";
+    std::string size = "0";
+    std::string count = "1";
+    std::string memory;
+    std::string encoding;
+    std::string flags;
+    std::string descriptor = "NULL";
+    std::string min = "0";
+    std::string scale = "1";
+    std::string limitmin = "0";
+    std::string limitmax = "0";
+    int bytes = encodedType.bits/8;
+
+    if(isArray())
+    {
+        count = array;
+
+        if(is2dArray())
+            count = "(" + array + ")*(" + array2d + ")";
+    }
+
+    if(!isNotInMemory())
+    {
+        offset = "offsetof(" + structure + ", " + name + ")";
+        size = "sizeof(" + typeName + ")";
+    }
+
+    if(inMemoryType.isNull)
+        memory = "PG_MEMORY_NONE";
+    else if(inMemoryType.isStruct)
+        memory = "PG_MEMORY_STRUCT";
+    else if(inMemoryType.isString)
+        memory = "PG_MEMORY_STRING";
+    else if(inMemoryType.isBool)
+        memory = "PG_MEMORY_BOOL";
+    else if(inMemoryType.isFloat)
+        memory = "PG_MEMORY_FLOAT";
+    else if(inMemoryType.isSigned || inMemoryType.isEnum)
+        memory = "PG_MEMORY_SIGNED";
+    else
+        memory = "PG_MEMORY_UNSIGNED";
+
+    if(inMemoryType.isStruct)
+    {
+        encoding = "PG_ENCODING_STRUCT";
+        descriptor = "&descriptor" + typeName;
+        bytes = 0;
+    }
+    else if(inMemoryType.isString)
+    {
+        encoding = "PG_ENCODING_STRING";
+        bytes = 0;
+
+        if(inMemoryType.isFixedString)
+            flags = "PG_FIELD_FIXED";
+    }
+    else
+    {
+        std::string constantstring = getConstantString();
+
+        if(encodedType.isFloat)
+            encoding = "PG_ENCODING_FLOAT";
+        else if(isFloatScaling())
+        {
+            if(encodedType.isSigned)
+                encoding = "PG_ENCODING_SSCALED";
+            else
+            {
+                encoding = "PG_ENCODING_USCALED";
+                min = getNumberString(encodedMin, inMemoryType.bits);
+            }
+
+            scale = getNumberString(scaler, inMemoryType.bits);
+
+            // Same precision as the generated scaling function
+            if((inMemoryType.bits > 32) && support.float64)
+                flags = "PG_FIELD_FLOAT64";
+        }
+        else if(encodedType.isSigned)
+            encoding = "PG_ENCODING_SIGNED";
+        else
+            encoding = "PG_ENCODING_UNSIGNED";
+
+        if((bytes > 1) && support.bigendian)
+            flags += std::string(flags.empty() ? "" : " | ") + "PG_FIELD_BIGENDIAN";
+
+        // Constants replace the in-memory value and are never limited
+        if(!constantstring.empty())
+        {
+            flags += std::string(flags.empty() ? "" : " | ") + "PG_FIELD_CONSTANT";
+            limitmin = constantstring;
+
+            if(checkConstant && (!inMemoryType.isNull || array.empty()))
+                flags += " | PG_FIELD_CHECK";
+        }
+        else
+        {
+            std::string minstring, maxstring;
+
+            getEncodeLimits(minstring, maxstring);
+
+            if(!minstring.empty())
+            {
+                flags += std::string(flags.empty() ? "" : " | ") + "PG_FIELD_LIMITMIN";
+                limitmin = minstring;
+            }
+
+            if(!maxstring.empty())
+            {
+                flags += std::string(flags.empty() ? "" : " | ") + "PG_FIELD_LIMITMAX";
+                limitmax = maxstring;
+            }
+        }
+    }
+
+    if(flags.empty())
+        flags = "0";
+
+    return "{" + offset + ", " + count + ", " + size + ", " + memory + ", " + encoding + ", " + std::to_string(bytes) + ", " + flags + ", " +
+           std::to_string(length) + ", " + std::to_string(depends) + ", " + descriptor + ", " + min + ", " + scale + ", " + limitmin + ", " + limitmax + "}";
+
+}// ProtocolField::getDescriptorEntryString
+
+
+/*!
+ * Return the Python expression that converts an encoded value to the in
+ * memory value, applying the same scaling as the C decode function.
+ * \param value is the Python expression for the encoded value
+ * \return the Python expression for the in memory value
+ */
+std::string ProtocolField::getNumpyScaledString(const std::string& value) const
+{
+    std::string memory = inMemoryType.toNumpyMemoryString();
+    std::string inverse = getNumpyNumberString(1.0/scaler);
+
+    if(inMemoryType.isBool)
+        return "(" + value + " != 0)";
+    else if(encodedType.isFloat)
+    {
+        if(scaler != 1.0)
+            return "(" + value + "*" + inverse + ").astype(" + memory + ")";
+        else
+            return value + ".astype(" + memory + ", copy=False)";
+    }
+    else if(isFloatScaling())
+    {
+        // Match the precision of the C scaling function, which is float32
+        // unless the value needs (and the protocol supports) float64
+        bool float64 = support.float64 && ((encodedType.isBitfield ? encodedType.bits : inMemoryType.bits) > 32);
+        std::string type = float64 ? "np.float64" : "np.float32";
+        std::string scaled = type + "(1.0)/" + type + "(" + getNumpyNumberString(scaler) + ")*" + value + ".astype(" + type + ")";
+
+        // Unsigned encodings are offset by the minimum
+        if(!encodedType.isSigned)
+            scaled = type + "(" + getNumpyNumberString(encodedMin) + ") + " + scaled;
+
+        return "(" + scaled + ").astype(" + memory + ")";
+    }
+    else if(isIntegerScaling())
+    {
+        std::string minimum = std::to_string((int64_t)round(encodedMin));
+        std::string divisor = std::to_string((int64_t)round(scaler));
+
+        if(encodedType.isSigned)
+            return "_divide(" + value + ", " + divisor + ").astype(" + memory + ")";
+        else if(scaler == 1.0)
+            return "(" + minimum + " + " + value + ".astype(np.int64)).astype(" + memory + ")";
+        else
+            return "(" + minimum + " + _divide(" + value + ", " + divisor + ")).astype(" + memory + ")";
+    }
+    else
+        return value + ".astype(" + memory + ", copy=False)";
+
+}// ProtocolField::getNumpyScaledString
+
+
+/*!
+ * Return the first bitfield in the run of bitfields that includes this field
+ * \return the first field of the run, which may be this field
+ */
+const ProtocolField* ProtocolField::getNumpyBitfieldRunStart(void) const
+{
+    const ProtocolField* field = this;
+
+    while((field->bitfieldData.startingBitCount > 0) && (field->prevField != nullptr) && field->prevField->isBitfield())
+        field = field->prevField;
+
+    return field;
+}
+
+
+/*!
+ * Return the name of the NumPy dtype entry that holds the bytes of the run of
+ * bitfields that includes this field
+ * \return the entry name, which is based on the first field of the run
+ */
+std::string ProtocolField::getNumpyBitfieldRunName(void) const
+{
+    return "_" + getNumpyBitfieldRunStart()->name + "_bits";
+}
@@ -9,15 +9,18 @@ class TypeData
 {
 public:
 
-    //! Construct empty type data
-    TypeData(ProtocolSupport sup);
-
-    //! Construct type data by copying another type
-    TypeData(const TypeData& that);
+    //! Construct empty type data, the protocol support must outlive the type data
+    TypeData(const ProtocolSupport& sup);
 
     //! Reset all members to default except the protocol support
     void clear(void);
 
+    //! Save the type data to a precompiled library
+    void save(CacheWriter& writer) const;
+
+    //! Load the type data from a precompiled library
+    void load(CacheReader& reader);
+
 public:
     bool isBool;        //!< true if type is a 'bool'
     bool isStruct;      //!< true if this is an externally defined struct
@@ -31,7 +34,7 @@ public:
     int bits;           //!< number of bits used by type
     int sigbits;        //!< number of bits for the significand of a float16 or float24
     int enummax;        //!< maximum value of the enumeration if isEnum is true
-    std::string enumName;   //! Name of the enumerated type, empty if not enumerated type
+    InternedString enumName;//!< Name of the enumerated type, empty if not enumerated type
 
     //! Create the type string
     std::string toTypeString(const std::string& structName = std::string()) const;
@@ -39,6 +42,12 @@ public:
     //! Determine the signature of this field (for example uint8).
     std::string toSigString(void) const;
 
+    //! Determine the NumPy dtype string of this type when encoded (for example >u2)
+    std::string toNumpyString(bool bigendian) const;
+
+    //! Determine the NumPy type used for this type in memory (for example np.uint16)
+    std::string toNumpyMemoryString(void) const;
+
     //! Determine the maximum floating point value this TypeData can hold
     double getMaximumFloatValue(void) const;
 
@@ -62,7 +71,8 @@ public:
 
 private:
 
-    ProtocolSupport support;
+    //! Protocol support of the field that owns this type data. This is a pointer rather than a copy since every field has two type datas
+    const ProtocolSupport* support;
 };
 
 
@@ -90,6 +100,12 @@ public:
         lastBitfield = true;
     }
 
+    //! Save the bitfield data to a precompiled library
+    void save(CacheWriter& writer) const;
+
+    //! Load the bitfield data from a precompiled library
+    void load(CacheReader& reader);
+
     int startingBitCount;   //!< The starting bit count for this field if a bitfield
     int groupBits;          //!< number of bits in the bitfield group, same for all members
     bool groupStart;        //!< true if this bitfield starts a group
@@ -112,7 +128,7 @@ public:
     };
 
     //! Construct a field, setting the protocol name and name prefix
-    ProtocolField(ProtocolParser* parse, std::string parent, ProtocolSupport supported);
+    ProtocolField(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported);
 
     //! Provide the pointer to a previous encodable in the list
     void setPreviousEncodable(Encodable* prev) override;
@@ -132,6 +148,18 @@ public:
     //! Parse the DOM element
     void parse(void) override;
 
+    //! Save the parsed field to a precompiled library
+    void save(CacheWriter& writer) const override;
+
+    //! Load the parsed field from a precompiled library
+    bool load(CacheReader& reader) override;
+
+    //! Return the previous protocol field, which this field's bitfield follows
+    const ProtocolField* getPreviousField(void) const {return prevField;}
+
+    //! Set the previous protocol field, when the field is loaded instead of parsed
+    void setPreviousField(ProtocolField* prev) {prevField = prev;}
+
     //! Check names against the list of C keywords
     void checkAgainstKeywords(void) override;
 
@@ -222,6 +250,39 @@ public:
     //! Get the string used for map decoding this field
     std::string getMapDecodeString(void) const override;
 
+    //! Get the string used to append this field to the columns of a table
+    std::string getColumnAppendString(void) const override;
+
+    //! Return the reason this field has no fixed layout for a NumPy dtype, empty if it has one
+    std::string getNumpyIncompatibility(void) const override;
+
+    //! Return the entries of a NumPy dtype that describe the encoding of this field
+    std::string getNumpyDtypeString(void) const override;
+
+    //! Return the Python code that decodes this field from NumPy records into columns
+    std::string getNumpyDecodeString(void) const override;
+
+    //! Return the Python code that verifies this field in decoded NumPy columns
+    std::string getNumpyVerifyString(void) const override;
+
+    //! Return the reason this field cannot be described by a table codec descriptor, empty if it can
+    std::string getDescriptorIncompatibility(void) const override;
+
+    //! Return the entry of a table codec descriptor that describes this field
+    std::string getDescriptorEntryString(const std::string& structure, int length, int depends) const override;
+
+    //! True if decoding this field draws storage from an arena
+    bool usesArena(bool isStructureMember) const override;
+
+    //! Return the most arena storage that decoding this field can use, empty if none
+    std::string getSpanStorageString(void) const override;
+
+    //! True if the encoded bytes of this field are its in-memory bytes, so it can be sent without copying
+    bool isZeroCopy(void) const override;
+
+    //! Return the code that points an iovec entry at the in-memory bytes of this field
+    std::string getIovEncodeString(bool isStructureMember) const override;
+
     //! Return the string that sets this encodable to its initial value in code
     std::string getSetInitialValueString(bool isStructureMember) const override;
 
@@ -290,6 +351,15 @@ public:
 
 protected:
 
+    //! The ways the limit values are written as text
+    enum LimitFormat
+    {
+        noLimits,           //!< The limits have not been computed, they are written empty
+        floatLimits,        //!< Floating point numbers, with the precision of the encoding
+        truncatedLimits,    //!< Integers, truncated toward zero
+        roundedLimits       //!< Integers, rounded to the nearest
+    };
+
     //! Minimum encoded value (as a number), used by scaling routines for unsigned encodings
     double encodedMin;
 
@@ -300,43 +370,43 @@ protected:
     double scaler;
 
     //! String providing the maximum encoded value
-    std::string maxString;
+    InternedString maxString;
 
     //! String providing the minimum encoded value
-    std::string minString;
+    InternedString minString;
 
     //! String providing the scaler from in-Memory to encoded
-    std::string scalerString;
+    InternedString scalerString;
 
     //! The string used to multiply the in-memory type to compare and print to text
-    std::string printScalerString;
+    InternedString printScalerString;
 
     //! The string used to divide the in-memory type to read from text
-    std::string readScalerString;
+    InternedString readScalerString;
 
     //! String giving the default value to use if the packet is too short
-    std::string defaultString;
+    InternedString defaultString;
 
     //! String giving the default value for documentation purposes only
-    std::string defaultStringForDisplay;
+    InternedString defaultStringForDisplay;
 
     //! String giving the constant value to use on encoding
-    std::string constantString;
+    InternedString constantString;
 
     //! String giving the constant value for documentation purposes only
-    std::string constantStringForDisplay;
+    InternedString constantStringForDisplay;
 
     //! The string used in the set to defaults function
-    std::string initialValueString;
+    InternedString initialValueString;
 
     //! The string used in the set to defaults function, for documentation purposes only
-    std::string initialValueStringForDisplay;
+    InternedString initialValueStringForDisplay;
 
     //! The string used to verify the value on the low side
-    std::string verifyMinString;
+    InternedString verifyMinString;
 
     //! The string used to verify the value on the low side, for documentation purposes only
-    std::string verifyMinStringForDisplay;
+    InternedString verifyMinStringForDisplay;
 
     //! Flag if we know the verify min value
     bool hasVerifyMinValue;
@@ -347,17 +417,11 @@ protected:
     //! The minimum value of the encoding, or the verifyMin value, whichever is min
     double limitMinValue;
 
-    //! The string for the limit min value
-    std::string limitMinString;
-
-    //! The string for the limit min value used in comments
-    std::string limitMinStringForComment;
-
     //! The string used to verify the value on the high side
-    std::string verifyMaxString;
+    InternedString verifyMaxString;
 
     //! The string used to verify the value on the high side, for documentation purposes only
-    std::string verifyMaxStringForDisplay;
+    InternedString verifyMaxStringForDisplay;
 
     //! Flag if we know the verify max value
     bool hasVerifyMaxValue;
@@ -368,11 +432,8 @@ protected:
     //! The maximum value of the encoding, or the verifyMax value, whichever is less
     double limitMaxValue;
 
-    //! The string for the limit max value
-    std::string limitMaxString;
-
-    //! The string for the limit max value used in comments
-    std::string limitMaxStringForComment;
+    //! How limitMinValue and limitMaxValue are written as text
+    LimitFormat limitFormat;
 
     //! Flag to force this the decode function to verify the result against the constant value
     bool checkConstant;
@@ -415,7 +476,7 @@ protected:
     std::string getConstantString() const;
 
     //! Adjust input string for presence of numeric constants "pi" and "e"
-    std::string handleNumericConstants(std::string& input) const;
+    std::string handleNumericConstants(InternedString& input) const;
 
     //! Compute the encoded length string
     void computeEncodedLength(void);
@@ -429,12 +490,18 @@ protected:
     //! Get the ending bitcount for this fields bitfield
     int getEndingBitCount(void){return bitfieldData.startingBitCount + encodedType.bits;}
 
+    //! Get the text of a limit value, for code or for comments
+    std::string getLimitString(double value, bool forComment = false) const;
+
     //! Get the comment that describes the encoded range
     std::string getRangeComment(bool limitonencode = false) const;
 
     //! Determine if an argument should be passed to the limiting macro
     std::string getLimitedArgument(std::string argument) const;
 
+    //! Determine the limits that must be applied to the in-memory value before it is encoded
+    void getEncodeLimits(std::string& minstring, std::string& maxstring) const;
+
     //! Get the next lines(s) of source coded needed to encode a bitfield field
     std::string getEncodeStringForBitfield(int* bitcount, bool isStructureMember) const;
 
@@ -468,6 +535,15 @@ protected:
     //! Check to see if we should be doing integer scaling on this field
     bool isIntegerScaling(void) const;
 
+    //! Return the Python expression that converts an encoded value to the in memory value
+    std::string getNumpyScaledString(const std::string& value) const;
+
+    //! Return the first bitfield in the run of bitfields that includes this field
+    const ProtocolField* getNumpyBitfieldRunStart(void) const;
+
+    //! Return the name of the NumPy dtype entry that holds the bytes of this field's bitfield run
+    std::string getNumpyBitfieldRunName(void) const;
+
 };
 
 #endif // PROTOCOLFIELD_H
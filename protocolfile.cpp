@@ -2,8 +2,11 @@
 #include "protocolparser.h"
 #include <fstream>
 #include <filesystem>
+#include <cstring>
 
 std::string ProtocolFile::tempprefix = "temporarydeleteme_";
+std::map<std::string, std::string> ProtocolFile::temporaryfiles;
+std::map<std::string, std::unordered_set<std::string>> ProtocolFile::temporaryonces;
 
 /*!
  * Create the file object
@@ -11,9 +14,10 @@ std::string ProtocolFile::tempprefix = "temporarydeleteme_";
  * \param supported are the Protocol-wide options.
  * \param temp should be true for this file to be a temp file
  */
-ProtocolFile::ProtocolFile(const std::string& moduleName, ProtocolSupport supported, bool temp) :
+ProtocolFile::ProtocolFile(const std::string& moduleName, const ProtocolSupport& supported, bool temp) :
     support(supported),
     module(moduleName),
+    lastinclude(std::string::npos),
     dirty(false),
     appending(false),
     temporary(temp)
@@ -26,8 +30,9 @@ ProtocolFile::ProtocolFile(const std::string& moduleName, ProtocolSupport suppor
  * or a file will not be created
  * \param supported are the Protocol-wide options.
  */
-ProtocolFile::ProtocolFile(ProtocolSupport supported) :
+ProtocolFile::ProtocolFile(const ProtocolSupport& supported) :
     support(supported),
+    lastinclude(std::string::npos),
     dirty(false),
     appending(false),
     temporary(true)
@@ -71,6 +76,10 @@ void ProtocolFile::setModuleNameAndPath(std::string prefix, std::string name, st
 
     // This will see if the file already exists and will setup the initial output
     prepareToAppend();
+
+    // Existing contents were not written through write(), so index them now
+    if(appending)
+        indexIncludeDirectives();
 }
 
 
@@ -147,6 +156,9 @@ void ProtocolFile::separateModuleNameAndPath(std::string& name, std::string& fil
 void ProtocolFile::clear()
 {
     contents.clear();
+    onces.clear();
+    includes.clear();
+    lastinclude = std::string::npos;
     dirty = false;
     appending = false;
 }
@@ -159,27 +171,84 @@ void ProtocolFile::clear()
  */
 void ProtocolFile::write(const std::string& text)
 {
+    std::size_t start = contents.size();
+
     contents += text;
     dirty = true;
+
+    // Index from the start of the line, in case the text completes an include directive
+    if(start > 0)
+    {
+        start = contents.rfind('\n', start - 1);
+        if(start < contents.size())
+            start++;
+        else
+            start = 0;
+    }
+
+    indexIncludeDirectives(start);
 }
 
 
 /*!
  * Append to the contents of the file, not including any prologue/epilogue.
  * This will mark the file as dirty, which will cause it to be flushed to disk
- * on destruction. The append will only take place if `text` does not already
- * appear in the file contents.
+ * on destruction. The append will only take place if `text` has not already
+ * been written to this file with writeOnce().
  * \param text is the information to append
  */
 void ProtocolFile::writeOnce(const std::string& text)
 {
-    if(contents.find(text) >= contents.size())
+    // The record of text is kept across appends, so we never search the contents
+    if(onces.insert(text).second)
     {
         write(text);
     }
 }
 
 
+/*!
+ * Index all the include directives in the current contents. This is needed
+ * when the contents change other than by appending to them.
+ */
+void ProtocolFile::indexIncludeDirectives(void)
+{
+    includes.clear();
+    lastinclude = std::string::npos;
+    indexIncludeDirectives(0);
+}
+
+
+/*!
+ * Index the include directives in the contents starting at a specific
+ * location. Each directive is remembered up to the closing quote or bracket,
+ * so writeIncludeDirective() can check for it without searching the contents.
+ * \param start is the location in the contents to start searching from
+ */
+void ProtocolFile::indexIncludeDirectives(std::size_t start)
+{
+    for(std::size_t index = contents.find("#include", start); index < contents.size(); index = contents.find("#include", index + 1))
+    {
+        lastinclude = index;
+
+        // The directive we output is "#include " followed by a quoted or bracketed name
+        std::size_t open = index + 9;
+        if((open >= contents.size()) || (contents.at(open - 1) != ' '))
+            continue;
+
+        std::size_t close = std::string::npos;
+        if(contents.at(open) == '"')
+            close = contents.find('"', open + 1);
+        else if(contents.at(open) == '<')
+            close = contents.find('>', open + 1);
+
+        if(close < contents.size())
+            includes.insert(contents.substr(index, close + 1 - index));
+    }
+
+}// ProtocolFile::indexIncludeDirectives
+
+
 /*!
  * Output multiple include directives. The include directives are all done
  * using quotes, not global brackes
@@ -229,9 +298,11 @@ void ProtocolFile::writeIncludeDirective(const std::string& include, const std::
         directive = "#include <" + directive + ">";
 
     // See if this include directive is already present, in which case we don't need to add it again
-    if(contains(contents, directive, true))
+    if(includes.count(directive) > 0)
         return;
 
+    includes.insert(directive);
+
     // Add the comment if there is one
     if(comment.empty())
         directive += "\n";
@@ -239,14 +310,14 @@ void ProtocolFile::writeIncludeDirective(const std::string& include, const std::
         directive += "\t// " + comment + "\n";
 
     // We try to group all the #includes together
-    std::size_t index = contents.rfind("#include");
-    if(index < contents.size())
+    if(lastinclude < contents.size())
     {
         // Find the end of the line
-        index = contents.find("\n", index);
-        if(index >= 0)
+        std::size_t index = contents.find("\n", lastinclude);
+        if(index < contents.size())
         {
             contents.insert(index+1, directive);
+            lastinclude = index+1;
             dirty = true;
             return;
         }
@@ -400,56 +471,217 @@ void ProtocolFile::makeFileWritable(const std::string& fileName)
 
 
 /*!
- * Copy a temporary file to the real file and delete the temporary file
+ * Copy a temporary file to the real file and delete the temporary file. The
+ * temporary file is held in memory, the real file is only written if its
+ * contents are different from the temporary file.
  * \param path is the path to the files
  * \param fileName is the real file name, which does not include the temporary prefix
  */
 void ProtocolFile::copyTemporaryFile(const std::string& path, const std::string& fileName)
 {
-    bool equal = false;
-    std::string tempFileName = path + tempprefix + fileName;
-    std::string permFileName = path + fileName;
-
-    // Open the temporary file
-    std::fstream tempfile(tempFileName, std::ios_base::in);
+    std::map<std::string, std::string>::iterator it = temporaryfiles.find(temporaryKey(path + fileName));
 
     // Its possible we already copied and deleted the file, so this isn't an error
-    if(!tempfile.is_open())
+    if(it == temporaryfiles.end())
         return;
 
-    // Open the permanent file
-    std::fstream permfile(permFileName, std::ios_base::in);
+    writeFileIfDifferent(path + fileName, it->second);
 
-    // Check if the files are the same
-    if(permfile.is_open())
+    // Done with the temporary contents
+    temporaryonces.erase(it->first);
+    temporaryfiles.erase(it);
+
+}// ProtocolFile::copyTemporaryFile
+
+
+/*!
+ * Discard all temporary files which have not been copied to the real files.
+ * This is used when the generator runs more than once in the same process, so
+ * a run that failed part way cannot leave contents behind for the next run.
+ */
+void ProtocolFile::discardTemporaryFiles(void)
+{
+    temporaryfiles.clear();
+    temporaryonces.clear();
+}
+
+
+/*!
+ * Determine if a temporary file has contents which have not been copied to
+ * the real file yet
+ * \param fileName is the real file name, including the path
+ * \return true if the temporary file has contents
+ */
+bool ProtocolFile::isTemporaryFile(const std::string& fileName)
+{
+    return temporaryfiles.count(temporaryKey(fileName)) > 0;
+}
+
+
+/*!
+ * Determine if the contents of a file on disk are exactly equal to some data.
+ * The file size is checked first, then the file is compared a block at a time
+ * so we can stop at the first difference.
+ * \param fileName identifies the file relative to the current working directory
+ * \param data is the data to compare against the file
+ * \return true if the file exists and its contents are equal to data
+ */
+bool ProtocolFile::isFileContentsEqual(const std::string& fileName, const std::string& data)
+{
+    std::error_code ec;
+
+    // Windows text mode changes the line endings, so the size on disk is not
+    // the size of the data. Everywhere else a size mismatch is definitive.
+    #ifndef _WIN32
+    std::uintmax_t size = std::filesystem::file_size(fileName, ec);
+    if(ec || (size != data.size()))
+        return false;
+    #endif
+
+    std::fstream file(fileName, std::ios_base::in);
+
+    if(!file.is_open())
+        return false;
+
+    char buffer[8192];
+    std::size_t index = 0;
+
+    while(file)
     {
-        // Real all file bytes into a string, notice parentheses to deal with "most vexing parse problem"
-        std::string tempdata((std::istreambuf_iterator<char>(tempfile)), std::istreambuf_iterator<char>());
-        std::string permdata((std::istreambuf_iterator<char>(permfile)), std::istreambuf_iterator<char>());
+        file.read(buffer, sizeof(buffer));
+        std::size_t count = (std::size_t)file.gcount();
 
-        if(tempdata == permdata)
-            equal = true;
+        if((count > data.size() - index) || (data.compare(index, count, buffer, count) != 0))
+            return false;
 
-        permfile.close();
+        index += count;
     }
 
-    // Done with the file contents
-    tempfile.close();
+    // Equal only if we consumed all of the data
+    return (index == data.size());
 
-    if(equal)
+}// ProtocolFile::isFileContentsEqual
+
+
+/*!
+ * Write data to a file, but only if the file contents are different. This
+ * prevents unneeded rebuilds of a project that uses the generated files. The
+ * data are written to a temporary file which is then renamed, so the real file
+ * is never partially written.
+ * \param fileName identifies the file relative to the current working directory
+ * \param data is the complete contents of the file
+ * \return false if the file could not be written, else true
+ */
+bool ProtocolFile::writeFileIfDifferent(const std::string& fileName, const std::string& data)
+{
+    if(isFileContentsEqual(fileName, data))
+        return true;
+
+    std::error_code ec;
+    std::filesystem::path filepath(fileName);
+
+    // Make sure the path exists
+    if(filepath.has_parent_path())
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+
+    std::string tempFileName = (filepath.parent_path() / (tempprefix + filepath.filename().string())).string();
+
+    // Open the file for write
+    std::fstream file(tempFileName, std::ios_base::out);
+
+    if(!file.is_open())
     {
-        // If the two file contents are the same, delete the temporary
-        // file, leave the original file unchanged
+        std::cerr << "error: failed to open " << fileName << std::endl;
+        return false;
+    }
+
+    file << data;
+    file.close();
+
+    if(file.fail())
+    {
+        std::cerr << "error: failed to write " << fileName << std::endl;
         deleteFile(tempFileName);
+        return false;
     }
-    else
+
+    // Rename replaces the original file in one step. That can fail if the
+    // original is read-only (on Windows), in which case fall back to deleting it
+    std::filesystem::rename(tempFileName, fileName, ec);
+    if(ec)
+        renameFile(tempFileName, fileName);
+
+    return true;
+
+}// ProtocolFile::writeFileIfDifferent
+
+
+/*!
+ * Replace a file with a new file that has been written to disk, but only if
+ * the file contents are different. This is writeFileIfDifferent() for output
+ * that is streamed to a file rather than held in memory. The two files are
+ * compared a block at a time, if they are the same the new file is deleted,
+ * otherwise it is renamed to replace the file.
+ * \param fileName identifies the file relative to the current working directory
+ * \param newFileName identifies the new contents of the file
+ * \return false if the file could not be replaced, else true
+ */
+bool ProtocolFile::replaceFileIfDifferent(const std::string& fileName, const std::string& newFileName)
+{
+    std::error_code ec;
+    bool equal = false;
+
+    std::uintmax_t size = std::filesystem::file_size(fileName, ec);
+    if(!ec && (size == std::filesystem::file_size(newFileName, ec)) && !ec)
     {
-        // else if the file contents are different, delete the original
-        // file and rename the temp file to be the original file
-        renameFile(tempFileName, permFileName);
+        std::fstream file(fileName, std::ios_base::in | std::ios_base::binary);
+        std::fstream newfile(newFileName, std::ios_base::in | std::ios_base::binary);
+
+        char buffer[8192];
+        char newbuffer[8192];
+
+        equal = file.is_open() && newfile.is_open();
+
+        while(equal && file && newfile)
+        {
+            file.read(buffer, sizeof(buffer));
+            newfile.read(newbuffer, sizeof(newbuffer));
+
+            equal = (file.gcount() == newfile.gcount()) && (std::memcmp(buffer, newbuffer, (std::size_t)file.gcount()) == 0);
+        }
     }
 
-}// ProtocolFile::copyTemporaryFile
+    if(equal)
+    {
+        deleteFile(newFileName);
+        return true;
+    }
+
+    std::filesystem::rename(newFileName, fileName, ec);
+    if(ec)
+        renameFile(newFileName, fileName);
+
+    if(!std::filesystem::exists(fileName, ec))
+    {
+        std::cerr << "error: failed to write " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+
+}// ProtocolFile::replaceFileIfDifferent
+
+
+/*!
+ * Return the key used to identify a temporary file in memory. The key is
+ * the normalized file name, so different spellings of the same path match.
+ * \param fileName is the file name including the path
+ * \return the key for the temporary file map
+ */
+std::string ProtocolFile::temporaryKey(const std::string& fileName)
+{
+    return std::filesystem::path(fileName).lexically_normal().string();
+}
 
 
 /*!
@@ -475,18 +707,79 @@ ProtocolFile::~ProtocolFile()
 
 
 /*!
- * \return the the correct on disk name. This name will include the temporary
- *         prefix if needed
+ * \return the the correct on disk name, which does not include the temporary
+ *         prefix, since temporary files are held in memory
  */
 std::string ProtocolFile::fileNameAndPathOnDisk(void) const
 {
-    if(temporary)
-        return path + tempprefix+fileName();
-    else
-        return path + fileName();
+    return path + fileName();
 }
 
 
+/*!
+ * Read the existing contents of this file. Temporary files are read from
+ * memory, otherwise the file is read from disk.
+ * \return true if the file already exists and `contents` was loaded
+ */
+bool ProtocolFile::readExistingContents(void)
+{
+    if(temporary)
+    {
+        std::map<std::string, std::string>::const_iterator it = temporaryfiles.find(temporaryKey(fileNameAndPathOnDisk()));
+
+        if(it == temporaryfiles.end())
+            return false;
+
+        contents = it->second;
+        onces = temporaryonces[it->first];
+        return true;
+    }
+
+    std::error_code ec;
+
+    if(!std::filesystem::exists(fileNameAndPathOnDisk(), ec))
+        return false;
+
+    std::fstream file(fileNameAndPathOnDisk(), std::ios_base::in);
+
+    if(!file.is_open())
+    {
+        std::cerr << "Failed to open " << fileName() << " for append" << std::endl;
+        return false;
+    }
+
+    // Read the entire file, and store as existing text string data
+    contents = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Close the file, we don't need it anymore
+    file.close();
+
+    return true;
+
+}// ProtocolFile::readExistingContents
+
+
+/*!
+ * Store the complete file text. Temporary files are stored in memory until
+ * copyTemporaryFile() is called, other files are written to disk if changed.
+ * \param data is the complete text of the file, including any prologue/epilogue
+ * \return true if the data were stored
+ */
+bool ProtocolFile::storeContents(const std::string& data)
+{
+    if(temporary)
+    {
+        std::string key = temporaryKey(fileNameAndPathOnDisk());
+        temporaryfiles[key] = data;
+        temporaryonces[key] = onces;
+        return true;
+    }
+
+    return writeFileIfDifferent(fileNameAndPathOnDisk(), data);
+
+}// ProtocolFile::storeContents
+
+
 /*!
  * Write the file to disc, including any prologue/epilogue
  * \return true if the file is written, else there is a problem opening\overwriting the file
@@ -504,26 +797,9 @@ bool ProtocolFile::flush(void)
         return false;
     }
 
-    std::error_code ec;
-
-    // Make sure the path exists
-    if(!path.empty())
-        std::filesystem::create_directories(path, ec);
-
-    // Open the file for write
-    std::fstream file(fileNameAndPathOnDisk(), std::ios_base::out);
-
-    if(!file.is_open())
-    {
-        std::cerr << "error: failed to open " << fileName() << std::endl;
-        return false;
-    }
-
     // The actual interesting contents
-    file << contents;
-
-    // And the file
-    file.close();
+    if(!storeContents(contents))
+        return false;
 
     // Empty our data
     clear();
@@ -556,6 +832,9 @@ void ProtocolHeaderFile::setFileComment(const std::string& comment)
 
     replaceinplace(contents, match, filecomment);
 
+    // The includes may have moved
+    indexIncludeDirectives();
+
 }// ProtocolHeaderFile::setFileComment
 
 
@@ -596,29 +875,9 @@ bool ProtocolHeaderFile::flush(void)
         return false;
     }
 
-    std::error_code ec;
-
-    // Make sure the path exists
-    if(!path.empty())
-        std::filesystem::create_directories(path, ec);
-
-    // Open the file for write
-    std::fstream file(fileNameAndPathOnDisk(), std::ios_base::out);
-
-    if(!file.is_open())
-    {
-        std::cerr << "Failed to open " << fileName() << std::endl;
+    // The actual interesting contents, and close the file out
+    if(!storeContents(contents + getClosingStatement()))
         return false;
-    }
-
-    // The actual interesting contents
-    file << contents;
-
-    // close the file out
-    file << getClosingStatement();
-
-    // And the file
-    file.close();
 
     // Empty our data
     clear();
@@ -656,25 +915,9 @@ std::string ProtocolHeaderFile::getClosingStatement(void)
  * removed so append can be performed
  */
 void ProtocolHeaderFile::prepareToAppend(void)
-{    
-    std::error_code ec;
-
-    if(std::filesystem::exists(fileNameAndPathOnDisk(), ec))
+{
+    if(readExistingContents())
     {
-        std::fstream file(fileNameAndPathOnDisk(), std::ios_base::in);
-
-        if(!file.is_open())
-        {
-            std::cerr << "Failed to open " << fileName() << " for append" << std::endl;
-            return;
-        }
-
-        // Read the entire file, and store as existing text string data
-        contents = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-        // Close the file, we don't need it anymore
-        file.close();
-
         // Remove the trailing closing statement from the file so we can append further stuff
         size_t index = contents.rfind(getClosingStatement());
         if(index < contents.size())
@@ -691,9 +934,9 @@ void ProtocolHeaderFile::prepareToAppend(void)
         // Tag for what generated the file
         write("// " + fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + "\n\n");
 
-        if (!support.licenseText.empty())
+        if (!support.getLicenseText().empty())
         {
-            write(support.licenseText);
+            write(support.getLicenseText());
             makeLineSeparator();
         }
 
@@ -765,29 +1008,9 @@ bool ProtocolSourceFile::flush(void)
         return false;
     }
 
-    std::error_code ec;
-
-    // Make sure the path exists
-    if(!path.empty())
-        std::filesystem::create_directories(path, ec);
-
-    // Open the file for write
-    std::fstream file(fileNameAndPathOnDisk(), std::ios_base::out);
-
-    if(!file.is_open())
-    {
-        std::cerr << "Failed to open " << fileName() << std::endl;
+    // The actual interesting contents, and close the file out
+    if(!storeContents(contents + getClosingStatement()))
         return false;
-    }
-
-    // The actual interesting contents
-    file << contents;
-
-    // close the file out
-    file << getClosingStatement();
-
-    // And the file
-    file.close();
 
     // Empty our data
     clear();
@@ -818,24 +1041,8 @@ std::string ProtocolSourceFile::getClosingStatement(void)
  */
 void ProtocolSourceFile::prepareToAppend(void)
 {
-    std::error_code ec;
-
-    if(std::filesystem::exists(fileNameAndPathOnDisk(), ec))
+    if(readExistingContents())
     {
-        std::fstream file(fileNameAndPathOnDisk(), std::ios_base::in);
-
-        if(!file.is_open())
-        {
-            std::cerr << "Failed to open " << fileName() << " for append" << std::endl;
-            return;
-        }
-
-        // Read the entire file, and store as existing text string data 
-        contents = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-        // Close the file, we don't need it anymore
-        file.close();
-
         // Remove the trailing closing statement from the file so we can append further stuff
         size_t index = contents.rfind(getClosingStatement());
         if(index < contents.size())
@@ -852,9 +1059,9 @@ void ProtocolSourceFile::prepareToAppend(void)
         // Tag for what generated the file
         write("// " + fileName() + " was generated by ProtoGen version " + ProtocolParser::genVersion + "\n\n");
 
-        if (!support.licenseText.empty())
+        if (!support.getLicenseText().empty())
         {
-            write(support.licenseText);
+            write(support.getLicenseText());
             makeLineSeparator();
         }
 
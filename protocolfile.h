@@ -4,16 +4,18 @@
 #include "protocolsupport.h"
 #include <vector>
 #include <string>
+#include <map>
+#include <unordered_set>
 #include <cstdio>
 
 class ProtocolFile
 {
 public:
     //! Construct the protocol file
-    ProtocolFile(const std::string& moduleName, ProtocolSupport supported, bool temporary = true);
+    ProtocolFile(const std::string& moduleName, const ProtocolSupport& supported, bool temporary = true);
 
     //! Construct the protocol file
-    ProtocolFile(ProtocolSupport supported);
+    ProtocolFile(const ProtocolSupport& supported);
 
     //! Destructor that performs the actual file write
     virtual ~ProtocolFile();
@@ -87,6 +89,21 @@ public:
     //! Copy a temporary file to the real file and delete the temporary file
     static void copyTemporaryFile(const std::string& path, const std::string& fileName);
 
+    //! Discard all temporary files which have not been copied
+    static void discardTemporaryFiles(void);
+
+    //! Determine if a temporary file has contents which have not been copied
+    static bool isTemporaryFile(const std::string& fileName);
+
+    //! Determine if the contents of a file on disk are exactly equal to some data
+    static bool isFileContentsEqual(const std::string& fileName, const std::string& data);
+
+    //! Write data to a file, but only if the file contents are different
+    static bool writeFileIfDifferent(const std::string& fileName, const std::string& data);
+
+    //! Replace a file with a new file, but only if the file contents are different
+    static bool replaceFileIfDifferent(const std::string& fileName, const std::string& newFileName);
+
     //! Make sure one blank line at end
     static void makeLineSeparator(std::string& contents);
 
@@ -104,15 +121,39 @@ protected:
     //! Return the correct on disk name
     std::string fileNameAndPathOnDisk(void) const;
 
+    //! Read the existing contents of this file, from memory or disk
+    bool readExistingContents(void);
+
+    //! Store the complete file text, in memory if temporary, else to disk
+    bool storeContents(const std::string& data);
+
+    //! Return the key used to identify a temporary file in memory
+    static std::string temporaryKey(const std::string& fileName);
+
+    //! Index the include directives in the current contents
+    void indexIncludeDirectives(void);
+
+    //! Index the include directives in the contents starting at a specific location
+    void indexIncludeDirectives(std::size_t start);
+
+    //! Contents of temporary files which have been flushed, but not yet copied to disk
+    static std::map<std::string, std::string> temporaryfiles;
+
+    //! Text written with writeOnce() to temporary files which have been flushed
+    static std::map<std::string, std::unordered_set<std::string>> temporaryonces;
+
     ProtocolSupport support;//!< Protocol wide support details
     std::string extension;      //!< The file extension
     std::string path;           //!< Output path for the file
     std::string module;         //!< The module name, not including the file extension
     std::string contents;       //!< The contents, not including the prologue or epilogue
+    std::unordered_set<std::string> onces;      //!< Text that has been written with writeOnce()
+    std::unordered_set<std::string> includes;   //!< Include directives that appear in the contents
+    std::size_t lastinclude;    //!< Location of the last include directive in the contents
 
     bool dirty;             //!< Flag set to indicate that the file contents are dirty and need to be flushed
     bool appending;         //!< Flag set if an append operation is in progress
-    bool temporary;         //!< Flag to indicate this is a temporary file with "temporarydeleteme_" preceding the name
+    bool temporary;         //!< Flag to indicate this is a temporary file which is held in memory until copyTemporaryFile()
 };
 
 
@@ -121,7 +162,7 @@ class ProtocolHeaderFile : public ProtocolFile
 public:
 
     //! Construct the protocol header file
-    ProtocolHeaderFile(ProtocolSupport supported) : ProtocolFile(supported){}
+    ProtocolHeaderFile(const ProtocolSupport& supported) : ProtocolFile(supported){}
 
     //! Write the file to disc, including any prologue/epilogue
     bool flush(void) override;
@@ -147,7 +188,7 @@ class ProtocolSourceFile : public ProtocolFile
 public:
 
     //! Construct the protocol header file
-    ProtocolSourceFile(ProtocolSupport supported) : ProtocolFile(supported){}
+    ProtocolSourceFile(const ProtocolSupport& supported) : ProtocolFile(supported){}
 
     //! Write the file to disc, including any prologue/epilogue
     bool flush(void) override;
@@ -1,6 +1,6 @@
 #include "protocolfloatspecial.h"
 
-ProtocolFloatSpecial::ProtocolFloatSpecial(ProtocolSupport protocolsupport) :
+ProtocolFloatSpecial::ProtocolFloatSpecial(const ProtocolSupport& protocolsupport) :
     header(protocolsupport),
     source(protocolsupport),
     support(protocolsupport)
@@ -30,7 +30,7 @@ bool ProtocolFloatSpecial::generate(std::vector<std::string>& fileNameList, std:
 //! Generate the header file
 bool ProtocolFloatSpecial::generateHeader(void)
 {
-    header.setModuleNameAndPath("floatspecial", support.outputpath);
+    header.setModuleNameAndPath("floatspecial", support.outputpath());
 
 // Raw string magic here
 header.setFileComment(R"(\brief Special routines for floating point manipulation
@@ -91,7 +91,7 @@ return header.flush();
 //! Generate the encode source file
 bool ProtocolFloatSpecial::generateSource(void)
 {
-    source.setModuleNameAndPath("floatspecial", support.outputpath);
+    source.setModuleNameAndPath("floatspecial", support.outputpath());
     source.writeIncludeDirective("math.h", "", true);
     source.makeLineSeparator();
 
@@ -14,7 +14,7 @@
 class ProtocolFloatSpecial
 {
 public:
-    ProtocolFloatSpecial(ProtocolSupport protocolsupport);
+    ProtocolFloatSpecial(const ProtocolSupport& protocolsupport);
 
     //! Perform the generation, writing out the files
     bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
@@ -0,0 +1,126 @@
+#include "protocoliovencode.h"
+
+ProtocolIovEncode::ProtocolIovEncode(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolIovEncode::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//! Generate the header file
+bool ProtocolIovEncode::generateHeader(void)
+{
+    header.setModuleNameAndPath("iovencode", support.outputpath());
+
+// Raw string magic here
+header.setFileComment(R"(\brief Helpers for scatter gather packet encoding
+
+A scatter gather encode fills an array of iovec entries rather than one
+contiguous packet buffer. Fields that must be converted are encoded into
+the packet data buffer, which is used as scratch space, and arrays of bytes
+that are sent as they are in memory get an iovec entry that points at the
+caller's data. The iovec array can then be passed to writev() or sendmsg()
+without copying the large arrays.
+
+The entries only cover the packet data, the caller supplies any packet
+header and checksum, because the data are not contiguous in memory. The
+caller's data must not change until the entries are sent.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("stdint.h", std::string(), true);
+    header.writeIncludeDirective("stddef.h", std::string(), true);
+    header.writeIncludeDirective("sys/uio.h", std::string(), true);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! Add an entry to an iovec array, unless it is empty
+int appendIov(struct iovec* iov, int maxiov, int* numiov, const void* base, size_t length);
+
+//! Return the total number of bytes in an iovec array
+size_t iovLength(const struct iovec* iov, int numiov);
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolIovEncode::generateHeader
+
+
+//! Generate the source file
+bool ProtocolIovEncode::generateSource(void)
+{
+    source.setModuleNameAndPath("iovencode", support.outputpath());
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(/*!
+ * Add an entry to an iovec array. Entries of zero length are not added.
+ * \param iov is the iovec array
+ * \param maxiov is the number of entries in iov
+ * \param numiov is the number of entries used, which is incremented if an entry is added
+ * \param base points to the bytes of the entry
+ * \param length is the number of bytes in the entry
+ * \return 1 if the entry was added (or not needed), 0 if iov is full
+ */
+int appendIov(struct iovec* iov, int maxiov, int* numiov, const void* base, size_t length)
+{
+    if(length == 0)
+        return 1;
+
+    if(*numiov >= maxiov)
+        return 0;
+
+    iov[*numiov].iov_base = (void*)base;
+    iov[*numiov].iov_len = length;
+    (*numiov)++;
+
+    return 1;
+
+}// appendIov
+
+
+/*!
+ * Return the total number of bytes in an iovec array
+ * \param iov is the iovec array
+ * \param numiov is the number of entries used in iov
+ * \return the sum of the lengths of the entries
+ */
+size_t iovLength(const struct iovec* iov, int numiov)
+{
+    size_t length = 0;
+    int i;
+
+    for(i = 0; i < numiov; i++)
+        length += iov[i].iov_len;
+
+    return length;
+
+}// iovLength
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolIovEncode::generateSource
@@ -0,0 +1,35 @@
+#ifndef PROTOCOLIOVENCODE_H
+#define PROTOCOLIOVENCODE_H
+
+/*!
+ * \file
+ * Auto magically generate the helpers for scatter gather packet encoding
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+
+class ProtocolIovEncode
+{
+public:
+    ProtocolIovEncode(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLIOVENCODE_H
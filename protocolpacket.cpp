@@ -18,18 +18,19 @@
  * \param bigendian should be true to encode multi-byte fields with the most
  *        significant byte first.
  */
-ProtocolPacket::ProtocolPacket(ProtocolParser* parse, ProtocolSupport supported, const std::string& protocolApi, const std::string& protocolVersion) :
+ProtocolPacket::ProtocolPacket(ProtocolParser* parse, const ProtocolSupport& supported, const std::string& protocolApi, const std::string& protocolVersion) :
     ProtocolStructureModule(parse, supported, protocolApi, protocolVersion),
     useInOtherPackets(false),
     parameterFunctions(false),
-    structureFunctions(true)
+    structureFunctions(true),
+    layoutFunctions(false),
+    iovEncode(false),
+    ringEncode(false),
+    packetLayout(nullptr)
 {
     // These are attributes on top of the normal structureModule that we support
-    std::vector<std::string> newattribs({"structureInterface", "parameterInterface", "ID", "useInOtherPackets"});
-
-    // Now append the new attributes onto our old list
-    // Now append the new attributes onto our old list
-    attriblist.insert(attriblist.end(), newattribs.begin(), newattribs.end());
+    static const AttributeNames names(*attriblist, {"structureInterface", "parameterInterface", "ID", "useInOtherPackets", "iovEncode", "ringEncode"});
+    attriblist = &names;
 }
 
 
@@ -48,6 +49,10 @@ void ProtocolPacket::clear(void)
     useInOtherPackets = false;
     parameterFunctions = false;
     structureFunctions = true;
+    layoutFunctions = false;
+    iovEncode = false;
+    ringEncode = false;
+    packetLayout = nullptr;
 
     // Delete all the objects in the list
     for(std::size_t i = 0; i < documentList.size(); i++)
@@ -68,9 +73,21 @@ void ProtocolPacket::clear(void)
 
 
 /*!
- * Create the source and header files that represent a packet
+ * Parse the packet and create the source and header files that represent it
  */
 void ProtocolPacket::parse(void)
+{
+    parseDefinition();
+    output();
+
+}// ProtocolPacket::parse
+
+
+/*!
+ * Parse the packet and its fields from the DOM, without creating any files.
+ * The packet is output by output().
+ */
+void ProtocolPacket::parseDefinition(void)
 {
     // Initialize metadata
     clear();
@@ -86,14 +103,14 @@ void ProtocolPacket::parse(void)
     // re-implementation of ProtocolStructureModule with different rules.
     ProtocolStructure::parse();
 
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
-    std::string moduleName = ProtocolParser::getAttribute("file", map);
-    std::string defheadermodulename = ProtocolParser::getAttribute("deffile", map);
-    std::string verifymodulename = ProtocolParser::getAttribute("verifyfile", map);
-    std::string comparemodulename = ProtocolParser::getAttribute("comparefile", map);
-    std::string printmodulename = ProtocolParser::getAttribute("printfile", map);
-    std::string mapmodulename = ProtocolParser::getAttribute("mapfile", map);
+    moduleName = ProtocolParser::getAttribute("file", map);
+    defheadermodulename = ProtocolParser::getAttribute("deffile", map);
+    verifymodulename = ProtocolParser::getAttribute("verifyfile", map);
+    comparemodulename = ProtocolParser::getAttribute("comparefile", map);
+    printmodulename = ProtocolParser::getAttribute("printfile", map);
+    mapmodulename = ProtocolParser::getAttribute("mapfile", map);
 
     encode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("encode", map));
     decode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("decode", map));
@@ -103,7 +120,7 @@ void ProtocolPacket::parse(void)
     {
         support.compare = compare = false;
         comparemodulename.clear();
-        support.globalCompareName.clear();
+        support.edit().globalCompareName.clear();
     }
     else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("compare", map)))
         compare = true;
@@ -113,7 +130,7 @@ void ProtocolPacket::parse(void)
     {
         support.print = print = false;
         printmodulename.clear();
-        support.globalPrintName.clear();
+        support.edit().globalPrintName.clear();
     }
     else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map)))
         print = true;
@@ -123,11 +140,14 @@ void ProtocolPacket::parse(void)
     {
         support.mapEncode = mapEncode = false;
         mapmodulename.clear();
-        support.globalMapName.clear();
+        support.edit().globalMapName.clear();
     }
     else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("map", map)))
         mapEncode = true;
 
+    // Encode and decode with the table codec, setupFiles() checks if the packet allows it
+    tableDriven = ProtocolParser::isFieldSet("tableDriven", map);
+
     useInOtherPackets = ProtocolParser::isFieldSet("useInOtherPackets", map);
     std::string redefinename = ProtocolParser::getAttribute("redefine", map);
 
@@ -162,7 +182,7 @@ void ProtocolPacket::parse(void)
     if(support.maxdatasize > 0)
     {
         // maxdatasize will be zero if the length string cannot be computed
-        int maxdatasize = (int)(ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(encodedLength.maxEncodedLength)) + 0.5);
+        int maxdatasize = getMaxDataLength();
 
         // Warn the user if the packet might be too big
         if(maxdatasize > support.maxdatasize)
@@ -191,13 +211,34 @@ void ProtocolPacket::parse(void)
             parameterFunctions = true;
     }
 
+    // The scatter gather encode is an alternative to the structure encode, and
+    // is only worth having if some of the data can be sent without copying
+    if(ProtocolParser::isFieldSet("iovEncode", map))
+    {
+        if(!encode || !structureFunctions || (getNumberOfEncodeParameters() <= 0))
+            emitWarning("iovEncode is ignored: there is no structure encode function");
+        else if(getNumberOfZeroCopyFields() <= 0)
+            emitWarning("iovEncode is ignored: there are no byte arrays to send without copying");
+        else
+            iovEncode = true;
+    }
+
+    // The ring buffer encode is an alternative to the structure encode
+    if(ProtocolParser::isFieldSet("ringEncode", map))
+    {
+        if(!encode || !structureFunctions || (getNumberOfEncodeParameters() <= 0))
+            emitWarning("ringEncode is ignored: there is no structure encode function");
+        else
+            ringEncode = true;
+    }
+
     if(!redefinename.empty())
     {
         if(redefinename == name)
             emitWarning("Redefine must be different from name");
         else
         {
-            redefines = parser->lookUpStructure(support.prefix + redefinename + support.typeSuffix);
+            redefines = parser->lookUpStructure(support.prefix() + redefinename + support.typeSuffix());
             if(redefines == nullptr)
             {
                 redefinename.clear();
@@ -206,7 +247,7 @@ void ProtocolPacket::parse(void)
         }
 
         if(redefines != nullptr)
-            structName = support.prefix + redefinename + support.typeSuffix;
+            structName = support.prefix() + redefinename + support.typeSuffix();
     }
 
     // If no ID is supplied use the packet name in upper case,
@@ -214,6 +255,15 @@ void ProtocolPacket::parse(void)
     if(ids.size() <= 0)
         ids.push_back(toUpper(name));
 
+}// ProtocolPacket::parseDefinition
+
+
+/*!
+ * Create the source and header files that represent a packet, which must
+ * have been parsed by parseDefinition()
+ */
+void ProtocolPacket::output(void)
+{
     // Don't output if hidden and we are omitting hidden items
     if(isHidden() && !neverOmit && support.omitIfHidden)
     {
@@ -223,7 +273,8 @@ void ProtocolPacket::parse(void)
 
     // Most of the file setup work. This will also declare the structure if
     // warranted (note the details of the structure declaration will reflect
-    // back to this class via virtual functions).
+    // back to this class via virtual functions), and reuse the functions of
+    // earlier structures and packets that have the same layout.
     setupFiles(moduleName, defheadermodulename, verifymodulename, comparemodulename, printmodulename, mapmodulename, structureFunctions, false);
 
     // The functions that include structures which are children of this
@@ -241,6 +292,14 @@ void ProtocolPacket::parse(void)
             header.writeIncludeDirective(include);
     }
 
+    // The scatter gather encode helpers
+    if(iovEncode)
+        header.writeIncludeDirective("iovencode");
+
+    // The ring buffer helpers
+    if(ringEncode)
+        header.writeIncludeDirective("ringencode");
+
     // The functions that encode and decode the packet from a structure.
     if(structureFunctions)
         createStructurePacketFunctions();
@@ -313,7 +372,22 @@ void ProtocolPacket::parse(void)
             mapSource->flush();
     }
 
-}// ProtocolPacket::parse
+}// ProtocolPacket::output
+
+
+/*!
+ * Setup the files of a packet which has been parsed, without any output. This
+ * is used instead of output() when the files from the last generation are
+ * unchanged, so others can still find the files of this packet.
+ */
+void ProtocolPacket::outputUnchanged(void)
+{
+    if(isHidden() && !neverOmit && support.omitIfHidden)
+        return;
+
+    setupUnchangedFiles(structureFunctions);
+
+}// ProtocolPacket::outputUnchanged
 
 
 /*!
@@ -394,6 +468,20 @@ std::string ProtocolPacket::getClassDeclaration_CPP(void) const
             ProtocolFile::makeLineSeparator(output);
         }
 
+        if(iovEncode)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += getStructurePacketIovEncodePrototype(TAB_IN);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
+        if(ringEncode)
+        {
+            ProtocolFile::makeLineSeparator(output);
+            output += getStructurePacketRingEncodePrototype(TAB_IN);
+            ProtocolFile::makeLineSeparator(output);
+        }
+
         // In the event that there are no parameters, the parameter function
         // is the same as the structure function - so don't output both
         if(decode && ((getNumberOfDecodeParameters() > 0) || !parameterFunctions))
@@ -409,8 +497,8 @@ std::string ProtocolPacket::getClassDeclaration_CPP(void) const
     if(compare)
     {
         ProtocolFile::makeLineSeparator(output);
-        output += TAB_IN + "//! Compare two " + support.prefix + name + " packets and generate a report\n";
-        output += TAB_IN + "static std::string compare(std::string prename, const " + support.pointerType + " pkt1, const " + support.pointerType + " pkt2);\n";
+        output += TAB_IN + "//! Compare two " + support.prefix() + name + " packets and generate a report\n";
+        output += TAB_IN + "static std::string compare(std::string prename, const " + support.pointerType() + " pkt1, const " + support.pointerType() + " pkt2);\n";
         ProtocolFile::makeLineSeparator(output);
     }
 
@@ -419,7 +507,7 @@ std::string ProtocolPacket::getClassDeclaration_CPP(void) const
     {
         ProtocolFile::makeLineSeparator(output);
         output += TAB_IN + "//! Generate a string that describes the contents of a " + name + " packet\n";
-        output += TAB_IN + "static std::string textPrint(std::string prename, const " + support.pointerType + " pkt);\n";
+        output += TAB_IN + "static std::string textPrint(std::string prename, const " + support.pointerType() + " pkt);\n";
         ProtocolFile::makeLineSeparator(output);
     }
 
@@ -527,14 +615,14 @@ std::string ProtocolPacket::createUtilityFunctions(const std::string& spacing) c
         // The macro for the packet ID, we only emit this if the packet has a single ID, which is the normal case
         if(ids.size() == 1)
         {
-            output += spacing + "//! return the packet ID for the " + support.prefix + name + " packet\n";
-            output += spacing + "#define get" + support.prefix + name + support.packetParameterSuffix + "ID() (" + ids.at(0) + ")\n";
+            output += spacing + "//! return the packet ID for the " + support.prefix() + name + " packet\n";
+            output += spacing + "#define get" + support.prefix() + name + support.packetParameterSuffix() + "ID() (" + ids.at(0) + ")\n";
             output += "\n";
         }
 
         // The macro for the minimum packet length
-        output += spacing + "//! return the minimum encoded length for the " + support.prefix + name + " packet\n";
-        output += spacing + "#define get" + support.prefix + name + "MinDataLength() ";
+        output += spacing + "//! return the minimum encoded length for the " + support.prefix() + name + " packet\n";
+        output += spacing + "#define get" + support.prefix() + name + "MinDataLength() ";
         if(encodedLength.minEncodedLength.empty())
             output += "0\n";
         else
@@ -542,12 +630,28 @@ std::string ProtocolPacket::createUtilityFunctions(const std::string& spacing) c
 
         // The macro for the maximum packet length
         output += "\n";
-        output += spacing + "//! return the maximum encoded length for the " + support.prefix + name + " packet\n";
-        output += spacing + "#define get" + support.prefix + name + "MaxDataLength() ";
+        output += spacing + "//! return the maximum encoded length for the " + support.prefix() + name + " packet\n";
+        output += spacing + "#define get" + support.prefix() + name + "MaxDataLength() ";
         if(encodedLength.maxEncodedLength.empty())
             output += "0\n";
         else
             output += "("+encodedLength.maxEncodedLength + ")\n";
+
+        // The macro for the arena storage used by decoding
+        if(hasSpans())
+        {
+            output += "\n";
+            output += spacing + "//! return the most arena storage used to decode the spans of the " + support.prefix() + name + " packet\n";
+            output += spacing + "#define get" + support.prefix() + name + "MaxSpanStorage() (" + getMaxSpanStorageString() + ")\n";
+        }
+
+        // The macro for the iovec entries used by the scatter gather encode
+        if(iovEncode)
+        {
+            output += "\n";
+            output += spacing + "//! return the most iovec entries used to encode the " + support.prefix() + name + " packet\n";
+            output += spacing + "#define get" + support.prefix() + name + "MaxIovCount() (" + std::to_string(2*getNumberOfZeroCopyFields() + 1) + ")\n";
+        }
     }
     else
     {
@@ -574,6 +678,22 @@ std::string ProtocolPacket::createUtilityFunctions(const std::string& spacing) c
             output += "0;}\n";
         else
             output += "("+encodedLength.maxEncodedLength + ");}\n";
+
+        // The arena storage used by decoding, which sizes arrays so it is constexpr
+        if(hasSpans())
+        {
+            output += "\n";
+            output += spacing + "//! \\return the most arena storage used to decode the spans of the packet\n";
+            output += spacing + "static constexpr int maxSpanStorage(void) { return (" + getMaxSpanStorageString() + ");}\n";
+        }
+
+        // The iovec entries used by the scatter gather encode, which sizes arrays so it is constexpr
+        if(iovEncode)
+        {
+            output += "\n";
+            output += spacing + "//! \\return the most iovec entries used to encode the packet\n";
+            output += spacing + "static constexpr int maxIovCount(void) { return " + std::to_string(2*getNumberOfZeroCopyFields() + 1) + ";}\n";
+        }
     }
 
     return output;
@@ -611,15 +731,90 @@ void ProtocolPacket::createTopLevelInitializeFunction(void)
 }// ProtocolPacket::createTopLevelInitializeFunction
 
 
+/*!
+ * Get the layout signature of this packet, if its packet structure functions
+ * can share byte array functions with other packets. Packets which are used in
+ * other packets share like any structure, and are not included.
+ * \return the layout signature, which is empty if this packet cannot share.
+ */
+std::string ProtocolPacket::getPacketLayoutSignature(void) const
+{
+    if(!support.sharelayouts || useInOtherPackets || !encode || !decode || !structureFunctions || (redefines != nullptr))
+        return std::string();
+
+    // The byte array functions do not handle defaults the way the packet functions do
+    if(usesDefaults())
+        return std::string();
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->overridesPreviousEncodable())
+            return std::string();
+    }
+
+    return getLayoutSignature();
+
+}// ProtocolPacket::getPacketLayoutSignature
+
+
+/*!
+ * Share the type and the encode and decode functions of earlier structures or
+ * packets with the same layout. A packet which is used in other packets shares
+ * like any structure. Otherwise the packet structure is declared as the type
+ * of an earlier structure with the same layout, and the packet structure
+ * functions call its byte array functions. If there is none, and
+ * enableLayoutFunctions() was called because a later packet has the same
+ * layout, this packet outputs the byte array functions for them to call.
+ */
+void ProtocolPacket::shareModuleLayouts(void)
+{
+    if(useInOtherPackets)
+    {
+        shareStructureLayouts(true);
+        return;
+    }
+
+    // The children functions are always output
+    shareStructureLayouts(false);
+
+    std::string signature = getPacketLayoutSignature();
+
+    if(signature.empty())
+    {
+        layoutFunctions = false;
+        return;
+    }
+
+    std::string include, structinclude;
+    const ProtocolStructure* shared = parser->lookUpLayout(signature, &include, &structinclude);
+
+    if(shared != nullptr)
+    {
+        layoutFunctions = false;
+        packetLayout = shared;
+        sharedLayout = shared;
+        structHeader->writeIncludeDirective(structinclude);
+        source.writeIncludeDirective(include);
+    }
+    else if(layoutFunctions)
+    {
+        packetLayout = this;
+        parser->addLayout(signature, this, header.fileName(), structHeader->fileName());
+    }
+
+}// ProtocolPacket::shareModuleLayouts
+
+
 /*!
  * Write data to the source and header files to encode and decode structure
  * functions that do not use a packet. For this structure only, not its children
  */
 void ProtocolPacket::createTopLevelStructureFunctions(void)
 {
-    // If we are using this structure in other packets, we need the structure
-    // functions that come from ProtocolStructureModule
-    if(useInOtherPackets)
+    // If we are using this structure in other packets, or sharing its layout
+    // with later packets, we need the structure functions that come from
+    // ProtocolStructureModule
+    if(useInOtherPackets || layoutFunctions)
     {
         if(encode)
         {
@@ -677,6 +872,20 @@ void ProtocolPacket::createStructurePacketFunctions(void)
             header.write(getStructurePacketEncodePrototype(std::string()));
         }
 
+        if(iovEncode)
+        {
+            // The prototype for the structure packet scatter gather encode function
+            header.makeLineSeparator();
+            header.write(getStructurePacketIovEncodePrototype(std::string()));
+        }
+
+        if(ringEncode)
+        {
+            // The prototype for the structure packet ring buffer encode function
+            header.makeLineSeparator();
+            header.write(getStructurePacketRingEncodePrototype(std::string()));
+        }
+
         // In the event that there are no parameters, the parameter function
         // is the same as the structure function - so don't output both
         if(decode && ((numDecodes > 0) || !parameterFunctions))
@@ -689,8 +898,8 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         if(compare && compareHeader != nullptr)
         {
             compareHeader->makeLineSeparator();
-            compareHeader->write("//! Compare two " + support.prefix + name + " packets and generate a report\n");
-            compareHeader->write("std::string compare" + support.prefix + name + support.packetParameterSuffix + "(std::string prename, const " + support.pointerType + " pkt1, const " + support.pointerType + " pkt2);\n");
+            compareHeader->write("//! Compare two " + support.prefix() + name + " packets and generate a report\n");
+            compareHeader->write("std::string compare" + support.prefix() + name + support.packetParameterSuffix() + "(std::string prename, const " + support.pointerType() + " pkt1, const " + support.pointerType() + " pkt2);\n");
             compareHeader->makeLineSeparator();
         }
 
@@ -698,7 +907,7 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         {
             printHeader->makeLineSeparator();
             printHeader->write("//! Generate a string that describes the contents of a " + name + " packet\n");
-            printHeader->write("std::string textPrint" + (support.prefix + name + support.packetParameterSuffix) + "(std::string prename, const " + support.pointerType + " pkt);\n");
+            printHeader->write("std::string textPrint" + (support.prefix() + name + support.packetParameterSuffix()) + "(std::string prename, const " + support.pointerType() + " pkt);\n");
             printHeader->makeLineSeparator();
         }
 
@@ -713,6 +922,20 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         source.write(getStructurePacketEncodeBody());
     }
 
+    if(iovEncode)
+    {
+        // The source function for the scatter gather encode function
+        source.makeLineSeparator();
+        source.write(getStructurePacketIovEncodeBody());
+    }
+
+    if(ringEncode)
+    {
+        // The source function for the ring buffer encode function
+        source.makeLineSeparator();
+        source.write(getStructurePacketRingEncodeBody());
+    }
+
     // In the event that there are no parameters, the parameter function
     // is the same as the structure function - so don't output both
     if(decode && ((numDecodes > 0) || !parameterFunctions))
@@ -734,9 +957,9 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         compareSource->write(" */\n");
 
         if(support.language == ProtocolSupport::c_language)
-            compareSource->write("std::string compare" + (support.prefix + name + support.packetParameterSuffix) + "(std::string _pg_prename, const " + support.pointerType + " _pg_pkt1, const " + support.pointerType + " _pg_pkt2)\n");
+            compareSource->write("std::string compare" + (support.prefix() + name + support.packetParameterSuffix()) + "(std::string _pg_prename, const " + support.pointerType() + " _pg_pkt1, const " + support.pointerType() + " _pg_pkt2)\n");
         else
-            compareSource->write("std::string " + typeName + "::compare(std::string _pg_prename, const " + support.pointerType + " _pg_pkt1, const " + support.pointerType + " _pg_pkt2)\n");
+            compareSource->write("std::string " + typeName + "::compare(std::string _pg_prename, const " + support.pointerType() + " _pg_pkt1, const " + support.pointerType() + " _pg_pkt2)\n");
 
         compareSource->write("{\n");
         compareSource->write(TAB_IN + "std::string _pg_report;\n");
@@ -759,15 +982,35 @@ void ProtocolPacket::createStructurePacketFunctions(void)
                 compareSource->write(TAB_IN + "memset(&_pg_struct1, 0, sizeof(_pg_struct1));\n");
                 compareSource->write(TAB_IN + "memset(&_pg_struct2, 0, sizeof(_pg_struct2));\n");
 
+                std::string arena;
+
+                // Spans draw their storage from an arena
+                if(hasSpans())
+                {
+                    compareSource->makeLineSeparator();
+                    compareSource->write(getSpanArenaDeclaration(2));
+                    arena = ", &_pg_arena";
+                }
+
                 compareSource->makeLineSeparator();
                 compareSource->write(TAB_IN + "// Decode each packet\n");
-                compareSource->write(TAB_IN + "if(!decode" + extendedName() + "(_pg_pkt1, &_pg_struct1) || !decode" + extendedName() + "(_pg_pkt2, &_pg_struct2))\n");
+                compareSource->write(TAB_IN + "if(!decode" + extendedName() + "(_pg_pkt1, &_pg_struct1" + arena + ") || !decode" + extendedName() + "(_pg_pkt2, &_pg_struct2" + arena + "))\n");
             }
             else
             {
+                std::string arena;
+
+                // Spans draw their storage from an arena
+                if(hasSpans())
+                {
+                    compareSource->makeLineSeparator();
+                    compareSource->write(getSpanArenaDeclaration(2));
+                    arena = ", _pg_arena";
+                }
+
                 compareSource->makeLineSeparator();
                 compareSource->write(TAB_IN + "// Decode each packet\n");
-                compareSource->write(TAB_IN + "if(!_pg_struct1.decode(_pg_pkt1) || !_pg_struct2.decode(_pg_pkt2))\n");
+                compareSource->write(TAB_IN + "if(!_pg_struct1.decode(_pg_pkt1" + arena + ") || !_pg_struct2.decode(_pg_pkt2" + arena + "))\n");
             }
 
             compareSource->write(TAB_IN + "{\n");
@@ -783,7 +1026,7 @@ void ProtocolPacket::createStructurePacketFunctions(void)
 
             compareSource->makeLineSeparator();
             compareSource->write(TAB_IN + "// Check packet types\n");
-            compareSource->write(TAB_IN + "if((get" + support.protoName + "PacketID(_pg_pkt1) != get" + support.protoName + "PacketID(_pg_pkt1)) || (get"+ support.protoName + "PacketID(_pg_pkt2) != get" + (support.prefix + name + support.packetParameterSuffix) + "ID()))\n");
+            compareSource->write(TAB_IN + "if((get" + support.protoName() + "PacketID(_pg_pkt1) != get" + support.protoName() + "PacketID(_pg_pkt1)) || (get"+ support.protoName() + "PacketID(_pg_pkt2) != get" + (support.prefix() + name + support.packetParameterSuffix()) + "ID()))\n");
             compareSource->write(TAB_IN + "{\n");
             compareSource->write(TAB_IN + TAB_IN + "_pg_report += _pg_prename + \" packet IDs are different\\n\";\n");
             compareSource->write(TAB_IN + TAB_IN + "return _pg_report;\n");
@@ -792,7 +1035,7 @@ void ProtocolPacket::createStructurePacketFunctions(void)
 
         compareSource->makeLineSeparator();
         compareSource->write(TAB_IN + "// Check packet sizes. Even if sizes are different the packets may contain the same result\n");
-        compareSource->write(TAB_IN + "if(get" + support.protoName + "PacketSize(_pg_pkt1) != get" + support.protoName + "PacketSize(_pg_pkt2))\n");
+        compareSource->write(TAB_IN + "if(get" + support.protoName() + "PacketSize(_pg_pkt1) != get" + support.protoName() + "PacketSize(_pg_pkt2))\n");
         compareSource->write(TAB_IN + TAB_IN + "_pg_report += _pg_prename + \" packet sizes are different\\n\";\n");
 
         if(numDecodes > 0)
@@ -810,7 +1053,7 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         compareSource->write("\n");
 
         if(support.language == ProtocolSupport::c_language)
-            compareSource->write("}// compare" + support.prefix + name + support.packetParameterSuffix + "\n");
+            compareSource->write("}// compare" + support.prefix() + name + support.packetParameterSuffix() + "\n");
         else
             compareSource->write("}// " + typeName + "::compare\n");
 
@@ -826,9 +1069,9 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         printSource->write(" * \\return a string describing the contents of _pg_pkt\n");
         printSource->write(" */\n");
         if(support.language == ProtocolSupport::c_language)
-            printSource->write("std::string textPrint" + (support.prefix + name + support.packetParameterSuffix) + "(std::string _pg_prename, const " + support.pointerType + " _pg_pkt)\n");
+            printSource->write("std::string textPrint" + (support.prefix() + name + support.packetParameterSuffix()) + "(std::string _pg_prename, const " + support.pointerType() + " _pg_pkt)\n");
         else
-            printSource->write("std::string " + typeName + "::textPrint(std::string _pg_prename, const " + support.pointerType + " _pg_pkt)\n");
+            printSource->write("std::string " + typeName + "::textPrint(std::string _pg_prename, const " + support.pointerType() + " _pg_pkt)\n");
         printSource->write("{\n");
         printSource->write(TAB_IN + "std::string _pg_report;\n");
 
@@ -849,15 +1092,35 @@ void ProtocolPacket::createStructurePacketFunctions(void)
                 printSource->write(TAB_IN + "// All zeroes before decoding\n");
                 printSource->write(TAB_IN + "memset(&_pg_user, 0, sizeof(_pg_user));\n");
 
+                std::string arena;
+
+                // Spans draw their storage from an arena
+                if(hasSpans())
+                {
+                    printSource->makeLineSeparator();
+                    printSource->write(getSpanArenaDeclaration(1));
+                    arena = ", &_pg_arena";
+                }
+
                 printSource->makeLineSeparator();
                 printSource->write(TAB_IN + "// Decode packet\n");
-                printSource->write(TAB_IN + "if(!decode" + extendedName() + "(_pg_pkt, &_pg_user))\n");
+                printSource->write(TAB_IN + "if(!decode" + extendedName() + "(_pg_pkt, &_pg_user" + arena + "))\n");
             }
             else
             {
+                std::string arena;
+
+                // Spans draw their storage from an arena
+                if(hasSpans())
+                {
+                    printSource->makeLineSeparator();
+                    printSource->write(getSpanArenaDeclaration(1));
+                    arena = ", _pg_arena";
+                }
+
                 printSource->makeLineSeparator();
                 printSource->write(TAB_IN + "// Decode packet\n");
-                printSource->write(TAB_IN + "if(!_pg_user.decode(_pg_pkt))\n");
+                printSource->write(TAB_IN + "if(!_pg_user.decode(_pg_pkt" + arena + "))\n");
 
             }
 
@@ -874,7 +1137,7 @@ void ProtocolPacket::createStructurePacketFunctions(void)
 
             printSource->makeLineSeparator();
             printSource->write(TAB_IN + "// Check packet type\n");
-            printSource->write(TAB_IN + "if(get"+ support.protoName + "PacketID(_pg_pkt) != get" + (support.prefix + name + support.packetParameterSuffix) + "ID())\n");
+            printSource->write(TAB_IN + "if(get"+ support.protoName() + "PacketID(_pg_pkt) != get" + (support.prefix() + name + support.packetParameterSuffix()) + "ID())\n");
             printSource->write(TAB_IN + "{\n");
             printSource->write(TAB_IN + TAB_IN + "_pg_report += _pg_prename + \" packet ID is incorrect\\n\";\n");
             printSource->write(TAB_IN + TAB_IN + "return _pg_report;\n");
@@ -883,7 +1146,7 @@ void ProtocolPacket::createStructurePacketFunctions(void)
 
         printSource->makeLineSeparator();
         printSource->write(TAB_IN + "// Print the packet size\n");
-        printSource->write(TAB_IN + "_pg_report += _pg_prename + \" packet size is \" + std::to_string(get" + support.protoName + "PacketSize(_pg_pkt)) + \"\\n\";\n");
+        printSource->write(TAB_IN + "_pg_report += _pg_prename + \" packet size is \" + std::to_string(get" + support.protoName() + "PacketSize(_pg_pkt)) + \"\\n\";\n");
 
         if(numDecodes > 0)
         {
@@ -899,7 +1162,7 @@ void ProtocolPacket::createStructurePacketFunctions(void)
         printSource->write(TAB_IN + "return _pg_report;\n");
         printSource->write("\n");
         if(support.language == ProtocolSupport::c_language)
-            printSource->write("}// textPrint" + (support.prefix + name + support.packetParameterSuffix) + "\n");
+            printSource->write("}// textPrint" + (support.prefix() + name + support.packetParameterSuffix()) + "\n");
         else
             printSource->write("}// " + typeName + "::textPrint\n");
 
@@ -927,7 +1190,7 @@ std::string ProtocolPacket::getStructurePacketEncodeSignature(bool insource) con
 
     if(support.language == ProtocolSupport::c_language)
     {
-        output = "void encode" + support.prefix + name + support.packetStructureSuffix + "(" + support.pointerType + " " + pg + "pkt";
+        output = "void encode" + support.prefix() + name + support.packetStructureSuffix() + "(" + support.pointerType() + " " + pg + "pkt";
 
         if(numEncodes > 0)
             output += ", const " + structName + "* " + pg + "user";
@@ -946,7 +1209,7 @@ std::string ProtocolPacket::getStructurePacketEncodeSignature(bool insource) con
         if(insource)
             output += typeName + "::";
 
-        output += "encode(" + support.pointerType + " " + pg + "pkt";
+        output += "encode(" + support.pointerType() + " " + pg + "pkt";
     }
 
     if(ids.size() <= 1)
@@ -1009,50 +1272,27 @@ std::string ProtocolPacket::getStructurePacketEncodeBody(void) const
     output += "{\n";
 
     if(getNumberOfEncodes() > 0)
-        output += TAB_IN + "uint8_t* _pg_data = get" + support.protoName + "PacketData(_pg_pkt);\n";
+        output += TAB_IN + "uint8_t* _pg_data = get" + support.protoName() + "PacketData(_pg_pkt);\n";
 
     output += TAB_IN + "int _pg_byteindex = 0;\n";
 
-    if(usestempencodebitfields)
-        output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
-
-    if(usestempencodelongbitfields)
-        output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
-
-    if(numbitfieldgroupbytes > 0)
-    {
-        output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
-        output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
-    }
-
-    if(needsEncodeIterator)
-        output += TAB_IN + "unsigned _pg_i = 0;\n";
-
-    if(needs2ndEncodeIterator)
-        output += TAB_IN + "unsigned _pg_j = 0;\n";
-
-    int bitcount = 0;
-    for(std::size_t i = 0; i < encodables.size(); i++)
-    {
-        output += "\n";
-        output += encodables[i]->getEncodeString(support.bigendian, &bitcount, true);
-    }
+    output += getStructurePacketEncodeFields();
 
     std::string id;
     if(ids.size() > 1)
         id = "_pg_id";
     else if(support.language == ProtocolSupport::c_language)
-        id = "get" + support.prefix + name + support.packetParameterSuffix + "ID()";
+        id = "get" + support.prefix() + name + support.packetParameterSuffix() + "ID()";
     else
         id = "id()";
 
     ProtocolFile::makeLineSeparator(output);
     output += TAB_IN + "// complete the process of creating the packet\n";
-    output += TAB_IN + "finish" + support.protoName + "Packet(_pg_pkt, _pg_byteindex, " + id + ");\n";
+    output += TAB_IN + "finish" + support.protoName() + "Packet(_pg_pkt, _pg_byteindex, " + id + ");\n";
 
     ProtocolFile::makeLineSeparator(output);
     if(support.language == ProtocolSupport::c_language)
-        output += "}// encode" + support.prefix + name + support.packetStructureSuffix + "\n";
+        output += "}// encode" + support.prefix() + name + support.packetStructureSuffix() + "\n";
     else
         output += "}// " + typeName + "::encode\n";
 
@@ -1062,138 +1302,523 @@ std::string ProtocolPacket::getStructurePacketEncodeBody(void) const
 
 
 /*!
- * Get the signature of the packet structure decode function, without semicolon or
- * comments or line feed, for the prototype or actual function.
+ * Get the temporaries and the code that encode the fields of this packet from
+ * a structure or class into _pg_data, which the caller declares along with
+ * _pg_byteindex. This is shared by the structure encode functions.
+ * \param prologue is code that goes after the declarations and before the
+ *        fields are encoded, with line feeds.
+ * \return the declarations and code, with line feeds
+ */
+std::string ProtocolPacket::getStructurePacketEncodeFields(const std::string& prologue) const
+{
+    std::string output;
+
+    if(tableDriven)
+    {
+        output += prologue;
+        // The interpreter encodes the fields from the descriptor
+        output += "\n";
+        output += TAB_IN + "encodeFromDescriptor(&descriptor" + typeName + ", _pg_data, &_pg_byteindex, _pg_user);\n";
+    }
+    else if(packetLayout != nullptr)
+    {
+        output += prologue;
+
+        // A structure with the same layout encodes the fields
+        output += "\n";
+        output += TAB_IN + "encode" + packetLayout->typeName + "(_pg_data, &_pg_byteindex, _pg_user);\n";
+    }
+    else
+    {
+        if(usestempencodebitfields)
+            output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
+
+        if(usestempencodelongbitfields)
+            output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
+
+        if(numbitfieldgroupbytes > 0)
+        {
+            output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
+            output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
+        }
+
+        if(needsEncodeIterator)
+            output += TAB_IN + "unsigned _pg_i = 0;\n";
+
+        if(needs2ndEncodeIterator)
+            output += TAB_IN + "unsigned _pg_j = 0;\n";
+
+        output += prologue;
+
+        int bitcount = 0;
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            output += "\n";
+            output += encodables[i]->getEncodeString(support.bigendian, &bitcount, true);
+        }
+    }
+
+    return output;
+
+}// ProtocolPacket::getStructurePacketEncodeFields
+
+
+/*!
+ * Get the signature of the packet structure scatter gather encode function,
+ * without semicolon or comments or line feed, for the prototype or actual function.
  * \param insource should be true to indicate this signature is in source code
  *        (i.e. not a prototype) which determines if the "_pg_" decoration is
  *        used as well as c++ access specifiers.
- * \return the decode signature
+ * \return the encode signature
  */
-std::string ProtocolPacket::getStructurePacketDecodeSignature(bool insource) const
+std::string ProtocolPacket::getStructurePacketIovEncodeSignature(bool insource) const
 {
     std::string output;
     std::string pg;
 
-    int numDecodes = getNumberOfDecodeParameters();
-
     if(insource)
         pg = "_pg_";
 
     if(support.language == ProtocolSupport::c_language)
     {
-        output = "int decode" + support.prefix + name + support.packetStructureSuffix + "(const " + support.pointerType + " " + pg + "pkt";
-
-        if(numDecodes > 0)
-            output += ", " + structName + "* " + pg + "user";
+        output = "int encode" + support.prefix() + name + support.packetStructureSuffix() + "Iov(" + support.pointerType() + " " + pg + "pkt";
+        output += ", const " + structName + "* " + pg + "user";
     }
     else
     {
-        // C++ class member should be static if there are no decodes, because
-        // nothing will be modified, we are simply checking of the packet is good
-        if(!insource && (numDecodes <= 0))
-            output += "static ";
-
-        output += "bool ";
+        output += "int ";
 
         // In the source the function needs the class scope
         if(insource)
             output += typeName + "::";
 
-        output += "decode(const " + support.pointerType + " " + pg + "pkt";
+        output += "encodeIov(" + support.pointerType() + " " + pg + "pkt";
     }
 
-    output += + ")";
+    output += ", struct iovec* " + pg + "iov, int " + pg + "maxiov)";
+
+    if(support.language == ProtocolSupport::cpp_language)
+        output += " const";
 
     return output;
 
-}//ProtocolPacket::getStructurePacketDecodeSignature
+}// ProtocolPacket::getStructurePacketIovEncodeSignature
 
 
 /*!
- * Get the prototype for the structure packet decode function
+ * Get the prototype for the structure packet scatter gather encode function
  * \param spacing is the offset for each line
  * \return the prototype including semicolon and line fees
  */
-std::string ProtocolPacket::getStructurePacketDecodePrototype(const std::string& spacing) const
+std::string ProtocolPacket::getStructurePacketIovEncodePrototype(const std::string& spacing) const
 {
     std::string output;
 
-    if(!decode)
+    if(!iovEncode)
         return output;
 
-    output += spacing + "//! " + getPacketDecodeBriefComment() + "\n";
-    output += spacing + getStructurePacketDecodeSignature(false) + ";\n";;
+    output += spacing + "//! Create the " + support.prefix() + name + " packet data as iovec entries, without copying byte arrays\n";
+    output += spacing + getStructurePacketIovEncodeSignature(false) + ";\n";
 
     return output;
 }
 
 
 /*!
- * Get the body for the structure packet decode function
- * \return The body of the function that decodes this packet from a structure or class.
+ * Get the body for the structure packet scatter gather encode function. The
+ * fields are encoded into the packet data as normal, except for the byte
+ * arrays that can be sent from memory, which get their own iovec entries.
+ * The packet is not finished, because its data are not contiguous.
+ * \return The body of the function that encodes this packet to iovec entries.
  */
-std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
+std::string ProtocolPacket::getStructurePacketIovEncodeBody(void) const
 {
     std::string output;
 
-    if(!decode)
+    if(!iovEncode)
         return output;
 
-    // The string that gets the identifier for the packet, if there is only one
-    std::string id;
-    if(ids.size() <= 1)
-    {
-        if(support.language == ProtocolSupport::c_language)
-            id = "get" + support.prefix + name + support.packetParameterSuffix + "ID()";
-        else
-            id = "id()";
-    }
+    std::string maxiov;
+    if(support.language == ProtocolSupport::c_language)
+        maxiov = "get" + support.prefix() + name + "MaxIovCount()";
+    else
+        maxiov = "maxIovCount()";
 
-    // Check if there is anything that is encoded, if not, we use a different form of the function
-    if(getNumberOfEncodes() > 0)
-    {
-        output += "/*!\n";
-        output += " * \\brief " + getPacketDecodeBriefComment() + "\n";
-        output += " *\n";
-        output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
-        output += " * \\param _pg_pkt points to the packet being decoded by this function\n";
-        if((getNumberOfDecodeParameters() > 0) && (support.language == ProtocolSupport::c_language))
-            output += " * \\param _pg_user receives the data decoded from the packet\n";
-        output += " * \\return " + getReturnCode(false) + " is returned if the packet ID or size is wrong, else " + getReturnCode(true) + "\n";
-        output += " */\n";
-        output += getStructurePacketDecodeSignature(true) + "\n";
-        output += "{\n";
-        output += TAB_IN + "int _pg_numbytes;\n";
-        output += TAB_IN + "int _pg_byteindex = 0;\n";
-        output += TAB_IN + "const uint8_t* _pg_data;\n";
+    output += "/*!\n";
+    output += " * \\brief Create the " + support.prefix() + name + " packet data as iovec entries, without copying byte arrays\n";
+    output += " *\n";
+    output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
+    output += " *\n";
+    output += " * The entries only cover the packet data, the packet header and any\n";
+    output += " * checksum are up to the caller. The user data must not change until the\n";
+    output += " * entries are sent.\n";
+    output += " * \\param _pg_pkt gives the packet data buffer, which holds the fields that are not sent from memory\n";
+    if(support.language == ProtocolSupport::c_language)
+        output += " * \\param _pg_user points to the user data that will be encoded\n";
+    output += " * \\param _pg_iov receives the entries that describe the packet data\n";
+    output += " * \\param _pg_maxiov is the number of entries in _pg_iov, " + maxiov + " is always enough\n";
+    output += " * \\return the number of entries used in _pg_iov, or 0 if _pg_maxiov is too small\n";
+    output += " */\n";
+    output += getStructurePacketIovEncodeSignature(true) + "\n";
+    output += "{\n";
+    output += TAB_IN + "uint8_t* _pg_data = get" + support.protoName() + "PacketData(_pg_pkt);\n";
+    output += TAB_IN + "int _pg_byteindex = 0;\n";
+    output += TAB_IN + "int _pg_start = 0;\n";
+    output += TAB_IN + "int _pg_numiov = 0;\n";
 
-        if(usestempdecodebitfields)
-            output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
+    if(usestempencodebitfields)
+        output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
 
-        if(usestempdecodelongbitfields)
-            output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
+    if(usestempencodelongbitfields)
+        output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
 
-        if(numbitfieldgroupbytes > 0)
+    if(numbitfieldgroupbytes > 0)
+    {
+        output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
+        output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
+    }
+
+    // The fields sent from memory do not iterate
+    bool iterator = false, iterator2 = false;
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->isZeroCopy())
+            continue;
+
+        iterator = iterator || encodables.at(i)->usesEncodeIterator();
+        iterator2 = iterator2 || encodables.at(i)->uses2ndEncodeIterator();
+    }
+
+    if(iterator)
+        output += TAB_IN + "unsigned _pg_i = 0;\n";
+
+    if(iterator2)
+        output += TAB_IN + "unsigned _pg_j = 0;\n";
+
+    int bitcount = 0;
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        output += "\n";
+        if(encodables.at(i)->isZeroCopy())
+            output += encodables.at(i)->getIovEncodeString(true);
+        else
+            output += encodables.at(i)->getEncodeString(support.bigendian, &bitcount, true);
+    }
+
+    ProtocolFile::makeLineSeparator(output);
+    output += TAB_IN + "// The bytes encoded after the last field sent from memory\n";
+    output += TAB_IN + "if(!appendIov(_pg_iov, _pg_maxiov, &_pg_numiov, _pg_data + _pg_start, (size_t)(_pg_byteindex - _pg_start)))\n";
+    output += TAB_IN + TAB_IN + "return 0;\n";
+    output += "\n";
+    output += TAB_IN + "return _pg_numiov;\n";
+    output += "\n";
+
+    if(support.language == ProtocolSupport::c_language)
+        output += "}// encode" + support.prefix() + name + support.packetStructureSuffix() + "Iov\n";
+    else
+        output += "}// " + typeName + "::encodeIov\n";
+
+    return output;
+
+}// ProtocolPacket::getStructurePacketIovEncodeBody
+
+
+/*!
+ * Get the signature of the packet structure ring buffer encode function,
+ * without semicolon or comments or line feed, for the prototype or actual function.
+ * \param insource should be true to indicate this signature is in source code
+ *        (i.e. not a prototype) which determines if the "_pg_" decoration is
+ *        used as well as c++ access specifiers.
+ * \return the encode signature
+ */
+std::string ProtocolPacket::getStructurePacketRingEncodeSignature(bool insource) const
+{
+    std::string output;
+    std::string pg;
+
+    if(insource)
+        pg = "_pg_";
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output = "int encode" + support.prefix() + name + support.packetStructureSuffix() + "Ring(pgring_t* " + pg + "ring";
+        output += ", const " + structName + "* " + pg + "user)";
+    }
+    else
+    {
+        output += "int ";
+
+        // In the source the function needs the class scope
+        if(insource)
+            output += typeName + "::";
+
+        output += "encodeRing(pgring_t& " + pg + "ring) const";
+    }
+
+    return output;
+
+}// ProtocolPacket::getStructurePacketRingEncodeSignature
+
+
+/*!
+ * Get the prototype for the structure packet ring buffer encode function
+ * \param spacing is the offset for each line
+ * \return the prototype including semicolon and line fees
+ */
+std::string ProtocolPacket::getStructurePacketRingEncodePrototype(const std::string& spacing) const
+{
+    std::string output;
+
+    if(!ringEncode)
+        return output;
+
+    output += spacing + "//! Encode the " + support.prefix() + name + " packet data into a ring buffer\n";
+    output += spacing + getStructurePacketRingEncodeSignature(false) + ";\n";
+
+    return output;
+}
+
+
+/*!
+ * Get the body for the structure packet ring buffer encode function. The
+ * field encoders write through a linear pointer, so the fields are always
+ * encoded in place, running into the slack after the end of the ring if the
+ * packet wraps. commitRing() copies the bytes in the slack to the start, so
+ * there is no temporary on the stack. The packet is not finished, because its
+ * data are not in a packet buffer.
+ * \return The body of the function that encodes this packet to a ring buffer.
+ */
+std::string ProtocolPacket::getStructurePacketRingEncodeBody(void) const
+{
+    std::string output;
+
+    if(!ringEncode)
+        return output;
+
+    std::string maxlength;
+    if(support.language == ProtocolSupport::c_language)
+        maxlength = "get" + support.prefix() + name + "MaxDataLength()";
+    else
+        maxlength = "maxLength()";
+
+    // The ring is a reference in C++
+    std::string ring = "_pg_ring";
+    if(support.language == ProtocolSupport::cpp_language)
+        ring = "&_pg_ring";
+
+    output += "/*!\n";
+    output += " * \\brief Encode the " + support.prefix() + name + " packet data into a ring buffer\n";
+    output += " *\n";
+    output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
+    output += " *\n";
+    output += " * The data are encoded in place. If they wrap around the end of the ring they\n";
+    output += " * run on into its slack, and only those bytes are copied to the start, so the\n";
+    output += " * slack must be at least " + maxlength + " bytes. The data are\n";
+    output += " * committed in one step, so the consumer never sees part of a packet. The\n";
+    output += " * packet header and any checksum are up to the caller.\n";
+    output += " * \\param _pg_ring is the ring buffer, which must have only one producer\n";
+    if(support.language == ProtocolSupport::c_language)
+        output += " * \\param _pg_user points to the user data that will be encoded\n";
+    output += " * \\return the number of bytes added to the ring, or 0 if the ring does not have\n";
+    output += " *         space for " + maxlength + " bytes, or its slack is too small\n";
+    output += " */\n";
+    output += getStructurePacketRingEncodeSignature(true) + "\n";
+    output += "{\n";
+    output += TAB_IN + "// Encode in place, the slack after the end of the ring takes any bytes that wrap\n";
+    output += TAB_IN + "uint8_t* _pg_data = reserveRing(" + ring + ", " + maxlength + ");\n";
+    output += TAB_IN + "int _pg_byteindex = 0;\n";
+    output += getStructurePacketEncodeFields("\n" + TAB_IN + "if(_pg_data == NULL)\n" + TAB_IN + TAB_IN + "return 0;\n");
+
+    ProtocolFile::makeLineSeparator(output);
+    output += TAB_IN + "// Move any bytes in the slack to the start, and make the data visible to the consumer\n";
+    output += TAB_IN + "commitRing(" + ring + ", (uint32_t)_pg_byteindex);\n";
+    output += "\n";
+    output += TAB_IN + "return _pg_byteindex;\n";
+    output += "\n";
+
+    if(support.language == ProtocolSupport::c_language)
+        output += "}// encode" + support.prefix() + name + support.packetStructureSuffix() + "Ring\n";
+    else
+        output += "}// " + typeName + "::encodeRing\n";
+
+    return output;
+
+}// ProtocolPacket::getStructurePacketRingEncodeBody
+
+
+/*!
+ * Count the fields of this packet that the scatter gather encode sends from
+ * memory. Each one needs its own iovec entry, and another for the encoded
+ * bytes before it.
+ * \return the number of fields that can be sent without copying
+ */
+int ProtocolPacket::getNumberOfZeroCopyFields(void) const
+{
+    int count = 0;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->isZeroCopy())
+            count++;
+    }
+
+    return count;
+
+}// ProtocolPacket::getNumberOfZeroCopyFields
+
+
+/*!
+ * Get the signature of the packet structure decode function, without semicolon or
+ * comments or line feed, for the prototype or actual function.
+ * \param insource should be true to indicate this signature is in source code
+ *        (i.e. not a prototype) which determines if the "_pg_" decoration is
+ *        used as well as c++ access specifiers.
+ * \return the decode signature
+ */
+std::string ProtocolPacket::getStructurePacketDecodeSignature(bool insource) const
+{
+    std::string output;
+    std::string pg;
+
+    int numDecodes = getNumberOfDecodeParameters();
+
+    if(insource)
+        pg = "_pg_";
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        output = "int decode" + support.prefix() + name + support.packetStructureSuffix() + "(const " + support.pointerType() + " " + pg + "pkt";
+
+        if(numDecodes > 0)
+            output += ", " + structName + "* " + pg + "user";
+
+        // The storage for spans comes from an arena
+        if((numDecodes > 0) && hasSpans())
+            output += ", pgarena_t* " + pg + "arena";
+    }
+    else
+    {
+        // C++ class member should be static if there are no decodes, because
+        // nothing will be modified, we are simply checking of the packet is good
+        if(!insource && (numDecodes <= 0))
+            output += "static ";
+
+        output += "bool ";
+
+        // In the source the function needs the class scope
+        if(insource)
+            output += typeName + "::";
+
+        output += "decode(const " + support.pointerType() + " " + pg + "pkt";
+
+        // The storage for spans comes from an arena
+        if((numDecodes > 0) && hasSpans())
+            output += ", pgarena_t& " + pg + "arena";
+    }
+
+    output += + ")";
+
+    return output;
+
+}//ProtocolPacket::getStructurePacketDecodeSignature
+
+
+/*!
+ * Get the prototype for the structure packet decode function
+ * \param spacing is the offset for each line
+ * \return the prototype including semicolon and line fees
+ */
+std::string ProtocolPacket::getStructurePacketDecodePrototype(const std::string& spacing) const
+{
+    std::string output;
+
+    if(!decode)
+        return output;
+
+    output += spacing + "//! " + getPacketDecodeBriefComment() + "\n";
+    output += spacing + getStructurePacketDecodeSignature(false) + ";\n";;
+
+    return output;
+}
+
+
+/*!
+ * Get the body for the structure packet decode function
+ * \return The body of the function that decodes this packet from a structure or class.
+ */
+std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
+{
+    std::string output;
+
+    if(!decode)
+        return output;
+
+    // The string that gets the identifier for the packet, if there is only one
+    std::string id;
+    if(ids.size() <= 1)
+    {
+        if(support.language == ProtocolSupport::c_language)
+            id = "get" + support.prefix() + name + support.packetParameterSuffix() + "ID()";
+        else
+            id = "id()";
+    }
+
+    // Check if there is anything that is encoded, if not, we use a different form of the function
+    if(getNumberOfEncodes() > 0)
+    {
+        output += "/*!\n";
+        output += " * \\brief " + getPacketDecodeBriefComment() + "\n";
+        output += " *\n";
+        output += ProtocolParser::outputLongComment(" * ", comment) + "\n";
+        output += " * \\param _pg_pkt points to the packet being decoded by this function\n";
+        if((getNumberOfDecodeParameters() > 0) && (support.language == ProtocolSupport::c_language))
         {
-            output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
-            output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
+            output += " * \\param _pg_user receives the data decoded from the packet\n";
+            if(hasSpans())
+                output += " * \\param _pg_arena provides the storage for the spans of _pg_user\n";
         }
+        else if((getNumberOfDecodeParameters() > 0) && hasSpans())
+            output += " * \\param _pg_arena provides the storage for the spans of this " + typeName + "\n";
+        output += " * \\return " + getReturnCode(false) + " is returned if the packet ID or size is wrong, else " + getReturnCode(true) + "\n";
+        output += " */\n";
+        output += getStructurePacketDecodeSignature(true) + "\n";
+        output += "{\n";
+        output += TAB_IN + "int _pg_numbytes;\n";
+        output += TAB_IN + "int _pg_byteindex = 0;\n";
+        output += TAB_IN + "const uint8_t* _pg_data;\n";
 
-        if(needsDecodeIterator)
-            output += TAB_IN + "unsigned _pg_i = 0;\n";
-        if(needs2ndDecodeIterator)
-            output += TAB_IN + "unsigned _pg_j = 0;\n";
+        // The interpreter of a table driven packet, or the function of a
+        // structure with the same layout, needs no temporaries
+        if(!tableDriven && (packetLayout == nullptr))
+        {
+            if(usestempdecodebitfields)
+                output += TAB_IN + "unsigned int _pg_tempbitfield = 0;\n";
+
+            if(usestempdecodelongbitfields)
+                output += TAB_IN + "uint64_t _pg_templongbitfield = 0;\n";
+
+            if(numbitfieldgroupbytes > 0)
+            {
+                output += TAB_IN + "int _pg_bitfieldindex = 0;\n";
+                output += TAB_IN + "uint8_t _pg_bitfieldbytes[" + std::to_string(numbitfieldgroupbytes) + "];\n";
+            }
+
+            if(needsDecodeIterator)
+                output += TAB_IN + "unsigned _pg_i = 0;\n";
+            if(needs2ndDecodeIterator)
+                output += TAB_IN + "unsigned _pg_j = 0;\n";
+        }
         output += "\n";
 
         if(ids.size() <= 1)
         {
             output += TAB_IN + "// Verify the packet identifier\n";
-            output += TAB_IN + "if(get"+ support.protoName + "PacketID(_pg_pkt) != " + id + ")\n";
+            output += TAB_IN + "if(get"+ support.protoName() + "PacketID(_pg_pkt) != " + id + ")\n";
         }
         else
         {
             output += TAB_IN + "// Verify the packet identifier, multiple options exist\n";
-            output += TAB_IN + "uint32_t _pg_packetid = get"+ support.protoName + "PacketID(_pg_pkt);\n";
+            output += TAB_IN + "uint32_t _pg_packetid = get"+ support.protoName() + "PacketID(_pg_pkt);\n";
             output += TAB_IN + "if( _pg_packetid != " + ids.at(0);
             for(std::size_t i = 1; i < ids.size(); i++)
                 output += " &&\n" + TAB_IN + TAB_IN + "_pg_packetid != " + ids.at(i);
@@ -1202,61 +1827,93 @@ std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
         output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
         output += "\n";
         output += TAB_IN + "// Verify the packet size\n";
-        output += TAB_IN + "_pg_numbytes = get" + support.protoName + "PacketSize(_pg_pkt);\n";
+        output += TAB_IN + "_pg_numbytes = get" + support.protoName() + "PacketSize(_pg_pkt);\n";
         if(support.language == ProtocolSupport::c_language)
-            output += TAB_IN + "if(_pg_numbytes < get" + support.prefix + name + "MinDataLength())\n";
+            output += TAB_IN + "if(_pg_numbytes < get" + support.prefix() + name + "MinDataLength())\n";
         else
             output += TAB_IN + "if(_pg_numbytes < minLength())\n";
         output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
         output += "\n";
         output += TAB_IN + "// The raw data from the packet\n";
-        output += TAB_IN + "_pg_data = get" + support.protoName + "PacketDataConst(_pg_pkt);\n";
+        output += TAB_IN + "_pg_data = get" + support.protoName() + "PacketDataConst(_pg_pkt);\n";
         output += "\n";
-        if(defaults)
+        if(tableDriven)
         {
-            output += TAB_IN + "// this packet has default fields, make sure they are set\n";
+            // The interpreter checks each field against the packet size as it decodes
+            output += TAB_IN + "return decodeFromDescriptor(&descriptor" + typeName + ", _pg_data, &_pg_byteindex, _pg_numbytes, _pg_user);\n";
+        }
+        else if(packetLayout != nullptr)
+        {
+            // A structure with the same layout decodes the fields
+            std::string user = "_pg_user";
 
-            for(std::size_t i = 0; i < encodables.size(); i++)
-                output += encodables[i]->getSetToDefaultsString(true);
+            // The storage for spans comes from the arena
+            if(hasSpans())
+                user += ", _pg_arena";
 
-        }// if defaults are used in this packet
+            output += TAB_IN + "if(decode" + packetLayout->typeName + "(_pg_data, &_pg_byteindex, " + user + ") == 0)\n";
+            output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
 
-        ProtocolFile::makeLineSeparator(output);
+            if(encodedLength.minEncodedLength != encodedLength.nonDefaultEncodedLength)
+            {
+                output += "\n";
+                output += TAB_IN + "// Used variable length arrays or dependent fields, check actual length\n";
+                output += TAB_IN + "if(_pg_numbytes < _pg_byteindex)\n";
+                output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
+            }
 
-        // Keep our own track of the bitcount so we know what to do when we close the bitfield
-        int bitcount = 0;
-        std::size_t i;
-        for(i = 0; i < encodables.size(); i++)
+            output += "\n";
+            output += TAB_IN + "return " + getReturnCode(true) + ";\n";
+        }
+        else
         {
-            ProtocolFile::makeLineSeparator(output);
+            if(defaults)
+            {
+                output += TAB_IN + "// this packet has default fields, make sure they are set\n";
 
-            // Encode just the nondefaults here
-            if(encodables[i]->isDefault())
-                break;
+                for(std::size_t i = 0; i < encodables.size(); i++)
+                    output += encodables[i]->getSetToDefaultsString(true);
 
-            output += encodables[i]->getDecodeString(support.bigendian, &bitcount, true, true);
-        }
+            }// if defaults are used in this packet
 
-        // Before we write out the decodes for default fields we need to check
-        // packet size in the event that we were using variable length arrays
-        // or dependent fields
-        if((encodedLength.minEncodedLength != encodedLength.nonDefaultEncodedLength) && (i > 0))
-        {
             ProtocolFile::makeLineSeparator(output);
-            output += TAB_IN + "// Used variable length arrays or dependent fields, check actual length\n";
-            output += TAB_IN + "if(_pg_numbytes < _pg_byteindex)\n";
-            output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
-        }
 
-        // Now finish the fields (if any defaults)
-        for(; i < encodables.size(); i++)
-        {
+            // Keep our own track of the bitcount so we know what to do when we close the bitfield
+            int bitcount = 0;
+            std::size_t i;
+            for(i = 0; i < encodables.size(); i++)
+            {
+                ProtocolFile::makeLineSeparator(output);
+
+                // Encode just the nondefaults here
+                if(encodables[i]->isDefault())
+                    break;
+
+                output += encodables[i]->getDecodeString(support.bigendian, &bitcount, true, true);
+            }
+
+            // Before we write out the decodes for default fields we need to check
+            // packet size in the event that we were using variable length arrays
+            // or dependent fields
+            if((encodedLength.minEncodedLength != encodedLength.nonDefaultEncodedLength) && (i > 0))
+            {
+                ProtocolFile::makeLineSeparator(output);
+                output += TAB_IN + "// Used variable length arrays or dependent fields, check actual length\n";
+                output += TAB_IN + "if(_pg_numbytes < _pg_byteindex)\n";
+                output += TAB_IN + TAB_IN + "return " + getReturnCode(false) + ";\n";
+            }
+
+            // Now finish the fields (if any defaults)
+            for(; i < encodables.size(); i++)
+            {
+                ProtocolFile::makeLineSeparator(output);
+                output += encodables[i]->getDecodeString(support.bigendian, &bitcount, true, true);
+            }
+
             ProtocolFile::makeLineSeparator(output);
-            output += encodables[i]->getDecodeString(support.bigendian, &bitcount, true, true);
-        }
+            output += TAB_IN + "return " + getReturnCode(true) + ";\n";
 
-        ProtocolFile::makeLineSeparator(output);
-        output += TAB_IN + "return " + getReturnCode(true) + ";\n";
+        }// else if not table driven
 
     }// if fields to decode
     else
@@ -1273,12 +1930,12 @@ std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
         if(ids.size() <= 1)
         {
             output += TAB_IN + "// Verify the packet identifier\n";
-            output += TAB_IN + "if(get"+ support.protoName + "PacketID(_pg_pkt) != " + id + ")\n";
+            output += TAB_IN + "if(get"+ support.protoName() + "PacketID(_pg_pkt) != " + id + ")\n";
         }
         else
         {
             output += TAB_IN + "// Verify the packet identifier, multiple options exist\n";
-            output += TAB_IN + "uint32_t _pg_packetid = get"+ support.protoName + "PacketID(_pg_pkt);\n";
+            output += TAB_IN + "uint32_t _pg_packetid = get"+ support.protoName() + "PacketID(_pg_pkt);\n";
             output += TAB_IN + "if( _pg_packetid != " + ids.at(0);
             for(std::size_t i = 1; i < ids.size(); i++)
                 output += " &&\n" + TAB_IN + TAB_IN + "_pg_packetid != " + ids.at(i);
@@ -1292,7 +1949,7 @@ std::string ProtocolPacket::getStructurePacketDecodeBody(void) const
 
     ProtocolFile::makeLineSeparator(output);
     if(support.language == ProtocolSupport::c_language)
-        output += "}// decode" + support.prefix + name + support.packetStructureSuffix + "\n";
+        output += "}// decode" + support.prefix() + name + support.packetStructureSuffix() + "\n";
     else
         output += "}// " + typeName + "::decode\n";
 
@@ -1359,7 +2016,7 @@ std::string ProtocolPacket::getParameterPacketEncodeSignature(bool insource) con
 
     if(support.language == ProtocolSupport::c_language)
     {
-        output = "void encode" + support.prefix + name + support.packetParameterSuffix + "(" + support.pointerType + " " + pg + "pkt";
+        output = "void encode" + support.prefix() + name + support.packetParameterSuffix() + "(" + support.pointerType() + " " + pg + "pkt";
     }
     else
     {
@@ -1373,7 +2030,7 @@ std::string ProtocolPacket::getParameterPacketEncodeSignature(bool insource) con
         if(insource)
             output += typeName + "::";
 
-        output += "encode(" + support.pointerType + " " + pg + "pkt";
+        output += "encode(" + support.pointerType() + " " + pg + "pkt";
     }
 
     output += getDataEncodeParameterList();
@@ -1422,7 +2079,7 @@ std::string ProtocolPacket::getParameterPacketEncodeBody(void) const
     if(ids.size() > 1)
         id = "_pg_id";
     else if(support.language == ProtocolSupport::c_language)
-        id = "get" + support.prefix + name + support.packetParameterSuffix + "ID()";
+        id = "get" + support.prefix() + name + support.packetParameterSuffix() + "ID()";
     else
         id = "id()";
 
@@ -1443,7 +2100,7 @@ std::string ProtocolPacket::getParameterPacketEncodeBody(void) const
 
     if(!encodedLength.isZeroLength())
     {
-        output += TAB_IN + "uint8_t* _pg_data = get"+ support.protoName + "PacketData(_pg_pkt);\n";
+        output += TAB_IN + "uint8_t* _pg_data = get"+ support.protoName() + "PacketData(_pg_pkt);\n";
         output += TAB_IN + "int _pg_byteindex = 0;\n";
 
         if(usestempencodebitfields)
@@ -1473,18 +2130,18 @@ std::string ProtocolPacket::getParameterPacketEncodeBody(void) const
 
         ProtocolFile::makeLineSeparator(output);
         output += TAB_IN + "// complete the process of creating the packet\n";
-        output += TAB_IN + "finish" + support.protoName + "Packet(_pg_pkt, _pg_byteindex, " + id + ");\n";
+        output += TAB_IN + "finish" + support.protoName() + "Packet(_pg_pkt, _pg_byteindex, " + id + ");\n";
     }
     else
     {
         ProtocolFile::makeLineSeparator(output);
         output += TAB_IN + "// Zero length packet, no data encoded\n";
-        output += TAB_IN + "finish" + support.protoName + "Packet(_pg_pkt, 0, " + id + ");\n";
+        output += TAB_IN + "finish" + support.protoName() + "Packet(_pg_pkt, 0, " + id + ");\n";
     }
 
     ProtocolFile::makeLineSeparator(output);
     if(support.language == ProtocolSupport::c_language)
-        output += "}// encode" + support.prefix + name + support.packetParameterSuffix + "\n";
+        output += "}// encode" + support.prefix() + name + support.packetParameterSuffix() + "\n";
     else
         output += "}// " + typeName + "::encode\n";
 
@@ -1511,7 +2168,7 @@ std::string ProtocolPacket::getParameterPacketDecodeSignature(bool insource) con
 
     if(support.language == ProtocolSupport::c_language)
     {
-        output = "int decode" + support.prefix + name + support.packetParameterSuffix + "(const " + support.pointerType + " " + pg + "pkt";
+        output = "int decode" + support.prefix() + name + support.packetParameterSuffix() + "(const " + support.pointerType() + " " + pg + "pkt";
     }
     else
     {
@@ -1525,10 +2182,21 @@ std::string ProtocolPacket::getParameterPacketDecodeSignature(bool insource) con
         if(insource)
             output += typeName + "::";
 
-        output += "decode(const " + support.pointerType + " " + pg + "pkt";
+        output += "decode(const " + support.pointerType() + " " + pg + "pkt";
+    }
+
+    output += getDataDecodeParameterList();
+
+    // The storage for spans of structure parameters comes from an arena
+    if(parametersUseArena())
+    {
+        if(support.language == ProtocolSupport::c_language)
+            output += ", pgarena_t* " + pg + "arena";
+        else
+            output += ", pgarena_t& " + pg + "arena";
     }
 
-    output += getDataDecodeParameterList() + ")";
+    output += ")";
 
     return output;
 
@@ -1570,7 +2238,7 @@ std::string ProtocolPacket::getParameterPacketDecodeBody(void) const
     if(ids.size() <= 1)
     {
         if(support.language == ProtocolSupport::c_language)
-            id = "get" + support.prefix + name + support.packetParameterSuffix + "ID()";
+            id = "get" + support.prefix() + name + support.packetParameterSuffix() + "ID()";
         else
             id = "id()";
     }
@@ -1583,6 +2251,9 @@ std::string ProtocolPacket::getParameterPacketDecodeBody(void) const
     for(i = 0; i < encodables.size(); i++)
         output += encodables.at(i)->getDecodeParameterComment();
 
+    if(parametersUseArena())
+        output += " * \\param _pg_arena provides the storage for the spans of the structure parameters\n";
+
     if(support.language == ProtocolSupport::c_language)
         output += " * \\return 0 is returned if the packet ID or size is wrong, else 1\n";
     else
@@ -1611,19 +2282,19 @@ std::string ProtocolPacket::getParameterPacketDecodeBody(void) const
         if(needs2ndDecodeIterator)
             output += TAB_IN + "unsigned _pg_j = 0;\n";
         output += TAB_IN + "int _pg_byteindex = 0;\n";
-        output += TAB_IN + "const uint8_t* _pg_data = get" + support.protoName + "PacketDataConst(_pg_pkt);\n";
-        output += TAB_IN + "int _pg_numbytes = get" + support.protoName + "PacketSize(_pg_pkt);\n";
+        output += TAB_IN + "const uint8_t* _pg_data = get" + support.protoName() + "PacketDataConst(_pg_pkt);\n";
+        output += TAB_IN + "int _pg_numbytes = get" + support.protoName() + "PacketSize(_pg_pkt);\n";
         output += "\n";
 
         if(ids.size() <= 1)
         {
             output += TAB_IN + "// Verify the packet identifier\n";
-            output += TAB_IN + "if(get"+ support.protoName + "PacketID(_pg_pkt) != " + id + ")\n";
+            output += TAB_IN + "if(get"+ support.protoName() + "PacketID(_pg_pkt) != " + id + ")\n";
         }
         else
         {
             output += TAB_IN + "// Verify the packet identifier, multiple options exist\n";
-            output += TAB_IN + "uint32_t packetid = get"+ support.protoName + "PacketID(_pg_pkt);\n";
+            output += TAB_IN + "uint32_t packetid = get"+ support.protoName() + "PacketID(_pg_pkt);\n";
             output += TAB_IN + "if( packetid != " + ids.at(0);
             for(i = 1; i < ids.size(); i++)
                 output += " &&\n        packetid != " + ids.at(i);
@@ -1633,7 +2304,7 @@ std::string ProtocolPacket::getParameterPacketDecodeBody(void) const
 
         output += "\n";
         if(support.language == ProtocolSupport::c_language)
-            output += TAB_IN + "if(_pg_numbytes < get" + support.prefix + name + "MinDataLength())\n";
+            output += TAB_IN + "if(_pg_numbytes < get" + support.prefix() + name + "MinDataLength())\n";
         else
             output += TAB_IN + "if(_pg_numbytes < minLength())\n";
         output += TAB_IN + TAB_IN + "return 0;\n";
@@ -1687,12 +2358,12 @@ std::string ProtocolPacket::getParameterPacketDecodeBody(void) const
         if(ids.size() <= 1)
         {
             output += TAB_IN + "// Verify the packet identifier\n";
-            output += TAB_IN + "if(get"+ support.protoName + "PacketID(_pg_pkt) != " + id + ")\n";
+            output += TAB_IN + "if(get"+ support.protoName() + "PacketID(_pg_pkt) != " + id + ")\n";
         }
         else
         {
             output += TAB_IN + "// Verify the packet identifier, multiple options exist\n";
-            output += TAB_IN + "uint32_t packetid = get"+ support.protoName + "PacketID(_pg_pkt);\n";
+            output += TAB_IN + "uint32_t packetid = get"+ support.protoName() + "PacketID(_pg_pkt);\n";
             output += TAB_IN + "if( packetid != " + ids.at(0);
             for(i = 1; i < ids.size(); i++)
                 output += " &&\n        packetid != " + ids.at(i);
@@ -1706,7 +2377,7 @@ std::string ProtocolPacket::getParameterPacketDecodeBody(void) const
 
     ProtocolFile::makeLineSeparator(output);
     if(support.language == ProtocolSupport::c_language)
-        output += "}// decode" + support.prefix + name + support.packetParameterSuffix + "\n";
+        output += "}// decode" + support.prefix() + name + support.packetParameterSuffix() + "\n";
     else
         output += "}// " + typeName + "::decode\n";
 
@@ -1720,7 +2391,7 @@ std::string ProtocolPacket::getParameterPacketDecodeBody(void) const
  */
 std::string ProtocolPacket::getPacketEncodeBriefComment(void) const
 {
-    return std::string("Create the " + support.prefix + name + " packet");
+    return std::string("Create the " + support.prefix() + name + " packet");
 }
 
 
@@ -1729,7 +2400,7 @@ std::string ProtocolPacket::getPacketEncodeBriefComment(void) const
  */
 std::string ProtocolPacket::getPacketDecodeBriefComment(void) const
 {
-    return std::string("Decode the " + support.prefix + name + " packet");
+    return std::string("Decode the " + support.prefix() + name + " packet");
 }
 
 
@@ -1761,12 +2432,387 @@ std::string ProtocolPacket::getDataDecodeParameterList(void) const
 }
 
 
+/*!
+ * Determine if the parameter decode function draws storage from an arena.
+ * Parameters are never spans, but they can be structures with spans.
+ * \return true if any parameter needs the arena to decode
+ */
+bool ProtocolPacket::parametersUseArena(void) const
+{
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->usesArena(false))
+            return true;
+    }
+
+    return false;
+
+}// ProtocolPacket::parametersUseArena
+
+
+/*!
+ * Get the code that declares an arena, and its storage, which the compare
+ * and print functions use to decode packets whose structure has spans.
+ * \param count is the number of packets that will be decoded
+ * \return the declaration code, which is empty if the structure has no spans
+ */
+std::string ProtocolPacket::getSpanArenaDeclaration(int count) const
+{
+    std::string output;
+
+    if(!hasSpans())
+        return output;
+
+    std::string storage;
+
+    if(support.language == ProtocolSupport::c_language)
+        storage = "get" + support.prefix() + name + "MaxSpanStorage()";
+    else
+        storage = typeName + "::maxSpanStorage()";
+
+    if(count > 1)
+        storage = std::to_string(count) + "*" + storage;
+
+    output += TAB_IN + "// Storage for the spans of the decoded structure\n";
+    output += TAB_IN + "uint8_t _pg_storage[" + storage + "];\n";
+
+    output += TAB_IN + "pgarena_t _pg_arena;\n";
+    output += TAB_IN + "initArena(&_pg_arena, _pg_storage, sizeof(_pg_storage));\n";
+
+    return output;
+
+}// ProtocolPacket::getSpanArenaDeclaration
+
+
+/*!
+ * Get the code that declares a temporary structure, named _pg_user, for
+ * decoding this packet, and the arena for its spans.
+ * \param arena receives the argument that passes the arena to the decode
+ *        function, including the leading comma, or is empty if there are no spans
+ * \return the declaration code
+ */
+std::string ProtocolPacket::getDecodeTemporaryDeclaration(std::string& arena) const
+{
+    std::string output;
+
+    arena.clear();
+
+    // In C++ the class of this packet has the decode function
+    if(support.language == ProtocolSupport::c_language)
+        output += TAB_IN + structName + " _pg_user;\n";
+    else
+        output += TAB_IN + typeName + " _pg_user;\n";
+
+    // Spans draw their storage from an arena
+    if(hasSpans())
+    {
+        output += getSpanArenaDeclaration(1);
+
+        if(support.language == ProtocolSupport::c_language)
+            arena = ", &_pg_arena";
+        else
+            arena = ", _pg_arena";
+    }
+
+    return output;
+
+}// ProtocolPacket::getDecodeTemporaryDeclaration
+
+
+/*!
+ * Get the maximum number of data bytes of this packet, computed from the
+ * maximum encoded length with the enumerations replaced by their values.
+ * \return the maximum data length, which is zero if it cannot be computed
+ */
+int ProtocolPacket::getMaxDataLength(void) const
+{
+    return (int)(ShuntingYard::computeInfix(parser->replaceEnumerationNameWithValue(encodedLength.maxEncodedLength)) + 0.5);
+
+}// ProtocolPacket::getMaxDataLength
+
+
+/*!
+ * Get the function that the replay tool uses to decode this packet from a
+ * frame. It decodes to a temporary, only to find out if the packet is good.
+ * \return the function, which is empty if there is no structure decode function
+ */
+std::string ProtocolPacket::getReplayDecodeFunction(void) const
+{
+    std::string output;
+
+    int numDecodes = getNumberOfDecodeParameters();
+
+    if(!decode || !structureFunctions || ((numDecodes <= 0) && parameterFunctions))
+        return output;
+
+    output += "//! Decode a " + support.prefix() + name + " packet, returning true if it is good\n";
+    output += "bool replay" + support.prefix() + name + "(const " + support.pointerType() + " pkt)\n";
+    output += "{\n";
+
+    std::string arena;
+
+    if(numDecodes > 0)
+        output += getDecodeTemporaryDeclaration(arena) + "\n";
+
+    if(support.language == ProtocolSupport::c_language)
+    {
+        if(numDecodes > 0)
+            output += TAB_IN + "return decode" + extendedName() + "(pkt, &_pg_user" + arena + ") != 0;\n";
+        else
+            output += TAB_IN + "return decode" + extendedName() + "(pkt) != 0;\n";
+    }
+    else
+    {
+        if(numDecodes > 0)
+            output += TAB_IN + "return _pg_user.decode(pkt" + arena + ");\n";
+        else
+            output += TAB_IN + "return " + typeName + "::decode(pkt);\n";
+    }
+
+    output += "}\n";
+
+    return output;
+
+}// ProtocolPacket::getReplayDecodeFunction
+
+
+/*!
+ * Get the entries for this packet in the replay tool's table of packet types,
+ * one for each identifier. Packets without a structure decode function are
+ * counted, but not decoded.
+ * \return the table entries, with line feeds
+ */
+std::string ProtocolPacket::getReplayPacketTypes(void) const
+{
+    std::string output;
+
+    std::string function = "nullptr";
+    if(!getReplayDecodeFunction().empty())
+        function = "replay" + support.prefix() + name;
+
+    for(std::size_t i = 0; i < ids.size(); i++)
+        output += TAB_IN + "{(uint32_t)(" + ids.at(i) + "), \"" + support.prefix() + name + "\", " + function + "},\n";
+
+    return output;
+
+}// ProtocolPacket::getReplayPacketTypes
+
+
+/*!
+ * Return the string that gives the prototype of the function used to append
+ * the structure of this packet to the columns of a table
+ * \param includeChildren should be true to include the function prototypes
+ *        of the child structures
+ * \return the prototype, which is empty if this packet has no structure
+ */
+std::string ProtocolPacket::getColumnAppendFunctionPrototype(bool includeChildren) const
+{
+    if(!useInOtherPackets && !structureFunctions)
+        return std::string();
+
+    return ProtocolStructure::getColumnAppendFunctionPrototype(includeChildren);
+
+}// ProtocolPacket::getColumnAppendFunctionPrototype
+
+
+/*!
+ * Return the string that gives the function used to append the structure of
+ * this packet to the columns of a table
+ * \param includeChildren should be true to include the functions of the child structures
+ * \return the function, which is empty if this packet has no structure
+ */
+std::string ProtocolPacket::getColumnAppendFunctionBody(bool includeChildren) const
+{
+    if(!useInOtherPackets && !structureFunctions)
+        return std::string();
+
+    return ProtocolStructure::getColumnAppendFunctionBody(includeChildren);
+
+}// ProtocolPacket::getColumnAppendFunctionBody
+
+
+/*!
+ * Get the prototype of the function that decodes this packet and appends it
+ * to the columns of a table
+ * \return the prototype, which is empty if there is no structure decode function
+ */
+std::string ProtocolPacket::getColumnAppendPacketPrototype(void) const
+{
+    std::string output;
+
+    if(!decode || !structureFunctions || (getNumberOfDecodeParameters() <= 0))
+        return output;
+
+    output += "//! Decode a " + support.prefix() + name + " packet and append it as a row of a table\n";
+    output += "bool append" + support.prefix() + name + "Columns(PgColumnTable& table, const " + support.pointerType() + " pkt);\n";
+
+    return output;
+
+}// ProtocolPacket::getColumnAppendPacketPrototype
+
+
+/*!
+ * Get the function that decodes this packet and appends it to the columns of
+ * a table. The packet is decoded to a temporary, which is appended as one row.
+ * \return the function, which is empty if there is no structure decode function
+ */
+std::string ProtocolPacket::getColumnAppendPacketBody(void) const
+{
+    std::string output;
+
+    if(!decode || !structureFunctions || (getNumberOfDecodeParameters() <= 0))
+        return output;
+
+    std::string arena;
+
+    output += "/*!\n";
+    output += " * Decode a " + support.prefix() + name + " packet and append it as a row of a table\n";
+    output += " * \\param _pg_table is the table to append to\n";
+    output += " * \\param _pg_pkt is the packet to decode\n";
+    output += " * \\return true if the packet was decoded and appended\n";
+    output += " */\n";
+    output += "bool append" + support.prefix() + name + "Columns(PgColumnTable& _pg_table, const " + support.pointerType() + " _pg_pkt)\n";
+    output += "{\n";
+    output += getDecodeTemporaryDeclaration(arena);
+    output += "\n";
+
+    if(support.language == ProtocolSupport::c_language)
+        output += TAB_IN + "if(!decode" + extendedName() + "(_pg_pkt, &_pg_user" + arena + "))\n";
+    else
+        output += TAB_IN + "if(!_pg_user.decode(_pg_pkt" + arena + "))\n";
+    output += TAB_IN + TAB_IN + "return false;\n";
+    output += "\n";
+    output += TAB_IN + "_pg_table.beginRow();\n";
+    output += TAB_IN + "appendColumns(_pg_table, std::string(), &_pg_user);\n";
+    output += TAB_IN + "_pg_table.endRow();\n";
+    output += "\n";
+    output += TAB_IN + "return true;\n";
+    output += "\n";
+    output += "}// append" + support.prefix() + name + "Columns\n";
+
+    return output;
+
+}// ProtocolPacket::getColumnAppendPacketBody
+
+
+/*!
+ * Determine if the structure of this packet can be copied byte for byte
+ * through shared memory. Spans point into storage that belongs to the
+ * process that decoded them, so structures with spans cannot be shared.
+ * \return true if there is a structure, and it has no spans
+ */
+bool ProtocolPacket::isShmStructure(void) const
+{
+    return structureFunctions && (getNumberOfDecodeParameters() > 0) && !hasSpans();
+
+}// ProtocolPacket::isShmStructure
+
+
+/*!
+ * Get the name of the structure of this packet, which is the class in C++
+ * \return the name of the structure
+ */
+std::string ProtocolPacket::getUserTypeName(void) const
+{
+    if(support.language == ProtocolSupport::c_language)
+        return structName;
+    else
+        return typeName;
+
+}// ProtocolPacket::getUserTypeName
+
+
+/*!
+ * Get the prototypes of the functions that publish the structure of this
+ * packet to shared memory, and read it back in another process
+ * \return the prototypes, which are empty if the structure cannot be shared
+ */
+std::string ProtocolPacket::getShmPrototype(void) const
+{
+    std::string output;
+
+    if(!isShmStructure())
+        return output;
+
+    output += "//! Publish a decoded " + support.prefix() + name + " structure to shared memory\n";
+    output += "bool publish" + support.prefix() + name + "Shm(PgShmChannel& channel, const " + getUserTypeName() + "* user);\n";
+    output += "\n";
+    output += "//! Copy a " + support.prefix() + name + " structure from a message read from shared memory\n";
+    output += "bool read" + support.prefix() + name + "Shm(const PgShmMessage& message, " + getUserTypeName() + "* user);\n";
+
+    return output;
+
+}// ProtocolPacket::getShmPrototype
+
+
+/*!
+ * Get the functions that publish the structure of this packet to shared
+ * memory, and read it back in another process. The structure is copied byte
+ * for byte, so the processes must be built from the same protocol.
+ * \return the functions, which are empty if the structure cannot be shared
+ */
+std::string ProtocolPacket::getShmBody(void) const
+{
+    std::string output;
+
+    if(!isShmStructure())
+        return output;
+
+    std::string type = getUserTypeName();
+
+    output += "static_assert(std::is_trivially_copyable<" + type + ">::value, \"" + type + " must be trivially copyable to be shared\");\n";
+    output += "\n";
+    output += "/*!\n";
+    output += " * Publish a decoded " + support.prefix() + name + " structure to shared memory\n";
+    output += " * \\param _pg_channel is the channel to publish to\n";
+    output += " * \\param _pg_user is the structure to publish\n";
+    output += " * \\return true if the structure was published\n";
+    output += " */\n";
+    output += "bool publish" + support.prefix() + name + "Shm(PgShmChannel& _pg_channel, const " + type + "* _pg_user)\n";
+    output += "{\n";
+    output += TAB_IN + "return _pg_channel.publish((uint32_t)(" + ids.at(0) + "), PgShmChannel::Structure, _pg_user, sizeof(" + type + "));\n";
+    output += "}// publish" + support.prefix() + name + "Shm\n";
+    output += "\n";
+    output += "\n";
+    output += "/*!\n";
+    output += " * Copy a " + support.prefix() + name + " structure from a message read from shared memory\n";
+    output += " * \\param _pg_message is the message\n";
+    output += " * \\param _pg_user receives the structure\n";
+    output += " * \\return true if the message is a " + support.prefix() + name + " structure\n";
+    output += " */\n";
+    output += "bool read" + support.prefix() + name + "Shm(const PgShmMessage& _pg_message, " + type + "* _pg_user)\n";
+    output += "{\n";
+    output += TAB_IN + "if((_pg_message.kind != PgShmChannel::Structure) || (_pg_message.size != sizeof(" + type + ")))\n";
+    output += TAB_IN + TAB_IN + "return false;\n";
+    output += "\n";
+
+    if(ids.size() <= 1)
+        output += TAB_IN + "if(_pg_message.id != (uint32_t)(" + ids.at(0) + "))\n";
+    else
+    {
+        output += TAB_IN + "if( _pg_message.id != (uint32_t)(" + ids.at(0) + ")";
+        for(std::size_t i = 1; i < ids.size(); i++)
+            output += " &&\n" + TAB_IN + TAB_IN + "_pg_message.id != (uint32_t)(" + ids.at(i) + ")";
+        output += " )\n";
+    }
+
+    output += TAB_IN + TAB_IN + "return false;\n";
+    output += "\n";
+    output += TAB_IN + "std::memcpy(_pg_user, _pg_message.data, sizeof(" + type + "));\n";
+    output += TAB_IN + "return true;\n";
+    output += "}// read" + support.prefix() + name + "Shm\n";
+
+    return output;
+
+}// ProtocolPacket::getShmBody
+
+
 /*!
  * \return The brief comment of the structure encode function, without doxygen decorations or line feed
  */
 std::string ProtocolPacket::getDataEncodeBriefComment(void) const
 {
-    return std::string("Create the " + support.prefix + name + " packet from parameters");
+    return std::string("Create the " + support.prefix() + name + " packet from parameters");
 }
 
 
@@ -1775,7 +2821,7 @@ std::string ProtocolPacket::getDataEncodeBriefComment(void) const
  */
 std::string ProtocolPacket::getDataDecodeBriefComment(void) const
 {
-    return std::string("Decode the " + support.prefix + name + " packet to parameters");
+    return std::string("Decode the " + support.prefix() + name + " packet to parameters");
 }
 
 
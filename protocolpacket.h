@@ -10,13 +10,28 @@ class ProtocolPacket : public ProtocolStructureModule
 {
 public:
     //! Construct the packet parsing object, with details about the overall protocol
-    ProtocolPacket(ProtocolParser* parse, ProtocolSupport supported, const std::string& protocolApi, const std::string& protocolVersion);
+    ProtocolPacket(ProtocolParser* parse, const ProtocolSupport& supported, const std::string& protocolApi, const std::string& protocolVersion);
 
     ~ProtocolPacket();
 
-    //! Parse a packet from the DOM
+    //! Parse a packet from the DOM, and output it
     void parse(void) override;
 
+    //! Parse a packet from the DOM, without any output
+    void parseDefinition(void) override;
+
+    //! Output a packet which has been parsed
+    void output(void) override;
+
+    //! Setup the files of a packet which has been parsed, because the output from the last generation is unchanged
+    void outputUnchanged(void) override;
+
+    //! Get the layout signature of this packet, if it can share functions with other packets
+    std::string getPacketLayoutSignature(void) const;
+
+    //! Output byte array functions, because a later packet has the same layout
+    void enableLayoutFunctions(void) {layoutFunctions = true;}
+
     //! Clear out any data
     void clear(void) override;
 
@@ -30,7 +45,46 @@ public:
     void appendIds(std::vector<std::string>& list) const {list.insert(list.end(), ids.begin(), ids.end());}
 
     //! Return the extended packet name
-    std::string extendedName() const { return support.prefix + this->name + support.packetStructureSuffix; }
+    std::string extendedName() const { return support.prefix() + this->name + support.packetStructureSuffix(); }
+
+    //! True if this packet outputs a scatter gather encode function
+    bool isIovEncode(void) const {return iovEncode;}
+
+    //! True if this packet outputs a ring buffer encode function
+    bool isRingEncode(void) const {return ringEncode;}
+
+    //! Get the maximum number of data bytes of this packet, as a number
+    int getMaxDataLength(void) const;
+
+    //! Get the function that the replay tool uses to decode this packet
+    std::string getReplayDecodeFunction(void) const;
+
+    //! Get the entries for this packet in the replay tool's table of packet types
+    std::string getReplayPacketTypes(void) const;
+
+    //! Return the string that gives the prototype of the function used to append this structure to the columns of a table
+    std::string getColumnAppendFunctionPrototype(bool includeChildren = true) const override;
+
+    //! Return the string that gives the function used to append this structure to the columns of a table
+    std::string getColumnAppendFunctionBody(bool includeChildren = true) const override;
+
+    //! Get the prototype of the function that decodes this packet and appends it to the columns of a table
+    std::string getColumnAppendPacketPrototype(void) const;
+
+    //! Get the function that decodes this packet and appends it to the columns of a table
+    std::string getColumnAppendPacketBody(void) const;
+
+    //! True if the structure of this packet can be copied byte for byte through shared memory
+    bool isShmStructure(void) const;
+
+    //! Get the prototypes of the functions that publish and read the structure of this packet through shared memory
+    std::string getShmPrototype(void) const;
+
+    //! Get the functions that publish and read the structure of this packet through shared memory
+    std::string getShmBody(void) const;
+
+    //! Get the name of the structure of this packet, in the language of the protocol
+    std::string getUserTypeName(void) const;
 
 protected:
 
@@ -49,6 +103,9 @@ protected:
     //! Create the functions that encode and decode the structure
     void createStructurePacketFunctions(void);
 
+    //! Share the type and functions of earlier structures or packets with the same layout
+    void shareModuleLayouts(void) override;
+
     //! Create the functions that encode and decode the parameters
     void createPacketFunctions(void);
 
@@ -61,6 +118,30 @@ protected:
     //! Get the prototype for the structure packet encode function
     std::string getStructurePacketEncodeBody(void) const;
 
+    //! Get the code that encodes the fields of the packet from a structure or class
+    std::string getStructurePacketEncodeFields(const std::string& prologue = std::string()) const;
+
+    //! Get the signature of the packet structure scatter gather encode function
+    std::string getStructurePacketIovEncodeSignature(bool insource) const;
+
+    //! Get the prototype for the structure packet scatter gather encode function
+    std::string getStructurePacketIovEncodePrototype(const std::string& spacing) const;
+
+    //! Get the body for the structure packet scatter gather encode function
+    std::string getStructurePacketIovEncodeBody(void) const;
+
+    //! Get the signature of the packet structure ring buffer encode function
+    std::string getStructurePacketRingEncodeSignature(bool insource) const;
+
+    //! Get the prototype for the structure packet ring buffer encode function
+    std::string getStructurePacketRingEncodePrototype(const std::string& spacing) const;
+
+    //! Get the body for the structure packet ring buffer encode function
+    std::string getStructurePacketRingEncodeBody(void) const;
+
+    //! Return the number of fields that the scatter gather encode sends without copying
+    int getNumberOfZeroCopyFields(void) const;
+
     //! Get the signature of the packet structure decode function
     std::string getStructurePacketDecodeSignature(bool insource) const;
 
@@ -100,6 +181,15 @@ protected:
     //! Get the parameter list part of a decode signature like ", type1* name1, type2 name2[3] ... "
     std::string getDataDecodeParameterList(void) const;
 
+    //! Return true if the parameter decode function draws storage from an arena
+    bool parametersUseArena(void) const;
+
+    //! Get the code that gives the compare and print functions an arena for decoding
+    std::string getSpanArenaDeclaration(int count) const;
+
+    //! Get the code that declares a temporary structure for decoding this packet
+    std::string getDecodeTemporaryDeclaration(std::string& arena) const;
+
     //! Get the structure encode comment
     std::string getDataEncodeBriefComment(void) const;
 
@@ -117,6 +207,18 @@ protected:
     //! Flag to output structure functions
     bool structureFunctions;
 
+    //! Flag to output the byte array functions, so later packets with the same layout can share them
+    bool layoutFunctions;
+
+    //! Flag to output the scatter gather encode function
+    bool iovEncode;
+
+    //! Flag to output the ring buffer encode function
+    bool ringEncode;
+
+    //! Structure whose byte array functions encode and decode the fields of this packet
+    const ProtocolStructure* packetLayout;
+
     //! Packet identifier string
     std::vector<std::string> ids;
 
@@ -0,0 +1,823 @@
+#include "protocolpacketlog.h"
+#include <sstream>
+
+ProtocolPacketLog::ProtocolPacketLog(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolPacketLog::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*!
+ * Output C++ functions that write packets of this protocol to an indexed
+ * binary log, and read them back. The log header carries a fingerprint of the
+ * protocol: its api, its version, and a hash of the xml files it was parsed
+ * from. The generic log writer and reader helper module is output as well.
+ * \param protocolname is the name of the protocol
+ * \param protocolheader is the name of the main header of the protocol
+ * \param api is the api of the protocol
+ * \param version is the version of the protocol
+ * \param xmlhash is the hash of the xml files the protocol was parsed from
+ * \param fileNameList is appended with the names of the files that are output
+ * \param filePathList is appended with the paths of the files that are output
+ * \return true if the helper module was output
+ */
+bool ProtocolPacketLog::generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::string& api, const std::string& version, uint64_t xmlhash, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    std::ostringstream hashstring;
+    hashstring << "0x" << std::hex << std::uppercase << xmlhash << "ULL";
+
+    std::string pointer = support.pointerType();
+    std::string fingerprint = protocolname + "LogFingerprint";
+
+    ProtocolHeaderFile logheader(support);
+    ProtocolSourceFile logsource(support);
+
+    logheader.setModuleNameAndPath(protocolname + "Log", support.outputpath(), ProtocolSupport::cpp_language);
+    logsource.setModuleNameAndPath(protocolname + "Log", support.outputpath(), ProtocolSupport::cpp_language);
+
+    logheader.setFileComment("Functions that write " + protocolname + " packets to an indexed binary log, and read them back");
+
+    logheader.writeIncludeDirective("packetlog");
+    logheader.writeIncludeDirective(protocolheader, std::string(), false, false);
+    logheader.makeLineSeparator();
+
+    logheader.write("//! Identifies logs written by this version of the " + protocolname + " protocol\n");
+    logheader.write("extern const PgLogFingerprint " + fingerprint + ";\n\n");
+    logheader.write("//! Create a log of " + protocolname + " packets\n");
+    logheader.write("bool open" + protocolname + "LogWriter(PgLogWriter& log, const std::string& fileName);\n\n");
+    logheader.write("//! Append a " + protocolname + " packet to a log\n");
+    logheader.write("bool write" + protocolname + "Log(PgLogWriter& log, uint64_t time, const " + pointer + " pkt);\n\n");
+    logheader.write("//! Open a log, if it was written by this version of the " + protocolname + " protocol\n");
+    logheader.write("bool open" + protocolname + "LogReader(PgLogReader& log, const std::string& fileName);\n\n");
+    logheader.write("//! Copy a record of a log to a " + protocolname + " packet\n");
+    logheader.write("void read" + protocolname + "Log(const PgLogRecord& record, " + pointer + " pkt);\n");
+    logheader.makeLineSeparator();
+
+    logsource.makeLineSeparator();
+    logsource.write("//! Identifies logs written by this version of the " + protocolname + " protocol\n");
+    logsource.write("const PgLogFingerprint " + fingerprint + " = {\"" + api + "\", \"" + version + "\", " + hashstring.str() + "};\n");
+
+    logsource.write(R"(
+
+/*!
+ * Create a log of )" + protocolname + R"( packets, replacing any file with the same name
+ * \param log is the writer which is opened
+ * \param fileName is the name of the log file
+ * \return true if the log was created
+ */
+bool open)" + protocolname + R"(LogWriter(PgLogWriter& log, const std::string& fileName)
+{
+    return log.open(fileName, )" + fingerprint + R"();
+}// open)" + protocolname + R"(LogWriter
+
+
+/*!
+ * Append a )" + protocolname + R"( packet to a log
+ * \param log is the writer, which must be open
+ * \param time is the time of the packet, in any units, which the index is sorted by
+ * \param pkt is the packet
+ * \return true if the packet was written
+ */
+bool write)" + protocolname + R"(Log(PgLogWriter& log, uint64_t time, const )" + pointer + R"( pkt)
+{
+    return log.append(time, get)" + protocolname + R"(PacketID(pkt), get)" + protocolname + R"(PacketDataConst(pkt), (uint32_t)get)" + protocolname + R"(PacketSize(pkt));
+}// write)" + protocolname + R"(Log
+
+
+/*!
+ * Open a log, if it was written by this version of the )" + protocolname + R"( protocol.
+ * Use PgLogReader::open() to read a log from any version.
+ * \param log is the reader which is opened
+ * \param fileName is the name of the log file
+ * \return true if the log was opened, and its fingerprint matches
+ */
+bool open)" + protocolname + R"(LogReader(PgLogReader& log, const std::string& fileName)
+{
+    if(!log.open(fileName))
+        return false;
+
+    if(log.matches()" + fingerprint + R"())
+        return true;
+
+    log.close();
+    return false;
+}// open)" + protocolname + R"(LogReader
+
+
+/*!
+ * Copy a record of a log to a )" + protocolname + R"( packet, through the packet
+ * interface functions. The packet must be big enough for the record.
+ * \param record is the record from the log
+ * \param pkt is the packet that receives the record
+ */
+void read)" + protocolname + R"(Log(const PgLogRecord& record, )" + pointer + R"( pkt)
+{
+    std::memcpy(get)" + protocolname + R"(PacketData(pkt), record.data, record.size);
+    finish)" + protocolname + R"(Packet(pkt, (int)record.size, record.id);
+}// read)" + protocolname + R"(Log
+)");
+
+    bool helper = generate(fileNameList, filePathList);
+
+    logheader.flush();
+    fileNameList.push_back(logheader.fileName());
+    filePathList.push_back(logheader.filePath());
+
+    logsource.writeIncludeDirective("cstring", std::string(), true, false);
+    logsource.makeLineSeparator();
+    logsource.flush();
+    fileNameList.push_back(logsource.fileName());
+    filePathList.push_back(logsource.filePath());
+
+    return helper;
+
+}// ProtocolPacketLog::generateProtocol
+
+
+//! Generate the header file
+bool ProtocolPacketLog::generateHeader(void)
+{
+    header.setModuleNameAndPath("packetlog", support.outputpath(), ProtocolSupport::cpp_language);
+
+// Raw string magic here
+header.setFileComment(R"(\brief Binary log of packets, with a trailing index for each packet type
+
+The writer appends each packet as a record: its time, its identifier, its
+size, and its data. When the log is closed an index is appended, with a table
+for each packet identifier that gives the time and file offset of every
+record of that type, in time order. The header identifies the protocol that
+wrote the log: its api, its version, and a hash of its xml.
+
+The reader memory maps the log, and uses the index to find all the records
+of one type, or of one type in a time range, without scanning the file. A
+log that was not closed (for example because the writer crashed) has no
+index, in which case the reader scans the records once to build it.
+
+The file layout is described with PgLogWriter::open() and PgLogWriter::close().
+All numbers are in the byte order of the machine that wrote the log, and
+every item is aligned to 8 bytes.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("cstdint", std::string(), true, false);
+    header.writeIncludeDirective("cstdio", std::string(), true, false);
+    header.writeIncludeDirective("map", std::string(), true, false);
+    header.writeIncludeDirective("string", std::string(), true, false);
+    header.writeIncludeDirective("vector", std::string(), true, false);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! Identifies the protocol that wrote a log
+typedef struct
+{
+    const char* api;        //!< The api of the protocol
+    const char* version;    //!< The version of the protocol
+    uint64_t hash;          //!< The hash of the xml that describes the protocol
+}PgLogFingerprint;
+
+//! The header at the start of a log
+typedef struct
+{
+    char magic[8];          //!< "PGLOG1" and two zeroes
+    uint32_t byteOrder;     //!< 0x01020304 in the byte order of the writer
+    uint32_t headerSize;    //!< Size of this header in bytes
+    uint64_t hash;          //!< The hash of the xml that describes the protocol
+    char api[32];           //!< The api of the protocol, zero terminated
+    char version[32];       //!< The version of the protocol, zero terminated
+    uint64_t indexOffset;   //!< Offset of the index, zero if the log was not closed
+    uint64_t count;         //!< Number of records, zero if the log was not closed
+}PgLogHeader;
+
+//! The header of each record in a log, which is followed by the data of the packet
+typedef struct
+{
+    uint64_t time;          //!< The time given when the packet was written
+    uint32_t id;            //!< The identifier of the packet
+    uint32_t size;          //!< The number of bytes of packet data that follow
+}PgLogRecordHeader;
+
+//! An entry in the index of a log
+typedef struct
+{
+    uint64_t time;          //!< The time of the record
+    uint64_t offset;        //!< File offset of the record header
+}PgLogEntry;
+
+//! A record in a log, as found by the reader
+typedef struct
+{
+    uint64_t time;          //!< The time given when the packet was written
+    uint32_t id;            //!< The identifier of the packet
+    uint32_t size;          //!< The number of bytes of packet data
+    const uint8_t* data;    //!< The packet data, in the memory map of the log
+}PgLogRecord;
+
+
+//! Writes packets to a log, and the index when the log is closed
+class PgLogWriter
+{
+public:
+
+    //! Construct a writer, with no log open
+    PgLogWriter(void);
+
+    //! Close the log, if it is open
+    ~PgLogWriter(void);
+
+    //! Create a log, replacing any file with the same name
+    bool open(const std::string& fileName, const PgLogFingerprint& fingerprint);
+
+    //! Append a packet to the log
+    bool append(uint64_t time, uint32_t id, const uint8_t* data, uint32_t size);
+
+    //! Write the index and close the log
+    bool close(void);
+
+    //! Return true if a log is open
+    bool isOpen(void) const {return file != nullptr;}
+
+private:
+
+    //! Write bytes to the log, padded to 8 bytes
+    bool writePadded(const void* bytes, std::size_t size);
+
+    std::FILE* file;        //!< The log file
+    PgLogHeader header;     //!< The header, which is written again when the log is closed
+    uint64_t offset;        //!< Offset of the next record
+    uint64_t count;         //!< Number of records written
+    std::map<uint32_t, std::vector<PgLogEntry>> index;  //!< Index entries for each identifier
+};
+
+
+//! Reads a log through a memory map, finding records by their index
+class PgLogReader
+{
+public:
+
+    //! Construct a reader, with no log open
+    PgLogReader(void);
+
+    //! Close the log, if it is open
+    ~PgLogReader(void);
+
+    //! Open and memory map a log, reading or building its index
+    bool open(const std::string& fileName);
+
+    //! Unmap and close the log
+    void close(void);
+
+    //! Return the header of the log, which is only valid while the log is open
+    const PgLogHeader& header(void) const {return *(const PgLogHeader*)data;}
+
+    //! Return true if the log was written by the protocol with this fingerprint
+    bool matches(const PgLogFingerprint& fingerprint) const;
+
+    //! Return the packet identifiers in the log
+    std::vector<uint32_t> ids(void) const;
+
+    //! Return the number of records of one packet identifier
+    std::size_t count(uint32_t id) const;
+
+    //! Return the index entries of one packet identifier, in time order
+    const PgLogEntry* entries(uint32_t id, std::size_t& number) const;
+
+    //! Return the index entries of one packet identifier in a time range, in time order
+    const PgLogEntry* entries(uint32_t id, uint64_t first, uint64_t last, std::size_t& number) const;
+
+    //! Return the index entries of every packet identifier in a time range, in time order
+    std::vector<PgLogEntry> allEntries(uint64_t first, uint64_t last) const;
+
+    //! Return the record of an index entry
+    PgLogRecord record(const PgLogEntry& entry) const;
+
+private:
+
+    //! Build the index by scanning the records
+    bool scan(void);
+
+    //! The entries of one packet identifier
+    typedef struct
+    {
+        const PgLogEntry* entries;  //!< The entries, in the log or in rebuilt
+        std::size_t number;         //!< The number of entries
+    }Table;
+
+    const uint8_t* data;    //!< The memory map of the log
+    std::size_t size;       //!< The size of the log in bytes
+    std::map<uint32_t, Table> tables;   //!< The index, by identifier
+    std::map<uint32_t, std::vector<PgLogEntry>> rebuilt; //!< The index of a log that was not closed
+};
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolPacketLog::generateHeader
+
+
+//! Generate the source file
+bool ProtocolPacketLog::generateSource(void)
+{
+    source.setModuleNameAndPath("packetlog", support.outputpath(), ProtocolSupport::cpp_language);
+    source.writeIncludeDirective("algorithm", std::string(), true, false);
+    source.writeIncludeDirective("cstring", std::string(), true, false);
+    source.writeIncludeDirective("fcntl.h", std::string(), true, false);
+    source.writeIncludeDirective("sys/mman.h", std::string(), true, false);
+    source.writeIncludeDirective("sys/stat.h", std::string(), true, false);
+    source.writeIncludeDirective("unistd.h", std::string(), true, false);
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(//! The magic bytes at the start of the index
+static const char indexMagic[8] = {'P', 'G', 'L', 'O', 'G', 'I', 'X', 0};
+
+//! Return a size rounded up to a multiple of 8
+static uint64_t padded(uint64_t size)
+{
+    return (size + 7) & ~((uint64_t)7);
+}
+
+//! Order index entries by time
+static bool earlier(const PgLogEntry& one, const PgLogEntry& two)
+{
+    return one.time < two.time;
+}
+
+
+/*!
+ * Construct a writer, with no log open
+ */
+PgLogWriter::PgLogWriter(void) :
+    file(nullptr),
+    offset(0),
+    count(0)
+{
+}
+
+
+/*!
+ * Close the log, if it is open, which writes its index
+ */
+PgLogWriter::~PgLogWriter(void)
+{
+    close();
+}
+
+
+/*!
+ * Create a log, replacing any file with the same name, and write its header
+ * (PgLogHeader). The header is written again, with the offset of the index,
+ * when the log is closed.
+ * \param fileName is the name of the log file
+ * \param fingerprint identifies the protocol that writes the log
+ * \return true if the log was created
+ */
+bool PgLogWriter::open(const std::string& fileName, const PgLogFingerprint& fingerprint)
+{
+    close();
+
+    file = std::fopen(fileName.c_str(), "wb");
+    if(file == nullptr)
+        return false;
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "PGLOG1", 6);
+    header.byteOrder = 0x01020304;
+    header.headerSize = sizeof(header);
+    header.hash = fingerprint.hash;
+    std::strncpy(header.api, fingerprint.api, sizeof(header.api) - 1);
+    std::strncpy(header.version, fingerprint.version, sizeof(header.version) - 1);
+
+    offset = 0;
+    count = 0;
+    index.clear();
+
+    if(!writePadded(&header, sizeof(header)))
+    {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    return true;
+
+}// PgLogWriter::open
+
+
+/*!
+ * Write bytes to the log, padded with zeroes to a multiple of 8 bytes
+ * \param bytes are the bytes to write
+ * \param size is the number of bytes to write
+ * \return true if the bytes were written
+ */
+bool PgLogWriter::writePadded(const void* bytes, std::size_t size)
+{
+    static const uint8_t zeroes[8] = {0};
+    std::size_t pad = (std::size_t)(padded(size) - size);
+
+    if((size > 0) && (std::fwrite(bytes, 1, size, file) != size))
+        return false;
+
+    if((pad > 0) && (std::fwrite(zeroes, 1, pad, file) != pad))
+        return false;
+
+    offset += size + pad;
+
+    return true;
+
+}// PgLogWriter::writePadded
+
+
+/*!
+ * Append a packet to the log. The record is a PgLogRecordHeader followed by
+ * the packet data, padded to 8 bytes.
+ * \param time is the time of the packet, in any units, which the index is sorted by
+ * \param id is the identifier of the packet
+ * \param data is the packet data
+ * \param size is the number of bytes of packet data
+ * \return true if the packet was written
+ */
+bool PgLogWriter::append(uint64_t time, uint32_t id, const uint8_t* data, uint32_t size)
+{
+    if(file == nullptr)
+        return false;
+
+    PgLogEntry entry = {time, offset};
+    PgLogRecordHeader record = {time, id, size};
+
+    if(std::fwrite(&record, 1, sizeof(record), file) != sizeof(record))
+        return false;
+
+    offset += sizeof(record);
+
+    if(!writePadded(data, size))
+        return false;
+
+    index[id].push_back(entry);
+    count++;
+
+    return true;
+
+}// PgLogWriter::append
+
+
+/*!
+ * Write the index and close the log. The index is "PGLOGIX" and a zero, the
+ * uint64_t number of packet identifiers, and then a table for each
+ * identifier: uint32_t id, uint32_t zero, uint64_t number of entries, and
+ * then the entries (PgLogEntry) of that identifier in time order. The header
+ * is rewritten with the offset of the index and the number of records.
+ * \return true if the index was written
+ */
+bool PgLogWriter::close(void)
+{
+    if(file == nullptr)
+        return false;
+
+    bool good = true;
+
+    header.indexOffset = offset;
+    header.count = count;
+
+    uint64_t numTables = index.size();
+
+    good = good && writePadded(indexMagic, sizeof(indexMagic));
+    good = good && writePadded(&numTables, sizeof(numTables));
+
+    for(auto& table : index)
+    {
+        uint32_t id[2] = {table.first, 0};
+        uint64_t number = table.second.size();
+
+        // Packets are usually written in time order, in which case this does nothing
+        std::stable_sort(table.second.begin(), table.second.end(), earlier);
+
+        good = good && writePadded(id, sizeof(id));
+        good = good && writePadded(&number, sizeof(number));
+        good = good && writePadded(table.second.data(), table.second.size()*sizeof(PgLogEntry));
+    }
+
+    good = good && (std::fseek(file, 0, SEEK_SET) == 0);
+    good = good && (std::fwrite(&header, 1, sizeof(header), file) == sizeof(header));
+
+    good = (std::fclose(file) == 0) && good;
+    file = nullptr;
+    index.clear();
+
+    return good;
+
+}// PgLogWriter::close
+
+
+/*!
+ * Construct a reader, with no log open
+ */
+PgLogReader::PgLogReader(void) :
+    data(nullptr),
+    size(0)
+{
+}
+
+
+/*!
+ * Unmap the log, if it is open
+ */
+PgLogReader::~PgLogReader(void)
+{
+    close();
+}
+
+
+/*!
+ * Open and memory map a log. The index is read from the log if it was closed,
+ * otherwise it is built by scanning the records.
+ * \param fileName is the name of the log file
+ * \return true if the log was opened
+ */
+bool PgLogReader::open(const std::string& fileName)
+{
+    close();
+
+    int file = ::open(fileName.c_str(), O_RDONLY);
+    if(file < 0)
+        return false;
+
+    struct stat status;
+    if((fstat(file, &status) != 0) || ((std::size_t)status.st_size < sizeof(PgLogHeader)))
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* map = mmap(nullptr, (std::size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+
+    if(map == MAP_FAILED)
+        return false;
+
+    data = (const uint8_t*)map;
+    size = (std::size_t)status.st_size;
+
+    const PgLogHeader& head = header();
+
+    if((std::memcmp(head.magic, "PGLOG1", 7) != 0) || (head.byteOrder != 0x01020304) || (head.headerSize != sizeof(PgLogHeader)))
+    {
+        close();
+        return false;
+    }
+
+    // A log that was not closed has no index
+    if((head.indexOffset == 0) || (head.indexOffset + 16 > size) || (std::memcmp(data + head.indexOffset, indexMagic, sizeof(indexMagic)) != 0))
+        return scan();
+
+    uint64_t position = head.indexOffset + 8;
+    uint64_t numTables = *(const uint64_t*)(data + position);
+    position += 8;
+
+    for(uint64_t i = 0; i < numTables; i++)
+    {
+        if(position + 16 > size)
+            return scan();
+
+        uint32_t id = *(const uint32_t*)(data + position);
+        uint64_t number = *(const uint64_t*)(data + position + 8);
+        position += 16;
+
+        if((number > (size - position)/sizeof(PgLogEntry)))
+            return scan();
+
+        Table table = {(const PgLogEntry*)(data + position), (std::size_t)number};
+        tables[id] = table;
+        position += number*sizeof(PgLogEntry);
+    }
+
+    return true;
+
+}// PgLogReader::open
+
+
+/*!
+ * Build the index by scanning the records, for a log that was not closed. A
+ * record that is cut off by the end of the file is ignored.
+ * \return true, the log can be read even if it has no records
+ */
+bool PgLogReader::scan(void)
+{
+    tables.clear();
+    rebuilt.clear();
+
+    uint64_t position = padded(sizeof(PgLogHeader));
+
+    while(position + sizeof(PgLogRecordHeader) <= size)
+    {
+        const PgLogRecordHeader* record = (const PgLogRecordHeader*)(data + position);
+
+        uint64_t next = position + sizeof(PgLogRecordHeader) + padded(record->size);
+        if(next > size)
+            break;
+
+        PgLogEntry entry = {record->time, position};
+        rebuilt[record->id].push_back(entry);
+
+        position = next;
+    }
+
+    for(auto& list : rebuilt)
+    {
+        std::stable_sort(list.second.begin(), list.second.end(), earlier);
+
+        Table table = {list.second.data(), list.second.size()};
+        tables[list.first] = table;
+    }
+
+    return true;
+
+}// PgLogReader::scan
+
+
+/*!
+ * Unmap and close the log
+ */
+void PgLogReader::close(void)
+{
+    if(data != nullptr)
+        munmap((void*)data, size);
+
+    data = nullptr;
+    size = 0;
+    tables.clear();
+    rebuilt.clear();
+
+}// PgLogReader::close
+
+
+/*!
+ * Determine if the log was written by the protocol with this fingerprint
+ * \param fingerprint identifies the protocol
+ * \return true if the api, version, and hash of the log match the fingerprint
+ */
+bool PgLogReader::matches(const PgLogFingerprint& fingerprint) const
+{
+    if(data == nullptr)
+        return false;
+
+    const PgLogHeader& head = header();
+
+    return (head.hash == fingerprint.hash) &&
+           (std::strncmp(head.api, fingerprint.api, sizeof(head.api) - 1) == 0) &&
+           (std::strncmp(head.version, fingerprint.version, sizeof(head.version) - 1) == 0);
+
+}// PgLogReader::matches
+
+
+/*!
+ * Return the packet identifiers in the log
+ * \return the identifiers, in increasing order
+ */
+std::vector<uint32_t> PgLogReader::ids(void) const
+{
+    std::vector<uint32_t> list;
+
+    for(const auto& table : tables)
+        list.push_back(table.first);
+
+    return list;
+
+}// PgLogReader::ids
+
+
+/*!
+ * Return the number of records of one packet identifier
+ * \param id is the packet identifier
+ * \return the number of records with that identifier
+ */
+std::size_t PgLogReader::count(uint32_t id) const
+{
+    auto table = tables.find(id);
+
+    if(table == tables.end())
+        return 0;
+
+    return table->second.number;
+
+}// PgLogReader::count
+
+
+/*!
+ * Return the index entries of one packet identifier, in time order
+ * \param id is the packet identifier
+ * \param number receives the number of entries
+ * \return the first entry, which is only valid while the log is open
+ */
+const PgLogEntry* PgLogReader::entries(uint32_t id, std::size_t& number) const
+{
+    auto table = tables.find(id);
+
+    if(table == tables.end())
+    {
+        number = 0;
+        return nullptr;
+    }
+
+    number = table->second.number;
+    return table->second.entries;
+
+}// PgLogReader::entries
+
+
+/*!
+ * Return the index entries of one packet identifier in a time range, in time
+ * order. The range is found by binary search of the index.
+ * \param id is the packet identifier
+ * \param first is the earliest time to include
+ * \param last is the latest time to include
+ * \param number receives the number of entries
+ * \return the first entry, which is only valid while the log is open
+ */
+const PgLogEntry* PgLogReader::entries(uint32_t id, uint64_t first, uint64_t last, std::size_t& number) const
+{
+    const PgLogEntry* begin = entries(id, number);
+    const PgLogEntry* end = begin + number;
+
+    PgLogEntry low = {first, 0};
+    PgLogEntry high = {last, 0};
+
+    begin = std::lower_bound(begin, end, low, earlier);
+    end = std::upper_bound(begin, end, high, earlier);
+
+    number = (std::size_t)(end - begin);
+    return begin;
+
+}// PgLogReader::entries
+
+
+/*!
+ * Return the index entries of every packet identifier in a time range, in
+ * time order. Records with the same time are in the order they were written.
+ * \param first is the earliest time to include
+ * \param last is the latest time to include
+ * \return the entries
+ */
+std::vector<PgLogEntry> PgLogReader::allEntries(uint64_t first, uint64_t last) const
+{
+    std::vector<PgLogEntry> list;
+
+    for(const auto& table : tables)
+    {
+        std::size_t number = 0;
+        const PgLogEntry* range = entries(table.first, first, last, number);
+
+        list.insert(list.end(), range, range + number);
+    }
+
+    std::sort(list.begin(), list.end(), [](const PgLogEntry& one, const PgLogEntry& two)
+    {
+        return (one.time < two.time) || ((one.time == two.time) && (one.offset < two.offset));
+    });
+
+    return list;
+
+}// PgLogReader::allEntries
+
+
+/*!
+ * Return the record of an index entry
+ * \param entry is the index entry
+ * \return the record, whose data are only valid while the log is open
+ */
+PgLogRecord PgLogReader::record(const PgLogEntry& entry) const
+{
+    const PgLogRecordHeader* head = (const PgLogRecordHeader*)(data + entry.offset);
+    PgLogRecord record = {head->time, head->id, head->size, data + entry.offset + sizeof(PgLogRecordHeader)};
+
+    return record;
+
+}// PgLogReader::record
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolPacketLog::generateSource
@@ -0,0 +1,38 @@
+#ifndef PROTOCOLPACKETLOG_H
+#define PROTOCOLPACKETLOG_H
+
+/*!
+ * \file
+ * Auto magically generate the indexed binary log writer and reader
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+
+class ProtocolPacketLog
+{
+public:
+    ProtocolPacketLog(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+    //! Perform the generation of the functions that log the packets of a protocol, and the helper module
+    bool generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::string& api, const std::string& version, uint64_t xmlhash, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLPACKETLOG_H
@@ -0,0 +1,256 @@
+#include "protocolpacketqueue.h"
+
+ProtocolPacketQueue::ProtocolPacketQueue(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolPacketQueue::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//! Generate the header file
+bool ProtocolPacketQueue::generateHeader(void)
+{
+    header.setModuleNameAndPath("packetqueue", support.outputpath());
+
+// Raw string magic here
+header.setFileComment(R"(\brief A queue of fixed size packet slots with one producer and one consumer
+
+The queue hands out pointers to its slots, so the producer (for example a
+receive interrupt that frames bytes) builds each packet in place, and the
+consumer (for example the main loop) decodes each packet in place. No packet
+is copied between them. The producer only changes the head, and the consumer
+only changes the tail, so neither blocks the other. The head and the tail
+are on different cache lines, and each side keeps its own copy of the other
+side's index, so it only reads the shared index when the queue looks full or
+empty.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("stdint.h", std::string(), true);
+    header.writeIncludeDirective("stddef.h", std::string(), true);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! Bytes between the head and the tail, at least 8. Targets without a data cache can use 8
+#ifndef PG_QUEUE_CACHE_LINE
+#define PG_QUEUE_CACHE_LINE 64
+#endif
+
+//! A queue of packet slots with a single producer and a single consumer
+typedef struct
+{
+    volatile uint32_t head; //!< Number of slots committed, only the producer changes this
+    uint32_t tailCopy;      //!< The producer's copy of the tail
+    uint8_t headPad[PG_QUEUE_CACHE_LINE - 2*sizeof(uint32_t)];
+
+    volatile uint32_t tail; //!< Number of slots released, only the consumer changes this
+    uint32_t headCopy;      //!< The consumer's copy of the head
+    uint8_t tailPad[PG_QUEUE_CACHE_LINE - 2*sizeof(uint32_t)];
+
+    uint8_t* base;          //!< The caller's storage for the slots
+    uint32_t slotSize;      //!< Number of bytes in each slot
+    uint32_t mask;          //!< Number of slots, less one
+}pgqueue_t;
+
+//! Initialize a queue to use caller provided storage for its slots
+int initQueue(pgqueue_t* queue, void* storage, uint32_t slotSize, uint32_t slotCount);
+
+//! Return the number of committed slots the consumer has not released
+uint32_t queueUsed(const pgqueue_t* queue);
+
+//! Get the slot the producer builds the next packet in
+uint8_t* reserveQueue(pgqueue_t* queue);
+
+//! Pass the reserved slot to the consumer
+void commitQueue(pgqueue_t* queue);
+
+//! Get the oldest committed slot, without removing it
+uint8_t* peekQueue(pgqueue_t* queue);
+
+//! Return the oldest committed slot to the producer, after it has been consumed
+void releaseQueue(pgqueue_t* queue);
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolPacketQueue::generateHeader
+
+
+//! Generate the source file
+bool ProtocolPacketQueue::generateSource(void)
+{
+    source.setModuleNameAndPath("packetqueue", support.outputpath());
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(// The head and tail are shared between the producer and the consumer, which
+// may run on different threads or in an interrupt. The index one side owns
+// is published with release semantics, and the other side's index is read
+// with acquire semantics, so a slot is written before the consumer sees it,
+// and read before the producer reuses it.
+#if defined(__GNUC__) || defined(__clang__)
+#define loadQueueIndex(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define storeQueueIndex(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#else
+#if (defined(__cplusplus) && (__cplusplus >= 201103L)) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201103L))
+#include <atomic>
+#define queueFence(order) std::atomic_thread_fence(std::memory_order_##order)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define queueFence(order) atomic_thread_fence(memory_order_##order)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+// x86 keeps loads in order and stores in order, only the compiler must not move them
+#define queueFence(order) _ReadWriteBarrier()
+#else
+#error "The packet queue needs C11 or C++11 atomics, or a memory barrier for this compiler"
+#endif
+// Read the index, and then keep later accesses after the read
+static uint32_t pgQueueAcquire(uint32_t index) { queueFence(acquire); return index; }
+#define loadQueueIndex(index) pgQueueAcquire(index)
+// Keep earlier accesses before the index is written
+#define storeQueueIndex(index, value) (queueFence(release), (index) = (value))
+#endif
+
+/*!
+ * Initialize a queue to use caller provided storage for its slots. The queue
+ * is empty. The head and tail count slots without wrapping to the number of
+ * slots, so every slot can be used.
+ * \param queue is the queue to initialize
+ * \param storage holds slotCount slots of slotSize bytes, and must persist as
+ *        long as the queue is used. Slots are aligned like storage if slotSize
+ *        is a multiple of the alignment.
+ * \param slotSize is the number of bytes in each slot
+ * \param slotCount is the number of slots, which must be a power of two
+ * \return 1 if the queue was initialized, 0 if slotCount is not a power of two
+ */
+int initQueue(pgqueue_t* queue, void* storage, uint32_t slotSize, uint32_t slotCount)
+{
+    if((slotCount == 0) || ((slotCount & (slotCount - 1)) != 0))
+        return 0;
+
+    queue->head = queue->tailCopy = 0;
+    queue->tail = queue->headCopy = 0;
+    queue->base = (uint8_t*)storage;
+    queue->slotSize = slotSize;
+    queue->mask = slotCount - 1;
+
+    return 1;
+
+}// initQueue
+
+
+/*!
+ * Return the number of committed slots the consumer has not released. This
+ * can be called from either side, the answer may be stale for the other side.
+ * \param queue is the queue
+ * \return the number of slots in use
+ */
+uint32_t queueUsed(const pgqueue_t* queue)
+{
+    uint32_t tail = loadQueueIndex(queue->tail);
+
+    return loadQueueIndex(queue->head) - tail;
+
+}// queueUsed
+
+
+/*!
+ * Get the slot the producer builds the next packet in. The same slot is
+ * returned until commitQueue() is called, so a packet that turns out to be
+ * bad is dropped by not committing it.
+ * \param queue is the queue
+ * \return a pointer to the slot, or NULL if every slot is in use
+ */
+uint8_t* reserveQueue(pgqueue_t* queue)
+{
+    uint32_t head = queue->head;
+
+    // Only read the consumer's index when the queue looks full
+    if(head - queue->tailCopy > queue->mask)
+    {
+        queue->tailCopy = loadQueueIndex(queue->tail);
+
+        if(head - queue->tailCopy > queue->mask)
+            return NULL;
+    }
+
+    return queue->base + (head & queue->mask)*queue->slotSize;
+
+}// reserveQueue
+
+
+/*!
+ * Pass the reserved slot to the consumer. Only call this after reserveQueue()
+ * returned a slot.
+ * \param queue is the queue
+ */
+void commitQueue(pgqueue_t* queue)
+{
+    storeQueueIndex(queue->head, queue->head + 1);
+
+}// commitQueue
+
+
+/*!
+ * Get the oldest committed slot, without removing it. The same slot is
+ * returned until releaseQueue() is called.
+ * \param queue is the queue
+ * \return a pointer to the slot, or NULL if the queue is empty
+ */
+uint8_t* peekQueue(pgqueue_t* queue)
+{
+    uint32_t tail = queue->tail;
+
+    // Only read the producer's index when the queue looks empty
+    if(tail == queue->headCopy)
+    {
+        queue->headCopy = loadQueueIndex(queue->head);
+
+        if(tail == queue->headCopy)
+            return NULL;
+    }
+
+    return queue->base + (tail & queue->mask)*queue->slotSize;
+
+}// peekQueue
+
+
+/*!
+ * Return the oldest committed slot to the producer, after it has been
+ * consumed. Only call this after peekQueue() returned a slot.
+ * \param queue is the queue
+ */
+void releaseQueue(pgqueue_t* queue)
+{
+    storeQueueIndex(queue->tail, queue->tail + 1);
+
+}// releaseQueue
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolPacketQueue::generateSource
@@ -0,0 +1,35 @@
+#ifndef PROTOCOLPACKETQUEUE_H
+#define PROTOCOLPACKETQUEUE_H
+
+/*!
+ * \file
+ * Auto magically generate the queue of packet slots between a producer and a consumer
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+
+class ProtocolPacketQueue
+{
+public:
+    ProtocolPacketQueue(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLPACKETQUEUE_H
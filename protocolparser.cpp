@@ -5,15 +5,30 @@
 #include "protocolscaling.h"
 #include "fieldcoding.h"
 #include "protocolfloatspecial.h"
+#include "protocoltablecodec.h"
+#include "protocolspanarena.h"
+#include "protocoliovencode.h"
+#include "protocolringencode.h"
+#include "protocolpacketqueue.h"
+#include "protocolcolumntable.h"
+#include "protocolpacketlog.h"
+#include "protocoludpbatch.h"
+#include "protocolshmchannel.h"
+#include "protocolreplay.h"
 #include "protocolsupport.h"
 #include "protocolbitfield.h"
 #include "protocoldocumentation.h"
 #include "shuntingyard.h"
+#include "protocolprofiler.h"
+#include "markdownrenderer.h"
+#include "latexrenderer.h"
 #include <string>
 #include <iostream>
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
+#include <unordered_map>
 
 // The version of the protocol generator is set here
 const std::string ProtocolParser::genVersion = "3.2.a";
@@ -22,8 +37,10 @@ const std::string ProtocolParser::genVersion = "3.2.a";
  * \brief ProtocolParser::ProtocolParser
  */
 ProtocolParser::ProtocolParser() :
-    currentxml(nullptr),
+    xmlloader(&ownxmlloader),
+    modulecache(nullptr),
     header(nullptr),
+    packetqueue(false),
     latexHeader(1),
     latexEnabled(false),
     nomarkdown(false),
@@ -31,7 +48,16 @@ ProtocolParser::ProtocolParser() :
     nodoxygen(false),
     noAboutSection(false),
     nocss(false),
-    tableOfContents(false)
+    tableOfContents(false),
+    numpy(false),
+    replay(false),
+    columns(false),
+    log(false),
+    udp(false),
+    shm(false),
+    precompile(false),
+    dependencies(nullptr),
+    dependencyrank(0)
 {
 }
 
@@ -58,12 +84,12 @@ ProtocolParser::~ProtocolParser()
         delete globalenu;
     globalEnums.clear();
 
-    for(auto xmldoc : xmldocs)
-        delete xmldoc;
-    xmldocs.clear();
-
     if(header != nullptr)
         delete header;
+
+    for(auto library : libraries)
+        delete library;
+    libraries.clear();
 }
 
 
@@ -79,6 +105,9 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
     // Top level printout of the version information
     std::cout << "ProtoGen version " << genVersion << std::endl;
 
+    // In case a previous run in this process failed part way
+    ProtocolFile::discardTemporaryFiles();
+
     std::filesystem::path filepath(filename);
 
     // Remember the input path, in case there are files referenced by the main file
@@ -89,25 +118,29 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
 
     // Also remember the name of the file, which we use for warning outputs
     inputfile = filepath.filename().string();
-    std::fstream file(filename, std::ios_base::in);
 
-    if(!file.is_open())
+    // Start loading all the files, including the files they require, so they
+    // are ready (or nearly so) by the time we get to them in order
+    std::vector<std::string> prefetchfiles(otherfiles);
+    prefetchfiles.push_back(filename);
+    xmlloader->prefetch(prefetchfiles);
+
+    std::size_t phase = profiler.begin("XML load");
+    XMLDocument* doc = xmlloader->document(filename);
+
+    if(doc == nullptr)
     {
         std::cerr << filename << " : error: Failed to open protocol file" << std::endl;
         return false;
     }
 
-    currentxml = new XMLDocument();
-    xmldocs.push_back(currentxml);
-    if(currentxml->Parse(std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()).c_str()) != XML_SUCCESS)
+    if(doc->Error())
     {
-        file.close();
-        std::cerr << currentxml->ErrorStr() << std::endl;
+        std::cerr << doc->ErrorStr() << std::endl;
         return false;
     }
 
-    // Done with the file
-    file.close();
+    profiler.end(phase);
 
     // Set our output directory
     // Make the path as short as possible
@@ -130,7 +163,7 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
     if(!ec)
     {
         // Remember the output path for all users
-        support.outputpath = path;
+        support.edit().outputpath = path;
     }
     else
     {
@@ -139,7 +172,7 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
     }
 
     // The outer most element
-    XMLElement* docElem = currentxml->RootElement();
+    XMLElement* docElem = doc->RootElement();
 
     // This element must have the "Protocol" tag
     if((docElem == nullptr) || (XMLUtil::StringEqual(docElem->Name(), "protocol") == false))
@@ -149,24 +182,30 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
     }
 
     // Protocol options specified in the xml
-    support.sourcefile = inputpath + inputfile;
-    support.protoName = name = getAttribute("name", docElem->FirstAttribute());
-    if(support.protoName.empty())
+    support.edit().sourcefile = inputpath + inputfile;
+
+    // Index the protocol attributes once, we look up a lot of them
+    const AttributeIndex map(docElem->FirstAttribute());
+
+    support.edit().protoName = name = getAttribute("name", map);
+    if(support.protoName().empty())
     {
         std::cerr << filename << " : error: Protocol name not found in XML" << std::endl;
         return false;
     }
 
-    title = getAttribute("title", docElem->FirstAttribute());
-    api = getAttribute("api", docElem->FirstAttribute());
-    version = getAttribute("version", docElem->FirstAttribute());
-    comment = getAttribute("comment", docElem->FirstAttribute());
-    support.parse(docElem->FirstAttribute());
+    title = getAttribute("title", map);
+    api = getAttribute("api", map);
+    version = getAttribute("version", map);
+    comment = getAttribute("comment", map);
+    sync = getAttribute("sync", map);
+    packetqueue = isFieldSet("packetQueue", map);
+    support.parse(map);
 
     if(support.disableunrecognized == false)
     {
         // All the attributes we understand
-        std::vector<std::string> attriblist = {"name", "title", "api", "version", "comment"};
+        std::vector<std::string> attriblist = {"name", "title", "api", "version", "comment", "sync", "packetQueue"};
 
         // and the ones understood by the protocol support
         std::vector<std::string> supportlist = support.getAttriblist();
@@ -175,7 +214,7 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         {
             std::string test = trimm(a->Name());
             if(!contains(attriblist, test) && !contains(supportlist, test))
-                std::cerr << support.sourcefile << ":" << a->GetLineNum() << ":0: warning: Unrecognized attribute \"" + test + "\"" << std::endl;
+                std::cerr << support.sourcefile() << ":" << a->GetLineNum() << ":0: warning: Unrecognized attribute \"" + test + "\"" << std::endl;
 
         }// for all the attributes
 
@@ -194,6 +233,7 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
 
     // Now parse the contents of all the files. We do other files first since
     // we expect them to be helpers that the main file may depend on.
+    phase = profiler.begin("Flatten XML files");
     for(std::size_t i = 0; i < otherfiles.size(); i++)
         parseFile(otherfiles.at(i));
 
@@ -219,16 +259,29 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         }
     }
 
+    profiler.end(phase);
+
+    // Find out which modules are affected by the files that changed
+    if(modulecache != nullptr)
+        beginModuleCache(docElem);
+
     // Output the global enumerations first, they will go in the main
     // header file by default, unless the enum specifies otherwise
+    phase = profiler.begin("Global enumerations");
     ProtocolHeaderFile enumfile(support);
     ProtocolSourceFile enumSourceFile(support);
 
     for(std::size_t i = 0; i < globalEnums.size(); i++)
     {
+        ProtocolProfiler::Scope scope(profiler, std::string(), true);
+
+        parseGlobalEnumeration(i);
+
         EnumCreator* module = globalEnums.at(i);
+        scope.setName(module->getHierarchicalName());
 
-        module->parseGlobal();
+        // Now that it is parsed others can look it up
+        symbols.addEnumeration(module, true);
 
         // Don't output if hidden and we are omitting hidden items
         if(module->isHidden() && !module->isNeverOmit() && support.omitIfHidden)
@@ -266,13 +319,23 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         filePathList.push_back(enumfile.filePath());
     }
 
+    profiler.end(phase);
+
     // Now parse the global structures
+    phase = profiler.begin("Structure modules");
     for(std::size_t i = 0; i < structures.size(); i++)
     {
-        ProtocolStructureModule* module = structures[i];
+        ProtocolProfiler::Scope scope(profiler, std::string(), true);
 
         // Parse its XML and generate the output
-        module->parse();
+        parseStructure(i);
+
+        ProtocolStructureModule* module = structures[i];
+        outputModule(module);
+        scope.setName(module->getHierarchicalName());
+
+        // Now that it is parsed others can look it up
+        symbols.addStructure(module);
 
         // Keep a list of all the file names
         fileNameList.push_back(module->getDefinitionFileName());
@@ -300,9 +363,16 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
 
     }// for all top level structures
 
+    // The enumerations and structures of the Require'd files are all parsed
+    if(precompile)
+        savePrecompiledLibraries();
+
+    profiler.end(phase);
+
     // And the global packets. We want to sort the packets into two batches:
     // those packets which can be used by other packets; and those which cannot.
     // This way we can parse the first batch ahead of the second
+    phase = profiler.begin("Packet modules");
     for(std::size_t i = 0; i < packets.size(); i++)
     {
         ProtocolPacket* packet = packets.at(i);
@@ -310,12 +380,17 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         if(!isFieldSet(packet->getElement(), "useInOtherPackets"))
             continue;
 
-        // Parse its XML
-        packet->parse();
+        ProtocolProfiler::Scope scope(profiler, std::string(), true);
+
+        // Parse its XML and generate the output
+        packet->parseDefinition();
+        outputModule(packet);
+        scope.setName(packet->getHierarchicalName());
 
         // The structures have been parsed, adding this packet to the list
         // makes it available for other packets to find as structure reference
         structures.push_back(packet);
+        symbols.addStructure(packet);
 
         // Keep a list of all the file names
         fileNameList.push_back(packet->getDefinitionFileName());
@@ -343,7 +418,12 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
 
     }
 
-    // And the packets which are not available for other packets
+    // And the packets which are not available for other packets. To share
+    // layouts these are all parsed before any is output, so the first packet
+    // with a layout knows if later packets will call its functions
+    if(support.sharelayouts)
+        parsePacketLayouts();
+
     for(std::size_t i = 0; i < packets.size(); i++)
     {
         ProtocolPacket* packet = packets.at(i);
@@ -351,8 +431,16 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         if(isFieldSet(packet->getElement(), "useInOtherPackets"))
             continue;
 
-        // Parse its XML
-        packet->parse();
+        ProtocolProfiler::Scope scope(profiler, std::string(), true);
+
+        // Parse its XML and generate the output
+        if(!support.sharelayouts)
+            packet->parseDefinition();
+        outputModule(packet);
+        scope.setName(packet->getHierarchicalName());
+
+        // Now that it is parsed others can look it up
+        symbols.addStructure(packet);
 
         // Keep a list of all the file names
         fileNameList.push_back(packet->getDefinitionFileName());
@@ -380,7 +468,10 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
 
     }
 
+    profiler.end(phase);
+
     // Parse all of the documentation
+    phase = profiler.begin("Documentation");
     for(std::size_t i = 0; i < documents.size(); i++)
     {
         ProtocolDocumentation* doc = documents.at(i);
@@ -388,33 +479,122 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
         doc->parse();
     }
 
+    profiler.end(phase);
+
+    phase = profiler.begin("Helper files");
     if(!nohelperfiles)
     {
         // Auto-generated files for coding
         ProtocolScaling(support).generate(fileNameList, filePathList);
         FieldCoding(support).generate(fileNameList, filePathList);
         ProtocolFloatSpecial(support).generate(fileNameList, filePathList);
+
+        // The table codec interpreter, only if something uses it
+        bool tableDriven = false;
+        for(std::size_t i = 0; i < structures.size(); i++)
+            tableDriven = tableDriven || structures.at(i)->isTableDriven();
+        for(std::size_t i = 0; i < packets.size(); i++)
+            tableDriven = tableDriven || packets.at(i)->isTableDriven();
+
+        if(tableDriven)
+            ProtocolTableCodec(support).generate(fileNameList, filePathList);
+
+        // The arena for spans, only if something uses it
+        bool spans = false;
+        for(std::size_t i = 0; i < structures.size(); i++)
+            spans = spans || structures.at(i)->hasSpans();
+        for(std::size_t i = 0; i < packets.size(); i++)
+            spans = spans || packets.at(i)->hasSpans();
+
+        if(spans)
+            ProtocolSpanArena(support).generate(fileNameList, filePathList);
+
+        // The scatter gather encode helpers, only if a packet uses them
+        bool iovEncode = false;
+        for(std::size_t i = 0; i < packets.size(); i++)
+            iovEncode = iovEncode || packets.at(i)->isIovEncode();
+
+        if(iovEncode)
+            ProtocolIovEncode(support).generate(fileNameList, filePathList);
+
+        // The ring buffer helpers, only if a packet uses them
+        bool ringEncode = false;
+        for(std::size_t i = 0; i < packets.size(); i++)
+            ringEncode = ringEncode || packets.at(i)->isRingEncode();
+
+        if(ringEncode)
+            ProtocolRingEncode(support).generate(fileNameList, filePathList);
+
+        // The queue of packet slots, only if the protocol asks for it
+        if(packetqueue)
+            ProtocolPacketQueue(support).generate(fileNameList, filePathList);
     }
 
     // Code for testing bitfields
     if(support.bitfieldtest && support.bitfield)
         ProtocolBitfield::generatetest(support);
 
+    profiler.end(phase);
+
+    phase = profiler.begin("Markdown");
     if(!nomarkdown)
         outputMarkdown(support.bigendian, inlinecss);
+    profiler.end(phase);
+
+    phase = profiler.begin("NumPy");
+    if(numpy)
+        outputNumpy();
+    profiler.end(phase);
+
+    phase = profiler.begin("Replay");
+    if(replay)
+        ProtocolReplay(support, name, sync).generate(packets, header->fileName());
+    profiler.end(phase);
+
+    phase = profiler.begin("Columns");
+    if(columns)
+        ProtocolColumnTable(support).generateProtocol(name, header->fileName(), structures, packets, fileNameList, filePathList);
+    profiler.end(phase);
+
+    phase = profiler.begin("Log");
+    if(log)
+        ProtocolPacketLog(support).generateProtocol(name, header->fileName(), api, version, getXmlHash(), fileNameList, filePathList);
+    profiler.end(phase);
+
+    phase = profiler.begin("UDP");
+    if(udp)
+        ProtocolUdpBatch(support).generateProtocol(name, header->fileName(), packets, fileNameList, filePathList);
+    profiler.end(phase);
+
+    phase = profiler.begin("Shm");
+    if(shm)
+        ProtocolShmChannel(support).generateProtocol(name, header->fileName(), packets, getXmlHash(), fileNameList, filePathList);
+    profiler.end(phase);
 
     #ifndef _DEBUG
+    phase = profiler.begin("Doxygen");
     if(!nodoxygen)
         outputDoxygen();
+    profiler.end(phase);
     #endif
 
     // The last bit of the protocol header
+    phase = profiler.begin("File flush");
     finishProtocolHeader();
 
-    // This is fun...replace all the temporary files with real ones if needed
+    // The output of an unchanged module must not have been lost
+    if((modulecache != nullptr) && !finishModuleCache())
+    {
+        profiler.end(phase);
+        return false;
+    }
+
+    // This is fun...write all the temporary files to real ones if needed
     for(std::size_t i = 0; i < fileNameList.size(); i++)
         ProtocolFile::copyTemporaryFile(filePathList.at(i), fileNameList.at(i));
 
+    profiler.end(phase);
+
     // If we are putting the files in our local directory then we don't just want an empty string in our printout
     if(path.empty())
         path = "./";
@@ -430,8 +610,10 @@ bool ProtocolParser::parse(std::string filename, std::string path, std::vector<s
  * Parses a single XML file handling any require tags to flatten a file
  * heirarchy into a single flat structure
  * \param xmlFilename is the file to parse
+ * \param required should be true if the file is Require'd by another file,
+ *        in which case its enumerations and structures can be precompiled
  */
-bool ProtocolParser::parseFile(std::string xmlFilename)
+bool ProtocolParser::parseFile(std::string xmlFilename, bool required)
 {
     // Path contains the path and file name and extension
     std::filesystem::path path(xmlFilename);
@@ -455,46 +637,28 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
 
     std::cout << "Parsing file " << ProtocolFile::sanitizePath(path.parent_path().string()) << path.filename().string() << std::endl;
 
-    std::fstream xmlFile(xmlFilename, std::ios_base::in);
+    // The document was probably loaded in the background already
+    std::size_t phase = profiler.begin("XML load");
+    XMLDocument* doc = xmlloader->document(xmlFilename);
 
-    if(!xmlFile.is_open())
+    if(doc == nullptr)
     {
         std::string warning = "error: Failed to open xml protocol file " + xmlFilename;
         std::cerr << warning << std::endl;
         return false;
     }
 
-    currentxml = new XMLDocument();
-    xmldocs.push_back(currentxml);
-    std::string contents = std::string((std::istreambuf_iterator<char>(xmlFile)), std::istreambuf_iterator<char>());
-
-    // Done with the file
-    xmlFile.close();
-
     // Error parsing
-    std::string error;
-    //int errorLine, errorCol;
-
-    currentxml = new XMLDocument();
-
-    // Extract XML data
-    if(currentxml->Parse(contents.c_str()) != XML_SUCCESS)
+    if(doc->Error())
     {
-        std::cerr << currentxml->ErrorStr() << std::endl;
-        delete currentxml;
-
-        if(xmldocs.size() > 0)
-            currentxml = xmldocs.back();
-        else
-            currentxml = nullptr;
-
+        std::cerr << doc->ErrorStr() << std::endl;
         return false;
     }
-    else
-        xmldocs.push_back(currentxml);
+
+    profiler.end(phase);
 
     // The outer most element
-    XMLElement* docElem = currentxml->RootElement();
+    XMLElement* docElem = doc->RootElement();
 
     // This element must have the "Protocol" tag
     if((docElem == nullptr) || (XMLUtil::StringEqual(docElem->Name(), "protocol") == false))
@@ -505,10 +669,31 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
     }
 
     // Protocol file options specified in the xml
-    localsupport.parseFileNames(docElem->FirstAttribute());
-    localsupport.sourcefile = xmlFilename;
+    localsupport.parseFileNames(AttributeIndex(docElem->FirstAttribute()));
+    localsupport.edit().sourcefile = xmlFilename;
+
+    // The precompiled library of a Require'd file, files in the resources are part of ProtoGen itself
+    PrecompiledLibrary* library = nullptr;
+    uint64_t hash = 0;
+    if(required && (xmlFilename.at(0) != ':') && hashFile(xmlFilename, hash))
+    {
+        // Everything that changes how the file is parsed
+        CacheWriter options;
+        options.write(genVersion);
+        options.write(api);
+        options.write(version);
+        support.save(options);
+        localsupport.save(options);
+
+        library = new PrecompiledLibrary(xmlFilename, hash, options.data());
+        libraries.push_back(library);
+
+        if(!precompile)
+            library->load();
+    }
 
-    for(const XMLElement* element = docElem->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+    int index = 0;
+    for(const XMLElement* element = docElem->FirstChildElement(); element != nullptr; element = element->NextSiblingElement(), index++)
     {
         std::string nodename = toLower(trimm(element->Name()));
 
@@ -530,7 +715,15 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
                     subfile += ".xml";
 
                 // The new file is relative to this file
-                parseFile(ProtocolFile::sanitizePath(path.parent_path().string()) + subfile);
+                subfile = ProtocolFile::sanitizePath(path.parent_path().string()) + subfile;
+
+                // Remember the dependency, so a change to the new file affects this one
+                if(subfile.at(0) == ':')
+                    requiredfiles[absolutepathname].push_back(subfile);
+                else
+                    requiredfiles[absolutepathname].push_back(std::filesystem::absolute(subfile).string());
+
+                parseFile(subfile, true);
             }
 
         }
@@ -542,6 +735,10 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
             module->setElement(element);
 
             structures.push_back( module );
+            modulefiles[module] = absolutepathname;
+
+            if(library != nullptr)
+                precompiled.emplace(module, PrecompiledSource(library, index, localsupport));
         }
         else if( nodename == "enum" || nodename == "enumeration" )
         {
@@ -551,6 +748,9 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
 
             globalEnums.push_back( Enum );
             alldocumentsinorder.push_back( Enum );
+
+            if(library != nullptr)
+                precompiled.emplace(Enum, PrecompiledSource(library, index, localsupport));
         }
         // Define a packet
         else if( nodename == "packet" || nodename == "pkt" )
@@ -560,6 +760,7 @@ bool ProtocolParser::parseFile(std::string xmlFilename)
             packet->setElement(element);
 
             packets.push_back( packet );
+            modulefiles[packet] = absolutepathname;
             alldocumentsinorder.push_back( packet );
         }
         else if ( nodename == "doc" || contains(nodename, "document"))
@@ -593,7 +794,7 @@ void ProtocolParser::createProtocolHeader(const XMLElement* docElem)
     header = new ProtocolHeaderFile(support);
 
     // The file name
-    header->setModuleNameAndPath(name + "Protocol", support.outputpath);
+    header->setModuleNameAndPath(name + "Protocol", support.outputpath());
 
     // Construct the file comment that goes in the \file block
     std::string filecomment = "\\mainpage " + name + " protocol stack\n\n" + comment + "\n\n";
@@ -631,6 +832,9 @@ void ProtocolParser::createProtocolHeader(const XMLElement* docElem)
 
     header->writeIncludeDirective("stdint.h", std::string(), true);
 
+    if(packetqueue)
+        header->writeIncludeDirective("packetqueue");
+
     // Add other includes
     outputIncludes(name, *header, docElem);
 
@@ -661,7 +865,7 @@ void ProtocolParser::createProtocolHeader(const XMLElement* docElem)
 
     header->makeLineSeparator();
 
-    // We need to flush this to disk now, because others may try to open this file and append it
+    // We need to flush this now, because others may try to open this file and append it
     header->flush();
 
 }// ProtocolParser::createProtocolHeader
@@ -672,35 +876,108 @@ void ProtocolParser::finishProtocolHeader(void)
     // We need to re-open this file because others may have written to it and
     // we want to append after their write (This is the whole reaons that
     // finishProtocolHeader() is separate from createProtocolHeader()
-    header->setModuleNameAndPath(name + "Protocol", support.outputpath);
+    header->setModuleNameAndPath(name + "Protocol", support.outputpath());
 
     header->makeLineSeparator();
 
-    // We want these prototypes to be the last things written to the file, because support.pointerType may be defined above
+    // We want these prototypes to be the last things written to the file, because support.pointerType() may be defined above
     header->write("\n");
     header->write("// The prototypes below provide an interface to the packets.\n");
     header->write("// They are not auto-generated functions, but must be hand-written\n");
     header->write("\n");
     header->write("//! \\return the packet data pointer from the packet\n");
-    header->write("uint8_t* get" + name + "PacketData(" + support.pointerType + " pkt);\n");
+    header->write("uint8_t* get" + name + "PacketData(" + support.pointerType() + " pkt);\n");
     header->write("\n");
     header->write("//! \\return the packet data pointer from the packet, const\n");
-    header->write("const uint8_t* get" + name + "PacketDataConst(const " + support.pointerType + " pkt);\n");
+    header->write("const uint8_t* get" + name + "PacketDataConst(const " + support.pointerType() + " pkt);\n");
     header->write("\n");
     header->write("//! Complete a packet after the data have been encoded\n");
-    header->write("void finish" + name + "Packet(" + support.pointerType + " pkt, int size, uint32_t packetID);\n");
+    header->write("void finish" + name + "Packet(" + support.pointerType() + " pkt, int size, uint32_t packetID);\n");
     header->write("\n");
     header->write("//! \\return the size of a packet from the packet header\n");
-    header->write("int get" + name + "PacketSize(const " + support.pointerType + " pkt);\n");
+    header->write("int get" + name + "PacketSize(const " + support.pointerType() + " pkt);\n");
     header->write("\n");
     header->write("//! \\return the ID of a packet from the packet header\n");
-    header->write("uint32_t get" + name + "PacketID(const " + support.pointerType + " pkt);\n");
+    header->write("uint32_t get" + name + "PacketID(const " + support.pointerType() + " pkt);\n");
     header->write("\n");
 
+    if(packetqueue)
+        header->write(getPacketQueueMacros());
+
     header->flush();
 }
 
 
+/*!
+ * Get the macros that give the size of the slots of a queue of packets of
+ * this protocol, and cast its slots to packets. If the packet pointer is a
+ * type each slot is one packet. Otherwise each slot holds the largest packet
+ * data plus the framing, with the largest data computed from the packets, or
+ * given by maxSize.
+ * \return the macros, which go after the packet interface prototypes
+ */
+std::string ProtocolParser::getPacketQueueMacros(void) const
+{
+    std::string output;
+    std::string pointer = support.pointerType();
+    std::string packettype = trimm(pointer.substr(0, pointer.size() - 1));
+    std::string slotsize = "get" + name + "QueueSlotSize";
+    std::string macro = toUpper(name) + "_QUEUE_FRAME_OVERHEAD";
+
+    output += "// The queue of packet slots, which packets are framed and decoded in place\n";
+
+    if(packettype != "void")
+    {
+        output += "\n";
+        output += "//! The bytes of each slot of a queue of " + name + " packets, which is one packet\n";
+        output += "#define " + slotsize + "() sizeof(" + packettype + ")\n";
+    }
+    else
+    {
+        // The largest packet data of the protocol
+        int maxdatalength = 0;
+        for(std::size_t i = 0; i < packets.size(); i++)
+            maxdatalength = std::max(maxdatalength, packets.at(i)->getMaxDataLength());
+
+        if(maxdatalength <= 0)
+            maxdatalength = support.maxdatasize;
+
+        output += "\n";
+        output += "//! The bytes of framing around the packet data, which the framing code can define\n";
+        output += "#ifndef " + macro + "\n";
+        output += "#define " + macro + " 16\n";
+        output += "#endif\n";
+        output += "\n";
+        output += "//! The bytes of each slot of a queue of " + name + " packets, the largest packet and its framing\n";
+        output += "#ifndef " + slotsize + "\n";
+
+        if(maxdatalength > 0)
+            output += "#define " + slotsize + "() (" + std::to_string(maxdatalength) + " + " + macro + ")\n";
+        else
+        {
+            std::cerr << support.sourcefile() << ": warning: packetQueue slot size is not known, define " + slotsize + "() or set maxSize" << std::endl;
+            output += "#error " + slotsize + "() must be defined, because the largest " + name + " packet is not known\n";
+        }
+
+        output += "#endif\n";
+    }
+
+    output += "\n";
+    output += "//! Initialize a queue of " + name + " packets, storage holds slotCount slots, which must be a power of two\n";
+    output += "#define init" + name + "Queue(queue, storage, slotCount) initQueue((queue), (storage), " + slotsize + "(), (slotCount))\n";
+    output += "\n";
+    output += "//! \\return the packet the producer frames the next packet in, or NULL if the queue is full\n";
+    output += "#define reserve" + name + "Queue(queue) ((" + pointer + ")reserveQueue(queue))\n";
+    output += "\n";
+    output += "//! \\return the oldest packet in the queue, to decode in place, or NULL if the queue is empty\n";
+    output += "#define peek" + name + "Queue(queue) ((" + pointer + ")peekQueue(queue))\n";
+    output += "\n";
+
+    return output;
+
+}// ProtocolParser::getPacketQueueMacros
+
+
 /*!
  * Output a long string of text which should be wrapped at 80 characters.
  * \param file receives the output
@@ -893,6 +1170,24 @@ std::string ProtocolParser::getAttribute(const std::string &name, const XMLAttri
 }// ProtocolParser::getAttribute
 
 
+/*!
+ * Get the value of an attribute from an index of the attributes of an element
+ * \param name is the name of the attribute, case is ignored
+ * \param index is the attribute index of the element
+ * \param defaultIfNone is returned if the attribute is not found
+ * \return the trimmed value of the attribute, or defaultIfNone
+ */
+std::string ProtocolParser::getAttribute(const std::string& name, const AttributeIndex& index, const std::string& defaultIfNone)
+{
+    const XMLAttribute* a = index.find(name);
+
+    if(a == nullptr)
+        return defaultIfNone;
+    else
+        return trimm(a->Value());
+}
+
+
 /*!
  * Parse all enumerations which are direct children of a DomNode. The
  * enumerations will be stored in the global list
@@ -945,13 +1240,46 @@ const EnumCreator* ProtocolParser::parseEnumeration(const std::string& parent, c
         Enum = nullptr;
     }
     else
+    {
         enums.push_back(Enum);
+        symbols.addEnumeration(Enum, false);
+    }
 
     return Enum;
 
 }// ProtocolParser::parseEnumeration
 
 
+/*!
+ * Load an enumeration from a precompiled library, in place of
+ * parseEnumeration(). The enumeration is added to the global list which can
+ * be searched with lookUpEnumeration(). Hidden enumerations which are omitted
+ * are not in the library.
+ * \param parent is the hierarchical name of the object which owns the new enumeration
+ * \param element is the DomElement that represents this enumeration
+ * \param reader supplies the data written by EnumCreator::save()
+ * \return a pointer to the newly created enumeration object, or null if it could not be loaded
+ */
+const EnumCreator* ProtocolParser::loadEnumeration(const std::string& parent, const XMLElement* element, CacheReader& reader)
+{
+    EnumCreator* Enum = new EnumCreator(this, parent, support);
+
+    Enum->setElement(element);
+
+    if(!Enum->load(reader))
+    {
+        delete Enum;
+        return nullptr;
+    }
+
+    enums.push_back(Enum);
+    symbols.addEnumeration(Enum, false);
+
+    return Enum;
+
+}// ProtocolParser::loadEnumeration
+
+
 /*!
  * Output all include directions which are direct children of a DomNode
  * \param parent is the hierarchical name of the owning object
@@ -997,7 +1325,7 @@ void ProtocolParser::outputIncludes(const std::string& parent, ProtocolFile& fil
                 else if(attrname == "global")
                     global = ProtocolParser::isFieldSet(a->Value());
                 else if(support.disableunrecognized == false)
-                    ProtocolDocumentation::emitWarning(support.sourcefile, parent + ": " + include, "Unrecognized attribute", a);
+                    ProtocolDocumentation::emitWarning(support.sourcefile(), parent + ": " + include, "Unrecognized attribute", a);
 
             }// for all attributes
 
@@ -1018,29 +1346,13 @@ void ProtocolParser::outputIncludes(const std::string& parent, ProtocolFile& fil
  */
 std::string ProtocolParser::lookUpIncludeName(const std::string& typeName) const
 {
-    for(std::size_t i = 0; i < structures.size(); i++)
-    {
-        if(structures.at(i)->typeName == typeName)
-        {
-            return structures.at(i)->getDefinitionFileName();
-        }
-    }
+    const ProtocolStructureModule* struc = symbols.lookUpStructure(typeName);
+    if(struc != nullptr)
+        return struc->getDefinitionFileName();
 
-    for(std::size_t i = 0; i < packets.size(); i++)
-    {
-        if(packets.at(i)->typeName == typeName)
-        {
-            return packets.at(i)->getDefinitionFileName();
-        }
-    }
-
-    for(std::size_t i = 0; i < globalEnums.size(); i++)
-    {
-        if((globalEnums.at(i)->getName() == typeName) || globalEnums.at(i)->isEnumerationValue(typeName))
-        {
-            return globalEnums.at(i)->getHeaderFileName();
-        }
-    }
+    const EnumCreator* creator = symbols.lookUpEnumerationForNameOrValue(typeName, true);
+    if(creator != nullptr)
+        return creator->getHeaderFileName();
 
     return std::string();
 }
@@ -1053,24 +1365,8 @@ std::string ProtocolParser::lookUpIncludeName(const std::string& typeName) const
  */
 const ProtocolStructureModule* ProtocolParser::lookUpStructure(const std::string& typeName) const
 {
-    for(std::size_t i = 0; i < structures.size(); i++)
-    {
-        if(structures.at(i)->typeName == typeName)
-        {
-            return structures.at(i);
-        }
-    }
-
-
-    for(std::size_t i = 0; i < packets.size(); i++)
-    {
-        if(packets.at(i)->typeName == typeName)
-        {
-            return packets.at(i);
-        }
-    }
-
-    return NULL;
+    addDependency(PrecompiledLibrary::structureLookup, typeName);
+    return symbols.lookUpStructure(typeName);
 }
 
 
@@ -1081,23 +1377,8 @@ const ProtocolStructureModule* ProtocolParser::lookUpStructure(const std::string
  */
 const EnumCreator* ProtocolParser::lookUpEnumeration(const std::string& enumName) const
 {
-    for(std::size_t i = 0; i < globalEnums.size(); i++)
-    {
-        if(globalEnums.at(i)->getName() == enumName)
-        {
-            return globalEnums.at(i);
-        }
-    }
-
-    for(std::size_t i = 0; i < enums.size(); i++)
-    {
-        if(enums.at(i)->getName() == enumName)
-        {
-            return enums.at(i);
-        }
-    }
-
-    return 0;
+    addDependency(PrecompiledLibrary::enumerationLookup, enumName);
+    return symbols.lookUpEnumeration(enumName);
 }
 
 
@@ -1108,19 +1389,8 @@ const EnumCreator* ProtocolParser::lookUpEnumeration(const std::string& enumName
  */
 std::string ProtocolParser::replaceEnumerationNameWithValue(const std::string& text) const
 {
-    std::string replace = text;
-
-    for(std::size_t i = 0; i < globalEnums.size(); i++)
-    {
-        replace = globalEnums.at(i)->replaceEnumerationNameWithValue(replace);
-    }
-
-    for(std::size_t i = 0; i < enums.size(); i++)
-    {
-        replace = enums.at(i)->replaceEnumerationNameWithValue(replace);
-    }
-
-    return replace;
+    addDependency(PrecompiledLibrary::valueReplacement, text);
+    return symbols.replaceEnumerationNameWithValue(text);
 }
 
 
@@ -1132,19 +1402,12 @@ std::string ProtocolParser::replaceEnumerationNameWithValue(const std::string& t
  */
 std::string ProtocolParser::getEnumerationNameForEnumValue(const std::string& text) const
 {
-    for(std::size_t i = 0; i < globalEnums.size(); i++)
-    {
-        if(globalEnums.at(i)->isEnumerationValue(text))
-            return globalEnums.at(i)->getName();
-    }
-
-    for(std::size_t i = 0; i < enums.size(); i++)
-    {
-        if(enums.at(i)->isEnumerationValue(text))
-            return enums.at(i)->getName();
-    }
+    const EnumCreator* creator = symbols.lookUpEnumerationForValue(text);
 
-    return std::string();
+    if(creator != nullptr)
+        return creator->getName();
+    else
+        return std::string();
 
 }
 
@@ -1159,24 +1422,7 @@ std::string ProtocolParser::getEnumerationNameForEnumValue(const std::string& te
  */
 std::string ProtocolParser::getEnumerationValueComment(const std::string& name) const
 {
-    std::string comment;
-
-    for(std::size_t i = 0; i < globalEnums.size(); i++)
-    {
-        comment = globalEnums.at(i)->getEnumerationValueComment(name);
-        if(!comment.empty())
-            return comment;
-    }
-
-    for(std::size_t i = 0; i < enums.size(); i++)
-    {
-        comment = enums.at(i)->getEnumerationValueComment(name);
-        if(!comment.empty())
-            return comment;
-    }
-
-    return comment;
-
+    return symbols.getEnumerationValueComment(name);
 }
 
 
@@ -1193,41 +1439,78 @@ std::string ProtocolParser::getEnumerationValueComment(const std::string& name)
  */
 void ProtocolParser::getStructureSubDocumentationDetails(std::string typeName, std::vector<int>& outline, std::string& startByte, std::vector<std::string>& bytes, std::vector<std::string>& names, std::vector<std::string>& encodings, std::vector<std::string>& repeats, std::vector<std::string>& comments) const
 {
-    for(std::size_t i = 0; i < structures.size(); i++)
-    {
-        if(structures.at(i)->typeName == typeName)
-        {
-            return structures.at(i)->getSubDocumentationDetails(outline, startByte, bytes, names, encodings, repeats, comments);
-        }
-    }
+    const ProtocolStructureModule* struc = symbols.lookUpStructure(typeName);
 
-
-    for(std::size_t i = 0; i < packets.size(); i++)
-    {
-        if(packets.at(i)->typeName == typeName)
-        {
-            return packets.at(i)->getSubDocumentationDetails(outline, startByte, bytes, names, encodings, repeats, comments);
-        }
-    }
+    if(struc != nullptr)
+        struc->getSubDocumentationDetails(outline, startByte, bytes, names, encodings, repeats, comments);
 
 }
 
 
 /*!
- * Ouptut documentation for the protocol as a markdown file
+ * Ouptut documentation for the protocol as a markdown file, and the html and
+ * LaTeX rendering of it. The documentation of each item is rendered as it is
+ * generated, and streamed to temporary body files. The header, title page and
+ * table of contents (which needs every heading) are done last, and each output
+ * file is assembled from those and its body file.
  * \param isBigEndian should be true for big endian documentation, else the documentation is little endian.
  * \param inlinecss is the css to use for the markdown output, if blank use default.
  */
 void ProtocolParser::outputMarkdown(bool isBigEndian, std::string inlinecss)
 {
-    std::string basepath = support.outputpath;
+    std::string basepath = support.outputpath();
 
     if (!docsDir.empty())
         basepath = docsDir;
 
     std::string filename = basepath + name + ".markdown";
-    std::string filecontents = "\n\n";
-    ProtocolFile file(filename, support, false);
+    std::string htmlfile =  basepath + name + ".html";
+    std::string latexfile =  basepath + name + ".tex";
+
+    std::error_code ec;
+    if(std::filesystem::path(filename).has_parent_path())
+        std::filesystem::create_directories(std::filesystem::path(filename).parent_path(), ec);
+
+    // The bodies of the documents, which are streamed as they are generated
+    std::string bodyprefix = basepath + ProtocolFile::tempprefix + name;
+    std::fstream markdownbody(bodyprefix + ".markdown.body", std::ios_base::out | std::ios_base::trunc);
+    std::fstream htmlbody(bodyprefix + ".html.body", std::ios_base::out | std::ios_base::trunc);
+    std::fstream latexbody;
+
+    if(latexEnabled)
+        latexbody.open(bodyprefix + ".tex.body", std::ios_base::out | std::ios_base::trunc);
+
+    // Rendering also collects the headings for the table of contents
+    MarkdownRenderer renderer;
+    LatexRenderer latexrenderer;
+
+    // Text is held back from the last line break, so the page break
+    // replacement (which matches a line break) sees each line break once
+    std::string pending = "\n\n";
+
+    auto stream = [&](const std::string& text, bool last)
+    {
+        pending += text;
+
+        std::size_t end = last ? pending.size() : pending.rfind('\n');
+        if((end == std::string::npos) || (end == 0))
+            return;
+
+        std::string chunk = pending.substr(0, end);
+        pending.erase(0, end);
+
+        // Add html page breaks at each ---
+        replaceinplace(chunk, "\n---", "<div class=\"page-break\"></div>\n\n\n---");
+
+        // Deal with the degrees symbol, which doesn't render in html
+        replaceinplace(chunk, "°", "&deg;");
+
+        markdownbody << chunk;
+        renderer.render(chunk, htmlbody, false);
+
+        if(latexEnabled)
+            latexrenderer.render(chunk, latexbody, false);
+    };
 
     std::vector<std::string> packetids;
     for(std::size_t i = 0; i < packets.size(); i++)
@@ -1238,20 +1521,23 @@ void ProtocolParser::outputMarkdown(bool isBigEndian, std::string inlinecss)
     /* Write protocol introductory information */
     if (hasAboutSection())
     {
+        std::string about;
+
         if(title.empty())
-            filecontents += "# " + name + " Protocol\n\n";
+            about += "# " + name + " Protocol\n\n";
         else
-            filecontents += "# " + title + "\n\n";
+            about += "# " + title + "\n\n";
 
         if(!comment.empty())
-            filecontents += outputLongComment("", comment) + "\n\n";
+            about += outputLongComment("", comment) + "\n\n";
 
         if(!version.empty())
-            filecontents += title + " Protocol version is " + version + ".\n\n";
+            about += title + " Protocol version is " + version + ".\n\n";
 
         if(!api.empty())
-            filecontents += title + " Protocol API is " + api + ".\n\n";
+            about += title + " Protocol API is " + api + ".\n\n";
 
+        stream(about, false);
     }
 
     for(std::size_t i = 0; i < alldocumentsinorder.size(); i++)
@@ -1263,180 +1549,112 @@ void ProtocolParser::outputMarkdown(bool isBigEndian, std::string inlinecss)
         if(alldocumentsinorder.at(i)->isHidden() && !support.showAllItems)
             continue;
 
-        filecontents += alldocumentsinorder.at(i)->getTopLevelMarkdown(true, packetids);
-        filecontents += "\n";
+        stream(alldocumentsinorder.at(i)->getTopLevelMarkdown(true, packetids) + "\n", false);
     }
 
     if (hasAboutSection())
-        filecontents += getAboutSection(isBigEndian);
+        stream(getAboutSection(isBigEndian), true);
+    else
+        stream(std::string(), true);
+
+    markdownbody.close();
+    htmlbody.close();
+    latexbody.close();
+
+    std::string header;
 
     // The title attribute, remove any emphasis characters. We only put this
     // out if we have a title page, this preserves the behavior before 2.14,
     // which did not have a title attribute
     if(!titlePage.empty())
-        file.write("Title:" + title + "\n\n");
+        header += "Title:" + title + "\n\n";
 
     // Specific header-level definitions are required for LaTeX compatibility
     if (latexEnabled)
     {
-        file.write("Base Header Level: 1 \n");  // Base header level refers to the HTML output format
-        file.write("LaTeX Header Level: " + std::to_string(latexHeader) + " \n"); // LaTeX header level can be set by user
-        file.write("\n");
+        header += "Base Header Level: 1 \n";  // Base header level refers to the HTML output format
+        header += "LaTeX Header Level: " + std::to_string(latexHeader) + " \n"; // LaTeX header level can be set by user
+        header += "\n";
     }
 
     // Add stylesheet information (unless it is disabled entirely)
     if (!nocss)
     {
         // Open the style tag
-        file.write("<style>\n");
+        header += "<style>\n";
 
         if(inlinecss.empty())
-            file.write(getDefaultInlinCSS());
+            header += getDefaultInlinCSS();
         else
-            file.write(inlinecss);
+            header += inlinecss;
 
         // Close the style tag
-        file.write("</style>\n");
+        header += "</style>\n";
 
-        file.write("\n");
+        header += "\n";
     }
 
-    if(tableOfContents)
-    {
-        std::string temp = getTableOfContents(filecontents);
-        temp += "----------------------------\n\n";
-        temp += filecontents;
-        filecontents = temp;
-    }
+    std::string prologue;
 
     if(!titlePage.empty())
-    {
-        std::string temp = titlePage;
-        temp += "\n----------------------------\n\n";
-        temp += filecontents;
-        filecontents = temp;
-    }
-
-    // Add html page breaks at each ---
-    replaceinplace(filecontents, "\n---", "<div class=\"page-break\"></div>\n\n\n---");
+        prologue = titlePage + "\n----------------------------\n\n";
 
-    // Deal with the degrees symbol, which doesn't render in html
-    replaceinplace(filecontents, "°", "&deg;");
+    std::string contents;
 
-    file.write(filecontents);
-
-    file.flush();
+    if(tableOfContents)
+        contents = renderer.getTableOfContents() + "----------------------------\n\n";
 
-    // Write html documentation
-    std::string htmlfile =  basepath + name + ".html";
-    std::cout << "Writing HTML documentation to " << htmlfile << std::endl;
-    #if defined(__APPLE__) && defined(__MACH__)
-    std::system(("/usr/local/bin/MultiMarkdown " + filename + " > " + htmlfile).c_str());
-    #else    
-    std::system(("multimarkdown " + filename + " > " + htmlfile).c_str());
-    #endif
+    replaceinplace(prologue, "\n---", "<div class=\"page-break\"></div>\n\n\n---");
+    replaceinplace(prologue, "°", "&deg;");
+    replaceinplace(contents, "\n---", "<div class=\"page-break\"></div>\n\n\n---");
+    replaceinplace(contents, "°", "&deg;");
 
-    if (latexEnabled)
+    // Assemble an output file from its start and its body. The start is
+    // rendered first, since the document title comes from the header metadata
+    auto assemble = [&](const std::string& outputfile, const std::string& bodyfile, const std::string& start, const std::string& end)
     {
-        // Write LaTeX documentation
-        std::string latexfile =  basepath + name + ".tex";
-        std::cout << "Writing LaTeX documentation to " << latexfile << "\n";
-
-        #if defined(__APPLE__) && defined(__MACH__)
-        std::system(("/usr/local/bin/MultiMarkdown " + filename + " > " + latexfile + " --to=latex").c_str());
-        #else
-        std::system(("multimarkdown " + filename + " > " + latexfile + " --to=latex").c_str());
-        #endif
-    }
-}
-
-
-/*!
- * Get the table of contents, based on the file contents
- * \param filecontents are the file contents (without a TOC)
- * \return the table of contents data
- */
-std::string ProtocolParser::getTableOfContents(const std::string& filecontents)
-{
-    std::string output;
+        std::string tempfile = basepath + ProtocolFile::tempprefix + std::filesystem::path(outputfile).filename().string();
 
-    // The table of contents identifies all the heding references, which start
-    // with #. Each heading reference is also prefaced by two line feeds. The
-    // level of the heading (and toc line) is defined by the number of #s.
-    std::vector<std::string> headings = split(filecontents, "\n\n#");
-
-    if(headings.size() > 0)
-        output = "<toctitle id=\"tableofcontents\">Table of contents</toctitle>\n";
+        {
+            std::fstream output(tempfile, std::ios_base::out | std::ios_base::trunc);
+            std::fstream body(bodyfile, std::ios_base::in);
 
-    for(std::size_t i = 0; i < headings.size(); i++)
-    {
-        std::string refname;
-        std::string text;
-        int level = 1;
+            output << start;
 
-        // Pull the first line out of the heading group
-        std::string line = headings.at(i).substr(0, headings.at(i).find("\n"));
+            if(body.is_open() && (body.peek() != std::char_traits<char>::eof()))
+                output << body.rdbuf();
 
-        std::size_t prolog;
-        for(prolog = 0; prolog < line.size(); prolog++)
-        {
-            char symbol = line.at(prolog);
+            output << end;
+        }
 
-            if(symbol == '#')       // Count the level
-                level++;
-            else if(symbol == ' ')  // Remove leading spaces
-                continue;
-            else
-            {
-                // Remove the prolog and get out
-                line.erase(0, prolog);
-                break;
-            }
+        ProtocolFile::deleteFile(bodyfile);
+        ProtocolFile::replaceFileIfDifferent(outputfile, tempfile);
+    };
 
-        }// for all characters
+    assemble(filename, bodyprefix + ".markdown.body", header + prologue + contents, std::string());
 
-        // Special check in case we got a weird one
-        if(line.empty())
-            continue;
+    // Write html documentation
+    std::cout << "Writing HTML documentation to " << htmlfile << std::endl;
 
-        // Now figure out the reference. It is either going to be given by some
-        // embedded html, or by the id that markdown will put into the output html
-        if(contains(line, "<a name=") && contains(line, "\""))
-        {
-            // The text is after the reference closure
-            text = line.substr(line.find("</a>")+4);
+    std::ostringstream htmlstart;
+    renderer.render(header + prologue + contents, htmlstart, true);
+    assemble(htmlfile, bodyprefix + ".html.body", renderer.documentStart() + htmlstart.str(), renderer.documentEnd());
 
-            // In this case the reference name is contained within quotes
-            std::size_t start = line.find("\"") + 1;
-            refname = line.substr(start, line.find("\"", start) - start - 1);
-        }
-        else
-        {
-            // The text for the line is the line
-            text = line;
-
-            // In this case the reference name is the whole line, lower case, no spaces and other special characters
-            refname = toLower(line);
-            replaceinplace(refname, " ");
-            replaceinplace(refname, "(");
-            replaceinplace(refname, ")");
-            replaceinplace(refname, "{");
-            replaceinplace(refname, "}");
-            replaceinplace(refname, "[");
-            replaceinplace(refname, "]");
-            replaceinplace(refname, "`");
-            replaceinplace(refname, "\"");
-            replaceinplace(refname, "*");
-        }
+    if (latexEnabled)
+    {
+        // Write LaTeX documentation, the table of contents comes from LaTeX
+        std::cout << "Writing LaTeX documentation to " << latexfile << "\n";
 
-        // Finally the actual line
-        output += "<toc"+std::to_string(level)+"><a href=\"#" + refname + "\">" + text + "</a></toc"+std::to_string(level)+">\n";
+        std::ostringstream latexstart;
+        latexrenderer.render(header + prologue, latexstart, true);
 
-    }// for all headings
+        if(tableOfContents)
+            latexstart << "\\tableofcontents\n\n";
 
-    return output + "\n";
+        assemble(latexfile, bodyprefix + ".tex.body", latexrenderer.documentStart() + latexstart.str(), latexrenderer.documentEnd());
+    }
 
-}// ProtocolParser::getTableOfContents
+}// ProtocolParser::outputMarkdown
 
 
 /*!
@@ -1532,6 +1750,18 @@ bool ProtocolParser::isFieldSet(const std::string& attribname, const XMLAttribut
 }
 
 
+/*!
+ * Determine if the value of an attribute is either {'true','yes','1'}
+ * \param attribname is the name of the attribute to test
+ * \param index is the attribute index of the element to search
+ * \return true if the attribute value is "true", "yes", or "1"
+ */
+bool ProtocolParser::isFieldSet(const std::string& attribname, const AttributeIndex& index)
+{
+    return isFieldSet(ProtocolParser::getAttribute(attribname, index));
+}
+
+
 /*!
  * Determine if the value of an attribute is either {'true','yes','1'}
  * \param value is the attribute value to test
@@ -1577,6 +1807,18 @@ bool ProtocolParser::isFieldClear(const std::string& attribname, const XMLAttrib
 }
 
 
+/*!
+ * Determine if the value of an attribute is either {'false','no','0'}
+ * \param attribname is the name of the attribute to test
+ * \param index is the attribute index of the element to search
+ * \return true if the attribute value is "false", "no", or "0"
+ */
+bool ProtocolParser::isFieldClear(const std::string& attribname, const AttributeIndex& index)
+{
+    return isFieldClear(ProtocolParser::getAttribute(attribname, index));
+}
+
+
 /*!
  * Determine if the value of an attribute is either {'false','no','0'}
  * \param value is the attribute value to test
@@ -1802,3 +2044,545 @@ void ProtocolParser::outputDoxygen(void)
     ProtocolFile::deleteFile("Doxyfile");
     ProtocolFile::deleteFile(fileName);
 }
+
+
+/*!
+ * Output a Python module with a NumPy dtype for every structure and packet
+ * whose encoding has a fixed layout, and functions that decode and verify
+ * many encoded structures at once, without a Python loop per structure.
+ * Structures whose layout depends on their contents are listed in a comment.
+ */
+void ProtocolParser::outputNumpy(void)
+{
+    std::string output;
+
+    output += "# " + name + "Numpy.py was generated by ProtoGen version " + genVersion + "\n";
+    output += "#\n";
+    output += "# NumPy dtypes and vectorized decoders for the " + name + " protocol. Each\n";
+    output += "# read function decodes many encoded structures (for example the payloads\n";
+    output += "# of a log of packets) into a dictionary of columns, one array per field.\n";
+    output += "\n";
+    output += "import numpy as np\n";
+
+    // Helpers used by the generated functions
+    output += R"(
+
+def _records(data, dtype, offset=0, stride=None, count=-1):
+    """View count records of dtype in data, which are stride bytes apart"""
+    if stride is None:
+        stride = dtype.itemsize
+    available = (memoryview(data).nbytes - offset - dtype.itemsize)//stride + 1
+    if count < 0:
+        count = max(available, 0)
+    elif count > available:
+        raise ValueError('data holds %d records, not %d' % (max(available, 0), count))
+    return np.ndarray((count,), dtype, buffer=data, offset=offset, strides=(stride,))
+
+
+def _uint(raw, bigendian):
+    """Assemble unsigned integers from the bytes in the last axis of raw"""
+    if not bigendian:
+        raw = raw[..., ::-1]
+    value = np.zeros(raw.shape[:-1], dtype=np.uint64)
+    for i in range(raw.shape[-1]):
+        value = (value << np.uint64(8)) | raw[..., i].astype(np.uint64)
+    return value
+
+
+def _int(raw, bigendian):
+    """Assemble signed integers from the bytes in the last axis of raw"""
+    m = np.int64(1) << np.int64(8*raw.shape[-1] - 1)
+    return (_uint(raw, bigendian).astype(np.int64) ^ m) - m
+
+
+def _bits(raw, start, width):
+    """Extract width bits, starting start bits from the most significant bit of raw"""
+    first = start//8
+    last = (start + width - 1)//8
+    value = _uint(raw[..., first:last + 1], True)
+    shift = 8*(last + 1) - start - width
+    return (value >> np.uint64(shift)) & np.uint64((1 << width) - 1)
+
+
+def _specialFloat(value, bits, sigbits):
+    """Convert float16 or float24 bit patterns to float64"""
+    value = value.astype(np.int64)
+    sign = np.where(value & (1 << (bits - 1)), -1.0, 1.0)
+    exponent = (value >> sigbits) & ((1 << (bits - 1 - sigbits)) - 1)
+    significand = value & ((1 << sigbits) - 1)
+    bias = (1 << (bits - 2 - sigbits)) - 1
+    normal = np.ldexp(1.0 + significand/float(1 << sigbits), exponent - bias)
+    subnormal = np.ldexp(significand/float(1 << sigbits), 1 - bias)
+    special = np.where(significand == 0, np.inf, np.nan)
+    maximum = (1 << (bits - 1 - sigbits)) - 1
+    return sign*np.where(exponent == maximum, special, np.where(exponent == 0, subnormal, normal))
+
+
+def _divide(value, divisor):
+    """Integer division which truncates toward zero, like C"""
+    value = value.astype(np.int64)
+    return np.sign(value)*(np.abs(value)//divisor)
+
+
+def _limit(values, low, high, good):
+    """Clip values to [low, high], clearing good for records that were clipped"""
+    low = None if low is None else values.dtype.type(low)
+    high = None if high is None else values.dtype.type(high)
+    bad = np.zeros(values.shape, dtype=np.bool_)
+    if low is not None:
+        bad |= values < low
+    if high is not None:
+        bad |= values > high
+    good &= ~bad.reshape(len(good), -1).any(axis=1)
+    return np.clip(values, low, high)
+
+
+def _length(columns):
+    """Return the number of records in a dictionary of columns"""
+    for value in columns.values():
+        if isinstance(value, dict):
+            return _length(value)
+        return len(value)
+    return 0
+)";
+
+    std::vector<const ProtocolStructureModule*> modules(structures.begin(), structures.end());
+
+    // Packets which can be used by other packets are already in the structures
+    for(std::size_t i = 0; i < packets.size(); i++)
+    {
+        if(std::find(modules.begin(), modules.end(), packets.at(i)) == modules.end())
+            modules.push_back(packets.at(i));
+    }
+
+    for(const ProtocolStructureModule* module : modules)
+    {
+        // Don't output if hidden and we are omitting hidden items
+        if(module->isHidden() && !module->isNeverOmit() && support.omitIfHidden)
+            continue;
+
+        std::string reason = module->getNumpyIncompatibility();
+
+        if(reason.empty())
+            output += module->getNumpyDefinition();
+        else
+            output += "\n\n# " + module->getNumpyName() + " is not included: " + reason + "\n";
+    }
+
+    ProtocolFile::writeFileIfDifferent(support.outputpath() + name + "Numpy.py", output);
+
+}// ProtocolParser::outputNumpy
+
+
+/*!
+ * Parse the packets which are not available for other packets, without any
+ * output, and find the packets which have the same layout as a later packet.
+ * Those packets output byte array functions for the later packets to call.
+ */
+void ProtocolParser::parsePacketLayouts(void)
+{
+    std::unordered_map<std::string, ProtocolPacket*> firstpackets;
+
+    for(std::size_t i = 0; i < packets.size(); i++)
+    {
+        ProtocolPacket* packet = packets.at(i);
+
+        if(isFieldSet(packet->getElement(), "useInOtherPackets"))
+            continue;
+
+        packet->parseDefinition();
+
+        // Later packets can look it up, as if it had been output
+        symbols.addStructure(packet);
+
+        std::string signature = packet->getPacketLayoutSignature();
+
+        if(signature.empty())
+            continue;
+
+        auto it = firstpackets.find(signature);
+
+        if(it == firstpackets.end())
+            firstpackets.emplace(signature, packet);
+        else
+            it->second->enableLayoutFunctions();
+    }
+
+}// ProtocolParser::parsePacketLayouts
+
+
+/*!
+ * Parse a global enumeration. If the enumeration is from a Require'd file it
+ * is loaded from the precompiled library of the file instead, as long as
+ * everything it looked up when it was precompiled gives the same answer. The
+ * warnings of the parse are printed again when it is loaded.
+ * \param index is the index of the enumeration in globalEnums
+ */
+void ProtocolParser::parseGlobalEnumeration(std::size_t index)
+{
+    EnumCreator* module = globalEnums.at(index);
+
+    std::map<const ProtocolDocumentation*, PrecompiledSource>::iterator it = precompiled.find(module);
+
+    if(it == precompiled.end())
+    {
+        module->parseGlobal();
+        return;
+    }
+
+    PrecompiledSource source = it->second;
+    precompiled.erase(it);
+
+    if(precompile)
+    {
+        PrecompiledLibrary::Entry& entry = source.library->addEntry(source.element);
+
+        dependencies = &entry.dependencies;
+        dependencyrank = symbols.getEnumerationCount();
+
+        {
+            OutputRecorder recorder(entry.output);
+            module->parseGlobal();
+        }
+
+        dependencies = nullptr;
+
+        CacheWriter writer;
+        module->save(writer);
+        entry.model = writer.data();
+        return;
+    }
+
+    const PrecompiledLibrary::Entry* entry = source.library->getEntry(source.element);
+
+    if((entry != nullptr) && hasCurrentDependencies(*entry))
+    {
+        CacheReader reader(entry->model);
+
+        if(module->load(reader))
+        {
+            OutputRecorder::replay(entry->output);
+            return;
+        }
+    }
+
+    // Parse a new enumeration, nothing of the failed load is kept
+    const XMLElement* element = module->getElement();
+    EnumCreator* Enum = new EnumCreator(this, toLower(trimm(element->Name())), source.support);
+    Enum->setElement(element);
+
+    globalEnums[index] = Enum;
+    std::replace(alldocumentsinorder.begin(), alldocumentsinorder.end(), (ProtocolDocumentation*)module, (ProtocolDocumentation*)Enum);
+    delete module;
+
+    Enum->parseGlobal();
+
+}// ProtocolParser::parseGlobalEnumeration
+
+
+/*!
+ * Parse the definition of a global structure. If the structure is from a
+ * Require'd file it is loaded from the precompiled library of the file
+ * instead, as long as everything it looked up when it was precompiled gives
+ * the same answer. The warnings of the parse are printed again when it is
+ * loaded. The enumerations of the structure are loaded with it.
+ * \param index is the index of the structure in structures
+ */
+void ProtocolParser::parseStructure(std::size_t index)
+{
+    ProtocolStructureModule* module = structures.at(index);
+
+    std::map<const ProtocolDocumentation*, PrecompiledSource>::iterator it = precompiled.find(module);
+
+    if(it == precompiled.end())
+    {
+        module->parseDefinition();
+        return;
+    }
+
+    PrecompiledSource source = it->second;
+    precompiled.erase(it);
+
+    if(precompile)
+    {
+        PrecompiledLibrary::Entry& entry = source.library->addEntry(source.element);
+
+        dependencies = &entry.dependencies;
+        dependencyrank = symbols.getEnumerationCount();
+
+        {
+            OutputRecorder recorder(entry.output);
+            module->parseDefinition();
+        }
+
+        dependencies = nullptr;
+
+        CacheWriter writer;
+        module->save(writer);
+        entry.model = writer.data();
+        return;
+    }
+
+    const PrecompiledLibrary::Entry* entry = source.library->getEntry(source.element);
+
+    if((entry != nullptr) && hasCurrentDependencies(*entry))
+    {
+        std::size_t enumcount = enums.size();
+        CacheReader reader(entry->model);
+
+        if(module->load(reader))
+        {
+            OutputRecorder::replay(entry->output);
+            return;
+        }
+
+        // Forget the enumerations of the failed load
+        for(std::size_t i = enumcount; i < enums.size(); i++)
+        {
+            symbols.removeEnumeration(enums.at(i));
+            delete enums.at(i);
+        }
+
+        enums.resize(enumcount);
+    }
+
+    // Parse a new structure, nothing of the failed load is kept
+    ProtocolStructureModule* structure = new ProtocolStructureModule(this, source.support, api, version);
+    structure->setElement(module->getElement());
+
+    structures[index] = structure;
+    modulefiles[structure] = modulefiles[module];
+    modulefiles.erase(module);
+    module->clear();
+    delete module;
+
+    structure->parseDefinition();
+
+}// ProtocolParser::parseStructure
+
+
+/*!
+ * Record something looked up by the enumeration or structure being
+ * precompiled. Nothing is recorded unless an object is being precompiled.
+ * \param kind is the PrecompiledLibrary::DependencyKind of the look up
+ * \param argument is what was looked up
+ */
+void ProtocolParser::addDependency(int kind, const std::string& argument) const
+{
+    if(dependencies != nullptr)
+        dependencies->emplace_back(kind, argument, getDependencyResult(kind, argument, dependencyrank));
+}
+
+
+/*!
+ * Get a summary of the answer to a look up, which has everything the parse
+ * uses from the answer. The enumerations of the object being precompiled are
+ * not used, they are loaded with the object, so only the answer from the
+ * enumerations added before a rank is summarized.
+ * \param kind is the PrecompiledLibrary::DependencyKind of the look up
+ * \param argument is what was looked up
+ * \param maxrank is the rank of the first enumeration which is not used
+ * \return the summary of the answer
+ */
+std::string ProtocolParser::getDependencyResult(int kind, const std::string& argument, std::size_t maxrank) const
+{
+    if(kind == PrecompiledLibrary::enumerationLookup)
+    {
+        const EnumCreator* creator = symbols.lookUpEnumerationBefore(argument, maxrank);
+        if(creator == nullptr)
+            return std::string();
+        else
+            return std::to_string(creator->getMinBitWidth()) + " " + std::to_string(creator->getMaximumValue());
+    }
+    else if(kind == PrecompiledLibrary::valueReplacement)
+        return symbols.replaceEnumerationNameWithValueBefore(argument, maxrank);
+    else
+    {
+        const ProtocolStructureModule* structure = symbols.lookUpStructure(argument);
+        if(structure == nullptr)
+            return std::string();
+        else
+            return structure->encodedLength.minEncodedLength + "\n" + structure->encodedLength.maxEncodedLength + "\n" + structure->encodedLength.nonDefaultEncodedLength;
+    }
+
+}// ProtocolParser::getDependencyResult
+
+
+/*!
+ * Determine if everything a precompiled entry looked up when it was parsed
+ * gives the same answer now. If not the entry is out of date, because it
+ * depends on something in another file that changed.
+ * \param entry is the precompiled entry
+ * \return true if the entry can be loaded
+ */
+bool ProtocolParser::hasCurrentDependencies(const PrecompiledLibrary::Entry& entry) const
+{
+    for(const PrecompiledLibrary::Dependency& dependency : entry.dependencies)
+    {
+        if(getDependencyResult(dependency.kind, dependency.argument, symbols.getEnumerationCount()) != dependency.result)
+            return false;
+    }
+
+    return true;
+}
+
+
+/*!
+ * Write the precompiled libraries of the Require'd files, so the next
+ * generation can load their enumerations and structures instead of parsing
+ * them. A library that cannot be written is a warning.
+ */
+void ProtocolParser::savePrecompiledLibraries(void) const
+{
+    for(const PrecompiledLibrary* library : libraries)
+    {
+        if(library->isEmpty())
+            continue;
+
+        if(!library->save())
+            std::cerr << library->getFileName() << ": warning: Failed to write precompiled library" << std::endl;
+    }
+
+}// ProtocolParser::savePrecompiledLibraries
+
+
+/*!
+ * Find the modules which are affected by the files that changed since the
+ * last generation, using the hash of each xml file and the files it Requires.
+ * \param docElem is the top level element of the main file, whose attributes are the protocol options
+ */
+void ProtocolParser::beginModuleCache(const XMLElement* docElem)
+{
+    std::map<std::string, uint64_t> hashes;
+    for(const std::string& file : filesparsed)
+    {
+        uint64_t hash = 0;
+        if(hashFile(file, hash))
+            hashes[file] = hash;
+    }
+
+    std::string options;
+    for(const XMLAttribute* a = docElem->FirstAttribute(); a != nullptr; a = a->Next())
+        options += std::string(a->Name()) + "=" + a->Value() + "\n";
+
+    // Which packets share layouts can change with any packet, so every module is affected
+    if(support.sharelayouts)
+        modulecache->clear();
+
+    modulecache->begin(hashes, requiredfiles, options);
+
+}// ProtocolParser::beginModuleCache
+
+
+/*!
+ * Output a structure or packet module which has been parsed. If the module is
+ * not affected by the files that changed since the last generation only its
+ * file names are setup, and its files are left as they are.
+ * \param module is the structure or packet to output
+ */
+void ProtocolParser::outputModule(ProtocolStructureModule* module)
+{
+    if(modulecache == nullptr)
+    {
+        module->output();
+        return;
+    }
+
+    const std::string& file = modulefiles[module];
+    bool affected = modulecache->isAffected(module->getHierarchicalName(), file);
+
+    if(affected)
+        module->output();
+    else
+        module->outputUnchanged();
+
+    std::vector<std::string> outputs;
+    module->getOutputFiles(outputs);
+    modulecache->addModule(module->getHierarchicalName(), file, outputs, affected);
+
+}// ProtocolParser::outputModule
+
+
+/*!
+ * Determine if this generation is valid, and make it the last generation for
+ * the next one. The generation is not valid if a file of a module which was
+ * not generated was written by something else, because the contents of that
+ * module would be lost. In that case every module must be generated again.
+ * \return true if the generation is valid
+ */
+bool ProtocolParser::finishModuleCache(void)
+{
+    for(const auto& output : modulecache->getUnchangedOutputs())
+    {
+        if(ProtocolFile::isTemporaryFile(output.first))
+        {
+            std::cout << output.second << " shares " << output.first << " with output that changed, generating every module" << std::endl;
+            ProtocolFile::discardTemporaryFiles();
+            modulecache->invalidate(output.second);
+            return false;
+        }
+    }
+
+    modulecache->finish();
+
+    std::cout << "Generated " << modulecache->getGeneratedCount() << " of " << modulecache->getModuleCount() << " structures and packets, the others are unchanged" << std::endl;
+
+    return true;
+
+}// ProtocolParser::finishModuleCache
+
+
+/*!
+ * Get the hash of all the xml files that were parsed, in the order they were
+ * parsed, which identifies the protocol in the files that are shared between
+ * programs built from it.
+ * \return the hash of the xml
+ */
+uint64_t ProtocolParser::getXmlHash(void) const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for(std::size_t i = 0; i < filesparsed.size(); i++)
+    {
+        uint64_t filehash = 0;
+
+        // Files in the resources, which start with ':', are part of ProtoGen itself
+        if(hashFile(filesparsed.at(i), filehash))
+        {
+            hash ^= filehash;
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+
+}// ProtocolParser::getXmlHash
+
+
+/*!
+ * Compute the 64-bit FNV-1a hash of the contents of a file
+ * \param fileName is the name of the file
+ * \param hash receives the hash
+ * \return true if the file could be read
+ */
+bool ProtocolParser::hashFile(const std::string& fileName, uint64_t& hash)
+{
+    std::ifstream file(fileName, std::ios_base::in | std::ios_base::binary);
+
+    if(!file.is_open())
+        return false;
+
+    hash = 14695981039346656037ULL;
+
+    char buffer[65536];
+    while(file.read(buffer, sizeof(buffer)) || (file.gcount() > 0))
+    {
+        for(std::streamsize i = 0; i < file.gcount(); i++)
+        {
+            hash ^= (uint8_t)buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return true;
+
+}// ProtocolParser::hashFile
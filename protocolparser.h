@@ -4,6 +4,13 @@
 #include <iostream>
 #include "protocolfile.h"
 #include "protocolsupport.h"
+#include "symboltable.h"
+#include "attributeindex.h"
+#include "protocolprofiler.h"
+#include "xmlloader.h"
+#include "modulecache.h"
+#include "internedstring.h"
+#include "precompiledlibrary.h"
 #include "tinyxml2.h"
 
 using namespace tinyxml2;
@@ -69,6 +76,42 @@ public:
     //! Disable CSS entirely
     void disableCSS(bool disable) { nocss = disable; }
 
+    //! Use a loader that outlives this parser, so the xml documents stay loaded for the next parser
+    void setXmlLoader(XmlLoader* loader) {xmlloader = (loader != nullptr) ? loader : &ownxmlloader;}
+
+    //! Use a cache that outlives this parser, so only the modules affected by a change are generated again
+    void setModuleCache(ModuleCache* cache) {modulecache = cache;}
+
+    //! Option to report the time and memory used by each phase of the generation
+    void enableProfiling(bool enable) {profiler.enable(enable);}
+
+    //! Option to output NumPy dtypes and vectorized decoders for the structures and packets
+    void enableNumpy(bool enable) {numpy = enable;}
+
+    //! Option to output a multithreaded tool that decodes capture files
+    void enableReplay(bool enable) {replay = enable;}
+
+    //! Option to output functions that append decoded packets to typed columns
+    void enableColumns(bool enable) {columns = enable;}
+
+    //! Option to output an indexed binary log writer and reader for the packets
+    void enableLog(bool enable) {log = enable;}
+
+    //! Option to output a Linux transport that receives and sends packets over UDP in batches
+    void enableUdp(bool enable) {udp = enable;}
+
+    //! Option to output a shared memory channel that publishes packets to other processes
+    void enableShm(bool enable) {shm = enable;}
+
+    //! Option to write the parsed enumerations and structures of Require'd files to precompiled libraries
+    void enablePrecompile(bool enable) {precompile = enable;}
+
+    //! Return the profiler, which has data if profiling was enabled
+    const ProtocolProfiler& getProfiler(void) const {return profiler;}
+
+    //! Return the absolute paths of all the xml files that were parsed, including Require'd files
+    const std::vector<std::string>& getFilesParsed(void) const {return filesparsed;}
+
     //! Parse the DOM from the xml file(s). This kicks off the auto code generation for the protocol
     bool parse(std::string filename, std::string path, std::vector<std::string> otherfiles);
 
@@ -78,6 +121,9 @@ public:
     //! Return the value of an attribute from a Dom Element
     static std::string getAttribute(const std::string& name, const XMLAttribute* attr, const std::string& defaultIfNone = std::string());
 
+    //! Return the value of an attribute from an index of the attributes of a Dom Element
+    static std::string getAttribute(const std::string& name, const AttributeIndex& index, const std::string& defaultIfNone = std::string());
+
     //! Output a long string of text which should be wrapped at 80 characters.
     static void outputLongComment(ProtocolFile& file, const std::string& prefix, const std::string& comment);
 
@@ -87,6 +133,9 @@ public:
     //! Parse all enumerations which are direct children of an element
     const EnumCreator* parseEnumeration(const std::string& parent, const XMLElement* element);
 
+    //! Load an enumeration from a precompiled library, in place of parseEnumeration()
+    const EnumCreator* loadEnumeration(const std::string& parent, const XMLElement* element, CacheReader& reader);
+
     //! Output all includes which are direct children of a node
     void outputIncludes(const std::string& parent, ProtocolFile& file, const XMLNode* node) const;
 
@@ -120,6 +169,12 @@ public:
     //! Find the global structure point for a specific type
     const ProtocolStructureModule* lookUpStructure(const std::string& typeName) const;
 
+    //! Add a structure whose encode and decode functions can be shared by structures with the same layout
+    void addLayout(const std::string& layout, const ProtocolStructure* structure, const std::string& include, const std::string& structinclude) {symbols.addLayout(layout, structure, include, structinclude);}
+
+    //! Find the structure whose encode and decode functions have a specific layout
+    const ProtocolStructure* lookUpLayout(const std::string& layout, std::string* include = nullptr, std::string* structinclude = nullptr) const {return symbols.lookUpLayout(layout, include, structinclude);}
+
     //! Get the documentation details for a specific global structure type
     void getStructureSubDocumentationDetails(std::string typeName, std::vector<int>& outline, std::string& startByte, std::vector<std::string>& bytes, std::vector<std::string>& names, std::vector<std::string>& encodings, std::vector<std::string>& repeats, std::vector<std::string>& comments) const;
 
@@ -141,6 +196,9 @@ public:
     //! Return true if the value of an attribute is 'true', 'yes', or '1'
     static bool isFieldSet(const std::string& attribname, const XMLAttribute* firstattrib);
 
+    //! Return true if the value of an indexed attribute is 'true', 'yes', or '1'
+    static bool isFieldSet(const std::string& attribname, const AttributeIndex& index);
+
     //! Return true if the element has a particular attribute set to {'false','no','0'}
     static bool isFieldClear(const XMLElement* e, const std::string& label);
 
@@ -150,36 +208,85 @@ public:
     //! Determine if the value of an attribute is either {'false','no','0'}
     static bool isFieldClear(const std::string& attribname, const XMLAttribute* firstattrib);
 
+    //! Determine if the value of an indexed attribute is either {'false','no','0'}
+    static bool isFieldClear(const std::string& attribname, const AttributeIndex& index);
+
     //! Set the license text
-    void setLicenseText(const std::string text) { support.licenseText = text; }
+    void setLicenseText(const std::string text) { support.setLicenseText(text); }
 
-    std::string getLicenseText() const { return support.licenseText; }
+    //! Get the license text
+    const std::string& getLicenseText() const { return support.getLicenseText(); }
 
 protected:
 
     //! Parses a single XML file handling any require tags to flatten a file
-    bool parseFile(std::string xmlFilename);
+    bool parseFile(std::string xmlFilename, bool required = false);
+
+    //! Parse a global enumeration, or load it from its precompiled library
+    void parseGlobalEnumeration(std::size_t index);
+
+    //! Parse a global structure, or load it from its precompiled library
+    void parseStructure(std::size_t index);
+
+    //! Record something looked up by the enumeration or structure being precompiled
+    void addDependency(int kind, const std::string& argument) const;
+
+    //! Get the summary of the answer to a look up, as recorded in a precompiled library
+    std::string getDependencyResult(int kind, const std::string& argument, std::size_t maxrank) const;
+
+    //! Determine if everything a precompiled entry looked up still gives the same answer
+    bool hasCurrentDependencies(const PrecompiledLibrary::Entry& entry) const;
+
+    //! Write the precompiled libraries of the Require'd files
+    void savePrecompiledLibraries(void) const;
 
     //! Create markdown documentation
     void outputMarkdown(bool isBigEndian, std::string inlinecss);
 
-    //! Get the table of contents, based on the file contents
-    std::string getTableOfContents(const std::string& filecontents);
-
     //! Get the "About this ICD" section to file
     std::string getAboutSection(bool isBigEndian);
 
     //! Output the doxygen HTML documentation
     void outputDoxygen(void);
 
+    //! Output the NumPy dtypes and vectorized decoders
+    void outputNumpy(void);
+
+    //! Get the macros that size and cast the slots of a queue of packets
+    std::string getPacketQueueMacros(void) const;
+
+    //! Parse the packets that are not used in other packets, and find the ones with the same layout
+    void parsePacketLayouts(void);
+
+    //! Find the modules which are affected by the files that changed since the last generation
+    void beginModuleCache(const XMLElement* docElem);
+
+    //! Output a structure or packet module which has been parsed, unless its output is unchanged
+    void outputModule(ProtocolStructureModule* module);
+
+    //! Determine if the last generation is still valid, and make this generation the last one
+    bool finishModuleCache(void);
+
+    //! Get the hash of all the xml files that were parsed
+    uint64_t getXmlHash(void) const;
+
+    //! Compute the 64-bit FNV-1a hash of the contents of a file
+    static bool hashFile(const std::string& fileName, uint64_t& hash);
+
+    //! Owns the interned strings of this protocol, declared first so it is destroyed last
+    InternedString::Pool strings;
+
     //! Protocol support information
     ProtocolSupport support;
 
-    //! The list of xml documents we created by loading files
-    std::vector<XMLDocument*> xmldocs;
+    //! Loads the xml files and owns the documents, unless a loader is given
+    XmlLoader ownxmlloader;
+
+    //! The loader in use, which is ownxmlloader or one that outlives this parser
+    XmlLoader* xmlloader;
 
-    //! The document currently being parsed
-    XMLDocument* currentxml;
+    //! The cache of modules from the last generation, or null to generate every module
+    ModuleCache* modulecache;
 
     //! The protocol header file (*.h)
     ProtocolHeaderFile* header;
@@ -189,6 +296,8 @@ protected:
     std::string comment;//!< Comment description of the protocol
     std::string version;//!< The version string
     std::string api;    //!< The protocol API enumeration
+    std::string sync;   //!< The bytes that start each frame of the protocol
+    bool packetqueue;   //!< Output the queue of packet slots
 
     std::string docsDir;    //!< Directory target for storing documentation markdown
 
@@ -202,15 +311,43 @@ protected:
     std::string inlinecss;  //!< CSS used for markdown output
     bool nocss;         //!< Disable all CSS output
     bool tableOfContents;//!< Enable table of contents
+    bool numpy;         //!< Output NumPy dtypes and vectorized decoders
+    bool replay;        //!< Output the capture file decode tool
+    bool columns;       //!< Output the functions that append decoded packets to typed columns
+    bool log;           //!< Output the indexed binary log writer and reader
+    bool udp;           //!< Output the batched UDP transport
+    bool shm;           //!< Output the shared memory channel
+    bool precompile;    //!< Write the precompiled libraries, instead of loading them
     std::string titlePage;     //!< Title page information
+    ProtocolProfiler profiler; //!< Records time and memory used by each phase
 
     std::vector<std::string> filesparsed;
+    std::map<std::string, std::vector<std::string>> requiredfiles;      //!< The files each xml file Requires, by absolute file name
+    std::map<const ProtocolStructureModule*, std::string> modulefiles;  //!< The absolute name of the xml file of each structure and packet
     std::vector<ProtocolDocumentation*> alldocumentsinorder;
     std::vector<ProtocolDocumentation*> documents;
     std::vector<ProtocolStructureModule*> structures;
     std::vector<ProtocolPacket*> packets;
     std::vector<EnumCreator*> enums;
     std::vector<EnumCreator*> globalEnums;
+    SymbolTable symbols;    //!< Hashed lookup of the parsed structures and enumerations
+
+    //! Where the parsed data of an enumeration or structure from a Require'd file is kept
+    class PrecompiledSource
+    {
+    public:
+        PrecompiledSource(PrecompiledLibrary* lib, int index, const ProtocolSupport& supported) :
+            library(lib), element(index), support(supported) {}
+
+        PrecompiledLibrary* library;    //!< The library of the file
+        int element;                    //!< The index of the element in the file
+        ProtocolSupport support;        //!< The support the object was constructed with
+    };
+
+    std::vector<PrecompiledLibrary*> libraries; //!< The precompiled libraries of the Require'd files
+    std::map<const ProtocolDocumentation*, PrecompiledSource> precompiled; //!< The enumerations and structures which can be precompiled
+    std::vector<PrecompiledLibrary::Dependency>* dependencies; //!< Receives the look ups of the object being precompiled, or null
+    std::size_t dependencyrank;     //!< Enumerations from this rank are part of the object being precompiled
     std::string inputpath;
     std::string inputfile;
 
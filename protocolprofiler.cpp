@@ -0,0 +1,427 @@
+#include "protocolprofiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//! Count of the memory allocations made while counting
+static std::atomic<uint64_t> globalAllocationCount(0);
+
+//! Heap bytes in use, counted from when a profiler was first enabled, so it can be negative
+static std::atomic<int64_t> globalHeapBytes(0);
+
+//! Most heap bytes in use since the innermost event began
+static std::atomic<int64_t> globalHighWater(0);
+
+//! True once a profiler is enabled, so allocations are only counted when profiling
+static std::atomic<bool> globalCountAllocations(false);
+
+//! True if allocationhooks.cpp is linked
+static std::atomic<bool> globalHooksInstalled(false);
+
+/*!
+ * Construct a disabled profiler
+ */
+ProtocolProfiler::ProtocolProfiler(void) :
+    enabled(false),
+    origin(std::chrono::steady_clock::now())
+{
+}
+
+
+/*!
+ * Enable or disable the profiler. Memory allocations are only counted once a
+ * profiler has been enabled, so a run without profiling does not pay for it.
+ * \param on should be true to enable the profiler
+ */
+void ProtocolProfiler::enable(bool on)
+{
+    enabled = on;
+
+    if(on)
+        globalCountAllocations.store(true, std::memory_order_relaxed);
+
+}// ProtocolProfiler::enable
+
+
+/*!
+ * Begin a phase or module. Phases and modules can be nested.
+ * \param name is the name of the phase, or the hierarchical name of the module
+ * \param module should be true if this is a module, rather than a phase
+ * \return the index of the event, which must be passed to end()
+ */
+std::size_t ProtocolProfiler::begin(const std::string& name, bool module)
+{
+    if(!enabled)
+        return 0;
+
+    Event event;
+    event.name = name;
+    event.module = module;
+    event.duration = 0;
+    event.allocations = 0;
+    event.peak = 0;
+
+    events.push_back(event);
+
+    // Take the measurements last so we don't count our own bookkeeping. The
+    // high-water mark starts again for this event, and the enclosing event's
+    // mark is kept to be restored when this event ends
+    startallocations.push_back(allocationCount());
+    events.back().startBytes = globalHeapBytes.load(std::memory_order_relaxed);
+    events.back().outerHighWater = globalHighWater.exchange(events.back().startBytes, std::memory_order_relaxed);
+    events.back().start = now();
+
+    return events.size() - 1;
+
+}// ProtocolProfiler::begin
+
+
+/*!
+ * End a phase or module that was begun
+ * \param index is the value returned from begin()
+ */
+void ProtocolProfiler::end(std::size_t index)
+{
+    if(!enabled || (index >= events.size()))
+        return;
+
+    Event& event = events[index];
+
+    event.duration = now() - event.start;
+    event.allocations = allocationCount() - startallocations.at(index);
+
+    int64_t highWater = globalHighWater.load(std::memory_order_relaxed);
+    event.peak = (highWater > event.startBytes) ? (uint64_t)(highWater - event.startBytes) : 0;
+
+    // The enclosing event's peak includes the peak of this event
+    globalHighWater.store(std::max(highWater, event.outerHighWater), std::memory_order_relaxed);
+
+}// ProtocolProfiler::end
+
+
+/*!
+ * Get the totals for each phase, in the order the phases first began. Phases
+ * with the same name are combined. Phases can be nested, in which case the
+ * outer phase includes the inner phase.
+ * \param names receives the name of each phase
+ * \param counts receives the number of times each phase was run
+ * \param milliseconds receives the total wall time of each phase
+ * \param allocations receives the total memory allocations of each phase
+ * \param peaks receives the largest peak heap use of each phase, above the heap use at its start
+ */
+void ProtocolProfiler::getPhaseTotals(std::vector<std::string>& names, std::vector<int>& counts, std::vector<double>& milliseconds, std::vector<uint64_t>& allocations, std::vector<uint64_t>& peaks) const
+{
+    names.clear();
+    counts.clear();
+    milliseconds.clear();
+    allocations.clear();
+    peaks.clear();
+
+    for(const Event& event : events)
+    {
+        if(event.module)
+            continue;
+
+        std::size_t i = std::find(names.begin(), names.end(), event.name) - names.begin();
+
+        if(i < names.size())
+        {
+            counts[i]++;
+            milliseconds[i] += event.duration/1000.0;
+            allocations[i] += event.allocations;
+            peaks[i] = std::max(peaks[i], event.peak);
+        }
+        else
+        {
+            names.push_back(event.name);
+            counts.push_back(1);
+            milliseconds.push_back(event.duration/1000.0);
+            allocations.push_back(event.allocations);
+            peaks.push_back(event.peak);
+        }
+
+    }// for all events
+
+}// ProtocolProfiler::getPhaseTotals
+
+
+/*!
+ * Output a text report of the phases and the slowest modules
+ * \param out is the stream to output the report to
+ * \param topcount is the number of slowest modules to list
+ */
+void ProtocolProfiler::report(std::ostream& out, std::size_t topcount) const
+{
+    if(!enabled)
+        return;
+
+    std::vector<std::string> names;
+    std::vector<int> counts;
+    std::vector<double> milliseconds;
+    std::vector<uint64_t> allocations;
+    std::vector<uint64_t> peaks;
+
+    getPhaseTotals(names, counts, milliseconds, allocations, peaks);
+
+    out << std::endl << "Profile" << std::endl;
+    out << std::left << std::setw(32) << "  Phase" << std::right << std::setw(6) << "Count" << std::setw(14) << "Time (ms)";
+    if(hasAllocationHooks())
+        out << std::setw(14) << "Allocations" << std::setw(14) << "Peak (MB)";
+    out << std::endl << std::fixed;
+
+    for(std::size_t i = 0; i < names.size(); i++)
+    {
+        out << std::left << std::setw(32) << ("  " + names.at(i)) << std::right << std::setw(6) << counts.at(i)
+            << std::setw(14) << std::setprecision(3) << milliseconds.at(i);
+
+        if(hasAllocationHooks())
+            out << std::setw(14) << allocations.at(i) << std::setw(14) << std::setprecision(1) << peaks.at(i)/1048576.0;
+
+        out << std::endl;
+    }
+
+    std::vector<const Event*> modules;
+    for(const Event& event : events)
+    {
+        if(event.module)
+            modules.push_back(&event);
+    }
+
+    if(!modules.empty())
+    {
+        std::stable_sort(modules.begin(), modules.end(), [](const Event* a, const Event* b){return a->duration > b->duration;});
+
+        if(modules.size() > topcount)
+            modules.resize(topcount);
+
+        out << std::endl << "  Slowest " << modules.size() << " modules" << std::endl;
+
+        for(const Event* event : modules)
+        {
+            out << std::right << std::setw(14) << std::setprecision(3) << event->duration/1000.0 << " ms";
+
+            if(hasAllocationHooks())
+                out << std::setw(14) << event->allocations << " allocations";
+
+            out << "  " << event->name << std::endl;
+        }
+    }
+
+    out << std::defaultfloat << std::endl;
+
+}// ProtocolProfiler::report
+
+
+/*!
+ * Write the recorded events as a JSON file in the Chrome trace event format
+ * \param fileName is the name of the file to write
+ * \return true if the file was written
+ */
+bool ProtocolProfiler::writeTrace(const std::string& fileName) const
+{
+    std::ofstream file(fileName, std::ios_base::out | std::ios_base::trunc);
+
+    if(!file.is_open())
+        return false;
+
+    file << "{\"traceEvents\":[";
+
+    for(std::size_t i = 0; i < events.size(); i++)
+    {
+        const Event& event = events.at(i);
+
+        if(i > 0)
+            file << ",";
+
+        file << "\n{\"name\":\"" << escapeJSON(event.name) << "\",\"cat\":\"" << (event.module ? "module" : "phase")
+             << "\",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration
+             << ",\"pid\":1,\"tid\":1,\"args\":{\"allocations\":" << event.allocations << ",\"peakBytes\":" << event.peak << "}}";
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return file.good();
+
+}// ProtocolProfiler::writeTrace
+
+
+/*!
+ * \return the number of memory allocations made by the process while a
+ *         profiler was enabled
+ */
+uint64_t ProtocolProfiler::allocationCount(void)
+{
+    return globalAllocationCount.load(std::memory_order_relaxed);
+}
+
+
+/*!
+ * Tell the profiler that allocations can be counted. This is called once,
+ * when allocationhooks.cpp is initialized.
+ * \return true
+ */
+bool ProtocolProfiler::installAllocationHooks(void)
+{
+    globalHooksInstalled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+
+/*!
+ * \return true if allocationhooks.cpp is linked, so memory is measured
+ */
+bool ProtocolProfiler::hasAllocationHooks(void)
+{
+    return globalHooksInstalled.load(std::memory_order_relaxed);
+}
+
+
+/*!
+ * \return true if a profiler has been enabled, so the allocation hooks
+ *         should count allocations and frees. Until then the hooks only
+ *         pay for this check.
+ */
+bool ProtocolProfiler::isCounting(void)
+{
+    return globalCountAllocations.load(std::memory_order_relaxed);
+}
+
+
+/*!
+ * Count an allocation, and raise the heap high-water mark if needed. This is
+ * called by the allocation hooks, from any thread.
+ * \param bytes is the size of the allocation
+ */
+void ProtocolProfiler::countAllocation(std::size_t bytes)
+{
+    globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    int64_t inuse = globalHeapBytes.fetch_add((int64_t)bytes, std::memory_order_relaxed) + (int64_t)bytes;
+    int64_t highWater = globalHighWater.load(std::memory_order_relaxed);
+
+    while((inuse > highWater) && !globalHighWater.compare_exchange_weak(highWater, inuse, std::memory_order_relaxed))
+    {
+    }
+
+}// ProtocolProfiler::countAllocation
+
+
+/*!
+ * Count a free. This is called by the allocation hooks, from any thread.
+ * \param bytes is the size of the memory freed
+ */
+void ProtocolProfiler::countFree(std::size_t bytes)
+{
+    globalHeapBytes.fetch_sub((int64_t)bytes, std::memory_order_relaxed);
+}
+
+
+/*!
+ * \return the peak memory used by the process in bytes, or 0 if not known
+ */
+uint64_t ProtocolProfiler::peakMemory(void)
+{
+    #if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    #else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        #if defined(__APPLE__)
+        // macOS reports bytes
+        return (uint64_t)usage.ru_maxrss;
+        #else
+        // Linux reports kilobytes
+        return (uint64_t)usage.ru_maxrss*1024;
+        #endif
+    }
+    #endif
+
+    return 0;
+
+}// ProtocolProfiler::peakMemory
+
+
+/*!
+ * \return microseconds since the profiler was constructed
+ */
+int64_t ProtocolProfiler::now(void) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+
+/*!
+ * Escape a string for output as a JSON string value
+ * \param text is the string to escape
+ * \return the escaped string, not including the enclosing quotes
+ */
+std::string ProtocolProfiler::escapeJSON(const std::string& text)
+{
+    std::string output;
+
+    for(char c : text)
+    {
+        if((c == '"') || (c == '\\'))
+        {
+            output += '\\';
+            output += c;
+        }
+        else if((unsigned char)c < 0x20)
+        {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned)c);
+            output += buffer;
+        }
+        else
+            output += c;
+    }
+
+    return output;
+
+}// ProtocolProfiler::escapeJSON
+
+
+/*!
+ * Begin a phase or module, which will end when this object is destroyed
+ * \param prof is the profiler which records the phase or module
+ * \param name is the name of the phase, or the hierarchical name of the module
+ * \param module should be true if this is a module, rather than a phase
+ */
+ProtocolProfiler::Scope::Scope(ProtocolProfiler& prof, const std::string& name, bool module) :
+    profiler(prof),
+    index(prof.begin(name, module))
+{
+}
+
+
+/*!
+ * End the phase or module
+ */
+ProtocolProfiler::Scope::~Scope(void)
+{
+    profiler.end(index);
+}
+
+
+/*!
+ * Change the name of the phase or module. This is useful for modules whose
+ * hierarchical name is not known until they are parsed.
+ * \param name is the new name
+ */
+void ProtocolProfiler::Scope::setName(const std::string& name)
+{
+    if(profiler.enabled && (index < profiler.events.size()))
+        profiler.events[index].name = name;
+}
@@ -0,0 +1,128 @@
+#ifndef PROTOCOLPROFILER_H
+#define PROTOCOLPROFILER_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+/*!
+ * The ProtocolProfiler records the wall time, number of memory allocations,
+ * and peak heap use of the phases of a ProtoGen run, and of the individual
+ * modules that are generated. The results can be reported as text, or written
+ * as a JSON trace file that can be loaded by Chrome's trace viewer
+ * (chrome://tracing or ui.perfetto.dev). When the profiler is not enabled it
+ * records nothing.
+ *
+ * Memory is only measured if the program links allocationhooks.cpp, which
+ * replaces the global operator new and delete. The peak of a phase is the
+ * most heap bytes in use above the amount in use when the phase began, so
+ * each phase reports its own peak, not the process high-water mark.
+ */
+class ProtocolProfiler
+{
+public:
+
+    //! Construct a disabled profiler
+    ProtocolProfiler(void);
+
+    //! Enable or disable the profiler
+    void enable(bool on);
+
+    //! \return true if the profiler is enabled
+    bool isEnabled(void) const {return enabled;}
+
+    //! Begin a phase or module, return the index to pass to end()
+    std::size_t begin(const std::string& name, bool module = false);
+
+    //! End a phase or module that was begun
+    void end(std::size_t index);
+
+    //! Get the totals for each phase, combining phases with the same name
+    void getPhaseTotals(std::vector<std::string>& names, std::vector<int>& counts, std::vector<double>& milliseconds, std::vector<uint64_t>& allocations, std::vector<uint64_t>& peaks) const;
+
+    //! Output a text report of the phases and the slowest modules
+    void report(std::ostream& out, std::size_t topcount) const;
+
+    //! Write the recorded events as a Chrome trace viewer JSON file
+    bool writeTrace(const std::string& fileName) const;
+
+    //! Return the number of memory allocations made by the process while a profiler was enabled
+    static uint64_t allocationCount(void);
+
+    //! Return the peak memory used by the process in bytes, or 0 if not known
+    static uint64_t peakMemory(void);
+
+    //! Called by allocationhooks.cpp to tell the profiler allocations can be counted
+    static bool installAllocationHooks(void);
+
+    //! \return true if allocationhooks.cpp is linked, so memory is measured
+    static bool hasAllocationHooks(void);
+
+    //! \return true if the allocation hooks should call countAllocation() and countFree()
+    static bool isCounting(void);
+
+    //! Count an allocation of a number of bytes
+    static void countAllocation(std::size_t bytes);
+
+    //! Count a free of a number of bytes
+    static void countFree(std::size_t bytes);
+
+    /*!
+     * Scope object which begins a phase or module on construction and ends it
+     * on destruction. Does nothing if the profiler is not enabled.
+     */
+    class Scope
+    {
+    public:
+        //! Begin a phase or module
+        Scope(ProtocolProfiler& prof, const std::string& name, bool module = false);
+
+        //! End the phase or module
+        ~Scope(void);
+
+        //! Change the name of the phase or module, for names known only after parsing
+        void setName(const std::string& name);
+
+    private:
+        ProtocolProfiler& profiler; //!< The profiler that records this scope
+        std::size_t index;          //!< The index of the event in the profiler
+    };
+
+protected:
+
+    //! Information about one phase or module
+    class Event
+    {
+    public:
+        std::string name;       //!< Name of the phase, or hierarchical name of the module
+        bool module;            //!< True if this is a module, else it is a phase
+        int64_t start;          //!< Start time in microseconds since the profiler was constructed
+        int64_t duration;       //!< Wall time in microseconds
+        uint64_t allocations;   //!< Number of memory allocations made
+        uint64_t peak;          //!< Most heap bytes in use above the amount at the start
+        int64_t startBytes;     //!< Heap bytes in use at the start
+        int64_t outerHighWater; //!< Heap high-water mark of the enclosing event, restored at the end
+    };
+
+    //! \return microseconds since the profiler was constructed
+    int64_t now(void) const;
+
+    //! Escape a string for output in JSON
+    static std::string escapeJSON(const std::string& text);
+
+    //! Set to true to record events
+    bool enabled;
+
+    //! The time the profiler was constructed
+    std::chrono::steady_clock::time_point origin;
+
+    //! The events that have been recorded, in the order they began
+    std::vector<Event> events;
+
+    //! Allocation count when each event began
+    std::vector<uint64_t> startallocations;
+};
+
+#endif // PROTOCOLPROFILER_H
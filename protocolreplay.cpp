@@ -0,0 +1,614 @@
+#include "protocolreplay.h"
+#include "protocolparser.h"
+#include "protocolpacket.h"
+#include "protocolfile.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+/*!
+ * Construct the generator of the replay tool
+ * \param protocolsupport gives the protocol options
+ * \param protocolname is the name of the protocol
+ * \param protocolsync is the sync attribute of the protocol, which can be empty
+ */
+ProtocolReplay::ProtocolReplay(const ProtocolSupport& protocolsupport, const std::string& protocolname, const std::string& protocolsync) :
+    support(protocolsupport),
+    name(protocolname),
+    sync(protocolsync)
+{
+}
+
+
+/*!
+ * Perform the generation, writing out the tool. Hidden packets are left out
+ * if the protocol omits hidden items.
+ * \param packets are the packets of the protocol, in the order they are reported
+ * \param protocolheader is the name of the main header of the protocol
+ * \return true if the tool was written, false if there are no packets
+ */
+bool ProtocolReplay::generate(const std::vector<ProtocolPacket*>& packets, const std::string& protocolheader)
+{
+    std::string decoders, types, includes;
+
+    for(std::size_t i = 0; i < packets.size(); i++)
+    {
+        const ProtocolPacket* packet = packets.at(i);
+
+        // Don't output if hidden and we are omitting hidden items
+        if(packet->isHidden() && !packet->isNeverOmit() && support.omitIfHidden)
+            continue;
+
+        std::string include = "#include \"" + packet->getHeaderFileName() + "\"\n";
+        if(!contains(includes, include))
+            includes += include;
+
+        std::string decoder = packet->getReplayDecodeFunction();
+        if(!decoder.empty())
+            decoders += "\n" + decoder;
+
+        types += packet->getReplayPacketTypes();
+    }
+
+    if(types.empty())
+    {
+        std::cerr << support.sourcefile() << ": warning: -replay is ignored: there are no packets" << std::endl;
+        return false;
+    }
+
+    std::size_t numsync = 0;
+    std::string syncbytes = getSyncBytes(numsync);
+
+    std::string pointer = "const " + support.pointerType();
+    std::string framelength = "get" + name + "FrameLength";
+    std::string packetid = "get" + name + "PacketID";
+
+    std::string output;
+
+    output += "// " + name + "Replay.cpp was generated by ProtoGen version " + ProtocolParser::genVersion + "\n";
+    output += "//\n";
+    output += "// Decodes a capture file of " + name + " packets in parallel, and reports how\n";
+    output += "// many of each packet were found and how many failed to decode. The file is\n";
+    output += "// memory mapped and split into chunks, which are decoded on a work stealing\n";
+    output += "// thread pool through the generated decode functions. The chunks are merged\n";
+    output += "// in order, and a chunk whose first frame does not line up with the end of\n";
+    output += "// the chunk before is decoded again, so the results are the same as decoding\n";
+    output += "// the file from start to end.\n";
+    output += "//\n";
+    output += "// The framing of packets in the capture is not part of the protocol, so the\n";
+    output += "// code that owns the framing must provide this function:\n";
+    output += "//\n";
+    output += "//     int " + framelength + "(const uint8_t* frame, size_t size);\n";
+    output += "//\n";
+    output += "// It returns the number of bytes in the frame that starts at frame, after\n";
+    output += "// checking its header and checksum, or 0 if frame does not start a valid\n";
+    output += "// frame. size is the number of bytes to the end of the file. A valid frame\n";
+    output += "// is given to the packet interface functions (" + packetid + "() and the\n";
+    output += "// rest) as the packet.";
+    if(numsync > 0)
+        output += " Frames are only looked for at the sync bytes.\n";
+    else
+        output += " The protocol has no sync attribute, so frames are\n// looked for at every byte.\n";
+    output += "//\n";
+    output += "// Build it with the generated sources and the packet interface, for example:\n";
+    output += "//\n";
+    output += "//     c++ -std=c++11 -O2 -pthread " + name + "Replay.cpp <sources> -o " + name + "Replay\n";
+    output += "//\n";
+    output += "// Usage: " + name + "Replay [-threads <n>] [-chunk <megabytes>] [-list <file>] <capture>\n";
+    output += "//\n";
+    output += "// -list writes a line for every frame in file order: the offset, packet name,\n";
+    output += "// packet ID, frame length, and 1 if it decoded (0 if not, - if not decoded).\n";
+    output += "\n";
+    output += "#include <algorithm>\n";
+    output += "#include <cinttypes>\n";
+    output += "#include <condition_variable>\n";
+    output += "#include <chrono>\n";
+    output += "#include <cstdio>\n";
+    output += "#include <cstdlib>\n";
+    output += "#include <cstring>\n";
+    output += "#include <deque>\n";
+    output += "#include <mutex>\n";
+    output += "#include <string>\n";
+    output += "#include <thread>\n";
+    output += "#include <unordered_map>\n";
+    output += "#include <vector>\n";
+    output += "#include <fcntl.h>\n";
+    output += "#include <sys/mman.h>\n";
+    output += "#include <sys/stat.h>\n";
+    output += "#include <unistd.h>\n";
+    output += "#include \"" + protocolheader + "\"\n";
+    output += includes;
+    output += "\n";
+    output += "//! Return the length of the valid frame that starts at frame, or 0, provided by the framing code\n";
+    if(support.language == ProtocolSupport::c_language)
+        output += "extern \"C\" ";
+    output += "int " + framelength + "(const uint8_t* frame, size_t size);\n";
+    output += "\n";
+    output += "namespace\n";
+    output += "{\n";
+    output += "\n";
+    output += "//! The bytes that start every frame\n";
+    if(numsync > 0)
+    {
+        output += "const uint8_t syncBytes[] = {" + syncbytes + "};\n";
+        output += "const std::size_t numSyncBytes = sizeof(syncBytes);\n";
+    }
+    else
+    {
+        output += "const uint8_t syncBytes[] = {0};\n";
+        output += "const std::size_t numSyncBytes = 0;\n";
+    }
+    output += decoders;
+    output += "\n";
+    output += "//! A packet that the tool knows\n";
+    output += "struct PacketType\n";
+    output += "{\n";
+    output += "    uint32_t id;        //!< Packet identifier\n";
+    output += "    const char* name;   //!< Packet name\n";
+    output += "    bool (*decode)(" + pointer + " pkt); //!< Decode function, or null if the packet is only counted\n";
+    output += "};\n";
+    output += "\n";
+    output += "//! All the packets, in the order they are reported\n";
+    output += "const PacketType packetTypes[] =\n";
+    output += "{\n";
+    output += types;
+    output += "};\n";
+    output += "\n";
+    output += "const std::size_t numPacketTypes = sizeof(packetTypes)/sizeof(packetTypes[0]);\n";
+
+// Raw string magic here
+output += R"===(
+//! Counts for one packet
+struct PacketCount
+{
+    uint64_t frames = 0;    //!< Number of frames
+    uint64_t bad = 0;       //!< Number of frames that failed to decode
+    uint64_t bytes = 0;     //!< Number of bytes in the frames
+};
+
+//! One chunk of the file, and the results of decoding it
+struct Chunk
+{
+    std::size_t begin = 0;  //!< Offset where the chunk starts
+    std::size_t end = 0;    //!< Offset where the chunk ends, frames that start before this belong to the chunk
+    std::size_t first = 0;  //!< Offset of the first frame, or stop if there are none
+    std::size_t stop = 0;   //!< Offset where decoding stopped, at or after end
+    uint64_t skipped = 0;   //!< Bytes after the first frame that are not in a frame
+    uint64_t unknown = 0;   //!< Frames whose packet ID is not known
+    std::vector<PacketCount> counts;    //!< Counts for each entry of packetTypes
+    std::string listing;    //!< Lines for the -list output
+    bool done = false;      //!< True once a worker has decoded the chunk
+};
+
+//! The chunk indices for one worker, which other workers steal from when they run out
+class WorkQueue
+{
+public:
+
+    //! Add a job to the back of the queue
+    void push(std::size_t job)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+
+    //! Take the job at the front of the queue, which is used by the owner
+    bool pop(std::size_t& job)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(jobs.empty())
+            return false;
+        job = jobs.front();
+        jobs.pop_front();
+        return true;
+    }
+
+    //! Take the job at the back of the queue, which is used by other workers
+    bool steal(std::size_t& job)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(jobs.empty())
+            return false;
+        job = jobs.back();
+        jobs.pop_back();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<std::size_t> jobs;
+};
+
+//! Everything shared by the workers
+struct Replay
+{
+    const uint8_t* data = nullptr;  //!< The mapped file
+    std::size_t size = 0;           //!< Number of bytes in the file
+    bool list = false;              //!< True to make the -list output
+    std::unordered_map<uint32_t, std::size_t> lookup;   //!< Index into packetTypes for each packet ID
+    std::vector<Chunk> chunks;      //!< The chunks of the file, in order
+    std::vector<WorkQueue> queues;  //!< One queue of chunks for each worker
+    std::mutex mutex;               //!< Protects the done flags of the chunks
+    std::condition_variable ready;  //!< Signaled when a chunk is done
+};
+
+
+/*!
+ * Find the next offset where the sync bytes start
+ * \param replay has the file
+ * \param from is the first offset to look at
+ * \param end is the offset to stop looking at
+ * \return the offset of the sync bytes, or end if there are none
+ */
+std::size_t findSync(const Replay& replay, std::size_t from, std::size_t end)
+{
+    // Without sync bytes every offset could be a frame
+    if(numSyncBytes == 0)
+        return from;
+
+    while(from < end)
+    {
+        const void* hit = std::memchr(replay.data + from, syncBytes[0], end - from);
+        if(hit == nullptr)
+            return end;
+
+        from = (std::size_t)((const uint8_t*)hit - replay.data);
+        if((replay.size - from >= numSyncBytes) && (std::memcmp(replay.data + from, syncBytes, numSyncBytes) == 0))
+            return from;
+
+        from++;
+    }
+
+    return end;
+}
+
+
+/*!
+ * Decode the frames that start in a chunk
+ * \param replay has the file
+ * \param chunk receives the results
+ * \param from is where to start looking for frames, which is the chunk
+ *        begin, or where the previous chunk stopped if it is decoded again
+ */
+void decodeChunk(const Replay& replay, Chunk& chunk, std::size_t from)
+{
+    std::size_t offset = from;
+    bool found = false;
+
+    chunk.counts.assign(numPacketTypes, PacketCount());
+    chunk.skipped = 0;
+    chunk.unknown = 0;
+    chunk.listing.clear();
+
+    while(offset < chunk.end)
+    {
+        std::size_t start = findSync(replay, offset, chunk.end);
+        std::size_t length = 0;
+
+        if(start < chunk.end)
+        {
+            int frame = )===" + framelength + R"===((replay.data + start, replay.size - start);
+            if((frame > 0) && ((std::size_t)frame <= replay.size - start))
+                length = (std::size_t)frame;
+        }
+
+        if(length == 0)
+        {
+            // Not a frame, move on
+            std::size_t next = (start < chunk.end) ? start + 1 : chunk.end;
+            if(found)
+                chunk.skipped += next - offset;
+            offset = next;
+            continue;
+        }
+
+        if(!found)
+        {
+            found = true;
+            chunk.first = start;
+        }
+        else
+            chunk.skipped += start - offset;
+
+        )===" + pointer + R"===( pkt = ()===" + pointer + R"===()(replay.data + start);
+        uint32_t id = )===" + packetid + R"===((pkt);
+        auto type = replay.lookup.find(id);
+        const char* good = "-";
+
+        if(type == replay.lookup.end())
+            chunk.unknown++;
+        else
+        {
+            PacketCount& count = chunk.counts[type->second];
+            count.frames++;
+            count.bytes += length;
+
+            bool (*decode)()===" + pointer + R"===( pkt) = packetTypes[type->second].decode;
+            if(decode != nullptr)
+            {
+                good = "1";
+                if(!decode(pkt))
+                {
+                    good = "0";
+                    count.bad++;
+                }
+            }
+        }
+
+        if(replay.list)
+        {
+            char line[160];
+            std::snprintf(line, sizeof(line), "%zu,%s,%" PRIu32 ",%zu,%s\n", start, (type == replay.lookup.end()) ? "?" : packetTypes[type->second].name, id, length, good);
+            chunk.listing += line;
+        }
+
+        offset = start + length;
+
+    }// while frames start in this chunk
+
+    if(!found)
+        chunk.first = offset;
+
+    chunk.stop = offset;
+}
+
+
+/*!
+ * Decode chunks until there are none left, first from this worker's queue
+ * and then stolen from the other queues
+ * \param replay has the file and the queues
+ * \param index is the index of this worker's queue
+ */
+void worker(Replay& replay, std::size_t index)
+{
+    for(;;)
+    {
+        std::size_t job = 0;
+        bool have = replay.queues[index].pop(job);
+
+        for(std::size_t i = 1; !have && (i < replay.queues.size()); i++)
+            have = replay.queues[(index + i) % replay.queues.size()].steal(job);
+
+        // All the chunks have been taken
+        if(!have)
+            return;
+
+        Chunk& chunk = replay.chunks[job];
+        decodeChunk(replay, chunk, chunk.begin);
+
+        {
+            std::lock_guard<std::mutex> lock(replay.mutex);
+            chunk.done = true;
+        }
+
+        replay.ready.notify_all();
+    }
+}
+
+
+//! Print the usage for the tool
+void usage(const char* program)
+{
+    std::fprintf(stderr, "Usage: %s [-threads <n>] [-chunk <megabytes>] [-list <file>] <capture>\n", program);
+}
+
+}// namespace
+
+
+int main(int argc, char* argv[])
+{
+    std::size_t threads = std::thread::hardware_concurrency();
+    std::size_t chunksize = 16;
+    const char* listname = nullptr;
+    const char* filename = nullptr;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if((std::strcmp(argv[i], "-threads") == 0) && (i + 1 < argc))
+            threads = (std::size_t)std::strtoul(argv[++i], nullptr, 10);
+        else if((std::strcmp(argv[i], "-chunk") == 0) && (i + 1 < argc))
+            chunksize = (std::size_t)std::strtoul(argv[++i], nullptr, 10);
+        else if((std::strcmp(argv[i], "-list") == 0) && (i + 1 < argc))
+            listname = argv[++i];
+        else if((argv[i][0] != '-') && (filename == nullptr))
+            filename = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if(filename == nullptr)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if(threads == 0)
+        threads = 1;
+
+    if(chunksize == 0)
+        chunksize = 1;
+
+    chunksize *= 1024*1024;
+
+    int file = open(filename, O_RDONLY);
+    struct stat status;
+    if((file < 0) || (fstat(file, &status) != 0))
+    {
+        std::perror(filename);
+        return 1;
+    }
+
+    Replay replay;
+    replay.size = (std::size_t)status.st_size;
+
+    void* map = nullptr;
+    if(replay.size > 0)
+    {
+        map = mmap(nullptr, replay.size, PROT_READ, MAP_PRIVATE, file, 0);
+        if(map == MAP_FAILED)
+        {
+            std::perror(filename);
+            return 1;
+        }
+
+        replay.data = (const uint8_t*)map;
+    }
+
+    close(file);
+
+    FILE* listfile = nullptr;
+    if(listname != nullptr)
+    {
+        listfile = std::fopen(listname, "w");
+        if(listfile == nullptr)
+        {
+            std::perror(listname);
+            return 1;
+        }
+
+        std::fputs("offset,packet,id,length,good\n", listfile);
+        replay.list = true;
+    }
+
+    // A packet ID that appears twice belongs to the first packet
+    for(std::size_t i = 0; i < numPacketTypes; i++)
+        replay.lookup.emplace(packetTypes[i].id, i);
+
+    std::size_t numchunks = (replay.size + chunksize - 1)/chunksize;
+    replay.chunks.resize(numchunks);
+    for(std::size_t i = 0; i < numchunks; i++)
+    {
+        replay.chunks[i].begin = i*chunksize;
+        replay.chunks[i].end = std::min(replay.size, (i + 1)*chunksize);
+    }
+
+    // Deal the chunks out in turn, so the early chunks, which are merged
+    // first, are decoded first
+    threads = std::max<std::size_t>(1, std::min(threads, numchunks));
+    replay.queues = std::vector<WorkQueue>(threads);
+    for(std::size_t i = 0; i < numchunks; i++)
+        replay.queues[i % threads].push(i);
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for(std::size_t i = 0; i < threads; i++)
+        pool.emplace_back(worker, std::ref(replay), i);
+
+    std::vector<PacketCount> totals(numPacketTypes);
+    uint64_t skipped = 0, unknown = 0, redone = 0;
+    std::size_t expected = 0;
+
+    // Merge the chunks in order, as they are done
+    for(std::size_t i = 0; i < numchunks; i++)
+    {
+        Chunk& chunk = replay.chunks[i];
+
+        {
+            std::unique_lock<std::mutex> lock(replay.mutex);
+            replay.ready.wait(lock, [&chunk]{return chunk.done;});
+        }
+
+        // The previous chunk stopped after the first frame of this one, so
+        // that frame was found inside a frame, decode the chunk again from
+        // where the previous chunk stopped
+        if(chunk.first < expected)
+        {
+            decodeChunk(replay, chunk, expected);
+            redone++;
+        }
+
+        skipped += (chunk.first - expected) + chunk.skipped;
+        unknown += chunk.unknown;
+
+        for(std::size_t j = 0; j < numPacketTypes; j++)
+        {
+            totals[j].frames += chunk.counts[j].frames;
+            totals[j].bad += chunk.counts[j].bad;
+            totals[j].bytes += chunk.counts[j].bytes;
+        }
+
+        if(listfile != nullptr)
+            std::fwrite(chunk.listing.data(), 1, chunk.listing.size(), listfile);
+
+        expected = chunk.stop;
+
+        // Release the results of the chunk, they are merged
+        std::string().swap(chunk.listing);
+        std::vector<PacketCount>().swap(chunk.counts);
+    }
+
+    for(std::size_t i = 0; i < pool.size(); i++)
+        pool[i].join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    if(listfile != nullptr)
+        std::fclose(listfile);
+
+    if(map != nullptr)
+        munmap(map, replay.size);
+
+    uint64_t frames = 0, bad = 0;
+    std::printf("%-32s %14s %10s %16s\n", "Packet", "Frames", "Bad", "Bytes");
+    for(std::size_t i = 0; i < numPacketTypes; i++)
+    {
+        frames += totals[i].frames;
+        bad += totals[i].bad;
+
+        if(totals[i].frames > 0)
+            std::printf("%-32s %14" PRIu64 " %10" PRIu64 " %16" PRIu64 "\n", packetTypes[i].name, totals[i].frames, totals[i].bad, totals[i].bytes);
+    }
+
+    std::printf("\n");
+    std::printf("%" PRIu64 " frames, %" PRIu64 " failed to decode, %" PRIu64 " with unknown IDs, %" PRIu64 " bytes skipped\n", frames + unknown, bad, unknown, skipped);
+    std::printf("%zu bytes in %zu chunks (%" PRIu64 " decoded again) on %zu threads, %.3f s, %.1f MB/s\n", replay.size, numchunks, redone, threads, seconds, (seconds > 0) ? replay.size/(1024.0*1024.0*seconds) : 0.0);
+
+    return 0;
+}
+)===";
+
+    ProtocolFile::writeFileIfDifferent(support.outputpath() + name + "Replay.cpp", output);
+
+    return true;
+
+}// ProtocolReplay::generate
+
+
+/*!
+ * Get the sync bytes of the protocol, which are a list of numbers separated
+ * by spaces or commas. Numbers which are not bytes are warned about.
+ * \param numsync receives the number of sync bytes, which is 0 if the
+ *        protocol has no sync attribute
+ * \return the sync bytes as a C initializer list, without the braces
+ */
+std::string ProtocolReplay::getSyncBytes(std::size_t& numsync) const
+{
+    std::string syncbytes;
+    std::string list = sync;
+    std::replace(list.begin(), list.end(), ',', ' ');
+    std::istringstream stream(list);
+
+    numsync = 0;
+    for(std::string byte; stream >> byte; numsync++)
+    {
+        char* end = nullptr;
+        unsigned long value = std::strtoul(byte.c_str(), &end, 0);
+        if((end == nullptr) || (*end != '\0') || (value > 255))
+        {
+            std::cerr << support.sourcefile() << ": warning: sync byte \"" << byte << "\" is not a number from 0 to 255" << std::endl;
+            value &= 0xFF;
+        }
+
+        if(!syncbytes.empty())
+            syncbytes += ", ";
+        syncbytes += std::to_string(value);
+    }
+
+    return syncbytes;
+
+}// ProtocolReplay::getSyncBytes
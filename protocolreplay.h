@@ -0,0 +1,46 @@
+#ifndef PROTOCOLREPLAY_H
+#define PROTOCOLREPLAY_H
+
+/*!
+ * \file
+ * Auto magically generate the tool that decodes a capture file of packets in parallel
+ */
+
+
+#include "protocolsupport.h"
+#include <string>
+#include <vector>
+
+class ProtocolPacket;
+
+/*!
+ * The ProtocolReplay writes <Protocol>Replay.cpp, a C++ tool that decodes a
+ * capture file of packets of the protocol on a work stealing thread pool, and
+ * reports how many of each packet were found and how many failed to decode.
+ *
+ * The framing of packets in the capture is not described by the xml, so the
+ * tool depends on two things from outside the packet definitions. The code
+ * that owns the framing must provide get<Protocol>FrameLength(), which returns
+ * the length of the valid frame at a location, or 0. And the tool only looks
+ * for frames where the bytes of the protocol's sync attribute are found, or
+ * at every byte if the protocol has no sync attribute.
+ */
+class ProtocolReplay
+{
+public:
+    ProtocolReplay(const ProtocolSupport& protocolsupport, const std::string& protocolname, const std::string& protocolsync);
+
+    //! Perform the generation, writing out the tool
+    bool generate(const std::vector<ProtocolPacket*>& packets, const std::string& protocolheader);
+
+protected:
+
+    //! Get the sync bytes of the protocol as a C initializer list
+    std::string getSyncBytes(std::size_t& numsync) const;
+
+    ProtocolSupport support;
+    std::string name;   //!< The name of the protocol
+    std::string sync;   //!< The bytes that start each frame of the protocol
+};
+
+#endif // PROTOCOLREPLAY_H
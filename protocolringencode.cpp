@@ -0,0 +1,330 @@
+#include "protocolringencode.h"
+
+ProtocolRingEncode::ProtocolRingEncode(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolRingEncode::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//! Generate the header file
+bool ProtocolRingEncode::generateHeader(void)
+{
+    header.setModuleNameAndPath("ringencode", support.outputpath());
+
+// Raw string magic here
+header.setFileComment(R"(\brief A ring buffer that packets can be encoded into
+
+The ring is a circular buffer with one producer and one consumer, for
+example a transmit routine and the DMA or interrupt that empties it. Ring
+encode functions write the packet data straight into the ring. The buffer
+ends with slack, bytes that are not part of the circle, so a packet that
+wraps around the end is encoded straight on into the slack. When it is
+committed only the bytes in the slack are copied to the start of the
+buffer. The slack must be at least as big as the largest packet encoded
+into the ring, so no temporary copy of the packet is needed.
+
+The producer only changes the head, and the consumer only changes the tail.
+Bytes written at the head are not visible to the consumer until they are
+committed, so the consumer never sees part of a packet. One byte of the
+buffer is always left empty to tell a full ring from an empty one.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("stdint.h", std::string(), true);
+    header.writeIncludeDirective("stddef.h", std::string(), true);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! A ring buffer with a single producer and a single consumer
+typedef struct
+{
+    uint8_t* base;          //!< The caller's buffer
+    uint32_t capacity;      //!< Number of bytes in the circle, which is followed by the slack
+    uint32_t slack;         //!< Number of bytes after the circle that a write can run into
+    volatile uint32_t head; //!< Index of the next byte to write, only the producer changes this
+    volatile uint32_t tail; //!< Index of the next byte to read, only the consumer changes this
+}pgring_t;
+
+//! Initialize a ring to use a caller provided buffer, the end of which is slack
+void initRing(pgring_t* ring, void* storage, uint32_t size, uint32_t slack);
+
+//! Return the number of bytes the producer can write
+uint32_t ringSpace(const pgring_t* ring);
+
+//! Return the number of committed bytes the consumer can read
+uint32_t ringUsed(const pgring_t* ring);
+
+//! Get contiguous space at the head of the ring, which can run into the slack
+uint8_t* reserveRing(pgring_t* ring, uint32_t size);
+
+//! Copy data to the head of the ring, wrapping around the end, without committing it
+int writeRing(pgring_t* ring, const void* data, uint32_t size);
+
+//! Make bytes written at the head of the ring visible to the consumer
+void commitRing(pgring_t* ring, uint32_t size);
+
+//! Get the contiguous committed bytes at the tail of the ring, without removing them
+uint32_t peekRing(const pgring_t* ring, const uint8_t** data);
+
+//! Remove bytes from the tail of the ring, after they have been consumed
+void releaseRing(pgring_t* ring, uint32_t size);
+
+//! Copy bytes out of the tail of the ring, and remove them
+uint32_t readRing(pgring_t* ring, void* data, uint32_t size);
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolRingEncode::generateHeader
+
+
+//! Generate the source file
+bool ProtocolRingEncode::generateSource(void)
+{
+    source.setModuleNameAndPath("ringencode", support.outputpath());
+    source.writeIncludeDirective("string.h", std::string(), true);
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(// The head and tail are shared between the producer and the consumer, which
+// may run on different threads or in an interrupt. The index one side owns
+// is published with release semantics, and the other side's index is read
+// with acquire semantics, so the bytes are in the buffer before they are seen.
+#if defined(__GNUC__) || defined(__clang__)
+#define loadRingIndex(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define storeRingIndex(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#else
+#if (defined(__cplusplus) && (__cplusplus >= 201103L)) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201103L))
+#include <atomic>
+#define ringFence(order) std::atomic_thread_fence(std::memory_order_##order)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define ringFence(order) atomic_thread_fence(memory_order_##order)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+// x86 keeps loads in order and stores in order, only the compiler must not move them
+#define ringFence(order) _ReadWriteBarrier()
+#else
+#error "The ring buffer needs C11 or C++11 atomics, or a memory barrier for this compiler"
+#endif
+// Read the index, and then keep later accesses after the read
+static uint32_t pgRingAcquire(uint32_t index) { ringFence(acquire); return index; }
+#define loadRingIndex(index) pgRingAcquire(index)
+// Keep earlier accesses before the index is written
+#define storeRingIndex(index, value) (ringFence(release), (index) = (value))
+#endif
+
+/*!
+ * Initialize a ring to use a caller provided buffer. The ring is empty. The
+ * last slack bytes of the buffer are not part of the circle, they take the
+ * bytes of a reserved write that runs past the end until it is committed.
+ * \param ring is the ring to initialize
+ * \param storage is the buffer, which must persist as long as the ring is used
+ * \param size is the number of bytes in storage
+ * \param slack is the number of bytes at the end of storage used as slack,
+ *        which should be at least the largest packet encoded into the ring.
+ *        The ring holds size - slack - 1 bytes.
+ */
+void initRing(pgring_t* ring, void* storage, uint32_t size, uint32_t slack)
+{
+    if(slack >= size)
+        slack = 0;
+
+    ring->base = (uint8_t*)storage;
+    ring->capacity = size - slack;
+    ring->slack = slack;
+    ring->head = 0;
+    ring->tail = 0;
+
+}// initRing
+
+
+/*!
+ * Return the number of bytes the producer can write
+ * \param ring is the ring
+ * \return the number of free bytes in the ring
+ */
+uint32_t ringSpace(const pgring_t* ring)
+{
+    uint32_t tail = loadRingIndex(ring->tail);
+
+    return (tail + ring->capacity - ring->head - 1) % ring->capacity;
+
+}// ringSpace
+
+
+/*!
+ * Return the number of committed bytes the consumer can read
+ * \param ring is the ring
+ * \return the number of bytes in the ring
+ */
+uint32_t ringUsed(const pgring_t* ring)
+{
+    uint32_t head = loadRingIndex(ring->head);
+
+    return (head + ring->capacity - ring->tail) % ring->capacity;
+
+}// ringUsed
+
+
+/*!
+ * Get contiguous space at the head of the ring, if there is enough. The space
+ * can run past the end of the circle into the slack, commitRing() moves those
+ * bytes to the start. The space is not committed, call commitRing() once the
+ * bytes are written.
+ * \param ring is the ring
+ * \param size is the number of bytes needed
+ * \return a pointer to the space, or NULL if the ring does not have size
+ *         bytes free, or size is more than fits before the end of the slack
+ */
+uint8_t* reserveRing(pgring_t* ring, uint32_t size)
+{
+    if(size > ringSpace(ring))
+        return NULL;
+
+    if(size > ring->capacity - ring->head + ring->slack)
+        return NULL;
+
+    return ring->base + ring->head;
+
+}// reserveRing
+
+
+/*!
+ * Copy data to the head of the ring, wrapping around the end of the buffer.
+ * The data are not committed, call commitRing() once they are written.
+ * \param ring is the ring
+ * \param data are the bytes to copy
+ * \param size is the number of bytes to copy
+ * \return 1 if the data were copied, 0 if the ring does not have space
+ */
+int writeRing(pgring_t* ring, const void* data, uint32_t size)
+{
+    uint32_t first = ring->capacity - ring->head;
+
+    if(size > ringSpace(ring))
+        return 0;
+
+    if(first > size)
+        first = size;
+
+    memcpy(ring->base + ring->head, data, first);
+    memcpy(ring->base, (const uint8_t*)data + first, size - first);
+
+    return 1;
+
+}// writeRing
+
+
+/*!
+ * Make bytes written at the head of the ring visible to the consumer. Bytes
+ * that were written past the end of the circle, into the slack, are copied
+ * to the start of the buffer first. The space check in reserveRing() makes
+ * sure the consumer is not using those bytes.
+ * \param ring is the ring
+ * \param size is the number of bytes that were written
+ */
+void commitRing(pgring_t* ring, uint32_t size)
+{
+    uint32_t head = ring->head + size;
+
+    if(head >= ring->capacity)
+    {
+        head -= ring->capacity;
+        memcpy(ring->base, ring->base + ring->capacity, head);
+    }
+
+    storeRingIndex(ring->head, head);
+
+}// commitRing
+
+
+/*!
+ * Get the contiguous committed bytes at the tail of the ring, without
+ * removing them. This suits a DMA that sends directly from the ring.
+ * \param ring is the ring
+ * \param data receives a pointer to the bytes
+ * \return the number of contiguous bytes at data, which is less than
+ *         ringUsed() if the bytes wrap around the end of the buffer
+ */
+uint32_t peekRing(const pgring_t* ring, const uint8_t** data)
+{
+    uint32_t head = loadRingIndex(ring->head);
+
+    *data = ring->base + ring->tail;
+
+    if(head >= ring->tail)
+        return head - ring->tail;
+    else
+        return ring->capacity - ring->tail;
+
+}// peekRing
+
+
+/*!
+ * Remove bytes from the tail of the ring, after they have been consumed
+ * \param ring is the ring
+ * \param size is the number of bytes to remove, which must not be more than ringUsed()
+ */
+void releaseRing(pgring_t* ring, uint32_t size)
+{
+    storeRingIndex(ring->tail, (ring->tail + size) % ring->capacity);
+
+}// releaseRing
+
+
+/*!
+ * Copy bytes out of the tail of the ring, and remove them
+ * \param ring is the ring
+ * \param data receives the bytes
+ * \param size is the most bytes to copy
+ * \return the number of bytes copied
+ */
+uint32_t readRing(pgring_t* ring, void* data, uint32_t size)
+{
+    uint32_t used = ringUsed(ring);
+    uint32_t first = ring->capacity - ring->tail;
+
+    if(size > used)
+        size = used;
+
+    if(first > size)
+        first = size;
+
+    memcpy(data, ring->base + ring->tail, first);
+    memcpy((uint8_t*)data + first, ring->base, size - first);
+
+    releaseRing(ring, size);
+
+    return size;
+
+}// readRing
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolRingEncode::generateSource
@@ -0,0 +1,35 @@
+#ifndef PROTOCOLRINGENCODE_H
+#define PROTOCOLRINGENCODE_H
+
+/*!
+ * \file
+ * Auto magically generate the ring buffer that packets can be encoded into
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+
+class ProtocolRingEncode
+{
+public:
+    ProtocolRingEncode(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLRINGENCODE_H
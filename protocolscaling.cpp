@@ -466,7 +466,7 @@ bool ProtocolScaling::areTypesSupported(inmemorytypes_t inmemory, encodedtypes_t
 /*!
  * Construct the protocol scaling object
  */
-ProtocolScaling::ProtocolScaling(ProtocolSupport sup) :
+ProtocolScaling::ProtocolScaling(const ProtocolSupport& sup) :
     header(sup),
     source(sup),
     support(sup)
@@ -530,7 +530,7 @@ bool ProtocolScaling::generate(std::vector<std::string>& fileNameList, std::vect
  */
 bool ProtocolScaling::generateEncodeHeader(void)
 {
-    header.setModuleNameAndPath("scaledencode", support.outputpath, support.language);
+    header.setModuleNameAndPath("scaledencode", support.outputpath(), support.language);
 
     // Top level comment
     header.write(
@@ -664,7 +664,7 @@ bool ProtocolScaling::generateEncodeHeader(void)
  */
 bool ProtocolScaling::generateEncodeSource(void)
 {
-    source.setModuleNameAndPath("scaledencode", support.outputpath, support.language);
+    source.setModuleNameAndPath("scaledencode", support.outputpath(), support.language);
 
     source.writeIncludeDirective("fieldencode");
     source.write("\n");
@@ -1230,7 +1230,7 @@ std::string ProtocolScaling::fullIntegerEncodeFunction(inmemorytypes_t inmemory,
  */
 bool ProtocolScaling::generateDecodeHeader(void)
 {
-    header.setModuleNameAndPath("scaleddecode", support.outputpath, support.language);
+    header.setModuleNameAndPath("scaleddecode", support.outputpath(), support.language);
 
     // Top level comment
     header.write(
@@ -1332,7 +1332,7 @@ bool ProtocolScaling::generateDecodeHeader(void)
  */
 bool ProtocolScaling::generateDecodeSource(void)
 {
-    source.setModuleNameAndPath("scaleddecode", support.outputpath, support.language);
+    source.setModuleNameAndPath("scaleddecode", support.outputpath(), support.language);
 
     source.writeIncludeDirective("fielddecode");
     source.write("\n");
@@ -20,7 +20,7 @@ class ProtocolScaling
 {
 public:
     //! Construct the protocol scaling object
-    ProtocolScaling(ProtocolSupport sup);
+    ProtocolScaling(const ProtocolSupport& sup);
 
     //! Perform the generation, writing out the files
     bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
@@ -0,0 +1,741 @@
+#include "protocolshmchannel.h"
+#include "protocolpacket.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+ProtocolShmChannel::ProtocolShmChannel(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolShmChannel::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*!
+ * Output C++ functions that publish packets of this protocol, and the decoded
+ * structures of its packets, to other processes through shared memory. The
+ * slots of the channel are sized from the largest packet data and the largest
+ * structure. The shared memory channel helper module is output as well.
+ * \param protocolname is the name of the protocol
+ * \param protocolheader is the name of the main header of the protocol
+ * \param packets are the packets of the protocol
+ * \param xmlhash is the hash of the xml files the protocol was parsed from
+ * \param fileNameList is appended with the names of the files that are output
+ * \param filePathList is appended with the paths of the files that are output
+ * \return true if the helper module was output
+ */
+bool ProtocolShmChannel::generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::vector<ProtocolPacket*>& packets, uint64_t xmlhash, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    // The largest packet data of the protocol
+    int maxdatalength = 0;
+    for(std::size_t i = 0; i < packets.size(); i++)
+        maxdatalength = std::max(maxdatalength, packets.at(i)->getMaxDataLength());
+
+    if(maxdatalength <= 0)
+    {
+        std::cerr << support.sourcefile() << ": warning: -shm slots hold 65535 bytes of packet data, because the largest packet is not known" << std::endl;
+        maxdatalength = 65535;
+    }
+
+    std::ostringstream hashstring;
+    hashstring << "0x" << std::hex << std::uppercase << xmlhash << "ULL";
+
+    std::string pointer = support.pointerType();
+
+    ProtocolHeaderFile shmheader(support);
+    ProtocolSourceFile shmsource(support);
+
+    shmheader.setModuleNameAndPath(protocolname + "Shm", support.outputpath(), ProtocolSupport::cpp_language);
+    shmsource.setModuleNameAndPath(protocolname + "Shm", support.outputpath(), ProtocolSupport::cpp_language);
+
+    shmheader.setFileComment("Functions that publish " + protocolname + " packets, and their decoded structures, to other processes through shared memory");
+
+    shmheader.writeIncludeDirective("shmchannel");
+    shmheader.writeIncludeDirective(protocolheader, std::string(), false, false);
+
+    std::vector<std::string> includes;
+    std::string slotsize, prototypes, bodies;
+
+    for(std::size_t i = 0; i < packets.size(); i++)
+    {
+        const ProtocolPacket* packet = packets.at(i);
+
+        // Don't output if hidden and we are omitting hidden items
+        if(packet->isHidden() && !packet->isNeverOmit() && support.omitIfHidden)
+            continue;
+
+        if(!packet->isShmStructure())
+            continue;
+
+        includes.push_back(packet->getHeaderFileName());
+
+        slotsize += "    size = pgShmMax(size, sizeof(" + packet->getUserTypeName() + "));\n";
+
+        ProtocolFile::makeLineSeparator(prototypes);
+        prototypes += packet->getShmPrototype();
+
+        ProtocolFile::makeLineSeparator(bodies);
+        bodies += packet->getShmBody();
+    }
+
+    removeDuplicates(includes);
+    for(std::size_t i = 0; i < includes.size(); i++)
+        shmheader.writeIncludeDirective(includes.at(i), std::string(), false, false);
+
+    shmheader.makeLineSeparator();
+
+    shmheader.write(R"(//! Identifies channels created by this version of the )" + protocolname + R"( protocol
+#define get)" + protocolname + R"(ShmHash() )" + hashstring.str() + R"(
+
+//! Return the largest message of a )" + protocolname + R"( channel
+std::size_t get)" + protocolname + R"(ShmSlotSize(void);
+
+//! Create a channel to publish )" + protocolname + R"( packets to
+bool create)" + protocolname + R"(Shm(PgShmChannel& channel, const char* name, std::size_t slotCount);
+
+//! Open a channel, if it was created by this version of the )" + protocolname + R"( protocol
+bool open)" + protocolname + R"(Shm(PgShmChannel& channel, const char* name);
+
+//! Publish a )" + protocolname + R"( packet
+bool publish)" + protocolname + R"(PacketShm(PgShmChannel& channel, const )" + pointer + R"( pkt);
+
+//! Copy a )" + protocolname + R"( packet from a message read from shared memory
+bool read)" + protocolname + R"(PacketShm(const PgShmMessage& message, )" + pointer + R"( pkt);
+)");
+
+    shmheader.makeLineSeparator();
+    shmheader.write(prototypes);
+    shmheader.makeLineSeparator();
+
+    shmsource.writeIncludeDirective("cstring", std::string(), true, false);
+    shmsource.writeIncludeDirective("type_traits", std::string(), true, false);
+    shmsource.makeLineSeparator();
+
+    shmsource.write(R"(/*!
+ * Return the largest message of a )" + protocolname + R"( channel, which is the larger
+ * of the largest packet data and the largest structure that can be shared
+ * \return the size of the slots of the channel
+ */
+std::size_t get)" + protocolname + R"(ShmSlotSize(void)
+{
+    // The largest packet data
+    std::size_t size = )" + std::to_string(maxdatalength) + R"(;
+)" + slotsize + R"(
+    return size;
+}// get)" + protocolname + R"(ShmSlotSize
+
+
+/*!
+ * Create a channel to publish )" + protocolname + R"( packets to, replacing any shared
+ * memory with the same name
+ * \param channel is the channel which is created
+ * \param name is the shared memory name, or null for anonymous shared memory
+ * \param slotCount is the number of messages the ring holds
+ * \return true if the channel was created
+ */
+bool create)" + protocolname + R"(Shm(PgShmChannel& channel, const char* name, std::size_t slotCount)
+{
+    return channel.create(name, get)" + protocolname + R"(ShmSlotSize(), slotCount, get)" + protocolname + R"(ShmHash());
+}// create)" + protocolname + R"(Shm
+
+
+/*!
+ * Open a channel, if it was created by this version of the )" + protocolname + R"( protocol.
+ * Use PgShmChannel::open() to open a channel from any version.
+ * \param channel is the channel which is opened
+ * \param name is the shared memory name
+ * \return true if the channel was opened, and its hash matches
+ */
+bool open)" + protocolname + R"(Shm(PgShmChannel& channel, const char* name)
+{
+    if(!channel.open(name))
+        return false;
+
+    if(channel.hash() == get)" + protocolname + R"(ShmHash())
+        return true;
+
+    channel.close();
+    return false;
+}// open)" + protocolname + R"(Shm
+
+
+/*!
+ * Publish a )" + protocolname + R"( packet, through the packet interface functions
+ * \param channel is the channel to publish to
+ * \param pkt is the packet
+ * \return true if the packet was published
+ */
+bool publish)" + protocolname + R"(PacketShm(PgShmChannel& channel, const )" + pointer + R"( pkt)
+{
+    return channel.publish(get)" + protocolname + R"(PacketID(pkt), PgShmChannel::Packet, get)" + protocolname + R"(PacketDataConst(pkt), (std::size_t)get)" + protocolname + R"(PacketSize(pkt));
+}// publish)" + protocolname + R"(PacketShm
+
+
+/*!
+ * Copy a )" + protocolname + R"( packet from a message read from shared memory, through
+ * the packet interface functions. The packet must be big enough for the message.
+ * \param message is the message
+ * \param pkt is the packet that receives the message
+ * \return true if the message is a packet
+ */
+bool read)" + protocolname + R"(PacketShm(const PgShmMessage& message, )" + pointer + R"( pkt)
+{
+    if(message.kind != PgShmChannel::Packet)
+        return false;
+
+    std::memcpy(get)" + protocolname + R"(PacketData(pkt), message.data, message.size);
+    finish)" + protocolname + R"(Packet(pkt, (int)message.size, message.id);
+    return true;
+}// read)" + protocolname + R"(PacketShm
+)");
+
+    shmsource.makeLineSeparator();
+    shmsource.write("\n" + bodies);
+    shmsource.makeLineSeparator();
+
+    bool helper = generate(fileNameList, filePathList);
+
+    shmheader.flush();
+    fileNameList.push_back(shmheader.fileName());
+    filePathList.push_back(shmheader.filePath());
+
+    shmsource.flush();
+    fileNameList.push_back(shmsource.fileName());
+    filePathList.push_back(shmsource.filePath());
+
+    return helper;
+
+}// ProtocolShmChannel::generateProtocol
+
+
+//! Generate the header file
+bool ProtocolShmChannel::generateHeader(void)
+{
+    header.setModuleNameAndPath("shmchannel", support.outputpath(), ProtocolSupport::cpp_language);
+
+// Raw string magic here
+header.setFileComment(R"(\brief A shared memory ring that one process publishes messages to, and many read
+
+One publisher process writes messages (decoded structures or raw packets)
+into a ring of fixed size slots in shared memory, and any number of consumer
+processes read them without serialization or locks. Each slot has a version,
+which is odd while the publisher writes the slot and even once the message
+is complete. A consumer copies the message out, and then checks the version
+again: if it changed the publisher lapped the consumer, and the message is
+counted as lost instead of being returned torn. The publisher never waits
+for consumers.
+
+The shared memory is created with shm_open(), so consumers can open it by
+name, or with memfd_create() if no name is given, so its descriptor can be
+passed to consumers (for example across fork()). This module needs Linux, and
+the atomic builtins of gcc or clang.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("cstddef", std::string(), true, false);
+    header.writeIncludeDirective("cstdint", std::string(), true, false);
+    header.writeIncludeDirective("vector", std::string(), true, false);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! Return the larger of two sizes, at compile time
+static constexpr std::size_t pgShmMax(std::size_t one, std::size_t two) {return (one > two) ? one : two;}
+
+//! A message read from a shared memory channel
+typedef struct
+{
+    uint64_t sequence;      //!< The number of messages published before this one
+    uint32_t id;            //!< The packet identifier
+    uint32_t kind;          //!< PgShmChannel::Packet or PgShmChannel::Structure
+    uint32_t size;          //!< The number of bytes of data
+    const uint8_t* data;    //!< The data, valid until the next read
+}PgShmMessage;
+
+
+//! A shared memory ring that one process publishes messages to, and many read
+class PgShmChannel
+{
+public:
+
+    //! The kinds of message
+    enum Kind
+    {
+        Packet,     //!< The data of a validated packet
+        Structure   //!< A decoded structure, copied byte for byte
+    };
+
+    //! Construct a channel, with no shared memory
+    PgShmChannel(void);
+
+    //! Unmap the shared memory
+    ~PgShmChannel(void);
+
+    //! Create the shared memory, as the publisher
+    bool create(const char* name, std::size_t slotSize, std::size_t slotCount, uint64_t hash);
+
+    //! Open shared memory by name, as a consumer
+    bool open(const char* name);
+
+    //! Map shared memory from a descriptor, as a consumer
+    bool attach(int descriptor);
+
+    //! Unmap the shared memory, and close its descriptor
+    void close(void);
+
+    //! Remove the name of shared memory, it is freed once no process maps it
+    static bool unlink(const char* name);
+
+    //! Return the descriptor of the shared memory, or -1
+    int descriptor(void) const {return fd;}
+
+    //! Return the hash that identifies the protocol, given by the publisher
+    uint64_t hash(void) const;
+
+    //! Return the largest message
+    std::size_t getSlotSize(void) const;
+
+    //! Return the number of messages the ring holds
+    std::size_t getSlotCount(void) const;
+
+    //! Publish a message
+    bool publish(uint32_t id, Kind kind, const void* data, std::size_t size);
+
+    //! Read the next message
+    bool read(PgShmMessage& message);
+
+    //! Move the consumer to the next message that will be published
+    void skipToNewest(void);
+
+    //! Return the number of messages this consumer lost, because the publisher lapped it
+    uint64_t lost(void) const {return numLost;}
+
+private:
+
+    //! Map the shared memory from fd and check it
+    bool map(void);
+
+    int fd;                     //!< The descriptor of the shared memory
+    uint8_t* base;              //!< The mapped shared memory
+    std::size_t size;           //!< The number of bytes mapped
+    uint64_t next;              //!< Sequence of the next message this consumer reads
+    uint64_t numLost;           //!< Messages this consumer lost
+    std::vector<uint8_t> copy;  //!< The message read by this consumer
+};
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolShmChannel::generateHeader
+
+
+//! Generate the source file
+bool ProtocolShmChannel::generateSource(void)
+{
+    source.setModuleNameAndPath("shmchannel", support.outputpath(), ProtocolSupport::cpp_language);
+    source.writeIncludeDirective("cstring", std::string(), true, false);
+    source.writeIncludeDirective("fcntl.h", std::string(), true, false);
+    source.writeIncludeDirective("sys/mman.h", std::string(), true, false);
+    source.writeIncludeDirective("sys/stat.h", std::string(), true, false);
+    source.writeIncludeDirective("unistd.h", std::string(), true, false);
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(//! The header at the start of the shared memory, one cache line
+typedef struct
+{
+    char magic[8];          //!< "PGSHM1" and two zeroes
+    uint64_t hash;          //!< Identifies the protocol
+    uint64_t slotSize;      //!< The largest message
+    uint64_t slotCount;     //!< The number of slots
+    uint64_t stride;        //!< Bytes from one slot to the next
+    uint64_t head;          //!< The number of messages published
+    uint64_t reserved[2];   //!< Zero
+}ShmHeader;
+
+//! The header of each slot, which is followed by the message data
+typedef struct
+{
+    uint64_t version;       //!< Twice the sequence, plus one while the slot is written, plus two once it is complete
+    uint32_t id;            //!< The packet identifier
+    uint32_t kind;          //!< The kind of message
+    uint32_t size;          //!< The number of bytes of data
+    uint32_t reserved;      //!< Zero
+}ShmSlot;
+
+//! Return the header of the shared memory, all access to its head is atomic
+static ShmHeader* shmHeader(uint8_t* base) {return (ShmHeader*)base;}
+
+//! Return a slot of the ring
+static ShmSlot* shmSlot(uint8_t* base, uint64_t index) {return (ShmSlot*)(base + sizeof(ShmHeader) + index*shmHeader(base)->stride);}
+
+
+/*!
+ * Construct a channel, with no shared memory
+ */
+PgShmChannel::PgShmChannel(void) :
+    fd(-1),
+    base(nullptr),
+    size(0),
+    next(0),
+    numLost(0)
+{
+}
+
+
+/*!
+ * Unmap the shared memory
+ */
+PgShmChannel::~PgShmChannel(void)
+{
+    close();
+}
+
+
+/*!
+ * Create the shared memory, as the publisher. Slots are cache line aligned,
+ * so a consumer reading one slot does not share a line with the next slot.
+ * \param name is the shared memory name (for example "/gateway"), or null to
+ *        create anonymous memory whose descriptor() can be passed to consumers
+ * \param slotSize is the largest message
+ * \param slotCount is the number of messages the ring holds
+ * \param hash identifies the protocol, so consumers can check it
+ * \return true if the shared memory was created and mapped
+ */
+bool PgShmChannel::create(const char* name, std::size_t slotSize, std::size_t slotCount, uint64_t hash)
+{
+    close();
+
+    if(slotCount == 0)
+        return false;
+
+    if(name == nullptr)
+        fd = memfd_create("pgshm", 0);
+    else
+        fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+
+    if(fd < 0)
+        return false;
+
+    uint64_t stride = (sizeof(ShmSlot) + slotSize + 63) & ~((uint64_t)63);
+
+    size = (std::size_t)(sizeof(ShmHeader) + slotCount*stride);
+
+    if(ftruncate(fd, (off_t)size) != 0)
+    {
+        close();
+        return false;
+    }
+
+    base = (uint8_t*)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(base == (uint8_t*)MAP_FAILED)
+    {
+        base = nullptr;
+        close();
+        return false;
+    }
+
+    // ftruncate() filled the memory with zeroes, so every slot is version 0
+    ShmHeader* head = shmHeader(base);
+    head->hash = hash;
+    head->slotSize = slotSize;
+    head->slotCount = slotCount;
+    head->stride = stride;
+    __atomic_store_n(&head->head, 0, __ATOMIC_RELEASE);
+
+    // The magic goes last, a consumer that sees it sees the rest of the header
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    std::memcpy(head->magic, "PGSHM1", 6);
+
+    return true;
+
+}// PgShmChannel::create
+
+
+/*!
+ * Open shared memory by name, as a consumer. The consumer starts with the
+ * next message that is published.
+ * \param name is the shared memory name that the publisher created
+ * \return true if the shared memory was opened and mapped
+ */
+bool PgShmChannel::open(const char* name)
+{
+    close();
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0)
+        return false;
+
+    return map();
+
+}// PgShmChannel::open
+
+
+/*!
+ * Map shared memory from a descriptor, as a consumer. The descriptor is
+ * duplicated, so the caller still owns it. The consumer starts with the next
+ * message that is published.
+ * \param descriptor is the descriptor of the shared memory
+ * \return true if the shared memory was mapped
+ */
+bool PgShmChannel::attach(int descriptor)
+{
+    close();
+
+    fd = dup(descriptor);
+    if(fd < 0)
+        return false;
+
+    return map();
+
+}// PgShmChannel::attach
+
+
+/*!
+ * Map the shared memory from the descriptor, read only, and check its header
+ * \return true if the memory was mapped and is a channel
+ */
+bool PgShmChannel::map(void)
+{
+    struct stat status;
+    if((fstat(fd, &status) != 0) || ((std::size_t)status.st_size < sizeof(ShmHeader)))
+    {
+        close();
+        return false;
+    }
+
+    size = (std::size_t)status.st_size;
+
+    base = (uint8_t*)mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if(base == (uint8_t*)MAP_FAILED)
+    {
+        base = nullptr;
+        close();
+        return false;
+    }
+
+    ShmHeader* head = shmHeader(base);
+
+    if((std::memcmp(head->magic, "PGSHM1", 7) != 0) || (sizeof(ShmHeader) + head->slotCount*head->stride > size))
+    {
+        close();
+        return false;
+    }
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    copy.resize((std::size_t)head->slotSize);
+    skipToNewest();
+
+    return true;
+
+}// PgShmChannel::map
+
+
+/*!
+ * Unmap the shared memory, and close its descriptor. The name of the shared
+ * memory remains until unlink().
+ */
+void PgShmChannel::close(void)
+{
+    if(base != nullptr)
+        munmap(base, size);
+
+    if(fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    base = nullptr;
+    size = 0;
+    next = 0;
+    numLost = 0;
+
+}// PgShmChannel::close
+
+
+/*!
+ * Remove the name of shared memory, it is freed once no process maps it
+ * \param name is the shared memory name
+ * \return true if the name was removed
+ */
+bool PgShmChannel::unlink(const char* name)
+{
+    return shm_unlink(name) == 0;
+
+}// PgShmChannel::unlink
+
+
+/*!
+ * Return the hash that identifies the protocol, given by the publisher
+ * \return the hash, or 0 if there is no shared memory
+ */
+uint64_t PgShmChannel::hash(void) const
+{
+    return (base == nullptr) ? 0 : shmHeader(base)->hash;
+
+}// PgShmChannel::hash
+
+
+/*!
+ * Return the largest message
+ * \return the size of the slots, or 0 if there is no shared memory
+ */
+std::size_t PgShmChannel::getSlotSize(void) const
+{
+    return (base == nullptr) ? 0 : (std::size_t)shmHeader(base)->slotSize;
+
+}// PgShmChannel::getSlotSize
+
+
+/*!
+ * Return the number of messages the ring holds
+ * \return the number of slots, or 0 if there is no shared memory
+ */
+std::size_t PgShmChannel::getSlotCount(void) const
+{
+    return (base == nullptr) ? 0 : (std::size_t)shmHeader(base)->slotCount;
+
+}// PgShmChannel::getSlotCount
+
+
+/*!
+ * Publish a message, overwriting the oldest message in the ring. There must
+ * be only one publisher.
+ * \param id is the packet identifier
+ * \param kind is the kind of message
+ * \param data is the message data
+ * \param size is the number of bytes of data
+ * \return true if the message was published, false if it is too big
+ */
+bool PgShmChannel::publish(uint32_t id, Kind kind, const void* data, std::size_t size)
+{
+    if((base == nullptr) || (size > shmHeader(base)->slotSize))
+        return false;
+
+    ShmHeader* head = shmHeader(base);
+    uint64_t sequence = __atomic_load_n(&head->head, __ATOMIC_RELAXED);
+    ShmSlot* entry = shmSlot(base, sequence % head->slotCount);
+
+    // Odd version: consumers that read the slot now will discard what they read
+    __atomic_store_n(&entry->version, 2*sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    entry->id = id;
+    entry->kind = (uint32_t)kind;
+    entry->size = (uint32_t)size;
+    std::memcpy((uint8_t*)entry + sizeof(ShmSlot), data, size);
+
+    // Even version: the message is complete
+    __atomic_store_n(&entry->version, 2*sequence + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&head->head, sequence + 1, __ATOMIC_RELEASE);
+
+    return true;
+
+}// PgShmChannel::publish
+
+
+/*!
+ * Read the next message, as a consumer. The message is copied out of the
+ * shared memory, and only returned if the publisher did not overwrite it
+ * during the copy. A consumer that falls more than a ring behind skips to the
+ * oldest message still in the ring, and counts the messages it lost.
+ * \param message receives the message, whose data are valid until the next read
+ * \return true if a message was read, false if there is no new message
+ */
+bool PgShmChannel::read(PgShmMessage& message)
+{
+    if(base == nullptr)
+        return false;
+
+    ShmHeader* head = shmHeader(base);
+
+    while(true)
+    {
+        uint64_t published = __atomic_load_n(&head->head, __ATOMIC_ACQUIRE);
+
+        if(next >= published)
+            return false;
+
+        // Messages older than a ring have been overwritten
+        if(published - next > head->slotCount)
+        {
+            numLost += published - head->slotCount - next;
+            next = published - head->slotCount;
+        }
+
+        ShmSlot* entry = shmSlot(base, next % head->slotCount);
+        uint64_t expected = 2*next + 2;
+
+        uint64_t before = __atomic_load_n(&entry->version, __ATOMIC_ACQUIRE);
+
+        if(before == expected)
+        {
+            message.sequence = next;
+            message.id = entry->id;
+            message.kind = entry->kind;
+            message.size = entry->size;
+
+            if(message.size <= copy.size())
+                std::memcpy(copy.data(), (const uint8_t*)entry + sizeof(ShmSlot), message.size);
+
+            // The copy must be done before the version is checked again
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+            if((__atomic_load_n(&entry->version, __ATOMIC_RELAXED) == expected) && (message.size <= copy.size()))
+            {
+                message.data = copy.data();
+                next++;
+                return true;
+            }
+        }
+        else if(before < expected)
+        {
+            // The publisher is still writing this message
+            return false;
+        }
+
+        // The publisher lapped this consumer while it read the slot
+        numLost++;
+        next++;
+    }
+
+}// PgShmChannel::read
+
+
+/*!
+ * Move the consumer to the next message that will be published, skipping any
+ * messages in the ring
+ */
+void PgShmChannel::skipToNewest(void)
+{
+    if(base != nullptr)
+        next = __atomic_load_n(&shmHeader(base)->head, __ATOMIC_ACQUIRE);
+
+}// PgShmChannel::skipToNewest
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolShmChannel::generateSource
@@ -0,0 +1,41 @@
+#ifndef PROTOCOLSHMCHANNEL_H
+#define PROTOCOLSHMCHANNEL_H
+
+/*!
+ * \file
+ * Auto magically generate the shared memory channel that publishes packets to other processes
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+#include <vector>
+
+class ProtocolPacket;
+
+class ProtocolShmChannel
+{
+public:
+    ProtocolShmChannel(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+    //! Perform the generation of the functions that share the packets of a protocol, and the helper module
+    bool generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::vector<ProtocolPacket*>& packets, uint64_t xmlhash, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLSHMCHANNEL_H
@@ -0,0 +1,159 @@
+#include "protocolspanarena.h"
+
+ProtocolSpanArena::ProtocolSpanArena(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolSpanArena::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//! Generate the header file
+bool ProtocolSpanArena::generateHeader(void)
+{
+    header.setModuleNameAndPath("spanarena", support.outputpath());
+
+// Raw string magic here
+header.setFileComment(R"(\brief Storage for the spans of decoded structures
+
+Variable length arrays marked span are declared as a pointer, rather than
+as an array of their maximum length. The pointer and the variable array
+length together are the span. When a structure is decoded the storage for
+each span is drawn from an arena the caller provides, sized by the decoded
+array length. Structures that are kept in memory then only use the storage
+their arrays actually need.
+
+An arena hands out storage from one buffer, in order, and never frees any
+of it. The caller releases all the storage at once by resetting the arena,
+which invalidates every span decoded from it. A batch of packets can be
+decoded into one arena and released together, with no allocation per
+packet. In C the decode functions take the arena by pointer, in C++ they
+take it by reference.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("stdint.h", std::string(), true);
+    header.writeIncludeDirective("stddef.h", std::string(), true);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! Alignment of the storage of each span, in bytes
+#define PG_ARENA_ALIGNMENT 8
+
+//! Storage for spans, provided by the caller
+typedef struct
+{
+    uint8_t* storage;   //!< The caller's buffer
+    size_t size;        //!< Number of bytes in the buffer
+    size_t used;        //!< Number of bytes given out so far
+}pgarena_t;
+
+//! Initialize an arena to give out storage from a caller provided buffer
+void initArena(pgarena_t* arena, void* storage, size_t size);
+
+//! Release all the storage given out by an arena
+void resetArena(pgarena_t* arena);
+
+//! Get the storage for a span from an arena
+void* allocateArenaSpan(pgarena_t* arena, unsigned count, unsigned maximum, size_t size);
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolSpanArena::generateHeader
+
+
+//! Generate the source file
+bool ProtocolSpanArena::generateSource(void)
+{
+    source.setModuleNameAndPath("spanarena", support.outputpath());
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(/*!
+ * Initialize an arena to give out storage from a caller provided buffer
+ * \param arena is the arena to initialize
+ * \param storage is the buffer, which must persist as long as any span drawn from it
+ * \param size is the number of bytes in storage
+ */
+void initArena(pgarena_t* arena, void* storage, size_t size)
+{
+    arena->storage = (uint8_t*)storage;
+    arena->size = size;
+    arena->used = 0;
+
+}// initArena
+
+
+/*!
+ * Release all the storage given out by an arena, so it can be given out
+ * again. Any span that was drawn from the arena is no longer valid.
+ * \param arena is the arena to reset
+ */
+void resetArena(pgarena_t* arena)
+{
+    arena->used = 0;
+
+}// resetArena
+
+
+/*!
+ * Get the storage for a span from an arena. The storage is aligned to
+ * PG_ARENA_ALIGNMENT bytes.
+ * \param arena is the arena to draw the storage from
+ * \param count is the number of elements in the span
+ * \param maximum is the largest number of elements allowed, count is limited to this
+ * \param size is the size of one element in bytes
+ * \return a pointer to the storage, or NULL if the arena does not have enough
+ */
+void* allocateArenaSpan(pgarena_t* arena, unsigned count, unsigned maximum, size_t size)
+{
+    size_t padding, bytes;
+    uint8_t* span;
+
+    if(count > maximum)
+        count = maximum;
+
+    // Padding to align the start of the span
+    padding = (size_t)((uintptr_t)(arena->storage + arena->used) % PG_ARENA_ALIGNMENT);
+    if(padding != 0)
+        padding = PG_ARENA_ALIGNMENT - padding;
+
+    bytes = (size_t)count*size;
+
+    if((arena->used > arena->size) || (padding + bytes > arena->size - arena->used))
+        return NULL;
+
+    span = arena->storage + arena->used + padding;
+    arena->used += padding + bytes;
+
+    return span;
+
+}// allocateArenaSpan
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolSpanArena::generateSource
@@ -0,0 +1,35 @@
+#ifndef PROTOCOLSPANARENA_H
+#define PROTOCOLSPANARENA_H
+
+/*!
+ * \file
+ * Auto magically generate the arena that gives storage to decoded spans
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+
+class ProtocolSpanArena
+{
+public:
+    ProtocolSpanArena(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLSPANARENA_H
@@ -2,6 +2,7 @@
 #include "protocolstructuremodule.h"
 #include "protocolparser.h"
 #include "protocolfield.h"
+#include "precompiledlibrary.h"
 #include <string>
 #include <iostream>
 
@@ -11,7 +12,7 @@
  * \param parent is the hierarchical name of the object that owns this object.
  * \param support are the protocol support details
  */
-ProtocolStructure::ProtocolStructure(ProtocolParser* parse, std::string parent, ProtocolSupport supported) :
+ProtocolStructure::ProtocolStructure(ProtocolParser* parse, std::string parent, const ProtocolSupport& supported) :
     Encodable(parse, parent, supported),
     numbitfieldgroupbytes(0),
     bitfields(false),
@@ -37,10 +38,13 @@ ProtocolStructure::ProtocolStructure(ProtocolParser* parse, std::string parent,
     compare(false),
     print(false),
     mapEncode(false),
-    redefines(nullptr)
+    tableDriven(false),
+    redefines(nullptr),
+    sharedLayout(nullptr)
 {
     // List of attributes understood by ProtocolStructure
-    attriblist = {"name",  "title",  "array",  "variableArray",  "array2d",  "variable2dArray",  "dependsOn",  "comment",  "hidden",  "neverOmit", "limitOnEncode"};
+    static const AttributeNames names({"name",  "title",  "array",  "variableArray",  "array2d",  "variable2dArray",  "dependsOn",  "comment",  "hidden",  "neverOmit", "limitOnEncode", "span"});
+    attriblist = &names;
 
 }
 
@@ -90,8 +94,10 @@ void ProtocolStructure::clear(void)
     hasverify = false;
     encode = decode = true;
     print = compare = mapEncode = false;
+    tableDriven = false;
     structName.clear();
     redefines = nullptr;
+    sharedLayout = nullptr;
 
 }// ProtocolStructure::clear
 
@@ -104,7 +110,7 @@ void ProtocolStructure::parse(void)
     if(e == nullptr)
         return;
 
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
     // All the attribute we care about
     name = ProtocolParser::getAttribute("name", map, "_unknown");
@@ -140,10 +146,15 @@ void ProtocolStructure::parse(void)
     else if(ProtocolParser::isFieldClear("limitOnEncode", map))
         support.limitonencode = false;
 
+    if(ProtocolParser::isFieldSet("span", map))
+        support.span = true;
+    else if(ProtocolParser::isFieldClear("span", map))
+        support.span = false;
+
     testAndWarnAttributes(map);
 
     // for now the typename is derived from the name
-    structName = typeName = support.prefix + name + support.typeSuffix;
+    structName = typeName = support.prefix() + name + support.typeSuffix();
 
     // We can't have a variable array length without an array
     if(array.empty() && !variableArray.empty())
@@ -178,6 +189,9 @@ void ProtocolStructure::parse(void)
     // Check to make sure we did not step on any keywords
     checkAgainstKeywords();
 
+    // Variable length arrays of structures can be spans of arena storage
+    span = support.span && isArray() && !is2dArray() && !variableArray.empty();
+
     // Get any enumerations
     parseEnumerations(e);
 
@@ -198,6 +212,162 @@ void ProtocolStructure::parse(void)
 }// ProtocolStructure::parse
 
 
+/*!
+ * Save the parsed structure to a precompiled library, including its
+ * enumerations and all of its children
+ * \param writer receives the data
+ */
+void ProtocolStructure::save(CacheWriter& writer) const
+{
+    Encodable::save(writer);
+
+    writer.write((int64_t)enumList.size());
+    for(const EnumCreator* Enum : enumList)
+    {
+        writer.write((int64_t)Enum->getElementIndex());
+        Enum->save(writer);
+    }
+
+    writer.write((int64_t)numbitfieldgroupbytes);
+    writer.write(bitfields);
+    writer.write(usestempencodebitfields);
+    writer.write(usestempencodelongbitfields);
+    writer.write(usestempdecodebitfields);
+    writer.write(usestempdecodelongbitfields);
+    writer.write(needsEncodeIterator);
+    writer.write(needsDecodeIterator);
+    writer.write(needsInitIterator);
+    writer.write(needsVerifyIterator);
+    writer.write(needs2ndEncodeIterator);
+    writer.write(needs2ndDecodeIterator);
+    writer.write(needs2ndInitIterator);
+    writer.write(needs2ndVerifyIterator);
+    writer.write(defaults);
+    writer.write(hidden);
+    writer.write(neverOmit);
+    writer.write(hasinit);
+    writer.write(hasverify);
+    writer.write(structName);
+    writer.write(encode);
+    writer.write(decode);
+    writer.write(compare);
+    writer.write(print);
+    writer.write(mapEncode);
+    writer.write(tableDriven);
+
+    writer.write((int64_t)encodables.size());
+    for(const Encodable* encodable : encodables)
+    {
+        writer.write((int64_t)encodable->getElementIndex());
+
+        // The field before this one, as an index into our list
+        int64_t previous = -1;
+        const ProtocolField* field = dynamic_cast<const ProtocolField*>(encodable);
+        if((field != nullptr) && (field->getPreviousField() != nullptr))
+        {
+            for(std::size_t i = 0; i < encodables.size(); i++)
+            {
+                if(encodables.at(i) == field->getPreviousField())
+                    previous = (int64_t)i;
+            }
+        }
+
+        writer.write(previous);
+        encodable->save(writer);
+    }
+
+}// ProtocolStructure::save
+
+
+/*!
+ * Load the parsed structure from a precompiled library, in place of parse().
+ * The enumerations of the structure are given to the parser, as parse() does.
+ * \param reader supplies the data written by save()
+ * \return true if the structure was loaded
+ */
+bool ProtocolStructure::load(CacheReader& reader)
+{
+    clear();
+
+    // This restores the support options our children are created with
+    Encodable::load(reader);
+
+    std::vector<const XMLElement*> children = childElements(e);
+
+    for(int64_t count = reader.readInt(); (count > 0) && reader.isGood(); count--)
+    {
+        const XMLElement* element = readElement(reader, children);
+
+        if(!reader.isGood())
+            break;
+
+        const EnumCreator* Enum = parser->loadEnumeration(getHierarchicalName(), element, reader);
+        if(Enum == nullptr)
+            reader.fail();
+        else
+            enumList.push_back(Enum);
+    }
+
+    numbitfieldgroupbytes = (int)reader.readInt();
+    bitfields = reader.readBool();
+    usestempencodebitfields = reader.readBool();
+    usestempencodelongbitfields = reader.readBool();
+    usestempdecodebitfields = reader.readBool();
+    usestempdecodelongbitfields = reader.readBool();
+    needsEncodeIterator = reader.readBool();
+    needsDecodeIterator = reader.readBool();
+    needsInitIterator = reader.readBool();
+    needsVerifyIterator = reader.readBool();
+    needs2ndEncodeIterator = reader.readBool();
+    needs2ndDecodeIterator = reader.readBool();
+    needs2ndInitIterator = reader.readBool();
+    needs2ndVerifyIterator = reader.readBool();
+    defaults = reader.readBool();
+    hidden = reader.readBool();
+    neverOmit = reader.readBool();
+    hasinit = reader.readBool();
+    hasverify = reader.readBool();
+    structName = reader.readString();
+    encode = reader.readBool();
+    decode = reader.readBool();
+    compare = reader.readBool();
+    print = reader.readBool();
+    mapEncode = reader.readBool();
+    tableDriven = reader.readBool();
+
+    for(int64_t count = reader.readInt(); (count > 0) && reader.isGood(); count--)
+    {
+        const XMLElement* element = readElement(reader, children);
+        int64_t previous = reader.readInt();
+
+        Encodable* encodable = createEncodable(parser, getHierarchicalName(), support, element);
+        if(encodable == nullptr)
+        {
+            reader.fail();
+            break;
+        }
+
+        encodable->setElement(element);
+        encodable->load(reader);
+
+        // The previous field is always earlier in the list
+        ProtocolField* field = dynamic_cast<ProtocolField*>(encodable);
+        if((field != nullptr) && (previous >= 0))
+        {
+            if(previous < (int64_t)encodables.size())
+                field->setPreviousField(dynamic_cast<ProtocolField*>(encodables.at((std::size_t)previous)));
+            else
+                reader.fail();
+        }
+
+        encodables.push_back(encodable);
+    }
+
+    return reader.isGood();
+
+}// ProtocolStructure::load
+
+
 /*!
  * Return the string used to declare this encodable as part of a structure.
  * This includes the spacing, typename, name, semicolon, comment, and linefeed
@@ -207,7 +377,9 @@ std::string ProtocolStructure::getDeclaration(void) const
 {
     std::string output = TAB_IN + "" + typeName + " " + name;
 
-    if(array.empty())
+    if(span)
+        output = TAB_IN + "" + typeName + "* " + name + ";";
+    else if(array.empty())
         output += ";";
     else if(array2d.empty())
         output += "[" + array + "];";
@@ -217,6 +389,14 @@ std::string ProtocolStructure::getDeclaration(void) const
     if(!comment.empty())
         output += " //!< " + comment;
 
+    if(span)
+    {
+        if(comment.empty())
+            output += " //!< Span of up to " + array + " elements.";
+        else
+            output += ". Span of up to " + array + " elements.";
+    }
+
     output += "\n";
 
     return output;
@@ -317,6 +497,9 @@ std::string ProtocolStructure::getDecodeString(bool isBigEndian, int* bitcount,
         spacing += TAB_IN;
     }
 
+    if(isStructureMember)
+        output += getSpanAllocationCode(spacing);
+
     // Array handling
     output += getDecodeArrayIterationCode(spacing, isStructureMember);
 
@@ -330,16 +513,26 @@ std::string ProtocolStructure::getDecodeString(bool isBigEndian, int* bitcount,
 
     if(support.language == ProtocolSupport::c_language)
     {
-        output += spacing + "if(decode" + typeName + "(_pg_data, &_pg_byteindex, " + access + ") == 0)\n";
+        // Our spans draw their storage from the arena
+        if(hasSpans())
+            output += spacing + "if(decode" + typeName + "(_pg_data, &_pg_byteindex, " + access + ", _pg_arena) == 0)\n";
+        else
+            output += spacing + "if(decode" + typeName + "(_pg_data, &_pg_byteindex, " + access + ") == 0)\n";
         output += spacing + TAB_IN + "return 0;\n";
     }
     else
-    {       
+    {
+        std::string arena;
+
+        // Our spans draw their storage from the arena
+        if(hasSpans())
+            arena = ", _pg_arena";
+
         // Note that if we are an array the dereferencing is done by the array operator
         if(isStructureMember || isArray())
-            output += spacing + "if(" + access + ".decode(_pg_data, &_pg_byteindex) == false)\n";
+            output += spacing + "if(" + access + ".decode(_pg_data, &_pg_byteindex" + arena + ") == false)\n";
         else
-            output += spacing + "if(" + access + "->decode(_pg_data, &_pg_byteindex) == false)\n";
+            output += spacing + "if(" + access + "->decode(_pg_data, &_pg_byteindex" + arena + ") == false)\n";
 
         output += spacing + TAB_IN + "return false;\n";
     }
@@ -368,8 +561,14 @@ std::string ProtocolStructure::getVerifyString(void) const
     if(!comment.empty())
         output += spacing + "// " + comment + "\n";
 
+    // A span only has storage for the variable array length
+    if(span)
+    {
+        output += getEncodeArrayIterationCode(spacing, true);
+        spacing += TAB_IN;
+    }
     // Do not call getDecodeArrayIterationCode() because we explicity don't handle variable length arrays here
-    if(isArray())
+    else if(isArray())
     {
         output += spacing + "for(_pg_i = 0; _pg_i < " + array + "; _pg_i++)\n";
         spacing += TAB_IN;
@@ -406,7 +605,17 @@ std::string ProtocolStructure::getSetInitialValueString(bool isStructureMember)
     std::string output;
     std::string spacing = TAB_IN;
 
-    // We only need this function if we are C language, C++ classes initialize themselves
+    // A span has no storage to initialize until it is decoded, in C++ it starts out empty
+    if(span)
+    {
+        if(support.language != ProtocolSupport::c_language)
+            output += TAB_IN + name + "(NULL),\n";
+
+        return output;
+    }
+
+    // We only need this function if we are C language, C++ classes initialize
+    // themselves.
     if((!hasinit) || (support.language != ProtocolSupport::c_language))
         return output;
 
@@ -488,7 +697,27 @@ std::string ProtocolStructure::getComparisonString(void) const
         access2 = "&_pg_user->" + name;
     }
 
-    if(isArray())
+    // A span only has storage for the variable array length, so only compare
+    // spans of the same length, and only to that length
+    if(span)
+    {
+        if(support.language == ProtocolSupport::c_language)
+        {
+            output += spacing + "if(_pg_user1->" + variableArray + " == _pg_user2->" + variableArray + ")\n";
+            output += spacing + TAB_IN + "for(_pg_i = 0; (_pg_i < " + array + ") && (_pg_i < (unsigned)_pg_user1->" + variableArray + "); _pg_i++)\n";
+        }
+        else
+        {
+            output += spacing + "if(" + variableArray + " == _pg_user->" + variableArray + ")\n";
+            output += spacing + TAB_IN + "for(_pg_i = 0; (_pg_i < " + array + ") && (_pg_i < (unsigned)" + variableArray + "); _pg_i++)\n";
+        }
+
+        spacing += TAB_IN + TAB_IN;
+
+        access1 += "[_pg_i]";
+        access2 += "[_pg_i]";
+    }
+    else if(isArray())
     {
         output += spacing + "for(_pg_i = 0; _pg_i < " + array + "; _pg_i++)\n";
         spacing += TAB_IN;
@@ -708,6 +937,28 @@ std::string ProtocolStructure::getMapDecodeString(void) const
 }// ProtocolStructure::getMapDecodeString
 
 
+/*!
+ * Return the string used to append this structure to the columns of a table
+ * \return the append string, which may be empty
+ */
+std::string ProtocolStructure::getColumnAppendString(void) const
+{
+    std::string output;
+
+    // No columns if nothing is in memory
+    if(getNumberOfDecodeParameters() == 0)
+        return output;
+
+    if(!comment.empty())
+        output += TAB_IN + "// " + comment + "\n";
+
+    output += getColumnStructureCode(structName);
+
+    return output;
+
+}// ProtocolStructure::getColumnAppendString
+
+
 /*!
  * Parse all enumerations which are direct children of a DomNode
  * \param node is parent node
@@ -1310,6 +1561,13 @@ std::string ProtocolStructure::getStructureDeclaration_C(bool alwaysCreate) cons
             output += " */\n";
         }
 
+        // A structure with the same layout is the same type, so its functions take this structure
+        if(sharedLayout != nullptr)
+        {
+            output += "typedef " + sharedLayout->structName + " " + typeName + ";\n";
+            return output;
+        }
+
         // The opening to the structure
         output += "typedef struct\n";
         output += "{\n";
@@ -1638,6 +1896,24 @@ std::string ProtocolStructure::getEncodeFunctionBody(bool isBigEndian, bool incl
     output += getEncodeFunctionSignature(true) + "\n";
     output += "{\n";
 
+    // Table driven structures are encoded by the interpreter from their descriptor
+    if(tableDriven)
+    {
+        output += TAB_IN + "encodeFromDescriptor(&descriptor" + typeName + ", _pg_data, _pg_bytecount, _pg_user);\n";
+        output += "\n";
+        output += "}// encode" + typeName + "\n";
+        return output;
+    }
+
+    // A structure with the same layout already has this function
+    if(sharedLayout != nullptr)
+    {
+        output += TAB_IN + "encode" + sharedLayout->typeName + "(_pg_data, _pg_bytecount, _pg_user);\n";
+        output += "\n";
+        output += "}// encode" + typeName + "\n";
+        return output;
+    }
+
     output += TAB_IN + "int _pg_byteindex = *_pg_bytecount;\n";
 
     if(usestempencodebitfields)
@@ -1697,7 +1973,13 @@ std::string ProtocolStructure::getDecodeFunctionSignature(bool insource) const
 
         if(getNumberOfDecodeParameters() > 0)
         {
-            output = "int decode" + typeName + "(const uint8_t* " + pg + "data, int* " + pg + "bytecount, " + structName + "* " + pg + "user)";
+            output = "int decode" + typeName + "(const uint8_t* " + pg + "data, int* " + pg + "bytecount, " + structName + "* " + pg + "user";
+
+            // The storage for spans comes from an arena
+            if(hasSpans())
+                output += ", pgarena_t* " + pg + "arena";
+
+            output += ")";
         }
         else
         {
@@ -1709,9 +1991,20 @@ std::string ProtocolStructure::getDecodeFunctionSignature(bool insource) const
         // For C++ these functions are within the class namespace and they
         // reference their own members.
         if(insource)
-            output = "bool " + typeName + "::decode(const uint8_t* _pg_data, int* _pg_bytecount)";
+            output = "bool " + typeName + "::decode(const uint8_t* _pg_data, int* _pg_bytecount";
         else
-            output = "bool decode(const uint8_t* data, int* bytecount)";
+            output = "bool decode(const uint8_t* data, int* bytecount";
+
+        // The storage for spans comes from an arena
+        if(hasSpans())
+        {
+            if(insource)
+                output += ", pgarena_t& _pg_arena";
+            else
+                output += ", pgarena_t& arena";
+        }
+
+        output += ")";
     }
 
     return output;
@@ -1789,13 +2082,40 @@ std::string ProtocolStructure::getDecodeFunctionBody(bool isBigEndian, bool incl
     output += " * \\param _pg_data points to the byte array to decoded data from\n";
     output += " * \\param _pg_bytecount points to the starting location in the byte array, and will be incremented by the number of bytes decoded\n";
     if((support.language == ProtocolSupport::c_language) && (getNumberOfDecodeParameters() > 0))
+    {
         output += " * \\param _pg_user is the data to decode from the byte array\n";
+        if(hasSpans())
+            output += " * \\param _pg_arena provides the storage for the spans of _pg_user\n";
+    }
+    else if((support.language != ProtocolSupport::c_language) && hasSpans())
+        output += " * \\param _pg_arena provides the storage for the spans of this " + typeName + "\n";
 
     output += " * \\return " + getReturnCode(true) + " if the data are decoded, else " + getReturnCode(false) + ".\n";
     output += " */\n";
     output += getDecodeFunctionSignature(true) + "\n";
     output += "{\n";
 
+    // Table driven structures are decoded by the interpreter from their descriptor
+    if(tableDriven)
+    {
+        output += TAB_IN + "return decodeFromDescriptor(&descriptor" + typeName + ", _pg_data, _pg_bytecount, -1, _pg_user);\n";
+        output += "\n";
+        output += "}// decode" + typeName + "\n";
+        return output;
+    }
+
+    // A structure with the same layout already has this function
+    if(sharedLayout != nullptr)
+    {
+        if(hasSpans())
+            output += TAB_IN + "return decode" + sharedLayout->typeName + "(_pg_data, _pg_bytecount, _pg_user, _pg_arena);\n";
+        else
+            output += TAB_IN + "return decode" + sharedLayout->typeName + "(_pg_data, _pg_bytecount, _pg_user);\n";
+        output += "\n";
+        output += "}// decode" + typeName + "\n";
+        return output;
+    }
+
     output += TAB_IN + "int _pg_byteindex = *_pg_bytecount;\n";
 
     if(usestempdecodebitfields)
@@ -1989,8 +2309,8 @@ std::string ProtocolStructure::getSetToInitialValueFunctionBody(bool includeChil
 
         for(std::size_t i = 0; i < encodables.size(); i++)
         {
-            // Structures (classes really) take care of themselves
-            if(!encodables.at(i)->isPrimitive() || encodables.at(i)->isNotInMemory())
+            // Structures (classes really) take care of themselves, unless they are spans
+            if((!encodables.at(i)->isPrimitive() && !encodables.at(i)->isSpan()) || encodables.at(i)->isNotInMemory())
                 continue;
 
             initializerlist += encodables.at(i)->getSetInitialValueString(true);
@@ -2838,6 +3158,134 @@ std::string ProtocolStructure::getMapDecodeFunctionBody(bool includeChildren) co
 }// ProtocolStructure::getMapDecodeFunctionString
 
 
+/*!
+ * Get the signature of the function that appends this structure to the
+ * columns of a table. The function is free, and overloaded on the structure
+ * type, in both languages since the column output is always C++.
+ * \param insource should be true to indicate this signature is in source code.
+ * \return the signature of the column append function.
+ */
+std::string ProtocolStructure::getColumnAppendFunctionSignature(bool insource) const
+{
+    if(insource)
+        return "void appendColumns(PgColumnTable& _pg_table, const std::string& _pg_prename, const " + structName + "* _pg_user)";
+    else
+        return "void appendColumns(PgColumnTable& table, const std::string& prename, const " + structName + "* user)";
+
+}// ProtocolStructure::getColumnAppendFunctionSignature
+
+
+/*!
+ * Return the string that gives the prototype of the function used to append
+ * this structure to the columns of a table
+ * \param includeChildren should be true to include the function prototypes
+ *        of the child structures
+ * \return the function prototype string, which may be empty
+ */
+std::string ProtocolStructure::getColumnAppendFunctionPrototype(bool includeChildren) const
+{
+    std::string output;
+
+    // A redefining packet uses the function of the structure it redefines
+    if((getNumberOfDecodeParameters() == 0) || (structName != typeName))
+        return output;
+
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size();  i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            ProtocolFile::makeLineSeparator(output);
+
+            output += structure->getColumnAppendFunctionPrototype(includeChildren);
+        }
+
+        ProtocolFile::makeLineSeparator(output);
+    }
+
+    output += "//! Append the contents of a " + typeName + " to the columns of a table\n";
+    output += getColumnAppendFunctionSignature(false) + ";\n";
+
+    return output;
+
+}// ProtocolStructure::getColumnAppendFunctionPrototype
+
+
+/*!
+ * Return the string that gives the function used to append this structure to
+ * the columns of a table
+ * \param includeChildren should be true to include the functions of the child structures
+ * \return the function string, which may be empty
+ */
+std::string ProtocolStructure::getColumnAppendFunctionBody(bool includeChildren) const
+{
+    std::string output;
+    std::string fields;
+
+    if((getNumberOfDecodeParameters() == 0) || (structName != typeName))
+        return output;
+
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if (!structure)
+                continue;
+
+            ProtocolFile::makeLineSeparator(output);
+            output += structure->getColumnAppendFunctionBody(includeChildren);
+        }
+
+        ProtocolFile::makeLineSeparator(output);
+    }
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        std::string code = encodables[i]->getColumnAppendString();
+
+        if(code.empty())
+            continue;
+
+        if(!fields.empty())
+            fields += "\n";
+
+        fields += code;
+    }
+
+    output += "/*!\n";
+    output += " * Append the contents of a " + typeName + " to the columns of a table\n";
+    output += " * \\param _pg_table is the table to append to\n";
+    output += " * \\param _pg_prename is prepended to the names of the columns\n";
+    output += " * \\param _pg_user is the structure to append\n";
+    output += " */\n";
+    output += getColumnAppendFunctionSignature(true) + "\n";
+    output += "{\n";
+
+    // Every element of an array is appended, so the iterators depend only on the field code
+    if(contains(fields, "_pg_i"))
+        output += TAB_IN + "unsigned _pg_i = 0;\n";
+
+    if(contains(fields, "_pg_j"))
+        output += TAB_IN + "unsigned _pg_j = 0;\n";
+
+    if(contains(fields, "_pg_i"))
+        output += "\n";
+
+    output += fields;
+    output += "\n";
+    output += "}// appendColumns\n";
+
+    return output;
+
+}// ProtocolStructure::getColumnAppendFunctionBody
+
+
 /*!
  * Get details needed to produce documentation for this encodable.
  * \param parentName is the name of the parent which will be pre-pended to the name of this encodable
@@ -2943,3 +3391,556 @@ void ProtocolStructure::getSubDocumentationDetails(std::vector<int>& outline, st
 
 }// ProtocolStructure::getSubDocumentationDetails
 
+
+
+/*!
+ * Return the reason this structure has no fixed layout for a NumPy dtype
+ * \return the reason, or an empty string if the structure, and all of its
+ *         children, can be described by a dtype
+ */
+std::string ProtocolStructure::getNumpyIncompatibility(void) const
+{
+    std::vector<int> dimensions;
+
+    if(!getNumpyArrayDimensions(dimensions))
+        return "structure " + name + " does not have a fixed array length";
+
+    if(!dependsOn.empty())
+        return "structure " + name + " depends on another field";
+
+    if(getNumberOfEncodes() == 0)
+        return "structure " + name + " has no encoded fields";
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        std::string reason = encodables.at(i)->getNumpyIncompatibility();
+
+        if(!reason.empty())
+            return reason;
+    }
+
+    return std::string();
+
+}// ProtocolStructure::getNumpyIncompatibility
+
+
+/*!
+ * Return the entry of a NumPy dtype that describes this structure as a member
+ * of another structure
+ * \return the dtype entry
+ */
+std::string ProtocolStructure::getNumpyDtypeString(void) const
+{
+    std::vector<int> dimensions;
+    getNumpyArrayDimensions(dimensions);
+
+    std::string output = TAB_IN + "('" + name + "', " + getNumpyName() + "_dtype";
+
+    if(!dimensions.empty())
+        output += ", " + getNumpyShapeString(dimensions);
+
+    return output + "),\n";
+
+}// ProtocolStructure::getNumpyDtypeString
+
+
+/*!
+ * Return the Python code that decodes this structure from NumPy records into
+ * a dictionary of columns
+ * \return the Python code
+ */
+std::string ProtocolStructure::getNumpyDecodeString(void) const
+{
+    return TAB_IN + "columns['" + name + "'] = decode" + getNumpyName() + "(raw['" + name + "'])\n";
+}
+
+
+/*!
+ * Return the Python code that verifies this structure in decoded NumPy columns
+ * \return the Python code, which is empty if this structure has nothing to verify
+ */
+std::string ProtocolStructure::getNumpyVerifyString(void) const
+{
+    if(!hasverify)
+        return std::string();
+
+    return TAB_IN + "verify" + getNumpyName() + "(columns['" + name + "'], good)\n";
+}
+
+
+/*!
+ * Return the name used for this structure in the NumPy output. This is the
+ * type name without its suffix, except for a structure that redefines
+ * another, which shares the type name but not the encoding, and so uses its
+ * own name.
+ * \return the Python name of this structure
+ */
+std::string ProtocolStructure::getNumpyName(void) const
+{
+    if(redefines != nullptr)
+        return name;
+    else
+        return getNumpyStructureName(typeName);
+}
+
+
+/*!
+ * Return the Python definitions of the NumPy dtype that describes the encoding
+ * of this structure, and the functions that decode, verify, and read many
+ * encoded structures at once.
+ * \param includeChildren should be true to output the children's definitions first
+ * \return the Python definitions
+ */
+std::string ProtocolStructure::getNumpyDefinition(bool includeChildren) const
+{
+    std::string output;
+    std::string pyname = getNumpyName();
+
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            output += structure->getNumpyDefinition(includeChildren);
+        }
+    }
+
+    output += "\n\n";
+
+    if(!title.empty())
+        output += "# " + title + "\n";
+    else
+        output += "# " + typeName + "\n";
+
+    output += pyname + "_dtype = np.dtype([\n";
+    for(std::size_t i = 0; i < encodables.size(); i++)
+        output += encodables.at(i)->getNumpyDtypeString();
+    output += "])\n";
+
+    output += "\n\n";
+    output += "def decode" + pyname + "(raw):\n";
+    output += TAB_IN + "\"\"\"Decode records of " + pyname + "_dtype into a dictionary of columns\"\"\"\n";
+    output += TAB_IN + "columns = {}\n";
+    for(std::size_t i = 0; i < encodables.size(); i++)
+        output += encodables.at(i)->getNumpyDecodeString();
+    output += TAB_IN + "return columns\n";
+
+    output += "\n\n";
+    output += "def verify" + pyname + "(columns, good=None):\n";
+    output += TAB_IN + "\"\"\"Limit decoded columns of " + pyname + " to their allowed range, returning which records were good\"\"\"\n";
+    output += TAB_IN + "if good is None:\n";
+    output += TAB_IN + TAB_IN + "good = np.ones(_length(columns), dtype=np.bool_)\n";
+    for(std::size_t i = 0; i < encodables.size(); i++)
+        output += encodables.at(i)->getNumpyVerifyString();
+    output += TAB_IN + "return good\n";
+
+    output += "\n\n";
+    output += "def read" + pyname + "(data, offset=0, stride=None, count=-1):\n";
+    output += TAB_IN + "\"\"\"Decode encoded " + pyname + " structures which are stride bytes apart in data\"\"\"\n";
+    output += TAB_IN + "return decode" + pyname + "(_records(data, " + pyname + "_dtype, offset, stride, count))\n";
+
+    return output;
+
+}// ProtocolStructure::getNumpyDefinition
+
+
+//! Set the table driven flag for this structure and all children structure
+void ProtocolStructure::setTableDriven(bool enable)
+{
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        // Is this encodable a structure?
+        ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+        if(structure == nullptr)
+            continue;
+
+        structure->setTableDriven(enable);
+
+    }// for all children
+
+    tableDriven = enable;
+}
+
+
+/*!
+ * Get the list of encodables of this structure which have an entry in its
+ * table codec descriptor, which are the ones that are encoded.
+ * \param entries receives the encodables, in the order they are encoded
+ */
+void ProtocolStructure::getDescriptorEntries(std::vector<const Encodable*>& entries) const
+{
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(!encodables.at(i)->isNotEncoded())
+            entries.push_back(encodables.at(i));
+    }
+}
+
+
+/*!
+ * Find the descriptor entry of a field used as an array length or dependsOn
+ * variable. The field must be a single number in memory.
+ * \param entries is the list of descriptor entries
+ * \param variable is the name of the field
+ * \return the index of the entry, or -1 if there is no suitable entry
+ */
+int ProtocolStructure::getDescriptorReferenceIndex(const std::vector<const Encodable*>& entries, const std::string& variable)
+{
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        const Encodable* entry = entries.at(i);
+
+        if(entry->name != variable)
+            continue;
+
+        if(entry->isPrimitive() && !entry->isString() && !entry->isArray() && !entry->isNotInMemory())
+            return (int)i;
+        else
+            return -1;
+    }
+
+    return -1;
+
+}// ProtocolStructure::getDescriptorReferenceIndex
+
+
+/*!
+ * Return the reason this structure cannot be described by a table codec
+ * descriptor
+ * \return the reason, or an empty string if the structure, and all of its
+ *         children, can be described by descriptors
+ */
+std::string ProtocolStructure::getDescriptorIncompatibility(void) const
+{
+    if(redefines != nullptr)
+        return "structure " + name + " redefines another structure";
+
+    if((getNumberOfEncodeParameters() <= 0) || (getNumberOfDecodeParameters() <= 0))
+        return "structure " + name + " has no in-memory data to encode";
+
+    std::vector<const Encodable*> entries;
+    getDescriptorEntries(entries);
+
+    if(entries.empty() || (entries.size() > 32767))
+        return "structure " + name + " has no encoded fields, or too many";
+
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        const Encodable* entry = entries.at(i);
+        std::string reason = entry->getDescriptorIncompatibility();
+
+        if(!reason.empty())
+            return reason;
+
+        if(!entry->variable2dArray.empty() || (!entry->variableArray.empty() && entry->is2dArray()))
+            return entry->name + " has a variable length two dimensional array";
+
+        if(!entry->dependsOnValue.empty())
+            return entry->name + " uses dependsOnValue";
+
+        if(entry->isSpan())
+            return entry->name + " is a span";
+
+        if(!entry->variableArray.empty() && (getDescriptorReferenceIndex(entries, entry->variableArray) < 0))
+            return "variableArray " + entry->variableArray + " of " + entry->name + " is not an encoded number";
+
+        if(!entry->dependsOn.empty() && (getDescriptorReferenceIndex(entries, entry->dependsOn) < 0))
+            return "dependsOn " + entry->dependsOn + " of " + entry->name + " is not an encoded number";
+    }
+
+    return std::string();
+
+}// ProtocolStructure::getDescriptorIncompatibility
+
+
+/*!
+ * Return the entry of a table codec descriptor that describes this structure
+ * as a member of another structure
+ * \param structure is the name of the in-memory structure that holds this structure
+ * \param length is the index of the descriptor entry that gives the array length, or -1
+ * \param depends is the index of the descriptor entry this structure depends on, or -1
+ * \return the pgfield_t initializer for this structure, without line feed
+ */
+std::string ProtocolStructure::getDescriptorEntryString(const std::string& structure, int length, int depends) const
+{
+    std::string count = "1";
+
+    if(isArray())
+    {
+        count = array;
+
+        if(is2dArray())
+            count = "(" + array + ")*(" + array2d + ")";
+    }
+
+    return "{offsetof(" + structure + ", " + name + "), " + count + ", sizeof(" + typeName + "), PG_MEMORY_STRUCT, PG_ENCODING_STRUCT, 0, 0, " +
+           std::to_string(length) + ", " + std::to_string(depends) + ", &descriptor" + typeName + ", 0, 1, 0, 0}";
+
+}// ProtocolStructure::getDescriptorEntryString
+
+
+/*!
+ * Return the table codec descriptor of this structure, which lists its
+ * encoded fields for encodeFromDescriptor() and decodeFromDescriptor().
+ * \param includeChildren should be true to output the children's descriptors first
+ * \param isStatic should be true if the descriptor is only used in this source file
+ * \return the C definitions of the descriptor
+ */
+std::string ProtocolStructure::getDescriptorDefinition(bool includeChildren, bool isStatic) const
+{
+    std::string output;
+
+    if(includeChildren)
+    {
+        for(std::size_t i = 0; i < encodables.size(); i++)
+        {
+            ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+            if(!structure)
+                continue;
+
+            ProtocolFile::makeLineSeparator(output);
+            output += structure->getDescriptorDefinition(includeChildren, true);
+        }
+        ProtocolFile::makeLineSeparator(output);
+    }
+
+    std::vector<const Encodable*> entries;
+    getDescriptorEntries(entries);
+
+    std::string number = std::to_string(entries.size());
+
+    output += "//! Fields of " + typeName + " for the table codec\n";
+    output += "static const pgfield_t fields" + typeName + "[" + number + "] =\n";
+    output += "{\n";
+
+    for(std::size_t i = 0; i < entries.size(); i++)
+    {
+        const Encodable* entry = entries.at(i);
+        int length = entry->variableArray.empty() ? -1 : getDescriptorReferenceIndex(entries, entry->variableArray);
+        int depends = entry->dependsOn.empty() ? -1 : getDescriptorReferenceIndex(entries, entry->dependsOn);
+
+        output += TAB_IN + entry->getDescriptorEntryString(structName, length, depends);
+
+        if(i + 1 < entries.size())
+            output += ",";
+
+        output += " // " + entry->name + "\n";
+    }
+
+    output += "};\n";
+    output += "\n";
+    output += "//! Table codec descriptor of " + typeName + "\n";
+
+    if(isStatic)
+        output += "static ";
+
+    output += "const pgdescriptor_t descriptor" + typeName + " = {fields" + typeName + ", " + number + "};\n";
+
+    return output;
+
+}// ProtocolStructure::getDescriptorDefinition
+
+
+
+/*!
+ * Return a string which is the same for structures whose encode and decode
+ * functions are interchangeable. Two structures have the same layout if their
+ * in-memory declarations and their encode and decode function bodies are the
+ * same, apart from comments and the name of the structure. The members must
+ * have the same names, because a structure which shares a layout is declared
+ * as the type of the first structure with that layout. This must be called
+ * before shareLayouts() changes the function bodies.
+ * \return the layout signature, which is empty if the functions of this
+ *         structure cannot be shared.
+ */
+std::string ProtocolStructure::getLayoutSignature(void) const
+{
+    // C++ classes cannot be declared as another class
+    if(support.language != ProtocolSupport::c_language)
+        return std::string();
+
+    if((redefines != nullptr) || tableDriven || (getNumberOfEncodeParameters() <= 0) || (getNumberOfDecodeParameters() <= 0))
+        return std::string();
+
+    std::string signature;
+
+    // The in-memory declaration, without the comments
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        std::string declaration = encodables.at(i)->getDeclaration();
+        std::size_t comment = declaration.find("//");
+
+        if(comment < declaration.size())
+            declaration.erase(comment);
+
+        signature += trimm(declaration) + ";";
+    }
+
+    // The function bodies, without the comments
+    std::string bodies = getEncodeFunctionBody(support.bigendian, false) + getDecodeFunctionBody(support.bigendian, false);
+    std::size_t start = 0;
+
+    while(start < bodies.size())
+    {
+        std::size_t end = bodies.find("\n", start);
+
+        if(end >= bodies.size())
+            end = bodies.size();
+
+        std::string line = trimm(bodies.substr(start, end - start));
+
+        bool comment = startsWith(line, "//") || startsWith(line, "/*") || startsWith(line, "* ") || startsWith(line, "*/") || (line == "*");
+
+        if(!line.empty() && !comment)
+            signature += line + "\n";
+
+        start = end + 1;
+    }
+
+    // The name of the structure is the only thing allowed to differ
+    return replace(signature, typeName, "$");
+
+}// ProtocolStructure::getLayoutSignature
+
+
+/*!
+ * Share the encode and decode functions of earlier structures with the same
+ * layout, for this structure and its children. Structures which share are
+ * declared as the type of the earlier structure, and their functions become a
+ * call to the functions of the earlier structure. Structures which do not
+ * share are remembered so later structures can share their functions. This
+ * must be called before the structure is declared, and the caller must output
+ * the encode and decode functions of this structure.
+ * \param include is the header which declares the functions of this structure.
+ * \param structinclude is the header which declares the type of this structure.
+ * \param includeSelf should be false to only share the children functions,
+ *        because this structure does not output byte array functions.
+ * \param list is appended with the headers of the shared functions.
+ * \param structlist is appended with the headers of the shared types.
+ */
+void ProtocolStructure::shareLayouts(const std::string& include, const std::string& structinclude, bool includeSelf, std::vector<std::string>& list, std::vector<std::string>& structlist)
+{
+    // Children first, their functions come first
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        ProtocolStructure* structure = dynamic_cast<ProtocolStructure*>(encodables.at(i));
+
+        if(structure != nullptr)
+            structure->shareLayouts(include, structinclude, true, list, structlist);
+    }
+
+    if(!includeSelf)
+        return;
+
+    std::string signature = getLayoutSignature();
+
+    if(signature.empty())
+        return;
+
+    std::string sharedinclude, sharedstructinclude;
+    const ProtocolStructure* shared = parser->lookUpLayout(signature, &sharedinclude, &sharedstructinclude);
+
+    if((shared != nullptr) && (shared != this))
+    {
+        sharedLayout = shared;
+        list.push_back(sharedinclude);
+        structlist.push_back(sharedstructinclude);
+    }
+    else
+        parser->addLayout(signature, this, include, structinclude);
+
+}// ProtocolStructure::shareLayouts
+
+
+/*!
+ * Determine if decoding this structure draws storage from an arena, because
+ * it has spans or contains structures that do.
+ * \return true if the decode function of this structure needs an arena
+ */
+bool ProtocolStructure::hasSpans(void) const
+{
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->usesArena(true))
+            return true;
+    }
+
+    return false;
+
+}// ProtocolStructure::hasSpans
+
+
+/*!
+ * Determine if decoding this structure as a member of another structure
+ * draws storage from an arena
+ * \param isStructureMember should be true if this structure is decoded into a containing structure
+ * \return true if the decode needs an arena
+ */
+bool ProtocolStructure::usesArena(bool isStructureMember) const
+{
+    return (span && isStructureMember) || hasSpans();
+}
+
+
+/*!
+ * Get the most arena storage that decoding this structure as a member of
+ * another structure can use, as an expression for the C compiler
+ * \return the storage expression, empty if no storage is used
+ */
+std::string ProtocolStructure::getSpanStorageString(void) const
+{
+    return combineSpanStorage(getMaxSpanStorageString());
+}
+
+
+/*!
+ * Get the most arena storage that decoding this structure can use, as an
+ * expression for the C compiler. This is the sum of the storage of each span
+ * in the structure and its children.
+ * \return the storage expression, empty if no storage is used
+ */
+std::string ProtocolStructure::getMaxSpanStorageString(void) const
+{
+    std::string output;
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        std::string storage = encodables.at(i)->getSpanStorageString();
+
+        if(storage.empty())
+            continue;
+
+        if(!output.empty())
+            output += " + ";
+
+        output += storage;
+    }
+
+    return output;
+
+}// ProtocolStructure::getMaxSpanStorageString
+
+
+/*!
+ * Declare this structure and its children as fixed arrays, rather than spans
+ * \return true if this structure or any of its children was a span
+ */
+bool ProtocolStructure::clearSpans(void)
+{
+    bool cleared = Encodable::clearSpans();
+
+    for(std::size_t i = 0; i < encodables.size(); i++)
+    {
+        if(encodables.at(i)->clearSpans())
+            cleared = true;
+    }
+
+    return cleared;
+
+}// ProtocolStructure::clearSpans
@@ -12,7 +12,7 @@ class ProtocolStructure : public Encodable
 public:
 
     //! Default constructor for protocol structure
-    ProtocolStructure(ProtocolParser* parse, std::string Parent, ProtocolSupport supported);
+    ProtocolStructure(ProtocolParser* parse, std::string Parent, const ProtocolSupport& supported);
 
     //! Reset all data to defaults
     void clear(void) override;
@@ -20,6 +20,12 @@ public:
     //! Parse the DOM data for this structure
     void parse(void) override;
 
+    //! Save the parsed structure to a precompiled library
+    void save(CacheWriter& writer) const override;
+
+    //! Load the parsed structure from a precompiled library
+    bool load(CacheReader& reader) override;
+
     //! Return the struct name, which may be different from typeName
     const std::string& getStructName(void) const {return structName;}
 
@@ -59,6 +65,60 @@ public:
     //! Return the string used for map decoding this structure
     std::string getMapDecodeString(void) const override;
 
+    //! Return the string used to append this structure to the columns of a table
+    std::string getColumnAppendString(void) const override;
+
+    //! Return the reason this structure has no fixed layout for a NumPy dtype, empty if it has one
+    std::string getNumpyIncompatibility(void) const override;
+
+    //! Return the entry of a NumPy dtype that describes this structure as a member of another
+    std::string getNumpyDtypeString(void) const override;
+
+    //! Return the Python code that decodes this structure from NumPy records into columns
+    std::string getNumpyDecodeString(void) const override;
+
+    //! Return the Python code that verifies this structure in decoded NumPy columns
+    std::string getNumpyVerifyString(void) const override;
+
+    //! Return the name used for this structure in the NumPy output
+    std::string getNumpyName(void) const;
+
+    //! Return the Python definitions of the NumPy dtype and functions for this structure
+    std::string getNumpyDefinition(bool includeChildren = true) const;
+
+    //! Return the reason this structure cannot be described by a table codec descriptor, empty if it can
+    std::string getDescriptorIncompatibility(void) const override;
+
+    //! Return the entry of a table codec descriptor that describes this structure as a member of another
+    std::string getDescriptorEntryString(const std::string& structure, int length, int depends) const override;
+
+    //! Return the table codec descriptor of this structure
+    std::string getDescriptorDefinition(bool includeChildren = true, bool isStatic = false) const;
+
+    //! Return true if this structure is encoded and decoded by the table codec
+    bool isTableDriven(void) const {return tableDriven;}
+
+    //! Return a string which is the same for structures whose encode and decode functions are interchangeable
+    std::string getLayoutSignature(void) const;
+
+    //! Share the encode and decode functions of earlier structures with the same layout
+    void shareLayouts(const std::string& include, const std::string& structinclude, bool includeSelf, std::vector<std::string>& list, std::vector<std::string>& structlist);
+
+    //! Return true if decoding this structure draws storage for spans from an arena
+    bool hasSpans(void) const;
+
+    //! True if decoding this structure as a member of another draws storage from an arena
+    bool usesArena(bool isStructureMember) const override;
+
+    //! Return the most arena storage that decoding this structure as a member of another can use
+    std::string getSpanStorageString(void) const override;
+
+    //! Return the most arena storage that decoding this structure can use, empty if none
+    std::string getMaxSpanStorageString(void) const;
+
+    //! Declare this structure and its children as fixed arrays, return true if any were spans
+    bool clearSpans(void) override;
+
     //! Parse the DOM data for this structures children
     void parseChildren(const XMLElement* field);
 
@@ -71,6 +131,9 @@ public:
     //! Set the mapEncode flag for this structure and all children structure
     void setMapEncode(bool enable);
 
+    //! Set the table driven flag for this structure and all children structure
+    void setTableDriven(bool enable);
+
     //! Determine if this encodable is a primitive, rather than a structure
     bool isPrimitive(void) const override {return false;}
 
@@ -203,6 +266,16 @@ public:
     virtual std::string getMapDecodeFunctionBody(bool includeChildren = true) const;
 
 
+    //! Return the string that gives the signature of the function used to append this structure to the columns of a table
+    std::string getColumnAppendFunctionSignature(bool insource) const;
+
+    //! Return the string that gives the prototype of the function used to append this structure to the columns of a table
+    virtual std::string getColumnAppendFunctionPrototype(bool includeChildren = true) const;
+
+    //! Return the string that gives the function used to append this structure to the columns of a table
+    virtual std::string getColumnAppendFunctionBody(bool includeChildren = true) const;
+
+
     //! Return the string that gives the signature of the function used to initialize this structure
     virtual std::string getSetToInitialValueFunctionSignature(bool insource) const;
 
@@ -254,6 +327,9 @@ public:
     //! Return true if this structure should be hidden from the documentation
     bool isHidden(void) const override {return hidden;}
 
+    //! Return true if this structure should never be omitted, even if hidden
+    bool isNeverOmit(void) const {return neverOmit;}
+
     //! True if this encodable has verification data
     bool hasVerify(void) const override {return hasverify;}
 
@@ -280,6 +356,12 @@ protected:
     //! Parse all enumerations which are direct children of a DomNode
     void parseEnumerations(const XMLNode* node);
 
+    //! Get the list of encodables which have an entry in the table codec descriptor
+    void getDescriptorEntries(std::vector<const Encodable*>& entries) const;
+
+    //! Find the descriptor entry of a field used as an array length or dependsOn variable
+    static int getDescriptorReferenceIndex(const std::vector<const Encodable*>& entries, const std::string& variable);
+
     //! This list of all children encodables
     std::vector<Encodable*> encodables;
 
@@ -312,7 +394,9 @@ protected:
     bool compare;                       //!< True if the comparison function is output
     bool print;                         //!< True if the textPrint function is output
     bool mapEncode;                     //!< True if the mapEncode function is output
+    bool tableDriven;                   //!< True if encode and decode use the table codec descriptor
     const ProtocolStructureModule* redefines; //!< Pointer to a structure that we are redefining
+    const ProtocolStructure* sharedLayout;    //!< Pointer to a structure with the same layout, whose type and functions we use
 
 };
 
@@ -1,5 +1,6 @@
 #include "protocolstructuremodule.h"
 #include "protocolparser.h"
+#include "precompiledlibrary.h"
 #include <iostream>
 
 /*!
@@ -9,8 +10,8 @@
  * \param protocolApi is the API string of the protocol
  * \param protocolVersion is the version string of the protocol
  */
-ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, ProtocolSupport supported, const std::string& protocolApi, const std::string& protocolVersion) :
-    ProtocolStructure(parse, supported.protoName, supported),
+ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, const ProtocolSupport& supported, const std::string& protocolApi, const std::string& protocolVersion) :
+    ProtocolStructure(parse, supported.protoName(), supported),
     source(supported),
     header(supported),
     _structHeader(supported),
@@ -47,10 +48,8 @@ ProtocolStructureModule::ProtocolStructureModule(ProtocolParser* parse, Protocol
     }
 
     // These are attributes on top of the normal structure that we support
-    std::vector<std::string> newattribs({"encode", "decode", "file", "deffile", "verifyfile", "comparefile", "printfile", "mapfile", "redefine", "compare", "print", "map"});
-
-    // Now append the new attributes onto our old list
-    attriblist.insert(attriblist.end(), newattribs.begin(), newattribs.end());
+    static const AttributeNames names(*attriblist, {"encode", "decode", "file", "deffile", "verifyfile", "comparefile", "printfile", "mapfile", "redefine", "compare", "print", "map", "tableDriven"});
+    attriblist = &names;
 }
 
 
@@ -107,7 +106,7 @@ void ProtocolStructureModule::clear(void)
  * Issue warnings for the structure module. This should be called after the
  * attributes have been parsed.
  */
-void ProtocolStructureModule::issueWarnings(const XMLAttribute* map)
+void ProtocolStructureModule::issueWarnings(const AttributeIndex& map)
 {
     (void)map;
 
@@ -136,9 +135,20 @@ void ProtocolStructureModule::issueWarnings(const XMLAttribute* map)
 
 
 /*!
- * Create the source and header files that represent a packet
+ * Create the source and header files that represent a structure
  */
 void ProtocolStructureModule::parse(void)
+{
+    parseDefinition();
+    output();
+
+}// ProtocolStructureModule::parse
+
+
+/*!
+ * Parse the structure from the DOM, without any output
+ */
+void ProtocolStructureModule::parseDefinition(void)
 {
     // Initialize metadata
     clear();
@@ -149,14 +159,14 @@ void ProtocolStructureModule::parse(void)
     // Me and all my children, which may themselves be structures
     ProtocolStructure::parse();
 
-    const XMLAttribute* map = e->FirstAttribute();
+    const AttributeIndex map(e->FirstAttribute());
 
-    std::string moduleName = ProtocolParser::getAttribute("file", map);
-    std::string defheadermodulename = ProtocolParser::getAttribute("deffile", map);
-    std::string verifymodulename = ProtocolParser::getAttribute("verifyfile", map);
-    std::string comparemodulename = ProtocolParser::getAttribute("comparefile", map);
-    std::string printmodulename = ProtocolParser::getAttribute("printfile", map);
-    std::string mapmodulename = ProtocolParser::getAttribute("mapfile", map);
+    moduleName = ProtocolParser::getAttribute("file", map);
+    defheadermodulename = ProtocolParser::getAttribute("deffile", map);
+    verifymodulename = ProtocolParser::getAttribute("verifyfile", map);
+    comparemodulename = ProtocolParser::getAttribute("comparefile", map);
+    printmodulename = ProtocolParser::getAttribute("printfile", map);
+    mapmodulename = ProtocolParser::getAttribute("mapfile", map);
 
     encode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("encode", map));
     decode = !ProtocolParser::isFieldClear(ProtocolParser::getAttribute("decode", map));
@@ -166,7 +176,7 @@ void ProtocolStructureModule::parse(void)
     {
         support.compare = compare = false;
         comparemodulename.clear();
-        support.globalCompareName.clear();
+        support.edit().globalCompareName.clear();
     }
     else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("compare", map)))
         compare = true;
@@ -176,7 +186,7 @@ void ProtocolStructureModule::parse(void)
     {
         support.print = print = false;
         printmodulename.clear();
-        support.globalPrintName.clear();
+        support.edit().globalPrintName.clear();
     }
     else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map)))
         print = true;
@@ -186,11 +196,14 @@ void ProtocolStructureModule::parse(void)
     {
         support.mapEncode = mapEncode = false;
         mapmodulename.clear();
-        support.globalMapName.clear();
+        support.edit().globalMapName.clear();
     }
     else if(ProtocolParser::isFieldSet(ProtocolParser::getAttribute("map", map)))
         mapEncode = true;
 
+    // Encode and decode with the table codec, setupFiles() checks if the structure allows it
+    tableDriven = ProtocolParser::isFieldSet("tableDriven", map);
+
     std::string redefinename = ProtocolParser::getAttribute("redefine", map);
 
     // Warnings for users
@@ -202,15 +215,99 @@ void ProtocolStructureModule::parse(void)
             emitWarning("Redefine must be different from name");
         else
         {
-            redefines = parser->lookUpStructure(support.prefix + redefinename + support.typeSuffix);
+            redefines = parser->lookUpStructure(support.prefix() + redefinename + support.typeSuffix());
             if(redefines == NULL)
                 emitWarning("Could not find structure to redefine");
         }
 
         if(redefines != NULL)
-            structName = support.prefix + redefinename + support.typeSuffix;
+            structName = support.prefix() + redefinename + support.typeSuffix();
     }
 
+}// ProtocolStructureModule::parseDefinition
+
+
+/*!
+ * Save the parsed structure to a precompiled library
+ * \param writer receives the data
+ */
+void ProtocolStructureModule::save(CacheWriter& writer) const
+{
+    ProtocolStructure::save(writer);
+
+    writer.write(moduleName);
+    writer.write(defheadermodulename);
+    writer.write(verifymodulename);
+    writer.write(comparemodulename);
+    writer.write(printmodulename);
+    writer.write(mapmodulename);
+    writer.write((redefines == nullptr) ? std::string() : (const std::string&)redefines->typeName);
+
+    // The structure can suppress the global compare, print, and map outputs
+    writer.write(support.compare);
+    writer.write(support.print);
+    writer.write(support.mapEncode);
+    writer.write(support.globalCompareName());
+    writer.write(support.globalPrintName());
+    writer.write(support.globalMapName());
+
+}// ProtocolStructureModule::save
+
+
+/*!
+ * Load the parsed structure from a precompiled library, in place of parseDefinition()
+ * \param reader supplies the data written by save()
+ * \return true if the structure was loaded
+ */
+bool ProtocolStructureModule::load(CacheReader& reader)
+{
+    // The children are created before the support changes below, as in parseDefinition()
+    ProtocolStructure::load(reader);
+
+    moduleName = reader.readString();
+    defheadermodulename = reader.readString();
+    verifymodulename = reader.readString();
+    comparemodulename = reader.readString();
+    printmodulename = reader.readString();
+    mapmodulename = reader.readString();
+
+    std::string redefinename = reader.readString();
+    if(!redefinename.empty())
+    {
+        redefines = parser->lookUpStructure(redefinename);
+        if(redefines == nullptr)
+            reader.fail();
+    }
+
+    support.compare = reader.readBool();
+    support.print = reader.readBool();
+    support.mapEncode = reader.readBool();
+
+    std::string globalname = reader.readString();
+    if(globalname != support.globalCompareName())
+        support.edit().globalCompareName = globalname;
+
+    globalname = reader.readString();
+    if(globalname != support.globalPrintName())
+        support.edit().globalPrintName = globalname;
+
+    globalname = reader.readString();
+    if(globalname != support.globalMapName())
+        support.edit().globalMapName = globalname;
+
+    return reader.isGood();
+
+}// ProtocolStructureModule::load
+
+
+/*!
+ * Output a structure which has been parsed
+ */
+void ProtocolStructureModule::output(void)
+{
+    if(e == nullptr)
+        return;
+
     // Don't output if hidden and we are omitting hidden items
     if(isHidden() && !neverOmit && support.omitIfHidden)
     {
@@ -257,37 +354,96 @@ void ProtocolStructureModule::parse(void)
         verifySource->flush();
     }
 
-}// ProtocolStructureModule::parse
+}// ProtocolStructureModule::output
 
 
 /*!
- * Setup the files, which accounts for all the ways the fils can be organized for this structure.
+ * Setup the files of a structure which has been parsed, without any output.
+ * This is used instead of output() when the files from the last generation
+ * are unchanged, so others can still find the files of this structure.
+ */
+void ProtocolStructureModule::outputUnchanged(void)
+{
+    if((e == nullptr) || (isHidden() && !neverOmit && support.omitIfHidden))
+        return;
+
+    setupUnchangedFiles(true);
+
+}// ProtocolStructureModule::outputUnchanged
+
+
+/*!
+ * Setup the file names of a structure whose output is unchanged, and discard
+ * the contents the files would start with, so the files are not written.
+ * \param forceStructureDeclaration should be true to force the declaration of the structure, even if it only has one member
+ */
+void ProtocolStructureModule::setupUnchangedFiles(bool forceStructureDeclaration)
+{
+    setupFileNames(moduleName, defheadermodulename, verifymodulename, comparemodulename, printmodulename, mapmodulename, forceStructureDeclaration);
+
+    source.clear();
+    header.clear();
+    _structHeader.clear();
+    _verifySource.clear();
+    _verifyHeader.clear();
+    _compareSource.clear();
+    _compareHeader.clear();
+    _printSource.clear();
+    _printHeader.clear();
+    _mapSource.clear();
+    _mapHeader.clear();
+
+}// ProtocolStructureModule::setupUnchangedFiles
+
+
+/*!
+ * Get the names of all the files this structure writes, including the path.
+ * Files can be shared, so the same name may be listed more than once.
+ * \param list receives the file names
+ */
+void ProtocolStructureModule::getOutputFiles(std::vector<std::string>& list) const
+{
+    const ProtocolFile* files[] = {&header, &source, structHeader, verifyHeader, verifySource, compareHeader, compareSource, printHeader, printSource, mapHeader, mapSource};
+
+    for(const ProtocolFile* file : files)
+    {
+        if((file != nullptr) && !file->fileName().empty())
+            list.push_back(file->filePath() + file->fileName());
+    }
+
+}// ProtocolStructureModule::getOutputFiles
+
+
+/*!
+ * Setup the file names, which accounts for all the ways the files can be
+ * organized for this structure. Nothing is written to the files.
  * \param moduleName is the module name from the attributes
  * \param defheadermodulename is the structure header file name from the attributes
  * \param verifymodulename is the verify module name from the attributes
  * \param comparemodulename is the comparison module name from the attributes
  * \param printmodulename is the print module name from the attributes
+ * \param mapmodulename is the map module name from the attributes
  * \param forceStructureDeclaration should be true to force the declaration of the structure, even if it only has one member
- * \param outputUtilties should be true to output the helper macros
+ * \return true if the structure must be declared
  */
-void ProtocolStructureModule::setupFiles(std::string moduleName,
-                                         std::string defheadermodulename,
-                                         std::string verifymodulename,
-                                         std::string comparemodulename,
-                                         std::string printmodulename,
-                                         std::string mapmodulename,
-                                         bool forceStructureDeclaration, bool outputUtilities)
+bool ProtocolStructureModule::setupFileNames(std::string moduleName,
+                                             std::string defheadermodulename,
+                                             std::string verifymodulename,
+                                             std::string comparemodulename,
+                                             std::string printmodulename,
+                                             std::string mapmodulename,
+                                             bool forceStructureDeclaration)
 {
     // User can provide compare flag, or the file name, or set the global flag
-    if(!comparemodulename.empty() || !support.globalCompareName.empty() || support.compare)
+    if(!comparemodulename.empty() || !support.globalCompareName().empty() || support.compare)
         compare = true;
 
     // User can provide print flag, or the file name, or set the global flag
-    if(!printmodulename.empty() || !support.globalPrintName.empty() || support.print)
+    if(!printmodulename.empty() || !support.globalPrintName().empty() || support.print)
         print = true;
 
     // User can provide map flag, or the file name, or set the global flag
-    if(!mapmodulename.empty() || !support.globalMapName.empty() || support.mapEncode)
+    if(!mapmodulename.empty() || !support.globalMapName().empty() || support.mapEncode)
         mapEncode = true;
 
     // In order to do compare, print, map, verify or init we must actually have some parameters
@@ -317,27 +473,56 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
     if(compare || print || mapEncode || hasverify || hasinit)
         forceStructureDeclaration = true;
 
+    // Spans need the structure declaration, and arrays that textRead and mapDecode can fill
+    std::string spanreason;
+
+    if(print || mapEncode)
+        spanreason = "print and map functions need fixed arrays";
+    else if((getNumberInMemory() <= 1) && !forceStructureDeclaration)
+        spanreason = "there is no structure declaration";
+
+    if(!spanreason.empty() && clearSpans())
+        emitWarning("span is ignored: " + spanreason);
+
+    // The table codec needs the structure declaration, and descriptors that can describe every field
+    if(tableDriven)
+    {
+        std::string reason;
+
+        if(support.language != ProtocolSupport::c_language)
+            reason = "only the C language is supported";
+        else if((getNumberInMemory() <= 1) && !forceStructureDeclaration)
+            reason = "there is no structure declaration";
+        else
+            reason = getDescriptorIncompatibility();
+
+        if(reason.empty())
+            setTableDriven(true);
+        else
+        {
+            emitWarning("tableDriven is ignored: " + reason);
+            setTableDriven(false);
+        }
+    }
+
     // The file directive tells us if we are creating a separate file, or if we are appending an existing one
     if(moduleName.empty())
-        moduleName = support.globalFileName;
+        moduleName = support.globalFileName();
 
     // The file names
     if(moduleName.empty())
     {
-        header.setModuleNameAndPath(support.prefix, name, support.outputpath);
-        source.setModuleNameAndPath(support.prefix, name, support.outputpath);
+        header.setModuleNameAndPath(support.prefix(), name, support.outputpath());
+        source.setModuleNameAndPath(support.prefix(), name, support.outputpath());
     }
     else
     {
-        header.setModuleNameAndPath(moduleName, support.outputpath);
-        source.setModuleNameAndPath(moduleName, support.outputpath);
+        header.setModuleNameAndPath(moduleName, support.outputpath());
+        source.setModuleNameAndPath(moduleName, support.outputpath());
     }
 
-    if(support.supportbool && (support.language == ProtocolSupport::c_language))
-        header.writeIncludeDirective("stdbool.h", "", true);
-
     if(verifymodulename.empty())
-        verifymodulename = support.globalVerifyName;
+        verifymodulename = support.globalVerifyName();
 
     if(verifymodulename.empty())
     {
@@ -347,8 +532,8 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
     }
     else if(hasInit() || hasVerify())
     {
-        _verifyHeader.setModuleNameAndPath(verifymodulename, support.outputpath);
-        _verifySource.setModuleNameAndPath(verifymodulename, support.outputpath);
+        _verifyHeader.setModuleNameAndPath(verifymodulename, support.outputpath());
+        _verifySource.setModuleNameAndPath(verifymodulename, support.outputpath());
         verifyHeader = &_verifyHeader;
         verifySource = &_verifySource;
     }
@@ -356,10 +541,10 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
     if(compare)
     {
         if(comparemodulename.empty())
-            comparemodulename = support.globalCompareName;
+            comparemodulename = support.globalCompareName();
 
         if(comparemodulename.empty() && (support.language == ProtocolSupport::c_language))
-            comparemodulename = support.prefix + name + "_compare";
+            comparemodulename = support.prefix() + name + "_compare";
 
         if(comparemodulename.empty())
         {
@@ -368,26 +553,21 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
         }
         else
         {
-            _compareHeader.setModuleNameAndPath(comparemodulename, support.outputpath, ProtocolSupport::cpp_language);
-            _compareSource.setModuleNameAndPath(comparemodulename, support.outputpath, ProtocolSupport::cpp_language);
+            _compareHeader.setModuleNameAndPath(comparemodulename, support.outputpath(), ProtocolSupport::cpp_language);
+            _compareSource.setModuleNameAndPath(comparemodulename, support.outputpath(), ProtocolSupport::cpp_language);
             compareHeader = &_compareHeader;
             compareSource = &_compareSource;
         }
-
-        // Make sure to provide the helper functions
-        compareSource->makeLineSeparator();
-        compareSource->writeOnce(getToFormattedStringFunction());
-        compareSource->makeLineSeparator();
     }
 
     if(mapEncode)
     {
         if(mapmodulename.empty())
-            mapmodulename = support.globalMapName;
+            mapmodulename = support.globalMapName();
 
         // In C the map outputs cannot be in the main code files, because they are c++
         if(mapmodulename.empty() && (support.language == ProtocolSupport::c_language))
-            mapmodulename = support.prefix + name + "_map";
+            mapmodulename = support.prefix() + name + "_map";
 
         if(mapmodulename.empty())
         {
@@ -396,8 +576,8 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
         }
         else
         {
-            _mapHeader.setModuleNameAndPath(mapmodulename, support.outputpath, ProtocolSupport::cpp_language);
-            _mapSource.setModuleNameAndPath(mapmodulename, support.outputpath, ProtocolSupport::cpp_language);
+            _mapHeader.setModuleNameAndPath(mapmodulename, support.outputpath(), ProtocolSupport::cpp_language);
+            _mapSource.setModuleNameAndPath(mapmodulename, support.outputpath(), ProtocolSupport::cpp_language);
             mapHeader = &_mapHeader;
             mapSource = &_mapSource;
         }
@@ -406,11 +586,11 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
     if(print)
     {
         if(printmodulename.empty())
-            printmodulename = support.globalPrintName;
+            printmodulename = support.globalPrintName();
 
         // In C the print outputs cannot be in the main code files, because they are c++
         if(printmodulename.empty() && (support.language == ProtocolSupport::c_language))
-            printmodulename = support.prefix + name + "_print";
+            printmodulename = support.prefix() + name + "_print";
 
         if(printmodulename.empty())
         {
@@ -419,23 +599,81 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
         }
         else
         {
-            _printHeader.setModuleNameAndPath(printmodulename, support.outputpath, ProtocolSupport::cpp_language);
-            _printSource.setModuleNameAndPath(printmodulename, support.outputpath, ProtocolSupport::cpp_language);
+            _printHeader.setModuleNameAndPath(printmodulename, support.outputpath(), ProtocolSupport::cpp_language);
+            _printSource.setModuleNameAndPath(printmodulename, support.outputpath(), ProtocolSupport::cpp_language);
             printHeader = &_printHeader;
             printSource = &_printSource;
         }
+    }
+
+    // Handle the idea that the structure might be defined in a different file,
+    // unless we are using someone elses definition
+    if((redefines == NULL) && !defheadermodulename.empty())
+    {
+        _structHeader.setModuleNameAndPath(defheadermodulename, support.outputpath(), support.language);
+        structHeader = &_structHeader;
+    }
+
+    return forceStructureDeclaration;
+
+}// ProtocolStructureModule::setupFileNames
+
 
+/*!
+ * Setup the files, which accounts for all the ways the fils can be organized for this structure.
+ * \param moduleName is the module name from the attributes
+ * \param defheadermodulename is the structure header file name from the attributes
+ * \param verifymodulename is the verify module name from the attributes
+ * \param comparemodulename is the comparison module name from the attributes
+ * \param printmodulename is the print module name from the attributes
+ * \param forceStructureDeclaration should be true to force the declaration of the structure, even if it only has one member
+ * \param outputUtilties should be true to output the helper macros
+ */
+void ProtocolStructureModule::setupFiles(std::string moduleName,
+                                         std::string defheadermodulename,
+                                         std::string verifymodulename,
+                                         std::string comparemodulename,
+                                         std::string printmodulename,
+                                         std::string mapmodulename,
+                                         bool forceStructureDeclaration, bool outputUtilities)
+{
+    // Do the file names first
+    forceStructureDeclaration = setupFileNames(moduleName, defheadermodulename, verifymodulename, comparemodulename, printmodulename, mapmodulename, forceStructureDeclaration);
+
+    // Structures which share a layout are declared as the type of the earlier structure
+    shareModuleLayouts();
+
+    if(support.supportbool && (support.language == ProtocolSupport::c_language))
+        header.writeIncludeDirective("stdbool.h", "", true);
+
+    if(compare)
+    {
+        // Make sure to provide the helper functions
+        compareSource->makeLineSeparator();
+        compareSource->writeOnce(getToFormattedStringFunction());
+        compareSource->makeLineSeparator();
+    }
+
+    if(print)
+    {
         // Make sure to provide the helper functions
         printSource->makeLineSeparator();
         printSource->writeOnce(getToFormattedStringFunction());
         printSource->makeLineSeparator();
         printSource->writeOnce(getExtractTextFunction());
         printSource->makeLineSeparator();
-
     }
 
     // Include the protocol top level module. This module may already be included, but in that case it won't be included twice
-    header.writeIncludeDirective(support.protoName + "Protocol");
+    header.writeIncludeDirective(support.protoName() + "Protocol");
+
+    // The table codec declares the descriptor types
+    if(tableDriven)
+        header.writeIncludeDirective("tablecodec");
+
+    // The arena gives the storage for spans
+    if(hasSpans())
+        header.writeIncludeDirective("spanarena");
 
     // If we are using someone elses definition then we can't have a separate definition file
     if(redefines != NULL)
@@ -444,12 +682,8 @@ void ProtocolStructureModule::setupFiles(std::string moduleName,
         redefines->getIncludeDirectives(list);
         header.writeIncludeDirectives(list);
     }
-    else if(!defheadermodulename.empty())
+    else if(structHeader == &_structHeader)
     {
-        // Handle the idea that the structure might be defined in a different file
-        _structHeader.setModuleNameAndPath(defheadermodulename, support.outputpath, support.language);
-        structHeader = &_structHeader;
-
         if(support.supportbool && (support.language == ProtocolSupport::c_language))
             structHeader->writeIncludeDirective("stdbool.h", "", true);
 
@@ -634,6 +868,14 @@ std::string ProtocolStructureModule::createUtilityFunctions(const std::string& s
             output += "0\n";
         else
             output += "("+encodedLength.maxEncodedLength + ")\n";
+
+        // The macro for the arena storage used by decoding
+        if(hasSpans())
+        {
+            output += "\n";
+            output += spacing + "//! return the most arena storage used to decode the spans of the " + typeName + " structure\n";
+            output += spacing + "#define getMaxSpanStorageOf" + typeName + "() (" + getMaxSpanStorageString() + ")\n";
+        }
     }
     else
     {
@@ -653,6 +895,14 @@ std::string ProtocolStructureModule::createUtilityFunctions(const std::string& s
             output += "0;}\n";
         else
             output += "("+encodedLength.maxEncodedLength + ");}\n";
+
+        // The arena storage used by decoding, which sizes arrays so it is constexpr
+        if(hasSpans())
+        {
+            output += "\n";
+            output += spacing + "//! \\return the most arena storage used to decode the spans of the structure\n";
+            output += spacing + "static constexpr int maxSpanStorage(void) { return (" + getMaxSpanStorageString() + ");}\n";
+        }
     }
 
     return output;
@@ -782,6 +1032,42 @@ void ProtocolStructureModule::createStructureFunctions(void)
 }// ProtocolStructureModule::createStructureFunctions
 
 
+/*!
+ * Share the type and the encode and decode functions of earlier structures
+ * with the same layout, for this structure and its children.
+ */
+void ProtocolStructureModule::shareModuleLayouts(void)
+{
+    shareStructureLayouts(true);
+}
+
+
+/*!
+ * Share the type and the encode and decode functions of earlier structures
+ * with the same layout, for this structure and its children. This must be
+ * called after the file names are setup, and before the structure is
+ * declared. Only C structures are shared, only if the protocol sets
+ * shareLayouts, and only if this module outputs both the encode and decode
+ * functions.
+ * \param includeSelf should be true if this module outputs the byte array
+ *        encode and decode functions of this structure, false to only share
+ *        the functions of the children.
+ */
+void ProtocolStructureModule::shareStructureLayouts(bool includeSelf)
+{
+    if(!support.sharelayouts || !encode || !decode || (support.language != ProtocolSupport::c_language) || (redefines != nullptr))
+        return;
+
+    std::vector<std::string> list, structlist;
+    shareLayouts(header.fileName(), structHeader->fileName(), includeSelf, list, structlist);
+
+    // The declarations of the shared types, and the prototypes of the shared functions
+    structHeader->writeIncludeDirectives(structlist);
+    source.writeIncludeDirectives(list);
+
+}// ProtocolStructureModule::shareStructureLayouts
+
+
 /*!
  * Create the functions that encode/decode sub stuctures.
  * These functions are local to the source module
@@ -792,6 +1078,17 @@ void ProtocolStructureModule::createSubStructureFunctions()
     if(redefines != nullptr)
         return;
 
+    // The descriptors, which the encode and decode functions of this structure and its children use
+    if(tableDriven)
+    {
+        header.makeLineSeparator();
+        header.write("//! Table codec descriptor of " + typeName + "\n");
+        header.write("extern const pgdescriptor_t descriptor" + typeName + ";\n");
+
+        source.makeLineSeparator();
+        source.write(getDescriptorDefinition(true, false));
+    }
+
     // The embedded structures functions
     for(std::size_t i = 0; i < encodables.size(); i++)
     {
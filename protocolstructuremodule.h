@@ -12,11 +12,26 @@ class ProtocolStructureModule : public ProtocolStructure
 public:
 
     //! Construct the structure parsing object, with details about the overall protocol
-    ProtocolStructureModule(ProtocolParser* parse, ProtocolSupport supported, const std::string& protocolApi, const std::string& protocolVersion);
+    ProtocolStructureModule(ProtocolParser* parse, const ProtocolSupport& supported, const std::string& protocolApi, const std::string& protocolVersion);
 
-    //! Parse a packet from the DOM
+    //! Parse a structure from the DOM, and output it
     void parse(void) override;
 
+    //! Parse a structure from the DOM, without any output
+    virtual void parseDefinition(void);
+
+    //! Save the parsed structure to a precompiled library
+    void save(CacheWriter& writer) const override;
+
+    //! Load the parsed structure from a precompiled library, in place of parseDefinition()
+    bool load(CacheReader& reader) override;
+
+    //! Output a structure which has been parsed
+    virtual void output(void);
+
+    //! Setup the files of a structure which has been parsed, because the output from the last generation is unchanged
+    virtual void outputUnchanged(void);
+
     //! Reset our data contents
     void clear(void) override;
 
@@ -41,6 +56,9 @@ public:
     //! Return the include directives needed for this encodable's print functions
     void getPrintIncludeDirectives(std::vector<std::string>& list) const override;
 
+    //! Get the names of all the files this structure writes, including the path
+    void getOutputFiles(std::vector<std::string>& list) const;
+
     //! Get the name of the header file that encompasses this structure definition
     std::string getDefinitionFileName(void) const {return structHeader->fileName();}
 
@@ -109,6 +127,18 @@ public:
 
 protected:
 
+    //! Setup the file names, which accounts for all the ways the files can be organized for this structure.
+    bool setupFileNames(std::string moduleName,
+                        std::string defheadermodulename,
+                        std::string verifymodulename,
+                        std::string comparemodulename,
+                        std::string printmodulename,
+                        std::string mapmodulename,
+                        bool forceStructureDeclaration);
+
+    //! Setup the file names of a structure whose output is unchanged, without writing to the files
+    void setupUnchangedFiles(bool forceStructureDeclaration);
+
     //! Setup the files, which accounts for all the ways the files can be organized for this structure.
     void setupFiles(std::string moduleName,
                     std::string defheadermodulename,
@@ -122,7 +152,7 @@ protected:
     std::string createUtilityFunctions(const std::string& spacing) const override;
 
     //! Issue warnings for the structure module.
-    void issueWarnings(const XMLAttribute* map);
+    void issueWarnings(const AttributeIndex& map);
 
     //! Write data to the source and header files to encode and decode this structure and all its children
     void createStructureFunctions(void);
@@ -130,6 +160,12 @@ protected:
     //! Create the functions that encode/decode sub stuctures.
     void createSubStructureFunctions(void);
 
+    //! Share the type and functions of earlier structures with the same layout, before the structure is declared
+    virtual void shareModuleLayouts(void);
+
+    //! Share the encode and decode functions of earlier structures with the same layout
+    void shareStructureLayouts(bool includeSelf);
+
     //! Write data to the source and header files to encode and decode this structure but not its children
     void createTopLevelStructureFunctions(void);
 
@@ -168,6 +204,13 @@ protected:
     ProtocolSourceFile* mapSource;      //!< Pointer to the source file for map code (*.cpp)
     ProtocolHeaderFile* mapHeader;      //!< Pointer to the header file for map code (*.h)
 
+    std::string moduleName;             //!< The name of the module from the file attribute
+    std::string defheadermodulename;    //!< The name of the module from the deffile attribute
+    std::string verifymodulename;       //!< The name of the module from the verifyfile attribute
+    std::string comparemodulename;      //!< The name of the module from the comparefile attribute
+    std::string printmodulename;        //!< The name of the module from the printfile attribute
+    std::string mapmodulename;          //!< The name of the module from the mapfile attribute
+
     std::string api;                    //!< The protocol API enumeration
     std::string version;                //!< The version string
 };
@@ -1,5 +1,6 @@
 #include "protocolsupport.h"
 #include "protocolparser.h"
+#include "precompiledlibrary.h"
 #include <algorithm>
 
 //! Split a string into multiple sub strings spearated by a separator.
@@ -382,6 +383,14 @@ std::vector<std::string>& removeDuplicates(std::vector<std::string>& list, bool
 }
 
 
+ProtocolContext::ProtocolContext() :
+    packetStructureSuffix("PacketStructure"),
+    packetParameterSuffix("Packet"),
+    typeSuffix("_t")
+{
+}
+
+
 ProtocolSupport::ProtocolSupport() :
     language(c_language),
     maxdatasize(0),
@@ -395,19 +404,36 @@ ProtocolSupport::ProtocolSupport() :
     bigendian(true),
     supportbool(false),
     limitonencode(false),
+    span(false),
+    sharelayouts(false),
     compare(false),
     print(false),
     mapEncode(false),
     showAllItems(false),
     omitIfHidden(false),
-    packetStructureSuffix("PacketStructure"),
-    packetParameterSuffix("Packet"),
-    typeSuffix("_t"),
-    enablelanguageoverride(false)
+    enablelanguageoverride(false),
+    context(std::make_shared<ProtocolContext>())
 {
 }
 
 
+/*!
+ * Return the shared names and options so they can be changed. Copies of this
+ * object share them, so if anything else holds them this object gets its own
+ * copy first, and the change is only seen by this object and the copies made
+ * from it afterwards.
+ * \return the names and options of this object
+ */
+ProtocolContext& ProtocolSupport::edit(void)
+{
+    if(context.use_count() > 1)
+        context = std::make_shared<ProtocolContext>(*context);
+
+    return *context;
+
+}// ProtocolSupport::edit
+
+
 //! Return the list of attributes understood by ProtocolSupport
 std::vector<std::string> ProtocolSupport::getAttriblist(void) const
 {
@@ -439,6 +465,8 @@ std::vector<std::string> ProtocolSupport::getAttriblist(void) const
     attribs.push_back("pointerCPP");
     attribs.push_back("supportBool");
     attribs.push_back("limitOnEncode");
+    attribs.push_back("span");
+    attribs.push_back("shareLayouts");
     attribs.push_back("C");
     attribs.push_back("CPP");
     attribs.push_back("compare");
@@ -449,11 +477,56 @@ std::vector<std::string> ProtocolSupport::getAttriblist(void) const
 }
 
 
+/*!
+ * Save all the options, which is used to tell if precompiled data were made
+ * with the same options. The license text is not saved, it only affects how
+ * files are written, not how the protocol is parsed.
+ * \param writer receives the options
+ */
+void ProtocolSupport::save(CacheWriter& writer) const
+{
+    writer.write((int64_t)language);
+    writer.write((int64_t)maxdatasize);
+    writer.write(int64);
+    writer.write(float64);
+    writer.write(specialFloat);
+    writer.write(bitfield);
+    writer.write(longbitfield);
+    writer.write(bitfieldtest);
+    writer.write(disableunrecognized);
+    writer.write(bigendian);
+    writer.write(supportbool);
+    writer.write(limitonencode);
+    writer.write(span);
+    writer.write(sharelayouts);
+    writer.write(compare);
+    writer.write(print);
+    writer.write(mapEncode);
+    writer.write(showAllItems);
+    writer.write(omitIfHidden);
+    writer.write(enablelanguageoverride);
+    writer.write(context->globalFileName);
+    writer.write(context->globalVerifyName);
+    writer.write(context->globalCompareName);
+    writer.write(context->globalPrintName);
+    writer.write(context->globalMapName);
+    writer.write(context->outputpath);
+    writer.write(context->packetStructureSuffix);
+    writer.write(context->packetParameterSuffix);
+    writer.write(context->protoName);
+    writer.write(context->prefix);
+    writer.write(context->typeSuffix);
+    writer.write(context->pointerType);
+    writer.write(context->sourcefile);
+
+}// ProtocolSupport::save
+
+
 /*!
  * Parse the attributes for this support object from the DOM map
  * \param map is the DOM map
  */
-void ProtocolSupport::parse(const XMLAttribute* map)
+void ProtocolSupport::parse(const AttributeIndex& map)
 {
     if(!enablelanguageoverride)
     {
@@ -510,6 +583,14 @@ void ProtocolSupport::parse(const XMLAttribute* map)
     if(ProtocolParser::isFieldSet("limitOnEncode", map))
         limitonencode = true;
 
+    // Variable length arrays as spans can be turned on
+    if(ProtocolParser::isFieldSet("span", map))
+        span = true;
+
+    // Sharing functions between structures with the same layout can be turned on
+    if(ProtocolParser::isFieldSet("shareLayouts", map))
+        sharelayouts = true;
+
     // Global flags to force output for compare, print, and map functions
     compare = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("compare", map));
     print = ProtocolParser::isFieldSet(ProtocolParser::getAttribute("print", map));
@@ -518,40 +599,42 @@ void ProtocolSupport::parse(const XMLAttribute* map)
     // The global file names
     parseFileNames(map);
 
+    ProtocolContext& names = edit();
+
     // Prefix is not required
-    prefix = ProtocolParser::getAttribute("prefix", map);
+    names.prefix = ProtocolParser::getAttribute("prefix", map);
 
     // And it can be language specific
     if(language == c_language)
-        prefix = ProtocolParser::getAttribute("prefixC", map, prefix);
+        names.prefix = ProtocolParser::getAttribute("prefixC", map, names.prefix);
     else if(language == cpp_language)
-        prefix = ProtocolParser::getAttribute("prefixCPP", map, prefix);
+        names.prefix = ProtocolParser::getAttribute("prefixCPP", map, names.prefix);
 
     // Packet pointer type (default is 'void')
-    pointerType = ProtocolParser::getAttribute("pointer", map, "void*");
+    names.pointerType = ProtocolParser::getAttribute("pointer", map, "void*");
 
     // And it can be language specific
     if(language == c_language)
-        pointerType = ProtocolParser::getAttribute("pointerC", map, pointerType);
+        names.pointerType = ProtocolParser::getAttribute("pointerC", map, names.pointerType);
     else if(language == cpp_language)
-        pointerType = ProtocolParser::getAttribute("pointerCPP", map, pointerType);
+        names.pointerType = ProtocolParser::getAttribute("pointerCPP", map, names.pointerType);
 
     // Must be a pointer type
-    if(pointerType.back() != '*')
-        pointerType += '*';
+    if(names.pointerType.back() != '*')
+        names.pointerType += '*';
 
     // Packet name post fixes
-    packetStructureSuffix = ProtocolParser::getAttribute("packetStructureSuffix", map, packetStructureSuffix);
-    packetParameterSuffix = ProtocolParser::getAttribute("packetParameterSuffix", map, packetParameterSuffix);
+    names.packetStructureSuffix = ProtocolParser::getAttribute("packetStructureSuffix", map, names.packetStructureSuffix);
+    names.packetParameterSuffix = ProtocolParser::getAttribute("packetParameterSuffix", map, names.packetParameterSuffix);
 
     // Typedef stucture and packet suffix
-    typeSuffix = ProtocolParser::getAttribute("typeSuffix", map, typeSuffix);
+    names.typeSuffix = ProtocolParser::getAttribute("typeSuffix", map, names.typeSuffix);
 
     // The type suffix can be language specific
     if(language == c_language)
-        typeSuffix = ProtocolParser::getAttribute("typeSuffixC", map, typeSuffix);
+        names.typeSuffix = ProtocolParser::getAttribute("typeSuffixC", map, names.typeSuffix);
     else if(language == cpp_language)
-        typeSuffix = ProtocolParser::getAttribute("typeSuffixCPP", map, typeSuffix);
+        names.typeSuffix = ProtocolParser::getAttribute("typeSuffixCPP", map, names.typeSuffix);
 
     if(contains(ProtocolParser::getAttribute("endian", map), "little"))
         bigendian = false;
@@ -563,19 +646,21 @@ void ProtocolSupport::parse(const XMLAttribute* map)
  * Parse the global file names used for this support object from the DOM map
  * \param map is the DOM map
  */
-void ProtocolSupport::parseFileNames(const XMLAttribute* map)
+void ProtocolSupport::parseFileNames(const AttributeIndex& map)
 {
+    ProtocolContext& names = edit();
+
     // Global file names can be specified, but cannot have a "." in it
-    globalFileName = ProtocolParser::getAttribute("file", map);
-    globalVerifyName = ProtocolParser::getAttribute("verifyfile", map);
-    globalCompareName = ProtocolParser::getAttribute("comparefile", map);
-    globalPrintName = ProtocolParser::getAttribute("printfile", map);
-    globalMapName = ProtocolParser::getAttribute("mapfile", map);
-
-    replaceinplace(globalFileName, ".");
-    replaceinplace(globalVerifyName, ".");
-    replaceinplace(globalCompareName, ".");
-    replaceinplace(globalPrintName, ".");
-    replaceinplace(globalMapName, ".");
+    names.globalFileName = ProtocolParser::getAttribute("file", map);
+    names.globalVerifyName = ProtocolParser::getAttribute("verifyfile", map);
+    names.globalCompareName = ProtocolParser::getAttribute("comparefile", map);
+    names.globalPrintName = ProtocolParser::getAttribute("printfile", map);
+    names.globalMapName = ProtocolParser::getAttribute("mapfile", map);
+
+    replaceinplace(names.globalFileName, ".");
+    replaceinplace(names.globalVerifyName, ".");
+    replaceinplace(names.globalCompareName, ".");
+    replaceinplace(names.globalPrintName, ".");
+    replaceinplace(names.globalMapName, ".");
 
 }// ProtocolSupport::parseFileNames
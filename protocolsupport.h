@@ -2,11 +2,15 @@
 #define PROTOCOLSUPPORT_H
 
 #include "tinyxml2.h"
+#include "attributeindex.h"
 #include <vector>
 #include <string>
+#include <memory>
 
 using namespace tinyxml2;
 
+class CacheWriter;
+
 //! Make a copy of a string that is all lower case.
 std::string toLower(const std::string& text);
 
@@ -56,20 +60,50 @@ std::string join(const std::vector<std::string> list, const std::string& joiner
 std::vector<std::string>& removeDuplicates(std::vector<std::string>& list, bool casesensitive = false);
 
 
+/*!
+ * The protocol wide names and options which are set while the protocol and
+ * file tags are parsed, and then only read. Every copy of ProtocolSupport
+ * shares one ProtocolContext, a copy that changes it gets its own.
+ */
+class ProtocolContext
+{
+public:
+    ProtocolContext();
+
+    std::string globalFileName;        //!< File name to be used if a name is not given
+    std::string globalVerifyName;      //!< Verify file name to be used if a name is not given
+    std::string globalCompareName;     //!< Comparison file name to be used if a name is not given
+    std::string globalPrintName;       //!< Print file name to be used if a name is not given
+    std::string globalMapName;         //!< Map file name to be used if a name is not given
+    std::string outputpath;            //!< path to output files to
+    std::string packetStructureSuffix; //!< Name to use at end of encode/decode Packet structure functions
+    std::string packetParameterSuffix; //!< Name to use at end of encode/decode Packet parameter functions
+    std::string protoName;             //!< Name of the protocol
+    std::string prefix;                //!< Prefix name
+    std::string typeSuffix;            //!< Suffix on typedef structures
+    std::string pointerType;           //!< Packet pointer type - default is "void*"
+    std::string sourcefile;            //!< Source file name, used for warning outputs
+    std::string licenseText;           //!< License text to be added to each generated file
+};
+
+
 class ProtocolSupport
 {
 public:
     ProtocolSupport();
 
     //! Parse attributes from the ProtocolTag
-    void parse(const XMLAttribute* map);
+    void parse(const AttributeIndex& map);
 
     //! Parse the global file names
-    void parseFileNames(const XMLAttribute* map);
+    void parseFileNames(const AttributeIndex& map);
 
     //! Return the list of attributes understood by ProtocolSupport
     std::vector<std::string> getAttriblist(void) const;
 
+    //! Save all the options, to tell if precompiled data are current
+    void save(CacheWriter& writer) const;
+
     //! The type of language being output
     typedef enum
     {
@@ -81,6 +115,29 @@ public:
     //! Set the language override option, call this before the parse function
     void setLanguageOverride(LanguageType lang) {enablelanguageoverride = true; language = lang;}
 
+    //! Set the license text to be added to each generated file
+    void setLicenseText(const std::string& text) {edit().licenseText = text;}
+
+    //! Return the license text to be added to each generated file
+    const std::string& getLicenseText(void) const {return context->licenseText;}
+
+    //! Return the shared names and options for changing, this object gets its own copy if they are shared
+    ProtocolContext& edit(void);
+
+    const std::string& globalFileName(void) const {return context->globalFileName;}                 //!< File name to be used if a name is not given
+    const std::string& globalVerifyName(void) const {return context->globalVerifyName;}             //!< Verify file name to be used if a name is not given
+    const std::string& globalCompareName(void) const {return context->globalCompareName;}           //!< Comparison file name to be used if a name is not given
+    const std::string& globalPrintName(void) const {return context->globalPrintName;}               //!< Print file name to be used if a name is not given
+    const std::string& globalMapName(void) const {return context->globalMapName;}                   //!< Map file name to be used if a name is not given
+    const std::string& outputpath(void) const {return context->outputpath;}                         //!< path to output files to
+    const std::string& packetStructureSuffix(void) const {return context->packetStructureSuffix;}   //!< Name to use at end of encode/decode Packet structure functions
+    const std::string& packetParameterSuffix(void) const {return context->packetParameterSuffix;}   //!< Name to use at end of encode/decode Packet parameter functions
+    const std::string& protoName(void) const {return context->protoName;}                           //!< Name of the protocol
+    const std::string& prefix(void) const {return context->prefix;}                                 //!< Prefix name
+    const std::string& typeSuffix(void) const {return context->typeSuffix;}                         //!< Suffix on typedef structures
+    const std::string& pointerType(void) const {return context->pointerType;}                       //!< Packet pointer type - default is "void*"
+    const std::string& sourcefile(void) const {return context->sourcefile;}                         //!< Source file name, used for warning outputs
+
     LanguageType language;             //!< Enumerator specifying the language type
     int maxdatasize;                   //!< Maximum number of data bytes in a packet, 0 if no limit
     bool int64;                        //!< true if support for integers greater than 32 bits is included
@@ -93,30 +150,21 @@ public:
     bool bigendian;                    //!< Protocol bigendian flag
     bool supportbool;                  //!< true if support for 'bool' is included
     bool limitonencode;                //!< true to enforce verification limits on encode
+    bool span;                         //!< true to declare variable length arrays as spans of arena storage
+    bool sharelayouts;                 //!< true to share the C encode and decode functions of structures with the same layout
     bool compare;                      //!< True if the compare function is output for all structures
     bool print;                        //!< True if the textPrint and textRead function is output for all structures
     bool mapEncode;                    //!< True if the mapEncode and mapDecode function is output for all structures
     bool showAllItems;                 //!< Generate documentation even for elements marked hidden
     bool omitIfHidden;                 //!< Omit code generation for items marked hidden
-    std::string globalFileName;        //!< File name to be used if a name is not given
-    std::string globalVerifyName;      //!< Verify file name to be used if a name is not given
-    std::string globalCompareName;     //!< Comparison file name to be used if a name is not given
-    std::string globalPrintName;       //!< Print file name to be used if a name is not given
-    std::string globalMapName;         //!< Map file name to be used if a name is not given
-    std::string outputpath;            //!< path to output files to
-    std::string packetStructureSuffix; //!< Name to use at end of encode/decode Packet structure functions
-    std::string packetParameterSuffix; //!< Name to use at end of encode/decode Packet parameter functions
-    std::string protoName;             //!< Name of the protocol
-    std::string prefix;                //!< Prefix name
-    std::string typeSuffix;            //!< Suffix on typedef structures
-    std::string pointerType;           //!< Packet pointer type - default is "void*"
-    std::string licenseText;           //!< License text to be added to each generated file
-    std::string sourcefile;            //!< Source file name, used for warning outputs
 
 protected:
 
     //! Set to true to enable the language override feature
     bool enablelanguageoverride;
+
+    //! The names and options shared by all copies, which is never changed while it is shared
+    std::shared_ptr<ProtocolContext> context;
 };
 
 #endif // PROTOCOLSUPPORT_H
@@ -0,0 +1,862 @@
+#include "protocoltablecodec.h"
+
+ProtocolTableCodec::ProtocolTableCodec(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolTableCodec::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//! Generate the header file
+bool ProtocolTableCodec::generateHeader(void)
+{
+    header.setModuleNameAndPath("tablecodec", support.outputpath());
+
+// Raw string magic here
+header.setFileComment(R"(\brief Table driven encoding and decoding of structures
+
+Structures and packets marked tableDriven do not get generated code for
+each field. Instead they get a constant descriptor, which is a table with
+one entry for each encoded field, giving the location of the field in the
+in-memory structure, its in-memory type, and how it is encoded. The
+routines in this module interpret any descriptor, so all table driven
+structures share one small encoder and decoder. This trades a little
+speed for much less code, which matters on targets with many packets.
+
+The results are identical to the generated code, except that decoding
+checks every field against the number of bytes available, rather than
+relying on a single minimum length check.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("stdint.h", std::string(), true);
+    header.writeIncludeDirective("stddef.h", std::string(), true);
+    header.makeLineSeparator();
+
+    if(support.int64)
+    {
+        header.write("//! Integer type large enough to hold any encoded integer\n");
+        header.write("typedef uint64_t pguint_t;\n\n");
+        header.write("//! Signed integer type large enough to hold any encoded integer\n");
+        header.write("typedef int64_t pgint_t;\n");
+    }
+    else
+    {
+        header.write("//! Integer type large enough to hold any encoded integer\n");
+        header.write("typedef uint32_t pguint_t;\n\n");
+        header.write("//! Signed integer type large enough to hold any encoded integer\n");
+        header.write("typedef int32_t pgint_t;\n");
+    }
+
+    header.makeLineSeparator();
+    header.write("//! Floating point type used for the scaling constants and limits of a descriptor\n");
+    if(support.float64)
+        header.write("typedef double pgfloat_t;\n");
+    else
+        header.write("typedef float pgfloat_t;\n");
+
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! Types of in-memory data described by a pgfield_t
+typedef enum
+{
+    PG_MEMORY_NONE,     //!< Not in memory, the encoding is a constant or reserved space
+    PG_MEMORY_UNSIGNED, //!< Unsigned integer
+    PG_MEMORY_SIGNED,   //!< Signed integer or enumeration
+    PG_MEMORY_BOOL,     //!< Boolean
+    PG_MEMORY_FLOAT,    //!< float or double
+    PG_MEMORY_STRING,   //!< Null terminated character array
+    PG_MEMORY_STRUCT    //!< Structure, which has its own descriptor
+}pgmemory_t;
+
+//! Types of encodings described by a pgfield_t
+typedef enum
+{
+    PG_ENCODING_UNSIGNED,   //!< Unsigned integer
+    PG_ENCODING_SIGNED,     //!< Signed integer
+    PG_ENCODING_FLOAT,      //!< IEEE-754 binary32 or binary64
+    PG_ENCODING_USCALED,    //!< Unsigned integer, floating point scaled with min and scaler
+    PG_ENCODING_SSCALED,    //!< Signed integer, floating point scaled with scaler
+    PG_ENCODING_STRING,     //!< Null terminated string
+    PG_ENCODING_STRUCT      //!< Structure, which has its own descriptor
+}pgencoding_t;
+
+//! Flags that modify how a pgfield_t is encoded and decoded
+typedef enum
+{
+    PG_FIELD_BIGENDIAN = 0x01,  //!< Multi-byte encodings are big endian
+    PG_FIELD_LIMITMIN  = 0x02,  //!< Limit the in-memory value to limitmin before encoding
+    PG_FIELD_LIMITMAX  = 0x04,  //!< Limit the in-memory value to limitmax before encoding
+    PG_FIELD_CONSTANT  = 0x08,  //!< Encode the constant in limitmin instead of the in-memory value
+    PG_FIELD_CHECK     = 0x10,  //!< Decoding fails unless the value matches the constant in limitmin
+    PG_FIELD_FIXED     = 0x20,  //!< The string is encoded with its full length
+    PG_FIELD_FLOAT64   = 0x40   //!< Scaling is done in double precision, else single precision
+}pgfieldflags_t;
+
+typedef struct pgdescriptor_t pgdescriptor_t;
+
+//! Description of one encoded field of a structure
+typedef struct
+{
+    uint32_t offset;                    //!< Offset of the field in the in-memory structure
+    uint32_t count;                     //!< Number of elements, the maximum if the array is variable, or the maximum length of a string
+    uint16_t size;                      //!< Size of one element in memory
+    uint8_t memory;                     //!< In-memory type, from pgmemory_t
+    uint8_t encoding;                   //!< Encoded type, from pgencoding_t
+    uint8_t bytes;                      //!< Number of encoded bytes of one element
+    uint8_t flags;                      //!< Combination of pgfieldflags_t
+    int16_t length;                     //!< Index of the field that gives the array length, -1 if the array is fixed
+    int16_t depends;                    //!< Index of the field that must be non-zero for this field to be present, -1 if always present
+    const pgdescriptor_t* structure;    //!< Descriptor of the elements, if this is a structure
+    pgfloat_t min;                      //!< Minimum value of an unsigned scaled encoding
+    pgfloat_t scaler;                   //!< Multiplier from in-memory to encoded value of a scaled encoding
+    pgfloat_t limitmin;                 //!< Lower limit applied before encoding, or the constant value
+    pgfloat_t limitmax;                 //!< Upper limit applied before encoding
+}pgfield_t;
+
+//! Description of a structure, as the list of its encoded fields
+struct pgdescriptor_t
+{
+    const pgfield_t* fields;    //!< The encoded fields, in the order they are encoded
+    int numfields;              //!< Number of entries in fields
+};
+
+//! Encode a structure into a byte array using its descriptor
+void encodeFromDescriptor(const pgdescriptor_t* descriptor, uint8_t* data, int* bytecount, const void* user);
+
+//! Decode a structure from a byte array using its descriptor
+int decodeFromDescriptor(const pgdescriptor_t* descriptor, const uint8_t* data, int* bytecount, int numbytes, void* user);
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolTableCodec::generateHeader
+
+
+//! Generate the source file
+bool ProtocolTableCodec::generateSource(void)
+{
+    source.setModuleNameAndPath("tablecodec", support.outputpath());
+    source.writeIncludeDirective("fieldencode");
+    source.writeIncludeDirective("fielddecode");
+    source.writeIncludeDirective("string.h", std::string(), true);
+    source.makeLineSeparator();
+
+    // Pieces of the interpreter that depend on the protocol support
+    std::string readUnsigned64, readSigned64, write64, readDouble, writeDouble;
+    std::string encodeDouble, decodeDouble, checkDouble, scaleEncodeDouble, scaleDecodeDouble;
+
+    if(support.int64)
+    {
+        readUnsigned64 = R"===(
+    case 8: {uint64_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)value;})===";
+
+        readSigned64 = R"===(
+    case 8: {int64_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)value;})===";
+
+        write64 = R"===(
+    case 8: {uint64_t value = (uint64_t)number; memcpy(element, &value, sizeof(value)); break;})===";
+    }
+
+    if(support.float64)
+    {
+        readDouble = R"===(
+    else if(field->size == sizeof(double))
+    {
+        double value;
+        memcpy(&value, element, sizeof(value));
+        return (pgfloat_t)value;
+    })===";
+
+        writeDouble = R"===(
+        else if(field->size == sizeof(double))
+        {
+            double output = (double)value;
+            memcpy(element, &output, sizeof(output));
+        })===";
+
+        encodeDouble = R"===(
+        if(field->bytes == 8)
+        {
+            if(bigendian)
+                float64ToBeBytes((double)value, bytes, &index);
+            else
+                float64ToLeBytes((double)value, bytes, &index);
+        }
+        else )===";
+
+        decodeDouble = R"===(
+        if(field->bytes == 8)
+            writeFloat(field, element, (pgfloat_t)(bigendian ? float64FromBeBytes(bytes, &index) : float64FromLeBytes(bytes, &index)));
+        else )===";
+
+        checkDouble = R"===(
+        if(field->bytes == 8)
+            return (bigendian ? float64FromBeBytes(bytes, &index) : float64FromLeBytes(bytes, &index)) == (double)field->limitmin;
+        else )===";
+
+        scaleEncodeDouble = R"===(
+    if(field->flags & PG_FIELD_FLOAT64)
+    {
+        double scaled;
+
+        if(field->encoding == PG_ENCODING_USCALED)
+            scaled = (double)(((double)value - (double)field->min)*(double)field->scaler);
+        else
+            scaled = (double)((double)value*(double)field->scaler);
+
+        if(field->encoding == PG_ENCODING_SSCALED)
+        {
+            if(scaled >= 0)
+            {
+                if(scaled >= (double)max)
+                    return (pguint_t)max;
+                else
+                    return (pguint_t)(pgint_t)(scaled + 0.5); // account for fractional truncation
+            }
+            else
+            {
+                if(scaled <= (double)(-max - 1))
+                    return (pguint_t)(-max - 1);
+                else
+                    return (pguint_t)(pgint_t)(scaled - 0.5); // account for fractional truncation
+            }
+        }
+        else
+        {
+            if(scaled >= (double)umax)
+                return umax;
+            else if(scaled <= 0)
+                return 0;
+            else
+                return (pguint_t)(scaled + 0.5); // account for fractional truncation
+        }
+
+    }// if double precision scaling
+)===";
+
+        scaleDecodeDouble = R"===(
+    if(field->flags & PG_FIELD_FLOAT64)
+    {
+        double invscaler = 1.0/(double)field->scaler;
+
+        if(field->encoding == PG_ENCODING_SSCALED)
+            return (pgfloat_t)(double)(invscaler*(double)(pgint_t)signExtend(number, field->bytes));
+        else
+            return (pgfloat_t)(double)((double)field->min + invscaler*(double)number);
+    }
+)===";
+    }
+
+    source.write(R"===(/*!
+ * Read an integer from an in-memory element
+ * \param field describes the element, which must be an integer or boolean.
+ * \param element points to the element.
+ * \return the value of the element, signed values are sign extended.
+ */
+static pguint_t readInteger(const pgfield_t* field, const uint8_t* element)
+{
+    if(field->memory == PG_MEMORY_SIGNED)
+    {
+        switch(field->size)
+        {
+        default: return 0;
+        case 1: {int8_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)(pgint_t)value;}
+        case 2: {int16_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)(pgint_t)value;}
+        case 4: {int32_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)(pgint_t)value;})===" + readSigned64 + R"===(
+        }
+    }
+
+    switch(field->size)
+    {
+    default: return 0;
+    case 1: {uint8_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)value;}
+    case 2: {uint16_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)value;}
+    case 4: {uint32_t value; memcpy(&value, element, sizeof(value)); return (pguint_t)value;})===" + readUnsigned64 + R"===(
+    }
+
+}// readInteger
+
+
+/*!
+ * Read any numeric in-memory element as floating point
+ * \param field describes the element.
+ * \param element points to the element.
+ * \return the value of the element.
+ */
+static pgfloat_t readFloat(const pgfield_t* field, const uint8_t* element)
+{
+    if(field->memory == PG_MEMORY_SIGNED)
+        return (pgfloat_t)(pgint_t)readInteger(field, element);
+    else if(field->memory != PG_MEMORY_FLOAT)
+        return (pgfloat_t)readInteger(field, element);
+    else if(field->size == sizeof(float))
+    {
+        float value;
+        memcpy(&value, element, sizeof(value));
+        return (pgfloat_t)value;
+    })===" + readDouble + R"===(
+    else
+        return 0;
+
+}// readFloat
+
+
+/*!
+ * Write an integer to an in-memory element
+ * \param field describes the element, which must be an integer or boolean.
+ * \param element points to the element.
+ * \param number is the value to write, which is truncated to fit the element.
+ */
+static void writeInteger(const pgfield_t* field, uint8_t* element, pguint_t number)
+{
+    switch(field->size)
+    {
+    default: break;
+    case 1: {uint8_t value = (uint8_t)number; memcpy(element, &value, sizeof(value)); break;}
+    case 2: {uint16_t value = (uint16_t)number; memcpy(element, &value, sizeof(value)); break;}
+    case 4: {uint32_t value = (uint32_t)number; memcpy(element, &value, sizeof(value)); break;})===" + write64 + R"===(
+    }
+
+}// writeInteger
+
+
+/*!
+ * Convert a floating point value to an integer, negative values wrap around
+ * \param value is the value to convert.
+ * \return the converted value.
+ */
+static pguint_t floatToNumber(pgfloat_t value)
+{
+    if(value < 0)
+        return (pguint_t)(pgint_t)value;
+    else
+        return (pguint_t)value;
+}
+
+
+/*!
+ * Write a floating point value to any numeric in-memory element
+ * \param field describes the element.
+ * \param element points to the element.
+ * \param value is the value to write, which is truncated if the element is an integer.
+ */
+static void writeFloat(const pgfield_t* field, uint8_t* element, pgfloat_t value)
+{
+    if(field->memory == PG_MEMORY_FLOAT)
+    {
+        if(field->size == sizeof(float))
+        {
+            float output = (float)value;
+            memcpy(element, &output, sizeof(output));
+        })===" + writeDouble + R"===(
+    }
+    else if(field->memory == PG_MEMORY_BOOL)
+        writeInteger(field, element, (value != 0) ? 1 : 0);
+    else if(field->memory == PG_MEMORY_SIGNED)
+        writeInteger(field, element, (pguint_t)(pgint_t)value);
+    else
+        writeInteger(field, element, (pguint_t)value);
+
+}// writeFloat
+
+
+/*!
+ * Encode the least significant bytes of an integer
+ * \param number is the integer to encode.
+ * \param bytes receives the encoded bytes.
+ * \param num is the number of bytes to encode.
+ * \param bigendian should be non-zero to encode the most significant byte first.
+ */
+static void numberToBytes(pguint_t number, uint8_t* bytes, int num, int bigendian)
+{
+    int i;
+
+    if(bigendian)
+    {
+        for(i = num - 1; i >= 0; i--)
+        {
+            bytes[i] = (uint8_t)number;
+            number >>= 8;
+        }
+    }
+    else
+    {
+        for(i = 0; i < num; i++)
+        {
+            bytes[i] = (uint8_t)number;
+            number >>= 8;
+        }
+    }
+
+}// numberToBytes
+
+
+/*!
+ * Decode an unsigned integer from bytes
+ * \param bytes are the encoded bytes.
+ * \param num is the number of bytes to decode.
+ * \param bigendian should be non-zero if the most significant byte is first.
+ * \return the decoded integer.
+ */
+static pguint_t bytesToNumber(const uint8_t* bytes, int num, int bigendian)
+{
+    pguint_t number = 0;
+    int i;
+
+    if(bigendian)
+    {
+        for(i = 0; i < num; i++)
+            number = (number << 8) | bytes[i];
+    }
+    else
+    {
+        for(i = num - 1; i >= 0; i--)
+            number = (number << 8) | bytes[i];
+    }
+
+    return number;
+
+}// bytesToNumber
+
+
+/*!
+ * Sign extend a decoded integer
+ * \param number is the decoded integer.
+ * \param num is the number of bytes that were decoded.
+ * \return the sign extended integer.
+ */
+static pguint_t signExtend(pguint_t number, int num)
+{
+    if((num < (int)sizeof(pguint_t)) && ((number >> (8*num - 1)) & 1))
+        number |= (~(pguint_t)0) << (8*num);
+
+    return number;
+}
+
+
+/*!
+ * Apply the encode limits of a field
+ * \param field describes the field.
+ * \param value is the value to limit.
+ * \return the limited value.
+ */
+static pgfloat_t limitValue(const pgfield_t* field, pgfloat_t value)
+{
+    if((field->flags & PG_FIELD_LIMITMAX) && (value > field->limitmax))
+        return field->limitmax;
+    else if((field->flags & PG_FIELD_LIMITMIN) && (value < field->limitmin))
+        return field->limitmin;
+    else
+        return value;
+}
+
+
+/*!
+ * Scale a value to fit a scaled integer encoding, with the same precision and
+ * rounding as the scaledencode module.
+ * \param field describes the scaled encoding.
+ * \param value is the in-memory value to scale.
+ * \return the scaled integer.
+ */
+static pguint_t scaleToNumber(const pgfield_t* field, pgfloat_t value)
+{
+    pguint_t umax = ~(pguint_t)0;
+    pgint_t max = (pgint_t)(umax >> 1);
+    float scaled;
+
+    if(field->bytes < (int)sizeof(pguint_t))
+    {
+        umax = ((pguint_t)1 << (8*field->bytes)) - 1;
+        max = (pgint_t)(umax >> 1);
+    }
+)===" + scaleEncodeDouble + R"===(
+    if(field->encoding == PG_ENCODING_USCALED)
+        scaled = (float)(((float)value - (float)field->min)*(float)field->scaler);
+    else
+        scaled = (float)((float)value*(float)field->scaler);
+
+    if(field->encoding == PG_ENCODING_SSCALED)
+    {
+        if(scaled >= 0)
+        {
+            if(scaled >= (float)max)
+                return (pguint_t)max;
+            else
+                return (pguint_t)(pgint_t)(scaled + 0.5f); // account for fractional truncation
+        }
+        else
+        {
+            if(scaled <= (float)(-max - 1))
+                return (pguint_t)(-max - 1);
+            else
+                return (pguint_t)(pgint_t)(scaled - 0.5f); // account for fractional truncation
+        }
+    }
+    else
+    {
+        if(scaled >= (float)umax)
+            return umax;
+        else if(scaled <= 0)
+            return 0;
+        else
+            return (pguint_t)(scaled + 0.5f); // account for fractional truncation
+    }
+
+}// scaleToNumber
+
+
+/*!
+ * Convert a scaled integer back to its in-memory value, with the same
+ * precision as the scaleddecode module.
+ * \param field describes the scaled encoding.
+ * \param number is the decoded integer, without sign extension.
+ * \return the in-memory value.
+ */
+static pgfloat_t scaleFromNumber(const pgfield_t* field, pguint_t number)
+{
+    float invscaler = 1.0f/(float)field->scaler;
+)===" + scaleDecodeDouble + R"===(
+    if(field->encoding == PG_ENCODING_SSCALED)
+        return (pgfloat_t)(float)(invscaler*(float)(pgint_t)signExtend(number, field->bytes));
+    else
+        return (pgfloat_t)(float)((float)field->min + invscaler*(float)number);
+
+}// scaleFromNumber
+
+
+/*!
+ * Determine the number of elements of a field that are encoded
+ * \param descriptor describes the structure that holds the field.
+ * \param field describes the field.
+ * \param structure points to the in-memory structure.
+ * \return the number of elements, which is zero if the field is not present.
+ */
+static uint32_t getCount(const pgdescriptor_t* descriptor, const pgfield_t* field, const uint8_t* structure)
+{
+    uint32_t count = field->count;
+
+    // The field is only present if the field it depends on is non-zero
+    if(field->depends >= 0)
+    {
+        const pgfield_t* depends = &descriptor->fields[field->depends];
+
+        if(readFloat(depends, structure + depends->offset) == 0)
+            return 0;
+    }
+
+    // The array length is limited by the field that gives the length
+    if(field->length >= 0)
+    {
+        const pgfield_t* length = &descriptor->fields[field->length];
+        unsigned value;
+
+        if(length->memory == PG_MEMORY_FLOAT)
+            value = (unsigned)(pgint_t)readFloat(length, structure + length->offset);
+        else
+            value = (unsigned)readInteger(length, structure + length->offset);
+
+        if(value < count)
+            count = value;
+    }
+
+    return count;
+
+}// getCount
+
+
+/*!
+ * Encode one element of a numeric field
+ * \param field describes the field.
+ * \param element points to the in-memory element, which is ignored for constants.
+ * \param bytes receives the encoded bytes.
+ */
+static void encodeElement(const pgfield_t* field, const uint8_t* element, uint8_t* bytes)
+{
+    int bigendian = (field->flags & PG_FIELD_BIGENDIAN) ? 1 : 0;
+    int constant = (field->flags & PG_FIELD_CONSTANT) ? 1 : 0;
+    pgfloat_t value = constant ? field->limitmin : readFloat(field, element);
+    pguint_t number;
+    int index = 0;
+
+    if(field->encoding == PG_ENCODING_FLOAT)
+    {
+        if(!constant)
+            value = limitValue(field, value);
+)===" + encodeDouble + R"===(if(bigendian)
+            float32ToBeBytes((float)value, bytes, &index);
+        else
+            float32ToLeBytes((float)value, bytes, &index);
+
+        return;
+
+    }// if floating point encoding
+    else if((field->encoding == PG_ENCODING_USCALED) || (field->encoding == PG_ENCODING_SSCALED))
+    {
+        if(!constant)
+            value = limitValue(field, value);
+
+        number = scaleToNumber(field, value);
+
+    }// else if scaled encoding
+    else if(constant || (field->memory == PG_MEMORY_FLOAT))
+    {
+        if(!constant)
+            value = limitValue(field, value);
+
+        number = floatToNumber(value);
+
+    }// else if integer encoding from floating point
+    else if(field->memory == PG_MEMORY_BOOL)
+        number = (readInteger(field, element) != 0) ? 1 : 0;
+    else
+    {
+        // Integers are only converted to floating point to compare them against the limits
+        number = readInteger(field, element);
+
+        if((field->flags & PG_FIELD_LIMITMAX) && (value > field->limitmax))
+            number = floatToNumber(field->limitmax);
+        else if((field->flags & PG_FIELD_LIMITMIN) && (value < field->limitmin))
+            number = floatToNumber(field->limitmin);
+
+    }// else if integer encoding from integer
+
+    numberToBytes(number, bytes, field->bytes, bigendian);
+
+}// encodeElement
+
+
+/*!
+ * Decode one element of a numeric field
+ * \param field describes the field.
+ * \param bytes are the encoded bytes.
+ * \param element receives the decoded in-memory element.
+ */
+static void decodeElement(const pgfield_t* field, const uint8_t* bytes, uint8_t* element)
+{
+    int bigendian = (field->flags & PG_FIELD_BIGENDIAN) ? 1 : 0;
+    pguint_t number;
+    int index = 0;
+
+    if(field->encoding == PG_ENCODING_FLOAT)
+    {
+        )===" + decodeDouble + R"===(writeFloat(field, element, (pgfloat_t)(bigendian ? float32FromBeBytes(bytes, &index) : float32FromLeBytes(bytes, &index)));
+
+        return;
+    }
+
+    number = bytesToNumber(bytes, field->bytes, bigendian);
+
+    if((field->encoding == PG_ENCODING_USCALED) || (field->encoding == PG_ENCODING_SSCALED))
+        writeFloat(field, element, scaleFromNumber(field, number));
+    else
+    {
+        if(field->encoding == PG_ENCODING_SIGNED)
+            number = signExtend(number, field->bytes);
+
+        if(field->memory == PG_MEMORY_FLOAT)
+        {
+            if(field->encoding == PG_ENCODING_SIGNED)
+                writeFloat(field, element, (pgfloat_t)(pgint_t)number);
+            else
+                writeFloat(field, element, (pgfloat_t)number);
+        }
+        else if(field->memory == PG_MEMORY_BOOL)
+            writeInteger(field, element, (number != 0) ? 1 : 0);
+        else
+            writeInteger(field, element, number);
+    }
+
+}// decodeElement
+
+
+/*!
+ * Determine if an encoded element matches the constant value of a field
+ * \param field describes the field.
+ * \param bytes are the encoded bytes.
+ * \return 1 if the encoded element matches, else 0.
+ */
+static int matchesConstant(const pgfield_t* field, const uint8_t* bytes)
+{
+    int bigendian = (field->flags & PG_FIELD_BIGENDIAN) ? 1 : 0;
+    int index = 0;
+
+    if(field->encoding == PG_ENCODING_FLOAT)
+    {
+        )===" + checkDouble + R"===(return (bigendian ? float32FromBeBytes(bytes, &index) : float32FromLeBytes(bytes, &index)) == (float)field->limitmin;
+    }
+    else
+    {
+        pguint_t mask = ~(pguint_t)0;
+
+        if(field->bytes < (int)sizeof(pguint_t))
+            mask = ((pguint_t)1 << (8*field->bytes)) - 1;
+
+        return bytesToNumber(bytes, field->bytes, bigendian) == (floatToNumber(field->limitmin) & mask);
+    }
+
+}// matchesConstant
+
+
+/*!
+ * Encode a structure into a byte array using its descriptor. This gives the
+ * same result as the generated encode function of the structure.
+ * \param descriptor describes the structure.
+ * \param data points to the byte array to add encoded data to.
+ * \param bytecount points to the starting location in the byte array, and
+ *        will be incremented by the number of encoded bytes.
+ * \param user is the structure to encode.
+ */
+void encodeFromDescriptor(const pgdescriptor_t* descriptor, uint8_t* data, int* bytecount, const void* user)
+{
+    const uint8_t* structure = (const uint8_t*)user;
+    int index = *bytecount;
+    int i;
+
+    for(i = 0; i < descriptor->numfields; i++)
+    {
+        const pgfield_t* field = &descriptor->fields[i];
+        const uint8_t* element = structure + field->offset;
+        uint32_t count = getCount(descriptor, field, structure);
+        uint32_t j;
+
+        if(field->encoding == PG_ENCODING_STRING)
+        {
+            stringToBytes((const char*)element, data, &index, (int)count, (field->flags & PG_FIELD_FIXED) ? 1 : 0);
+        }
+        else if(field->encoding == PG_ENCODING_STRUCT)
+        {
+            for(j = 0; j < count; j++, element += field->size)
+                encodeFromDescriptor(field->structure, data, &index, element);
+        }
+        else
+        {
+            for(j = 0; j < count; j++, element += field->size)
+            {
+                encodeElement(field, element, data + index);
+                index += field->bytes;
+            }
+        }
+
+    }// for all fields
+
+    *bytecount = index;
+
+}// encodeFromDescriptor
+
+
+/*!
+ * Decode a structure from a byte array using its descriptor. This gives the
+ * same result as the generated decode function of the structure.
+ * \param descriptor describes the structure.
+ * \param data points to the byte array to decode data from.
+ * \param bytecount points to the starting location in the byte array, and
+ *        will be incremented by the number of bytes decoded.
+ * \param numbytes is the number of bytes in the byte array, which every field
+ *        is checked against. Use -1 to skip the checks.
+ * \param user receives the decoded structure.
+ * \return 1 if the data are decoded, else 0.
+ */
+int decodeFromDescriptor(const pgdescriptor_t* descriptor, const uint8_t* data, int* bytecount, int numbytes, void* user)
+{
+    uint8_t* structure = (uint8_t*)user;
+    int index = *bytecount;
+    int i;
+
+    for(i = 0; i < descriptor->numfields; i++)
+    {
+        const pgfield_t* field = &descriptor->fields[i];
+        uint8_t* element = structure + field->offset;
+        uint32_t count = getCount(descriptor, field, structure);
+        uint32_t j;
+
+        if(field->encoding == PG_ENCODING_STRING)
+        {
+            int maxlength = (int)count;
+
+            if(numbytes >= 0)
+            {
+                // Variable length strings can end early, if their terminator is in the data
+                if(numbytes - index < maxlength)
+                {
+                    if(field->flags & PG_FIELD_FIXED)
+                        return 0;
+
+                    maxlength = numbytes - index;
+
+                    if((maxlength < 1) || (memchr(data + index, 0, (size_t)maxlength) == NULL))
+                        return 0;
+                }
+            }
+
+            stringFromBytes((char*)element, data, &index, maxlength, (field->flags & PG_FIELD_FIXED) ? 1 : 0);
+        }
+        else if(field->encoding == PG_ENCODING_STRUCT)
+        {
+            for(j = 0; j < count; j++, element += field->size)
+            {
+                if(decodeFromDescriptor(field->structure, data, &index, numbytes, element) == 0)
+                    return 0;
+            }
+        }
+        else
+        {
+            if((numbytes >= 0) && ((index > numbytes) || ((uint32_t)(numbytes - index) < count*field->bytes)))
+                return 0;
+
+            if(field->memory == PG_MEMORY_NONE)
+            {
+                // Reserved space, which may have to match the constant
+                if((field->flags & PG_FIELD_CHECK) && !matchesConstant(field, data + index))
+                    return 0;
+
+                index += count*field->bytes;
+                continue;
+            }
+
+            for(j = 0; j < count; j++, element += field->size)
+            {
+                decodeElement(field, data + index, element);
+                index += field->bytes;
+
+                if((field->flags & PG_FIELD_CHECK) && (readFloat(field, element) != field->limitmin))
+                    return 0;
+            }
+        }
+
+    }// for all fields
+
+    *bytecount = index;
+
+    return 1;
+
+}// decodeFromDescriptor
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolTableCodec::generateSource
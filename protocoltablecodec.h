@@ -0,0 +1,35 @@
+#ifndef PROTOCOLTABLECODEC_H
+#define PROTOCOLTABLECODEC_H
+
+/*!
+ * \file
+ * Auto magically generate the table driven encode and decode interpreter
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+
+class ProtocolTableCodec
+{
+public:
+    ProtocolTableCodec(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLTABLECODEC_H
@@ -0,0 +1,637 @@
+#include "protocoludpbatch.h"
+#include "protocolpacket.h"
+#include <algorithm>
+#include <iostream>
+
+ProtocolUdpBatch::ProtocolUdpBatch(const ProtocolSupport& protocolsupport) :
+    header(protocolsupport),
+    source(protocolsupport),
+    support(protocolsupport)
+{}
+
+//! Perform the generation, writing out the files
+bool ProtocolUdpBatch::generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    if(generateHeader())
+    {
+        fileNameList.push_back(header.fileName());
+        filePathList.push_back(header.filePath());
+
+        if(generateSource())
+        {
+            fileNameList.push_back(source.fileName());
+            filePathList.push_back(source.filePath());
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*!
+ * Output a C++ transport for Linux that receives datagrams of this protocol
+ * in batches with recvmmsg(), checks each frame in them and passes it to a
+ * handler, and sends batches of encoded packets with sendmmsg(). The framing
+ * of packets is not described by the xml, so the transport calls the same
+ * frame length function as the replay tool. The buffers are sized from the
+ * largest packet of the protocol. The batched UDP helper module is output as
+ * well.
+ * \param protocolname is the name of the protocol
+ * \param protocolheader is the name of the main header of the protocol
+ * \param packets are the packets of the protocol
+ * \param fileNameList is appended with the names of the files that are output
+ * \param filePathList is appended with the paths of the files that are output
+ * \return true if the helper module was output
+ */
+bool ProtocolUdpBatch::generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::vector<ProtocolPacket*>& packets, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList)
+{
+    // The largest packet data of the protocol
+    int maxdatalength = 0;
+    for(std::size_t i = 0; i < packets.size(); i++)
+        maxdatalength = std::max(maxdatalength, packets.at(i)->getMaxDataLength());
+
+    // The largest UDP payload, if the packet lengths cannot be computed
+    if((maxdatalength <= 0) || (maxdatalength > 65507))
+    {
+        std::cerr << support.sourcefile() << ": warning: -udp buffers are the largest datagram, because the largest packet is not known" << std::endl;
+        maxdatalength = 65507;
+    }
+
+    // Enough datagrams in a batch to amortize the system call, limited by the kernel's limit of 1024 messages per call
+    int batchsize = std::min(1024, std::max(8, 262144/(maxdatalength + 16)));
+
+    std::string pointer = support.pointerType();
+    std::string framelength = "get" + protocolname + "FrameLength";
+    std::string macro = toUpper(protocolname) + "_UDP_FRAME_OVERHEAD";
+    std::string handler = protocolname + "UdpHandler";
+
+    ProtocolHeaderFile udpheader(support);
+    ProtocolSourceFile udpsource(support);
+
+    udpheader.setModuleNameAndPath(protocolname + "Udp", support.outputpath(), ProtocolSupport::cpp_language);
+    udpsource.setModuleNameAndPath(protocolname + "Udp", support.outputpath(), ProtocolSupport::cpp_language);
+
+    udpheader.setFileComment("Receive and send " + protocolname + " packets over UDP in batches. Each datagram holds one or more frames, "
+                             "which are found with " + framelength + "(), provided by the code that owns the framing. "
+                             "It returns the length of the valid frame that starts at frame, or 0, and a valid frame is given to "
+                             "the packet interface functions as the packet.");
+
+    udpheader.writeIncludeDirective("udpbatch");
+    udpheader.writeIncludeDirective(protocolheader, std::string(), false, false);
+    udpheader.makeLineSeparator();
+
+    udpheader.write(R"(//! The bytes of framing around the packet data, which the framing code can define
+#ifndef )" + macro + R"(
+#define )" + macro + R"( 16
+#endif
+
+//! The largest data of any )" + protocolname + R"( packet
+#define get)" + protocolname + R"(MaxPacketDataLength() )" + std::to_string(maxdatalength) + R"(
+
+//! The size of each datagram buffer
+#define get)" + protocolname + R"(UdpDatagramSize() (get)" + protocolname + R"(MaxPacketDataLength() + )" + macro + R"()
+
+//! The number of datagrams received or sent with one system call
+#define get)" + protocolname + R"(UdpBatchSize() )" + std::to_string(batchsize) + R"(
+
+//! Return the length of the valid frame that starts at frame, or 0, provided by the framing code
+)" + ((support.language == ProtocolSupport::c_language) ? "extern \"C\" " : "") + R"(int )" + framelength + R"((const uint8_t* frame, size_t size);
+
+//! Handles a frame received by receive)" + protocolname + R"(Udp()
+typedef void (*)" + handler + R"()(const )" + pointer + R"( pkt, const PgUdpDatagram& datagram, void* context);
+
+//! Construct a batched UDP socket with buffers sized for )" + protocolname + R"( packets
+PgUdpBatch* new)" + protocolname + R"(Udp(void);
+
+//! Receive a batch of datagrams, and pass each valid frame to a handler
+int receive)" + protocolname + R"(Udp(PgUdpBatch& udp, int timeout, )" + handler + R"( handler, void* context, int* invalid);
+
+//! Return the packet to encode the next outgoing frame into
+)" + pointer + R"( reserve)" + protocolname + R"(Udp(PgUdpBatch& udp);
+
+//! Queue the frame encoded in the reserved packet to be sent
+bool commit)" + protocolname + R"(Udp(PgUdpBatch& udp, const )" + pointer + R"( pkt);
+)");
+    udpheader.makeLineSeparator();
+
+    udpsource.makeLineSeparator();
+    udpsource.write(R"(/*!
+ * Construct a batched UDP socket with buffers sized for )" + protocolname + R"( packets
+ * \return the new object, which the caller must delete
+ */
+PgUdpBatch* new)" + protocolname + R"(Udp(void)
+{
+    return new PgUdpBatch(get)" + protocolname + R"(UdpDatagramSize(), get)" + protocolname + R"(UdpBatchSize());
+}// new)" + protocolname + R"(Udp
+
+
+/*!
+ * Receive a batch of datagrams, with one system call, and pass each valid
+ * frame in them to a handler. A datagram can hold more than one frame. The
+ * rest of a datagram is dropped at the first invalid frame.
+ * \param udp is the open socket
+ * \param timeout is the most milliseconds to wait for the first datagram, or
+ *        negative to wait forever
+ * \param handler is called for each valid frame
+ * \param context is passed to the handler
+ * \param invalid is incremented for each datagram with an invalid or
+ *        truncated frame, it can be null
+ * \return the number of frames passed to the handler, or -1 if the socket failed
+ */
+int receive)" + protocolname + R"(Udp(PgUdpBatch& udp, int timeout, )" + handler + R"( handler, void* context, int* invalid)
+{
+    int frames = 0;
+    int count = udp.receive(timeout);
+
+    if(count < 0)
+        return -1;
+
+    for(int i = 0; i < count; i++)
+    {
+        const PgUdpDatagram& datagram = udp.datagram(i);
+        std::size_t offset = 0;
+
+        while(!datagram.truncated && (offset < datagram.size))
+        {
+            int length = )" + framelength + R"((datagram.data + offset, datagram.size - offset);
+            if((length <= 0) || ((std::size_t)length > datagram.size - offset))
+                break;
+
+            handler((const )" + pointer + R"()(datagram.data + offset), datagram, context);
+            offset += (std::size_t)length;
+            frames++;
+        }
+
+        if((offset < datagram.size) && (invalid != nullptr))
+            (*invalid)++;
+    }
+
+    return frames;
+
+}// receive)" + protocolname + R"(Udp
+
+
+/*!
+ * Return the packet to encode the next outgoing frame into. The packet is a
+ * buffer of the send pool, so encoding into it does not copy.
+ * \param udp is the open socket
+ * \return the packet, which has get)" + protocolname + R"(UdpDatagramSize() bytes
+ */
+)" + pointer + R"( reserve)" + protocolname + R"(Udp(PgUdpBatch& udp)
+{
+    return ()" + pointer + R"()udp.reserve();
+}// reserve)" + protocolname + R"(Udp
+
+
+/*!
+ * Queue the frame encoded in the reserved packet to be sent to the
+ * destination of the socket. The frames are sent when the send pool is full,
+ * or by PgUdpBatch::flush().
+ * \param udp is the open socket
+ * \param pkt is the packet from reserve)" + protocolname + R"(Udp(), with an encoded frame
+ * \return true if the frame was valid and queued
+ */
+bool commit)" + protocolname + R"(Udp(PgUdpBatch& udp, const )" + pointer + R"( pkt)
+{
+    int length = )" + framelength + R"(((const uint8_t*)pkt, udp.getDatagramSize());
+    if(length <= 0)
+        return false;
+
+    return udp.commit((std::size_t)length);
+}// commit)" + protocolname + R"(Udp
+)");
+    udpsource.makeLineSeparator();
+
+    bool helper = generate(fileNameList, filePathList);
+
+    udpheader.flush();
+    fileNameList.push_back(udpheader.fileName());
+    filePathList.push_back(udpheader.filePath());
+
+    udpsource.flush();
+    fileNameList.push_back(udpsource.fileName());
+    filePathList.push_back(udpsource.filePath());
+
+    return helper;
+
+}// ProtocolUdpBatch::generateProtocol
+
+
+//! Generate the header file
+bool ProtocolUdpBatch::generateHeader(void)
+{
+    header.setModuleNameAndPath("udpbatch", support.outputpath(), ProtocolSupport::cpp_language);
+
+// Raw string magic here
+header.setFileComment(R"(\brief A UDP socket that receives and sends datagrams in batches
+
+Receiving and sending one datagram per system call costs more CPU than
+handling the datagram. PgUdpBatch receives up to a batch of datagrams with
+one recvmmsg() call, into a pool of buffers that is allocated once, and
+queues outgoing datagrams in a second pool which is sent with one sendmmsg()
+call. Each buffer holds one datagram, so the buffer size should be the
+largest datagram of the protocol.
+
+This module needs Linux (recvmmsg() and sendmmsg() are GNU extensions, which
+g++ and clang++ enable by default), and uses IPv4.)");
+
+    header.makeLineSeparator();
+    header.writeIncludeDirective("cstddef", std::string(), true, false);
+    header.writeIncludeDirective("cstdint", std::string(), true, false);
+    header.writeIncludeDirective("vector", std::string(), true, false);
+    header.writeIncludeDirective("netinet/in.h", std::string(), true, false);
+    header.writeIncludeDirective("sys/socket.h", std::string(), true, false);
+    header.makeLineSeparator();
+
+// Raw string magic here
+header.write(R"(//! A datagram received by a PgUdpBatch
+typedef struct
+{
+    const uint8_t* data;        //!< The bytes of the datagram, valid until the next receive()
+    std::size_t size;           //!< The number of bytes in the datagram
+    bool truncated;             //!< True if the datagram was larger than the buffer
+    struct sockaddr_in source;  //!< The address that sent the datagram
+}PgUdpDatagram;
+
+
+//! A UDP socket that receives and sends datagrams in batches
+class PgUdpBatch
+{
+public:
+
+    //! Construct the buffer pools, without a socket
+    PgUdpBatch(std::size_t datagramSize, std::size_t batchSize);
+
+    //! Close the socket, if it is open
+    ~PgUdpBatch(void);
+
+    //! Open a socket, bound to an address and port
+    bool open(const char* address, uint16_t port);
+
+    //! Set the address that datagrams are sent to
+    bool setDestination(const char* address, uint16_t port);
+
+    //! Send any queued datagrams and close the socket
+    void close(void);
+
+    //! Return the file descriptor of the socket, or -1
+    int descriptor(void) const {return socketfd;}
+
+    //! Return the port the socket is bound to, which is useful if it was opened with port 0
+    uint16_t port(void) const;
+
+    //! Receive a batch of datagrams
+    int receive(int timeout);
+
+    //! Return a datagram from the last receive()
+    const PgUdpDatagram& datagram(int index) const {return received.at((std::size_t)index);}
+
+    //! Return the buffer for the next datagram to send
+    uint8_t* reserve(void);
+
+    //! Queue the datagram in the reserved buffer, to be sent to the destination
+    bool commit(std::size_t size);
+
+    //! Queue the datagram in the reserved buffer, to be sent to an address
+    bool commit(std::size_t size, const struct sockaddr_in& address);
+
+    //! Send all the queued datagrams
+    int flush(void);
+
+    //! Return the size of each buffer
+    std::size_t getDatagramSize(void) const {return datagramSize;}
+
+    //! Return the number of buffers in each pool
+    std::size_t getBatchSize(void) const {return batchSize;}
+
+private:
+
+    std::size_t datagramSize;   //!< The size of each buffer
+    std::size_t batchSize;      //!< The number of buffers in each pool
+    int socketfd;               //!< The socket
+    std::size_t queued;         //!< The number of datagrams waiting to be sent
+    struct sockaddr_in destination; //!< Where datagrams are sent by default
+
+    std::vector<uint8_t> inPool;                //!< Buffers for received datagrams
+    std::vector<struct iovec> inVectors;        //!< One vector for each receive buffer
+    std::vector<struct sockaddr_in> inAddresses;//!< Sources of the received datagrams
+    std::vector<struct mmsghdr> inMessages;     //!< Messages for recvmmsg()
+    std::vector<PgUdpDatagram> received;        //!< The datagrams from the last receive()
+
+    std::vector<uint8_t> outPool;               //!< Buffers for datagrams to send
+    std::vector<struct iovec> outVectors;       //!< One vector for each send buffer
+    std::vector<struct sockaddr_in> outAddresses;//!< Destinations of the queued datagrams
+    std::vector<struct mmsghdr> outMessages;    //!< Messages for sendmmsg()
+};
+)");
+
+    header.makeLineSeparator();
+
+    return header.flush();
+
+}// ProtocolUdpBatch::generateHeader
+
+
+//! Generate the source file
+bool ProtocolUdpBatch::generateSource(void)
+{
+    source.setModuleNameAndPath("udpbatch", support.outputpath(), ProtocolSupport::cpp_language);
+    source.writeIncludeDirective("cerrno", std::string(), true, false);
+    source.writeIncludeDirective("cstring", std::string(), true, false);
+    source.writeIncludeDirective("arpa/inet.h", std::string(), true, false);
+    source.writeIncludeDirective("poll.h", std::string(), true, false);
+    source.writeIncludeDirective("sys/uio.h", std::string(), true, false);
+    source.writeIncludeDirective("unistd.h", std::string(), true, false);
+    source.makeLineSeparator();
+
+// Raw string magic here
+source.write(R"===(/*!
+ * Fill out an IPv4 address
+ * \param address is the dotted address, or null for any address
+ * \param port is the port number
+ * \param result receives the address
+ * \return true if the address was understood
+ */
+static bool makeAddress(const char* address, uint16_t port, struct sockaddr_in& result)
+{
+    std::memset(&result, 0, sizeof(result));
+    result.sin_family = AF_INET;
+    result.sin_port = htons(port);
+
+    if(address == nullptr)
+    {
+        result.sin_addr.s_addr = htonl(INADDR_ANY);
+        return true;
+    }
+
+    return inet_pton(AF_INET, address, &result.sin_addr) == 1;
+}
+
+
+/*!
+ * Construct the buffer pools, without a socket. The pools are allocated
+ * here, and never again.
+ * \param datagramSize is the size of each buffer, the largest datagram
+ * \param batchSize is the number of datagrams received or sent with one call
+ */
+PgUdpBatch::PgUdpBatch(std::size_t datagramSize, std::size_t batchSize) :
+    datagramSize(datagramSize),
+    batchSize(batchSize > 0 ? batchSize : 1),
+    socketfd(-1),
+    queued(0),
+    inPool(datagramSize*this->batchSize),
+    inVectors(this->batchSize),
+    inAddresses(this->batchSize),
+    inMessages(this->batchSize),
+    received(this->batchSize),
+    outPool(datagramSize*this->batchSize),
+    outVectors(this->batchSize),
+    outAddresses(this->batchSize),
+    outMessages(this->batchSize)
+{
+    std::memset(&destination, 0, sizeof(destination));
+    std::memset(inMessages.data(), 0, inMessages.size()*sizeof(struct mmsghdr));
+    std::memset(outMessages.data(), 0, outMessages.size()*sizeof(struct mmsghdr));
+
+    for(std::size_t i = 0; i < this->batchSize; i++)
+    {
+        inVectors[i].iov_base = inPool.data() + i*datagramSize;
+        inVectors[i].iov_len = datagramSize;
+        inMessages[i].msg_hdr.msg_iov = &inVectors[i];
+        inMessages[i].msg_hdr.msg_iovlen = 1;
+        inMessages[i].msg_hdr.msg_name = &inAddresses[i];
+
+        outVectors[i].iov_base = outPool.data() + i*datagramSize;
+        outMessages[i].msg_hdr.msg_iov = &outVectors[i];
+        outMessages[i].msg_hdr.msg_iovlen = 1;
+        outMessages[i].msg_hdr.msg_name = &outAddresses[i];
+        outMessages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+}
+
+
+/*!
+ * Close the socket, if it is open
+ */
+PgUdpBatch::~PgUdpBatch(void)
+{
+    close();
+}
+
+
+/*!
+ * Open a socket, bound to an address and port
+ * \param address is the dotted IPv4 address to bind to, or null for any address
+ * \param port is the port to bind to, 0 to let the system choose
+ * \return true if the socket was opened and bound
+ */
+bool PgUdpBatch::open(const char* address, uint16_t port)
+{
+    struct sockaddr_in local;
+
+    close();
+
+    if(!makeAddress(address, port, local))
+        return false;
+
+    socketfd = socket(AF_INET, SOCK_DGRAM, 0);
+    if(socketfd < 0)
+        return false;
+
+    if(bind(socketfd, (const struct sockaddr*)&local, sizeof(local)) != 0)
+    {
+        ::close(socketfd);
+        socketfd = -1;
+        return false;
+    }
+
+    return true;
+
+}// PgUdpBatch::open
+
+
+/*!
+ * Set the address that datagrams are sent to by commit(size)
+ * \param address is the dotted IPv4 address
+ * \param port is the port number
+ * \return true if the address was understood
+ */
+bool PgUdpBatch::setDestination(const char* address, uint16_t port)
+{
+    return (address != nullptr) && makeAddress(address, port, destination);
+
+}// PgUdpBatch::setDestination
+
+
+/*!
+ * Send any queued datagrams and close the socket
+ */
+void PgUdpBatch::close(void)
+{
+    if(socketfd < 0)
+        return;
+
+    flush();
+    ::close(socketfd);
+    socketfd = -1;
+    queued = 0;
+
+}// PgUdpBatch::close
+
+
+/*!
+ * Return the port the socket is bound to
+ * \return the port, or 0 if the socket is not open
+ */
+uint16_t PgUdpBatch::port(void) const
+{
+    struct sockaddr_in local;
+    socklen_t length = sizeof(local);
+
+    if((socketfd < 0) || (getsockname(socketfd, (struct sockaddr*)&local, &length) != 0))
+        return 0;
+
+    return ntohs(local.sin_port);
+
+}// PgUdpBatch::port
+
+
+/*!
+ * Receive a batch of datagrams with one recvmmsg() call. This waits for the
+ * first datagram, and then takes any others that are already waiting, up to
+ * the batch size.
+ * \param timeout is the most milliseconds to wait for the first datagram, or
+ *        negative to wait forever
+ * \return the number of datagrams received, which can be 0 if the timeout
+ *         expired, or -1 if the socket failed
+ */
+int PgUdpBatch::receive(int timeout)
+{
+    if(socketfd < 0)
+        return -1;
+
+    if(timeout >= 0)
+    {
+        struct pollfd waiting = {socketfd, POLLIN, 0};
+
+        int result = poll(&waiting, 1, timeout);
+        if(result == 0)
+            return 0;
+        else if(result < 0)
+            return (errno == EINTR) ? 0 : -1;
+    }
+
+    // The lengths are outputs of the last call
+    for(std::size_t i = 0; i < batchSize; i++)
+    {
+        inMessages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        inMessages[i].msg_hdr.msg_flags = 0;
+        inMessages[i].msg_len = 0;
+    }
+
+    int count = recvmmsg(socketfd, inMessages.data(), (unsigned int)batchSize, MSG_WAITFORONE, nullptr);
+    if(count < 0)
+        return (errno == EINTR) ? 0 : -1;
+
+    for(int i = 0; i < count; i++)
+    {
+        received[i].data = inPool.data() + i*datagramSize;
+        received[i].size = inMessages[i].msg_len;
+        received[i].truncated = (inMessages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        received[i].source = inAddresses[i];
+    }
+
+    return count;
+
+}// PgUdpBatch::receive
+
+
+/*!
+ * Return the buffer for the next datagram to send. If the send pool is full
+ * the queued datagrams are sent first.
+ * \return the buffer, which has getDatagramSize() bytes
+ */
+uint8_t* PgUdpBatch::reserve(void)
+{
+    if(queued >= batchSize)
+        flush();
+
+    return outPool.data() + queued*datagramSize;
+
+}// PgUdpBatch::reserve
+
+
+/*!
+ * Queue the datagram in the reserved buffer, to be sent to the destination
+ * \param size is the number of bytes in the datagram
+ * \return true if the datagram was queued
+ */
+bool PgUdpBatch::commit(std::size_t size)
+{
+    return commit(size, destination);
+
+}// PgUdpBatch::commit
+
+
+/*!
+ * Queue the datagram in the reserved buffer, to be sent to an address. The
+ * queue is sent when it is full, or by flush().
+ * \param size is the number of bytes in the datagram
+ * \param address is where the datagram is sent
+ * \return true if the datagram was queued
+ */
+bool PgUdpBatch::commit(std::size_t size, const struct sockaddr_in& address)
+{
+    if((size > datagramSize) || (queued >= batchSize))
+        return false;
+
+    outVectors[queued].iov_len = size;
+    outAddresses[queued] = address;
+    queued++;
+
+    if(queued >= batchSize)
+        flush();
+
+    return true;
+
+}// PgUdpBatch::commit
+
+
+/*!
+ * Send all the queued datagrams, with as few sendmmsg() calls as possible
+ * \return the number of datagrams sent, or -1 if the socket failed. Datagrams
+ *         that were not sent are dropped, as they would be by the network.
+ */
+int PgUdpBatch::flush(void)
+{
+    std::size_t sent = 0;
+
+    while((socketfd >= 0) && (sent < queued))
+    {
+        int count = sendmmsg(socketfd, outMessages.data() + sent, (unsigned int)(queued - sent), 0);
+
+        if(count > 0)
+            sent += (std::size_t)count;
+        else if((count < 0) && (errno == EINTR))
+            continue;
+        else
+        {
+            queued = 0;
+            return -1;
+        }
+    }
+
+    queued = 0;
+
+    return (int)sent;
+
+}// PgUdpBatch::flush
+)===");
+
+    source.makeLineSeparator();
+
+    return source.flush();
+
+}// ProtocolUdpBatch::generateSource
@@ -0,0 +1,41 @@
+#ifndef PROTOCOLUDPBATCH_H
+#define PROTOCOLUDPBATCH_H
+
+/*!
+ * \file
+ * Auto magically generate the batched UDP transport
+ */
+
+
+#include "protocolfile.h"
+#include "protocolsupport.h"
+#include <string>
+#include <vector>
+
+class ProtocolPacket;
+
+class ProtocolUdpBatch
+{
+public:
+    ProtocolUdpBatch(const ProtocolSupport& protocolsupport);
+
+    //! Perform the generation, writing out the files
+    bool generate(std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+    //! Perform the generation of the functions that send and receive the packets of a protocol, and the helper module
+    bool generateProtocol(const std::string& protocolname, const std::string& protocolheader, const std::vector<ProtocolPacket*>& packets, std::vector<std::string>& fileNameList, std::vector<std::string>& filePathList);
+
+protected:
+
+    //! Generate the header file
+    bool generateHeader(void);
+
+    //! Generate the source file
+    bool generateSource(void);
+
+    ProtocolHeaderFile header;
+    ProtocolSourceFile source;
+    ProtocolSupport support;
+};
+
+#endif // PROTOCOLUDPBATCH_H
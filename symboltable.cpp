@@ -0,0 +1,362 @@
+#include "symboltable.h"
+#include "enumcreator.h"
+#include "protocolstructuremodule.h"
+#include "shuntingyard.h"
+
+/*!
+ * Construct an empty symbol table
+ */
+SymbolTable::SymbolTable(void) :
+    enumcount(0)
+{
+}
+
+
+/*!
+ * Remove all symbols from the table
+ */
+void SymbolTable::clear(void)
+{
+    structures.clear();
+    layouts.clear();
+    enumerations.clear();
+    values.clear();
+    enumcount = 0;
+}
+
+
+/*!
+ * Add an enumeration and all its values to the table. This should be called
+ * after the enumeration is parsed. Enumerations added earlier take precedence
+ * over enumerations added later.
+ * \param enumeration is the enumeration to add, which must outlive the table
+ * \param global should be true if this is a global enumeration
+ */
+void SymbolTable::addEnumeration(const EnumCreator* enumeration, bool global)
+{
+    if(enumeration == nullptr)
+        return;
+
+    EnumSymbol symbol;
+    symbol.rank = enumcount++;
+    symbol.global = global;
+    symbol.enumeration = enumeration;
+    symbol.element = nullptr;
+
+    enumerations.emplace(enumeration->getName(), symbol);
+
+    const std::vector<EnumElement>& elements = enumeration->getElements();
+
+    for(std::size_t i = 0; i < elements.size(); i++)
+    {
+        std::vector<EnumSymbol>& list = values[trimm(elements.at(i).getName())];
+
+        // Only the first value with a given name in an enumeration is used
+        if(!list.empty() && (list.back().enumeration == enumeration))
+            continue;
+
+        symbol.element = &elements.at(i);
+        list.push_back(symbol);
+    }
+
+}// SymbolTable::addEnumeration
+
+
+/*!
+ * Remove an enumeration and all its values from the table. This is used when
+ * an enumeration that was added must be parsed again.
+ * \param enumeration is the enumeration to remove
+ */
+void SymbolTable::removeEnumeration(const EnumCreator* enumeration)
+{
+    if(enumeration == nullptr)
+        return;
+
+    std::unordered_map<std::string, EnumSymbol>::iterator it = enumerations.find(enumeration->getName());
+    if((it != enumerations.end()) && (it->second.enumeration == enumeration))
+        enumerations.erase(it);
+
+    for(auto value = values.begin(); value != values.end(); )
+    {
+        std::vector<EnumSymbol>& list = value->second;
+
+        for(std::size_t i = list.size(); i > 0; i--)
+        {
+            if(list.at(i - 1).enumeration == enumeration)
+                list.erase(list.begin() + (i - 1));
+        }
+
+        if(list.empty())
+            value = values.erase(value);
+        else
+            ++value;
+    }
+
+}// SymbolTable::removeEnumeration
+
+
+/*!
+ * Add a structure to the table, by its type name. This should be called after
+ * the structure is parsed. If the type name is already used the first
+ * structure takes precedence.
+ * \param structure is the structure to add, which must outlive the table
+ */
+void SymbolTable::addStructure(const ProtocolStructureModule* structure)
+{
+    if(structure != nullptr)
+        structures.emplace(structure->typeName, structure);
+}
+
+
+/*!
+ * Find the structure with a specific type name
+ * \param typeName is the type to lookup
+ * \return a pointer to the structure, or nullptr if it does not exist
+ */
+const ProtocolStructureModule* SymbolTable::lookUpStructure(const std::string& typeName) const
+{
+    std::unordered_map<std::string, const ProtocolStructureModule*>::const_iterator it = structures.find(typeName);
+
+    if(it == structures.end())
+        return nullptr;
+    else
+        return it->second;
+}
+
+
+/*!
+ * Add a structure by the layout of its encode and decode functions, see
+ * ProtocolStructure::getLayoutSignature(). The structure must output byte
+ * array encode and decode functions. The first structure with a layout takes
+ * precedence.
+ * \param layout is the layout signature of the structure
+ * \param structure is the structure to add, which must outlive the table
+ * \param include is the header which declares the functions of the structure
+ * \param structinclude is the header which declares the type of the structure
+ */
+void SymbolTable::addLayout(const std::string& layout, const ProtocolStructure* structure, const std::string& include, const std::string& structinclude)
+{
+    if((structure == nullptr) || layout.empty())
+        return;
+
+    LayoutSymbol& symbol = layouts[layout];
+
+    if(symbol.structure != nullptr)
+        return;
+
+    symbol.structure = structure;
+    symbol.include = include;
+    symbol.structInclude = structinclude;
+}
+
+
+/*!
+ * Find the structure whose encode and decode functions have a specific layout
+ * \param layout is the layout signature to lookup
+ * \param include receives the header which declares the functions of the structure, can be null
+ * \param structinclude receives the header which declares the type of the structure, can be null
+ * \return a pointer to the structure, or nullptr if no structure has the layout
+ */
+const ProtocolStructure* SymbolTable::lookUpLayout(const std::string& layout, std::string* include, std::string* structinclude) const
+{
+    std::unordered_map<std::string, LayoutSymbol>::const_iterator it = layouts.find(layout);
+
+    if(it == layouts.end())
+        return nullptr;
+
+    if(include != nullptr)
+        (*include) = it->second.include;
+
+    if(structinclude != nullptr)
+        (*structinclude) = it->second.structInclude;
+
+    return it->second.structure;
+}
+
+
+/*!
+ * Find the enumeration with a specific name
+ * \param enumName is the name of the enumeration
+ * \param globalonly should be true to only find global enumerations
+ * \return a pointer to the enumeration, or nullptr if it does not exist
+ */
+const EnumCreator* SymbolTable::lookUpEnumeration(const std::string& enumName, bool globalonly) const
+{
+    std::unordered_map<std::string, EnumSymbol>::const_iterator it = enumerations.find(enumName);
+
+    // Global enumerations are always added first, so if the first one is not global none are
+    if((it == enumerations.end()) || (globalonly && !it->second.global))
+        return nullptr;
+    else
+        return it->second.enumeration;
+}
+
+
+/*!
+ * Find the enumeration which has a value with a specific name
+ * \param valueName is the name of the enumeration value
+ * \param globalonly should be true to only find global enumerations
+ * \return a pointer to the first enumeration with this value, or nullptr if none
+ */
+const EnumCreator* SymbolTable::lookUpEnumerationForValue(const std::string& valueName, bool globalonly) const
+{
+    std::unordered_map<std::string, std::vector<EnumSymbol>>::const_iterator it = values.find(trimm(valueName));
+
+    if((it == values.end()) || (globalonly && !it->second.front().global))
+        return nullptr;
+    else
+        return it->second.front().enumeration;
+}
+
+
+/*!
+ * Find the first enumeration which has a specific name, or has a value with
+ * that name. If both exist the enumeration that was added first is returned.
+ * \param name is the name of the enumeration or enumeration value
+ * \param globalonly should be true to only find global enumerations
+ * \return a pointer to the enumeration, or nullptr if none
+ */
+const EnumCreator* SymbolTable::lookUpEnumerationForNameOrValue(const std::string& name, bool globalonly) const
+{
+    std::unordered_map<std::string, EnumSymbol>::const_iterator enumit = enumerations.find(name);
+    std::unordered_map<std::string, std::vector<EnumSymbol>>::const_iterator valueit = values.find(trimm(name));
+
+    const EnumSymbol* symbol = nullptr;
+
+    if(enumit != enumerations.end())
+        symbol = &enumit->second;
+
+    if((valueit != values.end()) && ((symbol == nullptr) || (valueit->second.front().rank < symbol->rank)))
+        symbol = &valueit->second.front();
+
+    if((symbol == nullptr) || (globalonly && !symbol->global))
+        return nullptr;
+    else
+        return symbol->enumeration;
+}
+
+
+/*!
+ * Find the enumeration value with this name and return its comment. If more
+ * than one enumeration has this value the first non-empty comment is returned.
+ * \param valueName is the name of the enumeration value to find
+ * \return the comment of the enumeration value, or an empty string
+ */
+std::string SymbolTable::getEnumerationValueComment(const std::string& valueName) const
+{
+    std::unordered_map<std::string, std::vector<EnumSymbol>>::const_iterator it = values.find(trimm(valueName));
+
+    if(it != values.end())
+    {
+        for(const EnumSymbol& symbol : it->second)
+        {
+            if(!symbol.element->comment.empty())
+                return symbol.element->comment;
+        }
+    }
+
+    return std::string();
+}
+
+
+/*!
+ * Replace any text that matches an enumeration value name with the value of
+ * that enumeration. The replacement text is itself searched for names from
+ * enumerations added after the one that supplied the replacement.
+ * \param text is the source text to search, which won't be modified
+ * \return A new string that replaces any enumeration names with the value of the enumeration
+ */
+std::string SymbolTable::replaceEnumerationNameWithValue(const std::string& text) const
+{
+    return replaceEnumerationNameWithValue(text, 0, enumcount);
+}
+
+
+/*!
+ * Find the enumeration with a specific name, as if only the enumerations
+ * added before a rank were in the table. This gives the answer the table
+ * had before those enumerations were added.
+ * \param enumName is the name of the enumeration
+ * \param maxrank is the rank of the first enumeration to ignore
+ * \return a pointer to the enumeration, or nullptr if it does not exist
+ */
+const EnumCreator* SymbolTable::lookUpEnumerationBefore(const std::string& enumName, std::size_t maxrank) const
+{
+    std::unordered_map<std::string, EnumSymbol>::const_iterator it = enumerations.find(enumName);
+
+    // The first enumeration with a name wins, so if it is too late none are early enough
+    if((it == enumerations.end()) || (it->second.rank >= maxrank))
+        return nullptr;
+    else
+        return it->second.enumeration;
+}
+
+
+/*!
+ * Replace any text that matches an enumeration value name with the value of
+ * that enumeration, as if only the enumerations added before a rank were in
+ * the table.
+ * \param text is the source text to search, which won't be modified
+ * \param maxrank is the rank of the first enumeration to ignore
+ * \return A new string that replaces any enumeration names with the value of the enumeration
+ */
+std::string SymbolTable::replaceEnumerationNameWithValueBefore(const std::string& text, std::size_t maxrank) const
+{
+    return replaceEnumerationNameWithValue(text, 0, maxrank);
+}
+
+
+/*!
+ * Replace any text that matches an enumeration value name with the value of
+ * that enumeration, using only enumerations added at or after one rank, and
+ * before another.
+ * \param text is the source text to search, which won't be modified
+ * \param minrank is the lowest rank of enumeration to use
+ * \param maxrank is the rank of the first enumeration to ignore
+ * \return A new string that replaces any enumeration names with the value of the enumeration
+ */
+std::string SymbolTable::replaceEnumerationNameWithValue(const std::string& text, std::size_t minrank, std::size_t maxrank) const
+{
+    // split words around mathematical operators
+    std::vector<std::string> tokens = EnumCreator::splitAroundMathOperators(text);
+
+    for(std::size_t j = 0; j < tokens.size(); j++)
+    {
+        std::string token = trimm(tokens.at(j));
+
+        // Don't look to replace the mathematical operators
+        if(token.empty() || EnumCreator::isMathOperator(token.at(0)))
+            continue;
+
+        // Don't look to replace elements that are already numeric
+        if(ShuntingYard::isInt(token))
+            continue;
+
+        std::unordered_map<std::string, std::vector<EnumSymbol>>::const_iterator it = values.find(token);
+        if(it == values.end())
+            continue;
+
+        for(const EnumSymbol& symbol : it->second)
+        {
+            if(symbol.rank < minrank)
+                continue;
+
+            // The symbols are in the order they were added
+            if(symbol.rank >= maxrank)
+                break;
+
+            std::string substitution = symbol.element->getSubstitution();
+            if(substitution.empty())
+                continue;
+
+            tokens[j] = replaceEnumerationNameWithValue(substitution, symbol.rank + 1, maxrank);
+            break;
+
+        }// for all enumerations with this value name
+
+    }// for all tokens
+
+    // Rejoin the strings
+    return join(tokens);
+
+}// SymbolTable::replaceEnumerationNameWithValue
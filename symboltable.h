@@ -0,0 +1,111 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+class EnumCreator;
+class EnumElement;
+class ProtocolStructureModule;
+class ProtocolStructure;
+
+/*!
+ * The SymbolTable provides hashed lookup of the global names that the parser
+ * knows about: structure type names, enumeration names, and enumeration value
+ * names. Symbols are added as their owners are parsed, and the order in which
+ * they are added determines which symbol wins if a name is used more than once.
+ */
+class SymbolTable
+{
+public:
+
+    //! Construct an empty symbol table
+    SymbolTable(void);
+
+    //! Remove all symbols from the table
+    void clear(void);
+
+    //! Add an enumeration and all its values to the table
+    void addEnumeration(const EnumCreator* enumeration, bool global);
+
+    //! Remove an enumeration and all its values from the table
+    void removeEnumeration(const EnumCreator* enumeration);
+
+    //! Add a structure to the table, by its type name
+    void addStructure(const ProtocolStructureModule* structure);
+
+    //! Find the structure with a specific type name
+    const ProtocolStructureModule* lookUpStructure(const std::string& typeName) const;
+
+    //! Add a structure whose encode and decode functions have a specific layout
+    void addLayout(const std::string& layout, const ProtocolStructure* structure, const std::string& include, const std::string& structinclude);
+
+    //! Find the structure whose encode and decode functions have a specific layout
+    const ProtocolStructure* lookUpLayout(const std::string& layout, std::string* include = nullptr, std::string* structinclude = nullptr) const;
+
+    //! Find the enumeration with a specific name
+    const EnumCreator* lookUpEnumeration(const std::string& enumName, bool globalonly = false) const;
+
+    //! Find the enumeration which has a value with a specific name
+    const EnumCreator* lookUpEnumerationForValue(const std::string& valueName, bool globalonly = false) const;
+
+    //! Find the first enumeration which has a specific name, or has a value with that name
+    const EnumCreator* lookUpEnumerationForNameOrValue(const std::string& name, bool globalonly = false) const;
+
+    //! Find the enumeration value with this name and return its comment, or an empty string
+    std::string getEnumerationValueComment(const std::string& valueName) const;
+
+    //! Replace any text that matches an enumeration value name with the value of that enumeration
+    std::string replaceEnumerationNameWithValue(const std::string& text) const;
+
+    //! Return the number of enumerations which have been added, which is the rank of the next one
+    std::size_t getEnumerationCount(void) const {return enumcount;}
+
+    //! Find the enumeration with a specific name, using only enumerations added before a rank
+    const EnumCreator* lookUpEnumerationBefore(const std::string& enumName, std::size_t maxrank) const;
+
+    //! Replace enumeration value names using only enumerations added before a rank
+    std::string replaceEnumerationNameWithValueBefore(const std::string& text, std::size_t maxrank) const;
+
+protected:
+
+    //! Replace enumeration value names using only enumerations added at or after one rank, and before another
+    std::string replaceEnumerationNameWithValue(const std::string& text, std::size_t minrank, std::size_t maxrank) const;
+
+    //! Information about an enumeration name or value name
+    class EnumSymbol
+    {
+    public:
+        std::size_t rank;                   //!< The order in which the enumeration was added
+        bool global;                        //!< True if the enumeration is global
+        const EnumCreator* enumeration;     //!< The enumeration that owns this symbol
+        const EnumElement* element;         //!< The enumeration value, or null for the enumeration name
+    };
+
+    //! Information about a structure layout
+    class LayoutSymbol
+    {
+    public:
+        const ProtocolStructure* structure; //!< The structure which has this layout
+        std::string include;                //!< The header which declares the structure functions
+        std::string structInclude;          //!< The header which declares the structure type
+    };
+
+    //! Number of enumerations which have been added
+    std::size_t enumcount;
+
+    //! Structures by type name
+    std::unordered_map<std::string, const ProtocolStructureModule*> structures;
+
+    //! Structures by the layout of their encode and decode functions
+    std::unordered_map<std::string, LayoutSymbol> layouts;
+
+    //! Enumerations by name
+    std::unordered_map<std::string, EnumSymbol> enumerations;
+
+    //! Enumeration values by name, in the order their enumerations were added
+    std::unordered_map<std::string, std::vector<EnumSymbol>> values;
+};
+
+#endif // SYMBOLTABLE_H
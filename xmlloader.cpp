@@ -0,0 +1,439 @@
+#include "xmlloader.h"
+#include "protocolsupport.h"
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*!
+ * Construct an empty loader. The worker threads are started when there are
+ * files to load, up to one for each hardware thread.
+ */
+XmlLoader::XmlLoader(void) :
+    activeWorkers(0),
+    maxWorkers(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+
+/*!
+ * Wait for any loads in progress and delete all the documents
+ */
+XmlLoader::~XmlLoader(void)
+{
+    waitForLoads();
+
+    for(const auto& entry : documents)
+        delete entry.second.get();
+
+    documents.clear();
+
+}// XmlLoader::~XmlLoader
+
+
+/*!
+ * Wait until all the loads in progress, and the loads they queue, are done,
+ * and then join the worker threads. Files still in the queue are loaded by
+ * this thread as well.
+ */
+void XmlLoader::waitForLoads(void)
+{
+    std::vector<std::thread> finished;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while(true)
+        {
+            if(!queue.empty())
+            {
+                Job job = std::move(queue.front());
+                queue.pop_front();
+
+                lock.unlock();
+                run(job);
+                lock.lock();
+            }
+            else if(activeWorkers == 0)
+                break;
+            else
+                idle.wait(lock);
+        }
+
+        finished.swap(workers);
+    }
+
+    for(std::thread& worker : finished)
+        worker.join();
+
+}// XmlLoader::waitForLoads
+
+
+/*!
+ * Load files from the queue until it is empty. This is the body of each
+ * worker thread, which ends when there is nothing left to load.
+ */
+void XmlLoader::work(void)
+{
+    while(true)
+    {
+        Job job;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if(queue.empty())
+            {
+                activeWorkers--;
+                idle.notify_all();
+                return;
+            }
+
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        run(job);
+    }
+
+}// XmlLoader::work
+
+
+/*!
+ * Load the file of a job and fulfill its promise, which wakes anyone waiting
+ * for the document. The mutex must not be locked.
+ * \param job is the job to run
+ */
+void XmlLoader::run(Job& job)
+{
+    try
+    {
+        job.promise.set_value(load(job.key));
+    }
+    catch(...)
+    {
+        job.promise.set_exception(std::current_exception());
+    }
+
+}// XmlLoader::run
+
+
+/*!
+ * Drop the documents whose files changed since they were loaded, including
+ * files that could not be opened before and now exist, so they are loaded
+ * again the next time they are requested. Documents of unchanged files stay
+ * loaded. No document may be in use when this is called.
+ * \return the number of documents that were dropped
+ */
+std::size_t XmlLoader::refresh(void)
+{
+    waitForLoads();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t count = 0;
+
+    for(auto it = documents.begin(); it != documents.end(); )
+    {
+        FileStamp stamp = fileStamp(it->first);
+        const FileStamp& loaded = stamps[it->first];
+
+        if((stamp.time == loaded.time) && (stamp.size == loaded.size))
+        {
+            ++it;
+            continue;
+        }
+
+        delete it->second.get();
+        stamps.erase(it->first);
+        it = documents.erase(it);
+        count++;
+    }
+
+    return count;
+
+}// XmlLoader::refresh
+
+
+/*!
+ * Start loading files, and the files they require, in the background. Files
+ * that are already loaded or loading are not loaded again.
+ * \param fileNames is the list of files to load
+ */
+void XmlLoader::prefetch(const std::vector<std::string>& fileNames)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for(const std::string& fileName : fileNames)
+        schedule(fileKey(fileName));
+}
+
+
+/*!
+ * Return the document for a file, waiting for it to be loaded if needed. If
+ * no worker has started the file yet it is loaded by this thread, rather than
+ * waiting behind other files. The same document is returned each time the
+ * same file is requested.
+ * \param fileName is the name of the file
+ * \return the document, which the loader still owns. This will be null if the
+ *         file could not be opened. The caller must check the document for
+ *         parse errors.
+ */
+XMLDocument* XmlLoader::document(const std::string& fileName)
+{
+    std::string key = fileKey(fileName);
+    std::shared_future<XMLDocument*> future;
+    Job job;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        schedule(key);
+        future = documents[key];
+
+        auto it = std::find_if(queue.begin(), queue.end(), [&key](const Job& queued){return queued.key == key;});
+        if(it != queue.end())
+        {
+            job = std::move(*it);
+            queue.erase(it);
+        }
+    }
+
+    if(!job.key.empty())
+        run(job);
+
+    return future.get();
+
+}// XmlLoader::document
+
+
+/*!
+ * Queue a file to be loaded in the background, unless it is already loaded or
+ * queued. Another worker thread is started if there are fewer than the
+ * maximum, workers end as soon as the queue is empty.
+ * \param key is the key of the file, from fileKey()
+ */
+void XmlLoader::schedule(const std::string& key)
+{
+    if(documents.count(key) > 0)
+        return;
+
+    Job job;
+    job.key = key;
+    documents[key] = job.promise.get_future().share();
+    queue.push_back(std::move(job));
+
+    if(activeWorkers >= maxWorkers)
+        return;
+
+    try
+    {
+        workers.emplace_back(&XmlLoader::work, this);
+        activeWorkers++;
+    }
+    catch(const std::system_error&)
+    {
+        // Could not start a thread, the file will be loaded when it is needed
+    }
+
+}// XmlLoader::schedule
+
+
+/*!
+ * Load and parse one file, and then queue the files it requires. This runs
+ * on a worker thread, or the thread that asked for the document.
+ * \param key is the key of the file, from fileKey()
+ * \return the parsed document, or null if the file could not be opened
+ */
+XMLDocument* XmlLoader::load(const std::string& key)
+{
+    // Stamp the file before reading it, so a change during the read is seen by refresh()
+    FileStamp stamp = fileStamp(key);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stamps[key] = stamp;
+    }
+
+    XMLDocument* doc = new XMLDocument();
+
+    if(!parseFile(key, doc))
+    {
+        delete doc;
+        return nullptr;
+    }
+
+    const XMLElement* root = doc->RootElement();
+
+    if((root == nullptr) || doc->Error())
+        return doc;
+
+    // Files required by this one are relative to this one
+    std::filesystem::path directory = std::filesystem::path(key).parent_path();
+    std::vector<std::string> required;
+
+    // This must find the same files as ProtocolParser::parseFile(), which
+    // uses the first trimmed file attribute of each (case insensitive) Require
+    for(const XMLElement* element = root->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+    {
+        if(toLower(trimm(element->Name())) != "require")
+            continue;
+
+        for(const XMLAttribute* a = element->FirstAttribute(); a != nullptr; a = a->Next())
+        {
+            if(!XMLUtil::StringEqual(a->Name(), "file"))
+                continue;
+
+            std::string subfile = trimm(a->Value());
+
+            if(!subfile.empty())
+            {
+                if(!endsWith(subfile, ".xml"))
+                    subfile += ".xml";
+
+                required.push_back(fileKey((directory / subfile).string()));
+            }
+
+            break;
+        }
+    }
+
+    if(!required.empty())
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for(const std::string& requiredKey : required)
+            schedule(requiredKey);
+    }
+
+    return doc;
+
+}// XmlLoader::load
+
+
+/*!
+ * Parse a file into a document. The file is mapped into memory and handed to
+ * tinyxml2 directly, which avoids reading it into an intermediate string. If
+ * the file cannot be mapped, which can happen for some file systems, it is
+ * read instead.
+ * \param fileName is the name of the file
+ * \param doc is the document to parse into
+ * \return false if the file could not be opened, else true, even if the
+ *         contents failed to parse.
+ */
+bool XmlLoader::parseFile(const std::string& fileName, XMLDocument* doc)
+{
+    bool mapped = false;
+
+    #if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    const char* data = nullptr;
+
+    if(GetFileSizeEx(file, &size) && (size.QuadPart > 0))
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if(mapping != NULL)
+        data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if(data != nullptr)
+    {
+        doc->Parse(data, (std::size_t)size.QuadPart);
+        UnmapViewOfFile(data);
+        mapped = true;
+    }
+
+    if(mapping != NULL)
+        CloseHandle(mapping);
+
+    CloseHandle(file);
+
+    #else
+    int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return false;
+
+    struct stat info;
+    void* data = MAP_FAILED;
+
+    if((fstat(fd, &info) == 0) && (info.st_size > 0))
+        data = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if(data != MAP_FAILED)
+    {
+        doc->Parse((const char*)data, (std::size_t)info.st_size);
+        munmap(data, (std::size_t)info.st_size);
+        mapped = true;
+    }
+
+    close(fd);
+
+    #endif
+
+    if(!mapped)
+    {
+        // Read the file instead, an empty file gives an empty document
+        std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
+
+        if(!stream.is_open())
+            return false;
+
+        std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        doc->Parse(contents.data(), contents.size());
+    }
+
+    return true;
+
+}// XmlLoader::parseFile
+
+
+/*!
+ * Get the modification time and size of a file
+ * \param fileName is the name of the file
+ * \return the stamp of the file, which is zero if the file does not exist
+ */
+XmlLoader::FileStamp XmlLoader::fileStamp(const std::string& fileName)
+{
+    FileStamp stamp;
+    std::error_code ec;
+
+    stamp.time = std::filesystem::last_write_time(fileName, ec);
+    if(ec)
+        stamp.time = std::filesystem::file_time_type::min();
+
+    stamp.size = std::filesystem::file_size(fileName, ec);
+    if(ec)
+        stamp.size = 0;
+
+    return stamp;
+
+}// XmlLoader::fileStamp
+
+
+/*!
+ * Return the key for a file, which is its absolute normalized path, so the
+ * same file is only loaded once no matter how it is named.
+ * \param fileName is the name of the file
+ * \return the key for the file
+ */
+std::string XmlLoader::fileKey(const std::string& fileName)
+{
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::absolute(fileName, ec);
+
+    if(ec)
+        path = fileName;
+
+    return path.lexically_normal().string();
+}
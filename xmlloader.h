@@ -0,0 +1,118 @@
+#ifndef XMLLOADER_H
+#define XMLLOADER_H
+
+#include "tinyxml2.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <future>
+#include <thread>
+#include <deque>
+#include <condition_variable>
+#include <filesystem>
+
+using namespace tinyxml2;
+
+/*!
+ * The XmlLoader reads and parses the protocol xml files, and owns the
+ * resulting documents. Files are memory mapped and handed to tinyxml2
+ * directly, so the file contents are not copied into an intermediate string.
+ * Files are loaded by a small pool of worker threads, no more than there are
+ * hardware threads, and as soon as a file is parsed the files it requires
+ * (with the Require tag) are queued as well. The parser asks for the
+ * documents in order, and only waits if a document is not ready yet, so the
+ * semantic pass is unchanged. A document that no worker has started yet is
+ * loaded by the thread that asks for it.
+ *
+ * The loader can outlive the parser, so documents stay resident between
+ * generations in watch mode. refresh() drops the documents whose files
+ * changed, and only those are loaded again.
+ */
+class XmlLoader
+{
+public:
+
+    //! Construct an empty loader
+    XmlLoader(void);
+
+    //! Wait for any loads in progress and delete all the documents
+    ~XmlLoader(void);
+
+    //! Start loading files, and the files they require, in the background
+    void prefetch(const std::vector<std::string>& fileNames);
+
+    //! Return the document for a file, waiting for it to be loaded if needed
+    XMLDocument* document(const std::string& fileName);
+
+    //! Drop the documents whose files changed since they were loaded, return how many
+    std::size_t refresh(void);
+
+protected:
+
+    //! The modification time and size of a file when it was loaded
+    class FileStamp
+    {
+    public:
+        std::filesystem::file_time_type time;   //!< The modification time
+        std::uintmax_t size;                    //!< The size in bytes
+    };
+
+    //! A file waiting to be loaded, with the promise of its document
+    class Job
+    {
+    public:
+        std::string key;                        //!< The key of the file
+        std::promise<XMLDocument*> promise;     //!< Fulfilled when the file is loaded
+    };
+
+    //! Wait until all the loads in progress, and the loads they start, are done
+    void waitForLoads(void);
+
+    //! Load files from the queue until it is empty, this runs on a worker thread
+    void work(void);
+
+    //! Load the file of a job and fulfill its promise
+    void run(Job& job);
+
+    //! Get the modification time and size of a file, which is zero if it does not exist
+    static FileStamp fileStamp(const std::string& fileName);
+
+    //! Queue a file to be loaded in the background, the mutex must be locked
+    void schedule(const std::string& key);
+
+    //! Load and parse one file, and queue the files it requires
+    XMLDocument* load(const std::string& key);
+
+    //! Parse a file by mapping it into memory
+    static bool parseFile(const std::string& fileName, XMLDocument* doc);
+
+    //! Return the key for a file, which is its absolute normalized path
+    static std::string fileKey(const std::string& fileName);
+
+    //! Protects the documents, the queue and the workers, which are changed by the loading threads
+    std::mutex mutex;
+
+    //! Signaled when a worker thread runs out of work
+    std::condition_variable idle;
+
+    //! Files waiting for a worker
+    std::deque<Job> queue;
+
+    //! The worker threads, which are joined when all loads are done
+    std::vector<std::thread> workers;
+
+    //! Number of worker threads still taking files from the queue
+    std::size_t activeWorkers;
+
+    //! Maximum number of worker threads
+    std::size_t maxWorkers;
+
+    //! Documents by file key, each of which may still be loading. A null document means the file could not be opened
+    std::map<std::string, std::shared_future<XMLDocument*>> documents;
+
+    //! The stamp of each file when it was loaded, by file key
+    std::map<std::string, FileStamp> stamps;
+};
+
+#endif // XMLLOADER_H